@@ -0,0 +1,15 @@
+#version 300 es
+
+// Precision qualifiers required for OpenGL ES
+precision highp float;
+
+// Input from vertex shader
+in vec4 v_Color;
+
+// Explicit output variable (replaces gl_FragColor)
+out vec4 FragColor;
+
+void main() {
+    // Straight alpha, for GL_SRC_ALPHA / GL_ONE_MINUS_SRC_ALPHA blending
+    FragColor = v_Color;
+}
@@ -2,20 +2,28 @@
 
 // Precision qualifiers required for OpenGL ES
 precision highp float;
+precision highp sampler2DArray;
 
 // Input from vertex shader
 in vec2 v_TexCoord;
+in float v_Layer;
 
 // Uniforms
 uniform sampler2D u_Texture;
 uniform vec3      u_Color;
 uniform bool      u_UseTexture;
 
+// Atlas pages as one texture array (unit 1)
+uniform sampler2DArray u_TextureArray;
+uniform bool           u_UseTextureArray;
+
 // Explicit output variable (replaces gl_FragColor)
 out vec4 FragColor;
 
 void main() {
-    if (u_UseTexture) {
+    if (u_UseTexture && u_UseTextureArray) {
+        FragColor = texture(u_TextureArray, vec3(v_TexCoord, v_Layer));
+    } else if (u_UseTexture) {
         FragColor = texture(u_Texture, v_TexCoord);
     } else {
         FragColor = vec4(u_Color, 1.0);
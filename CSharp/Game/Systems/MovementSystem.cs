@@ -4,7 +4,6 @@ using ScriptHost;
 using System;
 using System.Collections.Generic;
 using System.Linq;
-using System.Runtime.InteropServices;
 using WanderSpire.Components;
 using WanderSpire.Core.Events;
 using WanderSpire.Scripting;
@@ -32,17 +31,23 @@ namespace Game.Systems
         }
 
         readonly Dictionary<uint, State> _moving = new();
+        readonly Dictionary<uint, (uint Request, bool Run)> _requested = new();
 
         public MovementSystem()
         {
             if (Instance != null) throw new InvalidOperationException("Only one MovementSystem allowed");
             Instance = this;
             GameEventBus.Event<MovementIntentEvent>.Subscribe(OnIntent);
+            EventBus.PathApplied += OnPathApplied;
         }
 
         public void Dispose()
         {
             GameEventBus.Event<MovementIntentEvent>.Unsubscribe(OnIntent);
+            EventBus.PathApplied -= OnPathApplied;
+            foreach (var pending in _requested.Values)
+                Path_Cancel(Engine.Instance.Context, pending.Request);
+            _requested.Clear();
             _moving.Clear();
             Instance = null;
         }
@@ -121,29 +126,67 @@ namespace Game.Systems
                     ?? ent.GetScriptData<GridPositionComponent>(nameof(GridPositionComponent));
             var (sx, sy) = grid?.AsTuple() ?? (0, 0);
 
-            // 2) Ask native for the full path
-            IntPtr raw = Engine_FindPath(
+            // 2) Queue the search; native serves it within the per-frame path budget
+            //    and supersedes any request this entity still has pending
+            _moving.Remove(ev.EntityId);
+            uint request = Path_Request(
                 Engine.Instance.Context,
+                new EntityId { id = ev.EntityId },
                 sx, sy,
                 ev.TargetX, ev.TargetY,
-                ev.Run ? 1000 : 64);
-            if (raw == IntPtr.Zero) return;
-            string json = Marshal.PtrToStringAnsi(raw) ?? "[]";
-            Engine_FreeString(raw);
+                ev.Run ? 1000 : 64,
+                EntityId.Invalid,
+                0, 0, 0);
+            if (request == 0)
+            {
+                _requested.Remove(ev.EntityId);
+                return;
+            }
+            _requested[ev.EntityId] = (request, ev.Run);
+        }
 
-            var arr = JsonHelper.Deserialize<List<int[]>>(json);
-            if (arr == null || arr.Count < 2) return;
-            var path = arr.Select(a => (x: a[0], y: a[1])).ToList();
+        private void OnPathApplied(PathAppliedEvent ev)
+        {
+            // Only the latest request of an entity still wants its path
+            if (!_requested.TryGetValue(ev.entity, out var pending) || pending.Request != ev.requestId)
+                return;
+            _requested.Remove(ev.entity);
+
+            var path = ExpandCheckpoints(ev.GetCheckpoints());
+            if (path.Count < 2) return;
 
             // 3) Queue up for the next tick
-            _moving[ev.EntityId] = new State
+            _moving[ev.entity] = new State
             {
                 Path = path,
-                Run = ev.Run,
+                Run = pending.Run,
                 NextIndex = 1,  // index 0 is spot-in-place
-                StepInterval = Engine.Instance.TickInterval * (ev.Run ? 0.5f : 1f),
+                StepInterval = Engine.Instance.TickInterval * (pending.Run ? 0.5f : 1f),
                 InterpStarted = false
             };
         }
+
+        /// <summary>
+        /// Checkpoints mark where a path turns; every run between two of them is
+        /// straight, so stepping towards the next one restores each tile.
+        /// </summary>
+        static List<(int x, int y)> ExpandCheckpoints((int X, int Y)[] checkpoints)
+        {
+            var path = new List<(int x, int y)>();
+            if (checkpoints.Length == 0) return path;
+
+            path.Add((checkpoints[0].X, checkpoints[0].Y));
+            for (int i = 1; i < checkpoints.Length; i++)
+            {
+                var (x, y) = path[^1];
+                while (x != checkpoints[i].X || y != checkpoints[i].Y)
+                {
+                    x += Math.Sign(checkpoints[i].X - x);
+                    y += Math.Sign(checkpoints[i].Y - y);
+                    path.Add((x, y));
+                }
+            }
+            return path;
+        }
     }
 }
@@ -22,6 +22,7 @@ namespace SceneEditor.Rendering
         private const float GRID = 32f;
         private readonly Vector3 _gridCol = new(0.3f, 0.3f, 0.3f);
         private readonly Vector3 _axisCol = new(0.8f, 0.8f, 0.8f);
+        private readonly List<DebugLinePrimitive> _gridLines = new();
 
         // textures
         private readonly Dictionary<string, uint> _tex = new();
@@ -123,28 +124,29 @@ namespace SceneEditor.Rendering
             float ex = MathF.Ceiling(b.MaxX / GRID) * GRID;
             float ey = MathF.Ceiling(b.MaxY / GRID) * GRID;
 
+            // All grid lines cross the interop boundary in one call and draw in one batch
+            uint grid = PackColour(_gridCol), axis = PackColour(_axisCol);
+            _gridLines.Clear();
             for (float x = sx; x <= ex; x += GRID)
-            {
-                EngineInterop.Engine_DrawDebugLine(_ctx, x, b.MinY, x, b.MaxY, _gridCol.X, _gridCol.Y, _gridCol.Z, 1f);
-                Stats.DrawCalls++;
-            }
+                _gridLines.Add(new DebugLinePrimitive { x1 = x, y1 = b.MinY, x2 = x, y2 = b.MaxY, colour = grid, width = 1f });
             for (float y = sy; y <= ey; y += GRID)
-            {
-                EngineInterop.Engine_DrawDebugLine(_ctx, b.MinX, y, b.MaxX, y, _gridCol.X, _gridCol.Y, _gridCol.Z, 1f);
-                Stats.DrawCalls++;
-            }
+                _gridLines.Add(new DebugLinePrimitive { x1 = b.MinX, y1 = y, x2 = b.MaxX, y2 = y, colour = grid, width = 1f });
             if (b.MinX <= 0 && b.MaxX >= 0)
-            {
-                EngineInterop.Engine_DrawDebugLine(_ctx, 0, b.MinY, 0, b.MaxY, _axisCol.X, _axisCol.Y, _axisCol.Z, 2f);
-                Stats.DrawCalls++;
-            }
+                _gridLines.Add(new DebugLinePrimitive { x1 = 0, y1 = b.MinY, x2 = 0, y2 = b.MaxY, colour = axis, width = 2f });
             if (b.MinY <= 0 && b.MaxY >= 0)
-            {
-                EngineInterop.Engine_DrawDebugLine(_ctx, b.MinX, 0, b.MaxX, 0, _axisCol.X, _axisCol.Y, _axisCol.Z, 2f);
-                Stats.DrawCalls++;
-            }
+                _gridLines.Add(new DebugLinePrimitive { x1 = b.MinX, y1 = 0, x2 = b.MaxX, y2 = 0, colour = axis, width = 2f });
+
+            var lines = _gridLines.ToArray();
+            EngineInterop.Engine_DebugDrawBatch(_ctx, lines, lines.Length, null, 0, null, 0);
+            Stats.DrawCalls++;
         }
 
+        private static uint PackColour(Vector3 c) =>
+            0xFF000000u
+            | ((uint)(Math.Clamp(c.X, 0f, 1f) * 255f + 0.5f) << 16)
+            | ((uint)(Math.Clamp(c.Y, 0f, 1f) * 255f + 0.5f) << 8)
+            | (uint)(Math.Clamp(c.Z, 0f, 1f) * 255f + 0.5f);
+
         private void DrawTilemaps(EditorCamera cam)
         {
             uint[] buf = new uint[512];
@@ -84,6 +84,128 @@ namespace WanderSpire.Scripting
         public long peakMemoryUsed;
     }
 
+    /// <summary>
+    /// Stream buffer upload and stall counters
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct RenderStreamStats
+    {
+        public long bytesLastFrame;
+        public long instanceBytes;
+        public long spriteBytes;
+        public long debugBytes;
+        public long bytesTotal;
+        public long allocations;
+        public long failedAllocations;
+        public long stalls;
+        public double stallMicros;
+        public long wraps;
+        public long capacity;
+        public int framesInFlight;
+        public int persistent;
+    }
+
+    /// <summary>
+    /// GL state cache counters. Per-kind order: program, vertex array, buffer,
+    /// texture, capability, blend, depth, scissor, viewport, framebuffer, clear color
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLStateCacheStats
+    {
+        public long requested;
+        public long skipped;
+        public long queries;
+        public long invalidations;
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 11)]
+        public long[] requestedByKind;
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 11)]
+        public long[] skippedByKind;
+    }
+
+    /// <summary>
+    /// Render thread counters; times in microseconds, averages smoothed over recent frames
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct RenderThreadReport
+    {
+        public int threaded;
+        public long framesSubmitted;
+        public long framesPresented;
+        public long contextBorrows;
+        public double lastRenderMicros;
+        public double averageRenderMicros;
+        public double averageBuildMicros;
+        public double lastPaceWaitMicros;
+        public double paceWaitMicros;
+    }
+
+    /// <summary>
+    /// How a generated atlas was packed
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct AtlasPackReport
+    {
+        public int images;
+        public int pages;
+        public int rejected;
+        public long usedArea;
+        public long pageArea;
+        public double efficiency;
+        public int textureArray;
+        public int batchesPerPass;
+        public int cached;
+    }
+
+    /// <summary>
+    /// Debug line for Engine_DebugDrawBatch; colour is 0xAARRGGBB, duration in seconds
+    /// (0 draws once, float.PositiveInfinity until cleared)
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct DebugLinePrimitive
+    {
+        public float x1, y1, x2, y2;
+        public uint colour;
+        public float width;
+        public float duration;
+    }
+
+    /// <summary>
+    /// Debug rectangle for Engine_DebugDrawBatch, from its bottom-left corner
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct DebugRectPrimitive
+    {
+        public float x, y;
+        public float width, height;
+        public uint colour;
+        public int filled;
+        public float duration;
+    }
+
+    /// <summary>
+    /// Debug circle for Engine_DebugDrawBatch
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct DebugCirclePrimitive
+    {
+        public float x, y, radius;
+        public uint colour;
+        public int segments;
+        public float duration;
+    }
+
+    /// <summary>
+    /// Debug geometry of the last frame
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct DebugDrawReport
+    {
+        public int lines;
+        public int quads;
+        public int persistent;
+        public int drawCalls;
+    }
+
     /// <summary>
     /// Profiling section result
     /// </summary>
@@ -433,11 +555,69 @@ namespace WanderSpire.Scripting
             IntPtr ctx, int startX, int startY, int targetX, int targetY,
             int maxRange, EntityId tilemapLayer);
 
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int Engine_AreConnected(
+            IntPtr ctx, int ax, int ay, int bx, int by, EntityId tilemapLayer);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern IntPtr Engine_FindWeightedPath(
+            IntPtr ctx, int startX, int startY, int targetX, int targetY,
+            int maxRange, EntityId tilemapLayer);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Engine_SetMovementCostOverlay(IntPtr ctx, int x, int y, int cost);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Engine_ClearMovementCostOverlay(IntPtr ctx, int x, int y);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern uint Path_Request(
+            IntPtr ctx, EntityId entity, int startX, int startY, int targetX, int targetY,
+            int maxRange, EntityId tilemapLayer, int weighted, int priority, uint deadlineMicros);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int Path_Cancel(IntPtr ctx, uint requestId);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int Path_CancelForEntity(IntPtr ctx, EntityId entity);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int Path_GetPendingCount(IntPtr ctx);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Path_SetFrameBudget(IntPtr ctx, uint budgetMicros);
+
         [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
         public static extern void Engine_FreeString(IntPtr str);
 
         #endregion
 
+        #region Visibility API
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int Visibility_GetFOVMaskSize(int radius);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int Visibility_ComputeFOV(
+            IntPtr ctx, EntityId tilemapLayer, int originX, int originY, int radius,
+            [Out] byte[] outMask, int maskSize);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int Visibility_ComputeFOVBatch(
+            IntPtr ctx, EntityId tilemapLayer, [In] int[] observersXY, int observerCount, int radius,
+            [Out] byte[] outMasks, int maskStride);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int Visibility_HasLineOfSight(
+            IntPtr ctx, EntityId tilemapLayer, int fromX, int fromY, int toX, int toY);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int Visibility_HasLineOfSightBatch(
+            IntPtr ctx, EntityId tilemapLayer, [In] int[] pairs, int pairCount, float maxDistance,
+            [Out] byte[] outVisible);
+
+        #endregion
+
         #region Scene Management API
 
         [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
@@ -906,6 +1086,27 @@ namespace WanderSpire.Scripting
         public static extern void Engine_DrawDebugRect(IntPtr ctx, float x, float y, float width, float height,
             float colorR, float colorG, float colorB, int filled);
 
+        /// <summary>
+        /// Queue arrays of debug primitives in one call; any array may be null
+        /// </summary>
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Engine_DebugDrawBatch(IntPtr ctx,
+            [In] DebugLinePrimitive[] lines, int lineCount,
+            [In] DebugRectPrimitive[] rects, int rectCount,
+            [In] DebugCirclePrimitive[] circles, int circleCount);
+
+        /// <summary>
+        /// Drop debug primitives and overlays kept alive by a duration
+        /// </summary>
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Engine_DebugDrawClear(IntPtr ctx);
+
+        /// <summary>
+        /// Get debug draw statistics of the last frame
+        /// </summary>
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Engine_GetDebugDrawStats(IntPtr ctx, out DebugDrawReport report);
+
         #endregion
 
         #region Performance and Profiling
@@ -916,6 +1117,66 @@ namespace WanderSpire.Scripting
         [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
         public static extern void Engine_GetPerformanceMetrics(IntPtr ctx, out PerformanceMetrics metrics);
 
+        /// <summary>
+        /// Get stream buffer upload and stall counters
+        /// </summary>
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Engine_GetRenderStreamStats(IntPtr ctx, out RenderStreamStats stats);
+
+        /// <summary>
+        /// Reset the stream buffer counters
+        /// </summary>
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Engine_ResetRenderStreamStats(IntPtr ctx);
+
+        /// <summary>
+        /// Get redundant GL state change counters
+        /// </summary>
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Engine_GetGLStateCacheStats(IntPtr ctx, out GLStateCacheStats stats);
+
+        /// <summary>
+        /// Reset the GL state cache counters
+        /// </summary>
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Engine_ResetGLStateCacheStats(IntPtr ctx);
+
+        /// <summary>
+        /// Forget the cached GL state; call after GL code outside the engine changed it
+        /// </summary>
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Engine_InvalidateGLStateCache(IntPtr ctx);
+
+        /// <summary>
+        /// Threads building render commands, the main thread included (0 = automatic, 1 = serial)
+        /// </summary>
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Engine_SetRenderPrepThreads(IntPtr ctx, int threads);
+
+        /// <summary>
+        /// Draw and present frames on a dedicated render thread (standalone only). Returns 1 if threaded
+        /// </summary>
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int Engine_SetRenderThreadEnabled(IntPtr ctx, int enabled);
+
+        /// <summary>
+        /// Get render thread pacing and timing counters
+        /// </summary>
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Engine_GetRenderThreadStats(IntPtr ctx, out RenderThreadReport stats);
+
+        /// <summary>
+        /// Reset the render thread counters
+        /// </summary>
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Engine_ResetRenderThreadStats(IntPtr ctx);
+
+        /// <summary>
+        /// Get the packing report of a generated atlas. Returns 0 if it was not generated
+        /// </summary>
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int Engine_GetAtlasPackReport(IntPtr ctx, [MarshalAs(UnmanagedType.LPStr)] string atlasName, out AtlasPackReport report);
+
         /// <summary>
         /// Start performance profiling section
         /// </summary>
@@ -31,6 +31,7 @@ namespace WanderSpire.Core.Events
         // Pass checkpoint count and pointer to native array, or use a callback to fetch the checkpoints.
         public IntPtr checkpoints; // pointer to native array of int[2]
         public int checkpointCount;
+        public uint requestId;     // id from Path_Request, 0 for direct paths
 
         // Helper to read as managed array if needed
         public (int X, int Y)[] GetCheckpoints()
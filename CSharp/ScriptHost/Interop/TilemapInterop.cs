@@ -4,6 +4,82 @@ using System.Runtime.InteropServices;
 
 namespace WanderSpire.Scripting
 {
+    /// <summary>
+    /// One journaled tilemap edit: tiles in [min, max] of a chunk changed
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct TilemapChangeRecord
+    {
+        public ulong sequence;
+        public ulong chunkVersion;
+        public uint layer;
+        public int chunkX, chunkY;
+        public int minX, minY, maxX, maxY;
+        public int removed;
+    }
+
+    /// <summary>
+    /// Counters of the compressed cache of recently unloaded chunks
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct TilemapChunkCacheStats
+    {
+        public ulong hits;
+        public ulong misses;
+        public ulong stores;
+        public ulong evictions;
+        public long entries;
+        public long bytes;
+        public long rawBytes;
+        public long budgetBytes;
+        public double avgStoreMicros;
+        public double avgRestoreMicros;
+    }
+
+    /// <summary>
+    /// Pattern stamped onto generated terrain (tiles: width*height ints, -1 keeps terrain)
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ChunkGenStamp
+    {
+        public int width, height;
+        public IntPtr tiles;
+        public int onTileId;
+        public float density;
+    }
+
+    /// <summary>
+    /// Built-in noise chunk generator; pointer fields reference pinned arrays
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct NoiseChunkGeneratorDesc
+    {
+        public ulong seed;
+        public int noiseType;
+        public float frequency;
+        public int octaves;
+        public float persistence;
+        public float lacunarity;
+        public IntPtr bandMaxHeights;
+        public IntPtr bandTileIds;
+        public int bandCount;
+        public int fallbackTileId;
+        public IntPtr stamps;
+        public int stampCount;
+    }
+
+    /// <summary>
+    /// Min, max and sum of a tile attribute channel over a rectangle
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct TileAttributeStats
+    {
+        public float min;
+        public float max;
+        public double sum;
+        public long count;
+    }
+
     /// <summary>
     /// Tilemap and tile-related functionality interop
     /// </summary>
@@ -53,6 +129,116 @@ namespace WanderSpire.Scripting
 
         #endregion
 
+        #region Tilemap Change Journal API
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern uint TileJournal_Subscribe(IntPtr ctx);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void TileJournal_Unsubscribe(IntPtr ctx, uint subscriber);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TileJournal_Poll(
+            IntPtr ctx, uint subscriber, [Out] TilemapChangeRecord[] outRecords, int maxRecords, out int outOverflowed);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void TileJournal_SetCapacity(IntPtr ctx, int records);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern ulong Tilemap_GetChunkVersion(
+            IntPtr ctx, EntityId tilemapLayer, int chunkX, int chunkY);
+
+        #endregion
+
+        #region Tilemap Chunk Cache API
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Tilemap_GetChunkCacheStats(IntPtr ctx, out TilemapChunkCacheStats stats);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Tilemap_ResetChunkCacheStats(IntPtr ctx);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Tilemap_SetChunkCacheBudget(IntPtr ctx, long bytes);
+
+        #endregion
+
+        #region Procedural Chunk Generation API
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int Tilemap_SetNoiseGenerator(IntPtr ctx, EntityId tilemapLayer, ref NoiseChunkGeneratorDesc desc);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Tilemap_ClearGenerator(IntPtr ctx, EntityId tilemapLayer);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int Tilemap_GetPendingGeneration(IntPtr ctx);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int Tilemap_DrainGeneration(IntPtr ctx);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Tilemap_SetGenerationThreads(IntPtr ctx, int threads);
+
+        #endregion
+
+        #region Tilemap File API
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int Tilemap_SaveLayerFile(IntPtr ctx, EntityId tilemapLayer, [MarshalAs(UnmanagedType.LPStr)] string path);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int Tilemap_OpenLayerFile(IntPtr ctx, EntityId tilemapLayer, [MarshalAs(UnmanagedType.LPStr)] string path);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Tilemap_CloseLayerFile(IntPtr ctx, EntityId tilemapLayer);
+
+        #endregion
+
+        #region Tile Attribute API
+
+        // Channel types: 0 = byte, 1 = ushort, 2 = float, 3 = flag (one byte per tile in rect copies)
+        // Comparisons:   0 ==, 1 !=, 2 <, 3 <=, 4 >, 5 >=
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int Tilemap_CreateAttributeChannel(IntPtr ctx, EntityId tilemapLayer,
+            [MarshalAs(UnmanagedType.LPStr)] string name, int type, float defaultValue);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int Tilemap_FindAttributeChannel(IntPtr ctx, EntityId tilemapLayer,
+            [MarshalAs(UnmanagedType.LPStr)] string name);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int Tilemap_RemoveAttributeChannel(IntPtr ctx, EntityId tilemapLayer, int channel);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern float Tilemap_GetAttribute(IntPtr ctx, EntityId tilemapLayer, int channel, int x, int y);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Tilemap_SetAttribute(IntPtr ctx, EntityId tilemapLayer, int channel, int x, int y, float value);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Tilemap_FillAttributeRect(IntPtr ctx, EntityId tilemapLayer, int channel,
+            int minX, int minY, int maxX, int maxY, float value);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int Tilemap_ReadAttributeRect(IntPtr ctx, EntityId tilemapLayer, int channel,
+            int minX, int minY, int maxX, int maxY, IntPtr outValues);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int Tilemap_WriteAttributeRect(IntPtr ctx, EntityId tilemapLayer, int channel,
+            int minX, int minY, int maxX, int maxY, IntPtr values);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Tilemap_QueryAttributeRect(IntPtr ctx, EntityId tilemapLayer, int channel,
+            int minX, int minY, int maxX, int maxY, out TileAttributeStats outStats);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern long Tilemap_CountAttributeWhere(IntPtr ctx, EntityId tilemapLayer, int channel,
+            int minX, int minY, int maxX, int maxY, int compare, float value);
+
+        #endregion
+
         #region Tile Palette API
 
         [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
@@ -205,6 +391,12 @@ namespace WanderSpire.Scripting
         [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
         public static extern void TilemapLayer_Reorder(IntPtr ctx, EntityId layer, int newSortOrder);
 
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void TilemapLayer_SetTileLookup(IntPtr ctx, EntityId layer, int enabled);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TilemapLayer_GetTileLookup(IntPtr ctx, EntityId layer);
+
         [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
         public static extern int TilemapLayer_GetPaintable(IntPtr ctx, [Out] uint[] outLayers, int maxCount);
 
@@ -270,6 +462,12 @@ namespace WanderSpire.Scripting
             [MarshalAs(UnmanagedType.LPStr)] string atlasName,
             [MarshalAs(UnmanagedType.LPStr)] string frameName);
 
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void TileDef_SetBlocksVision(IntPtr ctx, int tileId, int blocksVision);
+
+        [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void TileDef_SetMovementCost(IntPtr ctx, int tileId, int movementCost);
+
         [DllImport(DLL, CallingConvention = CallingConvention.Cdecl)]
         public static extern int TileDef_GetCount(IntPtr ctx);
 
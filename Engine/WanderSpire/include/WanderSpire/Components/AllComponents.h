@@ -34,6 +34,7 @@
 #include "WanderSpire/Components/TileComponent.h"
 #include "WanderSpire/Components/TilemapChunkComponent.h"
 #include "WanderSpire/Components/TilemapLayerComponent.h"
+#include "WanderSpire/Components/TileAttributeComponent.h"
 
 // ─── asset & prefab ─────────────────────────────────────
 #include "WanderSpire/Components/AssetReferenceComponent.h"
@@ -12,6 +12,7 @@ namespace WanderSpire {
 		glm::vec2 uvOffset{ 0.0f, 0.0f };      ///< lower‑left UV
 		glm::vec2 uvSize{ 1.0f, 1.0f };      ///< size in UV space
 		glm::vec2 worldSize{ 1.0f, 1.0f };      ///< size in world units
+		int       textureLayer = -1;            ///< page of an array atlas, -1 for 2D textures
 	};
 
 }
\ No newline at end of file
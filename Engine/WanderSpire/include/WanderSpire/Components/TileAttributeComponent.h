@@ -0,0 +1,174 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "WanderSpire/Core/ReflectionMacros.h"
+
+namespace WanderSpire {
+
+	enum class TileAttributeType : uint8_t {
+		U8 = 0,
+		U16 = 1,
+		F32 = 2,
+		Flag = 3,    ///< One bit per tile
+	};
+
+	/// One named per-tile value on a layer. Blocks are allocated per chunk
+	/// (chunkSize² values, row-major, in the channel's own type) the first time
+	/// a tile of that chunk gets a non-default value; other chunks read as the
+	/// default.
+	struct TileAttributeChannel {
+		std::string name;                 // Empty = free slot
+		uint16_t generation = 0;          // Bumped when the slot is freed, so old ids go stale
+		TileAttributeType type = TileAttributeType::U8;
+		float defaultValue = 0.0f;
+		std::unordered_map<uint64_t, std::vector<uint64_t>> blocks;   // Chunk key → storage words
+
+		static size_t BlockWords(TileAttributeType type, int tileCount) {
+			const size_t n = static_cast<size_t>(tileCount);
+			switch (type) {
+			case TileAttributeType::U8:  return (n + 7) / 8;
+			case TileAttributeType::U16: return (n * 2 + 7) / 8;
+			case TileAttributeType::F32: return (n * 4 + 7) / 8;
+			case TileAttributeType::Flag: return (n + 63) / 64;
+			}
+			return 0;
+		}
+
+		/// Value as stored: integers round and clamp, flags are 0 or 1
+		static float Quantize(TileAttributeType type, float value) {
+			switch (type) {
+			case TileAttributeType::U8:  return std::clamp(std::round(value), 0.0f, 255.0f);
+			case TileAttributeType::U16: return std::clamp(std::round(value), 0.0f, 65535.0f);
+			case TileAttributeType::F32: return value;
+			case TileAttributeType::Flag: return value != 0.0f ? 1.0f : 0.0f;
+			}
+			return value;
+		}
+
+		static float Load(const uint64_t* block, TileAttributeType type, int index) {
+			switch (type) {
+			case TileAttributeType::U8:  return reinterpret_cast<const uint8_t*>(block)[index];
+			case TileAttributeType::U16: return reinterpret_cast<const uint16_t*>(block)[index];
+			case TileAttributeType::F32: return reinterpret_cast<const float*>(block)[index];
+			case TileAttributeType::Flag: return static_cast<float>((block[index >> 6] >> (index & 63)) & 1u);
+			}
+			return 0.0f;
+		}
+
+		static void Store(uint64_t* block, TileAttributeType type, int index, float value) {
+			value = Quantize(type, value);
+			switch (type) {
+			case TileAttributeType::U8:  reinterpret_cast<uint8_t*>(block)[index] = static_cast<uint8_t>(value); break;
+			case TileAttributeType::U16: reinterpret_cast<uint16_t*>(block)[index] = static_cast<uint16_t>(value); break;
+			case TileAttributeType::F32: reinterpret_cast<float*>(block)[index] = value; break;
+			case TileAttributeType::Flag:
+				if (value != 0.0f) block[index >> 6] |= uint64_t(1) << (index & 63);
+				else block[index >> 6] &= ~(uint64_t(1) << (index & 63));
+				break;
+			}
+		}
+
+		/// A block holding the default everywhere
+		std::vector<uint64_t> MakeBlock(int tileCount) const {
+			std::vector<uint64_t> block(BlockWords(type, tileCount), 0);
+			if (Quantize(type, defaultValue) != 0.0f) {
+				for (int i = 0; i < tileCount; ++i) Store(block.data(), type, i, defaultValue);
+			}
+			return block;
+		}
+	};
+
+	/// Per-tile attribute channels of a tilemap layer (see TileAttributes)
+	struct TileAttributeComponent {
+		int chunkSize = 32;
+		std::vector<TileAttributeChannel> channels;
+
+		static const char* TypeName(TileAttributeType type) {
+			switch (type) {
+			case TileAttributeType::U8:  return "u8";
+			case TileAttributeType::U16: return "u16";
+			case TileAttributeType::F32: return "f32";
+			case TileAttributeType::Flag: return "flag";
+			}
+			return "u8";
+		}
+
+		/// Blocks are written as flat value arrays, keyed by chunk coordinates
+		nlohmann::json ToJson() const
+		{
+			nlohmann::json j;
+			j["chunkSize"] = chunkSize;
+			j["channels"] = nlohmann::json::array();
+			const int tileCount = chunkSize * chunkSize;
+			for (const auto& channel : channels) {
+				// Free slots and generations are kept so channel ids survive a round trip
+				if (channel.name.empty()) {
+					j["channels"].push_back({ { "name", "" }, { "generation", channel.generation } });
+					continue;
+				}
+				nlohmann::json chunks = nlohmann::json::array();
+				for (const auto& [key, block] : channel.blocks) {
+					std::vector<float> values(static_cast<size_t>(tileCount));
+					for (int i = 0; i < tileCount; ++i) values[i] = TileAttributeChannel::Load(block.data(), channel.type, i);
+					chunks.push_back({
+						{ "coords", { static_cast<int32_t>(key >> 32), static_cast<int32_t>(key & 0xffffffffu) } },
+						{ "values", std::move(values) }
+						});
+				}
+				j["channels"].push_back({
+					{ "name",    channel.name },
+					{ "generation", channel.generation },
+					{ "type",    TypeName(channel.type) },
+					{ "default", channel.defaultValue },
+					{ "chunks",  std::move(chunks) }
+					});
+			}
+			return j;
+		}
+
+		void LoadFromJson(const nlohmann::json& j)
+		{
+			channels.clear();
+			chunkSize = j.value("chunkSize", 32);
+			const int tileCount = chunkSize * chunkSize;
+			if (!j.contains("channels") || !j["channels"].is_array()) return;
+
+			for (const auto& obj : j["channels"]) {
+				TileAttributeChannel channel;
+				channel.name = obj.value("name", std::string{});
+				channel.generation = obj.value("generation", uint16_t{ 0 });
+				if (channel.name.empty()) {
+					channels.push_back(std::move(channel));
+					continue;
+				}
+				const std::string type = obj.value("type", std::string("u8"));
+				channel.type = type == "u16" ? TileAttributeType::U16
+					: type == "f32" ? TileAttributeType::F32
+					: type == "flag" ? TileAttributeType::Flag
+					: TileAttributeType::U8;
+				channel.defaultValue = obj.value("default", 0.0f);
+
+				for (const auto& chunk : obj.value("chunks", nlohmann::json::array())) {
+					const auto coords = chunk.value("coords", std::vector<int>{});
+					const auto values = chunk.value("values", std::vector<float>{});
+					if (coords.size() < 2 || values.size() != static_cast<size_t>(tileCount)) continue;
+
+					const uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(coords[0])) << 32) |
+						static_cast<uint32_t>(coords[1]);
+					auto& block = channel.blocks[key];
+					block.assign(TileAttributeChannel::BlockWords(channel.type, tileCount), 0);
+					for (int i = 0; i < tileCount; ++i) TileAttributeChannel::Store(block.data(), channel.type, i, values[i]);
+				}
+				channels.push_back(std::move(channel));
+			}
+		}
+	};
+
+} // namespace WanderSpire
+
+REFLECT_TYPE(WanderSpire::TileAttributeComponent)
@@ -2,14 +2,106 @@
 #pragma once
 #include <glm/glm.hpp>
 #include <vector>
+#include <algorithm>
 #include <cstdint>
+#include <memory>
+#include <utility>
 #include "WanderSpire/Core/ReflectionMacros.h"
+#include "WanderSpire/World/PalettedTileStorage.h"
 #include <spdlog/spdlog.h>
 
 #include <nlohmann/json.hpp>
 
 namespace WanderSpire {
 
+	/// Incrementally maintained digest of a chunk's tiles, so region queries can
+	/// skip chunks that cannot match. Runtime only; never serialized.
+	struct TileChunkSummary {
+		bool valid = false;                       // false → rebuild from tileIds before use
+		bool boundsStale = false;                 // an edge tile was erased; recompute bounds
+		int occupancy = 0;                        // Non-empty tiles
+		glm::ivec2 boundsMin{ INT32_MAX, INT32_MAX };   // Local, inclusive, over non-empty tiles
+		glm::ivec2 boundsMax{ INT32_MIN, INT32_MIN };
+		std::vector<std::pair<int, int>> histogram;      // (tileId, count), non-empty ids only
+
+		int Count(int tileId) const {
+			for (const auto& [id, count] : histogram)
+				if (id == tileId) return count;
+			return 0;
+		}
+
+		void Rebuild(const int* tileIds, int tileCount, int chunkSize) {
+			histogram.clear();
+			occupancy = 0;
+			for (int i = 0; i < tileCount; ++i) {
+				if (tileIds[i] != -1) Adjust(tileIds[i], 1);
+			}
+			RecomputeBounds(tileIds, tileCount, chunkSize);
+			valid = true;
+		}
+
+		void RecomputeBounds(const int* tileIds, int tileCount, int chunkSize) {
+			boundsMin = { INT32_MAX, INT32_MAX };
+			boundsMax = { INT32_MIN, INT32_MIN };
+			for (int i = 0; i < tileCount; ++i) {
+				if (tileIds[i] == -1) continue;
+				const glm::ivec2 p{ i % chunkSize, i / chunkSize };
+				boundsMin = glm::min(boundsMin, p);
+				boundsMax = glm::max(boundsMax, p);
+			}
+			boundsStale = false;
+		}
+
+		/// Record one tile write at a flat local index
+		void OnTileChanged(int oldId, int newId, int index, int chunkSize) {
+			if (!valid || oldId == newId) return;
+			if (oldId != -1) Adjust(oldId, -1);
+			if (newId != -1) {
+				Adjust(newId, 1);
+				const glm::ivec2 p{ index % chunkSize, index / chunkSize };
+				boundsMin = glm::min(boundsMin, p);
+				boundsMax = glm::max(boundsMax, p);
+			}
+			else {
+				const glm::ivec2 p{ index % chunkSize, index / chunkSize };
+				if (p.x == boundsMin.x || p.y == boundsMin.y || p.x == boundsMax.x || p.y == boundsMax.y)
+					boundsStale = true;
+			}
+		}
+
+		/// Record `count` tiles switching from one id to another
+		void OnTilesReplaced(int fromId, int toId, int count) {
+			if (!valid || fromId == toId || count <= 0) return;
+			if (fromId != -1) Adjust(fromId, -count);
+			if (toId != -1) Adjust(toId, count);
+			if (fromId == -1 || toId == -1) boundsStale = true;
+		}
+
+	private:
+		void Adjust(int tileId, int delta) {
+			occupancy += delta;
+			for (size_t i = 0; i < histogram.size(); ++i) {
+				if (histogram[i].first != tileId) continue;
+				histogram[i].second += delta;
+				if (histogram[i].second <= 0) {
+					histogram[i] = histogram.back();
+					histogram.pop_back();
+				}
+				return;
+			}
+			if (delta > 0) histogram.emplace_back(tileId, delta);
+		}
+	};
+
+	/// Tiles of one chunk read in place from a memory-mapped tilemap file
+	/// (see TilemapFileReader). `owner` keeps the mapping alive.
+	struct MappedChunkTiles {
+		const int* tileIds = nullptr;
+		const uint32_t* tileData = nullptr;   // null → all zero
+		int tileCount = 0;
+		std::shared_ptr<const void> owner;
+	};
+
 	struct TilemapChunkComponent {
 		glm::ivec2 chunkCoords{ 0, 0 };
 		int chunkSize = 32;          // Tiles per chunk
@@ -23,12 +115,122 @@ namespace WanderSpire {
 		std::vector<int> tileIds;    // Flat array of tile IDs
 		std::vector<uint32_t> tileData; // Additional per-tile data
 
+		// Compact storage: while `compact` is set, tileIds/tileData are empty and
+		// the tiles live palette-packed in `packed` (see TilemapSystem::CompactChunk),
+		// or in `shared`, an immutable payload interned by ChunkPayloadPool that
+		// identical chunks point at. Writes split a shared chunk first (Unshare).
+		// A chunk opened from a tilemap file is compact with `mapped` set: its
+		// tiles stay on the file's mapped pages until the first write.
+		bool compact = false;
+		PalettedTileStorage packed;
+		std::shared_ptr<const PalettedTileStorage> shared;
+		std::shared_ptr<const MappedChunkTiles> mapped;
+
 		// Rendering optimization
 		uint32_t instanceVBO = 0;    // GPU buffer for instanced rendering
 		int instanceCount = 0;
+
+		// Region query acceleration (maintained by TilemapSystem writes)
+		TileChunkSummary summary;
+
+		// Version of the latest journaled change (see TilemapChangeJournal)
+		uint64_t version = 0;
+		uint64_t sourceVersion = 0;              // Version when the tiles last matched the layer file/generator
+		uint64_t idleCheckVersion = UINT64_MAX;   // Version seen by the last streaming pass
+
+		/// Packed tiles of a compact chunk, shared or private (not for mapped chunks)
+		const PalettedTileStorage& Packed() const {
+			return shared ? *shared : packed;
+		}
+
+		int TileCount() const {
+			if (!compact) return static_cast<int>(tileIds.size());
+			return mapped ? mapped->tileCount : Packed().TileCount();
+		}
+
+		int TileAt(int index) const {
+			if (!compact) return tileIds[index];
+			return mapped ? mapped->tileIds[index] : Packed().Get(index);
+		}
+
+		/// Flat tile ids, decoded into scratch when the chunk is packed
+		const int* ReadTileIds(std::vector<int>& scratch) const {
+			if (!compact) return tileIds.data();
+			if (mapped) return mapped->tileIds;
+			scratch.resize(static_cast<size_t>(Packed().TileCount()));
+			Packed().Decode(scratch.data());
+			return scratch.data();
+		}
+
+		/// Flat tile data, decoded into scratch unless the chunk is flat
+		const uint32_t* ReadTileData(std::vector<uint32_t>& scratch) const {
+			if (!compact && tileData.size() == tileIds.size()) return tileData.data();
+			if (mapped && mapped->tileData) return mapped->tileData;
+			scratch.assign(static_cast<size_t>(TileCount()), 0);
+			if (compact && !mapped) Packed().DecodeData(scratch.data());
+			else if (!compact) std::copy_n(tileData.begin(), std::min(tileData.size(), scratch.size()), scratch.begin());
+			return scratch.data();
+		}
+
+		/// Copy `count` consecutive tile ids starting at `first`
+		void ReadTileRange(int first, int count, int* out) const {
+			if (!compact) std::copy_n(tileIds.data() + first, count, out);
+			else if (mapped) std::copy_n(mapped->tileIds + first, count, out);
+			else Packed().DecodeRange(first, count, out);
+		}
+
+		/// Switch to palette-packed storage and release the flat arrays
+		void Compact() {
+			if (compact) return;
+			packed.Encode(tileIds.data(), tileData.size() == tileIds.size() ? tileData.data() : nullptr,
+				static_cast<int>(tileIds.size()));
+			std::vector<int>().swap(tileIds);
+			std::vector<uint32_t>().swap(tileData);
+			compact = true;
+		}
+
+		/// Copy-on-write: take a private copy of a shared or mapped payload before writing to it
+		void Unshare() {
+			if (mapped) {
+				packed.Encode(mapped->tileIds, mapped->tileData, mapped->tileCount);
+				mapped.reset();
+			}
+			if (!shared) return;
+			packed = *shared;
+			shared.reset();
+		}
+
+		/// Restore flat arrays for direct editing
+		void Expand() {
+			if (!compact) return;
+			if (mapped) {
+				tileIds.assign(mapped->tileIds, mapped->tileIds + mapped->tileCount);
+				if (mapped->tileData) tileData.assign(mapped->tileData, mapped->tileData + mapped->tileCount);
+				else tileData.assign(tileIds.size(), 0);
+				mapped.reset();
+				compact = false;
+				return;
+			}
+			const PalettedTileStorage& tiles = Packed();
+			tileIds.resize(static_cast<size_t>(tiles.TileCount()));
+			tileData.resize(tileIds.size());
+			tiles.Decode(tileIds.data());
+			tiles.DecodeData(tileData.data());
+			packed = PalettedTileStorage{};
+			shared.reset();
+			compact = false;
+		}
 	};
 
-	inline void to_json(nlohmann::json& j, const TilemapChunkComponent& chunk) {
+	inline void to_json(nlohmann::json& j, const TilemapChunkComponent& compactable) {
+		// Compact chunks serialize exactly like expanded ones
+		TilemapChunkComponent expanded;
+		if (compactable.compact) {
+			expanded = compactable;
+			expanded.Expand();
+		}
+		const TilemapChunkComponent& chunk = compactable.compact ? expanded : compactable;
+
 		j = nlohmann::json{
 			{"chunkCoords", {chunk.chunkCoords.x, chunk.chunkCoords.y}},
 			{"chunkSize", chunk.chunkSize},
@@ -39,22 +241,14 @@ namespace WanderSpire {
 			{"tileIds", chunk.tileIds},
 			{"tileData", chunk.tileData}
 		};
-
-		spdlog::debug("[TilemapChunkComponent::to_json] Serializing chunk ({},{}) with {} tiles, {} data entries",
-			chunk.chunkCoords.x, chunk.chunkCoords.y,
-			chunk.tileIds.size(), chunk.tileData.size());
 	}
 
 	inline void from_json(const nlohmann::json& j, TilemapChunkComponent& chunk) {
-		spdlog::debug("[TilemapChunkComponent::from_json] Starting deserialization");
-
 		try {
 			// Load chunk coordinates
 			if (j.contains("chunkCoords") && j["chunkCoords"].is_array() && j["chunkCoords"].size() >= 2) {
 				chunk.chunkCoords.x = j["chunkCoords"][0].get<int>();
 				chunk.chunkCoords.y = j["chunkCoords"][1].get<int>();
-				spdlog::debug("[TilemapChunkComponent::from_json] Loaded chunk coords: ({}, {})",
-					chunk.chunkCoords.x, chunk.chunkCoords.y);
 			}
 			else {
 				spdlog::warn("[TilemapChunkComponent::from_json] Invalid or missing chunkCoords");
@@ -68,23 +262,11 @@ namespace WanderSpire {
 			chunk.visible = j.value("visible", true);
 			chunk.instanceCount = j.value("instanceCount", 0);
 
-			spdlog::debug("[TilemapChunkComponent::from_json] Basic properties loaded, chunkSize: {}", chunk.chunkSize);
 
 			// Load tile data with validation
 			if (j.contains("tileIds") && j["tileIds"].is_array()) {
 				try {
 					chunk.tileIds = j["tileIds"].get<std::vector<int>>();
-					spdlog::debug("[TilemapChunkComponent::from_json] Loaded {} tile IDs from JSON", chunk.tileIds.size());
-
-					// Sample some tiles for debugging
-					if (!chunk.tileIds.empty()) {
-						size_t sampleCount = std::min(chunk.tileIds.size(), size_t(5));
-						std::string sampleStr = "First tiles: ";
-						for (size_t i = 0; i < sampleCount; ++i) {
-							sampleStr += std::to_string(chunk.tileIds[i]) + " ";
-						}
-						spdlog::debug("[TilemapChunkComponent::from_json] {}", sampleStr);
-					}
 				}
 				catch (const std::exception& e) {
 					spdlog::error("[TilemapChunkComponent::from_json] Failed to parse tileIds: {}", e.what());
@@ -104,7 +286,6 @@ namespace WanderSpire {
 			if (j.contains("tileData") && j["tileData"].is_array()) {
 				try {
 					chunk.tileData = j["tileData"].get<std::vector<uint32_t>>();
-					spdlog::debug("[TilemapChunkComponent::from_json] Loaded {} tile data entries", chunk.tileData.size());
 				}
 				catch (const std::exception& e) {
 					spdlog::error("[TilemapChunkComponent::from_json] Failed to parse tileData: {}", e.what());
@@ -113,7 +294,6 @@ namespace WanderSpire {
 				}
 			}
 			else {
-				spdlog::debug("[TilemapChunkComponent::from_json] No tileData array found, creating empty");
 				chunk.tileData.clear();
 				chunk.tileData.resize(chunk.chunkSize * chunk.chunkSize, 0);
 			}
@@ -132,8 +312,6 @@ namespace WanderSpire {
 				chunk.tileData.resize(expectedSize, 0);
 			}
 
-			spdlog::debug("[TilemapChunkComponent::from_json] Successfully deserialized chunk ({},{}) with {} tiles",
-				chunk.chunkCoords.x, chunk.chunkCoords.y, chunk.tileIds.size());
 
 		}
 		catch (const std::exception& e) {
@@ -20,6 +20,7 @@ namespace WanderSpire {
 		// Rendering
 		int sortingOrder = 0;
 		std::string materialName;
+		bool tileLookup = false;        ///< Drawn by TileLookupRenderer (index texture) instead of per-tile instances
 
 		// Tile palette integration
 		int paletteId = 0;              ///< Which palette defines the tiles for this layer
@@ -38,6 +39,7 @@ REFLECTABLE(WanderSpire::TilemapLayerComponent,
 	FIELD(Int, physicsLayer, 0, 32, 1),
 	FIELD(Int, sortingOrder, -1000, 1000, 1),
 	FIELD(String, materialName, 0, 0, 0),
+	FIELD(Bool, tileLookup, 0, 1, 1),
 	FIELD(Int, paletteId, 0, 1000, 1),
 	FIELD(Bool, autoRefreshDefinitions, 0, 1, 1)
 )
\ No newline at end of file
@@ -24,6 +24,9 @@ namespace WanderSpire {
 		/// Must be called each frame on the main thread to flush main-thread callbacks.
 		void UpdateMainThread();
 
+		/// True if main-thread callbacks are waiting for UpdateMainThread()
+		bool HasMainThreadWork();
+
 	private:
 		AssetLoader();
 		~AssetLoader();
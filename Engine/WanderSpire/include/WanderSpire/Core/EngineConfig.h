@@ -7,6 +7,16 @@ struct EngineConfig {
 	float       tileSize = 64.0f;
 	float       tickInterval = 0.6f;
 	int         chunkSize = 32;
+	int         pathBudgetMicros = 2000;   // Per-frame time budget for queued path searches
+	int         chunkCacheKilobytes = 8192; // Compressed cache of recently unloaded chunks (0 = off)
+	int         chunkGenThreads = 0;       // Procedural chunk workers (0 = hardware threads - 1)
+	int         chunkGenBudgetMicros = 1000; // Per-frame time budget for installing generated chunks
+	int         renderPrepThreads = 0;     // Threads building render commands, main included (0 = hardware threads)
+	bool        renderThread = false;      // Draw and present on a dedicated render thread
+	int         atlasMaxPageSize = 2048;   // Largest generated atlas page; more sprites spill to new pages
+	int         atlasPadding = 2;          // Empty pixels between packed sprites
+	int         atlasExtrude = 1;          // Edge pixels repeated around packed sprites
+	bool        atlasTextureArray = false; // Upload multi-page atlases as one GL_TEXTURE_2D_ARRAY
 	std::string assetsRoot = "Assets/";
 	std::string mapsRoot = "Assets/maps/";
 
@@ -16,6 +26,16 @@ struct EngineConfig {
 			{"tileSize",     c.tileSize},
 			{"tickInterval", c.tickInterval},
 			{"chunkSize",    c.chunkSize},
+			{"pathBudgetMicros", c.pathBudgetMicros},
+			{"chunkCacheKilobytes", c.chunkCacheKilobytes},
+			{"chunkGenThreads", c.chunkGenThreads},
+			{"chunkGenBudgetMicros", c.chunkGenBudgetMicros},
+			{"renderPrepThreads", c.renderPrepThreads},
+			{"renderThread", c.renderThread},
+			{"atlasMaxPageSize", c.atlasMaxPageSize},
+			{"atlasPadding", c.atlasPadding},
+			{"atlasExtrude", c.atlasExtrude},
+			{"atlasTextureArray", c.atlasTextureArray},
 			{"assetsRoot",   c.assetsRoot},
 			{"mapsRoot",     c.mapsRoot}
 		};
@@ -24,6 +44,16 @@ struct EngineConfig {
 		c.tileSize = j.value("tileSize", c.tileSize);
 		c.tickInterval = j.value("tickInterval", c.tickInterval);
 		c.chunkSize = j.value("chunkSize", c.chunkSize);
+		c.pathBudgetMicros = j.value("pathBudgetMicros", c.pathBudgetMicros);
+		c.chunkCacheKilobytes = j.value("chunkCacheKilobytes", c.chunkCacheKilobytes);
+		c.chunkGenThreads = j.value("chunkGenThreads", c.chunkGenThreads);
+		c.chunkGenBudgetMicros = j.value("chunkGenBudgetMicros", c.chunkGenBudgetMicros);
+		c.renderPrepThreads = j.value("renderPrepThreads", c.renderPrepThreads);
+		c.renderThread = j.value("renderThread", c.renderThread);
+		c.atlasMaxPageSize = j.value("atlasMaxPageSize", c.atlasMaxPageSize);
+		c.atlasPadding = j.value("atlasPadding", c.atlasPadding);
+		c.atlasExtrude = j.value("atlasExtrude", c.atlasExtrude);
+		c.atlasTextureArray = j.value("atlasTextureArray", c.atlasTextureArray);
 		c.assetsRoot = j.value("assetsRoot", c.assetsRoot);
 		c.mapsRoot = j.value("mapsRoot", c.mapsRoot);
 	}
@@ -21,10 +21,11 @@ namespace WanderSpire {
 	/* ───── path-finding (NEW) ─────────────────────────────────────────────── */
 	class GridMap2D;   // fwd
 
-	/** Fired by PathApplySystem after PathFollowingComponent is updated. */
+	/** Fired when a queued path request completes (see PathRequestService). */
 	struct PathAppliedEvent {
 		entt::entity              entity;
 		std::vector<glm::ivec2>   checkpoints;
+		uint32_t                  requestId = 0;   ///< 0 for paths not issued through the queue
 	};
 
 	/* ───── movement interpolation ─────────────────────────────────────────── */
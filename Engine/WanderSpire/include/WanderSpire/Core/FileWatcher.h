@@ -12,9 +12,15 @@ namespace WanderSpire {
 		/// Singleton accessor
 		static FileWatcher& Get();
 
-		/// Call from your main loop each frame
+		/// Call from your main loop each frame: Poll() then DispatchChanges()
 		void Update();
 
+		/// Check for changes without running callbacks; true if any are pending
+		bool Poll();
+
+		/// Run the callbacks of the changes found by Poll()
+		void DispatchChanges();
+
 		/// Watch a single file; callback() fires when its last-write time changes.
 		void WatchFile(const std::filesystem::path& path, std::function<void()> callback);
 
@@ -43,6 +49,7 @@ namespace WanderSpire {
 
 		std::vector<FileWatch> _files;
 		std::vector<DirWatch>  _dirs;
+		std::vector<std::function<void()>> _pending;
 	};
 
 }
@@ -2,6 +2,7 @@
 
 #include <SDL3/SDL.h>
 #include <string>
+#include "WanderSpire/Graphics/RenderThread.h"
 
 namespace WanderSpire {
 
@@ -23,4 +24,21 @@ namespace WanderSpire {
 		SDL_GLContext  m_Context = nullptr;
 	};
 
+	/// Draws frame packets into an SDLContext's window: moves its GL context
+	/// to whichever thread renders and swaps buffers after each frame
+	class SDLRenderBackend final : public RenderBackend {
+	public:
+		explicit SDLRenderBackend(const SDLContext& context)
+			: m_Window(context.GetWindow()), m_Context(context.GetContext()) {
+		}
+
+		bool AttachContext() override;
+		void DetachContext() override;
+		void Present(const FramePacket& packet) override;
+
+	private:
+		SDL_Window* m_Window = nullptr;
+		SDL_GLContext  m_Context = nullptr;
+	};
+
 }
@@ -0,0 +1,29 @@
+﻿#pragma once
+
+#include <entt/entt.hpp>
+
+namespace WanderSpire {
+
+	/**
+	 * Services that keep per-registry state in a map keyed by the registry's
+	 * address can meet a new registry created where a destroyed one lived.
+	 * Marking a registry stores a tag in its ctx(); a new registry at the same
+	 * address lacks it, so the owner knows its old entry is stale.
+	 */
+	template<typename Owner>
+	struct RegistryMark {};
+
+	/// Whether Owner has marked this registry
+	template<typename Owner>
+	bool IsRegistryMarked(const entt::registry& registry) {
+		return registry.ctx().contains<RegistryMark<Owner>>();
+	}
+
+	/// Mark the registry as known to Owner
+	template<typename Owner>
+	void MarkRegistry(entt::registry& registry) {
+		if (!registry.ctx().contains<RegistryMark<Owner>>())
+			registry.ctx().emplace<RegistryMark<Owner>>();
+	}
+
+} // namespace WanderSpire
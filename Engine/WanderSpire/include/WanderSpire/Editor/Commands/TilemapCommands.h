@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include "WanderSpire/Editor/ICommand.h"
+#include "WanderSpire/World/TilemapSystem.h"
 #include <entt/entt.hpp>
 #include <glm/glm.hpp>
 #include <vector>
@@ -53,7 +54,8 @@ namespace WanderSpire {
 		entt::entity tilemapLayer;
 		glm::ivec2 startPosition;
 		int newTileId;
-		std::vector<PaintTilesCommand::TileChange> affectedTiles;
+		int originalTileId = -1;
+		TilemapSystem::FloodFillMask affectedMask;   ///< Filled region, one bitset per chunk
 		void CalculateAffectedTiles();
 	};
 
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace WanderSpire {
+
+	struct AtlasPackSettings {
+		int  maxPageSize = 2048;    ///< Largest page edge in pixels; more images spill to new pages
+		int  padding = 2;           ///< Empty pixels between neighbouring images
+		int  extrude = 1;           ///< Edge pixels repeated around each image against filtering bleed
+		bool powerOfTwo = true;     ///< Round page sizes up to powers of two
+		bool uniformPages = false;  ///< Give every page the same size, as a texture array needs
+	};
+
+	struct AtlasPlacement {
+		int page = -1;              ///< -1 if the image does not fit on an empty page
+		int x = 0;                  ///< Top-left of the image itself, inside its extrusion
+		int y = 0;
+	};
+
+	struct AtlasPage {
+		int      width = 0;
+		int      height = 0;
+		size_t   images = 0;
+		uint64_t usedArea = 0;      ///< Image pixels, without padding or extrusion
+	};
+
+	struct AtlasPackResult {
+		std::vector<AtlasPlacement> placements;   ///< One per input size, in input order
+		std::vector<AtlasPage> pages;
+		size_t rejected = 0;                      ///< Images larger than a page
+
+		uint64_t UsedArea() const;
+		uint64_t PageArea() const;
+		/// Image pixels over page pixels, 0..1
+		double   Efficiency() const;
+	};
+
+	/**
+	 * MaxRects bin packer for texture atlases, with rotation off.
+	 *
+	 * Images are placed largest first, each at the free rectangle with the
+	 * best short-side fit on any open page; a new page is opened only when
+	 * none fits. Each image occupies its size plus extrusion on every side
+	 * plus padding, so neighbours never sample each other. The last page is
+	 * re-packed into the smallest size its images fit, so a folder of a few
+	 * sprites does not get a full-size page.
+	 *
+	 * Packing only computes placements; Blit() copies pixels into a page.
+	 */
+	class AtlasPacker {
+	public:
+		struct Size {
+			int width = 0;
+			int height = 0;
+		};
+
+		explicit AtlasPacker(const AtlasPackSettings& settings = {});
+
+		AtlasPackResult Pack(const std::vector<Size>& sizes) const;
+
+		/// Copy an RGBA image to (x, y) of an RGBA page, repeating its edge
+		/// pixels `extrude` times around it
+		static void Blit(std::vector<uint8_t>& page, int pageWidth, int pageHeight,
+			const uint8_t* image, int width, int height, int x, int y, int extrude);
+
+		const AtlasPackSettings& GetSettings() const { return m_settings; }
+
+	private:
+		AtlasPackSettings m_settings;
+	};
+
+	/**
+	 * Content hash naming everything that decides a packed atlas: the packer
+	 * settings, whether it becomes a texture array, and the names and file
+	 * bytes of its sources. Add sources in a fixed order (sorted by name);
+	 * equal keys mean the atlas written last time can be used as is.
+	 */
+	class AtlasCacheKey {
+	public:
+		AtlasCacheKey(const AtlasPackSettings& settings, bool textureArray);
+
+		void AddSource(const std::string& name, const uint8_t* data, size_t size);
+
+		/// 16 hex digits, as stored in the atlas JSON
+		std::string ToString() const;
+
+	private:
+		void Mix(const void* data, size_t size);
+
+		uint64_t m_hash;
+	};
+
+} // namespace WanderSpire
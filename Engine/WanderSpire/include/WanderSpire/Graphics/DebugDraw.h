@@ -0,0 +1,157 @@
+#pragma once
+
+#include "WanderSpire/Graphics/RenderCommand.h"
+#include "WanderSpire/Graphics/Shader.h"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace WanderSpire {
+
+	/// One end of a debug line, as the debug shader reads it
+	struct DebugLineVertex {
+		glm::vec2 position;
+		uint32_t  color;            ///< RGBA8, straight alpha
+	};
+
+	/// One filled debug quad, drawn as an instance
+	struct DebugQuadInstance {
+		glm::vec2 center;
+		glm::vec2 halfSize;
+		float     rotation;         ///< Radians
+		uint32_t  color;            ///< RGBA8, straight alpha
+	};
+
+	/// Draws a frame's debug geometry: every line in one GL_LINES draw and
+	/// every quad in one instanced draw
+	struct DebugDrawCommand : public RenderCommand {
+		std::vector<DebugLineVertex>   lines;   ///< Two vertices per segment
+		std::vector<DebugQuadInstance> quads;
+
+		DebugDrawCommand()
+			: RenderCommand(RenderCommandType::DrawDebug, RenderLayer::Debug) {
+		}
+
+		void Execute() override;
+	};
+
+	struct DebugDrawStats {
+		size_t   lines = 0;         ///< Segments in the last command built
+		size_t   quads = 0;
+		size_t   persistent = 0;    ///< Primitives kept from earlier frames by their duration
+		size_t   drawCalls = 0;     ///< Draws the last command takes: at most 2
+		uint64_t commands = 0;
+	};
+
+	/**
+	 * Immediate-mode debug drawing: lines, rectangles, circles and quads in
+	 * world units, from any thread.
+	 *
+	 * Each thread appends to its own accumulator, so submitting takes no
+	 * shared lock; the accumulators are double-buffered and swapped when
+	 * RenderManager fills a frame packet, which turns everything gathered
+	 * into one DebugDrawCommand on RenderLayer::Debug. That command uploads
+	 * through StreamBuffer and draws all lines in one call and all quads in
+	 * another, however many primitives there are.
+	 *
+	 * A primitive is drawn once by default. With a duration it is drawn in
+	 * every frame for that many seconds; UNTIL_CLEARED keeps it until Clear().
+	 *
+	 * Lines up to 1 unit wide are hairlines, one pixel at any zoom; wider
+	 * ones become rotated quads.
+	 */
+	class DebugDraw {
+	public:
+		static constexpr float UNTIL_CLEARED = std::numeric_limits<float>::infinity();
+
+		static DebugDraw& Get();
+		~DebugDraw();
+
+		DebugDraw(const DebugDraw&) = delete;
+		DebugDraw& operator=(const DebugDraw&) = delete;
+
+		void Line(const glm::vec2& from, const glm::vec2& to, const glm::vec4& color,
+			float width = 1.0f, float duration = 0.0f);
+		/// Axis-aligned, from its bottom-left corner
+		void Rect(const glm::vec2& min, const glm::vec2& size, const glm::vec4& color,
+			bool filled = false, float duration = 0.0f);
+		void Circle(const glm::vec2& center, float radius, const glm::vec4& color,
+			int segments = 32, float duration = 0.0f);
+		/// Filled, rotated about its center
+		void Quad(const glm::vec2& center, const glm::vec2& size, float rotation,
+			const glm::vec4& color, float duration = 0.0f);
+
+		/// Everything submitted since the last call plus what is still
+		/// persistent; null if there is nothing to draw
+		std::unique_ptr<DebugDrawCommand> BuildCommand();
+
+		/// Drop persistent primitives, including ones not yet built
+		void Clear();
+
+		DebugDrawStats GetStats() const;
+
+		/// Delete the GL objects; needs the GL context
+		void Shutdown();
+
+		static uint32_t PackColor(const glm::vec4& color);
+
+	private:
+		friend struct DebugDrawCommand;
+
+		/// Primitives with their durations, parallel to the geometry
+		struct Batch {
+			std::vector<DebugLineVertex>   lines;
+			std::vector<float>             lineDurations;   ///< One per segment
+			std::vector<DebugQuadInstance> quads;
+			std::vector<float>             quadDurations;
+		};
+
+		/// One thread's submissions. The owner writes the active batch; the
+		/// collector flips `active` and waits for the owner to leave the old one.
+		struct Accumulator {
+			Batch batches[2];
+			std::atomic<int> active{ 0 };
+			std::atomic<int> writing{ -1 };   ///< Batch the owner is inside, -1 if none
+			std::atomic<bool> retired{ false };  ///< The owner thread has exited
+		};
+
+		class WriteScope;
+		class LocalSlot;
+
+		DebugDraw() = default;
+
+		Accumulator& LocalAccumulator();
+		/// Move what every thread submitted into the pending or persistent store
+		void Collect(double now);
+		/// Move one batch's primitives into the pending or persistent store
+		void Drain(Batch& batch, double now);
+
+		void Draw(const DebugDrawCommand& command);
+		void CreateResources();
+
+		mutable std::mutex m_mutex;   ///< Accumulator list, persistent store and stats
+		std::vector<std::shared_ptr<Accumulator>> m_accumulators;
+
+		std::vector<DebugLineVertex>   m_pendingLines;     ///< Drawn once, by the next command
+		std::vector<DebugQuadInstance> m_pendingQuads;
+		std::vector<DebugLineVertex>   m_persistentLines;
+		std::vector<double>            m_lineExpiry;       ///< Seconds on the steady clock
+		std::vector<DebugQuadInstance> m_persistentQuads;
+		std::vector<double>            m_quadExpiry;
+		DebugDrawStats m_stats;
+
+		// Render side
+		Shader* m_shader = nullptr;
+		UniformHandle m_quadsUniform = InvalidUniform;
+		GLuint m_lineVAO = 0;
+		GLuint m_quadVAO = 0;
+		GLuint m_fallbackVBO = 0;     ///< When the stream buffer is unavailable
+	};
+
+} // namespace WanderSpire
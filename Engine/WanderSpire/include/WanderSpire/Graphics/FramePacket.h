@@ -0,0 +1,28 @@
+#pragma once
+
+#include "WanderSpire/Graphics/RenderCommand.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace WanderSpire {
+
+	/**
+	 * Everything needed to draw one frame, handed from the thread that built
+	 * it to the thread that draws it.
+	 *
+	 * The commands are already sorted, and own all the data they draw: once
+	 * submitted, a packet does not read the registry or anything else the
+	 * simulation may be changing.
+	 */
+	struct FramePacket {
+		uint64_t frameIndex = 0;
+		std::vector<std::unique_ptr<RenderCommand>> commands;
+
+		/// Window viewport to set before drawing, if the producer knows it
+		bool hasViewport = false;
+		std::array<int, 4> viewport{};
+	};
+
+} // namespace WanderSpire
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace WanderSpire {
+
+	/// Contents of the `FrameData` uniform block, std140 layout
+	struct FrameUniformData {
+		glm::mat4 viewProjection{ 1.0f };
+		glm::vec4 viewport{ 0.0f };         ///< x, y, width, height of the view
+		glm::vec4 time{ 0.0f };             ///< Seconds since start, unused, unused, unused
+	};
+	static_assert(sizeof(FrameUniformData) == 96 && offsetof(FrameUniformData, viewport) == 64
+		&& offsetof(FrameUniformData, time) == 80, "FrameUniformData must match the std140 block");
+
+	/**
+	 * Uniform buffer for data shared by every shader in a view: the
+	 * view-projection matrix, the viewport and the time. It is written once
+	 * when a view begins instead of being set on each shader per draw.
+	 *
+	 * Shaders read it through
+	 *
+	 *     layout(std140) uniform FrameData {
+	 *         mat4 u_ViewProjection;
+	 *         vec4 u_Viewport;
+	 *         vec4 u_Time;
+	 *     };
+	 *
+	 * which Shader attaches to BINDING when it links.
+	 */
+	class FrameUniforms {
+	public:
+		static constexpr GLuint BINDING = 0;
+		static constexpr const char* BLOCK_NAME = "FrameData";
+
+		static FrameUniforms& Get();
+
+		/// Begin a view: fill in viewport and time and upload if anything changed
+		void BeginView(const glm::mat4& viewProjection);
+
+		/// Upload `data` unless it equals what the buffer already holds
+		void Update(const FrameUniformData& data);
+
+		const FrameUniformData& GetData() const { return m_Data; }
+		uint64_t GetUploadCount() const { return m_Uploads; }
+
+		/// Delete the buffer; needs the GL context
+		void Shutdown();
+
+	private:
+		FrameUniforms() = default;
+
+		GLuint m_Buffer = 0;
+		bool m_Valid = false;               ///< m_Data is in the buffer
+		FrameUniformData m_Data;
+		uint64_t m_Uploads = 0;
+		std::chrono::steady_clock::time_point m_Start = std::chrono::steady_clock::now();
+	};
+
+} // namespace WanderSpire
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "WanderSpire/Graphics/GLStateCache.h"
+#include <glad/glad.h>
+#include <memory>
+
+namespace WanderSpire::GL {
+
+	/**
+	 * Every GL call the renderer makes. Renderer code calls the method named
+	 * after the gl* function instead of the function itself, so the whole
+	 * render path can run against something other than a GL context.
+	 *
+	 * The state calls it inherits from StateBackend arrive through the
+	 * StateCache, whose default backend forwards here; everything else is
+	 * called directly. The default device forwards to the current context;
+	 * RecordingDevice (RecordingDevice.h) needs no GPU and validates, counts
+	 * and optionally logs the calls instead.
+	 *
+	 * Objects are generated one at a time, and the few calls taking array or
+	 * string arguments take the single value the engine passes.
+	 */
+	class Device : public StateBackend {
+	public:
+		/// The installed device
+		static Device& Get();
+
+		/// Replace the device for the whole process (null restores OpenGL) and
+		/// invalidate the state cache. Only while nothing renders.
+		static void Install(std::unique_ptr<Device> device);
+
+		// ─── Objects ───────────────────────────────────────────────────────
+		virtual GLuint GenBuffer() = 0;
+		virtual void   DeleteBuffer(GLuint buffer) = 0;
+		virtual GLuint GenVertexArray() = 0;
+		virtual void   DeleteVertexArray(GLuint vao) = 0;
+		virtual GLuint GenTexture() = 0;
+		virtual void   DeleteTexture(GLuint texture) = 0;
+
+		// ─── Buffers: the one bound to `target` ────────────────────────────
+		virtual void  BufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) = 0;
+		virtual void  BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) = 0;
+		virtual void  BufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags) = 0;
+		virtual void* MapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) = 0;
+		virtual void  UnmapBuffer(GLenum target) = 0;
+
+		// ─── Vertex layout of the bound vertex array ───────────────────────
+		virtual void EnableVertexAttribArray(GLuint index) = 0;
+		virtual void VertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+			GLsizei stride, const void* pointer) = 0;
+		virtual void VertexAttribDivisor(GLuint index, GLuint divisor) = 0;
+
+		// ─── Textures: the one bound to `target` on the active unit ────────
+		virtual void TexParameteri(GLenum target, GLenum pname, GLint param) = 0;
+		virtual void TexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+			GLenum format, GLenum type, const void* pixels) = 0;
+		virtual void TexSubImage2D(GLenum target, GLint level, GLint x, GLint y, GLsizei width, GLsizei height,
+			GLenum format, GLenum type, const void* pixels) = 0;
+		virtual void TexImage3D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+			GLsizei depth, GLenum format, GLenum type, const void* pixels) = 0;
+		virtual void TexSubImage3D(GLenum target, GLint level, GLint x, GLint y, GLint z,
+			GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void* pixels) = 0;
+
+		// ─── Shaders and programs ──────────────────────────────────────────
+		virtual GLuint CreateShader(GLenum type) = 0;
+		virtual void   ShaderSource(GLuint shader, const char* source) = 0;
+		virtual void   CompileShader(GLuint shader) = 0;
+		virtual void   GetShaderiv(GLuint shader, GLenum pname, GLint* value) = 0;
+		virtual void   GetShaderInfoLog(GLuint shader, GLsizei size, GLchar* log) = 0;
+		virtual void   DeleteShader(GLuint shader) = 0;
+		virtual GLuint CreateProgram() = 0;
+		virtual void   AttachShader(GLuint program, GLuint shader) = 0;
+		virtual void   LinkProgram(GLuint program) = 0;
+		virtual void   GetProgramiv(GLuint program, GLenum pname, GLint* value) = 0;
+		virtual void   GetProgramInfoLog(GLuint program, GLsizei size, GLchar* log) = 0;
+		virtual void   DeleteProgram(GLuint program) = 0;
+		virtual GLint  GetUniformLocation(GLuint program, const char* name) = 0;
+		virtual GLuint GetUniformBlockIndex(GLuint program, const char* name) = 0;
+		virtual void   UniformBlockBinding(GLuint program, GLuint block, GLuint binding) = 0;
+
+		// ─── Uniforms of the program in use ────────────────────────────────
+		virtual void Uniform1i(GLint location, GLint value) = 0;
+		virtual void Uniform1f(GLint location, GLfloat value) = 0;
+		virtual void Uniform2f(GLint location, GLfloat x, GLfloat y) = 0;
+		virtual void Uniform3f(GLint location, GLfloat x, GLfloat y, GLfloat z) = 0;
+		virtual void UniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) = 0;
+
+		// ─── Drawing ───────────────────────────────────────────────────────
+		virtual void Clear(GLbitfield mask) = 0;
+		virtual void DrawArrays(GLenum mode, GLint first, GLsizei count) = 0;
+		virtual void DrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances) = 0;
+		virtual void DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) = 0;
+		virtual void DrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices,
+			GLsizei instances) = 0;
+
+		// ─── Synchronization and capabilities ──────────────────────────────
+		virtual GLsync FenceSync() = 0;
+		virtual GLenum ClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeoutNanos) = 0;
+		virtual void   DeleteSync(GLsync sync) = 0;
+		/// GL_ARB_buffer_storage or GL 4.4
+		virtual bool   SupportsBufferStorage() = 0;
+	};
+
+} // namespace WanderSpire::GL
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace WanderSpire::GL {
+
+	/// The raw GL entry points the state cache issues. The default forwards
+	/// to the installed GL::Device; tests can also install their own here.
+	class StateBackend {
+	public:
+		virtual ~StateBackend() = default;
+
+		virtual void UseProgram(GLuint program) = 0;
+		virtual void BindVertexArray(GLuint vao) = 0;
+		virtual void BindBuffer(GLenum target, GLuint buffer) = 0;
+		virtual void BindBufferBase(GLenum target, GLuint index, GLuint buffer) = 0;
+		virtual void ActiveTexture(GLenum unit) = 0;
+		virtual void BindTexture(GLenum target, GLuint texture) = 0;
+		virtual void Enable(GLenum cap) = 0;
+		virtual void Disable(GLenum cap) = 0;
+		virtual void BlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha) = 0;
+		virtual void DepthFunc(GLenum func) = 0;
+		virtual void DepthMask(GLboolean mask) = 0;
+		virtual void Scissor(GLint x, GLint y, GLsizei width, GLsizei height) = 0;
+		virtual void Viewport(GLint x, GLint y, GLsizei width, GLsizei height) = 0;
+		virtual void BindFramebuffer(GLenum target, GLuint framebuffer) = 0;
+		virtual void ClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a) = 0;
+
+		/// Only used to learn state the cache does not know yet
+		virtual void GetIntegerv(GLenum pname, GLint* data) = 0;
+		virtual GLboolean IsEnabled(GLenum cap) = 0;
+	};
+
+	/// What kind of state a call changed, for the statistics
+	enum class StateKind : uint8_t {
+		Program, VertexArray, Buffer, Texture, Capability, Blend, Depth,
+		Scissor, Viewport, Framebuffer, ClearColor, Count
+	};
+
+	struct StateCacheStats {
+		static constexpr size_t KINDS = static_cast<size_t>(StateKind::Count);
+
+		uint64_t requested[KINDS] = {};     ///< Calls made to the cache
+		uint64_t skipped[KINDS] = {};       ///< Of which redundant: no GL call issued
+		uint64_t queries = 0;               ///< glGet* issued to fill unknown state
+		uint64_t invalidations = 0;
+
+		uint64_t TotalRequested() const { uint64_t n = 0; for (auto v : requested) n += v; return n; }
+		uint64_t TotalSkipped() const { uint64_t n = 0; for (auto v : skipped) n += v; return n; }
+	};
+
+	/**
+	 * Shadow copy of the GL state the engine changes: program, VAO, buffer
+	 * bindings per target (plus indexed uniform buffer bindings), textures per
+	 * unit and target, blend/depth/scissor state, viewport, framebuffers and
+	 * clear color.
+	 *
+	 * Engine code changes that state only through here, so a call that would
+	 * not change anything is dropped, and saving a binding to restore later
+	 * (see the binders in GLStateManager.h) reads the shadow copy instead of
+	 * stalling on glGetIntegerv. State starts out unknown; the first request
+	 * always reaches GL, and a getter asked for unknown state queries it once.
+	 *
+	 * Code that changes GL state behind the cache's back (the ImGui backend,
+	 * a host application sharing the context) must call Invalidate() after it.
+	 */
+	class StateCache {
+	public:
+		static constexpr GLuint UNKNOWN = ~GLuint(0);
+		static constexpr GLuint MAX_TEXTURE_UNITS = 32;
+		static constexpr GLuint MAX_UNIFORM_BINDINGS = 16;
+
+		static StateCache& Get();
+
+		/// Replace the backend (null restores the device one); invalidates everything
+		void SetBackend(std::unique_ptr<StateBackend> backend);
+
+		/// Forget everything: the next request of every kind reaches GL
+		void Invalidate();
+
+		// ─── Bindings ──────────────────────────────────────────────────────
+		void UseProgram(GLuint program);
+		/// Also forgets the element array binding, which belongs to the VAO
+		void BindVertexArray(GLuint vao);
+		void BindBuffer(GLenum target, GLuint buffer);
+		/// Binds the indexed point and the generic target, like GL
+		void BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+		/// `unit` is 0-based, not GL_TEXTURE0-based
+		void ActiveTexture(GLuint unit);
+		/// Bind on `unit`, switching the active unit only when needed
+		void BindTexture(GLenum target, GLuint texture, GLuint unit = 0);
+		void BindFramebuffer(GLenum target, GLuint framebuffer);
+
+		// ─── Fixed-function state ──────────────────────────────────────────
+		void SetEnabled(GLenum cap, bool enabled);
+		void Enable(GLenum cap) { SetEnabled(cap, true); }
+		void Disable(GLenum cap) { SetEnabled(cap, false); }
+		void BlendFunc(GLenum src, GLenum dst) { BlendFuncSeparate(src, dst, src, dst); }
+		void BlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha);
+		void DepthFunc(GLenum func);
+		void DepthMask(bool mask);
+		void Scissor(GLint x, GLint y, GLsizei width, GLsizei height);
+		void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+		void ClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a);
+
+		// ─── Current state (queried once if unknown) ───────────────────────
+		GLuint GetProgram();
+		GLuint GetVertexArray();
+		GLuint GetBuffer(GLenum target);
+		GLuint GetActiveTexture();
+		GLuint GetTexture(GLenum target, GLuint unit);
+		GLuint GetFramebuffer(GLenum target);
+		bool   IsEnabled(GLenum cap);
+		void   GetViewport(GLint out[4]);
+
+		// ─── Deleted objects no longer count as bound ──────────────────────
+		void ForgetProgram(GLuint program);
+		void ForgetVertexArray(GLuint vao);
+		void ForgetBuffer(GLuint buffer);
+		void ForgetTexture(GLuint texture);
+		void ForgetFramebuffer(GLuint framebuffer);
+
+		const StateCacheStats& GetStats() const { return m_stats; }
+		void ResetStats() { m_stats = StateCacheStats{}; }
+
+	private:
+		StateCache();
+
+		/// Count a request; true if it changes nothing and can be dropped
+		bool Redundant(StateKind kind, bool unchanged);
+		GLuint Query(GLenum pname);
+
+		static int BufferSlot(GLenum target);
+		static int TextureSlot(GLenum target);
+		static int CapabilitySlot(GLenum cap);
+
+		static constexpr int BUFFER_TARGETS = 10;
+		static constexpr int TEXTURE_TARGETS = 3;
+		static constexpr int CAPABILITIES = 5;
+
+		std::unique_ptr<StateBackend> m_backend;
+
+		GLuint m_program = UNKNOWN;
+		GLuint m_vertexArray = UNKNOWN;
+		std::array<GLuint, BUFFER_TARGETS> m_buffers{};
+		std::array<GLuint, MAX_UNIFORM_BINDINGS> m_uniformBindings{};
+		GLuint m_activeUnit = UNKNOWN;
+		std::array<std::array<GLuint, TEXTURE_TARGETS>, MAX_TEXTURE_UNITS> m_textures{};
+		GLuint m_drawFramebuffer = UNKNOWN;
+		GLuint m_readFramebuffer = UNKNOWN;
+
+		enum class Tri : uint8_t { Unknown, Off, On };
+		std::array<Tri, CAPABILITIES> m_capabilities{};
+		std::array<GLenum, 4> m_blend{};
+		bool   m_blendKnown = false;
+		GLenum m_depthFunc = 0;
+		Tri    m_depthMask = Tri::Unknown;
+		std::array<GLint, 4> m_scissor{};
+		bool   m_scissorKnown = false;
+		std::array<GLint, 4> m_viewport{};
+		bool   m_viewportKnown = false;
+		std::array<GLfloat, 4> m_clearColor{};
+		bool   m_clearColorKnown = false;
+
+		StateCacheStats m_stats;
+	};
+
+} // namespace WanderSpire::GL
@@ -2,20 +2,23 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <cstddef>
 #include <vector>
+#include "WanderSpire/Graphics/Shader.h"
 
 namespace WanderSpire {
 
-	class Shader;
-
 	/// RAII wrapper for instanced terrain/tile rendering
 	/// Eliminates duplication between GridMap2D and RenderCommand
+	/// Instance data streams through StreamBuffer; a private VBO is only used
+	/// if the stream buffer cannot be created
 	class InstanceRenderer {
 	public:
 		struct InstanceData {
 			glm::vec2 position;
 			glm::vec2 uvOffset;
 			glm::vec2 uvSize;
+			float     layer = 0.0f;   ///< Texture array layer (atlas page); ignored for 2D textures
 		};
 
 		InstanceRenderer();
@@ -30,10 +33,12 @@ namespace WanderSpire {
 		/// Setup for frame rendering with given shader and VAO
 		void BeginFrame(Shader* shader, GLuint quadVAO, GLuint quadEBO);
 
-		/// Render instances with given texture and tile size
+		/// Render instances with given texture and tile size. A GL_TEXTURE_2D_ARRAY
+		/// texture is sampled at each instance's layer.
 		void RenderInstances(GLuint textureID,
 			const std::vector<InstanceData>& instances,
-			float tileSize);
+			float tileSize,
+			GLenum textureTarget = GL_TEXTURE_2D);
 
 		/// End frame rendering
 		void EndFrame();
@@ -42,14 +47,21 @@ namespace WanderSpire {
 		static InstanceRenderer& Get();
 
 	private:
-		void SetupVertexAttributes();
+		/// Point the instance attributes of the bound VAO at `offset` in `buffer`
+		void SetupVertexAttributes(GLuint buffer, size_t offset);
 		void CleanupResources();
 
-		GLuint m_InstanceVBO = 0;
+		GLuint m_InstanceVBO = 0;          ///< Fallback when streaming is unavailable
 		Shader* m_CurrentShader = nullptr;
 		GLuint m_CurrentVAO = 0;
 		GLuint m_CurrentEBO = 0;
-		bool m_AttributesSetup = false;
+
+		/// Handles declared on m_UniformShader, redeclared when the shader changes
+		Shader* m_UniformShader = nullptr;
+		UniformHandle m_UseInstancingUniform = InvalidUniform;
+		UniformHandle m_TileSizeUniform = InvalidUniform;
+		UniformHandle m_UseTextureArrayUniform = InvalidUniform;
+		UniformHandle m_TextureArrayUniform = InvalidUniform;
 	};
 
 } // namespace WanderSpire
\ No newline at end of file
@@ -0,0 +1,247 @@
+#pragma once
+
+#include "WanderSpire/Graphics/GLDevice.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace WanderSpire::GL {
+
+	struct RecordingDeviceStats {
+		uint64_t calls = 0;             ///< Every call the device received
+		uint64_t stateChanges = 0;      ///< Binds and fixed-function changes that got past the StateCache
+		uint64_t drawCalls = 0;
+		uint64_t instances = 0;         ///< Summed over draws; 1 per non-instanced draw
+		uint64_t vertices = 0;          ///< Vertices (or indices) per draw, times its instances
+		uint64_t clears = 0;
+		uint64_t uniformUploads = 0;
+		uint64_t bufferBytes = 0;       ///< Given with BufferData/BufferSubData/BufferStorage, plus non-persistent write maps
+		uint64_t textureBytes = 0;      ///< Pixel data given with TexImage*/TexSubImage*
+		uint64_t errors = 0;            ///< Invalid calls, described in GetErrors()
+
+		uint64_t UploadedBytes() const { return bufferBytes + textureBytes; }
+	};
+
+	/// What the device claims to support
+	struct RecordingDeviceCaps {
+		GLint maxTextureSize = 8192;
+		GLint maxArrayTextureLayers = 256;
+		bool  bufferStorage = true;
+	};
+
+	/**
+	 * A GL::Device with no GPU behind it, for tests and benchmarks on machines
+	 * without one.
+	 *
+	 * Objects get names from one counter, buffers keep their contents, and
+	 * shaders "compile" to the uniforms and blocks their source declares, so
+	 * the renderer runs exactly as it does against GL. Every call is checked
+	 * the way a debug context would check it (objects exist and have the right
+	 * kind, something is bound where the call needs it, maps and draws are
+	 * legal); a violation is logged and kept in GetErrors() instead of
+	 * failing. Draws, state changes, uniform uploads and uploaded bytes are
+	 * counted.
+	 *
+	 * With logging on, every call also appends one line of text naming its
+	 * arguments, which is deterministic for a deterministic frame: tests
+	 * compare it against a golden snapshot of the command stream.
+	 *
+	 * Like a context, it is used by one thread at a time.
+	 */
+	class RecordingDevice final : public Device {
+	public:
+		explicit RecordingDevice(const RecordingDeviceCaps& caps = {});
+
+		/// Keep a line per call (off by default: benchmarks only want the counters)
+		void SetLogging(bool enabled) { m_logging = enabled; }
+		const std::vector<std::string>& GetLog() const { return m_log; }
+		/// The log so far, leaving it empty
+		std::vector<std::string> TakeLog();
+
+		const RecordingDeviceStats& GetStats() const { return m_stats; }
+		/// Zero the counters; objects, bindings and errors stay
+		void ResetStats() { m_stats = RecordingDeviceStats{}; }
+
+		const std::vector<std::string>& GetErrors() const { return m_errors; }
+		void ClearErrors() { m_errors.clear(); }
+
+		/// Objects generated and not deleted yet, one description each
+		std::vector<std::string> GetLiveObjects() const;
+		/// Contents of a buffer, or null if `buffer` is not one
+		const std::vector<uint8_t>* GetBufferContents(GLuint buffer) const;
+
+		// ─── StateBackend ──────────────────────────────────────────────────
+		void UseProgram(GLuint program) override;
+		void BindVertexArray(GLuint vao) override;
+		void BindBuffer(GLenum target, GLuint buffer) override;
+		void BindBufferBase(GLenum target, GLuint index, GLuint buffer) override;
+		void ActiveTexture(GLenum unit) override;
+		void BindTexture(GLenum target, GLuint texture) override;
+		void Enable(GLenum cap) override;
+		void Disable(GLenum cap) override;
+		void BlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha) override;
+		void DepthFunc(GLenum func) override;
+		void DepthMask(GLboolean mask) override;
+		void Scissor(GLint x, GLint y, GLsizei width, GLsizei height) override;
+		void Viewport(GLint x, GLint y, GLsizei width, GLsizei height) override;
+		void BindFramebuffer(GLenum target, GLuint framebuffer) override;
+		void ClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a) override;
+		void GetIntegerv(GLenum pname, GLint* data) override;
+		GLboolean IsEnabled(GLenum cap) override;
+
+		// ─── Device ────────────────────────────────────────────────────────
+		GLuint GenBuffer() override;
+		void   DeleteBuffer(GLuint buffer) override;
+		GLuint GenVertexArray() override;
+		void   DeleteVertexArray(GLuint vao) override;
+		GLuint GenTexture() override;
+		void   DeleteTexture(GLuint texture) override;
+
+		void  BufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) override;
+		void  BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) override;
+		void  BufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags) override;
+		void* MapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) override;
+		void  UnmapBuffer(GLenum target) override;
+
+		void EnableVertexAttribArray(GLuint index) override;
+		void VertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+			GLsizei stride, const void* pointer) override;
+		void VertexAttribDivisor(GLuint index, GLuint divisor) override;
+
+		void TexParameteri(GLenum target, GLenum pname, GLint param) override;
+		void TexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+			GLenum format, GLenum type, const void* pixels) override;
+		void TexSubImage2D(GLenum target, GLint level, GLint x, GLint y, GLsizei width, GLsizei height,
+			GLenum format, GLenum type, const void* pixels) override;
+		void TexImage3D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+			GLsizei depth, GLenum format, GLenum type, const void* pixels) override;
+		void TexSubImage3D(GLenum target, GLint level, GLint x, GLint y, GLint z,
+			GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void* pixels) override;
+
+		GLuint CreateShader(GLenum type) override;
+		void   ShaderSource(GLuint shader, const char* source) override;
+		void   CompileShader(GLuint shader) override;
+		void   GetShaderiv(GLuint shader, GLenum pname, GLint* value) override;
+		void   GetShaderInfoLog(GLuint shader, GLsizei size, GLchar* log) override;
+		void   DeleteShader(GLuint shader) override;
+		GLuint CreateProgram() override;
+		void   AttachShader(GLuint program, GLuint shader) override;
+		void   LinkProgram(GLuint program) override;
+		void   GetProgramiv(GLuint program, GLenum pname, GLint* value) override;
+		void   GetProgramInfoLog(GLuint program, GLsizei size, GLchar* log) override;
+		void   DeleteProgram(GLuint program) override;
+		GLint  GetUniformLocation(GLuint program, const char* name) override;
+		GLuint GetUniformBlockIndex(GLuint program, const char* name) override;
+		void   UniformBlockBinding(GLuint program, GLuint block, GLuint binding) override;
+
+		void Uniform1i(GLint location, GLint value) override;
+		void Uniform1f(GLint location, GLfloat value) override;
+		void Uniform2f(GLint location, GLfloat x, GLfloat y) override;
+		void Uniform3f(GLint location, GLfloat x, GLfloat y, GLfloat z) override;
+		void UniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) override;
+
+		void Clear(GLbitfield mask) override;
+		void DrawArrays(GLenum mode, GLint first, GLsizei count) override;
+		void DrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances) override;
+		void DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) override;
+		void DrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices,
+			GLsizei instances) override;
+
+		GLsync FenceSync() override;
+		GLenum ClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeoutNanos) override;
+		void   DeleteSync(GLsync sync) override;
+		bool   SupportsBufferStorage() override { return m_caps.bufferStorage; }
+
+	private:
+		enum class Kind : uint8_t { Buffer, VertexArray, Texture, Shader, Program };
+
+		static constexpr GLuint MAX_ATTRIBUTES = 16;
+
+		/// Where a vertex attribute reads from
+		struct Attribute {
+			GLuint buffer = 0;
+			size_t offset = 0;
+			size_t stride = 0;      ///< Resolved: never 0
+			size_t bytes = 0;       ///< One element
+			GLuint divisor = 0;
+		};
+
+		struct Object {
+			Kind kind = Kind::Buffer;
+			// Buffer
+			std::vector<uint8_t> data;
+			bool       immutable = false;
+			GLbitfield storageFlags = 0;        ///< BufferStorage flags
+			bool       mapped = false;
+			GLbitfield mapAccess = 0;
+			// Vertex array
+			uint32_t enabledAttributes = 0;     ///< Bit per attribute location
+			std::array<Attribute, MAX_ATTRIBUTES> attributes{};
+			GLuint   elementBuffer = 0;
+			// Texture
+			GLenum  target = 0;
+			GLsizei width = 0, height = 0, depth = 0;
+			// Shader
+			GLenum      shaderType = 0;
+			std::string source;
+			bool        compiled = false;
+			// Program
+			std::vector<GLuint> shaders;
+			bool linked = false;
+			std::vector<std::string> uniforms;  ///< Location is the index
+			std::vector<std::string> blocks;    ///< Block index is the index
+		};
+
+		/// Count a call and, with logging on, describe it
+		template <typename... Args>
+		void Record(const char* call, const Args&... args);
+		/// Note an invalid call
+		void Error(const std::string& message);
+
+		Object* Find(GLuint name, Kind kind, const char* call);
+		GLuint  Create(Kind kind);
+		void    Destroy(GLuint name, Kind kind, const char* call);
+		/// The buffer bound to `target`, or null (and an error) if none
+		Object* BoundBuffer(GLenum target, const char* call);
+		Object* BoundTexture(GLenum target, const char* call);
+		Object* BoundVertexArray(const char* call);
+		/// Check the program, vertex array and every buffer a draw reads:
+		/// `count` vertices from `first` (or `count` indices), `instances` times
+		void    ValidateDraw(const char* call, GLint first, GLsizei count, GLsizei instances,
+			GLenum indexType, const void* indices);
+		/// Check a Uniform* call and count it; false if it does nothing
+		bool    UniformTarget(GLint location, const char* call);
+
+		RecordingDeviceCaps m_caps;
+		RecordingDeviceStats m_stats;
+		bool m_logging = false;
+		std::vector<std::string> m_log;
+		std::vector<std::string> m_errors;
+
+		std::unordered_map<GLuint, Object> m_objects;
+		GLuint m_nextName = 1;
+		std::unordered_set<uintptr_t> m_fences;
+		uintptr_t m_nextFence = 1;
+
+		// Bindings
+		GLuint m_program = 0;
+		GLuint m_vertexArray = 0;
+		GLuint m_defaultElementBuffer = 0;    ///< Element binding while no vertex array is bound
+		std::unordered_map<GLenum, GLuint> m_buffers;
+		std::map<std::pair<GLenum, GLuint>, GLuint> m_indexedBuffers;
+		GLuint m_activeUnit = 0;
+		std::map<std::pair<GLuint, GLenum>, GLuint> m_textures;   ///< (unit, target) -> texture
+		std::unordered_set<GLenum> m_enabled;
+		GLuint m_drawFramebuffer = 0;
+		GLuint m_readFramebuffer = 0;
+		std::array<GLint, 4> m_viewport{};
+		std::array<GLint, 4> m_scissor{};
+	};
+
+} // namespace WanderSpire::GL
@@ -2,6 +2,8 @@
 
 #include <glm/glm.hpp>
 #include <glad/glad.h>
+#include "WanderSpire/Graphics/GLDevice.h"
+#include "WanderSpire/Graphics/GLStateCache.h"
 #include <functional>
 #include <memory>
 
@@ -24,6 +26,7 @@ namespace WanderSpire {
 		DrawSprite,         ///< Single sprite/quad
 		DrawInstanced,      ///< Instanced rendering (terrain)
 		DrawCustom,         ///< Custom user callback
+		DrawDebug,          ///< Batched debug lines and quads
 		BeginFrame,         ///< Setup frame state
 		EndFrame            ///< Finalize frame
 	};
@@ -55,13 +58,13 @@ namespace WanderSpire {
 		void Execute() override {
 			GLbitfield mask = 0;
 			if (clearColor) {
-				glClearColor(color.r, color.g, color.b, 1.0f);
+				GL::StateCache::Get().ClearColor(color.r, color.g, color.b, 1.0f);
 				mask |= GL_COLOR_BUFFER_BIT;
 			}
 			if (clearDepth) {
 				mask |= GL_DEPTH_BUFFER_BIT;
 			}
-			if (mask) glClear(mask);
+			if (mask) GL::Device::Get().Clear(mask);
 		}
 	};
 
@@ -74,11 +77,12 @@ namespace WanderSpire {
 		glm::vec3 color;
 		glm::vec2 uvOffset;
 		glm::vec2 uvSize;
+		int textureLayer;   ///< Layer when textureID is a texture array, else -1
 
 		SpriteCommand(RenderLayer layer, int order = 0)
 			: RenderCommand(RenderCommandType::DrawSprite, layer, order)
 			, textureID(0), position(0), size(1), rotation(0)
-			, color(1), uvOffset(0), uvSize(1) {
+			, color(1), uvOffset(0), uvSize(1), textureLayer(-1) {
 		}
 
 		void Execute() override;
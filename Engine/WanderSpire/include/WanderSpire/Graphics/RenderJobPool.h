@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace WanderSpire {
+
+	/**
+	 * Worker threads for preparing render commands: culling, sorting and
+	 * building instance data ahead of the draw.
+	 *
+	 * Run() is a blocking parallel-for. The calling thread works through the
+	 * indices alongside the workers, and each index runs exactly once. Jobs
+	 * only write their own output slot, so results never depend on the
+	 * number of threads or the order jobs finish in; callers merge the slots
+	 * in index order afterwards.
+	 *
+	 * A Run() issued from inside a job runs serially on that thread.
+	 */
+	class RenderJobPool {
+	public:
+		static RenderJobPool& Get();
+		~RenderJobPool();
+
+		/// Call `job(i)` for every i in [0, count) and wait for all of them
+		void Run(size_t count, const std::function<void(size_t)>& job);
+
+		/// Threads taking part in Run, the caller included (0 = hardware threads, 1 = serial)
+		void     SetThreadCount(unsigned threads);
+		unsigned GetThreadCount() const;
+
+	private:
+		RenderJobPool();
+
+		void StartWorkers();
+		void StopWorkers();
+		void WorkerLoop();
+		/// Take indices of the current batch until none are left
+		void Work();
+
+		mutable std::mutex m_mutex;
+		std::mutex m_runMutex;                    ///< One batch at a time
+		std::condition_variable m_batchReady;
+		std::condition_variable m_batchDone;
+		std::vector<std::thread> m_workers;
+		bool m_stopping = false;
+		unsigned m_threadCount = 0;
+
+		const std::function<void(size_t)>* m_job = nullptr;
+		size_t m_count = 0;
+		uint64_t m_batch = 0;                     ///< Bumped per Run so workers notice
+		std::atomic<size_t> m_next{ 0 };
+		size_t m_remaining = 0;                   ///< Indices not finished yet, under m_mutex
+		unsigned m_active = 0;                    ///< Workers inside the batch, under m_mutex
+	};
+
+} // namespace WanderSpire
@@ -1,6 +1,8 @@
 ﻿#pragma once
 
 #include "RenderCommand.h"
+#include "FramePacket.h"
+#include <array>
 #include <vector>
 #include <memory>
 #include <functional>
@@ -15,6 +17,9 @@ namespace WanderSpire {
 		/// Queue a render command for execution this frame
 		void Submit(std::unique_ptr<RenderCommand> command);
 
+		/// Queue a batch of commands, keeping their order among equal sort keys
+		void Submit(std::vector<std::unique_ptr<RenderCommand>>&& commands);
+
 		/// Submit a sprite for rendering
 		void SubmitSprite(GLuint textureID, const glm::vec2& position, const glm::vec2& size,
 			float rotation, const glm::vec3& color, const glm::vec2& uvOffset,
@@ -37,9 +42,24 @@ namespace WanderSpire {
 		/// Finalize frame
 		void EndFrame();
 
-		/// Execute all queued commands and clear the queue
+		/// Execute all queued commands on this thread and clear the queue.
+		/// Borrows the GL context if a render thread holds it.
 		void ExecuteFrame();
 
+		/// Hand this frame to RenderThread: drawn and presented there, or right
+		/// away if it is not threaded
+		void SubmitFrame();
+
+		/// Move this frame's sorted commands into `packet` and clear the queue
+		void FillPacket(FramePacket& packet);
+
+		/// Draw a packet's commands in order; needs the GL context
+		static void ExecutePacket(FramePacket& packet);
+
+		/// Window viewport stamped into every packet; the editor leaves it unset
+		/// and manages the viewport of its render targets itself
+		void SetViewport(int x, int y, int width, int height);
+
 		/// Clear all pending commands without executing
 		void Clear();
 
@@ -55,8 +75,11 @@ namespace WanderSpire {
 		std::vector<std::unique_ptr<RenderCommand>> m_commands;
 		int m_orderIncrement = 1;
 		int m_autoOrder = 0; ///< Auto-incrementing order for convenience
+		uint64_t m_frameIndex = 0;
+		bool m_hasViewport = false;
+		std::array<int, 4> m_viewport{};
 
-		/// Sort commands by layer, then by order within layer
+		/// Sort commands by layer, then by order within layer; ties keep submission order
 		void SortCommands();
 	};
 
@@ -1,6 +1,7 @@
 ﻿// include/WanderSpire/Graphics/RenderResourceManager.h
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <memory>
@@ -11,6 +12,19 @@
 
 namespace WanderSpire {
 
+	/// How one atlas folder was packed by GenerateAtlases
+	struct AtlasBuildReport {
+		size_t   images = 0;
+		size_t   pages = 0;
+		size_t   rejected = 0;          ///< Images larger than a page, left out
+		uint64_t usedArea = 0;          ///< Image pixels
+		uint64_t pageArea = 0;          ///< Page pixels
+		double   efficiency = 0.0;      ///< usedArea / pageArea
+		bool     textureArray = false;
+		size_t   batchesPerPass = 0;    ///< Texture binds to draw frames from every page: 1 for an array, else pages
+		bool     cached = false;        ///< Sources unchanged; the atlas written last time was reused
+	};
+
 	class RenderResourceManager {
 	public:
 		// publicly default-constructible
@@ -29,6 +43,11 @@ namespace WanderSpire {
 		void RegisterShader(const std::string& name,
 			const std::string& vsPath,
 			const std::string& fsPath);
+		/// Compile from source right away (built-in shaders, tests); like
+		/// RegisterShader, registering a name again recompiles the same object
+		void RegisterShaderSource(const std::string& name,
+			const std::string& vsSource,
+			const std::string& fsSource);
 		Shader* GetShader(const std::string& name);
 
 		// Single textures (for spritesheets)
@@ -42,8 +61,17 @@ namespace WanderSpire {
 			const std::string& mappingJsonPath);
 		TextureAtlas* GetAtlas(const std::string& name);
 		size_t GetAtlasCount() const;
-
+		/// Bumped whenever an atlas is (re)loaded; frames looked up before are stale
+		uint64_t GetAtlasRevision() const { return m_AtlasRevision; }
+
+		/// Pack every subfolder of `texturesSubfolder` into a (multi-page) atlas,
+		/// write its pages and mapping next to the folders, and register it.
+		/// Atlases whose sources and settings hash to the key stored in their
+		/// mapping are reused without decoding; the rest decode, pack and
+		/// encode on RenderJobPool.
 		void GenerateAtlases(const std::string& texturesSubfolder);
+		/// Packing result of a generated atlas; null if it was not generated
+		const AtlasBuildReport* GetAtlasReport(const std::string& name) const;
 
 		/// NEW: Auto-register all spritesheets from Assets/SpriteSheets/
 		void RegisterSpritesheets(const std::string& spriteSheetsRoot = "SpriteSheets");
@@ -52,6 +80,11 @@ namespace WanderSpire {
 		const std::unordered_map<std::string, std::unique_ptr<TextureAtlas>>&
 			GetAtlasMap() const { return m_Atlases; }
 
+		/// Delete the GL objects of every shader, texture and atlas. They stay
+		/// registered, so pointers held elsewhere remain valid, and registering
+		/// them again fills them. Needs the GL context.
+		void Shutdown();
+
 		// Expose for binding before glDrawElements
 		GLuint GetQuadVAO() const { return m_QuadVAO; }
 		GLuint GetQuadEBO() const { return m_QuadEBO; }
@@ -60,6 +93,9 @@ namespace WanderSpire {
 		std::unordered_map<std::string, std::unique_ptr<Shader>>       m_Shaders;
 		std::unordered_map<std::string, std::shared_ptr<Texture>>      m_Textures;
 		std::unordered_map<std::string, std::unique_ptr<TextureAtlas>> m_Atlases;
+		std::unordered_map<std::string, AtlasBuildReport>              m_AtlasReports;
+
+		uint64_t m_AtlasRevision = 0;
 
 		GLuint m_QuadVAO = 0;  ///< The quad VAO
 		GLuint m_QuadEBO = 0;  ///< The quad EBO (must be bound with VAO)
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "WanderSpire/Graphics/FramePacket.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace WanderSpire {
+
+	/// Where frame packets end up. The default runs the commands on whatever
+	/// GL context is current and presents nothing; the window backend (see
+	/// SDLContext) moves its context between threads and swaps buffers, and
+	/// tests install a recording one.
+	class RenderBackend {
+	public:
+		virtual ~RenderBackend() = default;
+
+		/// Make the context current on the calling thread
+		virtual bool AttachContext() { return true; }
+		/// Release the context from the calling thread
+		virtual void DetachContext() {}
+
+		/// Draw the packet's commands
+		virtual void Execute(FramePacket& packet);
+		/// Show the finished frame
+		virtual void Present(const FramePacket&) {}
+	};
+
+	struct RenderThreadStats {
+		bool     threaded = false;
+		uint64_t framesSubmitted = 0;
+		uint64_t framesPresented = 0;
+		uint64_t contextBorrows = 0;       ///< ContextScopes that took the context from the render thread
+		double   lastRenderMicros = 0.0;   ///< Execute + present of the last packet
+		double   averageRenderMicros = 0.0;
+		double   averageBuildMicros = 0.0; ///< Producer time from Pace() to SubmitPacket()
+		double   lastPaceWaitMicros = 0.0;
+		double   paceWaitMicros = 0.0;     ///< Total producer time spent waiting in Pace()
+	};
+
+	/**
+	 * Runs frame packets through a RenderBackend, either on the calling
+	 * thread or on a dedicated render thread that owns the GL context.
+	 *
+	 * Both modes take the same path: the producer calls Pace(), builds its
+	 * commands, fills BeginPacket() and calls SubmitPacket(). Single-threaded,
+	 * the packet is drawn and presented right there. Threaded, it goes into
+	 * one of two slots: the render thread draws one while the producer fills
+	 * the other, so a slow simulation frame and a slow driver frame overlap
+	 * instead of adding up. Packets are drawn strictly in submission order.
+	 *
+	 * Pace() keeps the producer at most one frame ahead, and if the render
+	 * thread will stay busy longer than a frame takes to build, delays the
+	 * start of the next frame so it samples input as late as possible.
+	 *
+	 * While threaded, any other GL work (resource uploads, hot reload, the
+	 * editor's render target calls) must happen inside a ContextScope, which
+	 * waits for queued packets and borrows the context.
+	 */
+	class RenderThread {
+	public:
+		static RenderThread& Get();
+		~RenderThread();
+
+		/// Replace the backend (null restores the default); not while threaded
+		void SetBackend(std::unique_ptr<RenderBackend> backend);
+
+		/// Move the context to a new render thread; call where it is current
+		bool Start();
+		/// Draw what is queued, end the render thread and take the context back
+		void Stop();
+		bool IsThreaded() const { return m_threaded.load(std::memory_order_acquire); }
+
+		/// True if the calling thread may issue GL calls right now
+		bool OwnsContext() const;
+
+		/// Call before building a frame; may wait for the render thread
+		void Pace();
+		/// Packet to fill for the next frame; empty, but keeps its capacity
+		FramePacket& BeginPacket();
+		/// Hand the packet from BeginPacket() over to be drawn
+		void SubmitPacket();
+		/// Wait until every submitted packet has been presented
+		void Flush();
+
+		RenderThreadStats GetStats() const;
+		void ResetStats();
+
+		/// Borrows the context for the calling thread while alive. Does nothing
+		/// when not threaded, on the render thread, or inside another scope.
+		class ContextScope {
+		public:
+			ContextScope();
+			~ContextScope();
+			ContextScope(const ContextScope&) = delete;
+			ContextScope& operator=(const ContextScope&) = delete;
+
+		private:
+			bool m_borrowed = false;
+		};
+
+	private:
+		RenderThread();
+
+		enum class SlotState : uint8_t { Free, Ready, Executing };
+		enum class StartState : uint8_t { Pending, Running, Failed };
+
+		struct Slot {
+			FramePacket packet;
+			SlotState state = SlotState::Free;
+		};
+
+		void ThreadLoop();
+		void Process(FramePacket& packet);
+		bool Borrow();
+		void Return();
+
+		mutable std::mutex m_mutex;
+		std::condition_variable m_wake;      ///< Render thread waits here
+		std::condition_variable m_changed;   ///< Producers and borrowers wait here
+		std::thread m_thread;
+		std::atomic<bool> m_threaded{ false };
+		bool m_stopping = false;
+		StartState m_startState = StartState::Pending;
+		bool m_borrowRequested = false;
+		bool m_lent = false;                 ///< The render thread released the context to a borrower
+
+		std::unique_ptr<RenderBackend> m_backend;
+		std::array<Slot, 2> m_slots;
+		size_t m_write = 0;                  ///< Slot the producer fills next
+		size_t m_read = 0;                   ///< Slot the render thread draws next
+		std::chrono::steady_clock::time_point m_buildStart;
+		std::chrono::steady_clock::time_point m_executeStart;
+
+		RenderThreadStats m_stats;
+	};
+
+} // namespace WanderSpire
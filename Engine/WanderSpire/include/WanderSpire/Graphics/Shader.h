@@ -1,13 +1,19 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <glm/glm.hpp>
 #include <glad/glad.h>
 #include <spdlog/spdlog.h>
 
 namespace WanderSpire {
 
+	/// Index of a uniform declared on a Shader; stays valid when the program is relinked
+	using UniformHandle = int32_t;
+	inline constexpr UniformHandle InvalidUniform = -1;
+
 	class Shader {
 	public:
 		/// Placeholder ctor
@@ -23,7 +29,19 @@ namespace WanderSpire {
 
 		GLuint GetID() const { return m_ProgramID; }
 
-		// Uniform setters
+		/// Declare a uniform once and keep the handle. Its location is resolved
+		/// at every link (including hot-reloads); declaring twice returns the same handle.
+		UniformHandle DeclareUniform(const std::string& name);
+
+		// Typed setters for a declared uniform. The shader must be bound; a value
+		// equal to the last one set on this program is not sent again.
+		void Set(UniformHandle handle, int value);
+		void Set(UniformHandle handle, float value);
+		void Set(UniformHandle handle, const glm::vec2& v);
+		void Set(UniformHandle handle, const glm::vec3& v);
+		void Set(UniformHandle handle, const glm::mat4& m);
+
+		// Uniform setters by name (declare on first use)
 		void SetUniformInt(const std::string& name, int value);
 		void SetUniformFloat(const std::string& name, float value);
 		void SetUniformVec2(const std::string& name, const glm::vec2& v);
@@ -33,13 +51,26 @@ namespace WanderSpire {
 		/// Async/hot-reload entry: compile & link on main thread.
 		void CompileFromSource(const std::string& vsSource, const std::string& fsSource);
 
+		/// Delete the program; declared uniforms are kept for the next
+		/// CompileFromSource. Needs the GL context.
+		void Release();
+
 	private:
+		struct UniformSlot {
+			std::string name;
+			GLint location = -1;
+			bool  known = false;            ///< `value` mirrors what the program holds
+			float value[16] = {};
+		};
+
 		GLuint CompileShader(GLenum type, const std::string& src);
-		GLint  GetUniformLocation(const std::string& name);
+		void   ResolveUniforms();
+		/// Slot to upload to, or null when the value is unchanged or the uniform absent
+		UniformSlot* Changed(UniformHandle handle, const void* value, size_t bytes);
 
 		GLuint m_ProgramID = 0;
-		mutable std::unordered_map<std::string, GLint> m_UniformLocationCache;
-		static inline GLuint s_CurrentProgramID = 0;
+		std::vector<UniformSlot> m_Uniforms;
+		std::unordered_map<std::string, UniformHandle> m_UniformHandles;
 	};
 
 }
@@ -16,13 +16,15 @@ namespace WanderSpire {
 		void BeginFrame(const glm::mat4& viewProjection);
 
 		/// Draw a quad. If textureID==0, draws a solid quad with 'color'.
+		/// With layer >= 0, textureID is a texture array sampled at that layer.
 		void DrawSprite(GLuint textureID,
 			const glm::vec2& position,
 			const glm::vec2& size,
 			float rotation,
 			const glm::vec3& color,
 			const glm::vec2& uvMin,
-			const glm::vec2& uvMax);
+			const glm::vec2& uvMax,
+			int layer = -1);
 
 		/// Helper to draw a colored border around a tile.
 		void DrawTileBorder(const glm::vec2& worldPos,
@@ -36,6 +38,19 @@ namespace WanderSpire {
 		SpriteRenderer();
 		Shader* m_Shader = nullptr;
 		GLuint  m_QuadVAO = 0;
+
+		struct {
+			UniformHandle texture = InvalidUniform;
+			UniformHandle useTexture = InvalidUniform;
+			UniformHandle useInstancing = InvalidUniform;
+			UniformHandle model = InvalidUniform;
+			UniformHandle color = InvalidUniform;
+			UniformHandle uvOffset = InvalidUniform;
+			UniformHandle uvSize = InvalidUniform;
+			UniformHandle textureArray = InvalidUniform;
+			UniformHandle useTextureArray = InvalidUniform;
+			UniformHandle layer = InvalidUniform;
+		} m_Uniforms;
 	};
 
 } // namespace WanderSpire
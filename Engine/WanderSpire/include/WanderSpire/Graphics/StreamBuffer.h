@@ -0,0 +1,144 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+namespace WanderSpire {
+
+	/// Kinds of per-frame data sharing the stream buffer (counted separately)
+	enum class StreamUsage : uint8_t {
+		Instance = 0,
+		Sprite,
+		Debug,
+		Count
+	};
+
+	/**
+	 * The GL calls StreamBuffer makes. The default implementation forwards to the
+	 * installed GL::Device; tests substitute a recording one so the fence and offset
+	 * logic runs without a GPU.
+	 */
+	class StreamBufferDevice {
+	public:
+		virtual ~StreamBufferDevice() = default;
+
+		/// Immutable storage that stays mapped (GL_ARB_buffer_storage)
+		virtual bool SupportsPersistentMapping() const = 0;
+
+		/// Allocate the buffer; with `persistent`, return its coherent write mapping
+		virtual bool  CreateStorage(size_t capacity, bool persistent, void** outMapping) = 0;
+		virtual void  DestroyStorage() = 0;
+		virtual GLuint GetBuffer() const = 0;
+
+		/// Fallback path: map one range without synchronizing (fences already did)
+		virtual void* MapRange(size_t offset, size_t size) = 0;
+		virtual void  UnmapRange() = 0;
+
+		virtual uint64_t InsertFence() = 0;
+		/// True once the GPU has passed the fence; a zero timeout only polls
+		virtual bool WaitFence(uint64_t fence, uint64_t timeoutNanos) = 0;
+		virtual void DeleteFence(uint64_t fence) = 0;
+	};
+
+	struct StreamBufferStats {
+		uint64_t bytesThisFrame = 0;
+		uint64_t bytesLastFrame = 0;
+		uint64_t bytesLastFrameByUsage[static_cast<size_t>(StreamUsage::Count)] = {};
+		uint64_t bytesTotal = 0;
+		uint64_t allocations = 0;
+		uint64_t failedAllocations = 0;     ///< Larger than the whole buffer
+		uint64_t stalls = 0;                ///< Waits on a fence the GPU had not passed
+		double   stallMicros = 0.0;
+		uint64_t wraps = 0;
+		uint64_t frames = 0;
+		size_t   capacity = 0;
+		size_t   framesInFlight = 0;        ///< Fenced frames not yet reclaimed
+		bool     persistent = false;
+	};
+
+	/**
+	 * One large ring buffer for data rewritten every frame (instances, sprites,
+	 * debug geometry), replacing per-draw glBufferData re-specification.
+	 *
+	 * Allocations are carved sequentially out of the ring. EndFrame() fences
+	 * what the frame used; its bytes are reused once the GPU passes the fence,
+	 * at the latest `framesInFlight` frames later. Where GL_ARB_buffer_storage
+	 * exists the whole buffer stays persistently mapped and an upload is a
+	 * memcpy; elsewhere each allocation maps its own range unsynchronized,
+	 * which the fences make safe.
+	 */
+	class StreamBuffer {
+	public:
+		static constexpr size_t DEFAULT_CAPACITY = 8 * 1024 * 1024;
+		static constexpr size_t DEFAULT_FRAMES_IN_FLIGHT = 3;
+
+		/// A range of the buffer for this frame's data; empty on failure
+		struct Allocation {
+			void*  data = nullptr;
+			size_t offset = 0;              ///< Bytes from the start of the buffer
+			size_t size = 0;
+			GLuint buffer = 0;
+
+			explicit operator bool() const { return data != nullptr; }
+		};
+
+		static StreamBuffer& Get();
+
+		StreamBuffer() = default;
+		~StreamBuffer();
+
+		StreamBuffer(const StreamBuffer&) = delete;
+		StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+		/// Needs a current GL context unless a device is given
+		bool Initialize(size_t capacity = DEFAULT_CAPACITY, size_t framesInFlight = DEFAULT_FRAMES_IN_FLIGHT,
+			std::unique_ptr<StreamBufferDevice> device = nullptr);
+		void Shutdown();
+		bool IsInitialized() const { return m_device != nullptr; }
+
+		/// Reserve `size` bytes; write them, then call Commit() before drawing
+		Allocation Allocate(size_t size, StreamUsage usage, size_t alignment = 16);
+		void Commit(const Allocation& allocation);
+
+		/// Allocate, copy and commit in one step
+		Allocation Upload(const void* data, size_t size, StreamUsage usage, size_t alignment = 16);
+
+		/// Fence everything allocated since the last call; once per frame after the last draw
+		void EndFrame();
+
+		const StreamBufferStats& GetStats() const { return m_stats; }
+		void ResetStats();
+
+		GLuint GetBuffer() const { return m_device ? m_device->GetBuffer() : 0; }
+		size_t GetCapacity() const { return m_capacity; }
+		size_t GetHead() const { return m_head; }
+		size_t GetBytesInUse() const { return m_used; }
+
+	private:
+		struct FencedFrame {
+			uint64_t fence;
+			size_t   bytes;                 ///< Ring bytes (padding included) the frame used
+		};
+
+		void FenceCurrentFrame();
+		bool RetireOldest(bool wait);
+
+		std::unique_ptr<StreamBufferDevice> m_device;
+		uint8_t* m_mapping = nullptr;       ///< Persistent mapping, null on the fallback path
+		bool   m_rangeMapped = false;       ///< Fallback: an allocation's range awaits Commit()
+		size_t m_capacity = 0;
+		size_t m_maxFramesInFlight = DEFAULT_FRAMES_IN_FLIGHT;
+
+		size_t m_head = 0;                  ///< Next free byte
+		size_t m_used = 0;                  ///< Bytes not yet reclaimed, padding included
+		size_t m_frameBytes = 0;            ///< Of which the current, unfenced frame
+		std::deque<FencedFrame> m_inFlight;
+
+		uint64_t m_usageBytes[static_cast<size_t>(StreamUsage::Count)] = {};
+		StreamBufferStats m_stats;
+	};
+
+} // namespace WanderSpire
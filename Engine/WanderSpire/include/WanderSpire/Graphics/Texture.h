@@ -24,6 +24,9 @@ namespace WanderSpire {
 
 		void UploadFromData(const unsigned char* data, int width, int height);
 
+		/// Delete the GL texture; UploadFromData creates it again. Needs the GL context.
+		void Release();
+
 	private:
 		GLuint      m_TextureID = 0;
 		int         m_Width = 0;
@@ -2,8 +2,10 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <glm/glm.hpp>
 #include <memory>
+#include <glad/glad.h>
 #include "WanderSpire/Graphics/Texture.h"
 
 namespace WanderSpire {
@@ -11,18 +13,43 @@ namespace WanderSpire {
 	struct AtlasFrame {
 		glm::vec2 uvOffset;
 		glm::vec2 uvSize;
+		int       page = 0;   ///< Page holding the frame
 	};
 
+	/// Packed sprite frames on one or more pages. The mapping JSON lists the
+	/// pages under meta.pages; with meta.textureArray they are uploaded as the
+	/// layers of one GL_TEXTURE_2D_ARRAY, so frames of every page share a bind.
 	class TextureAtlas {
 	public:
+		TextureAtlas() = default;
+		~TextureAtlas();
+		TextureAtlas(const TextureAtlas&) = delete;
+		TextureAtlas& operator=(const TextureAtlas&) = delete;
 
 		void Load(const std::string& atlasImagePath, const std::string& mappingJsonPath);
 
-		std::shared_ptr<Texture> GetTexture() const { return m_AtlasTexture; }
+		/// First page; null when the pages live in a texture array
+		std::shared_ptr<Texture> GetTexture() const { return m_Pages.empty() ? nullptr : m_Pages.front(); }
 		AtlasFrame               GetFrame(const std::string& name) const;
 
+		size_t GetPageCount() const { return m_PageCount; }
+		bool   IsTextureArray() const { return m_ArrayTexture != 0; }
+
+		/// Texture to bind for `frame`: its page, or the array holding every page
+		GLuint GetTextureID(const AtlasFrame& frame) const;
+		/// Array layer to sample for `frame`; -1 unless the pages form a texture array
+		int    GetLayer(const AtlasFrame& frame) const { return IsTextureArray() ? frame.page : -1; }
+
+		/// Delete the pages' GL textures; the page objects stay for the next Load().
+		/// Needs the GL context.
+		void Release();
+
 	private:
-		std::shared_ptr<Texture>              m_AtlasTexture;
+		void ReleaseArray();
+
+		std::vector<std::shared_ptr<Texture>>       m_Pages;   ///< Per-page textures, kept across reloads
+		GLuint                                      m_ArrayTexture = 0;
+		size_t                                      m_PageCount = 0;
 		std::unordered_map<std::string, AtlasFrame> m_Frames;
 	};
 
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "WanderSpire/Graphics/Shader.h"
+#include "WanderSpire/Graphics/TileRenderTable.h"
+#include <entt/entt.hpp>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace WanderSpire {
+
+	class TextureAtlas;
+	struct TileLookupDraw;
+	struct TileLookupGpuLayer;
+
+	/// What the tile lookup shader draws at a point
+	struct TileLookupSample {
+		int       tileId = -1;      ///< Stored in the chunk; -1 where nothing is drawn
+		glm::vec2 uv{ 0.0f };       ///< Atlas coordinates sampled
+		int       page = 0;
+	};
+
+	/// Last frame's work, summed over the layers drawn by lookup
+	struct TileLookupStats {
+		size_t   layers = 0;
+		size_t   residentChunks = 0;    ///< Chunks holding a region of an index texture
+		size_t   drawnChunks = 0;       ///< Chunk quads drawn
+		size_t   drawCalls = 0;
+		uint64_t indexTexels = 0;       ///< Tile ids sent to index textures
+		uint64_t lookupTexels = 0;      ///< Texels sent to lookup textures
+		uint64_t fullUploads = 0;       ///< Index textures sent whole (created, grown or resynchronized)
+	};
+
+	/// Uniforms of a tile lookup shader, declared once per shader
+	struct TileLookupUniforms {
+		UniformHandle chunkSize = InvalidUniform;
+		UniformHandle tileSize = InvalidUniform;
+		UniformHandle tileIndex = InvalidUniform;
+		UniformHandle tileLookup = InvalidUniform;
+		UniformHandle texture = InvalidUniform;
+		UniformHandle textureArray = InvalidUniform;
+		UniformHandle useTextureArray = InvalidUniform;
+		UniformHandle page = InvalidUniform;
+	};
+
+	/**
+	 * Draws tilemap layers without per-tile work on the CPU.
+	 *
+	 * Every loaded chunk of a layer owns a chunkSize² region of the layer's
+	 * integer index texture (GL_R32I), which holds its tile ids. A chunk is
+	 * uploaded when it first becomes resident; after that, a new chunk
+	 * version is compared with the copy kept here and only the rectangle of
+	 * tiles that changed is sent. A second, small texture maps each tile id
+	 * to the atlas frame it shows this frame (animations included), two
+	 * RGBA32F texels per id: uv offset and size, then the page.
+	 *
+	 * The layer is then one instanced draw of one quad per visible chunk, and
+	 * the fragment shader resolves the tile under each pixel through both
+	 * textures. Per frame the CPU touches the layer's chunks and tile ids,
+	 * never its tiles, so the cost does not depend on zoom or tile count.
+	 *
+	 * Prepare() runs on the game thread and keeps all bookkeeping; the
+	 * TileLookupDraw it returns carries the uploads and quads to Draw() on the
+	 * thread holding the context. Packets of a layer must be drawn in order;
+	 * if one is lost (the frame was cleared), the next Prepare() sends the
+	 * layer's textures whole again.
+	 *
+	 * Sample() is the CPU reference of the shader, reading the same data the
+	 * textures receive.
+	 *
+	 * Textures of layers no longer drawn are deleted by the next Draw() or by
+	 * Shutdown().
+	 */
+	class TileLookupRenderer {
+	public:
+		/// Atlas frame shown for a tile id (the animation frame already applied);
+		/// null if the id has none and should not be drawn
+		using Resolver = std::function<const TileRenderEntry* (int tileId)>;
+
+		static constexpr int INDEX_TEXTURE_WIDTH = 1024;      ///< Texels; chunk regions are packed in rows
+		static constexpr int MAX_INDEX_TEXTURE_HEIGHT = 4096;
+		static constexpr int LOOKUP_IDS_PER_ROW = 256;        ///< Two texels per id
+		static constexpr int MAX_TILE_ID = 1 << 20;
+
+		static TileLookupRenderer& Get();
+
+		TileLookupRenderer(const TileLookupRenderer&) = delete;
+		TileLookupRenderer& operator=(const TileLookupRenderer&) = delete;
+
+		/// Start a frame: layers not prepared since the last call are dropped,
+		/// and the stats restart
+		void BeginFrame();
+
+		/// Bring the layer's index and lookup textures up to date with its
+		/// loaded chunks and build its draw for the view. `atlas` and `shader`
+		/// are only used by Draw(). Null if there is nothing to draw or upload.
+		std::shared_ptr<const TileLookupDraw> Prepare(const entt::registry& registry, entt::entity layer,
+			const Resolver& resolve, const TextureAtlas* atlas, Shader* shader,
+			const glm::vec2& minBound, const glm::vec2& maxBound, float tileSize);
+
+		/// Apply a packet's uploads and draw it; needs the GL context
+		static void Draw(const TileLookupDraw& draw);
+
+		/// What the layer's shader draws at `world`, computed on the CPU
+		TileLookupSample Sample(entt::entity layer, const glm::vec2& world, float tileSize) const;
+
+		const TileLookupStats& GetStats() const { return m_stats; }
+
+		/// Forget every layer; their textures are deleted by the next Draw()
+		void Clear();
+
+		/// Forget every layer and delete all textures; needs the GL context
+		void Shutdown();
+
+	private:
+		/// A chunk's region of the index texture
+		struct Slot {
+			int          index = 0;
+			entt::entity chunk = entt::null;
+			uint64_t     version = 0;
+			uint64_t     seenPass = 0;
+		};
+
+		struct Layer {
+			const entt::registry* registry = nullptr;
+			uint64_t preparedFrame = 0;
+			uint64_t passes = 0;                         ///< Prepare() calls; chunks missing from the latest are dropped
+			uint64_t serial = 0;                         ///< Packets built for the layer
+			std::shared_ptr<TileLookupGpuLayer> gpu;
+
+			int chunkSize = 0;
+			int slotRows = 0;                            ///< Rows of chunk regions in the index texture
+			int slotCount = 0;                           ///< Regions handed out so far
+			std::unordered_map<uint64_t, Slot> slots;    ///< By chunk coordinates
+			std::vector<int> freeSlots;
+			std::vector<int32_t> index;                  ///< Copy of the index texture
+
+			std::vector<uint8_t> knownIds;               ///< Ids stored in any chunk so far
+			std::vector<int> knownList;
+			int lookupRows = 0;
+			std::vector<glm::vec4> lookup;               ///< Copy of the lookup texture
+			std::vector<uint8_t> pagesUsed;              ///< Atlas pages any known id shows
+		};
+
+		TileLookupRenderer() = default;
+
+		int  AllocateSlot(Layer& layer, bool& grown);
+		glm::ivec2 SlotOrigin(const Layer& layer, int slot) const;
+		/// Copy a chunk's tiles into its region; the changed rectangle goes to `draw`
+		void SyncChunk(Layer& layer, const Slot& slot, const int* tiles, TileLookupDraw* draw);
+		/// Re-resolve every known id; changed rows go to `draw`
+		void SyncLookup(Layer& layer, const Resolver& resolve, bool full, TileLookupDraw& draw);
+		/// Hand the layer's textures to the next Draw() to delete
+		void Release(Layer& layer);
+		/// Delete released textures; needs the GL context
+		void DeleteReleased();
+		/// The shader's uniform handles, declared on first use
+		const TileLookupUniforms& UniformsFor(Shader& shader);
+
+		std::unordered_map<entt::entity, Layer> m_layers;
+		std::unordered_map<const Shader*, TileLookupUniforms> m_uniforms;
+		uint64_t m_frame = 1;
+		TileLookupStats m_stats;
+		std::vector<int> m_scratch;
+
+		std::mutex m_releasedMutex;
+		std::vector<std::shared_ptr<TileLookupGpuLayer>> m_released;
+	};
+
+} // namespace WanderSpire
@@ -0,0 +1,106 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace WanderSpire {
+
+	class TextureAtlas;
+
+	/// How one tile id is drawn: an atlas frame
+	struct TileRenderEntry {
+		glm::vec2 uvOffset{ 0.0f };
+		glm::vec2 uvSize{ 0.0f };
+		const TextureAtlas* atlas = nullptr;
+		int page = 0;   ///< Atlas page holding the frame
+	};
+
+	/**
+	 * Flat tile id → atlas frame table used by tilemap rendering, plus the
+	 * table-driven tile animations.
+	 *
+	 * Entries are resolved once per tile id (by RenderSystem, from
+	 * TileDefinitionManager and the atlases) instead of once per drawn tile,
+	 * and dropped when the definitions change.
+	 *
+	 * An animated tile id is drawn as one of its frame tile ids. The frames of
+	 * every animation are compiled into flat arrays, and ResolveAnimations()
+	 * picks each animation's current frame from a single global clock. That
+	 * pass touches only the animation table, so a whole ocean of animated
+	 * water costs the same per frame as a single tile.
+	 */
+	class TileRenderTable {
+	public:
+		struct Frame {
+			int   tileId = -1;
+			float duration = 0.1f;   ///< Seconds
+		};
+
+		static TileRenderTable& GetInstance();
+
+		/// Drawn appearance of a tile id; null if not resolved yet
+		const TileRenderEntry* GetEntry(int tileId) const;
+		void SetEntry(int tileId, const TileRenderEntry& entry);
+
+		/// Drop resolved entries if the definitions or the atlases (which reload
+		/// in place) changed since the last sync
+		void SyncDefinitions(uint64_t definitionRevision, uint64_t atlasRevision);
+
+		/// Tile id to draw in place of `tileId` this frame (itself unless animated)
+		int GetDisplayTile(int tileId) const {
+			return tileId >= 0 && static_cast<size_t>(tileId) < m_display.size() ? m_display[tileId] : tileId;
+		}
+
+		/// Animate `tileId` through `frames`; an empty list removes the animation
+		void SetAnimation(int tileId, const std::vector<Frame>& frames, bool loop = true);
+		void RemoveAnimation(int tileId);
+		void ClearAnimations();
+		size_t GetAnimationCount() const { return m_animations.size(); }
+
+		/// Global animation clock, in seconds
+		void   Advance(float deltaTime) { m_time += deltaTime; }
+		void   SetTime(double seconds) { m_time = seconds; }
+		double GetTime() const { return m_time; }
+
+		/// Index of the frame an animation shows now (-1 if `tileId` is not animated)
+		int GetCurrentFrame(int tileId) const;
+
+		/// Point every animated tile id at its current frame; O(animations)
+		void ResolveAnimations();
+
+		/// Drop entries, animations and the clock
+		void Clear();
+
+	private:
+		TileRenderTable() = default;
+
+		/// Frames of one animation live in m_frameTiles/m_frameEnds[first, first + count)
+		struct Animation {
+			int   tileId = -1;
+			int   first = 0;
+			int   count = 0;
+			float length = 0.0f;
+			bool  loop = true;
+		};
+
+		static constexpr int MAX_DENSE_ID = 1 << 20;
+
+		int FrameAt(const Animation& animation) const;
+		void Recompile();
+
+		std::vector<TileRenderEntry> m_entries;               ///< Dense by tile id
+		std::vector<uint8_t> m_hasEntry;
+		std::unordered_map<int, TileRenderEntry> m_sparseEntries;   ///< Ids past MAX_DENSE_ID
+		uint64_t m_definitionRevision = UINT64_MAX;
+		uint64_t m_atlasRevision = UINT64_MAX;
+
+		std::unordered_map<int, std::pair<std::vector<Frame>, bool>> m_definitions;
+		std::vector<Animation> m_animations;
+		std::vector<int>   m_frameTiles;
+		std::vector<float> m_frameEnds;       ///< Cumulative end time of each frame
+		std::vector<int>   m_display;         ///< Tile id → tile id drawn this frame
+		double m_time = 0.0;
+	};
+
+} // namespace WanderSpire
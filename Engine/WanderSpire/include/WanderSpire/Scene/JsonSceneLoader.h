@@ -10,8 +10,9 @@ namespace WanderSpire::Scene {
 	public:
 		SceneLoadResult LoadScene(const std::string& filePath, entt::registry& registry) override;
 		bool SupportsFormat(const std::string& extension) const override;
+		/// chunkPayloads: the scene's shared "chunkPayloads" table, if any
 		void LoadEntityComponents(entt::entity entity, const nlohmann::json& components,
-			entt::registry& registry);
+			entt::registry& registry, const nlohmann::json* chunkPayloads = nullptr);
 	private:
 		struct LoadContext {
 			entt::registry* registry;
@@ -20,10 +20,12 @@ namespace WanderSpire::Scene {
 			nlohmann::json sceneJson;
 			std::vector<entt::entity> entitiesToSave;
 			size_t entitiesSaved = 0;
+			std::unordered_map<entt::entity, size_t> chunkPayloads;   // chunk → index into "chunkPayloads"
 		};
 
 		void GatherEntities(SaveContext& context);
 		void SaveMetadata(const SceneMetadata& metadata, SaveContext& context);
+		void SaveChunkPayloads(SaveContext& context);
 		void SaveEntities(SaveContext& context);
 		void SaveHierarchy(SaveContext& context);
 
@@ -0,0 +1,17 @@
+#pragma once
+#include <entt/entt.hpp>
+
+namespace WanderSpire {
+
+	/** Table-driven tile animation. Each AnimatedTileComponent animates the
+	 *  tile id of its first frame everywhere that id appears in a tilemap;
+	 *  the definitions are compiled into TileRenderTable, whose single clock
+	 *  advances once per frame. Paused components hold their current frame. */
+	struct AnimatedTileSystem {
+		/// Advance the shared clock; call once per frame, not once per registry
+		static void AdvanceClock(float deltaTime);
+
+		static void Update(entt::registry& registry);
+	};
+
+}
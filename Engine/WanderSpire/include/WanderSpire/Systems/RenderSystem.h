@@ -1,11 +1,15 @@
 ﻿#pragma once
 #include <entt/entt.hpp>
 #include "WanderSpire/Graphics/RenderCommand.h"
+#include <memory>
+#include <vector>
 
 namespace WanderSpire {
 	struct AppState;
 
-	/// Submits entity rendering commands to the RenderManager instead of immediate rendering
+	/// Submits entity rendering commands to the RenderManager instead of immediate rendering.
+	/// Culling, sorting and tile instance building run on RenderJobPool; the
+	/// commands come out the same whatever the number of threads.
 	class RenderSystem {
 	public:
 		/// Installs the event‑bus subscription (call once during bootstrap).
@@ -15,11 +19,28 @@ namespace WanderSpire {
 		static void SubmitEntityCommands(const entt::registry& registry,
 			const AppState* state);
 
+		/// Culled sprite commands of every entity in the bounds, ordered by zOrder and
+		/// then by view order. `jobs` splits the entities into that many ranges built
+		/// in parallel (0 = pick from the pool size); the result is the same for any value.
+		static std::vector<std::unique_ptr<RenderCommand>> BuildEntityCommands(const entt::registry& registry,
+			const glm::vec2& minBound,
+			const glm::vec2& maxBound,
+			size_t jobs = 0);
+
 		/// Submit terrain/chunk rendering commands using new ECS tilemap system
 		static void SubmitTerrainCommands(const AppState* state,
 			const glm::vec2& minBound,
 			const glm::vec2& maxBound);
 
+		/// Submit every visible layer of the given tilemaps, one command per layer.
+		/// The layers' instances are built on RenderJobPool; the commands are the
+		/// same for any pool size.
+		static void SubmitTilemapLayers(const entt::registry& registry,
+			const std::vector<entt::entity>& tilemaps,
+			const glm::vec2& minBound,
+			const glm::vec2& maxBound,
+			float tileSize);
+
 		/// Submit debug overlay commands
 		static void SubmitDebugCommands(const entt::registry& registry,
 			const AppState* state,
@@ -0,0 +1,130 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace WanderSpire {
+
+	struct TilemapChunkComponent;
+
+	/// Counters for one registry's chunk cache; latencies are cumulative.
+	struct ChunkCacheStats {
+		uint64_t hits = 0;              ///< Chunk creations served from the cache
+		uint64_t misses = 0;            ///< Unloaded or file-backed chunks recreated without the cache
+		uint64_t stores = 0;            ///< Unloaded chunks taken into the cache
+		uint64_t evictions = 0;         ///< Entries dropped to stay within budget
+		size_t   entries = 0;
+		size_t   pinned = 0;            ///< Entries holding edits no file or generator has
+		size_t   bytes = 0;             ///< Compressed bytes currently held
+		size_t   rawBytes = 0;          ///< What those entries occupy as flat arrays
+		uint64_t storeNanos = 0;        ///< Time spent compressing
+		uint64_t restoreNanos = 0;      ///< Time spent decompressing on hits
+	};
+
+	/**
+	 * Compressed LRU cache of recently unloaded chunks.
+	 *
+	 * TilemapSystem::UnloadChunk hands chunks to Store(), which run-length
+	 * encodes their tile ids and data. When streaming brings a chunk back,
+	 * GetOrCreateChunk calls Restore() and the tiles come back without touching
+	 * disk or a generator. Entries are dropped least recently stored first once
+	 * the byte budget (shared by all registries) is exceeded.
+	 *
+	 * A `modified` chunk holds edits that neither the layer file nor its
+	 * generator could recreate. Its entry is pinned: never evicted, even by a
+	 * zero budget, until the chunk is restored or its layer is forgotten. On a
+	 * `backed` layer an empty chunk is kept too, as a tombstone, so an erased
+	 * chunk is not generated or read from the file again.
+	 *
+	 * A chunk cannot be edited while it is unloaded (any write recreates it,
+	 * which restores and removes the entry), so entries never go stale.
+	 */
+	class ChunkEvictionCache {
+	public:
+		static constexpr size_t DEFAULT_BUDGET_BYTES = 8u << 20;
+
+		static ChunkEvictionCache& GetInstance();
+
+		/// Compress and keep a chunk that is about to be destroyed. `backed`: a
+		/// miss would not recreate it empty (the layer has a file or generator).
+		void Store(entt::registry& registry, entt::entity tilemapLayer, const TilemapChunkComponent& chunk,
+			bool backed = false, bool modified = false);
+
+		/// Fill chunk.tileIds/tileData from the cache and drop the entry; false if absent.
+		/// Only chunks unloaded before, or `backed` ones (the layer file has them),
+		/// count as misses; brand-new chunks were never the cache's to serve.
+		/// `modified` (optional) receives whether the entry was pinned.
+		bool Restore(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords,
+			TilemapChunkComponent& chunk, bool backed = false, bool* modified = nullptr);
+
+		/// Whether Restore() would hit (does not count as a lookup)
+		bool Contains(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords);
+
+		/// Decode a cached chunk but keep the entry; false if absent (does not count as a lookup)
+		bool Peek(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords,
+			std::vector<int>& tileIds, std::vector<uint32_t>& tileData);
+
+		/// Coordinates of every chunk cached for a layer
+		std::vector<glm::ivec2> GetCachedChunks(entt::registry& registry, entt::entity tilemapLayer);
+
+		/// Drop a layer's cached chunks (its content was replaced wholesale)
+		void Forget(entt::registry& registry, entt::entity tilemapLayer);
+
+		/// Byte budget for all cached chunks; 0 disables the cache
+		void   SetBudget(size_t bytes);
+		size_t GetBudget() const;
+
+		ChunkCacheStats GetStats(entt::registry& registry);
+		void ResetStats(entt::registry& registry);
+
+		/// Drop every cached chunk (e.g. on scene unload)
+		void Clear();
+
+	private:
+		ChunkEvictionCache();
+
+		struct Key {
+			entt::entity layer;
+			uint64_t     chunk;
+			bool operator==(const Key& o) const { return layer == o.layer && chunk == o.chunk; }
+		};
+
+		struct KeyHash {
+			size_t operator()(const Key& k) const noexcept;
+		};
+
+		struct RegistryState;
+
+		struct Entry {
+			RegistryState* owner = nullptr;
+			Key key;
+			std::vector<uint8_t> bytes;
+			int tileCount = 0;
+			bool pinned = false;   ///< Lives in m_pinned, out of the eviction order
+		};
+		using EntryList = std::list<Entry>;
+
+		struct RegistryState {
+			std::unordered_map<Key, EntryList::iterator, KeyHash> entries;
+			std::unordered_set<Key, KeyHash> unloaded;   ///< Passed to Store() and not recreated since
+			ChunkCacheStats stats;
+		};
+
+		RegistryState& StateFor(entt::registry& registry);
+		void Erase(EntryList::iterator it);
+		void Trim();
+
+		mutable std::mutex m_mutex;
+		std::unordered_map<const entt::registry*, RegistryState> m_registries;
+		EntryList m_lru;                  ///< Front = most recently stored, across registries
+		EntryList m_pinned;               ///< Modified chunks; counted in m_bytes, never evicted
+		size_t m_bytes = 0;
+		size_t m_budget = DEFAULT_BUDGET_BYTES;
+	};
+
+} // namespace WanderSpire
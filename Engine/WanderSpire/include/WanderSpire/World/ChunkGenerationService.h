@@ -0,0 +1,128 @@
+#pragma once
+#include "WanderSpire/World/ChunkGenerator.h"
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace WanderSpire {
+
+	/**
+	 * Runs chunk generators on worker threads and commits their output in bulk.
+	 *
+	 * When a layer has a generator, TilemapSystem::LoadChunk no longer creates
+	 * an empty chunk. It queues a job here instead, and the chunk appears
+	 * when Update() installs the finished arrays on the main thread, within a
+	 * per-frame time budget. A chunk that got created some other way in the
+	 * meantime (a script wrote to it) keeps its tiles; the generated ones are
+	 * dropped.
+	 *
+	 * Jobs only read their ChunkGenerationContext, so the tiles produced never
+	 * depend on the number of threads or the order jobs finish in.
+	 */
+	class ChunkGenerationService {
+	public:
+		static ChunkGenerationService& GetInstance();
+		~ChunkGenerationService();
+
+		/// Generate missing chunks of a layer with `generator` (null clears it)
+		void SetGenerator(entt::registry& registry, entt::entity tilemapLayer,
+			std::shared_ptr<const IChunkGenerator> generator, uint64_t worldSeed);
+		void ClearGenerator(entt::registry& registry, entt::entity tilemapLayer);
+		bool HasGenerator(entt::registry& registry, entt::entity tilemapLayer);
+
+		/// Queue a chunk; false if the layer has no generator or it is already queued
+		bool Request(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords, int chunkSize);
+
+		/// Drop queued chunks of a layer matching the predicate; returns how many
+		size_t CancelPending(entt::registry& registry, entt::entity tilemapLayer,
+			const std::function<bool(const glm::ivec2&)>& shouldCancel);
+
+		/// Install finished chunks until the frame budget is spent; returns how many
+		size_t Update(entt::registry& registry);
+		size_t Update(entt::registry& registry, uint32_t budgetMicros);
+
+		/// Block until every queued chunk of the registry is generated, then install them all
+		size_t Drain(entt::registry& registry);
+
+		size_t GetPendingCount(entt::registry& registry);
+
+		/// Worker threads (0 = one less than the hardware threads, at least one)
+		void     SetThreadCount(unsigned threads);
+		unsigned GetThreadCount() const;
+
+		void     SetFrameBudget(uint32_t micros);
+		uint32_t GetFrameBudget() const;
+
+		/// Drop every generator, queued job and finished result
+		void Clear();
+
+	private:
+		ChunkGenerationService();
+
+		struct Key {
+			entt::entity layer;
+			uint64_t     chunk;
+			bool operator==(const Key& o) const { return layer == o.layer && chunk == o.chunk; }
+		};
+
+		struct KeyHash {
+			size_t operator()(const Key& k) const noexcept;
+		};
+
+		struct Job {
+			uint64_t   stateId = 0;
+			uint64_t   ticket = 0;
+			Key        key{};
+			std::shared_ptr<const IChunkGenerator> generator;
+			ChunkGenerationContext context;
+		};
+
+		struct Result {
+			uint64_t   ticket = 0;
+			Key        key{};
+			glm::ivec2 chunkCoords{ 0, 0 };
+			std::vector<int> tileIds;
+			std::vector<uint32_t> tileData;
+		};
+
+		struct LayerGenerator {
+			std::shared_ptr<const IChunkGenerator> generator;
+			uint64_t worldSeed = 0;
+		};
+
+		struct RegistryState {
+			uint64_t id = 0;
+			std::unordered_map<entt::entity, LayerGenerator> generators;
+			std::unordered_map<Key, uint64_t, KeyHash> pending;   ///< Queued or running → ticket
+			std::vector<Result> finished;
+			size_t running = 0;
+		};
+
+		RegistryState& StateFor(entt::registry& registry);
+		RegistryState* StateById(uint64_t id);
+		void StartWorkers();
+		void StopWorkers();
+		void WorkerLoop();
+
+		mutable std::mutex m_mutex;
+		std::condition_variable m_jobReady;
+		std::condition_variable m_jobDone;
+		std::unordered_map<const entt::registry*, RegistryState> m_registries;
+		std::deque<Job> m_jobs;
+		std::vector<std::thread> m_workers;
+		bool m_stopping = false;
+		unsigned m_threadCount = 0;
+		uint32_t m_budgetMicros = 1000;
+		uint64_t m_nextStateId = 1;
+		uint64_t m_nextTicket = 1;
+	};
+
+} // namespace WanderSpire
@@ -0,0 +1,101 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace WanderSpire {
+
+	/// Everything a generator may depend on. Output must be a pure function of it.
+	struct ChunkGenerationContext {
+		glm::ivec2 chunkCoords{ 0, 0 };
+		int        chunkSize = 32;
+		uint64_t   worldSeed = 0;      ///< Seed of the whole layer (continuous fields)
+		uint64_t   chunkSeed = 0;      ///< Derived from worldSeed and chunkCoords
+	};
+
+	/**
+	 * Procedural source of chunk tiles, run on ChunkGenerationService workers.
+	 *
+	 * Generate() fills chunkSize² tile ids (pre-filled with -1) and tile data
+	 * (pre-filled with 0). It is called concurrently from several threads, so
+	 * it must not touch shared mutable state, and it must be deterministic:
+	 * the same context always yields the same tiles.
+	 */
+	class IChunkGenerator {
+	public:
+		virtual ~IChunkGenerator() = default;
+		virtual void Generate(const ChunkGenerationContext& context, int* tileIds, uint32_t* tileData) const = 0;
+	};
+
+	namespace Noise {
+
+		/// Well-mixed 64-bit hash of a seed and lattice point
+		uint64_t Hash(uint64_t seed, int x, int y);
+
+		/// Per-chunk seed used by ChunkGenerationContext::chunkSeed
+		uint64_t ChunkSeed(uint64_t worldSeed, const glm::ivec2& chunkCoords);
+
+		/// Smoothly interpolated lattice noise in [-1, 1]
+		float Value2D(uint64_t seed, float x, float y);
+
+		/// 2D simplex noise in roughly [-1, 1]
+		float Simplex2D(uint64_t seed, float x, float y);
+
+	} // namespace Noise
+
+	/**
+	 * Built-in terrain generator: fractal noise height, thresholded into
+	 * biome bands, then decorated with stamps (trees, rocks, ruins...).
+	 *
+	 * Height is sampled in world tile space from worldSeed, so terrain is
+	 * continuous across chunk borders. Stamps are anchored at world tiles
+	 * from worldSeed too and clipped to each chunk they overlap, so they
+	 * cross borders while chunks still generate independently.
+	 */
+	class NoiseChunkGenerator : public IChunkGenerator {
+	public:
+		enum class NoiseType { Value, Simplex };
+
+		/// Tiles with height <= maxHeight (first matching band wins)
+		struct Band {
+			float maxHeight = 0.0f;
+			int   tileId = -1;
+		};
+
+		/// Pattern placed at an anchor tile with probability `density`
+		struct Stamp {
+			int   width = 1;
+			int   height = 1;
+			std::vector<int> tiles;    ///< width × height, row-major; -1 keeps the terrain
+			int   onTileId = -1;       ///< Anchor must be this tile (-1 = any)
+			float density = 0.0f;
+		};
+
+		struct Settings {
+			NoiseType noise = NoiseType::Simplex;
+			float frequency = 0.05f;   ///< Per tile, first octave
+			int   octaves = 4;
+			float persistence = 0.5f;
+			float lacunarity = 2.0f;
+			std::vector<Band> bands;   ///< Ascending maxHeight
+			int   fallbackTileId = -1; ///< Above every band
+			std::vector<Stamp> stamps;
+		};
+
+		explicit NoiseChunkGenerator(Settings settings);
+
+		void Generate(const ChunkGenerationContext& context, int* tileIds, uint32_t* tileData) const override;
+
+		/// Fractal height in [-1, 1] at a world tile position
+		float HeightAt(uint64_t worldSeed, const glm::ivec2& tile) const;
+
+		const Settings& GetSettings() const { return m_settings; }
+
+	private:
+		/// Band tile at a world position, before stamps
+		int TerrainAt(uint64_t worldSeed, const glm::ivec2& tile) const;
+
+		Settings m_settings;
+	};
+
+} // namespace WanderSpire
@@ -0,0 +1,47 @@
+#pragma once
+#include "WanderSpire/World/PalettedTileStorage.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace WanderSpire {
+
+	/**
+	 * Intern table for compact chunk payloads.
+	 *
+	 * Intern() hashes a chunk's decoded tiles and returns the one immutable
+	 * PalettedTileStorage holding that content, so every identical chunk
+	 * (uniform ocean, grass, void) on any layer or registry points at the same
+	 * buffer. The pool only holds weak references; a payload dies with the
+	 * last chunk using it. Chunks split off a private copy before writing
+	 * (TilemapChunkComponent::Unshare).
+	 */
+	class ChunkPayloadPool {
+	public:
+		using Payload = std::shared_ptr<const PalettedTileStorage>;
+
+		static ChunkPayloadPool& GetInstance();
+
+		/// Shared payload with the same tiles as `storage`
+		Payload Intern(const PalettedTileStorage& storage);
+
+		/// Hash of a chunk's flat tile ids and data (data may be null = all zero)
+		static uint64_t ContentHash(const int* tileIds, const uint32_t* tileData, int tileCount);
+
+		/// Distinct payloads still referenced, and the bytes they hold
+		size_t GetPayloadCount();
+		size_t GetPayloadBytes();
+
+	private:
+		ChunkPayloadPool() = default;
+
+		void Prune();
+
+		std::mutex m_mutex;
+		std::unordered_multimap<uint64_t, std::weak_ptr<const PalettedTileStorage>> m_payloads;
+		size_t m_pruneAt = 64;
+	};
+
+} // namespace WanderSpire
@@ -0,0 +1,116 @@
+﻿#pragma once
+#include "WanderSpire/World/TilemapListener.h"
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace WanderSpire {
+
+	/**
+	 * Connected-component labelling of walkable space, used to reject
+	 * unreachable path requests before any search runs.
+	 *
+	 * Every loaded chunk keeps a local 4-connected labelling of its tiles
+	 * (diagonal steps never cut corners, so 4-connectivity is exact for the
+	 * pathfinder's 8-way moves). Local components are stitched across chunk
+	 * borders with a union-find that is flattened after each rebuild, so a
+	 * query is two array reads. Unloaded space is walkable for the pathfinder
+	 * and is modelled as a single shared "void" component.
+	 *
+	 * Chunks are relabelled lazily: tile writes (via TilemapSystem listeners),
+	 * chunk load/unload and obstacle/TileComponent changes (via registry
+	 * signals) only mark state dirty. Obstacle changes are applied as per-entity
+	 * deltas. When a relabelled chunk actually changed its components, only
+	 * its borders are stitched again and only the components it was part of
+	 * are re-merged; the rest of the union-find is left alone.
+	 */
+	class ConnectivityMap {
+	public:
+		static ConnectivityMap& GetInstance();
+
+		/// True if a walkable route may exist between a and b on the given layer.
+		/// Never returns false for a pair the pathfinder could connect.
+		bool AreConnected(entt::registry& registry, entt::entity tilemapLayer,
+			const glm::ivec2& a, const glm::ivec2& b);
+
+		/// Component id of a tile (0 = unloaded void), or -1 if the tile is blocked.
+		int GetComponentId(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& pos);
+
+		/// Mark a chunk for relabelling on the next query
+		void MarkChunkDirty(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords);
+
+		/// Force a full obstacle rescan, relabel and union-find rebuild on the next query
+		void Invalidate(entt::registry& registry);
+
+		/// Drop all cached labelling (e.g. when a registry is torn down)
+		void Clear();
+
+	private:
+		ConnectivityMap();
+
+		using Edge = std::pair<uint32_t, uint32_t>;
+
+		struct ChunkLabels : ListenedChunk {
+			int chunkSize = 0;
+			uint32_t baseNode = 0;               ///< Global node of local label 1
+			uint32_t nodeCapacity = 0;           ///< Nodes reserved from baseNode
+			uint16_t componentCount = 0;
+			std::vector<uint16_t> labels;        ///< 0 = blocked, 1..n local component
+			std::vector<Edge> edges[4];          ///< Unions across each side (+x, -x, +y, -y)
+		};
+
+		struct LayerState : ListenedLayer<ChunkLabels> {
+			std::vector<uint32_t> parent;        ///< Flattened union-find, node 0 = void
+			uint32_t freeNodes = 0;              ///< Nodes of unloaded/moved chunks
+			std::unordered_set<uint32_t> staleRoots;             ///< Components to re-merge
+			std::unordered_map<uint64_t, uint8_t> staleSides;    ///< chunk key → sides to restitch
+			bool topologyDirty = true;           ///< Rebuild the whole union-find
+		};
+
+		/// An obstacle or TileComponent entity's effect on walkability
+		struct ObstacleSource {
+			bool blocks = false;                 ///< Blocking ObstacleComponent at obstacleTile
+			uint64_t obstacleTile = 0;
+			bool overrides = false;              ///< TileComponent at overrideTile
+			bool walkable = false;
+			uint64_t overrideTile = 0;
+		};
+
+		/// Sources affecting one tile
+		struct TileBlockers {
+			uint32_t obstacles = 0;
+			uint32_t walkableOverrides = 0;
+			uint32_t blockingOverrides = 0;
+		};
+
+		struct RegistryState : ListenedRegistry<LayerState> {
+			std::unordered_map<entt::entity, ObstacleSource> sources;
+			std::unordered_map<uint64_t, TileBlockers> blockers;   ///< tile key → sources there
+			std::unordered_set<uint64_t> blocked;        ///< Tiles blocked by obstacles/overrides
+			std::unordered_map<uint64_t, std::unordered_set<int>> blockedByChunk; ///< chunk key → local indices
+		};
+
+		void Refresh(entt::registry& registry, RegistryState& state, entt::entity layer, LayerState& layerState);
+		void SyncObstacles(entt::registry& registry, RegistryState& state);
+		void ApplyObstacleChanges(entt::registry& registry, RegistryState& state);
+		void UpdateSource(entt::registry& registry, RegistryState& state, entt::entity entity,
+			std::unordered_set<uint64_t>& touchedTiles);
+		void UpdateBlocked(RegistryState& state, const std::unordered_set<uint64_t>& touchedTiles);
+		void ReindexChunks(entt::registry& registry, entt::entity layer, LayerState& layerState);
+		bool LabelChunk(const RegistryState& state, uint64_t chunkKey, ChunkLabels& labels,
+			const int* tileIds, int tileCount, int chunkSize);
+		void DetachChunk(LayerState& layerState, uint64_t chunkKey, const ChunkLabels& chunk, uint32_t nodeCount);
+		void ComputeEdges(const LayerState& layerState, uint64_t chunkKey, ChunkLabels& chunk, int side) const;
+		void RebuildUnionFind(LayerState& layerState);
+		void MergeStale(LayerState& layerState);
+		int NodeAt(const RegistryState& state, const LayerState& layerState, const glm::ivec2& pos) const;
+
+		TilemapListener<RegistryState> m_listener;
+	};
+
+} // namespace WanderSpire
@@ -0,0 +1,112 @@
+#pragma once
+#include "WanderSpire/World/TilemapListener.h"
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace WanderSpire {
+
+	/**
+	 * Per-chunk movement-cost field (one byte per tile) for weighted search.
+	 *
+	 * Costs come from TileDefinition::movementCost (0 for non-walkable tiles),
+	 * per-tile overlays (roads painted over grass, hazard zones) and the same
+	 * TileComponent / ObstacleComponent rules as Pathfinder2D::IsTileWalkable.
+	 * Empty and unloaded tiles cost BASE_COST unless an overlay says otherwise.
+	 *
+	 * Like ConnectivityMap, only dirtied chunks are rebuilt. A definition
+	 * change dirties just the chunks that contain a tile id whose cost moved.
+	 */
+	class MovementCostField {
+		struct CostChunk;
+		struct LayerState;
+
+	public:
+		static constexpr uint8_t BLOCKED = 0;
+		static constexpr uint8_t BASE_COST = 10;
+
+		/// Locked, chunk-caching view of one layer for tight search loops.
+		/// Holds the field's lock; keep it no longer than one search.
+		class Reader {
+		public:
+			Reader(Reader&&) = default;
+
+			uint8_t operator()(const glm::ivec2& pos);
+
+			/// Cheapest cost anywhere on the layer (admissible heuristic scale)
+			uint8_t MinCost() const { return m_minCost; }
+
+		private:
+			friend class MovementCostField;
+			Reader(std::unique_lock<std::mutex> lock, const LayerState* layer, int chunkSize, uint8_t minCost)
+				: m_lock(std::move(lock)), m_layer(layer), m_chunkSize(chunkSize), m_minCost(minCost) {}
+
+			std::unique_lock<std::mutex> m_lock;
+			const LayerState* m_layer = nullptr;
+			int m_chunkSize = 32;
+			uint8_t m_minCost = BASE_COST;
+			glm::ivec2 m_cachedCoords{ INT32_MAX, INT32_MAX };
+			const CostChunk* m_cached = nullptr;
+		};
+
+		static MovementCostField& GetInstance();
+
+		/// Bring the layer up to date and return a reader over it
+		Reader Acquire(entt::registry& registry, entt::entity tilemapLayer);
+
+		/// Step cost of a single tile (0 = impassable)
+		uint8_t GetCost(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& pos);
+
+		/// Override the cost of a tile on every layer (0 blocks it)
+		void SetCostOverlay(entt::registry& registry, const glm::ivec2& pos, uint8_t cost);
+		void ClearCostOverlay(entt::registry& registry, const glm::ivec2& pos);
+		void ClearCostOverlays(entt::registry& registry);
+
+		/// Mark a chunk for rebuild on the next query
+		void MarkChunkDirty(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords);
+
+		/// Force a full rebuild on the next query
+		void Invalidate(entt::registry& registry);
+
+		/// Drop all cached costs
+		void Clear();
+
+	private:
+		MovementCostField();
+
+		struct CostChunk : ListenedChunk {
+			int chunkSize = 0;
+			uint8_t minCost = BASE_COST;
+			std::vector<uint8_t> costs;
+			std::vector<int> tileIds;           ///< Distinct ids, for definition-change dirtying
+		};
+
+		struct LayerState : ListenedLayer<CostChunk> {
+			uint8_t minCost = BASE_COST;
+		};
+
+		struct RegistryState : ListenedRegistry<LayerState> {
+			std::unordered_map<uint64_t, std::vector<int>> blockedByChunk;     ///< chunk key → local indices
+			std::unordered_map<uint64_t, std::vector<int>> walkableByChunk;    ///< TileComponent walkable overrides
+			std::unordered_map<uint64_t, uint8_t> overlays;                    ///< tile key → cost
+			std::unordered_map<uint64_t, std::vector<int>> overlaysByChunk;   ///< chunk key → local indices
+		};
+
+		LayerState& Prepare(entt::registry& registry, entt::entity tilemapLayer);
+		void SyncDefinitions();
+		void SyncObstacles(entt::registry& registry, RegistryState& state);
+		void ReindexChunks(entt::registry& registry, entt::entity layer, RegistryState& state, LayerState& layerState);
+		void RebuildChunk(entt::registry& registry, const RegistryState& state, uint64_t chunkKey, CostChunk& chunk);
+		void MarkOverlayDirty(RegistryState& state, const glm::ivec2& pos);
+		uint8_t DefinitionCost(int tileId);
+
+		TilemapListener<RegistryState> m_listener;
+		uint64_t m_definitionRevision = UINT64_MAX;
+		std::unordered_map<int, uint8_t> m_costByTile;   ///< Snapshot of definition costs seen so far
+	};
+
+} // namespace WanderSpire
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace WanderSpire {
+
+	/**
+	 * Palette-compressed tile array for one chunk.
+	 *
+	 * Each tile stores an index into a per-chunk palette of tile ids. Indices
+	 * are bit-packed at 0, 1, 2, 4, 8 or 16 bits, the narrowest width that fits
+	 * the palette. A uniform chunk therefore costs no index bits at all, and a
+	 * three-tile chunk costs 2 bits per tile. Every width divides 64, so an
+	 * index never straddles words and Get/Set are O(1). The width grows, with
+	 * one repack, only when the palette outgrows it. Palette entries are
+	 * reference counted and reused once nothing points at them.
+	 *
+	 * Per-tile data (TilemapChunkComponent::tileData) is kept sparsely: only
+	 * non-zero values are stored.
+	 */
+	class PalettedTileStorage {
+	public:
+		PalettedTileStorage() = default;
+
+		/// tileCount tiles, all fillTileId, no data
+		void Reset(int tileCount, int fillTileId = -1);
+
+		/// Build from flat arrays; tileData may be null (all zero)
+		void Encode(const int* tileIds, const uint32_t* tileData, int tileCount);
+
+		/// Decode every tile id / data value into flat arrays of TileCount() entries
+		void Decode(int* outTileIds) const;
+		void DecodeData(uint32_t* outTileData) const;
+
+		/// Decode `count` consecutive tiles starting at `first`
+		void DecodeRange(int first, int count, int* outTileIds) const;
+
+		int  Get(int index) const { return m_palette[IndexAt(index)]; }
+		void Set(int index, int tileId);
+
+		uint32_t GetData(int index) const;
+		void     SetData(int index, uint32_t value);
+
+		int TileCount() const { return m_tileCount; }
+		int BitsPerIndex() const { return m_bits; }
+		const std::vector<int>& Palette() const { return m_palette; }
+
+		/// Heap plus inline bytes held by this storage
+		size_t MemoryBytes() const;
+
+		/// Drop dead palette entries and repack at the narrowest width
+		void ShrinkToFit();
+
+	private:
+		static int BitsFor(size_t paletteSize);
+
+		uint32_t IndexAt(int i) const {
+			if (m_bits == 0) return 0;
+			const uint64_t word = m_words[static_cast<size_t>(i) >> m_perWordShift];
+			const int shift = (i & ((1 << m_perWordShift) - 1)) * m_bits;
+			return static_cast<uint32_t>((word >> shift) & m_mask);
+		}
+		void SetIndexAt(int i, uint32_t paletteIndex);
+
+		uint32_t FindOrAddPaletteEntry(int tileId);
+		void SetBits(int bits);
+		void Repack(int newBits);
+
+		static constexpr size_t LINEAR_LOOKUP_LIMIT = 16;
+
+		int m_tileCount = 0;
+		int m_bits = 0;
+		int m_perWordShift = 6;                  ///< log2(indices per word)
+		uint64_t m_mask = 0;
+		std::vector<int> m_palette;
+		std::vector<uint32_t> m_refCounts;
+		std::vector<uint32_t> m_freeEntries;     ///< Palette slots with a zero refcount
+		std::vector<uint64_t> m_words;
+		std::vector<std::pair<uint32_t, uint32_t>> m_data;   ///< (tile index, value), sorted, non-zero only
+		std::unordered_map<int, uint32_t> m_lookup;           ///< tileId → palette slot, large palettes only
+	};
+
+} // namespace WanderSpire
@@ -0,0 +1,140 @@
+#pragma once
+#include "WanderSpire/World/Pathfinder2D.h"
+
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace WanderSpire {
+
+	/// One queued path search, as submitted by a system or script.
+	struct PathRequest {
+		entt::entity entity = entt::null;         ///< Requesting agent (null = anonymous)
+		glm::ivec2   start{ 0, 0 };
+		glm::ivec2   target{ 0, 0 };
+		int          maxRange = 32;
+		entt::entity tilemapLayer = entt::null;   ///< null = first layer found
+		bool         weighted = false;            ///< FindWeightedPath instead of FindPath
+		int          priority = 0;                ///< Higher runs first
+		uint32_t     deadlineMicros = 0;          ///< Serve-by time from submission, 0 = none
+	};
+
+	/**
+	 * Frame-budgeted path request queue.
+	 *
+	 * Requests are served in priority order (ties by earliest deadline, then
+	 * submission order); a request whose deadline has passed jumps the queue.
+	 * Identical searches (same start, target, range, layer and mode) are
+	 * coalesced and run once. Update() runs searches in slices of
+	 * SLICE_EXPANSIONS node expansions until the per-frame microsecond budget
+	 * is spent — always at least one slice, so the queue drains — and
+	 * delivers each result as a PathAppliedEvent carrying its request id.
+	 * A search cut off by the budget resumes first on the next Update(), and
+	 * is abandoned once every request waiting on it is gone.
+	 *
+	 * Each registry may have its own budget; otherwise the global one applies.
+	 *
+	 * A new request for an entity supersedes its pending one; destroying the
+	 * entity drops its request at once, freeing its queue slot and budget.
+	 */
+	class PathRequestService {
+	public:
+		using RequestId = uint32_t;
+		static constexpr RequestId INVALID_REQUEST = 0;
+		static constexpr size_t SLICE_EXPANSIONS = 256;   ///< Nodes expanded between budget checks
+
+		static PathRequestService& GetInstance();
+
+		/// Queue a search; returns its id (also carried by the PathAppliedEvent)
+		RequestId Submit(entt::registry& registry, const PathRequest& request);
+
+		/// Drop a pending request; false if it already ran or never existed
+		bool Cancel(entt::registry& registry, RequestId id);
+
+		/// Drop every pending request made by an entity; returns how many
+		size_t CancelForEntity(entt::registry& registry, entt::entity entity);
+
+		/// Run queued searches within the frame budget and publish their results.
+		/// Returns the number of searches run.
+		size_t Update(entt::registry& registry);
+		size_t Update(entt::registry& registry, uint32_t budgetMicros);
+
+		/// Budget of registries without their own
+		void     SetFrameBudget(uint32_t micros);
+		uint32_t GetFrameBudget() const;
+
+		/// Budget used by Update(registry) for this registry only
+		void     SetFrameBudget(entt::registry& registry, uint32_t micros);
+		uint32_t GetFrameBudget(entt::registry& registry);
+
+		size_t GetPendingCount(entt::registry& registry);
+
+		/// Drop every queue (e.g. on scene unload)
+		void Clear();
+
+	private:
+		PathRequestService();
+
+		using Clock = std::chrono::steady_clock;
+
+		struct SearchKey {
+			glm::ivec2   start;
+			glm::ivec2   target;
+			int          maxRange;
+			entt::entity layer;
+			bool         weighted;
+
+			bool operator==(const SearchKey& o) const {
+				return start == o.start && target == o.target && maxRange == o.maxRange &&
+					layer == o.layer && weighted == o.weighted;
+			}
+		};
+
+		struct SearchKeyHash {
+			size_t operator()(const SearchKey& k) const noexcept;
+		};
+
+		struct Pending {
+			SearchKey         key;
+			entt::entity      entity;
+			int               priority;
+			Clock::time_point deadline;
+			uint64_t          sequence;
+		};
+
+		/// (-priority, deadline, sequence, id): begin() is the next request to serve
+		using OrderKey = std::tuple<int, Clock::time_point, uint64_t, RequestId>;
+
+		struct RegistryState {
+			std::unordered_map<RequestId, Pending> pending;
+			std::set<OrderKey> order;
+			std::set<std::pair<Clock::time_point, RequestId>> deadlines;
+			std::unordered_map<SearchKey, std::vector<RequestId>, SearchKeyHash> byKey;
+			std::unordered_map<entt::entity, RequestId> byEntity;
+
+			std::unique_ptr<PathSearch> search;   ///< Cut off by the budget; resumes first
+			SearchKey searchKey{};
+			uint32_t  budgetMicros = 0;
+			bool      ownBudget = false;          ///< budgetMicros overrides the global budget
+		};
+
+		RegistryState& StateFor(entt::registry& registry);
+		void Remove(RegistryState& state, RequestId id);
+		void OnEntityDestroyed(entt::registry& registry, entt::entity entity);
+
+		mutable std::mutex m_mutex;
+		std::unordered_map<const entt::registry*, RegistryState> m_registries;
+		RequestId m_nextId = 1;
+		uint64_t  m_nextSequence = 0;
+		uint32_t  m_budgetMicros = 2000;
+	};
+
+} // namespace WanderSpire
@@ -1,4 +1,10 @@
 ﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 #include <glm/glm.hpp>
 #include <entt/entt.hpp>
@@ -22,6 +28,18 @@ namespace WanderSpire {
 			entt::entity tilemapLayer = entt::null
 		);
 
+		/// Cost-aware A* over the MovementCostField: roads are cheaper than
+		/// swamps, and tiles whose definition is not walkable are avoided.
+		/// Same range, fallback and checkpoint behaviour as FindPath.
+		/// If tilemapLayer is entt::null, will auto-find the first available layer.
+		static PathResult FindWeightedPath(
+			const glm::ivec2& start,
+			const glm::ivec2& target,
+			int maxRange,
+			entt::registry& registry,
+			entt::entity tilemapLayer = entt::null
+		);
+
 		/// Check if movement is allowed between two adjacent tiles.
 		/// If tilemapLayer is entt::null, will auto-find the first available layer.
 		static bool CanMoveBetween(
@@ -39,11 +57,83 @@ namespace WanderSpire {
 			const glm::ivec2& pos
 		);
 
+		/// Check whether two tiles lie in the same walkable region (O(1) after
+		/// the connectivity labelling is up to date).
+		/// If tilemapLayer is entt::null, will auto-find the first available layer.
+		static bool AreConnected(
+			entt::registry& registry,
+			entt::entity tilemapLayer,
+			const glm::ivec2& a,
+			const glm::ivec2& b
+		);
+
 		/// Auto-discover the first available tilemap layer in the registry.
 		/// Returns entt::null if no tilemap layer is found.
 		static entt::entity FindFirstTilemapLayer(entt::registry& registry);
 	};
 
+	/**
+	 * One path search that can run in slices across frames.
+	 *
+	 * Step() expands at most maxExpansions nodes and returns true once
+	 * Result() is final; FindPath and FindWeightedPath run one to completion.
+	 * Each slice reads the tiles and costs as they are then, so edits made
+	 * between slices are seen by the rest of the search.
+	 */
+	class PathSearch {
+	public:
+		/// weighted: FindWeightedPath's cost-aware A* instead of FindPath's search
+		PathSearch(const glm::ivec2& start, const glm::ivec2& target, int maxRange,
+			entt::entity tilemapLayer, bool weighted);
+
+		/// Advance the search; true once it has finished
+		bool Step(entt::registry& registry, size_t maxExpansions);
+
+		bool   Done() const { return m_done; }
+		size_t Expansions() const { return m_expansions; }
+
+		/// The path, once Done()
+		const PathResult& Result() const { return m_result; }
+		PathResult TakeResult() { return std::move(m_result); }
+
+	private:
+		void Begin(entt::registry& registry);
+		void StepBreadthFirst(entt::registry& registry, size_t maxExpansions);
+		void StepWeighted(entt::registry& registry, size_t maxExpansions);
+		template<typename CanMove>
+		void Finish(CanMove&& canMove);
+
+		bool     WithinRange(const glm::ivec2& p) const;
+		uint32_t IndexOf(const glm::ivec2& p) const;
+		glm::ivec2 PosOf(uint32_t index) const;
+		uint32_t Heuristic(const glm::ivec2& p) const;
+
+		glm::ivec2   m_start;
+		glm::ivec2   m_target;
+		int          m_range;
+		entt::entity m_layer;
+		bool         m_weighted;
+
+		bool   m_started = false;
+		bool   m_searching = false;   ///< Worth searching (connected, in range); else straight to the fallback
+		bool   m_found = false;
+		bool   m_done = false;
+		size_t m_expansions = 0;
+		PathResult m_result;
+
+		// Breadth-first (FindPath)
+		std::deque<glm::ivec2> m_queue;
+		std::unordered_map<uint64_t, glm::ivec2> m_parent;
+		std::unordered_set<uint64_t> m_visited;
+
+		// A* over a dense window around start (FindWeightedPath)
+		int m_side = 0;
+		uint32_t m_minCost = 0;
+		std::vector<uint32_t> m_gScore;                        ///< UINT32_MAX = unseen
+		std::vector<uint8_t>  m_cameFrom;
+		std::vector<std::pair<uint32_t, uint32_t>> m_open;     ///< (f, index) min-heap
+	};
+
 	/// Legacy free function for compatibility
 	bool CanMoveBetween(
 		const glm::ivec2& from,
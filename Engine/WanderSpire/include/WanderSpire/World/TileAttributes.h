@@ -0,0 +1,106 @@
+#pragma once
+#include "WanderSpire/Components/TileAttributeComponent.h"
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace WanderSpire {
+
+	/// Aggregate of a channel over a rectangle
+	struct TileAttributeStats {
+		float  min = 0.0f;
+		float  max = 0.0f;
+		double sum = 0.0;
+		size_t count = 0;           ///< Tiles covered
+	};
+
+	enum class TileAttributeCompare : uint8_t {
+		Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual
+	};
+
+	/**
+	 * Named per-tile attribute channels (height, ownership, fertility, light,
+	 * "harvested" flags...) kept in a TileAttributeComponent on the layer.
+	 *
+	 * Each channel stores one structure-of-arrays block per chunk, in its own
+	 * type, allocated only once the chunk holds a non-default value. Blocks
+	 * live on the layer rather than on chunk entities, so streaming a chunk
+	 * out does not lose them. Region queries run over whole rows of those
+	 * arrays and count chunks without a block analytically, which lets tile
+	 * simulations sweep large areas without touching an entity.
+	 *
+	 * Channels are addressed by the id CreateChannel returns; ids stay valid
+	 * until the channel is removed. An id carries its slot's generation, so a
+	 * removed channel's id never addresses a later channel reusing the slot.
+	 */
+	class TileAttributes {
+	public:
+		static TileAttributes& GetInstance();
+
+		/// Add a channel to a layer, or return the existing one of the same
+		/// name and type; -1 if the name is taken by another type
+		int  CreateChannel(entt::registry& registry, entt::entity tilemapLayer, const std::string& name,
+			TileAttributeType type, float defaultValue = 0.0f);
+		int  FindChannel(entt::registry& registry, entt::entity tilemapLayer, const std::string& name) const;
+		bool RemoveChannel(entt::registry& registry, entt::entity tilemapLayer, int channel);
+
+		/// Channel type; false if the channel does not exist
+		bool GetChannelType(entt::registry& registry, entt::entity tilemapLayer, int channel, TileAttributeType& outType) const;
+
+		// Values cross the generic API as floats; U8/U16 round and clamp, flags are 0/1
+
+		float Get(entt::registry& registry, entt::entity tilemapLayer, int channel, const glm::ivec2& position) const;
+		void  Set(entt::registry& registry, entt::entity tilemapLayer, int channel, const glm::ivec2& position, float value);
+
+		/// Inclusive rectangles, row-major
+		void FillRect(entt::registry& registry, entt::entity tilemapLayer, int channel,
+			const glm::ivec2& min, const glm::ivec2& max, float value);
+		void ReadRect(entt::registry& registry, entt::entity tilemapLayer, int channel,
+			const glm::ivec2& min, const glm::ivec2& max, float* outValues) const;
+		void WriteRect(entt::registry& registry, entt::entity tilemapLayer, int channel,
+			const glm::ivec2& min, const glm::ivec2& max, const float* values);
+
+		/// Same in the channel's own element type (uint8_t, uint16_t, float;
+		/// flags one uint8_t per tile); returns false on an unknown channel
+		bool ReadRectRaw(entt::registry& registry, entt::entity tilemapLayer, int channel,
+			const glm::ivec2& min, const glm::ivec2& max, void* outValues) const;
+		bool WriteRectRaw(entt::registry& registry, entt::entity tilemapLayer, int channel,
+			const glm::ivec2& min, const glm::ivec2& max, const void* values);
+
+		/// A chunk's block for direct simulation loops: chunkSize² values in the
+		/// channel's type (flags: bit i of word i / 64). Null if the chunk has no
+		/// block and `allocate` is false.
+		void* GetChunkBlock(entt::registry& registry, entt::entity tilemapLayer, int channel,
+			const glm::ivec2& chunkCoords, bool allocate);
+
+		/// Min, max and sum over a rectangle
+		TileAttributeStats QueryRect(entt::registry& registry, entt::entity tilemapLayer, int channel,
+			const glm::ivec2& min, const glm::ivec2& max) const;
+
+		/// Tiles in a rectangle whose value compares true against `value`
+		size_t CountWhere(entt::registry& registry, entt::entity tilemapLayer, int channel,
+			const glm::ivec2& min, const glm::ivec2& max, TileAttributeCompare compare, float value) const;
+
+		/// Chunks with a block, and the bytes those blocks hold
+		size_t GetBlockCount(entt::registry& registry, entt::entity tilemapLayer, int channel) const;
+		size_t GetMemoryBytes(entt::registry& registry, entt::entity tilemapLayer) const;
+
+	private:
+		TileAttributes() = default;
+
+		static constexpr int SLOT_BITS = 16;
+		static constexpr uint16_t GENERATION_MASK = 0x7fff;   ///< Keeps ids positive
+
+		static int MakeChannelId(size_t slot, uint16_t generation) {
+			return static_cast<int>((static_cast<uint32_t>(generation & GENERATION_MASK) << SLOT_BITS) | static_cast<uint32_t>(slot));
+		}
+
+		const TileAttributeChannel* FindChannelData(entt::registry& registry, entt::entity tilemapLayer, int channel,
+			int* outChunkSize = nullptr) const;
+		TileAttributeChannel* FindChannelData(entt::registry& registry, entt::entity tilemapLayer, int channel,
+			int* outChunkSize = nullptr);
+	};
+
+} // namespace WanderSpire
@@ -3,6 +3,7 @@
 #include <string>
 #include <mutex>
 #include <shared_mutex>
+#include <cstdint>
 
 namespace WanderSpire {
 
@@ -18,6 +19,8 @@ namespace WanderSpire {
 			std::string frameName;      // e.g. "grass", "sand"
 			bool walkable = true;
 			int collisionType = 0;
+			bool blocksVision = false;  // Opaque for field-of-view / line-of-sight
+			uint8_t movementCost = 10;  // Weighted path step cost (10 = plain ground)
 		};
 
 		static TileDefinitionManager& GetInstance();
@@ -29,6 +32,19 @@ namespace WanderSpire {
 		/// Get tile definition for rendering
 		const TileDefinition* GetTileDefinition(int tileId) const;
 
+		/// Mark a registered tile as opaque (or transparent) for visibility queries
+		void SetTileBlocksVision(int tileId, bool blocksVision);
+
+		/// Set the weighted pathfinding cost of a registered tile (1..255, 10 = plain ground)
+		void SetTileMovementCost(int tileId, uint8_t movementCost);
+
+		/// Step cost for weighted search; 0 if the tile is not walkable
+		uint8_t GetMovementCost(int tileId) const;
+
+		/// Monotonic counter bumped on every definition change, so derived
+		/// per-tile caches can tell when to rebuild
+		uint64_t GetRevision() const;
+
 		/// Clear all definitions
 		void Clear();
 
@@ -47,6 +63,7 @@ namespace WanderSpire {
 		mutable std::shared_mutex m_mutex;
 		std::unordered_map<int, TileDefinition> m_definitions;
 		TileDefinition m_defaultDefinition{ "terrain", "grass", true, 0 };
+		uint64_t m_revision = 0;
 	};
 
 } // namespace WanderSpire
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace WanderSpire {
+
+	/// One journaled edit: tiles inside [min, max] (tile coords, inclusive) of one chunk changed.
+	struct TileChangeRecord {
+		uint64_t     sequence = 0;        ///< Journal-wide, strictly increasing
+		entt::entity layer = entt::null;
+		glm::ivec2   chunkCoords{ 0, 0 };
+		uint64_t     chunkVersion = 0;    ///< The chunk's version after this change
+		glm::ivec2   min{ 0, 0 };
+		glm::ivec2   max{ 0, 0 };
+		bool         removed = false;     ///< Chunk was unloaded; drop anything derived from it
+	};
+
+	/**
+	 * Bounded ring of tilemap changes that downstream caches pull from.
+	 *
+	 * TilemapSystem records every tile write here and stamps the chunk with
+	 * the returned version. Versions come from one counter per registry, so
+	 * they only ever grow, even across unload and reload. A consumer keeps a
+	 * cursor (or a subscription that holds one) and reads only the records
+	 * newer than it. If the ring wrapped past the cursor, the read reports an
+	 * overflow and the consumer rebuilds from scratch.
+	 *
+	 * Back-to-back edits of the same chunk merge into one record until a
+	 * reader has been handed it, so per-tile write loops do not flood the ring.
+	 */
+	class TilemapChangeJournal {
+	public:
+		using SubscriberId = uint32_t;
+		static constexpr SubscriberId INVALID_SUBSCRIBER = 0;
+		static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+		static TilemapChangeJournal& GetInstance();
+
+		/// Append a change; returns the chunk's new version
+		uint64_t Record(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords,
+			const glm::ivec2& min, const glm::ivec2& max, bool removed = false);
+
+		/// Sequence number the next record will receive
+		uint64_t GetHead(entt::registry& registry);
+
+		/// Append records with sequence >= cursor (at most maxRecords) and advance
+		/// the cursor past them. Returns false if records were lost to wrap-around.
+		bool ReadSince(entt::registry& registry, uint64_t& cursor,
+			std::vector<TileChangeRecord>& out, size_t maxRecords = SIZE_MAX);
+
+		/// Register a reader whose cursor starts at the current head
+		SubscriberId Subscribe(entt::registry& registry);
+		void Unsubscribe(entt::registry& registry, SubscriberId id);
+
+		/// ReadSince with the subscriber's own cursor; false on overflow or unknown id
+		bool Poll(entt::registry& registry, SubscriberId id,
+			std::vector<TileChangeRecord>& out, size_t maxRecords = SIZE_MAX);
+
+		/// Ring size in records (existing records beyond it are dropped oldest first)
+		void   SetCapacity(size_t records);
+		size_t GetCapacity() const;
+
+		/// Drop every journal (e.g. on scene unload)
+		void Clear();
+
+	private:
+		TilemapChangeJournal() = default;
+
+		struct RegistryState {
+			std::vector<TileChangeRecord> ring;   ///< Record s lives at ring[s % capacity]
+			uint64_t nextSequence = 1;
+			uint64_t count = 0;                   ///< Records currently retained
+			uint64_t nextVersion = 1;
+			uint64_t handedOut = 0;               ///< Newest sequence any reader has received
+			std::unordered_map<SubscriberId, uint64_t> cursors;
+			SubscriberId nextSubscriber = 1;
+		};
+
+		RegistryState& StateFor(entt::registry& registry);
+		bool Read(RegistryState& state, uint64_t& cursor, std::vector<TileChangeRecord>& out, size_t maxRecords);
+		void Resize(RegistryState& state);
+
+		mutable std::mutex m_mutex;
+		std::unordered_map<const entt::registry*, RegistryState> m_registries;
+		size_t m_capacity = DEFAULT_CAPACITY;
+	};
+
+} // namespace WanderSpire
@@ -0,0 +1,158 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace WanderSpire {
+
+	struct MappedChunkTiles;
+
+	/**
+	 * Binary container for the chunks of one tilemap layer (little endian).
+	 *
+	 *   Header       64 bytes, see below
+	 *   Payloads     per chunk: int32 tileIds[tileCount], then uint32 tileData[tileCount]
+	 *                unless every value is zero; each payload starts on an
+	 *                `alignment` boundary (a page by default)
+	 *   Directory    one ChunkEntry per chunk
+	 *
+	 * The directory comes last so chunks can be streamed out without knowing
+	 * how many follow. The header and directory carry CRC32s checked on open;
+	 * a payload's CRC32 is checked the first time its chunk is mapped, so
+	 * opening a map only touches the pages of the chunks actually used.
+	 */
+	namespace TilemapFileFormat {
+		constexpr char     MAGIC[8] = { 'W', 'S', 'T', 'I', 'L', 'E', 'S', '\0' };
+		constexpr uint32_t VERSION = 1;
+		constexpr uint32_t DEFAULT_ALIGNMENT = 4096;
+		constexpr uint32_t MIN_ALIGNMENT = 16;
+
+		/// ChunkEntry::flags
+		constexpr uint32_t CHUNK_HAS_DATA = 1u << 0;
+
+		struct Header {
+			char     magic[8];
+			uint32_t version;
+			uint32_t headerSize;
+			int32_t  chunkSize;
+			uint32_t alignment;
+			uint64_t chunkCount;
+			uint64_t directoryOffset;
+			uint32_t directoryCrc;
+			uint32_t flags;
+			uint8_t  reserved[12];
+			uint32_t headerCrc;         ///< Over every byte before this field
+		};
+		static_assert(sizeof(Header) == 64);
+
+		struct ChunkEntry {
+			int32_t  x;
+			int32_t  y;
+			uint64_t offset;            ///< From the start of the file
+			uint32_t tileCount;
+			uint32_t flags;
+			uint32_t crc;               ///< Over the whole payload
+			uint32_t reserved;
+		};
+		static_assert(sizeof(ChunkEntry) == 32);
+
+		/// CRC-32 (IEEE); pass a previous result as `crc` to continue it
+		uint32_t Crc32(const void* data, size_t size, uint32_t crc = 0);
+	}
+
+	/**
+	 * Writes a tilemap file one chunk at a time. Nothing is valid until
+	 * Finish() writes the directory and the header, so an interrupted save
+	 * leaves a file that Open() rejects rather than a truncated map.
+	 */
+	class TilemapFileWriter {
+	public:
+		TilemapFileWriter() = default;
+		~TilemapFileWriter();
+
+		TilemapFileWriter(const TilemapFileWriter&) = delete;
+		TilemapFileWriter& operator=(const TilemapFileWriter&) = delete;
+
+		/// `alignment` must be a power of two, at least MIN_ALIGNMENT
+		bool Open(const std::string& path, int chunkSize,
+			uint32_t alignment = TilemapFileFormat::DEFAULT_ALIGNMENT);
+
+		/// Append one chunk; tileData may be null (all zero)
+		bool WriteChunk(const glm::ivec2& chunkCoords, const int* tileIds, const uint32_t* tileData, int tileCount);
+
+		/// Write the directory and header and close the file
+		bool Finish();
+
+		bool   IsOpen() const { return m_file.is_open(); }
+		size_t GetChunkCount() const { return m_directory.size(); }
+
+	private:
+		bool Fail(const char* what);
+
+		std::ofstream m_file;
+		std::string m_path;
+		uint64_t m_offset = 0;
+		int32_t  m_chunkSize = 0;
+		uint32_t m_alignment = TilemapFileFormat::DEFAULT_ALIGNMENT;
+		std::vector<TilemapFileFormat::ChunkEntry> m_directory;
+		std::unordered_map<uint64_t, size_t> m_written;
+	};
+
+	/**
+	 * Read-only, memory-mapped view of a tilemap file.
+	 *
+	 * Open() maps the file and reads only the header and directory. MapChunk()
+	 * hands out MappedChunkTiles that point straight into the mapped pages; a
+	 * chunk holding one keeps the reader (and the mapping) alive, and copies
+	 * the tiles out on its first write.
+	 */
+	class TilemapFileReader : public std::enable_shared_from_this<TilemapFileReader> {
+	public:
+		/// Null (after logging why) if the file is missing, truncated or corrupt
+		static std::shared_ptr<TilemapFileReader> Open(const std::string& path);
+		~TilemapFileReader();
+
+		TilemapFileReader(const TilemapFileReader&) = delete;
+		TilemapFileReader& operator=(const TilemapFileReader&) = delete;
+
+		const std::string& GetPath() const { return m_path; }
+		size_t GetFileSize() const { return m_size; }
+		int    GetChunkSize() const { return m_chunkSize; }
+		size_t GetChunkCount() const { return m_directory.size(); }
+
+		bool HasChunk(const glm::ivec2& chunkCoords) const;
+		std::vector<glm::ivec2> GetChunkCoords() const;
+
+		/// Tiles of a chunk on the mapped pages; null if absent or its checksum fails
+		std::shared_ptr<const MappedChunkTiles> MapChunk(const glm::ivec2& chunkCoords);
+
+		/// Check every payload checksum (reads the whole file)
+		bool Verify();
+
+	private:
+		TilemapFileReader() = default;
+
+		bool Map(const std::string& path);
+		void Unmap();
+		bool ReadDirectory();
+		bool CheckChunk(size_t index);
+
+		enum class ChunkCheck : uint8_t { Unchecked, Valid, Corrupt };
+
+		std::string m_path;
+		const uint8_t* m_base = nullptr;
+		size_t m_size = 0;
+		void* m_fileHandle = nullptr;       ///< Windows file and mapping handles
+		void* m_mappingHandle = nullptr;
+
+		int32_t m_chunkSize = 0;
+		std::vector<TilemapFileFormat::ChunkEntry> m_directory;
+		std::unordered_map<uint64_t, size_t> m_index;
+		std::vector<ChunkCheck> m_checked;
+	};
+
+} // namespace WanderSpire
@@ -0,0 +1,262 @@
+#pragma once
+#include "WanderSpire/World/TilemapSystem.h"
+#include "WanderSpire/ECS/RegistryIdentity.h"
+#include "WanderSpire/Components/TilemapChunkComponent.h"
+#include "WanderSpire/Components/SceneNodeComponent.h"
+#include "WanderSpire/Components/ObstacleComponent.h"
+#include "WanderSpire/Components/GridPositionComponent.h"
+#include "WanderSpire/Components/TileComponent.h"
+
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace WanderSpire {
+
+	/// Chunk entry of a TilemapListener layer; a cache's per-chunk data derives from it
+	struct ListenedChunk {
+		entt::entity entity = entt::null;   ///< Tile chunk, or null if nothing loaded lives here
+		bool dirty = true;
+	};
+
+	/// Chunks of one tilemap layer, by packed chunk coordinates
+	template<typename Chunk>
+	struct ListenedLayer {
+		std::unordered_map<uint64_t, Chunk> chunks;
+		bool chunkSetDirty = true;
+	};
+
+	/// Per-registry state of a TilemapListener; a cache's state derives from it
+	template<typename Layer>
+	struct ListenedRegistry {
+		bool hooked = false;
+		bool obstaclesDirty = true;                          ///< Rescan every obstacle
+		std::unordered_set<entt::entity> changedObstacles;   ///< Obstacle deltas (listeners built with them)
+		std::unordered_map<entt::entity, Layer> layers;
+	};
+
+	/**
+	 * Per-registry bookkeeping shared by the lazily rebuilt chunk caches
+	 * (ConnectivityMap, VisibilityMap, MovementCostField).
+	 *
+	 * Keeps one State per registry and hooks the registry's obstacle and
+	 * chunk signals the first time the state is used. Tile writes (via
+	 * TilemapSystem listeners), chunk load/unload and obstacle changes only
+	 * set dirty flags: State::obstaclesDirty, Layer::chunkSetDirty and
+	 * Chunk::dirty. A listener built with obstacle deltas instead collects
+	 * the changed entities in State::changedObstacles, leaving obstaclesDirty
+	 * to hooking and Invalidate(). The owner rebuilds what is dirty on its
+	 * next query, holding Mutex().
+	 */
+	template<typename State>
+	class TilemapListener {
+	public:
+		using Layer = typename decltype(State::layers)::mapped_type;
+
+		/// With trackTileOverrides, TileComponent changes dirty obstacles too;
+		/// with obstacleDeltas, changes are recorded per entity
+		explicit TilemapListener(bool trackTileOverrides, bool obstacleDeltas = false);
+
+		TilemapListener(const TilemapListener&) = delete;
+		TilemapListener& operator=(const TilemapListener&) = delete;
+
+		std::mutex& Mutex() { return m_mutex; }
+
+		/// State of a registry, hooking it first; the caller holds Mutex()
+		State& StateFor(entt::registry& registry);
+
+		/// Every hooked registry's state; the caller holds Mutex()
+		std::unordered_map<const entt::registry*, State>& States() { return m_registries; }
+
+		/// Mark a chunk for rebuild on the next query
+		void MarkChunkDirty(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords);
+
+		/// Force an obstacle rescan and a full rebuild on the next query
+		void Invalidate(entt::registry& registry);
+
+		/// Unhook every registry and drop all state
+		void Clear();
+
+		/// Point the layer's entries at its loaded chunks, dirtying those whose
+		/// chunk entity changed, and return their keys
+		static std::unordered_set<uint64_t> IndexLoadedChunks(entt::registry& registry, entt::entity layer, Layer& layerState);
+
+	private:
+		static uint64_t PackCoords(const glm::ivec2& p) {
+			return (uint64_t(uint32_t(p.x)) << 32) | uint32_t(p.y);
+		}
+
+		void Hook(entt::registry& registry, State& state);
+		void Unhook(entt::registry& registry);
+		void OnObstacleChanged(entt::registry& registry, entt::entity entity);
+		void OnChunkSetChanged(entt::registry& registry, entt::entity entity);
+
+		const bool m_trackTileOverrides;
+		const bool m_obstacleDeltas;
+		std::mutex m_mutex;
+		std::unordered_map<const entt::registry*, State> m_registries;
+	};
+
+	template<typename State>
+	TilemapListener<State>::TilemapListener(bool trackTileOverrides, bool obstacleDeltas)
+		: m_trackTileOverrides(trackTileOverrides)
+		, m_obstacleDeltas(obstacleDeltas)
+	{
+		TilemapSystem::GetInstance().AddChunkChangedListener(
+			[this](entt::registry& registry, entt::entity layer, const glm::ivec2& chunkCoords) {
+				MarkChunkDirty(registry, layer, chunkCoords);
+			});
+	}
+
+	template<typename State>
+	State& TilemapListener<State>::StateFor(entt::registry& registry) {
+		auto& state = m_registries[&registry];
+		if (state.hooked && !IsRegistryMarked<TilemapListener>(registry)) {
+			state = State{};
+		}
+		if (!state.hooked) Hook(registry, state);
+		return state;
+	}
+
+	template<typename State>
+	void TilemapListener<State>::MarkChunkDirty(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords) {
+		std::lock_guard lock(m_mutex);
+		auto regIt = m_registries.find(&registry);
+		if (regIt == m_registries.end()) return;
+
+		auto layerIt = regIt->second.layers.find(tilemapLayer);
+		if (layerIt == regIt->second.layers.end()) return;
+
+		// An entry without a chunk entity must be reindexed to pick one up
+		auto chunkIt = layerIt->second.chunks.find(PackCoords(chunkCoords));
+		if (chunkIt != layerIt->second.chunks.end() && chunkIt->second.entity != entt::null) {
+			chunkIt->second.dirty = true;
+		}
+		else {
+			layerIt->second.chunkSetDirty = true;
+		}
+	}
+
+	template<typename State>
+	void TilemapListener<State>::Invalidate(entt::registry& registry) {
+		std::lock_guard lock(m_mutex);
+		auto it = m_registries.find(&registry);
+		if (it == m_registries.end()) return;
+
+		it->second.obstaclesDirty = true;
+		for (auto& [layer, layerState] : it->second.layers) {
+			layerState.chunkSetDirty = true;
+			for (auto& [key, chunk] : layerState.chunks) chunk.dirty = true;
+		}
+	}
+
+	template<typename State>
+	void TilemapListener<State>::Clear() {
+		std::lock_guard lock(m_mutex);
+		for (auto& [reg, state] : m_registries) {
+			if (state.hooked) Unhook(*const_cast<entt::registry*>(reg));
+		}
+		m_registries.clear();
+	}
+
+	template<typename State>
+	std::unordered_set<uint64_t> TilemapListener<State>::IndexLoadedChunks(entt::registry& registry,
+		entt::entity layer, Layer& layerState)
+	{
+		std::unordered_set<uint64_t> present;
+
+		auto* layerNode = (layer != entt::null && registry.valid(layer))
+			? registry.try_get<SceneNodeComponent>(layer) : nullptr;
+		if (!layerNode) return present;
+
+		for (entt::entity child : layerNode->children) {
+			auto* comp = registry.try_get<TilemapChunkComponent>(child);
+			if (!comp) continue;
+
+			const uint64_t key = PackCoords(comp->chunkCoords);
+			present.insert(key);
+
+			auto& entry = layerState.chunks[key];
+			if (entry.entity != child) {
+				entry.entity = child;
+				entry.dirty = true;
+			}
+		}
+		return present;
+	}
+
+	template<typename State>
+	void TilemapListener<State>::Hook(entt::registry& registry, State& state) {
+		// Obstacles and per-tile overrides may move through reflection
+		// (emplace_or_replace), so listen to every mutation signal.
+		registry.on_construct<ObstacleComponent>().connect<&TilemapListener::OnObstacleChanged>(*this);
+		registry.on_update<ObstacleComponent>().connect<&TilemapListener::OnObstacleChanged>(*this);
+		registry.on_destroy<ObstacleComponent>().connect<&TilemapListener::OnObstacleChanged>(*this);
+		registry.on_construct<GridPositionComponent>().connect<&TilemapListener::OnObstacleChanged>(*this);
+		registry.on_update<GridPositionComponent>().connect<&TilemapListener::OnObstacleChanged>(*this);
+		registry.on_destroy<GridPositionComponent>().connect<&TilemapListener::OnObstacleChanged>(*this);
+		if (m_trackTileOverrides) {
+			registry.on_construct<TileComponent>().connect<&TilemapListener::OnObstacleChanged>(*this);
+			registry.on_update<TileComponent>().connect<&TilemapListener::OnObstacleChanged>(*this);
+			registry.on_destroy<TileComponent>().connect<&TilemapListener::OnObstacleChanged>(*this);
+		}
+
+		registry.on_construct<TilemapChunkComponent>().connect<&TilemapListener::OnChunkSetChanged>(*this);
+		registry.on_update<TilemapChunkComponent>().connect<&TilemapListener::OnChunkSetChanged>(*this);
+		registry.on_destroy<TilemapChunkComponent>().connect<&TilemapListener::OnChunkSetChanged>(*this);
+
+		MarkRegistry<TilemapListener>(registry);
+
+		state.hooked = true;
+		state.obstaclesDirty = true;
+	}
+
+	template<typename State>
+	void TilemapListener<State>::Unhook(entt::registry& registry) {
+		registry.on_construct<ObstacleComponent>().disconnect<&TilemapListener::OnObstacleChanged>(*this);
+		registry.on_update<ObstacleComponent>().disconnect<&TilemapListener::OnObstacleChanged>(*this);
+		registry.on_destroy<ObstacleComponent>().disconnect<&TilemapListener::OnObstacleChanged>(*this);
+		registry.on_construct<GridPositionComponent>().disconnect<&TilemapListener::OnObstacleChanged>(*this);
+		registry.on_update<GridPositionComponent>().disconnect<&TilemapListener::OnObstacleChanged>(*this);
+		registry.on_destroy<GridPositionComponent>().disconnect<&TilemapListener::OnObstacleChanged>(*this);
+		registry.on_construct<TileComponent>().disconnect<&TilemapListener::OnObstacleChanged>(*this);
+		registry.on_update<TileComponent>().disconnect<&TilemapListener::OnObstacleChanged>(*this);
+		registry.on_destroy<TileComponent>().disconnect<&TilemapListener::OnObstacleChanged>(*this);
+		registry.on_construct<TilemapChunkComponent>().disconnect<&TilemapListener::OnChunkSetChanged>(*this);
+		registry.on_update<TilemapChunkComponent>().disconnect<&TilemapListener::OnChunkSetChanged>(*this);
+		registry.on_destroy<TilemapChunkComponent>().disconnect<&TilemapListener::OnChunkSetChanged>(*this);
+	}
+
+	template<typename State>
+	void TilemapListener<State>::OnObstacleChanged(entt::registry& registry, entt::entity entity) {
+		// Plain GridPositionComponent moves (characters) never matter
+		const bool relevant = registry.any_of<ObstacleComponent>(entity)
+			|| (m_trackTileOverrides && registry.any_of<TileComponent>(entity));
+		if (!relevant) return;
+
+		std::lock_guard lock(m_mutex);
+		auto it = m_registries.find(&registry);
+		if (it == m_registries.end()) return;
+		if (m_obstacleDeltas) it->second.changedObstacles.insert(entity);
+		else it->second.obstaclesDirty = true;
+	}
+
+	template<typename State>
+	void TilemapListener<State>::OnChunkSetChanged(entt::registry& registry, entt::entity entity) {
+		std::lock_guard lock(m_mutex);
+		auto it = m_registries.find(&registry);
+		if (it == m_registries.end()) return;
+
+		for (auto& [layer, layerState] : it->second.layers) {
+			layerState.chunkSetDirty = true;
+			// A replaced component keeps its entity but not its tiles
+			for (auto& [key, chunk] : layerState.chunks) {
+				if (chunk.entity == entity) chunk.dirty = true;
+			}
+		}
+	}
+
+} // namespace WanderSpire
@@ -3,7 +3,10 @@
 #include <glm/glm.hpp>
 #include <entt/entt.hpp>
 #include <vector>
+#include <cstdint>
 #include <unordered_set>
+#include <unordered_map>
+#include <functional>
 
 namespace WanderSpire {
 
@@ -42,21 +45,71 @@ namespace WanderSpire {
 		// CHUNK MANAGEMENT (replaces ChunkManager functionality)
 		// ═════════════════════════════════════════════════════════════════════
 
-		/// Load/create a chunk at the given chunk coordinates
+		/// Load a chunk. On a layer with a generator (see ChunkGenerationService)
+		/// a chunk not held by the eviction cache is queued for generation instead
+		/// and appears once the generated tiles are installed.
 		void LoadChunk(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords);
 
+		/// Create a chunk from finished arrays in one step (generator output).
+		/// The chunk starts compact, on the interned payload for its tiles.
+		/// Returns false, leaving the tilemap untouched, if the chunk already exists.
+		bool InstallChunk(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords,
+			std::vector<int>&& tileIds, std::vector<uint32_t>&& tileData);
+
 		/// Unload a chunk at the given chunk coordinates
 		void UnloadChunk(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords);
 
 		/// Check if a chunk is loaded
 		bool IsChunkLoaded(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords);
 
+		/// Version of a chunk's latest journaled change (0 = not loaded or never edited)
+		uint64_t GetChunkVersion(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords) const;
+
 		/// Ensure all chunks overlapping the given world bounds are loaded
 		void EnsureChunksLoaded(entt::registry& registry, const glm::vec2& minWorldBound, const glm::vec2& maxWorldBound);
 
-		/// Update tilemap streaming based on camera position
+		/// Update tilemap streaming based on camera position. With idle compaction
+		/// on, chunks unchanged since the previous pass are also compacted.
 		void UpdateTilemapStreaming(entt::registry& registry, const glm::vec2& viewCenter, float viewRadius);
 
+		/// Switch a chunk to palette-packed storage (see PalettedTileStorage).
+		/// Identical chunks share one interned payload (ChunkPayloadPool) and
+		/// split it on their first write; installed chunks, ones restored from the
+		/// eviction cache and scene chunks with a shared payload start out that way. Reads and single-tile writes stay
+		/// O(1); bulk edits expand the chunk again.
+		bool CompactChunk(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords);
+
+		/// Restore a compact chunk's flat arrays
+		bool ExpandChunk(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords);
+
+		/// Compact every chunk of a layer; returns how many were compacted
+		size_t CompactLayer(entt::registry& registry, entt::entity tilemapLayer);
+
+		/// Bytes held by a layer's chunk tile storage (shared payloads counted once,
+		/// chunks still on a mapped tilemap file not at all)
+		size_t GetLayerTileMemory(entt::registry& registry, entt::entity tilemapLayer) const;
+
+		// ═════════════════════════════════════════════════════════════════════
+		// TILEMAP FILES (see TilemapFile.h)
+		// ═════════════════════════════════════════════════════════════════════
+
+		/// Stream every chunk of a layer into a binary tilemap file: the loaded
+		/// ones, then those held unloaded by the eviction cache or the layer's
+		/// attached file. False (the target untouched) if one of them can't be read.
+		bool SaveLayerFile(entt::registry& registry, entt::entity tilemapLayer, const std::string& path);
+
+		/// Back a layer with a memory-mapped tilemap file. Chunks in the file
+		/// are created from its pages when first loaded or written to, and
+		/// read in place until their first write; the file takes precedence
+		/// over the layer's generator. Replaces any file already attached.
+		bool OpenLayerFile(entt::registry& registry, entt::entity tilemapLayer, const std::string& path);
+
+		/// Detach a layer's file; chunks already created from it stay valid
+		void CloseLayerFile(entt::registry& registry, entt::entity tilemapLayer);
+
+		/// Whether a layer has a tilemap file attached
+		bool HasLayerFile(entt::registry& registry, entt::entity tilemapLayer) const;
+
 		// ═════════════════════════════════════════════════════════════════════
 		// CONFIGURATION
 		// ═════════════════════════════════════════════════════════════════════
@@ -73,16 +126,101 @@ namespace WanderSpire {
 		/// Get the current streaming radius
 		float GetStreamingRadius() const;
 
+		/// Compact chunks that went a whole streaming pass without edits (off by default)
+		void SetIdleChunkCompaction(bool enabled);
+		bool GetIdleChunkCompaction() const;
+
 		// ═════════════════════════════════════════════════════════════════════
 		// BULK OPERATIONS
 		// ═════════════════════════════════════════════════════════════════════
 
-		/// Flood fill starting from the given position
-		void FloodFill(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& startPos, int newTileId);
+		/// Tiles covered by a flood fill as one bitset per chunk (bit = local y * chunkSize + x)
+		struct FloodFillMask {
+			struct Chunk {
+				glm::ivec2 chunkCoords{ 0, 0 };
+				std::vector<uint64_t> bits;
+			};
+			std::vector<Chunk> chunks;
+			int chunkSize = 0;
+			size_t tileCount = 0;
+		};
+
+		struct FloodFillOptions {
+			/// Inclusive tile bounds; when unset the fill is clamped to the
+			/// layer's loaded chunks (plus the start chunk), since unloaded
+			/// ground reads as -1 forever
+			bool useBounds = false;
+			glm::ivec2 boundsMin{ 0, 0 };
+			glm::ivec2 boundsMax{ 0, 0 };
+
+			/// Abort without writing if the region exceeds this many tiles
+			size_t maxTiles = size_t(1) << 24;
+
+			bool apply = true;          ///< Write newTileId (false = measure only)
+			bool collectMask = false;   ///< Return the region as per-chunk bitmasks
+		};
+
+		struct FloodFillResult {
+			size_t tilesFilled = 0;
+			int originalTileId = -1;
+			bool aborted = false;       ///< maxTiles was exceeded; nothing was written
+			FloodFillMask mask;         ///< Only filled when collectMask is set
+		};
+
+		/// Flood fill starting from the given position; returns tiles changed
+		size_t FloodFill(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& startPos, int newTileId);
+
+		/// Scanline flood fill over raw chunk arrays (4-connected)
+		FloodFillResult FloodFill(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& startPos,
+			int newTileId, const FloodFillOptions& options);
+
+		/// Write one tile id into every tile of a mask; returns tiles changed
+		size_t ApplyMask(entt::registry& registry, entt::entity tilemapLayer, const FloodFillMask& mask, int tileId);
 
 		/// Fill a rectangular area with the given tile
 		void FloodFillArea(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& min, const glm::ivec2& max, int tileId);
 
+		/// Horizontal run of identical tiles starting at `start`
+		struct TileSpan {
+			glm::ivec2 start{ 0, 0 };
+			int length = 0;
+			int tileId = -1;
+		};
+
+		// Bulk edits resolve each chunk once, write whole rows, keep instance
+		// counts incrementally and mark/notify each changed chunk exactly once.
+		// Rectangles are inclusive [min, max].
+
+		/// Set arbitrary tiles (positions[i] ← tileIds[i]); returns tiles changed
+		size_t SetTiles(entt::registry& registry, entt::entity tilemapLayer,
+			const glm::ivec2* positions, const int* tileIds, size_t count);
+
+		/// Set a list of horizontal spans; returns tiles changed
+		size_t SetTiles(entt::registry& registry, entt::entity tilemapLayer,
+			const TileSpan* spans, size_t count);
+
+		/// Write a row-major block of (max - min + 1) tiles; returns tiles changed
+		size_t SetTilesRect(entt::registry& registry, entt::entity tilemapLayer,
+			const glm::ivec2& min, const glm::ivec2& max, const int* tileIds);
+
+		/// Fill a rectangle with one tile; returns tiles changed
+		size_t FillRect(entt::registry& registry, entt::entity tilemapLayer,
+			const glm::ivec2& min, const glm::ivec2& max, int tileId);
+
+		/// Read a rectangle row-major into outTileIds (-1 where unloaded)
+		void ReadRect(entt::registry& registry, entt::entity tilemapLayer,
+			const glm::ivec2& min, const glm::ivec2& max, int* outTileIds);
+
+		/// Copy a rectangle between (or within) layers; skipEmpty keeps the
+		/// destination where the source is -1. Returns tiles changed.
+		size_t CopyRect(entt::registry& registry, entt::entity srcLayer,
+			const glm::ivec2& srcMin, const glm::ivec2& srcMax,
+			entt::entity dstLayer, const glm::ivec2& dstMin, bool skipEmpty = false);
+
+		/// Replace every fromTileId in a rectangle with toTileId; returns tiles changed
+		size_t ReplaceInRect(entt::registry& registry, entt::entity tilemapLayer,
+			const glm::ivec2& min, const glm::ivec2& max, int fromTileId, int toTileId);
+
 		// ═════════════════════════════════════════════════════════════════════
 		// COORDINATE CONVERSION
 		// ═════════════════════════════════════════════════════════════════════
@@ -117,13 +255,77 @@ namespace WanderSpire {
 		/// Find the first tilemap layer with collision enabled
 		entt::entity FindCollisionLayer(entt::registry& registry, entt::entity tilemap) const;
 
+		// Region queries read the per-chunk summaries (occupancy, bounds, id
+		// histogram) to skip chunks that cannot match and clip the rest.
+
+		/// Matches every non-empty tile in CountTilesInRect
+		static constexpr int ANY_TILE = INT32_MIN;
+
+		/// Exact bounds of the layer's non-empty tiles; false if it has none
+		bool GetLayerBounds(entt::registry& registry, entt::entity tilemapLayer, glm::ivec2& outMin, glm::ivec2& outMax);
+
+		/// Count tiles equal to tileId (ANY_TILE = non-empty, -1 = empty) in an inclusive rectangle
+		size_t CountTilesInRect(entt::registry& registry, entt::entity tilemapLayer,
+			const glm::ivec2& min, const glm::ivec2& max, int tileId = ANY_TILE);
+
+		/// Write up to maxPositions positions holding tileId; returns how many were found
+		size_t FindTilePositions(entt::registry& registry, entt::entity tilemapLayer, int tileId,
+			glm::ivec2* outPositions, size_t maxPositions);
+
+		// ═════════════════════════════════════════════════════════════════════
+		// CHANGE NOTIFICATION
+		// ═════════════════════════════════════════════════════════════════════
+
+		/// Invoked after a chunk's tiles change or the chunk is loaded/unloaded
+		using ChunkChangedCallback = std::function<void(entt::registry&, entt::entity tilemapLayer, const glm::ivec2& chunkCoords)>;
+
+		/// Register a chunk change listener; returns an id for RemoveChunkChangedListener
+		size_t AddChunkChangedListener(ChunkChangedCallback callback);
+
+		/// Unregister a chunk change listener
+		void RemoveChunkChangedListener(size_t listenerId);
+
 	private:
 		int chunkSize = 32;
 		float streamingRadius = 1000.0f;
+		bool idleChunkCompaction = false;
+
+		std::vector<std::pair<size_t, ChunkChangedCallback>> chunkChangedListeners;
+		size_t nextListenerId = 1;
+
+		/// Notify listeners that a chunk changed
+		void NotifyChunkChanged(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords);
 
 		/// Get or create a chunk at the given chunk coordinates
 		entt::entity GetOrCreateChunk(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords);
 
+		/// Chunk entity at the given coordinates, or entt::null if not loaded
+		entt::entity FindChunk(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords) const;
+
+		/// Chunk coordinates → chunk entity for one layer
+		using ChunkIndex = std::unordered_map<uint64_t, entt::entity>;
+
+		/// The layer's chunk index, kept in the registry context and rebuilt
+		/// when the layer's children no longer match it
+		ChunkIndex& GetChunkIndex(entt::registry& registry, entt::entity tilemapLayer) const;
+
+		/// Record a chunk attached to (or, with entt::null, detached from) the layer
+		void UpdateChunkIndex(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords, entt::entity chunk) const;
+
+		/// Chunk changed by a bulk edit, with the local rectangle it touched
+		struct TouchedChunk {
+			entt::entity entity = entt::null;
+			glm::ivec2 min{ 0, 0 };
+			glm::ivec2 max{ 0, 0 };
+		};
+		using TouchSet = std::unordered_map<uint64_t, TouchedChunk>;
+
+		/// Add a local rectangle to a chunk's touched area
+		void Touch(TouchSet& touched, uint64_t key, entt::entity chunk, const glm::ivec2& localMin, const glm::ivec2& localMax) const;
+
+		/// Journal, mark dirty and notify each chunk of a bulk edit once
+		void FinishBulkEdit(entt::registry& registry, entt::entity tilemapLayer, const TouchSet& touched);
+
 		/// Optimize a chunk's rendering data
 		void OptimizeChunk(entt::registry& registry, entt::entity chunk);
 
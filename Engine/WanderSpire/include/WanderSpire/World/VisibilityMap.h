@@ -0,0 +1,117 @@
+﻿#pragma once
+#include "WanderSpire/World/TilemapListener.h"
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace WanderSpire {
+
+	/**
+	 * Square visibility bitmap centred on an observer, (2r+1)² bits row-major
+	 * from origin - (r, r). Reused between FOV calls to avoid reallocations.
+	 */
+	struct VisibilityBitmap {
+		glm::ivec2 origin{ 0, 0 };
+		int radius = 0;
+		std::vector<uint64_t> bits;
+
+		int Side() const { return radius * 2 + 1; }
+
+		/// Clear for a new observer, keeping the allocation
+		void Reset(const glm::ivec2& newOrigin, int newRadius);
+
+		void Set(const glm::ivec2& tile);
+		bool Test(const glm::ivec2& tile) const;
+
+		/// Number of visible tiles
+		size_t Count() const;
+
+		/// Copy into a byte-packed mask (bit i → byte i/8, bit i%8)
+		void CopyTo(uint8_t* outMask, size_t maskBytes) const;
+	};
+
+	/**
+	 * Native field-of-view and line-of-sight kernel.
+	 *
+	 * Keeps a per-chunk opacity bitgrid built from tile definitions
+	 * (TileDefinition::blocksVision) and ObstacleComponent::blocksVision.
+	 * Like ConnectivityMap, chunks are rebuilt lazily when tiles, obstacles
+	 * or tile definitions change; queries are pure bit reads.
+	 */
+	class VisibilityMap {
+	public:
+		static VisibilityMap& GetInstance();
+
+		/// Whether a tile blocks sight on the given layer
+		bool IsOpaque(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& pos);
+
+		/// Recursive shadowcasting FOV within a circular radius
+		void ComputeFOV(entt::registry& registry, entt::entity tilemapLayer,
+			const glm::ivec2& origin, int radius, VisibilityBitmap& out);
+
+		/// FOV for many observers sharing one radius; out is resized to count
+		void ComputeFOVBatch(entt::registry& registry, entt::entity tilemapLayer,
+			const glm::ivec2* origins, size_t count, int radius, std::vector<VisibilityBitmap>& out);
+
+		/// Grid DDA line of sight between tile centres (endpoints never block)
+		bool HasLineOfSight(entt::registry& registry, entt::entity tilemapLayer,
+			const glm::ivec2& from, const glm::ivec2& to);
+
+		/// Line of sight for many pairs; pairs farther than maxDistance (> 0) fail.
+		/// Returns the number of visible pairs.
+		size_t HasLineOfSightBatch(entt::registry& registry, entt::entity tilemapLayer,
+			const glm::ivec2* from, const glm::ivec2* to, size_t count,
+			float maxDistance, uint8_t* outVisible);
+
+		/// Mark a chunk for rebuild on the next query
+		void MarkChunkDirty(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords);
+
+		/// Force a full rebuild on the next query
+		void Invalidate(entt::registry& registry);
+
+		/// Drop all cached opacity
+		void Clear();
+
+	private:
+		VisibilityMap();
+
+		struct OpacityChunk : ListenedChunk {
+			int chunkSize = 0;
+			std::vector<uint64_t> bits;
+		};
+
+		using LayerState = ListenedLayer<OpacityChunk>;
+
+		struct RegistryState : ListenedRegistry<LayerState> {
+			uint64_t definitionRevision = UINT64_MAX;
+			std::unordered_map<uint64_t, std::vector<int>> opaqueByChunk; ///< chunk key → local indices
+		};
+
+		/// Cached chunk pointer for tight per-tile loops
+		struct OpacityReader {
+			const LayerState* layer = nullptr;
+			int chunkSize = 32;
+			glm::ivec2 cachedCoords{ INT32_MAX, INT32_MAX };
+			const OpacityChunk* cached = nullptr;
+
+			bool operator()(const glm::ivec2& pos);
+		};
+
+		LayerState& Prepare(entt::registry& registry, entt::entity tilemapLayer);
+		void SyncObstacles(entt::registry& registry, RegistryState& state);
+		void ReindexChunks(entt::registry& registry, entt::entity layer, RegistryState& state, LayerState& layerState);
+		void RebuildChunk(entt::registry& registry, const RegistryState& state, uint64_t chunkKey, OpacityChunk& chunk);
+
+		static void CastLight(OpacityReader& opaque, VisibilityBitmap& out, int row, float start, float end,
+			int radius, int xx, int xy, int yx, int yy);
+		static bool TraceLine(OpacityReader& opaque, const glm::ivec2& from, const glm::ivec2& to);
+
+		TilemapListener<RegistryState> m_listener;
+	};
+
+} // namespace WanderSpire
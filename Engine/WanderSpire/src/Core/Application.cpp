@@ -14,6 +14,13 @@
 #include "WanderSpire/Graphics/RenderResourceManager.h"
 #include "WanderSpire/Graphics/SpriteRenderer.h"
 #include "WanderSpire/Graphics/RenderManager.h"
+#include "WanderSpire/Graphics/StreamBuffer.h"
+#include "WanderSpire/Graphics/GLStateCache.h"
+#include "WanderSpire/Graphics/FrameUniforms.h"
+#include "WanderSpire/Graphics/RenderThread.h"
+#include "WanderSpire/Graphics/DebugDraw.h"
+#include "WanderSpire/Graphics/TileLookupRenderer.h"
+#include "WanderSpire/Graphics/GLDevice.h"
 #include "WanderSpire/Graphics/OpenGLDebug.h"
 
 #include "WanderSpire/Editor/EditorSystems.h"
@@ -21,6 +28,7 @@
 #include "WanderSpire/World/TilemapSystem.h"
 #include "WanderSpire/Systems/RenderSystem.h"
 #include "WanderSpire/Systems/TickSystem.h"
+#include "WanderSpire/Systems/AnimatedTileSystem.h"
 
 #include "WanderSpire/Input/InputManager.h"
 
@@ -160,6 +168,11 @@ namespace WanderSpire {
 		state->ctx.prefabs.LoadPrefabsFromFolder(
 			std::filesystem::path(state->ctx.settings.assetsRoot) / "prefabs");
 
+		// Initialization is done with GL; from here on frames may draw on their own thread
+		if (!g_editorMode && state->ctx.settings.renderThread) {
+			RenderThread::Get().Start();
+		}
+
 		spdlog::info("[AppInit] Reflection: {} types registered",
 			Reflect::TypeRegistry::Get().GetNameMap().size());
 		spdlog::info("=== Application initialized (editor mode: {}) ===", g_editorMode);
@@ -199,6 +212,10 @@ namespace WanderSpire {
 
 		static size_t frame = 0; ++frame;
 
+		// Wait here, not after simulating, if the render thread is behind
+		auto& renderThread = RenderThread::Get();
+		renderThread.Pace();
+
 		// Start frame timing
 		g_perfTracker.frameStart = std::chrono::high_resolution_clock::now();
 
@@ -229,8 +246,16 @@ namespace WanderSpire {
 		// Game logic -------------------------------------------------------
 		g_perfTracker.updateStart = std::chrono::high_resolution_clock::now();
 
-		AssetLoader::Get().UpdateMainThread();
-		FileWatcher::Get().Update();
+		// Uploads and hot reloads touch GL, so they borrow the render thread's context
+		const bool filesChanged = FileWatcher::Get().Poll();
+		if (filesChanged || AssetLoader::Get().HasMainThreadWork()) {
+			RenderThread::ContextScope glContext;
+			AssetLoader::Get().UpdateMainThread();
+			FileWatcher::Get().DispatchChanges();
+		}
+
+		// Shared across registries, so it moves once per frame rather than per world
+		AnimatedTileSystem::AdvanceClock(dt);
 
 		state->world.Tick(dt, state->ctx);
 		state->world.Update(dt, state->ctx);
@@ -256,16 +281,14 @@ namespace WanderSpire {
 		// Track draw calls
 		g_perfTracker.frameDrawCalls = static_cast<int>(renderMgr.GetCommandCount());
 
-		// Execute all queued commands in the correct layer order
-		renderMgr.ExecuteFrame();
+		// Draw and present the frame: here, or on the render thread while this
+		// thread moves on to the next frame
+		renderMgr.SubmitFrame();
 
 		auto renderEnd = std::chrono::high_resolution_clock::now();
 		g_perfTracker.lastRenderTime = std::chrono::duration<float, std::milli>(
 			renderEnd - g_perfTracker.renderStart).count();
 
-		// Swap buffers to display the rendered frame
-		SDL_GL_SwapWindow(state->sdl.GetWindow());
-
 		auto frameEnd = std::chrono::high_resolution_clock::now();
 		g_perfTracker.lastFrameTime = std::chrono::duration<float, std::milli>(
 			frameEnd - g_perfTracker.frameStart).count();
@@ -276,12 +299,25 @@ namespace WanderSpire {
 
 	void Application::AppQuit(void* raw, SDL_AppResult)
 	{
+		// Take the context back and forget the window before it is destroyed
+		RenderThread::Get().Stop();
+		RenderThread::Get().SetBackend(nullptr);
+
+		// GL objects go while the context is still alive
+		StreamBuffer::Get().Shutdown();
+		FrameUniforms::Get().Shutdown();
+		DebugDraw::Get().Shutdown();
+		TileLookupRenderer::Get().Shutdown();
+		RenderResourceManager::Get().Shutdown();
 		delete GetState(raw);
 	}
 
 	void Application::OnWindowResized(int width, int height)
 	{
-		glViewport(0, 0, width, height);
+		// Frames carry the viewport to the render thread; set it now if GL is ours
+		RenderManager::Get().SetViewport(0, 0, width, height);
+		if (RenderThread::Get().OwnsContext())
+			GL::StateCache::Get().Viewport(0, 0, width, height);
 		camera.SetScreenSize((float)width, (float)height);
 	}
 
@@ -307,8 +343,8 @@ namespace WanderSpire {
 			{ ".png", ".jpg", ".jpeg" },
 			[assetsRoot, &rm](const std::filesystem::path& changed) {
 				auto rel = std::filesystem::relative(changed, assetsRoot).generic_string();
-				if (rel.find("_atlas.png") != std::string::npos ||
-					rel.find("_atlas.json") != std::string::npos)
+				if (rel.find("_atlas.") != std::string::npos ||
+					rel.find("_atlas_") != std::string::npos)   // generated atlas pages
 					return;
 				rm.RegisterTexture(rel, rel);
 				spdlog::info("[HotReload] Scheduled texture reload: {}", rel);
@@ -384,7 +420,9 @@ namespace WanderSpire {
 		/* -----------------------------------------------------------------
 		   1)  Quad geometry (shared by sprites *and* terrain instances)
 		------------------------------------------------------------------*/
-		glBindVertexArray(state->gl.VAO);
+		auto& glState = GL::StateCache::Get();
+		auto& gl = GL::Device::Get();
+		glState.BindVertexArray(state->gl.VAO);
 
 		static const float verts[] = {
 			// pos               // uv
@@ -395,43 +433,49 @@ namespace WanderSpire {
 		};
 		static const unsigned idx[] = { 0, 1, 3, 1, 2, 3 };
 
-		glBindBuffer(GL_ARRAY_BUFFER, state->gl.VBO);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(verts), verts, GL_STATIC_DRAW);
+		glState.BindBuffer(GL_ARRAY_BUFFER, state->gl.VBO);
+		gl.BufferData(GL_ARRAY_BUFFER, sizeof(verts), verts, GL_STATIC_DRAW);
 
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, state->gl.EBO);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(idx), idx, GL_STATIC_DRAW);
+		glState.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, state->gl.EBO);
+		gl.BufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(idx), idx, GL_STATIC_DRAW);
 
 		/* per-vertex (sprite) attributes ─ locations 0-1 */
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float),
+		gl.VertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+		gl.EnableVertexAttribArray(0);
+		gl.VertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float),
 			(void*)(3 * sizeof(float)));
-		glEnableVertexAttribArray(1);
+		gl.EnableVertexAttribArray(1);
 
 		/* -----------------------------------------------------------------
 		   2)  Per-instance attributes for the terrain instanced path
-			   (position + UV rectangle)  – locations 2-4
+			   (position + UV rectangle + atlas page)  – locations 2-5
 		------------------------------------------------------------------*/
-		const GLsizei instStride = 6 * sizeof(float);   // vec2 pos, vec2 uvOff, vec2 uvSize
+		const GLsizei instStride = 7 * sizeof(float);   // vec2 pos, vec2 uvOff, vec2 uvSize, float layer
 
 		// a_InstancePos  (vec2)
-		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, instStride, (void*)0);
-		glEnableVertexAttribArray(2);
-		glVertexAttribDivisor(2, 1);                    // one per *instance*
+		gl.VertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, instStride, (void*)0);
+		gl.EnableVertexAttribArray(2);
+		gl.VertexAttribDivisor(2, 1);                    // one per *instance*
 
 		// a_InstanceUVOffset (vec2)
-		glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE,
+		gl.VertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE,
 			instStride, (void*)(2 * sizeof(float)));
-		glEnableVertexAttribArray(3);
-		glVertexAttribDivisor(3, 1);
+		gl.EnableVertexAttribArray(3);
+		gl.VertexAttribDivisor(3, 1);
 
 		// a_InstanceUVSize (vec2)
-		glVertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE,
+		gl.VertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE,
 			instStride, (void*)(4 * sizeof(float)));
-		glEnableVertexAttribArray(4);
-		glVertexAttribDivisor(4, 1);
+		gl.EnableVertexAttribArray(4);
+		gl.VertexAttribDivisor(4, 1);
+
+		// a_InstanceLayer (float)
+		gl.VertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE,
+			instStride, (void*)(6 * sizeof(float)));
+		gl.EnableVertexAttribArray(5);
+		gl.VertexAttribDivisor(5, 1);
 
-		glBindVertexArray(0);
+		glState.BindVertexArray(0);
 
 		/* -----------------------------------------------------------------
 		   3)  Hand off VAO + EBO to RenderResourceManager so the renderer
@@ -444,6 +488,8 @@ namespace WanderSpire {
 		------------------------------------------------------------------*/
 		auto& rm = state->ctx.renderer;
 		rm.RegisterShader("sprite", "shaders/vertex.glsl", "shaders/fragment.glsl");
+		rm.RegisterShader("debug", "shaders/debug_vertex.glsl", "shaders/debug_fragment.glsl");
+		rm.RegisterShader("tilemap", "shaders/tile_lookup_vertex.glsl", "shaders/tile_lookup_fragment.glsl");
 
 		auto watchShader = [&](const std::string& name,
 			const std::string& vsPath,
@@ -458,6 +504,8 @@ namespace WanderSpire {
 					[=]() { RenderResourceManager::Get().RegisterShader(name, vsPath, fsPath); });
 			};
 		watchShader("sprite", "shaders/vertex.glsl", "shaders/fragment.glsl");
+		watchShader("debug", "shaders/debug_vertex.glsl", "shaders/debug_fragment.glsl");
+		watchShader("tilemap", "shaders/tile_lookup_vertex.glsl", "shaders/tile_lookup_fragment.glsl");
 
 		/* -----------------------------------------------------------------
 		   5)  Sync the GL viewport to the actual SDL window size once
@@ -465,6 +513,12 @@ namespace WanderSpire {
 		int w = 0, h = 0;
 		SDL_GetWindowSizeInPixels(state->sdl.GetWindow(), &w, &h);
 		OnWindowResized(w, h);
+
+		/* -----------------------------------------------------------------
+		   6)  Frames are presented to the window (see AppInit for the
+			   render thread)
+		------------------------------------------------------------------*/
+		RenderThread::Get().SetBackend(std::make_unique<SDLRenderBackend>(state->sdl));
 	}
 
 }
@@ -70,4 +70,9 @@ namespace WanderSpire {
 		}
 	}
 
+	bool AssetLoader::HasMainThreadWork() {
+		std::lock_guard lk(_mainMtx);
+		return !_mainQueue.empty();
+	}
+
 }
@@ -42,6 +42,18 @@ namespace WanderSpire {
 	}
 
 	void FileWatcher::Update() {
+		Poll();
+		DispatchChanges();
+	}
+
+	void FileWatcher::DispatchChanges() {
+		// callbacks may watch more files, so run them from a local list
+		auto pending = std::move(_pending);
+		_pending.clear();
+		for (auto& callback : pending) callback();
+	}
+
+	bool FileWatcher::Poll() {
 		// check individual files
 		for (auto& fw : _files) {
 			if (!std::filesystem::exists(fw.path)) continue;
@@ -49,7 +61,7 @@ namespace WanderSpire {
 			if (newTime != fw.lastWrite) {
 				fw.lastWrite = newTime;
 				spdlog::info("[FileWatcher] file changed: {}", fw.path.string());
-				fw.callback();
+				_pending.push_back(fw.callback);
 			}
 		}
 
@@ -74,16 +86,17 @@ namespace WanderSpire {
 					// new file!
 					dw.times[key] = newTime;
 					spdlog::info("[FileWatcher] new file: {}", key);
-					dw.callback(p);
+					_pending.push_back([callback = dw.callback, p] { callback(p); });
 				}
 				else if (newTime != it->second) {
 					// modified
 					it->second = newTime;
 					spdlog::info("[FileWatcher] dir file changed: {}", key);
-					dw.callback(p);
+					_pending.push_back([callback = dw.callback, p] { callback(p); });
 				}
 			}
 		}
+		return !_pending.empty();
 	}
 
 }
@@ -1,26 +1,33 @@
 #include "WanderSpire/Core/GLObjects.h"
+#include "WanderSpire/Graphics/GLDevice.h"
+#include "WanderSpire/Graphics/GLStateCache.h"
 #include <spdlog/spdlog.h>
 
 namespace WanderSpire {
 
 	GLObjects::GLObjects() {
-		glGenVertexArrays(1, &VAO);
-		glGenBuffers(1, &VBO);
-		glGenBuffers(1, &EBO);
+		auto& gl = GL::Device::Get();
+		VAO = gl.GenVertexArray();
+		VBO = gl.GenBuffer();
+		EBO = gl.GenBuffer();
 		spdlog::info("[GLObjects] Generated VAO={}, VBO={}, EBO={}", VAO, VBO, EBO);
 	}
 
 	GLObjects::~GLObjects() {
+		auto& glState = GL::StateCache::Get();
 		if (EBO) {
-			glDeleteBuffers(1, &EBO);
+			glState.ForgetBuffer(EBO);
+			GL::Device::Get().DeleteBuffer(EBO);
 			spdlog::info("[GLObjects] Deleted EBO={}", EBO);
 		}
 		if (VBO) {
-			glDeleteBuffers(1, &VBO);
+			glState.ForgetBuffer(VBO);
+			GL::Device::Get().DeleteBuffer(VBO);
 			spdlog::info("[GLObjects] Deleted VBO={}", VBO);
 		}
 		if (VAO) {
-			glDeleteVertexArrays(1, &VAO);
+			glState.ForgetVertexArray(VAO);
+			GL::Device::Get().DeleteVertexArray(VAO);
 			spdlog::info("[GLObjects] Deleted VAO={}", VAO);
 		}
 	}
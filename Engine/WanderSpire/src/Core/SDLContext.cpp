@@ -1,6 +1,7 @@
 #include "WanderSpire/Core/SDLContext.h"
 #include <spdlog/spdlog.h>
 #include <glad/glad.h>
+#include "WanderSpire/Graphics/GLStateCache.h"
 
 namespace WanderSpire {
 
@@ -45,18 +46,41 @@ namespace WanderSpire {
 			spdlog::warn("[SDLContext] VSync unavailable: {}", SDL_GetError());
 		}
 
+		// a new context: nothing the state cache remembers applies any more
+		auto& glState = GL::StateCache::Get();
+		glState.Invalidate();
+
 		// set initial viewport
-		glViewport(0, 0, width, height);
+		glState.Viewport(0, 0, width, height);
 
 		// clear color
-		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glState.ClearColor(0.2f, 0.3f, 0.3f, 1.0f);
 
 		// enable alpha blending
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		glState.Enable(GL_BLEND);
+		glState.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 		// disable depth test for 2D
-		glDisable(GL_DEPTH_TEST);
+		glState.Disable(GL_DEPTH_TEST);
+	}
+
+	bool SDLRenderBackend::AttachContext()
+	{
+		if (!SDL_GL_MakeCurrent(m_Window, m_Context)) {
+			spdlog::error("[SDLContext] SDL_GL_MakeCurrent failed: {}", SDL_GetError());
+			return false;
+		}
+		return true;
+	}
+
+	void SDLRenderBackend::DetachContext()
+	{
+		SDL_GL_MakeCurrent(m_Window, nullptr);
+	}
+
+	void SDLRenderBackend::Present(const FramePacket&)
+	{
+		SDL_GL_SwapWindow(m_Window);
 	}
 
 	SDLContext::~SDLContext()
@@ -3,10 +3,13 @@
 #include "WanderSpire/Core/EngineContext.h"
 
 #include "WanderSpire/Systems/AnimationPlaybackSystem.h" 
+#include "WanderSpire/Systems/AnimatedTileSystem.h"
 #include "WanderSpire/Systems/ChunkStreamSystem.h"
 #include "WanderSpire/Systems/RenderSystem.h" 
 #include "WanderSpire/Systems/AnimationSystem.h" 
 #include "WanderSpire/Systems/SpriteUpdateSystem.h"
+#include "WanderSpire/World/PathRequestService.h"
+#include "WanderSpire/World/ChunkGenerationService.h"
 
 namespace WanderSpire {
 
@@ -38,6 +41,13 @@ namespace WanderSpire {
 	void World::Update(float dt, EngineContext& ctx)
 	{
 		AnimationPlaybackSystem::Update(m_Registry, dt);
+		AnimatedTileSystem::Update(m_Registry);
+
+		// Queued path searches, bounded by the configured frame budget
+		PathRequestService::GetInstance().Update(m_Registry);
+
+		// Generated chunks finished by the workers, bounded the same way
+		ChunkGenerationService::GetInstance().Update(m_Registry);
 
 		SpriteUpdateSystem::Update(m_Registry, ctx);
 	}
@@ -1,7 +1,5 @@
 ﻿#include "WanderSpire/Editor/Commands/TilemapCommands.h"
 #include "WanderSpire/World/TilemapSystem.h"
-#include <queue>
-#include <unordered_set>
 
 namespace WanderSpire {
 
@@ -12,53 +10,26 @@ namespace WanderSpire {
 	}
 
 	void FloodFillCommand::Execute() {
-		for (const auto& change : affectedTiles) {
-			TilemapSystem::GetInstance().SetTile(*registry, tilemapLayer, change.position, change.newTileId);
-		}
+		TilemapSystem::GetInstance().ApplyMask(*registry, tilemapLayer, affectedMask, newTileId);
 	}
 
 	void FloodFillCommand::Undo() {
-		for (const auto& change : affectedTiles) {
-			TilemapSystem::GetInstance().SetTile(*registry, tilemapLayer, change.position, change.oldTileId);
-		}
+		// Every filled tile held the start tile's id, so undo is one mask write too
+		TilemapSystem::GetInstance().ApplyMask(*registry, tilemapLayer, affectedMask, originalTileId);
 	}
 
 	std::string FloodFillCommand::GetDescription() const {
-		return "Flood fill " + std::to_string(affectedTiles.size()) + " tiles";
+		return "Flood fill " + std::to_string(affectedMask.tileCount) + " tiles";
 	}
 
 	void FloodFillCommand::CalculateAffectedTiles() {
-		auto& tilemapSystem = TilemapSystem::GetInstance();
-		int originalTileId = tilemapSystem.GetTile(*registry, tilemapLayer, startPosition);
+		TilemapSystem::FloodFillOptions options;
+		options.apply = false;
+		options.collectMask = true;
 
-		if (originalTileId == newTileId) return;
-
-		std::queue<glm::ivec2> toProcess;
-		std::unordered_set<uint64_t> visited;
-		toProcess.push(startPosition);
-
-		while (!toProcess.empty()) {
-			glm::ivec2 pos = toProcess.front();
-			toProcess.pop();
-
-			uint64_t key = (uint64_t(pos.x) << 32) | uint32_t(pos.y);
-			if (visited.find(key) != visited.end()) continue;
-			visited.insert(key);
-
-			int currentTileId = tilemapSystem.GetTile(*registry, tilemapLayer, pos);
-			if (currentTileId == originalTileId) {
-				PaintTilesCommand::TileChange change;
-				change.position = pos;
-				change.oldTileId = currentTileId;
-				change.newTileId = newTileId;
-				affectedTiles.push_back(change);
-
-				toProcess.push(pos + glm::ivec2{ 1, 0 });
-				toProcess.push(pos + glm::ivec2{ -1, 0 });
-				toProcess.push(pos + glm::ivec2{ 0, 1 });
-				toProcess.push(pos + glm::ivec2{ 0, -1 });
-			}
-		}
+		auto result = TilemapSystem::GetInstance().FloodFill(*registry, tilemapLayer, startPosition, newTileId, options);
+		originalTileId = result.originalTileId;
+		affectedMask = std::move(result.mask);
 	}
 
 } // namespace WanderSpire
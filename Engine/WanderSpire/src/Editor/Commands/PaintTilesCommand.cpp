@@ -3,19 +3,32 @@
 
 namespace WanderSpire {
 
+	/// Apply one side of a change list through the chunk-wise bulk path
+	static void ApplyTileChanges(entt::registry& registry, entt::entity tilemapLayer,
+		const std::vector<PaintTilesCommand::TileChange>& changes, bool redo)
+	{
+		std::vector<glm::ivec2> positions;
+		std::vector<int> tileIds;
+		positions.reserve(changes.size());
+		tileIds.reserve(changes.size());
+		for (const auto& change : changes) {
+			positions.push_back(change.position);
+			tileIds.push_back(redo ? change.newTileId : change.oldTileId);
+		}
+		TilemapSystem::GetInstance().SetTiles(registry, tilemapLayer, positions.data(), tileIds.data(), positions.size());
+	}
+
 	PaintTilesCommand::PaintTilesCommand(entt::registry& registry, entt::entity tilemapLayer,
 		const std::vector<TileChange>& changes)
 		: registry(&registry), tilemapLayer(tilemapLayer), tileChanges(changes) {
 	}
 
 	void PaintTilesCommand::Execute() {
-		for (const auto& change : tileChanges)
-			TilemapSystem::GetInstance().SetTile(*registry, tilemapLayer, change.position, change.newTileId);
+		ApplyTileChanges(*registry, tilemapLayer, tileChanges, true);
 	}
 
 	void PaintTilesCommand::Undo() {
-		for (const auto& change : tileChanges)
-			TilemapSystem::GetInstance().SetTile(*registry, tilemapLayer, change.position, change.oldTileId);
+		ApplyTileChanges(*registry, tilemapLayer, tileChanges, false);
 	}
 
 	std::string PaintTilesCommand::GetDescription() const {
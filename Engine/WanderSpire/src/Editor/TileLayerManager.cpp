@@ -12,6 +12,31 @@
 
 namespace WanderSpire {
 
+	/// Write the new side of a change list in one chunk-wise pass
+	static void ApplyChanges(entt::registry& registry, entt::entity layer,
+		const std::vector<PaintTilesCommand::TileChange>& changes)
+	{
+		std::vector<glm::ivec2> positions;
+		std::vector<int> tileIds;
+		positions.reserve(changes.size());
+		tileIds.reserve(changes.size());
+		for (const auto& change : changes) {
+			positions.push_back(change.position);
+			tileIds.push_back(change.newTileId);
+		}
+		TilemapSystem::GetInstance().SetTiles(registry, layer, positions.data(), tileIds.data(), positions.size());
+	}
+
+	/// Read an inclusive rectangle of a layer, row-major
+	static std::vector<int> ReadRegion(entt::registry& registry, entt::entity layer,
+		const glm::ivec2& min, const glm::ivec2& max)
+	{
+		if (max.x < min.x || max.y < min.y) return {};
+		std::vector<int> tiles(static_cast<size_t>(max.x - min.x + 1) * static_cast<size_t>(max.y - min.y + 1));
+		TilemapSystem::GetInstance().ReadRect(registry, layer, min, max, tiles.data());
+		return tiles;
+	}
+
 	TileLayerManager& TileLayerManager::GetInstance() {
 		static TileLayerManager instance;
 		return instance;
@@ -170,35 +195,30 @@ namespace WanderSpire {
 			return;
 		}
 
-		auto& tilemapSystem = TilemapSystem::GetInstance();
 		glm::ivec2 offset = dstPos - srcMin;
+		const int width = srcMax.x - srcMin.x + 1;
+
+		// Snapshot both regions up front so overlapping copies read the original tiles
+		const std::vector<int> srcTiles = ReadRegion(registry, srcLayer, srcMin, srcMax);
+		const std::vector<int> dstTiles = ReadRegion(registry, dstLayer, srcMin + offset, srcMax + offset);
 
 		std::vector<PaintTilesCommand::TileChange> changes;
 		int tilesCopied = 0;
 
-		for (int y = srcMin.y; y <= srcMax.y; ++y) {
-			for (int x = srcMin.x; x <= srcMax.x; ++x) {
-				glm::ivec2 srcTilePos{ x, y };
-				glm::ivec2 dstTilePos = srcTilePos + offset;
-
-				int srcTileId = tilemapSystem.GetTile(registry, srcLayer, srcTilePos);
-				if (srcTileId != -1) {
-					int oldDstTileId = tilemapSystem.GetTile(registry, dstLayer, dstTilePos);
-
-					if (oldDstTileId != srcTileId) {
-						PaintTilesCommand::TileChange change;
-						change.position = dstTilePos;
-						change.oldTileId = oldDstTileId;
-						change.newTileId = srcTileId;
-						changes.push_back(change);
-
-						tilemapSystem.SetTile(registry, dstLayer, dstTilePos, srcTileId);
-						tilesCopied++;
-					}
-				}
+		for (size_t i = 0; i < srcTiles.size(); ++i) {
+			int srcTileId = srcTiles[i];
+			if (srcTileId != -1 && dstTiles[i] != srcTileId) {
+				PaintTilesCommand::TileChange change;
+				change.position = dstPos + glm::ivec2{ static_cast<int>(i % width), static_cast<int>(i / width) };
+				change.oldTileId = dstTiles[i];
+				change.newTileId = srcTileId;
+				changes.push_back(change);
+				tilesCopied++;
 			}
 		}
 
+		ApplyChanges(registry, dstLayer, changes);
+
 		// Create command for undo/redo
 		if (!changes.empty() && g_commandHistory) {
 			auto command = std::make_unique<PaintTilesCommand>(registry, dstLayer, changes);
@@ -215,23 +235,18 @@ namespace WanderSpire {
 
 		if (!IsLayerValid(registry, layer)) return;
 
-		auto& tilemapSystem = TilemapSystem::GetInstance();
-
 		// Clear previous clipboard data
 		clipboardData.clear();
 		clipboardSize = max - min + glm::ivec2{ 1, 1 };
 
 		// Copy tiles to clipboard
-		for (int y = min.y; y <= max.y; ++y) {
-			for (int x = min.x; x <= max.x; ++x) {
-				glm::ivec2 pos{ x, y };
-				int tileId = tilemapSystem.GetTile(registry, layer, pos);
-
-				ClipboardTile clipTile;
-				clipTile.position = pos - min; // Store relative position
-				clipTile.tileId = tileId;
-				clipboardData.push_back(clipTile);
-			}
+		const std::vector<int> tiles = ReadRegion(registry, layer, min, max);
+		clipboardData.reserve(tiles.size());
+		for (size_t i = 0; i < tiles.size(); ++i) {
+			ClipboardTile clipTile;
+			clipTile.position = { static_cast<int>(i % clipboardSize.x), static_cast<int>(i / clipboardSize.x) }; // Store relative position
+			clipTile.tileId = tiles[i];
+			clipboardData.push_back(clipTile);
 		}
 
 		spdlog::debug("[TileLayerManager] Copied {}x{} region to clipboard with {} tiles",
@@ -258,12 +273,12 @@ namespace WanderSpire {
 					change.oldTileId = oldTileId;
 					change.newTileId = clipTile.tileId;
 					changes.push_back(change);
-
-					tilemapSystem.SetTile(registry, layer, pastePos, clipTile.tileId);
 				}
 			}
 		}
 
+		ApplyChanges(registry, layer, changes);
+
 		// Create command for undo/redo
 		if (!changes.empty() && g_commandHistory) {
 			auto command = std::make_unique<PaintTilesCommand>(registry, layer, changes);
@@ -291,32 +306,31 @@ namespace WanderSpire {
 			return;
 		}
 
-		auto& tilemapSystem = TilemapSystem::GetInstance();
 		std::vector<PaintTilesCommand::TileChange> changes;
 		float clampedOpacity = std::clamp(opacity, 0.0f, 1.0f);
 
-		for (int y = min.y; y <= max.y; ++y) {
-			for (int x = min.x; x <= max.x; ++x) {
-				glm::ivec2 pos{ x, y };
+		const std::vector<int> overlayTiles = ReadRegion(registry, overlayLayer, min, max);
+		const std::vector<int> baseTiles = ReadRegion(registry, baseLayer, min, max);
+		const int width = max.x - min.x + 1;
 
-				int overlayTile = tilemapSystem.GetTile(registry, overlayLayer, pos);
-				if (overlayTile != -1) {
-					int baseTile = tilemapSystem.GetTile(registry, baseLayer, pos);
-					int resultTile = BlendTiles(baseTile, overlayTile, clampedOpacity);
+		for (size_t i = 0; i < overlayTiles.size(); ++i) {
+			int overlayTile = overlayTiles[i];
+			if (overlayTile != -1) {
+				int baseTile = baseTiles[i];
+				int resultTile = BlendTiles(baseTile, overlayTile, clampedOpacity);
 
-					if (baseTile != resultTile) {
-						PaintTilesCommand::TileChange change;
-						change.position = pos;
-						change.oldTileId = baseTile;
-						change.newTileId = resultTile;
-						changes.push_back(change);
-
-						tilemapSystem.SetTile(registry, baseLayer, pos, resultTile);
-					}
+				if (baseTile != resultTile) {
+					PaintTilesCommand::TileChange change;
+					change.position = min + glm::ivec2{ static_cast<int>(i % width), static_cast<int>(i / width) };
+					change.oldTileId = baseTile;
+					change.newTileId = resultTile;
+					changes.push_back(change);
 				}
 			}
 		}
 
+		ApplyChanges(registry, baseLayer, changes);
+
 		// Create command for undo/redo
 		if (!changes.empty() && g_commandHistory) {
 			auto command = std::make_unique<PaintTilesCommand>(registry, baseLayer, changes);
@@ -335,37 +349,36 @@ namespace WanderSpire {
 			return;
 		}
 
-		auto& tilemapSystem = TilemapSystem::GetInstance();
 		std::vector<PaintTilesCommand::TileChange> changes;
 
-		for (int y = min.y; y <= max.y; ++y) {
-			for (int x = min.x; x <= max.x; ++x) {
-				glm::ivec2 pos{ x, y };
-				int targetTile = tilemapSystem.GetTile(registry, targetLayer, pos);
-				int resultTile = targetTile;
+		const std::vector<int> targetTiles = ReadRegion(registry, targetLayer, min, max);
+		std::vector<int> resultTiles = targetTiles;
 
-				// Merge from all source layers in order
-				for (entt::entity sourceLayer : sourceLayers) {
-					if (!IsLayerValid(registry, sourceLayer)) continue;
+		// Merge from all source layers in order
+		for (entt::entity sourceLayer : sourceLayers) {
+			if (!IsLayerValid(registry, sourceLayer)) continue;
 
-					int sourceTile = tilemapSystem.GetTile(registry, sourceLayer, pos);
-					if (sourceTile != -1) {
-						resultTile = MergeTiles(resultTile, sourceTile);
-					}
+			const std::vector<int> sourceTiles = ReadRegion(registry, sourceLayer, min, max);
+			for (size_t i = 0; i < sourceTiles.size(); ++i) {
+				if (sourceTiles[i] != -1) {
+					resultTiles[i] = MergeTiles(resultTiles[i], sourceTiles[i]);
 				}
+			}
+		}
 
-				if (targetTile != resultTile) {
-					PaintTilesCommand::TileChange change;
-					change.position = pos;
-					change.oldTileId = targetTile;
-					change.newTileId = resultTile;
-					changes.push_back(change);
-
-					tilemapSystem.SetTile(registry, targetLayer, pos, resultTile);
-				}
+		const int width = max.x - min.x + 1;
+		for (size_t i = 0; i < targetTiles.size(); ++i) {
+			if (targetTiles[i] != resultTiles[i]) {
+				PaintTilesCommand::TileChange change;
+				change.position = min + glm::ivec2{ static_cast<int>(i % width), static_cast<int>(i / width) };
+				change.oldTileId = targetTiles[i];
+				change.newTileId = resultTiles[i];
+				changes.push_back(change);
 			}
 		}
 
+		ApplyChanges(registry, targetLayer, changes);
+
 		// Create command for undo/redo
 		if (!changes.empty() && g_commandHistory) {
 			auto command = std::make_unique<PaintTilesCommand>(registry, targetLayer, changes);
@@ -645,9 +645,7 @@ namespace WanderSpire {
 		}
 
 		// Apply pattern
-		for (size_t i = 0; i < positions.size(); ++i) {
-			TilemapSystem::GetInstance().SetTile(registry, tilemapLayer, positions[i], tileIds[i]);
-		}
+		TilemapSystem::GetInstance().SetTiles(registry, tilemapLayer, positions.data(), tileIds.data(), positions.size());
 
 		if (!autoTileSets.empty()) {
 			ApplyAutoTiling(registry, tilemapLayer, positions);
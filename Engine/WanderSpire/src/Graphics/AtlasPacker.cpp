@@ -0,0 +1,346 @@
+#include "WanderSpire/Graphics/AtlasPacker.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+
+namespace WanderSpire {
+
+	namespace {
+		struct Rect {
+			int x = 0, y = 0, w = 0, h = 0;
+		};
+
+		bool Contains(const Rect& outer, const Rect& inner) {
+			return inner.x >= outer.x && inner.y >= outer.y &&
+				inner.x + inner.w <= outer.x + outer.w && inner.y + inner.h <= outer.y + outer.h;
+		}
+
+		bool Intersects(const Rect& a, const Rect& b) {
+			return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+		}
+
+		/// Bump when the packer or the atlas format changes, so old caches rebuild
+		constexpr uint32_t CACHE_VERSION = 1;
+
+		constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+		constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+		int NextPow2(int v) {
+			int p = 1;
+			while (p < v) p <<= 1;
+			return p;
+		}
+
+		/// Free space of one page, as the maximal free rectangles
+		class Bin {
+		public:
+			Bin(int width, int height) { m_free.push_back({ 0, 0, width, height }); }
+
+			/// Best short-side fit for a `w`×`h` footprint
+			bool Find(int w, int h, Rect& out, int& shortSide, int& longSide) const {
+				bool found = false;
+				for (const auto& f : m_free) {
+					if (f.w < w || f.h < h) continue;
+					const int a = f.w - w, b = f.h - h;
+					const int s = std::min(a, b), l = std::max(a, b);
+					if (!found || s < shortSide || (s == shortSide && l < longSide)) {
+						out = { f.x, f.y, w, h };
+						shortSide = s;
+						longSide = l;
+						found = true;
+					}
+				}
+				return found;
+			}
+
+			void Place(const Rect& used) {
+				std::vector<Rect> next;
+				next.reserve(m_free.size() + 4);
+				for (const auto& f : m_free) {
+					if (!Intersects(f, used)) {
+						next.push_back(f);
+						continue;
+					}
+					// What is left of `f` on each side of `used`
+					if (used.x > f.x) next.push_back({ f.x, f.y, used.x - f.x, f.h });
+					if (used.x + used.w < f.x + f.w) next.push_back({ used.x + used.w, f.y, f.x + f.w - used.x - used.w, f.h });
+					if (used.y > f.y) next.push_back({ f.x, f.y, f.w, used.y - f.y });
+					if (used.y + used.h < f.y + f.h) next.push_back({ f.x, used.y + used.h, f.w, f.y + f.h - used.y - used.h });
+				}
+
+				// Drop rectangles inside others; of two equal ones keep the first
+				m_free.clear();
+				for (size_t i = 0; i < next.size(); ++i) {
+					bool redundant = false;
+					for (size_t j = 0; j < next.size() && !redundant; ++j) {
+						if (i == j || !Contains(next[j], next[i])) continue;
+						redundant = !Contains(next[i], next[j]) || j < i;
+					}
+					if (!redundant) m_free.push_back(next[i]);
+				}
+			}
+
+		private:
+			std::vector<Rect> m_free;
+		};
+
+		/// Pack `items` (footprints) into one `width`×`height` bin; false if any does not fit
+		bool PackSingle(const std::vector<Rect>& footprints, const std::vector<size_t>& items,
+			int width, int height, std::vector<Rect>& out) {
+			Bin bin(width, height);
+			for (size_t item : items) {
+				Rect r;
+				int s = 0, l = 0;
+				if (!bin.Find(footprints[item].w, footprints[item].h, r, s, l)) return false;
+				bin.Place(r);
+				out[item] = r;
+			}
+			return true;
+		}
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Results
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	uint64_t AtlasPackResult::UsedArea() const {
+		uint64_t area = 0;
+		for (const auto& page : pages) area += page.usedArea;
+		return area;
+	}
+
+	uint64_t AtlasPackResult::PageArea() const {
+		uint64_t area = 0;
+		for (const auto& page : pages) area += uint64_t(page.width) * uint64_t(page.height);
+		return area;
+	}
+
+	double AtlasPackResult::Efficiency() const {
+		const uint64_t pageArea = PageArea();
+		return pageArea ? double(UsedArea()) / double(pageArea) : 0.0;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Packing
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	AtlasPacker::AtlasPacker(const AtlasPackSettings& settings)
+		: m_settings(settings)
+	{
+		m_settings.maxPageSize = std::max(1, m_settings.maxPageSize);
+		m_settings.padding = std::max(0, m_settings.padding);
+		m_settings.extrude = std::max(0, m_settings.extrude);
+	}
+
+	AtlasPackResult AtlasPacker::Pack(const std::vector<Size>& sizes) const {
+		const int extrude = m_settings.extrude;
+		const int padding = m_settings.padding;
+		// The padding after the last column and row may hang over the page edge
+		const int binSize = m_settings.maxPageSize + padding;
+
+		AtlasPackResult result;
+		result.placements.resize(sizes.size());
+
+		std::vector<Rect> footprints(sizes.size());
+		for (size_t i = 0; i < sizes.size(); ++i) {
+			footprints[i] = { 0, 0, sizes[i].width + 2 * extrude + padding, sizes[i].height + 2 * extrude + padding };
+		}
+
+		// Largest first: long side, then area; equal images keep their input order
+		std::vector<size_t> order(sizes.size());
+		std::iota(order.begin(), order.end(), size_t(0));
+		std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+			const int la = std::max(sizes[a].width, sizes[a].height);
+			const int lb = std::max(sizes[b].width, sizes[b].height);
+			if (la != lb) return la > lb;
+			return int64_t(sizes[a].width) * sizes[a].height > int64_t(sizes[b].width) * sizes[b].height;
+			});
+
+		std::vector<Bin> bins;
+		std::vector<std::vector<size_t>> pageItems;
+		std::vector<Rect> placed(sizes.size());
+		for (size_t item : order) {
+			const Rect& fp = footprints[item];
+			if (sizes[item].width <= 0 || sizes[item].height <= 0 || fp.w > binSize || fp.h > binSize) {
+				++result.rejected;
+				continue;
+			}
+
+			int bestPage = -1, bestShort = 0, bestLong = 0;
+			Rect best;
+			for (size_t page = 0; page < bins.size(); ++page) {
+				Rect r;
+				int s = 0, l = 0;
+				if (bins[page].Find(fp.w, fp.h, r, s, l) &&
+					(bestPage < 0 || s < bestShort || (s == bestShort && l < bestLong))) {
+					bestPage = static_cast<int>(page);
+					bestShort = s;
+					bestLong = l;
+					best = r;
+				}
+			}
+			if (bestPage < 0) {
+				bins.emplace_back(binSize, binSize);
+				pageItems.emplace_back();
+				bestPage = static_cast<int>(bins.size() - 1);
+				bins.back().Find(fp.w, fp.h, best, bestShort, bestLong);
+			}
+
+			bins[bestPage].Place(best);
+			placed[item] = best;
+			pageItems[bestPage].push_back(item);
+			result.placements[item].page = bestPage;
+		}
+
+		// Re-pack the last page into the smallest power-of-two size that takes all of its images
+		if (!pageItems.empty()) {
+			const auto& items = pageItems.back();
+			uint64_t area = 0;
+			int minW = 1, minH = 1;
+			for (size_t item : items) {
+				area += uint64_t(footprints[item].w) * uint64_t(footprints[item].h);
+				minW = std::max(minW, footprints[item].w - padding);
+				minH = std::max(minH, footprints[item].h - padding);
+			}
+
+			std::vector<int> edges;
+			for (int edge = 1; edge < m_settings.maxPageSize; edge <<= 1) edges.push_back(edge);
+			edges.push_back(m_settings.maxPageSize);
+
+			std::vector<std::pair<int, int>> candidates;
+			for (int w : edges) {
+				for (int h : edges) {
+					if (w >= minW && h >= minH && uint64_t(w + padding) * uint64_t(h + padding) >= area &&
+						(w < m_settings.maxPageSize || h < m_settings.maxPageSize)) {
+						candidates.emplace_back(w, h);
+					}
+				}
+			}
+			// Smallest area first, squarer first among equal areas
+			std::stable_sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+				const int64_t areaA = int64_t(a.first) * a.second, areaB = int64_t(b.first) * b.second;
+				if (areaA != areaB) return areaA < areaB;
+				return std::abs(a.first - a.second) < std::abs(b.first - b.second);
+				});
+
+			std::vector<Rect> trial(sizes.size());
+			for (const auto& [w, h] : candidates) {
+				if (PackSingle(footprints, items, w + padding, h + padding, trial)) {
+					for (size_t item : items) placed[item] = trial[item];
+					break;
+				}
+			}
+		}
+
+		// Page sizes: the space actually used, rounded as configured
+		result.pages.resize(bins.size());
+		for (size_t page = 0; page < pageItems.size(); ++page) {
+			auto& out = result.pages[page];
+			int usedW = 1, usedH = 1;
+			for (size_t item : pageItems[page]) {
+				usedW = std::max(usedW, placed[item].x + placed[item].w - padding);
+				usedH = std::max(usedH, placed[item].y + placed[item].h - padding);
+				out.usedArea += uint64_t(sizes[item].width) * uint64_t(sizes[item].height);
+				++out.images;
+			}
+			if (m_settings.powerOfTwo) {
+				usedW = NextPow2(usedW);
+				usedH = NextPow2(usedH);
+			}
+			out.width = std::min(usedW, m_settings.maxPageSize);
+			out.height = std::min(usedH, m_settings.maxPageSize);
+		}
+
+		if (m_settings.uniformPages) {
+			int w = 0, h = 0;
+			for (const auto& page : result.pages) {
+				w = std::max(w, page.width);
+				h = std::max(h, page.height);
+			}
+			for (auto& page : result.pages) {
+				page.width = w;
+				page.height = h;
+			}
+		}
+
+		for (size_t item = 0; item < sizes.size(); ++item) {
+			if (result.placements[item].page < 0) continue;
+			result.placements[item].x = placed[item].x + extrude;
+			result.placements[item].y = placed[item].y + extrude;
+		}
+		return result;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Pixels
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void AtlasPacker::Blit(std::vector<uint8_t>& page, int pageWidth, int pageHeight,
+		const uint8_t* image, int width, int height, int x, int y, int extrude) {
+		if (!image || width <= 0 || height <= 0) return;
+		if (page.size() < size_t(pageWidth) * size_t(pageHeight) * 4) return;
+
+		const int x0 = std::max(0, x - extrude);
+		const int x1 = std::min(pageWidth, x + width + extrude);
+		if (x0 >= x1) return;
+
+		for (int row = -extrude; row < height + extrude; ++row) {
+			const int dy = y + row;
+			if (dy < 0 || dy >= pageHeight) continue;
+
+			const uint8_t* src = image + size_t(std::clamp(row, 0, height - 1)) * size_t(width) * 4;
+			uint8_t* dst = page.data() + size_t(dy) * size_t(pageWidth) * 4;
+
+			// Body in one copy, then the extruded columns from the edge pixels
+			const int bodyX0 = std::max(x0, x), bodyX1 = std::min(x1, x + width);
+			if (bodyX0 < bodyX1) {
+				std::memcpy(dst + size_t(bodyX0) * 4, src + size_t(bodyX0 - x) * 4, size_t(bodyX1 - bodyX0) * 4);
+			}
+			for (int dx = x0; dx < std::min(x1, x); ++dx) std::memcpy(dst + size_t(dx) * 4, src, 4);
+			for (int dx = std::max(x0, x + width); dx < x1; ++dx) {
+				std::memcpy(dst + size_t(dx) * 4, src + size_t(width - 1) * 4, 4);
+			}
+		}
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Cache key
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	AtlasCacheKey::AtlasCacheKey(const AtlasPackSettings& settings, bool textureArray)
+		: m_hash(FNV_OFFSET)
+	{
+		const int32_t fields[] = {
+			static_cast<int32_t>(CACHE_VERSION), settings.maxPageSize, settings.padding, settings.extrude,
+			settings.powerOfTwo ? 1 : 0, settings.uniformPages ? 1 : 0, textureArray ? 1 : 0
+		};
+		Mix(fields, sizeof(fields));
+	}
+
+	void AtlasCacheKey::AddSource(const std::string& name, const uint8_t* data, size_t size) {
+		// Lengths first, so no two different name/content splits hash alike
+		const uint64_t lengths[] = { name.size(), size };
+		Mix(lengths, sizeof(lengths));
+		Mix(name.data(), name.size());
+		Mix(data, size);
+	}
+
+	std::string AtlasCacheKey::ToString() const {
+		char text[17];
+		std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(m_hash));
+		return text;
+	}
+
+	void AtlasCacheKey::Mix(const void* data, size_t size) {
+		// FNV-1a
+		const auto* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i) {
+			m_hash ^= bytes[i];
+			m_hash *= FNV_PRIME;
+		}
+	}
+
+} // namespace WanderSpire
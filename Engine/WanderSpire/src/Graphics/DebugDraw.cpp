@@ -0,0 +1,381 @@
+#include "WanderSpire/Graphics/DebugDraw.h"
+#include "WanderSpire/Graphics/GLDevice.h"
+#include "WanderSpire/Graphics/GLStateCache.h"
+#include "WanderSpire/Graphics/GLStateManager.h"
+#include "WanderSpire/Graphics/RenderResourceManager.h"
+#include "WanderSpire/Graphics/StreamBuffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <spdlog/spdlog.h>
+
+namespace WanderSpire {
+
+	namespace {
+		constexpr int MAX_CIRCLE_SEGMENTS = 256;
+
+		double Now() {
+			return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		/// Drop entries whose expiry has passed, keeping the order of the rest
+		template <typename T>
+		void Prune(std::vector<T>& items, std::vector<double>& expiry, size_t itemsPerEntry, double now) {
+			size_t kept = 0;
+			for (size_t i = 0; i < expiry.size(); ++i) {
+				if (expiry[i] <= now) continue;
+				for (size_t k = 0; k < itemsPerEntry; ++k) items[kept * itemsPerEntry + k] = items[i * itemsPerEntry + k];
+				expiry[kept++] = expiry[i];
+			}
+			items.resize(kept * itemsPerEntry);
+			expiry.resize(kept);
+		}
+	}
+
+	/// Holds the calling thread's active batch for writing. Never blocks: if
+	/// the collector flips batches in between, it simply takes the new one.
+	class DebugDraw::WriteScope {
+	public:
+		explicit WriteScope(Accumulator& accumulator)
+			: m_accumulator(accumulator)
+		{
+			while (true) {
+				const int index = accumulator.active.load();
+				accumulator.writing.store(index);
+				if (accumulator.active.load() == index) {
+					m_batch = &accumulator.batches[index];
+					break;
+				}
+			}
+		}
+
+		~WriteScope() {
+			m_accumulator.writing.store(-1);
+		}
+
+		void AddLine(const glm::vec2& from, const glm::vec2& to, uint32_t color, float duration) {
+			m_batch->lines.push_back({ from, color });
+			m_batch->lines.push_back({ to, color });
+			m_batch->lineDurations.push_back(duration);
+		}
+
+		void AddQuad(const glm::vec2& center, const glm::vec2& size, float rotation, uint32_t color, float duration) {
+			m_batch->quads.push_back({ center, size * 0.5f, rotation, color });
+			m_batch->quadDurations.push_back(duration);
+		}
+
+	private:
+		Accumulator& m_accumulator;
+		Batch* m_batch = nullptr;
+	};
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Submitting
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	DebugDraw& DebugDraw::Get() {
+		static DebugDraw instance;
+		return instance;
+	}
+
+	DebugDraw::~DebugDraw() = default;
+
+	uint32_t DebugDraw::PackColor(const glm::vec4& color) {
+		auto channel = [](float v) {
+			return static_cast<uint32_t>(std::lround(std::clamp(v, 0.0f, 1.0f) * 255.0f));
+		};
+		// Byte order R, G, B, A in memory, as the normalized attribute reads it
+		return channel(color.r) | (channel(color.g) << 8) | (channel(color.b) << 16) | (channel(color.a) << 24);
+	}
+
+	/// A thread's handle on its accumulator; retires it when the thread exits
+	class DebugDraw::LocalSlot {
+	public:
+		~LocalSlot() {
+			if (accumulator) accumulator->retired.store(true, std::memory_order_release);
+		}
+
+		std::shared_ptr<Accumulator> accumulator;
+	};
+
+	DebugDraw::Accumulator& DebugDraw::LocalAccumulator() {
+		thread_local LocalSlot local;
+		if (!local.accumulator) {
+			local.accumulator = std::make_shared<Accumulator>();
+			std::lock_guard lock(m_mutex);
+			m_accumulators.push_back(local.accumulator);
+		}
+		return *local.accumulator;
+	}
+
+	void DebugDraw::Line(const glm::vec2& from, const glm::vec2& to, const glm::vec4& color,
+		float width, float duration) {
+		WriteScope scope(LocalAccumulator());
+		if (width <= 1.0f) {
+			scope.AddLine(from, to, PackColor(color), duration);
+			return;
+		}
+
+		const glm::vec2 diff = to - from;
+		scope.AddQuad((from + to) * 0.5f, { glm::length(diff), width }, std::atan2(diff.y, diff.x),
+			PackColor(color), duration);
+	}
+
+	void DebugDraw::Rect(const glm::vec2& min, const glm::vec2& size, const glm::vec4& color,
+		bool filled, float duration) {
+		WriteScope scope(LocalAccumulator());
+		const uint32_t packed = PackColor(color);
+		if (filled) {
+			scope.AddQuad(min + size * 0.5f, size, 0.0f, packed, duration);
+			return;
+		}
+
+		const glm::vec2 max = min + size;
+		scope.AddLine(min, { max.x, min.y }, packed, duration);
+		scope.AddLine({ max.x, min.y }, max, packed, duration);
+		scope.AddLine(max, { min.x, max.y }, packed, duration);
+		scope.AddLine({ min.x, max.y }, min, packed, duration);
+	}
+
+	void DebugDraw::Circle(const glm::vec2& center, float radius, const glm::vec4& color,
+		int segments, float duration) {
+		segments = std::clamp(segments, 3, MAX_CIRCLE_SEGMENTS);
+		WriteScope scope(LocalAccumulator());
+		const uint32_t packed = PackColor(color);
+		const float step = 2.0f * 3.14159265358979f / static_cast<float>(segments);
+
+		glm::vec2 previous = center + glm::vec2(radius, 0.0f);
+		for (int i = 1; i <= segments; ++i) {
+			const float angle = step * static_cast<float>(i);
+			const glm::vec2 point = center + radius * glm::vec2(std::cos(angle), std::sin(angle));
+			scope.AddLine(previous, point, packed, duration);
+			previous = point;
+		}
+	}
+
+	void DebugDraw::Quad(const glm::vec2& center, const glm::vec2& size, float rotation,
+		const glm::vec4& color, float duration) {
+		WriteScope scope(LocalAccumulator());
+		scope.AddQuad(center, size, rotation, PackColor(color), duration);
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Collecting
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void DebugDraw::Drain(Batch& batch, double now) {
+		for (size_t line = 0; line < batch.lineDurations.size(); ++line) {
+			const float duration = batch.lineDurations[line];
+			if (duration > 0.0f) {
+				m_persistentLines.push_back(batch.lines[line * 2]);
+				m_persistentLines.push_back(batch.lines[line * 2 + 1]);
+				m_lineExpiry.push_back(now + duration);
+			}
+			else {
+				m_pendingLines.push_back(batch.lines[line * 2]);
+				m_pendingLines.push_back(batch.lines[line * 2 + 1]);
+			}
+		}
+		for (size_t quad = 0; quad < batch.quadDurations.size(); ++quad) {
+			const float duration = batch.quadDurations[quad];
+			if (duration > 0.0f) {
+				m_persistentQuads.push_back(batch.quads[quad]);
+				m_quadExpiry.push_back(now + duration);
+			}
+			else {
+				m_pendingQuads.push_back(batch.quads[quad]);
+			}
+		}
+		batch.lines.clear();
+		batch.lineDurations.clear();
+		batch.quads.clear();
+		batch.quadDurations.clear();
+	}
+
+	void DebugDraw::Collect(double now) {
+		for (size_t i = 0; i < m_accumulators.size();) {
+			Accumulator& accumulator = *m_accumulators[i];
+
+			// The thread is gone, so both batches are ours, including the one
+			// it was writing last
+			if (accumulator.retired.load(std::memory_order_acquire)) {
+				Drain(accumulator.batches[0], now);
+				Drain(accumulator.batches[1], now);
+				m_accumulators.erase(m_accumulators.begin() + static_cast<std::ptrdiff_t>(i));
+				continue;
+			}
+
+			// Point the owner at the other batch, then wait until it has left this one
+			const int index = accumulator.active.load();
+			accumulator.active.store(index ^ 1);
+			while (accumulator.writing.load() == index) std::this_thread::yield();
+			Drain(accumulator.batches[index], now);
+			++i;
+		}
+	}
+
+	std::unique_ptr<DebugDrawCommand> DebugDraw::BuildCommand() {
+		std::lock_guard lock(m_mutex);
+		const double now = Now();
+		Collect(now);
+		Prune(m_persistentLines, m_lineExpiry, 2, now);
+		Prune(m_persistentQuads, m_quadExpiry, 1, now);
+
+		auto command = std::make_unique<DebugDrawCommand>();
+		command->lines.swap(m_pendingLines);
+		command->quads.swap(m_pendingQuads);
+		command->lines.insert(command->lines.end(), m_persistentLines.begin(), m_persistentLines.end());
+		command->quads.insert(command->quads.end(), m_persistentQuads.begin(), m_persistentQuads.end());
+
+		m_stats.lines = command->lines.size() / 2;
+		m_stats.quads = command->quads.size();
+		m_stats.persistent = m_lineExpiry.size() + m_quadExpiry.size();
+		m_stats.drawCalls = (command->lines.empty() ? 0 : 1) + (command->quads.empty() ? 0 : 1);
+		if (m_stats.drawCalls == 0) return nullptr;
+
+		++m_stats.commands;
+		return command;
+	}
+
+	void DebugDraw::Clear() {
+		std::lock_guard lock(m_mutex);
+		// What was submitted to be drawn once still is
+		Collect(Now());
+		m_persistentLines.clear();
+		m_lineExpiry.clear();
+		m_persistentQuads.clear();
+		m_quadExpiry.clear();
+	}
+
+	DebugDrawStats DebugDraw::GetStats() const {
+		std::lock_guard lock(m_mutex);
+		return m_stats;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Drawing
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void DebugDrawCommand::Execute() {
+		DebugDraw::Get().Draw(*this);
+	}
+
+	void DebugDraw::CreateResources() {
+		if (!m_shader) {
+			m_shader = RenderResourceManager::Get().GetShader("debug");
+			if (!m_shader) {
+				spdlog::error("[DebugDraw] 'debug' shader not found!");
+				return;
+			}
+			m_quadsUniform = m_shader->DeclareUniform("u_Quads");
+		}
+
+		auto& gl = GL::Device::Get();
+		if (!m_lineVAO) m_lineVAO = gl.GenVertexArray();
+		if (!m_quadVAO) m_quadVAO = gl.GenVertexArray();
+
+		auto& stream = StreamBuffer::Get();
+		if (!stream.IsInitialized() && !m_fallbackVBO && !stream.Initialize()) {
+			m_fallbackVBO = gl.GenBuffer();
+			spdlog::warn("[DebugDraw] Stream buffer unavailable, using VBO: {}", m_fallbackVBO);
+		}
+	}
+
+	void DebugDraw::Draw(const DebugDrawCommand& command) {
+		if (command.lines.empty() && command.quads.empty()) return;
+
+		CreateResources();
+		if (!m_shader || !m_shader->GetID() || !m_lineVAO || !m_quadVAO) return;
+
+		auto& cache = GL::StateCache::Get();
+		auto& gl = GL::Device::Get();
+
+		// This frame's part of the stream buffer, or the fallback VBO
+		auto upload = [&](const void* data, size_t bytes, GLuint& buffer, size_t& offset) {
+			auto allocation = StreamBuffer::Get().Upload(data, bytes, StreamUsage::Debug);
+			if (allocation) {
+				buffer = allocation.buffer;
+				offset = allocation.offset;
+				return;
+			}
+			if (!m_fallbackVBO) m_fallbackVBO = gl.GenBuffer();
+			cache.BindBuffer(GL_ARRAY_BUFFER, m_fallbackVBO);
+			gl.BufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(bytes), data, GL_STREAM_DRAW);
+			buffer = m_fallbackVBO;
+			offset = 0;
+		};
+
+		// Whatever draws next in the frame gets its program and VAO back
+		GL::ProgramBinder program(m_shader->GetID());
+		GL::VertexArrayBinder vertexArray(m_lineVAO);
+
+		const bool blending = cache.IsEnabled(GL_BLEND);
+		cache.Enable(GL_BLEND);
+		cache.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);   // The engine's blending, left as found
+
+		GLuint buffer = 0;
+		size_t offset = 0;
+
+		// All lines: one GL_LINES draw
+		if (!command.lines.empty()) {
+			upload(command.lines.data(), command.lines.size() * sizeof(DebugLineVertex), buffer, offset);
+			cache.BindBuffer(GL_ARRAY_BUFFER, buffer);
+
+			const GLsizei stride = sizeof(DebugLineVertex);
+			gl.EnableVertexAttribArray(0);
+			gl.VertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride,
+				reinterpret_cast<void*>(offset + offsetof(DebugLineVertex, position)));
+			gl.EnableVertexAttribArray(1);
+			gl.VertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+				reinterpret_cast<void*>(offset + offsetof(DebugLineVertex, color)));
+
+			m_shader->Set(m_quadsUniform, 0);
+			gl.DrawArrays(GL_LINES, 0, static_cast<GLsizei>(command.lines.size()));
+		}
+
+		// All quads: one instanced triangle strip, corners from gl_VertexID
+		if (!command.quads.empty()) {
+			cache.BindVertexArray(m_quadVAO);
+			upload(command.quads.data(), command.quads.size() * sizeof(DebugQuadInstance), buffer, offset);
+			cache.BindBuffer(GL_ARRAY_BUFFER, buffer);
+
+			const GLsizei stride = sizeof(DebugQuadInstance);
+			gl.EnableVertexAttribArray(2);   // center.xy, halfSize.zw
+			gl.VertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride,
+				reinterpret_cast<void*>(offset + offsetof(DebugQuadInstance, center)));
+			gl.VertexAttribDivisor(2, 1);
+			gl.EnableVertexAttribArray(3);
+			gl.VertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride,
+				reinterpret_cast<void*>(offset + offsetof(DebugQuadInstance, rotation)));
+			gl.VertexAttribDivisor(3, 1);
+			gl.EnableVertexAttribArray(1);
+			gl.VertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+				reinterpret_cast<void*>(offset + offsetof(DebugQuadInstance, color)));
+			gl.VertexAttribDivisor(1, 1);
+
+			m_shader->Set(m_quadsUniform, 1);
+			gl.DrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(command.quads.size()));
+		}
+
+		if (!blending) cache.Disable(GL_BLEND);
+	}
+
+	void DebugDraw::Shutdown() {
+		auto& cache = GL::StateCache::Get();
+		auto& gl = GL::Device::Get();
+		for (GLuint* vao : { &m_lineVAO, &m_quadVAO }) {
+			if (!*vao) continue;
+			cache.ForgetVertexArray(*vao);
+			gl.DeleteVertexArray(*vao);
+			*vao = 0;
+		}
+		if (m_fallbackVBO) {
+			cache.ForgetBuffer(m_fallbackVBO);
+			gl.DeleteBuffer(m_fallbackVBO);
+			m_fallbackVBO = 0;
+		}
+	}
+
+} // namespace WanderSpire
@@ -0,0 +1,56 @@
+#include "WanderSpire/Graphics/FrameUniforms.h"
+#include "WanderSpire/Graphics/GLDevice.h"
+#include "WanderSpire/Graphics/GLStateCache.h"
+
+#include <cstring>
+
+namespace WanderSpire {
+
+	FrameUniforms& FrameUniforms::Get() {
+		static FrameUniforms instance;
+		return instance;
+	}
+
+	void FrameUniforms::BeginView(const glm::mat4& viewProjection) {
+		FrameUniformData data = m_Data;
+		data.viewProjection = viewProjection;
+
+		GLint viewport[4];
+		GL::StateCache::Get().GetViewport(viewport);
+		data.viewport = glm::vec4(viewport[0], viewport[1], viewport[2], viewport[3]);
+		data.time.x = std::chrono::duration<float>(std::chrono::steady_clock::now() - m_Start).count();
+
+		Update(data);
+	}
+
+	void FrameUniforms::Update(const FrameUniformData& data) {
+		auto& glState = GL::StateCache::Get();
+		auto& gl = GL::Device::Get();
+
+		if (m_Buffer == 0) {
+			m_Buffer = gl.GenBuffer();
+			glState.BindBuffer(GL_UNIFORM_BUFFER, m_Buffer);
+			gl.BufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniformData), nullptr, GL_DYNAMIC_DRAW);
+			m_Valid = false;
+		}
+
+		if (!m_Valid || std::memcmp(&data, &m_Data, sizeof(FrameUniformData)) != 0) {
+			m_Data = data;
+			glState.BindBuffer(GL_UNIFORM_BUFFER, m_Buffer);
+			gl.BufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniformData), &m_Data);
+			m_Valid = true;
+			++m_Uploads;
+		}
+
+		glState.BindBufferBase(GL_UNIFORM_BUFFER, BINDING, m_Buffer);
+	}
+
+	void FrameUniforms::Shutdown() {
+		if (m_Buffer == 0) return;
+		GL::StateCache::Get().ForgetBuffer(m_Buffer);
+		GL::Device::Get().DeleteBuffer(m_Buffer);
+		m_Buffer = 0;
+		m_Valid = false;
+	}
+
+} // namespace WanderSpire
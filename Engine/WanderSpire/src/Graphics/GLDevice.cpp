@@ -0,0 +1,172 @@
+#include "WanderSpire/Graphics/GLDevice.h"
+
+#include <cstring>
+
+namespace WanderSpire::GL {
+
+	namespace {
+
+		// ─────────────────────────────────────────────────────────────────────
+		// OpenGL device
+		// ─────────────────────────────────────────────────────────────────────
+
+		class OpenGLDevice final : public Device {
+		public:
+			// State, reached through the StateCache
+			void UseProgram(GLuint program) override { glUseProgram(program); }
+			void BindVertexArray(GLuint vao) override { glBindVertexArray(vao); }
+			void BindBuffer(GLenum target, GLuint buffer) override { glBindBuffer(target, buffer); }
+			void BindBufferBase(GLenum target, GLuint index, GLuint buffer) override { glBindBufferBase(target, index, buffer); }
+			void ActiveTexture(GLenum unit) override { glActiveTexture(unit); }
+			void BindTexture(GLenum target, GLuint texture) override { glBindTexture(target, texture); }
+			void Enable(GLenum cap) override { glEnable(cap); }
+			void Disable(GLenum cap) override { glDisable(cap); }
+			void BlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha) override {
+				glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+			}
+			void DepthFunc(GLenum func) override { glDepthFunc(func); }
+			void DepthMask(GLboolean mask) override { glDepthMask(mask); }
+			void Scissor(GLint x, GLint y, GLsizei width, GLsizei height) override { glScissor(x, y, width, height); }
+			void Viewport(GLint x, GLint y, GLsizei width, GLsizei height) override { glViewport(x, y, width, height); }
+			void BindFramebuffer(GLenum target, GLuint framebuffer) override { glBindFramebuffer(target, framebuffer); }
+			void ClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a) override { glClearColor(r, g, b, a); }
+			void GetIntegerv(GLenum pname, GLint* data) override { glGetIntegerv(pname, data); }
+			GLboolean IsEnabled(GLenum cap) override { return glIsEnabled(cap); }
+
+			// Objects
+			GLuint GenBuffer() override { GLuint name = 0; glGenBuffers(1, &name); return name; }
+			void DeleteBuffer(GLuint buffer) override { glDeleteBuffers(1, &buffer); }
+			GLuint GenVertexArray() override { GLuint name = 0; glGenVertexArrays(1, &name); return name; }
+			void DeleteVertexArray(GLuint vao) override { glDeleteVertexArrays(1, &vao); }
+			GLuint GenTexture() override { GLuint name = 0; glGenTextures(1, &name); return name; }
+			void DeleteTexture(GLuint texture) override { glDeleteTextures(1, &texture); }
+
+			// Buffers
+			void BufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) override {
+				glBufferData(target, size, data, usage);
+			}
+			void BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) override {
+				glBufferSubData(target, offset, size, data);
+			}
+			void BufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags) override {
+				glBufferStorage(target, size, data, flags);
+			}
+			void* MapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) override {
+				return glMapBufferRange(target, offset, length, access);
+			}
+			void UnmapBuffer(GLenum target) override { glUnmapBuffer(target); }
+
+			// Vertex layout
+			void EnableVertexAttribArray(GLuint index) override { glEnableVertexAttribArray(index); }
+			void VertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+				GLsizei stride, const void* pointer) override {
+				glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+			}
+			void VertexAttribDivisor(GLuint index, GLuint divisor) override { glVertexAttribDivisor(index, divisor); }
+
+			// Textures
+			void TexParameteri(GLenum target, GLenum pname, GLint param) override { glTexParameteri(target, pname, param); }
+			void TexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+				GLenum format, GLenum type, const void* pixels) override {
+				glTexImage2D(target, level, internalFormat, width, height, 0, format, type, pixels);
+			}
+			void TexSubImage2D(GLenum target, GLint level, GLint x, GLint y, GLsizei width, GLsizei height,
+				GLenum format, GLenum type, const void* pixels) override {
+				glTexSubImage2D(target, level, x, y, width, height, format, type, pixels);
+			}
+			void TexImage3D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+				GLsizei depth, GLenum format, GLenum type, const void* pixels) override {
+				glTexImage3D(target, level, internalFormat, width, height, depth, 0, format, type, pixels);
+			}
+			void TexSubImage3D(GLenum target, GLint level, GLint x, GLint y, GLint z,
+				GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void* pixels) override {
+				glTexSubImage3D(target, level, x, y, z, width, height, depth, format, type, pixels);
+			}
+
+			// Shaders and programs
+			GLuint CreateShader(GLenum type) override { return glCreateShader(type); }
+			void ShaderSource(GLuint shader, const char* source) override { glShaderSource(shader, 1, &source, nullptr); }
+			void CompileShader(GLuint shader) override { glCompileShader(shader); }
+			void GetShaderiv(GLuint shader, GLenum pname, GLint* value) override { glGetShaderiv(shader, pname, value); }
+			void GetShaderInfoLog(GLuint shader, GLsizei size, GLchar* log) override {
+				glGetShaderInfoLog(shader, size, nullptr, log);
+			}
+			void DeleteShader(GLuint shader) override { glDeleteShader(shader); }
+			GLuint CreateProgram() override { return glCreateProgram(); }
+			void AttachShader(GLuint program, GLuint shader) override { glAttachShader(program, shader); }
+			void LinkProgram(GLuint program) override { glLinkProgram(program); }
+			void GetProgramiv(GLuint program, GLenum pname, GLint* value) override { glGetProgramiv(program, pname, value); }
+			void GetProgramInfoLog(GLuint program, GLsizei size, GLchar* log) override {
+				glGetProgramInfoLog(program, size, nullptr, log);
+			}
+			void DeleteProgram(GLuint program) override { glDeleteProgram(program); }
+			GLint GetUniformLocation(GLuint program, const char* name) override { return glGetUniformLocation(program, name); }
+			GLuint GetUniformBlockIndex(GLuint program, const char* name) override { return glGetUniformBlockIndex(program, name); }
+			void UniformBlockBinding(GLuint program, GLuint block, GLuint binding) override {
+				glUniformBlockBinding(program, block, binding);
+			}
+
+			// Uniforms
+			void Uniform1i(GLint location, GLint value) override { glUniform1i(location, value); }
+			void Uniform1f(GLint location, GLfloat value) override { glUniform1f(location, value); }
+			void Uniform2f(GLint location, GLfloat x, GLfloat y) override { glUniform2f(location, x, y); }
+			void Uniform3f(GLint location, GLfloat x, GLfloat y, GLfloat z) override { glUniform3f(location, x, y, z); }
+			void UniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) override {
+				glUniformMatrix4fv(location, count, transpose, value);
+			}
+
+			// Drawing
+			void Clear(GLbitfield mask) override { glClear(mask); }
+			void DrawArrays(GLenum mode, GLint first, GLsizei count) override { glDrawArrays(mode, first, count); }
+			void DrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances) override {
+				glDrawArraysInstanced(mode, first, count, instances);
+			}
+			void DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) override {
+				glDrawElements(mode, count, type, indices);
+			}
+			void DrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices,
+				GLsizei instances) override {
+				glDrawElementsInstanced(mode, count, type, indices, instances);
+			}
+
+			// Synchronization and capabilities
+			GLsync FenceSync() override { return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0); }
+			GLenum ClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeoutNanos) override {
+				return glClientWaitSync(sync, flags, timeoutNanos);
+			}
+			void DeleteSync(GLsync sync) override { glDeleteSync(sync); }
+
+			bool SupportsBufferStorage() override {
+				if (!glBufferStorage) return false;
+				if (GLAD_GL_VERSION_4_4) return true;
+
+				GLint numExtensions = 0;
+				glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+				for (GLint i = 0; i < numExtensions; ++i) {
+					const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+					if (extension && std::strcmp(extension, "GL_ARB_buffer_storage") == 0) return true;
+				}
+				return false;
+			}
+		};
+
+		std::unique_ptr<Device>& Installed() {
+			static std::unique_ptr<Device> device = std::make_unique<OpenGLDevice>();
+			return device;
+		}
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Installation
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	Device& Device::Get() {
+		return *Installed();
+	}
+
+	void Device::Install(std::unique_ptr<Device> device) {
+		Installed() = device ? std::move(device) : std::make_unique<OpenGLDevice>();
+		StateCache::Get().Invalidate();
+	}
+
+} // namespace WanderSpire::GL
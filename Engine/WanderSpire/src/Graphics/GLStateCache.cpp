@@ -0,0 +1,326 @@
+#include "WanderSpire/Graphics/GLStateCache.h"
+#include "WanderSpire/Graphics/GLDevice.h"
+
+#include <iterator>
+
+namespace WanderSpire::GL {
+
+	namespace {
+
+		/// Forwards to whichever GL::Device is installed at the time of the call
+		class DeviceStateBackend final : public StateBackend {
+		public:
+			void UseProgram(GLuint program) override { Device::Get().UseProgram(program); }
+			void BindVertexArray(GLuint vao) override { Device::Get().BindVertexArray(vao); }
+			void BindBuffer(GLenum target, GLuint buffer) override { Device::Get().BindBuffer(target, buffer); }
+			void BindBufferBase(GLenum target, GLuint index, GLuint buffer) override { Device::Get().BindBufferBase(target, index, buffer); }
+			void ActiveTexture(GLenum unit) override { Device::Get().ActiveTexture(unit); }
+			void BindTexture(GLenum target, GLuint texture) override { Device::Get().BindTexture(target, texture); }
+			void Enable(GLenum cap) override { Device::Get().Enable(cap); }
+			void Disable(GLenum cap) override { Device::Get().Disable(cap); }
+			void BlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha) override {
+				Device::Get().BlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+			}
+			void DepthFunc(GLenum func) override { Device::Get().DepthFunc(func); }
+			void DepthMask(GLboolean mask) override { Device::Get().DepthMask(mask); }
+			void Scissor(GLint x, GLint y, GLsizei width, GLsizei height) override { Device::Get().Scissor(x, y, width, height); }
+			void Viewport(GLint x, GLint y, GLsizei width, GLsizei height) override { Device::Get().Viewport(x, y, width, height); }
+			void BindFramebuffer(GLenum target, GLuint framebuffer) override { Device::Get().BindFramebuffer(target, framebuffer); }
+			void ClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a) override { Device::Get().ClearColor(r, g, b, a); }
+			void GetIntegerv(GLenum pname, GLint* data) override { Device::Get().GetIntegerv(pname, data); }
+			GLboolean IsEnabled(GLenum cap) override { return Device::Get().IsEnabled(cap); }
+		};
+
+		constexpr GLenum TRACKED_BUFFERS[] = {
+			GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_UNIFORM_BUFFER, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+			GL_PIXEL_PACK_BUFFER, GL_PIXEL_UNPACK_BUFFER, GL_TEXTURE_BUFFER, GL_DRAW_INDIRECT_BUFFER, GL_SHADER_STORAGE_BUFFER,
+		};
+		constexpr GLenum BUFFER_BINDING_QUERIES[] = {
+			GL_ARRAY_BUFFER_BINDING, GL_ELEMENT_ARRAY_BUFFER_BINDING, GL_UNIFORM_BUFFER_BINDING, GL_COPY_READ_BUFFER_BINDING,
+			GL_COPY_WRITE_BUFFER_BINDING, GL_PIXEL_PACK_BUFFER_BINDING, GL_PIXEL_UNPACK_BUFFER_BINDING, GL_TEXTURE_BUFFER_BINDING,
+			GL_DRAW_INDIRECT_BUFFER_BINDING, GL_SHADER_STORAGE_BUFFER_BINDING,
+		};
+
+		constexpr GLenum TRACKED_TEXTURES[] = { GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BUFFER };
+		constexpr GLenum TEXTURE_BINDING_QUERIES[] = { GL_TEXTURE_BINDING_2D, GL_TEXTURE_BINDING_2D_ARRAY, GL_TEXTURE_BINDING_BUFFER };
+
+		constexpr GLenum TRACKED_CAPABILITIES[] = { GL_BLEND, GL_DEPTH_TEST, GL_SCISSOR_TEST, GL_CULL_FACE, GL_STENCIL_TEST };
+
+		template <typename Array, typename Value>
+		int IndexOf(const Array& values, Value value) {
+			for (size_t i = 0; i < std::size(values); ++i) {
+				if (values[i] == value) return static_cast<int>(i);
+			}
+			return -1;
+		}
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Setup
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	StateCache& StateCache::Get() {
+		static StateCache instance;
+		return instance;
+	}
+
+	StateCache::StateCache() : m_backend(std::make_unique<DeviceStateBackend>()) {
+		Invalidate();
+		m_stats = StateCacheStats{};
+	}
+
+	void StateCache::SetBackend(std::unique_ptr<StateBackend> backend) {
+		m_backend = backend ? std::move(backend) : std::make_unique<DeviceStateBackend>();
+		Invalidate();
+	}
+
+	void StateCache::Invalidate() {
+		m_program = UNKNOWN;
+		m_vertexArray = UNKNOWN;
+		m_buffers.fill(UNKNOWN);
+		m_uniformBindings.fill(UNKNOWN);
+		m_activeUnit = UNKNOWN;
+		for (auto& unit : m_textures) unit.fill(UNKNOWN);
+		m_drawFramebuffer = UNKNOWN;
+		m_readFramebuffer = UNKNOWN;
+		m_capabilities.fill(Tri::Unknown);
+		m_blendKnown = false;
+		m_depthFunc = 0;
+		m_depthMask = Tri::Unknown;
+		m_scissorKnown = false;
+		m_viewportKnown = false;
+		m_clearColorKnown = false;
+		++m_stats.invalidations;
+	}
+
+	bool StateCache::Redundant(StateKind kind, bool unchanged) {
+		const auto k = static_cast<size_t>(kind);
+		++m_stats.requested[k];
+		if (unchanged) ++m_stats.skipped[k];
+		return unchanged;
+	}
+
+	GLuint StateCache::Query(GLenum pname) {
+		GLint value = 0;
+		m_backend->GetIntegerv(pname, &value);
+		++m_stats.queries;
+		return static_cast<GLuint>(value);
+	}
+
+	int StateCache::BufferSlot(GLenum target) { return IndexOf(TRACKED_BUFFERS, target); }
+	int StateCache::TextureSlot(GLenum target) { return IndexOf(TRACKED_TEXTURES, target); }
+	int StateCache::CapabilitySlot(GLenum cap) { return IndexOf(TRACKED_CAPABILITIES, cap); }
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Bindings
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void StateCache::UseProgram(GLuint program) {
+		if (Redundant(StateKind::Program, m_program == program)) return;
+		m_backend->UseProgram(program);
+		m_program = program;
+	}
+
+	void StateCache::BindVertexArray(GLuint vao) {
+		if (Redundant(StateKind::VertexArray, m_vertexArray == vao)) return;
+		m_backend->BindVertexArray(vao);
+		m_vertexArray = vao;
+		m_buffers[BufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+	}
+
+	void StateCache::BindBuffer(GLenum target, GLuint buffer) {
+		const int slot = BufferSlot(target);
+		if (Redundant(StateKind::Buffer, slot >= 0 && m_buffers[slot] == buffer)) return;
+		m_backend->BindBuffer(target, buffer);
+		if (slot >= 0) m_buffers[slot] = buffer;
+	}
+
+	void StateCache::BindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+		const bool tracked = target == GL_UNIFORM_BUFFER && index < MAX_UNIFORM_BINDINGS;
+		if (Redundant(StateKind::Buffer, tracked && m_uniformBindings[index] == buffer)) return;
+		m_backend->BindBufferBase(target, index, buffer);
+		if (tracked) m_uniformBindings[index] = buffer;
+		if (const int slot = BufferSlot(target); slot >= 0) m_buffers[slot] = buffer;
+	}
+
+	void StateCache::ActiveTexture(GLuint unit) {
+		if (Redundant(StateKind::Texture, m_activeUnit == unit)) return;
+		m_backend->ActiveTexture(GL_TEXTURE0 + unit);
+		m_activeUnit = unit;
+	}
+
+	void StateCache::BindTexture(GLenum target, GLuint texture, GLuint unit) {
+		const int slot = unit < MAX_TEXTURE_UNITS ? TextureSlot(target) : -1;
+		if (Redundant(StateKind::Texture, slot >= 0 && m_textures[unit][slot] == texture)) return;
+		ActiveTexture(unit);
+		m_backend->BindTexture(target, texture);
+		if (slot >= 0) m_textures[unit][slot] = texture;
+	}
+
+	void StateCache::BindFramebuffer(GLenum target, GLuint framebuffer) {
+		const bool draw = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+		const bool read = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+		const bool unchanged = (!draw || m_drawFramebuffer == framebuffer) && (!read || m_readFramebuffer == framebuffer);
+		if (Redundant(StateKind::Framebuffer, unchanged)) return;
+		m_backend->BindFramebuffer(target, framebuffer);
+		if (draw) m_drawFramebuffer = framebuffer;
+		if (read) m_readFramebuffer = framebuffer;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Fixed-function state
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void StateCache::SetEnabled(GLenum cap, bool enabled) {
+		const int slot = CapabilitySlot(cap);
+		const Tri wanted = enabled ? Tri::On : Tri::Off;
+		if (Redundant(StateKind::Capability, slot >= 0 && m_capabilities[slot] == wanted)) return;
+		if (enabled) m_backend->Enable(cap);
+		else m_backend->Disable(cap);
+		if (slot >= 0) m_capabilities[slot] = wanted;
+	}
+
+	void StateCache::BlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha) {
+		const std::array<GLenum, 4> blend{ srcRGB, dstRGB, srcAlpha, dstAlpha };
+		if (Redundant(StateKind::Blend, m_blendKnown && m_blend == blend)) return;
+		m_backend->BlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+		m_blend = blend;
+		m_blendKnown = true;
+	}
+
+	void StateCache::DepthFunc(GLenum func) {
+		if (Redundant(StateKind::Depth, m_depthFunc == func)) return;
+		m_backend->DepthFunc(func);
+		m_depthFunc = func;
+	}
+
+	void StateCache::DepthMask(bool mask) {
+		const Tri wanted = mask ? Tri::On : Tri::Off;
+		if (Redundant(StateKind::Depth, m_depthMask == wanted)) return;
+		m_backend->DepthMask(mask ? GL_TRUE : GL_FALSE);
+		m_depthMask = wanted;
+	}
+
+	void StateCache::Scissor(GLint x, GLint y, GLsizei width, GLsizei height) {
+		const std::array<GLint, 4> box{ x, y, width, height };
+		if (Redundant(StateKind::Scissor, m_scissorKnown && m_scissor == box)) return;
+		m_backend->Scissor(x, y, width, height);
+		m_scissor = box;
+		m_scissorKnown = true;
+	}
+
+	void StateCache::Viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+		const std::array<GLint, 4> box{ x, y, width, height };
+		if (Redundant(StateKind::Viewport, m_viewportKnown && m_viewport == box)) return;
+		m_backend->Viewport(x, y, width, height);
+		m_viewport = box;
+		m_viewportKnown = true;
+	}
+
+	void StateCache::ClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a) {
+		const std::array<GLfloat, 4> color{ r, g, b, a };
+		if (Redundant(StateKind::ClearColor, m_clearColorKnown && m_clearColor == color)) return;
+		m_backend->ClearColor(r, g, b, a);
+		m_clearColor = color;
+		m_clearColorKnown = true;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Current state
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	GLuint StateCache::GetProgram() {
+		if (m_program == UNKNOWN) m_program = Query(GL_CURRENT_PROGRAM);
+		return m_program;
+	}
+
+	GLuint StateCache::GetVertexArray() {
+		if (m_vertexArray == UNKNOWN) m_vertexArray = Query(GL_VERTEX_ARRAY_BINDING);
+		return m_vertexArray;
+	}
+
+	GLuint StateCache::GetBuffer(GLenum target) {
+		const int slot = BufferSlot(target);
+		if (slot < 0) return Query(GL_ARRAY_BUFFER_BINDING);
+		if (m_buffers[slot] == UNKNOWN) m_buffers[slot] = Query(BUFFER_BINDING_QUERIES[slot]);
+		return m_buffers[slot];
+	}
+
+	GLuint StateCache::GetActiveTexture() {
+		if (m_activeUnit == UNKNOWN) m_activeUnit = Query(GL_ACTIVE_TEXTURE) - GL_TEXTURE0;
+		return m_activeUnit;
+	}
+
+	GLuint StateCache::GetTexture(GLenum target, GLuint unit) {
+		const int slot = unit < MAX_TEXTURE_UNITS ? TextureSlot(target) : -1;
+		if (slot >= 0 && m_textures[unit][slot] != UNKNOWN) return m_textures[unit][slot];
+
+		// Bindings are per unit: query on that unit
+		ActiveTexture(unit);
+		const GLuint texture = Query(slot >= 0 ? TEXTURE_BINDING_QUERIES[slot] : GL_TEXTURE_BINDING_2D);
+		if (slot >= 0) m_textures[unit][slot] = texture;
+		return texture;
+	}
+
+	GLuint StateCache::GetFramebuffer(GLenum target) {
+		if (target == GL_READ_FRAMEBUFFER) {
+			if (m_readFramebuffer == UNKNOWN) m_readFramebuffer = Query(GL_READ_FRAMEBUFFER_BINDING);
+			return m_readFramebuffer;
+		}
+		if (m_drawFramebuffer == UNKNOWN) m_drawFramebuffer = Query(GL_DRAW_FRAMEBUFFER_BINDING);
+		return m_drawFramebuffer;
+	}
+
+	bool StateCache::IsEnabled(GLenum cap) {
+		const int slot = CapabilitySlot(cap);
+		if (slot >= 0 && m_capabilities[slot] != Tri::Unknown) return m_capabilities[slot] == Tri::On;
+
+		const bool enabled = m_backend->IsEnabled(cap) == GL_TRUE;
+		++m_stats.queries;
+		if (slot >= 0) m_capabilities[slot] = enabled ? Tri::On : Tri::Off;
+		return enabled;
+	}
+
+	void StateCache::GetViewport(GLint out[4]) {
+		if (!m_viewportKnown) {
+			m_backend->GetIntegerv(GL_VIEWPORT, m_viewport.data());
+			++m_stats.queries;
+			m_viewportKnown = true;
+		}
+		for (int i = 0; i < 4; ++i) out[i] = m_viewport[i];
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Deleted objects
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	// Marking the state unknown (rather than 0) also covers programs, which
+	// GL keeps current after deletion, and names reused by the next glGen*
+
+	void StateCache::ForgetProgram(GLuint program) {
+		if (m_program == program) m_program = UNKNOWN;
+	}
+
+	void StateCache::ForgetVertexArray(GLuint vao) {
+		if (m_vertexArray == vao) {
+			m_vertexArray = UNKNOWN;
+			m_buffers[BufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+		}
+	}
+
+	void StateCache::ForgetBuffer(GLuint buffer) {
+		for (auto& bound : m_buffers) if (bound == buffer) bound = UNKNOWN;
+		for (auto& bound : m_uniformBindings) if (bound == buffer) bound = UNKNOWN;
+	}
+
+	void StateCache::ForgetTexture(GLuint texture) {
+		for (auto& unit : m_textures)
+			for (auto& bound : unit) if (bound == texture) bound = UNKNOWN;
+	}
+
+	void StateCache::ForgetFramebuffer(GLuint framebuffer) {
+		if (m_drawFramebuffer == framebuffer) m_drawFramebuffer = UNKNOWN;
+		if (m_readFramebuffer == framebuffer) m_readFramebuffer = UNKNOWN;
+	}
+
+} // namespace WanderSpire::GL
@@ -1,5 +1,8 @@
 ﻿#include "WanderSpire/Graphics/InstanceRenderer.h"
 #include "WanderSpire/Graphics/Shader.h"
+#include "WanderSpire/Graphics/GLDevice.h"
+#include "WanderSpire/Graphics/GLStateCache.h"
+#include "WanderSpire/Graphics/StreamBuffer.h"
 #include <spdlog/spdlog.h>
 #include <cstring>
 
@@ -16,13 +19,17 @@ namespace WanderSpire {
 		, m_CurrentShader(other.m_CurrentShader)
 		, m_CurrentVAO(other.m_CurrentVAO)
 		, m_CurrentEBO(other.m_CurrentEBO)
-		, m_AttributesSetup(other.m_AttributesSetup)
+		, m_UniformShader(other.m_UniformShader)
+		, m_UseInstancingUniform(other.m_UseInstancingUniform)
+		, m_TileSizeUniform(other.m_TileSizeUniform)
+		, m_UseTextureArrayUniform(other.m_UseTextureArrayUniform)
+		, m_TextureArrayUniform(other.m_TextureArrayUniform)
 	{
 		other.m_InstanceVBO = 0;
 		other.m_CurrentShader = nullptr;
 		other.m_CurrentVAO = 0;
 		other.m_CurrentEBO = 0;
-		other.m_AttributesSetup = false;
+		other.m_UniformShader = nullptr;
 	}
 
 	InstanceRenderer& InstanceRenderer::operator=(InstanceRenderer&& other) noexcept {
@@ -33,13 +40,17 @@ namespace WanderSpire {
 			m_CurrentShader = other.m_CurrentShader;
 			m_CurrentVAO = other.m_CurrentVAO;
 			m_CurrentEBO = other.m_CurrentEBO;
-			m_AttributesSetup = other.m_AttributesSetup;
+			m_UniformShader = other.m_UniformShader;
+			m_UseInstancingUniform = other.m_UseInstancingUniform;
+			m_TileSizeUniform = other.m_TileSizeUniform;
+			m_UseTextureArrayUniform = other.m_UseTextureArrayUniform;
+			m_TextureArrayUniform = other.m_TextureArrayUniform;
 
 			other.m_InstanceVBO = 0;
 			other.m_CurrentShader = nullptr;
 			other.m_CurrentVAO = 0;
 			other.m_CurrentEBO = 0;
-			other.m_AttributesSetup = false;
+			other.m_UniformShader = nullptr;
 		}
 		return *this;
 	}
@@ -59,97 +70,118 @@ namespace WanderSpire {
 			return;
 		}
 
-		// Create VBO on first use
-		if (m_InstanceVBO == 0) {
-			glGenBuffers(1, &m_InstanceVBO);
-			spdlog::debug("[InstanceRenderer] Created instance VBO: {}", m_InstanceVBO);
+		// Create the stream buffer on first use
+		auto& stream = StreamBuffer::Get();
+		if (!stream.IsInitialized() && !m_InstanceVBO && !stream.Initialize()) {
+			m_InstanceVBO = GL::Device::Get().GenBuffer();
+			spdlog::warn("[InstanceRenderer] Stream buffer unavailable, using instance VBO: {}", m_InstanceVBO);
 		}
 
-		glBindVertexArray(m_CurrentVAO);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_CurrentEBO);
-
-		// Setup vertex attributes on first use
-		if (!m_AttributesSetup) {
-			SetupVertexAttributes();
-			m_AttributesSetup = true;
+		if (m_UniformShader != m_CurrentShader) {
+			m_UseInstancingUniform = m_CurrentShader->DeclareUniform("u_UseInstancing");
+			m_TileSizeUniform = m_CurrentShader->DeclareUniform("u_TileSize");
+			m_UseTextureArrayUniform = m_CurrentShader->DeclareUniform("u_UseTextureArray");
+			m_TextureArrayUniform = m_CurrentShader->DeclareUniform("u_TextureArray");
+			m_UniformShader = m_CurrentShader;
 		}
+		if (m_CurrentShader->GetID()) m_CurrentShader->Bind();
+
+		GL::StateCache::Get().BindVertexArray(m_CurrentVAO);
+		GL::StateCache::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_CurrentEBO);
 	}
 
 	void InstanceRenderer::RenderInstances(GLuint textureID,
 		const std::vector<InstanceData>& instances,
-		float tileSize) {
+		float tileSize,
+		GLenum textureTarget) {
 		if (!m_CurrentShader || instances.empty()) return;
 
-		// Upload instance data
-		glBindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
-		glBufferData(GL_ARRAY_BUFFER,
-			instances.size() * sizeof(InstanceData),
-			instances.data(),
-			GL_DYNAMIC_DRAW);
+		// Upload instance data: a copy into this frame's part of the stream buffer
+		const size_t bytes = instances.size() * sizeof(InstanceData);
+		auto upload = StreamBuffer::Get().Upload(instances.data(), bytes, StreamUsage::Instance);
+		if (upload) {
+			SetupVertexAttributes(upload.buffer, upload.offset);
+		}
+		else {
+			if (m_InstanceVBO == 0) m_InstanceVBO = GL::Device::Get().GenBuffer();
+			GL::StateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
+			GL::Device::Get().BufferData(GL_ARRAY_BUFFER, bytes, instances.data(), GL_DYNAMIC_DRAW);
+			SetupVertexAttributes(m_InstanceVBO, 0);
+		}
 
 		// Set uniforms
-		m_CurrentShader->SetUniformInt("u_UseInstancing", 1);
-		m_CurrentShader->SetUniformFloat("u_TileSize", tileSize);
-
-		// Bind texture
+		m_CurrentShader->Set(m_UseInstancingUniform, 1);
+		m_CurrentShader->Set(m_TileSizeUniform, tileSize);
+
+		// Bind texture; arrays go to unit 1 so both sampler types keep their own unit
+		const bool useArray = textureTarget == GL_TEXTURE_2D_ARRAY;
+		m_CurrentShader->Set(m_UseTextureArrayUniform, useArray ? 1 : 0);
+		if (useArray) {
+			m_CurrentShader->Set(m_TextureArrayUniform, 1);
+		}
 		if (textureID != 0) {
-			glActiveTexture(GL_TEXTURE0);
-			glBindTexture(GL_TEXTURE_2D, textureID);
+			GL::StateCache::Get().BindTexture(textureTarget, textureID, useArray ? 1 : 0);
 		}
 
 		// Draw instances
-		glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT,
+		GL::Device::Get().DrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT,
 			nullptr, static_cast<GLsizei>(instances.size()));
 	}
 
 	void InstanceRenderer::EndFrame() {
 		if (m_CurrentShader) {
-			m_CurrentShader->SetUniformInt("u_UseInstancing", 0);
+			m_CurrentShader->Set(m_UseInstancingUniform, 0);
 		}
 
-		glBindVertexArray(0);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		GL::StateCache::Get().BindVertexArray(0);
+		GL::StateCache::Get().BindBuffer(GL_ARRAY_BUFFER, 0);
 
 		m_CurrentShader = nullptr;
 		m_CurrentVAO = 0;
 		m_CurrentEBO = 0;
 	}
 
-	void InstanceRenderer::SetupVertexAttributes() {
-		if (m_InstanceVBO == 0) return;
+	void InstanceRenderer::SetupVertexAttributes(GLuint buffer, size_t offset) {
+		if (buffer == 0) return;
 
-		glBindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
+		// Each upload lands at a different offset, so the pointers are re-issued per draw
+		GL::StateCache::Get().BindBuffer(GL_ARRAY_BUFFER, buffer);
 
 		const GLsizei stride = sizeof(InstanceData);
+		auto& gl = GL::Device::Get();
 
 		// Position (location 2)
-		glEnableVertexAttribArray(2);
-		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride,
-			reinterpret_cast<void*>(offsetof(InstanceData, position)));
-		glVertexAttribDivisor(2, 1);
+		gl.EnableVertexAttribArray(2);
+		gl.VertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride,
+			reinterpret_cast<void*>(offset + offsetof(InstanceData, position)));
+		gl.VertexAttribDivisor(2, 1);
 
 		// UV Offset (location 3)
-		glEnableVertexAttribArray(3);
-		glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, stride,
-			reinterpret_cast<void*>(offsetof(InstanceData, uvOffset)));
-		glVertexAttribDivisor(3, 1);
+		gl.EnableVertexAttribArray(3);
+		gl.VertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, stride,
+			reinterpret_cast<void*>(offset + offsetof(InstanceData, uvOffset)));
+		gl.VertexAttribDivisor(3, 1);
 
 		// UV Size (location 4)
-		glEnableVertexAttribArray(4);
-		glVertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE, stride,
-			reinterpret_cast<void*>(offsetof(InstanceData, uvSize)));
-		glVertexAttribDivisor(4, 1);
-
-		spdlog::debug("[InstanceRenderer] Setup vertex attributes for VBO: {}", m_InstanceVBO);
+		gl.EnableVertexAttribArray(4);
+		gl.VertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE, stride,
+			reinterpret_cast<void*>(offset + offsetof(InstanceData, uvSize)));
+		gl.VertexAttribDivisor(4, 1);
+
+		// Layer (location 5)
+		gl.EnableVertexAttribArray(5);
+		gl.VertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, stride,
+			reinterpret_cast<void*>(offset + offsetof(InstanceData, layer)));
+		gl.VertexAttribDivisor(5, 1);
 	}
 
 	void InstanceRenderer::CleanupResources() {
 		if (m_InstanceVBO != 0) {
-			glDeleteBuffers(1, &m_InstanceVBO);
+			GL::StateCache::Get().ForgetBuffer(m_InstanceVBO);
+			GL::Device::Get().DeleteBuffer(m_InstanceVBO);
 			spdlog::debug("[InstanceRenderer] Deleted VBO: {}", m_InstanceVBO);
 			m_InstanceVBO = 0;
 		}
-		m_AttributesSetup = false;
 	}
 
 } // namespace WanderSpire
\ No newline at end of file
@@ -0,0 +1,1066 @@
+#include "WanderSpire/Graphics/RecordingDevice.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <spdlog/spdlog.h>
+
+namespace WanderSpire::GL {
+
+	namespace {
+
+		// ─────────────────────────────────────────────────────────────────────
+		// Describing calls
+		// ─────────────────────────────────────────────────────────────────────
+
+		/// Arguments the log spells out by name
+		struct Enum { GLenum value; };
+		struct Mode { GLenum value; };
+		struct Factor { GLenum value; };
+
+		std::string EnumName(GLenum value) {
+			switch (value) {
+			case GL_ARRAY_BUFFER: return "ARRAY_BUFFER";
+			case GL_ELEMENT_ARRAY_BUFFER: return "ELEMENT_ARRAY_BUFFER";
+			case GL_UNIFORM_BUFFER: return "UNIFORM_BUFFER";
+			case GL_COPY_READ_BUFFER: return "COPY_READ_BUFFER";
+			case GL_COPY_WRITE_BUFFER: return "COPY_WRITE_BUFFER";
+			case GL_PIXEL_PACK_BUFFER: return "PIXEL_PACK_BUFFER";
+			case GL_PIXEL_UNPACK_BUFFER: return "PIXEL_UNPACK_BUFFER";
+			case GL_TEXTURE_BUFFER: return "TEXTURE_BUFFER";
+			case GL_DRAW_INDIRECT_BUFFER: return "DRAW_INDIRECT_BUFFER";
+			case GL_SHADER_STORAGE_BUFFER: return "SHADER_STORAGE_BUFFER";
+			case GL_STATIC_DRAW: return "STATIC_DRAW";
+			case GL_DYNAMIC_DRAW: return "DYNAMIC_DRAW";
+			case GL_STREAM_DRAW: return "STREAM_DRAW";
+			case GL_TEXTURE_2D: return "TEXTURE_2D";
+			case GL_TEXTURE_2D_ARRAY: return "TEXTURE_2D_ARRAY";
+			case GL_TEXTURE_WRAP_S: return "TEXTURE_WRAP_S";
+			case GL_TEXTURE_WRAP_T: return "TEXTURE_WRAP_T";
+			case GL_TEXTURE_MIN_FILTER: return "TEXTURE_MIN_FILTER";
+			case GL_TEXTURE_MAG_FILTER: return "TEXTURE_MAG_FILTER";
+			case GL_CLAMP_TO_EDGE: return "CLAMP_TO_EDGE";
+			case GL_REPEAT: return "REPEAT";
+			case GL_NEAREST: return "NEAREST";
+			case GL_LINEAR: return "LINEAR";
+			case GL_BLEND: return "BLEND";
+			case GL_DEPTH_TEST: return "DEPTH_TEST";
+			case GL_SCISSOR_TEST: return "SCISSOR_TEST";
+			case GL_CULL_FACE: return "CULL_FACE";
+			case GL_STENCIL_TEST: return "STENCIL_TEST";
+			case GL_BYTE: return "BYTE";
+			case GL_UNSIGNED_BYTE: return "UNSIGNED_BYTE";
+			case GL_SHORT: return "SHORT";
+			case GL_UNSIGNED_SHORT: return "UNSIGNED_SHORT";
+			case GL_INT: return "INT";
+			case GL_UNSIGNED_INT: return "UNSIGNED_INT";
+			case GL_FLOAT: return "FLOAT";
+			case GL_HALF_FLOAT: return "HALF_FLOAT";
+			case GL_RED: return "RED";
+			case GL_RG: return "RG";
+			case GL_RGB: return "RGB";
+			case GL_RGBA: return "RGBA";
+			case GL_RGBA8: return "RGBA8";
+			case GL_RGBA32F: return "RGBA32F";
+			case GL_R32I: return "R32I";
+			case GL_RED_INTEGER: return "RED_INTEGER";
+			case GL_DEPTH_COMPONENT: return "DEPTH_COMPONENT";
+			case GL_DEPTH_COMPONENT24: return "DEPTH_COMPONENT24";
+			case GL_VERTEX_SHADER: return "VERTEX_SHADER";
+			case GL_FRAGMENT_SHADER: return "FRAGMENT_SHADER";
+			case GL_FRAMEBUFFER: return "FRAMEBUFFER";
+			case GL_READ_FRAMEBUFFER: return "READ_FRAMEBUFFER";
+			case GL_NEVER: return "NEVER";
+			case GL_LESS: return "LESS";
+			case GL_EQUAL: return "EQUAL";
+			case GL_LEQUAL: return "LEQUAL";
+			case GL_GREATER: return "GREATER";
+			case GL_ALWAYS: return "ALWAYS";
+			default: return fmt::format("0x{:04X}", value);
+			}
+		}
+
+		std::string ModeName(GLenum mode) {
+			switch (mode) {
+			case GL_POINTS: return "POINTS";
+			case GL_LINES: return "LINES";
+			case GL_LINE_LOOP: return "LINE_LOOP";
+			case GL_LINE_STRIP: return "LINE_STRIP";
+			case GL_TRIANGLES: return "TRIANGLES";
+			case GL_TRIANGLE_STRIP: return "TRIANGLE_STRIP";
+			case GL_TRIANGLE_FAN: return "TRIANGLE_FAN";
+			default: return fmt::format("0x{:04X}", mode);
+			}
+		}
+
+		std::string FactorName(GLenum factor) {
+			switch (factor) {
+			case GL_ZERO: return "ZERO";
+			case GL_ONE: return "ONE";
+			case GL_SRC_COLOR: return "SRC_COLOR";
+			case GL_ONE_MINUS_SRC_COLOR: return "ONE_MINUS_SRC_COLOR";
+			case GL_SRC_ALPHA: return "SRC_ALPHA";
+			case GL_ONE_MINUS_SRC_ALPHA: return "ONE_MINUS_SRC_ALPHA";
+			case GL_DST_ALPHA: return "DST_ALPHA";
+			case GL_ONE_MINUS_DST_ALPHA: return "ONE_MINUS_DST_ALPHA";
+			case GL_DST_COLOR: return "DST_COLOR";
+			case GL_ONE_MINUS_DST_COLOR: return "ONE_MINUS_DST_COLOR";
+			default: return fmt::format("0x{:04X}", factor);
+			}
+		}
+
+		void Append(std::string& out, const Enum& value) { out += EnumName(value.value); }
+		void Append(std::string& out, const Mode& value) { out += ModeName(value.value); }
+		void Append(std::string& out, const Factor& value) { out += FactorName(value.value); }
+		void Append(std::string& out, const char* text) { out += text; }
+		void Append(std::string& out, const std::string& text) { out += text; }
+		void Append(std::string& out, bool value) { out += value ? "true" : "false"; }
+
+		template <typename T>
+			requires std::is_arithmetic_v<T>
+		void Append(std::string& out, T value) {
+			fmt::format_to(std::back_inserter(out), "{}", value);
+		}
+
+		/// Data pointers are logged by presence only, so logs do not depend on addresses
+		const char* Data(const void* data) { return data ? "data" : "null"; }
+		/// Offsets passed as pointers
+		size_t Offset(const void* pointer) { return reinterpret_cast<uintptr_t>(pointer); }
+
+		size_t TypeSize(GLenum type) {
+			switch (type) {
+			case GL_BYTE: case GL_UNSIGNED_BYTE: return 1;
+			case GL_SHORT: case GL_UNSIGNED_SHORT: case GL_HALF_FLOAT: return 2;
+			default: return 4;
+			}
+		}
+
+		size_t Components(GLenum format) {
+			switch (format) {
+			case GL_RED: case GL_RED_INTEGER: case GL_DEPTH_COMPONENT: return 1;
+			case GL_RG: return 2;
+			case GL_RGB: return 3;
+			default: return 4;
+			}
+		}
+
+		size_t ImageBytes(GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type) {
+			return static_cast<size_t>(width) * static_cast<size_t>(height) * static_cast<size_t>(depth) *
+				Components(format) * TypeSize(type);
+		}
+
+		const char* KindName(uint8_t kind) {
+			static const char* const names[] = { "buffer", "vertex array", "texture", "shader", "program" };
+			return names[kind];
+		}
+
+		// ─────────────────────────────────────────────────────────────────────
+		// Compiling
+		// ─────────────────────────────────────────────────────────────────────
+
+		bool IsIdentifierChar(char c) {
+			return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+		}
+
+		/// Identifiers and single punctuation characters, comments skipped
+		std::vector<std::string> Tokenize(const std::string& source) {
+			std::vector<std::string> tokens;
+			for (size_t i = 0; i < source.size();) {
+				const char c = source[i];
+				if (source.compare(i, 2, "//") == 0) {
+					i = source.find('\n', i);
+					if (i == std::string::npos) break;
+				}
+				else if (source.compare(i, 2, "/*") == 0) {
+					i = source.find("*/", i + 2);
+					if (i == std::string::npos) break;
+					i += 2;
+				}
+				else if (IsIdentifierChar(c)) {
+					size_t end = i;
+					while (end < source.size() && IsIdentifierChar(source[end])) ++end;
+					tokens.emplace_back(source, i, end - i);
+					i = end;
+				}
+				else {
+					if (!std::isspace(static_cast<unsigned char>(c))) tokens.emplace_back(1, c);
+					++i;
+				}
+			}
+			return tokens;
+		}
+
+		/// Collect `uniform <type> <name>` and `uniform <Block> {` declarations
+		void ScanUniforms(const std::string& source, std::vector<std::string>& uniforms, std::vector<std::string>& blocks) {
+			const auto tokens = Tokenize(source);
+			auto add = [](std::vector<std::string>& names, const std::string& name) {
+				if (std::find(names.begin(), names.end(), name) == names.end()) names.push_back(name);
+			};
+
+			for (size_t i = 0; i + 2 < tokens.size(); ++i) {
+				if (tokens[i] != "uniform") continue;
+				size_t next = i + 1;
+				while (next < tokens.size() &&
+					(tokens[next] == "lowp" || tokens[next] == "mediump" || tokens[next] == "highp")) ++next;
+				if (next + 1 >= tokens.size()) break;
+
+				if (tokens[next + 1] == "{") add(blocks, tokens[next]);
+				else if (IsIdentifierChar(tokens[next + 1][0])) add(uniforms, tokens[next + 1]);
+			}
+		}
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Inspection
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	RecordingDevice::RecordingDevice(const RecordingDeviceCaps& caps)
+		: m_caps(caps)
+	{
+	}
+
+	std::vector<std::string> RecordingDevice::TakeLog() {
+		return std::exchange(m_log, {});
+	}
+
+	std::vector<std::string> RecordingDevice::GetLiveObjects() const {
+		std::vector<std::pair<GLuint, const Object*>> live;
+		for (const auto& [name, object] : m_objects) live.emplace_back(name, &object);
+		std::sort(live.begin(), live.end());
+
+		std::vector<std::string> out;
+		for (const auto& [name, object] : live) {
+			std::string line = fmt::format("{} {}", KindName(static_cast<uint8_t>(object->kind)), name);
+			if (object->kind == Kind::Buffer) line += fmt::format(" ({} bytes)", object->data.size());
+			if (object->kind == Kind::Texture) line += fmt::format(" ({}x{}x{})", object->width, object->height, object->depth);
+			out.push_back(std::move(line));
+		}
+		return out;
+	}
+
+	const std::vector<uint8_t>* RecordingDevice::GetBufferContents(GLuint buffer) const {
+		auto it = m_objects.find(buffer);
+		return it != m_objects.end() && it->second.kind == Kind::Buffer ? &it->second.data : nullptr;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Helpers
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	template <typename... Args>
+	void RecordingDevice::Record(const char* call, const Args&... args) {
+		++m_stats.calls;
+		if (!m_logging) return;
+
+		std::string line = call;
+		line += '(';
+		bool first = true;
+		((line += first ? "" : ", ", Append(line, args), first = false), ...);
+		line += ')';
+		m_log.push_back(std::move(line));
+	}
+
+	void RecordingDevice::Error(const std::string& message) {
+		++m_stats.errors;
+		spdlog::warn("[RecordingDevice] {}", message);
+		m_errors.push_back(message);
+		if (m_logging) m_log.push_back("! " + message);
+	}
+
+	RecordingDevice::Object* RecordingDevice::Find(GLuint name, Kind kind, const char* call) {
+		auto it = m_objects.find(name);
+		if (it == m_objects.end()) {
+			Error(fmt::format("{}: {} is not a live object", call, name));
+			return nullptr;
+		}
+		if (it->second.kind != kind) {
+			Error(fmt::format("{}: {} is a {}, not a {}", call, name,
+				KindName(static_cast<uint8_t>(it->second.kind)), KindName(static_cast<uint8_t>(kind))));
+			return nullptr;
+		}
+		return &it->second;
+	}
+
+	GLuint RecordingDevice::Create(Kind kind) {
+		const GLuint name = m_nextName++;
+		Object object;
+		object.kind = kind;
+		m_objects.emplace(name, std::move(object));
+		return name;
+	}
+
+	void RecordingDevice::Destroy(GLuint name, Kind kind, const char* call) {
+		if (name == 0) return;   // Deleting 0 is silently ignored, as in GL
+		if (!Find(name, kind, call)) return;
+		m_objects.erase(name);
+
+		// Deleting a bound object unbinds it
+		switch (kind) {
+		case Kind::Buffer:
+			for (auto& [target, bound] : m_buffers) if (bound == name) bound = 0;
+			for (auto& [slot, bound] : m_indexedBuffers) if (bound == name) bound = 0;
+			if (m_defaultElementBuffer == name) m_defaultElementBuffer = 0;
+			if (auto it = m_objects.find(m_vertexArray); it != m_objects.end() && it->second.elementBuffer == name)
+				it->second.elementBuffer = 0;
+			break;
+		case Kind::VertexArray:
+			if (m_vertexArray == name) m_vertexArray = 0;
+			break;
+		case Kind::Texture:
+			for (auto& [slot, bound] : m_textures) if (bound == name) bound = 0;
+			break;
+		case Kind::Program:
+			if (m_program == name) m_program = 0;
+			break;
+		case Kind::Shader:
+			break;
+		}
+	}
+
+	RecordingDevice::Object* RecordingDevice::BoundBuffer(GLenum target, const char* call) {
+		GLuint name = 0;
+		if (target == GL_ELEMENT_ARRAY_BUFFER) {
+			auto vao = m_objects.find(m_vertexArray);
+			name = vao != m_objects.end() ? vao->second.elementBuffer : m_defaultElementBuffer;
+		}
+		else if (auto it = m_buffers.find(target); it != m_buffers.end()) {
+			name = it->second;
+		}
+		if (name == 0) {
+			Error(fmt::format("{}: no buffer bound to {}", call, EnumName(target)));
+			return nullptr;
+		}
+		return Find(name, Kind::Buffer, call);
+	}
+
+	RecordingDevice::Object* RecordingDevice::BoundTexture(GLenum target, const char* call) {
+		auto it = m_textures.find({ m_activeUnit, target });
+		if (it == m_textures.end() || it->second == 0) {
+			Error(fmt::format("{}: no texture bound to {} on unit {}", call, EnumName(target), m_activeUnit));
+			return nullptr;
+		}
+		return Find(it->second, Kind::Texture, call);
+	}
+
+	RecordingDevice::Object* RecordingDevice::BoundVertexArray(const char* call) {
+		if (m_vertexArray == 0) {
+			Error(fmt::format("{}: no vertex array bound", call));
+			return nullptr;
+		}
+		return Find(m_vertexArray, Kind::VertexArray, call);
+	}
+
+	void RecordingDevice::ValidateDraw(const char* call, GLint first, GLsizei count, GLsizei instances,
+		GLenum indexType, const void* indices) {
+		if (count < 0 || instances < 0) {
+			Error(fmt::format("{}: negative count", call));
+			return;
+		}
+
+		if (m_program == 0) Error(fmt::format("{}: no program in use", call));
+		else if (auto* program = Find(m_program, Kind::Program, call); program && !program->linked)
+			Error(fmt::format("{}: program {} is not linked", call, m_program));
+
+		auto* vao = BoundVertexArray(call);
+		if (!vao || count == 0 || instances == 0) return;
+
+		// Highest vertex read: from the index buffer for indexed draws
+		size_t lastVertex = static_cast<size_t>(first) + static_cast<size_t>(count) - 1;
+		if (indexType != 0) {
+			if (vao->elementBuffer == 0) {
+				Error(fmt::format("{}: vertex array {} has no element buffer", call, m_vertexArray));
+				return;
+			}
+			auto* elements = Find(vao->elementBuffer, Kind::Buffer, call);
+			if (!elements) return;
+			const size_t size = TypeSize(indexType);
+			const size_t offset = Offset(indices);
+			if (offset + size * static_cast<size_t>(count) > elements->data.size()) {
+				Error(fmt::format("{}: {} indices at {} overrun element buffer {} ({} bytes)",
+					call, count, offset, vao->elementBuffer, elements->data.size()));
+				return;
+			}
+			lastVertex = 0;
+			for (GLsizei i = 0; i < count; ++i) {
+				uint32_t index = 0;
+				std::memcpy(&index, elements->data.data() + offset + size * static_cast<size_t>(i), size);
+				lastVertex = std::max<size_t>(lastVertex, index);
+			}
+		}
+
+		for (GLuint location = 0; location < MAX_ATTRIBUTES; ++location) {
+			if (!(vao->enabledAttributes & (1u << location))) continue;
+			const Attribute& attribute = vao->attributes[location];
+			if (attribute.buffer == 0) {
+				Error(fmt::format("{}: attribute {} is enabled without a buffer", call, location));
+				continue;
+			}
+			auto* buffer = Find(attribute.buffer, Kind::Buffer, call);
+			if (!buffer) continue;
+			if (buffer->mapped && !(buffer->mapAccess & GL_MAP_PERSISTENT_BIT)) {
+				Error(fmt::format("{}: attribute {} reads buffer {} while it is mapped", call, location, attribute.buffer));
+				continue;
+			}
+
+			const size_t last = attribute.divisor == 0
+				? lastVertex
+				: (static_cast<size_t>(instances) - 1) / attribute.divisor;
+			const size_t end = attribute.offset + last * attribute.stride + attribute.bytes;
+			if (end > buffer->data.size()) {
+				Error(fmt::format("{}: attribute {} reads {} bytes of buffer {} ({} bytes)",
+					call, location, end, attribute.buffer, buffer->data.size()));
+			}
+		}
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// State
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void RecordingDevice::UseProgram(GLuint program) {
+		Record("UseProgram", program);
+		++m_stats.stateChanges;
+		if (program != 0) {
+			auto* object = Find(program, Kind::Program, "UseProgram");
+			if (!object) return;
+			if (!object->linked) {
+				Error(fmt::format("UseProgram: program {} is not linked", program));
+				return;
+			}
+		}
+		m_program = program;
+	}
+
+	void RecordingDevice::BindVertexArray(GLuint vao) {
+		Record("BindVertexArray", vao);
+		++m_stats.stateChanges;
+		if (vao != 0 && !Find(vao, Kind::VertexArray, "BindVertexArray")) return;
+		m_vertexArray = vao;
+	}
+
+	void RecordingDevice::BindBuffer(GLenum target, GLuint buffer) {
+		Record("BindBuffer", Enum{ target }, buffer);
+		++m_stats.stateChanges;
+		if (buffer != 0 && !Find(buffer, Kind::Buffer, "BindBuffer")) return;
+
+		if (target != GL_ELEMENT_ARRAY_BUFFER) m_buffers[target] = buffer;
+		else if (auto vao = m_objects.find(m_vertexArray); vao != m_objects.end()) vao->second.elementBuffer = buffer;
+		else m_defaultElementBuffer = buffer;
+	}
+
+	void RecordingDevice::BindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+		Record("BindBufferBase", Enum{ target }, index, buffer);
+		++m_stats.stateChanges;
+		if (buffer != 0 && !Find(buffer, Kind::Buffer, "BindBufferBase")) return;
+		m_indexedBuffers[{ target, index }] = buffer;
+		m_buffers[target] = buffer;
+	}
+
+	void RecordingDevice::ActiveTexture(GLenum unit) {
+		Record("ActiveTexture", fmt::format("TEXTURE{}", unit - GL_TEXTURE0));
+		++m_stats.stateChanges;
+		m_activeUnit = unit - GL_TEXTURE0;
+	}
+
+	void RecordingDevice::BindTexture(GLenum target, GLuint texture) {
+		Record("BindTexture", Enum{ target }, texture);
+		++m_stats.stateChanges;
+		if (texture != 0) {
+			auto* object = Find(texture, Kind::Texture, "BindTexture");
+			if (!object) return;
+			if (object->target == 0) object->target = target;
+			else if (object->target != target) {
+				Error(fmt::format("BindTexture: texture {} is a {}, bound as {}", texture,
+					EnumName(object->target), EnumName(target)));
+				return;
+			}
+		}
+		m_textures[{ m_activeUnit, target }] = texture;
+	}
+
+	void RecordingDevice::Enable(GLenum cap) {
+		Record("Enable", Enum{ cap });
+		++m_stats.stateChanges;
+		m_enabled.insert(cap);
+	}
+
+	void RecordingDevice::Disable(GLenum cap) {
+		Record("Disable", Enum{ cap });
+		++m_stats.stateChanges;
+		m_enabled.erase(cap);
+	}
+
+	void RecordingDevice::BlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha) {
+		Record("BlendFuncSeparate", Factor{ srcRGB }, Factor{ dstRGB }, Factor{ srcAlpha }, Factor{ dstAlpha });
+		++m_stats.stateChanges;
+	}
+
+	void RecordingDevice::DepthFunc(GLenum func) {
+		Record("DepthFunc", Enum{ func });
+		++m_stats.stateChanges;
+	}
+
+	void RecordingDevice::DepthMask(GLboolean mask) {
+		Record("DepthMask", mask == GL_TRUE);
+		++m_stats.stateChanges;
+	}
+
+	void RecordingDevice::Scissor(GLint x, GLint y, GLsizei width, GLsizei height) {
+		Record("Scissor", x, y, width, height);
+		++m_stats.stateChanges;
+		m_scissor = { x, y, width, height };
+	}
+
+	void RecordingDevice::Viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+		Record("Viewport", x, y, width, height);
+		++m_stats.stateChanges;
+		m_viewport = { x, y, width, height };
+	}
+
+	void RecordingDevice::BindFramebuffer(GLenum target, GLuint framebuffer) {
+		Record("BindFramebuffer", Enum{ target }, framebuffer);
+		++m_stats.stateChanges;
+		if (target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER) m_drawFramebuffer = framebuffer;
+		if (target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER) m_readFramebuffer = framebuffer;
+	}
+
+	void RecordingDevice::ClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a) {
+		Record("ClearColor", r, g, b, a);
+		++m_stats.stateChanges;
+	}
+
+	void RecordingDevice::GetIntegerv(GLenum pname, GLint* data) {
+		Record("GetIntegerv", Enum{ pname });
+		auto buffer = [this](GLenum target) {
+			auto it = m_buffers.find(target);
+			return static_cast<GLint>(it != m_buffers.end() ? it->second : 0);
+		};
+		auto texture = [this](GLenum target) {
+			auto it = m_textures.find({ m_activeUnit, target });
+			return static_cast<GLint>(it != m_textures.end() ? it->second : 0);
+		};
+
+		switch (pname) {
+		case GL_MAX_TEXTURE_SIZE: *data = m_caps.maxTextureSize; break;
+		case GL_MAX_ARRAY_TEXTURE_LAYERS: *data = m_caps.maxArrayTextureLayers; break;
+		case GL_NUM_EXTENSIONS: *data = 0; break;
+		case GL_CURRENT_PROGRAM: *data = static_cast<GLint>(m_program); break;
+		case GL_VERTEX_ARRAY_BINDING: *data = static_cast<GLint>(m_vertexArray); break;
+		case GL_ELEMENT_ARRAY_BUFFER_BINDING: {
+			auto vao = m_objects.find(m_vertexArray);
+			*data = static_cast<GLint>(vao != m_objects.end() ? vao->second.elementBuffer : m_defaultElementBuffer);
+			break;
+		}
+		case GL_ARRAY_BUFFER_BINDING: *data = buffer(GL_ARRAY_BUFFER); break;
+		case GL_UNIFORM_BUFFER_BINDING: *data = buffer(GL_UNIFORM_BUFFER); break;
+		case GL_COPY_READ_BUFFER_BINDING: *data = buffer(GL_COPY_READ_BUFFER); break;
+		case GL_COPY_WRITE_BUFFER_BINDING: *data = buffer(GL_COPY_WRITE_BUFFER); break;
+		case GL_PIXEL_PACK_BUFFER_BINDING: *data = buffer(GL_PIXEL_PACK_BUFFER); break;
+		case GL_PIXEL_UNPACK_BUFFER_BINDING: *data = buffer(GL_PIXEL_UNPACK_BUFFER); break;
+		case GL_TEXTURE_BUFFER_BINDING: *data = buffer(GL_TEXTURE_BUFFER); break;
+		case GL_DRAW_INDIRECT_BUFFER_BINDING: *data = buffer(GL_DRAW_INDIRECT_BUFFER); break;
+		case GL_SHADER_STORAGE_BUFFER_BINDING: *data = buffer(GL_SHADER_STORAGE_BUFFER); break;
+		case GL_ACTIVE_TEXTURE: *data = static_cast<GLint>(GL_TEXTURE0 + m_activeUnit); break;
+		case GL_TEXTURE_BINDING_2D: *data = texture(GL_TEXTURE_2D); break;
+		case GL_TEXTURE_BINDING_2D_ARRAY: *data = texture(GL_TEXTURE_2D_ARRAY); break;
+		case GL_TEXTURE_BINDING_BUFFER: *data = texture(GL_TEXTURE_BUFFER); break;
+		case GL_DRAW_FRAMEBUFFER_BINDING: *data = static_cast<GLint>(m_drawFramebuffer); break;
+		case GL_READ_FRAMEBUFFER_BINDING: *data = static_cast<GLint>(m_readFramebuffer); break;
+		case GL_VIEWPORT: std::copy(m_viewport.begin(), m_viewport.end(), data); break;
+		case GL_SCISSOR_BOX: std::copy(m_scissor.begin(), m_scissor.end(), data); break;
+		default: *data = 0; break;
+		}
+	}
+
+	GLboolean RecordingDevice::IsEnabled(GLenum cap) {
+		Record("IsEnabled", Enum{ cap });
+		return m_enabled.count(cap) ? GL_TRUE : GL_FALSE;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Objects and buffers
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	GLuint RecordingDevice::GenBuffer() {
+		const GLuint name = Create(Kind::Buffer);
+		Record("GenBuffer", name);
+		return name;
+	}
+
+	void RecordingDevice::DeleteBuffer(GLuint buffer) {
+		Record("DeleteBuffer", buffer);
+		Destroy(buffer, Kind::Buffer, "DeleteBuffer");
+	}
+
+	GLuint RecordingDevice::GenVertexArray() {
+		const GLuint name = Create(Kind::VertexArray);
+		Record("GenVertexArray", name);
+		return name;
+	}
+
+	void RecordingDevice::DeleteVertexArray(GLuint vao) {
+		Record("DeleteVertexArray", vao);
+		Destroy(vao, Kind::VertexArray, "DeleteVertexArray");
+	}
+
+	GLuint RecordingDevice::GenTexture() {
+		const GLuint name = Create(Kind::Texture);
+		Record("GenTexture", name);
+		return name;
+	}
+
+	void RecordingDevice::DeleteTexture(GLuint texture) {
+		Record("DeleteTexture", texture);
+		Destroy(texture, Kind::Texture, "DeleteTexture");
+	}
+
+	void RecordingDevice::BufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+		Record("BufferData", Enum{ target }, size, Data(data), Enum{ usage });
+		auto* buffer = BoundBuffer(target, "BufferData");
+		if (!buffer) return;
+		if (buffer->immutable) {
+			Error("BufferData: the buffer has immutable storage");
+			return;
+		}
+
+		buffer->mapped = false;   // Respecifying unmaps
+		buffer->data.assign(static_cast<size_t>(size), 0);
+		if (data) {
+			std::memcpy(buffer->data.data(), data, static_cast<size_t>(size));
+			m_stats.bufferBytes += static_cast<uint64_t>(size);
+		}
+	}
+
+	void RecordingDevice::BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {
+		Record("BufferSubData", Enum{ target }, offset, size, Data(data));
+		auto* buffer = BoundBuffer(target, "BufferSubData");
+		if (!buffer) return;
+		if (offset < 0 || size < 0 || static_cast<size_t>(offset + size) > buffer->data.size()) {
+			Error(fmt::format("BufferSubData: {} bytes at {} overrun the buffer ({} bytes)", size, offset, buffer->data.size()));
+			return;
+		}
+		if (buffer->mapped && !(buffer->mapAccess & GL_MAP_PERSISTENT_BIT)) {
+			Error("BufferSubData: the buffer is mapped");
+			return;
+		}
+		if (buffer->immutable && !(buffer->storageFlags & GL_DYNAMIC_STORAGE_BIT)) {
+			Error("BufferSubData: the buffer's storage is not GL_DYNAMIC_STORAGE_BIT");
+			return;
+		}
+		std::memcpy(buffer->data.data() + offset, data, static_cast<size_t>(size));
+		m_stats.bufferBytes += static_cast<uint64_t>(size);
+	}
+
+	void RecordingDevice::BufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags) {
+		Record("BufferStorage", Enum{ target }, size, Data(data), fmt::format("0x{:X}", flags));
+		auto* buffer = BoundBuffer(target, "BufferStorage");
+		if (!buffer) return;
+		if (buffer->immutable) {
+			Error("BufferStorage: the buffer already has immutable storage");
+			return;
+		}
+
+		buffer->immutable = true;
+		buffer->storageFlags = flags;
+		buffer->data.assign(static_cast<size_t>(size), 0);
+		if (data) {
+			std::memcpy(buffer->data.data(), data, static_cast<size_t>(size));
+			m_stats.bufferBytes += static_cast<uint64_t>(size);
+		}
+	}
+
+	void* RecordingDevice::MapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+		Record("MapBufferRange", Enum{ target }, offset, length, fmt::format("0x{:X}", access));
+		auto* buffer = BoundBuffer(target, "MapBufferRange");
+		if (!buffer) return nullptr;
+		if (buffer->mapped) {
+			Error("MapBufferRange: the buffer is already mapped");
+			return nullptr;
+		}
+		if (offset < 0 || length <= 0 || static_cast<size_t>(offset + length) > buffer->data.size()) {
+			Error(fmt::format("MapBufferRange: {} bytes at {} overrun the buffer ({} bytes)", length, offset, buffer->data.size()));
+			return nullptr;
+		}
+		constexpr GLbitfield storageBits = GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		if (buffer->immutable && (access & storageBits & ~buffer->storageFlags)) {
+			Error("MapBufferRange: persistent mapping of storage created without it");
+			return nullptr;
+		}
+		if (!buffer->immutable && (access & GL_MAP_PERSISTENT_BIT)) {
+			Error("MapBufferRange: persistent mapping needs BufferStorage");
+			return nullptr;
+		}
+
+		buffer->mapped = true;
+		buffer->mapAccess = access;
+		// A persistent mapping stays for the buffer's lifetime; what goes through it is counted by its user
+		if ((access & GL_MAP_WRITE_BIT) && !(access & GL_MAP_PERSISTENT_BIT))
+			m_stats.bufferBytes += static_cast<uint64_t>(length);
+		return buffer->data.data() + offset;
+	}
+
+	void RecordingDevice::UnmapBuffer(GLenum target) {
+		Record("UnmapBuffer", Enum{ target });
+		auto* buffer = BoundBuffer(target, "UnmapBuffer");
+		if (!buffer) return;
+		if (!buffer->mapped) {
+			Error("UnmapBuffer: the buffer is not mapped");
+			return;
+		}
+		buffer->mapped = false;
+		buffer->mapAccess = 0;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Vertex layout and textures
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void RecordingDevice::EnableVertexAttribArray(GLuint index) {
+		Record("EnableVertexAttribArray", index);
+		auto* vao = BoundVertexArray("EnableVertexAttribArray");
+		if (!vao) return;
+		if (index >= MAX_ATTRIBUTES) {
+			Error(fmt::format("EnableVertexAttribArray: location {} out of range", index));
+			return;
+		}
+		vao->enabledAttributes |= 1u << index;
+	}
+
+	void RecordingDevice::VertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+		GLsizei stride, const void* pointer) {
+		Record("VertexAttribPointer", index, size, Enum{ type }, normalized == GL_TRUE, stride, Offset(pointer));
+		auto* vao = BoundVertexArray("VertexAttribPointer");
+		if (!vao) return;
+		if (index >= MAX_ATTRIBUTES || size < 1 || size > 4) {
+			Error(fmt::format("VertexAttribPointer: location {} with {} components", index, size));
+			return;
+		}
+		const GLuint buffer = m_buffers.count(GL_ARRAY_BUFFER) ? m_buffers[GL_ARRAY_BUFFER] : 0;
+		if (buffer == 0) {
+			Error(fmt::format("VertexAttribPointer: no buffer bound to ARRAY_BUFFER for location {}", index));
+			return;
+		}
+
+		auto& attribute = vao->attributes[index];
+		attribute.buffer = buffer;
+		attribute.offset = Offset(pointer);
+		attribute.bytes = static_cast<size_t>(size) * TypeSize(type);
+		attribute.stride = stride != 0 ? static_cast<size_t>(stride) : attribute.bytes;
+	}
+
+	void RecordingDevice::VertexAttribDivisor(GLuint index, GLuint divisor) {
+		Record("VertexAttribDivisor", index, divisor);
+		auto* vao = BoundVertexArray("VertexAttribDivisor");
+		if (!vao) return;
+		if (index >= MAX_ATTRIBUTES) {
+			Error(fmt::format("VertexAttribDivisor: location {} out of range", index));
+			return;
+		}
+		vao->attributes[index].divisor = divisor;
+	}
+
+	void RecordingDevice::TexParameteri(GLenum target, GLenum pname, GLint param) {
+		Record("TexParameteri", Enum{ target }, Enum{ pname }, Enum{ static_cast<GLenum>(param) });
+		BoundTexture(target, "TexParameteri");
+	}
+
+	void RecordingDevice::TexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+		GLenum format, GLenum type, const void* pixels) {
+		Record("TexImage2D", Enum{ target }, level, Enum{ static_cast<GLenum>(internalFormat) }, width, height,
+			Enum{ format }, Enum{ type }, Data(pixels));
+		auto* texture = BoundTexture(target, "TexImage2D");
+		if (!texture) return;
+		if (width <= 0 || height <= 0 || width > m_caps.maxTextureSize || height > m_caps.maxTextureSize) {
+			Error(fmt::format("TexImage2D: {}x{} exceeds the {} limit", width, height, m_caps.maxTextureSize));
+			return;
+		}
+		if (level == 0) {
+			texture->width = width;
+			texture->height = height;
+			texture->depth = 1;
+		}
+		if (pixels) m_stats.textureBytes += ImageBytes(width, height, 1, format, type);
+	}
+
+	void RecordingDevice::TexSubImage2D(GLenum target, GLint level, GLint x, GLint y, GLsizei width, GLsizei height,
+		GLenum format, GLenum type, const void* pixels) {
+		Record("TexSubImage2D", Enum{ target }, level, x, y, width, height, Enum{ format }, Enum{ type }, Data(pixels));
+		auto* texture = BoundTexture(target, "TexSubImage2D");
+		if (!texture) return;
+		if (x < 0 || y < 0 || x + width > texture->width || y + height > texture->height) {
+			Error(fmt::format("TexSubImage2D: region {},{} {}x{} outside the {}x{} texture",
+				x, y, width, height, texture->width, texture->height));
+			return;
+		}
+		if (pixels) m_stats.textureBytes += ImageBytes(width, height, 1, format, type);
+	}
+
+	void RecordingDevice::TexImage3D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+		GLsizei depth, GLenum format, GLenum type, const void* pixels) {
+		Record("TexImage3D", Enum{ target }, level, Enum{ static_cast<GLenum>(internalFormat) }, width, height, depth,
+			Enum{ format }, Enum{ type }, Data(pixels));
+		auto* texture = BoundTexture(target, "TexImage3D");
+		if (!texture) return;
+		if (width <= 0 || height <= 0 || width > m_caps.maxTextureSize || height > m_caps.maxTextureSize ||
+			depth <= 0 || depth > m_caps.maxArrayTextureLayers) {
+			Error(fmt::format("TexImage3D: {}x{}x{} exceeds the device limits", width, height, depth));
+			return;
+		}
+		if (level == 0) {
+			texture->width = width;
+			texture->height = height;
+			texture->depth = depth;
+		}
+		if (pixels) m_stats.textureBytes += ImageBytes(width, height, depth, format, type);
+	}
+
+	void RecordingDevice::TexSubImage3D(GLenum target, GLint level, GLint x, GLint y, GLint z,
+		GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void* pixels) {
+		Record("TexSubImage3D", Enum{ target }, level, x, y, z, width, height, depth, Enum{ format }, Enum{ type },
+			Data(pixels));
+		auto* texture = BoundTexture(target, "TexSubImage3D");
+		if (!texture) return;
+		if (x < 0 || y < 0 || z < 0 || x + width > texture->width || y + height > texture->height ||
+			z + depth > texture->depth) {
+			Error(fmt::format("TexSubImage3D: region {},{},{} {}x{}x{} outside the {}x{}x{} texture",
+				x, y, z, width, height, depth, texture->width, texture->height, texture->depth));
+			return;
+		}
+		if (pixels) m_stats.textureBytes += ImageBytes(width, height, depth, format, type);
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Shaders and programs
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	GLuint RecordingDevice::CreateShader(GLenum type) {
+		const GLuint name = Create(Kind::Shader);
+		m_objects[name].shaderType = type;
+		Record("CreateShader", Enum{ type }, name);
+		return name;
+	}
+
+	void RecordingDevice::ShaderSource(GLuint shader, const char* source) {
+		Record("ShaderSource", shader, std::strlen(source));
+		if (auto* object = Find(shader, Kind::Shader, "ShaderSource")) object->source = source;
+	}
+
+	void RecordingDevice::CompileShader(GLuint shader) {
+		Record("CompileShader", shader);
+		// Anything with an entry point compiles; the uniforms are read at link
+		if (auto* object = Find(shader, Kind::Shader, "CompileShader"))
+			object->compiled = object->source.find("main") != std::string::npos;
+	}
+
+	void RecordingDevice::GetShaderiv(GLuint shader, GLenum pname, GLint* value) {
+		Record("GetShaderiv", shader, Enum{ pname });
+		auto* object = Find(shader, Kind::Shader, "GetShaderiv");
+		*value = pname == GL_COMPILE_STATUS && object && object->compiled ? GL_TRUE : GL_FALSE;
+	}
+
+	void RecordingDevice::GetShaderInfoLog(GLuint shader, GLsizei size, GLchar* log) {
+		Record("GetShaderInfoLog", shader);
+		if (size > 0) std::snprintf(log, static_cast<size_t>(size), "%s", "no main() in the shader source");
+	}
+
+	void RecordingDevice::DeleteShader(GLuint shader) {
+		Record("DeleteShader", shader);
+		Destroy(shader, Kind::Shader, "DeleteShader");
+	}
+
+	GLuint RecordingDevice::CreateProgram() {
+		const GLuint name = Create(Kind::Program);
+		Record("CreateProgram", name);
+		return name;
+	}
+
+	void RecordingDevice::AttachShader(GLuint program, GLuint shader) {
+		Record("AttachShader", program, shader);
+		auto* object = Find(program, Kind::Program, "AttachShader");
+		if (object && Find(shader, Kind::Shader, "AttachShader")) object->shaders.push_back(shader);
+	}
+
+	void RecordingDevice::LinkProgram(GLuint program) {
+		Record("LinkProgram", program);
+		auto* object = Find(program, Kind::Program, "LinkProgram");
+		if (!object) return;
+
+		object->linked = false;
+		object->uniforms.clear();
+		object->blocks.clear();
+		bool vertex = false, fragment = false;
+		for (GLuint shader : object->shaders) {
+			auto* stage = Find(shader, Kind::Shader, "LinkProgram");
+			if (!stage || !stage->compiled) return;
+			vertex |= stage->shaderType == GL_VERTEX_SHADER;
+			fragment |= stage->shaderType == GL_FRAGMENT_SHADER;
+			ScanUniforms(stage->source, object->uniforms, object->blocks);
+		}
+		object->linked = vertex && fragment;
+	}
+
+	void RecordingDevice::GetProgramiv(GLuint program, GLenum pname, GLint* value) {
+		Record("GetProgramiv", program, Enum{ pname });
+		auto* object = Find(program, Kind::Program, "GetProgramiv");
+		*value = pname == GL_LINK_STATUS && object && object->linked ? GL_TRUE : GL_FALSE;
+	}
+
+	void RecordingDevice::GetProgramInfoLog(GLuint program, GLsizei size, GLchar* log) {
+		Record("GetProgramInfoLog", program);
+		if (size > 0) std::snprintf(log, static_cast<size_t>(size), "%s", "needs a compiled vertex and fragment shader");
+	}
+
+	void RecordingDevice::DeleteProgram(GLuint program) {
+		Record("DeleteProgram", program);
+		Destroy(program, Kind::Program, "DeleteProgram");
+	}
+
+	GLint RecordingDevice::GetUniformLocation(GLuint program, const char* name) {
+		Record("GetUniformLocation", program, name);
+		auto* object = Find(program, Kind::Program, "GetUniformLocation");
+		if (!object) return -1;
+		if (!object->linked) {
+			Error(fmt::format("GetUniformLocation: program {} is not linked", program));
+			return -1;
+		}
+
+		std::string key = name;
+		if (key.size() > 3 && key.compare(key.size() - 3, 3, "[0]") == 0) key.resize(key.size() - 3);
+		auto it = std::find(object->uniforms.begin(), object->uniforms.end(), key);
+		return it != object->uniforms.end() ? static_cast<GLint>(it - object->uniforms.begin()) : -1;
+	}
+
+	GLuint RecordingDevice::GetUniformBlockIndex(GLuint program, const char* name) {
+		Record("GetUniformBlockIndex", program, name);
+		auto* object = Find(program, Kind::Program, "GetUniformBlockIndex");
+		if (!object) return GL_INVALID_INDEX;
+		auto it = std::find(object->blocks.begin(), object->blocks.end(), name);
+		return it != object->blocks.end() ? static_cast<GLuint>(it - object->blocks.begin()) : GL_INVALID_INDEX;
+	}
+
+	void RecordingDevice::UniformBlockBinding(GLuint program, GLuint block, GLuint binding) {
+		Record("UniformBlockBinding", program, block, binding);
+		auto* object = Find(program, Kind::Program, "UniformBlockBinding");
+		if (object && block >= object->blocks.size())
+			Error(fmt::format("UniformBlockBinding: program {} has no block {}", program, block));
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Uniforms
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	bool RecordingDevice::UniformTarget(GLint location, const char* call) {
+		if (location == -1) return false;   // Unknown uniforms are a legal no-op, as in GL
+		if (m_program == 0) {
+			Error(fmt::format("{}: no program in use", call));
+			return false;
+		}
+		auto* program = Find(m_program, Kind::Program, call);
+		if (!program) return false;
+		if (location < 0 || static_cast<size_t>(location) >= program->uniforms.size()) {
+			Error(fmt::format("{}: program {} has no uniform at location {}", call, m_program, location));
+			return false;
+		}
+		++m_stats.uniformUploads;
+		return true;
+	}
+
+	void RecordingDevice::Uniform1i(GLint location, GLint value) {
+		Record("Uniform1i", location, value);
+		UniformTarget(location, "Uniform1i");
+	}
+
+	void RecordingDevice::Uniform1f(GLint location, GLfloat value) {
+		Record("Uniform1f", location, value);
+		UniformTarget(location, "Uniform1f");
+	}
+
+	void RecordingDevice::Uniform2f(GLint location, GLfloat x, GLfloat y) {
+		Record("Uniform2f", location, x, y);
+		UniformTarget(location, "Uniform2f");
+	}
+
+	void RecordingDevice::Uniform3f(GLint location, GLfloat x, GLfloat y, GLfloat z) {
+		Record("Uniform3f", location, x, y, z);
+		UniformTarget(location, "Uniform3f");
+	}
+
+	void RecordingDevice::UniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+		Record("UniformMatrix4fv", location, count, transpose == GL_TRUE, Data(value));
+		UniformTarget(location, "UniformMatrix4fv");
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Drawing and synchronization
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void RecordingDevice::Clear(GLbitfield mask) {
+		std::string bits;
+		if (mask & GL_COLOR_BUFFER_BIT) bits += "COLOR";
+		if (mask & GL_DEPTH_BUFFER_BIT) bits += bits.empty() ? "DEPTH" : "|DEPTH";
+		if (mask & GL_STENCIL_BUFFER_BIT) bits += bits.empty() ? "STENCIL" : "|STENCIL";
+		Record("Clear", bits);
+		++m_stats.clears;
+	}
+
+	void RecordingDevice::DrawArrays(GLenum mode, GLint first, GLsizei count) {
+		Record("DrawArrays", Mode{ mode }, first, count);
+		ValidateDraw("DrawArrays", first, count, 1, 0, nullptr);
+		++m_stats.drawCalls;
+		++m_stats.instances;
+		m_stats.vertices += static_cast<uint64_t>(std::max(count, 0));
+	}
+
+	void RecordingDevice::DrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances) {
+		Record("DrawArraysInstanced", Mode{ mode }, first, count, instances);
+		ValidateDraw("DrawArraysInstanced", first, count, instances, 0, nullptr);
+		++m_stats.drawCalls;
+		m_stats.instances += static_cast<uint64_t>(std::max(instances, 0));
+		m_stats.vertices += static_cast<uint64_t>(std::max(count, 0)) * static_cast<uint64_t>(std::max(instances, 0));
+	}
+
+	void RecordingDevice::DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) {
+		Record("DrawElements", Mode{ mode }, count, Enum{ type }, Offset(indices));
+		ValidateDraw("DrawElements", 0, count, 1, type, indices);
+		++m_stats.drawCalls;
+		++m_stats.instances;
+		m_stats.vertices += static_cast<uint64_t>(std::max(count, 0));
+	}
+
+	void RecordingDevice::DrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices,
+		GLsizei instances) {
+		Record("DrawElementsInstanced", Mode{ mode }, count, Enum{ type }, Offset(indices), instances);
+		ValidateDraw("DrawElementsInstanced", 0, count, instances, type, indices);
+		++m_stats.drawCalls;
+		m_stats.instances += static_cast<uint64_t>(std::max(instances, 0));
+		m_stats.vertices += static_cast<uint64_t>(std::max(count, 0)) * static_cast<uint64_t>(std::max(instances, 0));
+	}
+
+	GLsync RecordingDevice::FenceSync() {
+		const uintptr_t fence = m_nextFence++;
+		m_fences.insert(fence);
+		Record("FenceSync", fence);
+		return reinterpret_cast<GLsync>(fence);
+	}
+
+	GLenum RecordingDevice::ClientWaitSync(GLsync sync, GLbitfield, GLuint64) {
+		const auto fence = reinterpret_cast<uintptr_t>(sync);
+		Record("ClientWaitSync", fence);
+		if (!m_fences.count(fence)) {
+			Error(fmt::format("ClientWaitSync: {} is not a live fence", fence));
+			return GL_WAIT_FAILED;
+		}
+		return GL_ALREADY_SIGNALED;   // Nothing is ever in flight
+	}
+
+	void RecordingDevice::DeleteSync(GLsync sync) {
+		const auto fence = reinterpret_cast<uintptr_t>(sync);
+		Record("DeleteSync", fence);
+		if (fence != 0 && !m_fences.erase(fence))
+			Error(fmt::format("DeleteSync: {} is not a live fence", fence));
+	}
+
+} // namespace WanderSpire::GL
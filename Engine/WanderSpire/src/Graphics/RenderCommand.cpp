@@ -8,7 +8,7 @@ namespace WanderSpire {
 
 	void SpriteCommand::Execute() {
 		auto& renderer = SpriteRenderer::Get();
-		renderer.DrawSprite(textureID, position, size, rotation, color, uvOffset, uvSize);
+		renderer.DrawSprite(textureID, position, size, rotation, color, uvOffset, uvSize, textureLayer);
 	}
 
 	void InstancedCommand::Execute() {
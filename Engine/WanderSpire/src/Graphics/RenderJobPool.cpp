@@ -0,0 +1,142 @@
+#include "WanderSpire/Graphics/RenderJobPool.h"
+#include "WanderSpire/Core/ConfigManager.h"
+
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+namespace WanderSpire {
+
+	namespace {
+		/// Set while this thread runs a job, so nested Run calls go serial
+		thread_local bool t_insideJob = false;
+
+		void RunJob(const std::function<void(size_t)>& job, size_t index) {
+			try {
+				job(index);
+			}
+			catch (const std::exception& e) {
+				spdlog::error("[RenderJobPool] Job {} failed: {}", index, e.what());
+			}
+		}
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Lifetime
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	RenderJobPool& RenderJobPool::Get() {
+		static RenderJobPool instance;
+		return instance;
+	}
+
+	RenderJobPool::RenderJobPool()
+		: m_threadCount(static_cast<unsigned>(std::max(0, ConfigManager::Get().renderPrepThreads)))
+	{
+	}
+
+	RenderJobPool::~RenderJobPool() {
+		StopWorkers();
+	}
+
+	void RenderJobPool::SetThreadCount(unsigned threads) {
+		std::lock_guard run(m_runMutex);
+		StopWorkers();
+		std::lock_guard lock(m_mutex);
+		m_threadCount = threads;
+	}
+
+	unsigned RenderJobPool::GetThreadCount() const {
+		std::lock_guard lock(m_mutex);
+		if (m_threadCount) return m_threadCount;
+		return std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	void RenderJobPool::StartWorkers() {
+		// Called with m_mutex held; the caller of Run is the remaining thread
+		if (!m_workers.empty()) return;
+		const unsigned threads = m_threadCount ? m_threadCount : std::max(1u, std::thread::hardware_concurrency());
+		for (unsigned i = 1; i < threads; ++i) {
+			m_workers.emplace_back(&RenderJobPool::WorkerLoop, this);
+		}
+	}
+
+	void RenderJobPool::StopWorkers() {
+		std::vector<std::thread> workers;
+		{
+			std::lock_guard lock(m_mutex);
+			m_stopping = true;
+			workers.swap(m_workers);
+		}
+		m_batchReady.notify_all();
+		for (auto& worker : workers) worker.join();
+
+		std::lock_guard lock(m_mutex);
+		m_stopping = false;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Batches
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void RenderJobPool::Run(size_t count, const std::function<void(size_t)>& job) {
+		if (count == 0) return;
+
+		if (t_insideJob || count == 1 || GetThreadCount() <= 1) {
+			for (size_t i = 0; i < count; ++i) RunJob(job, i);
+			return;
+		}
+
+		std::lock_guard run(m_runMutex);
+		{
+			std::lock_guard lock(m_mutex);
+			StartWorkers();
+			m_job = &job;
+			m_count = count;
+			m_next.store(0, std::memory_order_relaxed);
+			m_remaining = count;
+			++m_batch;
+		}
+		m_batchReady.notify_all();
+
+		Work();
+
+		std::unique_lock lock(m_mutex);
+		m_batchDone.wait(lock, [this] { return m_remaining == 0 && m_active == 0; });
+		m_job = nullptr;
+	}
+
+	void RenderJobPool::WorkerLoop() {
+		uint64_t seen = 0;
+		while (true) {
+			{
+				std::unique_lock lock(m_mutex);
+				m_batchReady.wait(lock, [&] { return m_stopping || m_batch != seen; });
+				if (m_stopping) return;
+				seen = m_batch;
+				if (!m_job) continue;   // Woke after the batch was already finished
+				++m_active;
+			}
+			Work();
+
+			std::lock_guard lock(m_mutex);
+			if (--m_active == 0 && m_remaining == 0) m_batchDone.notify_all();
+		}
+	}
+
+	void RenderJobPool::Work() {
+		// m_job and m_count stay put until every thread that joined the batch has left
+		t_insideJob = true;
+		size_t done = 0;
+		for (size_t i = m_next.fetch_add(1, std::memory_order_relaxed); i < m_count;
+			i = m_next.fetch_add(1, std::memory_order_relaxed)) {
+			RunJob(*m_job, i);
+			++done;
+		}
+		t_insideJob = false;
+
+		std::lock_guard lock(m_mutex);
+		m_remaining -= done;
+		if (m_remaining == 0 && m_active == 0) m_batchDone.notify_all();
+	}
+
+} // namespace WanderSpire
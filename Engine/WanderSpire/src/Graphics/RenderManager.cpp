@@ -1,4 +1,8 @@
 ﻿#include "WanderSpire/Graphics/RenderManager.h"
+#include "WanderSpire/Graphics/DebugDraw.h"
+#include "WanderSpire/Graphics/StreamBuffer.h"
+#include "WanderSpire/Graphics/RenderThread.h"
+#include "WanderSpire/Graphics/GLStateCache.h"
 #include <algorithm>
 #include <spdlog/spdlog.h>
 
@@ -14,6 +18,14 @@ namespace WanderSpire {
 		m_commands.push_back(std::move(command));
 	}
 
+	void RenderManager::Submit(std::vector<std::unique_ptr<RenderCommand>>&& commands) {
+		m_commands.reserve(m_commands.size() + commands.size());
+		for (auto& command : commands) {
+			if (command) m_commands.push_back(std::move(command));
+		}
+		commands.clear();
+	}
+
 	void RenderManager::SubmitSprite(GLuint textureID, const glm::vec2& position,
 		const glm::vec2& size, float rotation,
 		const glm::vec3& color, const glm::vec2& uvOffset,
@@ -72,11 +84,44 @@ namespace WanderSpire {
 	void RenderManager::ExecuteFrame() {
 		if (m_commands.empty()) return;
 
+		RenderThread::ContextScope glContext;
+		FramePacket packet;
+		FillPacket(packet);
+		ExecutePacket(packet);
+	}
+
+	void RenderManager::SubmitFrame() {
+		auto& renderThread = RenderThread::Get();
+		FillPacket(renderThread.BeginPacket());
+		renderThread.SubmitPacket();
+	}
+
+	void RenderManager::FillPacket(FramePacket& packet) {
+		// Debug geometry from any thread, as one command
+		Submit(DebugDraw::Get().BuildCommand());
+
 		// Sort commands by layer, then by order within layer
 		SortCommands();
 
+		// The packet's old, empty storage becomes the next frame's queue
+		packet.commands.clear();
+		packet.commands.swap(m_commands);
+		packet.frameIndex = ++m_frameIndex;
+		packet.hasViewport = m_hasViewport;
+		packet.viewport = m_viewport;
+
+		m_autoOrder = 0;
+	}
+
+	void RenderManager::ExecutePacket(FramePacket& packet) {
+		if (packet.commands.empty()) return;
+
+		if (packet.hasViewport) {
+			GL::StateCache::Get().Viewport(packet.viewport[0], packet.viewport[1], packet.viewport[2], packet.viewport[3]);
+		}
+
 		// Execute all commands in order
-		for (auto& command : m_commands) {
+		for (auto& command : packet.commands) {
 			try {
 				command->Execute();
 			}
@@ -84,9 +129,15 @@ namespace WanderSpire {
 				spdlog::error("[RenderManager] Command execution failed: {}", e.what());
 			}
 		}
+		packet.commands.clear();
 
-		// Clear for next frame
-		Clear();
+		// Fence this frame's streamed data so its space is reused once the GPU is done
+		StreamBuffer::Get().EndFrame();
+	}
+
+	void RenderManager::SetViewport(int x, int y, int width, int height) {
+		m_viewport = { x, y, width, height };
+		m_hasViewport = true;
 	}
 
 	void RenderManager::Clear() {
@@ -95,7 +146,8 @@ namespace WanderSpire {
 	}
 
 	void RenderManager::SortCommands() {
-		std::sort(m_commands.begin(), m_commands.end(),
+		// Stable, so equal keys draw in submission order every frame
+		std::stable_sort(m_commands.begin(), m_commands.end(),
 			[](const std::unique_ptr<RenderCommand>& a, const std::unique_ptr<RenderCommand>& b) {
 				// Sort by layer first
 				if (static_cast<int>(a->layer) != static_cast<int>(b->layer)) {
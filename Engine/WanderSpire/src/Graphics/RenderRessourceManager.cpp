@@ -1,6 +1,10 @@
 ﻿#include "WanderSpire/Graphics/RenderResourceManager.h"
 #include "WanderSpire/Core/AssetManager.h"
 #include "WanderSpire/Core/AssetLoader.h"
+#include "WanderSpire/Core/ConfigManager.h"
+#include "WanderSpire/Graphics/AtlasPacker.h"
+#include "WanderSpire/Graphics/GLDevice.h"
+#include "WanderSpire/Graphics/RenderJobPool.h"
 #include "WanderSpire/External/stb_image.h"
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "WanderSpire/External/stb_image_write.h"
@@ -8,18 +12,14 @@
 #include <nlohmann/json.hpp>
 #include <filesystem>
 #include <spdlog/spdlog.h>
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <cstring>
+#include <iterator>
 
 namespace WanderSpire {
 	namespace {
-		int NextPow2(int v) {
-			v--; v |= v >> 1; v |= v >> 2; v |= v >> 4; v |= v >> 8; v |= v >> 16;
-			v++;
-			return v > 0 ? v : 1;
-		}
-
 		bool IsSupportedImageExtension(const std::string& ext) {
 			std::string lowerExt = ext;
 			std::transform(lowerExt.begin(), lowerExt.end(), lowerExt.begin(), ::tolower);
@@ -40,16 +40,17 @@ namespace WanderSpire {
 	void RenderResourceManager::OnContextBound()
 	{
 		/* Example: re-query GL limits, re-create the quad VAO/EBO, etc. */
+		auto& gl = GL::Device::Get();
 		if (m_QuadVAO == 0 || m_QuadEBO == 0)
 		{
 			GLuint vao{}, ebo{};
-			glGenVertexArrays(1, &vao);
-			glGenBuffers(1, &ebo);
+			vao = gl.GenVertexArray();
+			ebo = gl.GenBuffer();
 			Init(vao, ebo);            // reuse your existing helper
 		}
 
 		GLint maxTex = 0;
-		glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTex);
+		gl.GetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTex);
 		spdlog::info("[RRM] New GL context bound (max tex = {})", maxTex);
 	}
 
@@ -60,8 +61,9 @@ namespace WanderSpire {
 		const std::string& vsPath,
 		const std::string& fsPath)
 	{
-		// 1) Insert placeholder so GetShader never returns null
-		m_Shaders[name] = std::make_unique<Shader>();
+		// 1) Insert placeholder so GetShader never returns null (re-registering keeps the object)
+		auto& placeholder = m_Shaders[name];
+		if (!placeholder) placeholder = std::make_unique<Shader>();
 
 		// 2) Enqueue worker task: load text from disk
 		AssetLoader::Get().Enqueue([this, name, vsPath, fsPath]() {
@@ -79,14 +81,25 @@ namespace WanderSpire {
 					return;
 				}
 
-				auto shader = std::make_unique<Shader>();
+				// Recompile in place: Shader pointers and uniform handles stay valid
+				auto& shader = m_Shaders[name];
+				if (!shader) shader = std::make_unique<Shader>();
 				shader->CompileFromSource(vsResult.content, fsResult.content);
-				m_Shaders[name] = std::move(shader);
 				spdlog::info("[HotReload] Shader '{}' recompiled", name);
 				});
 			});
 	}
 
+	void RenderResourceManager::RegisterShaderSource(
+		const std::string& name,
+		const std::string& vsSource,
+		const std::string& fsSource)
+	{
+		auto& shader = m_Shaders[name];
+		if (!shader) shader = std::make_unique<Shader>();
+		shader->CompileFromSource(vsSource, fsSource);
+	}
+
 	Shader* RenderResourceManager::GetShader(const std::string& name) {
 		auto it = m_Shaders.find(name);
 		return it != m_Shaders.end() ? it->second.get() : nullptr;
@@ -166,6 +179,7 @@ namespace WanderSpire {
 			/* keep the unique_ptr stable – just refresh its contents */
 			it->second->Load(atlasImagePath, mappingJsonPath);
 		}
+		++m_AtlasRevision;
 	}
 
 	std::shared_ptr<Texture> RenderResourceManager::GetTexture(
@@ -184,6 +198,18 @@ namespace WanderSpire {
 		return m_Atlases.size();
 	}
 
+	void RenderResourceManager::Shutdown() {
+		for (auto& [name, shader] : m_Shaders) {
+			if (shader) shader->Release();
+		}
+		for (auto& [name, texture] : m_Textures) {
+			if (texture) texture->Release();
+		}
+		for (auto& [name, atlas] : m_Atlases) {
+			if (atlas) atlas->Release();
+		}
+	}
+
 	/*──────────────────────── NEW: Spritesheet Registration ─────────────────────────*/
 	void RenderResourceManager::RegisterSpritesheets(const std::string& spriteSheetsRoot) {
 		namespace fs = std::filesystem;
@@ -220,7 +246,63 @@ namespace WanderSpire {
 			registeredCount, baseDir.string());
 	}
 
-	// --- Atlas generation (unchanged) ---
+	// --- Atlas generation ---
+	namespace {
+		struct AtlasSource {
+			std::string name;                    ///< File stem, the frame name
+			std::vector<unsigned char> file;     ///< Encoded bytes, dropped once decoded
+			int w = 0, h = 0;
+			std::vector<unsigned char> pixels;   ///< RGBA
+		};
+
+		struct AtlasBuild {
+			std::string name;
+			std::filesystem::path dir;
+			std::vector<AtlasSource> sources;
+			std::string cacheKey;
+			bool cached = false;
+			bool writeFailed = false;      ///< A page could not be written; the mapping gets no key
+			AtlasPackResult packed;
+			AtlasBuildReport report;
+		};
+
+		std::string AtlasPageFile(const std::string& atlasName, size_t page) {
+			return page == 0
+				? atlasName + "_atlas.png"
+				: atlasName + "_atlas_" + std::to_string(page) + ".png";
+		}
+
+		/// Reads the report of the atlas written last time, if it was built from
+		/// the same key and all of its pages are still there
+		bool LoadCachedAtlas(const std::filesystem::path& baseDir, const AtlasBuild& build, AtlasBuildReport& report) {
+			namespace fs = std::filesystem;
+			std::ifstream in(baseDir / (build.name + "_atlas.json"));
+			if (!in) return false;
+
+			const auto j = nlohmann::json::parse(in, nullptr, false);
+			if (j.is_discarded() || !j.contains("meta")) return false;
+			const auto& meta = j["meta"];
+			if (meta.value("cacheKey", std::string()) != build.cacheKey) return false;
+			if (!meta.contains("pages") || !meta["pages"].is_array() || meta["pages"].empty()) return false;
+
+			report = AtlasBuildReport{};
+			for (const auto& page : meta["pages"]) {
+				std::error_code ec;
+				if (!fs::is_regular_file(baseDir / page.value("image", std::string()), ec)) return false;
+				report.pageArea += uint64_t(page.value("width", 0)) * uint64_t(page.value("height", 0));
+				++report.pages;
+			}
+			report.images = meta.value("images", size_t(0));
+			report.rejected = meta.value("rejected", size_t(0));
+			report.usedArea = meta.value("usedArea", uint64_t(0));
+			report.efficiency = meta.value("efficiency", 0.0);
+			report.textureArray = meta.value("textureArray", false);
+			report.batchesPerPass = report.textureArray ? 1 : report.pages;
+			report.cached = true;
+			return true;
+		}
+	}
+
 	void RenderResourceManager::GenerateAtlases(const std::string& texturesSubfolder) {
 		namespace fs = std::filesystem;
 		fs::path baseDir = AssetManager::GetAssetsRoot() / texturesSubfolder;
@@ -230,102 +312,211 @@ namespace WanderSpire {
 		}
 
 		GLint glMax = 0;
-		glGetIntegerv(GL_MAX_TEXTURE_SIZE, &glMax);
-		int maxSize = glMax;
-
+		GL::Device::Get().GetIntegerv(GL_MAX_TEXTURE_SIZE, &glMax);
+		GLint glMaxLayers = 0;
+		GL::Device::Get().GetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &glMaxLayers);
+
+		const auto& cfg = ConfigManager::Get();
+		AtlasPackSettings settings;
+		settings.maxPageSize = glMax > 0 ? std::min(cfg.atlasMaxPageSize, static_cast<int>(glMax)) : cfg.atlasMaxPageSize;
+		settings.padding = cfg.atlasPadding;
+		settings.extrude = cfg.atlasExtrude;
+		settings.uniformPages = cfg.atlasTextureArray;
+		const AtlasPacker packer(settings);
+
+		std::vector<AtlasBuild> builds;
 		for (auto const& dirEntry : fs::directory_iterator(baseDir)) {
 			if (!dirEntry.is_directory()) continue;
-			std::string atlasName = dirEntry.path().filename().string();
+			AtlasBuild build;
+			build.name = dirEntry.path().filename().string();
+			build.dir = dirEntry.path();
+			builds.push_back(std::move(build));
+		}
 
-			struct Img { std::string name; int w, h; std::vector<unsigned char> data; };
-			std::vector<Img> images;
-			uint64_t totalArea = 0;
+		auto& jobs = RenderJobPool::Get();
 
-			// Load individual images
-			for (auto const& fileEntry : fs::directory_iterator(dirEntry.path())) {
-				auto ext = fileEntry.path().extension().string();
-				std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-				if (ext != ".png" && ext != ".jpg" && ext != ".jpeg") continue;
+		// 1) Read the source files and key each atlas by their contents; an
+		//    unchanged atlas is reused without decoding anything
+		jobs.Run(builds.size(), [&](size_t index) {
+			auto& build = builds[index];
+			std::vector<fs::path> files;
+			for (auto const& fileEntry : fs::directory_iterator(build.dir)) {
+				if (fileEntry.is_regular_file() && IsSupportedImageExtension(fileEntry.path().extension().string())) {
+					files.push_back(fileEntry.path());
+				}
+			}
+			std::sort(files.begin(), files.end());
 
-				int w, h, ch;
-				unsigned char* pix = stbi_load(
-					fileEntry.path().string().c_str(), &w, &h, &ch, 4
-				);
+			AtlasCacheKey key(settings, cfg.atlasTextureArray);
+			for (const auto& path : files) {
+				std::ifstream in(path, std::ios::binary);
+				if (!in) {
+					spdlog::error("[AtlasGen] fail to read '{}'", path.string());
+					continue;
+				}
+				AtlasSource source;
+				source.name = path.stem().string();
+				source.file.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+				key.AddSource(path.filename().string(), source.file.data(), source.file.size());
+				build.sources.push_back(std::move(source));
+			}
+			build.cacheKey = key.ToString();
+
+			if (!build.sources.empty() && LoadCachedAtlas(baseDir, build, build.report)) {
+				build.cached = true;
+				build.sources.clear();
+			}
+			});
+
+		// 2) Decode and pack the atlases that changed
+		jobs.Run(builds.size(), [&](size_t index) {
+			auto& build = builds[index];
+			if (build.cached) return;
+
+			std::vector<AtlasSource> decoded;
+			for (auto& source : build.sources) {
+				int ch = 0;
+				unsigned char* pix = stbi_load_from_memory(source.file.data(), static_cast<int>(source.file.size()),
+					&source.w, &source.h, &ch, 4);
 				if (!pix) {
-					spdlog::error("[AtlasGen] fail to load '{}'", fileEntry.path().string());
+					spdlog::error("[AtlasGen] fail to load '{}'", (build.dir / source.name).string());
 					continue;
 				}
-				Img img{ fileEntry.path().stem().string(), w, h, {} };
-				img.data.assign(pix, pix + w * h * 4);
+				source.pixels.assign(pix, pix + size_t(source.w) * size_t(source.h) * 4);
 				stbi_image_free(pix);
+				source.file = {};
+				decoded.push_back(std::move(source));
+			}
+			build.sources = std::move(decoded);
+			if (build.sources.empty()) return;
+
+			// MaxRects; what does not fit one page spills to the next
+			std::vector<AtlasPacker::Size> sizes;
+			sizes.reserve(build.sources.size());
+			for (auto const& source : build.sources) sizes.push_back({ source.w, source.h });
+			build.packed = packer.Pack(sizes);
+			});
 
-				images.push_back(std::move(img));
-				totalArea += uint64_t(w) * uint64_t(h);
+		// 3) Blit and encode every page of every changed atlas in parallel
+		std::vector<std::pair<size_t, size_t>> pageJobs;
+		for (size_t index = 0; index < builds.size(); ++index) {
+			for (size_t page = 0; page < builds[index].packed.pages.size(); ++page) pageJobs.emplace_back(index, page);
+		}
+		std::vector<uint8_t> pageFailed(pageJobs.size(), 0);
+		jobs.Run(pageJobs.size(), [&](size_t job) {
+			const auto& build = builds[pageJobs[job].first];
+			const size_t page = pageJobs[job].second;
+			const auto& info = build.packed.pages[page];
+
+			std::vector<unsigned char> buf(size_t(info.width) * size_t(info.height) * 4, 0);
+			for (size_t i = 0; i < build.sources.size(); ++i) {
+				const auto& placement = build.packed.placements[i];
+				if (placement.page != static_cast<int>(page)) continue;
+				AtlasPacker::Blit(buf, info.width, info.height, build.sources[i].pixels.data(),
+					build.sources[i].w, build.sources[i].h, placement.x, placement.y, settings.extrude);
 			}
 
-			if (images.empty()) {
-				spdlog::warn("[AtlasGen] '{}' empty", dirEntry.path().string());
-				continue;
+			const fs::path file = baseDir / AtlasPageFile(build.name, page);
+			if (!stbi_write_png(file.string().c_str(), info.width, info.height, 4, buf.data(), info.width * 4)) {
+				spdlog::error("[AtlasGen] fail to write '{}'", file.string());
+				pageFailed[job] = 1;
 			}
+			});
+		for (size_t job = 0; job < pageJobs.size(); ++job) {
+			if (pageFailed[job]) builds[pageJobs[job].first].writeFailed = true;
+		}
 
-			// Determine atlas size
-			float approx = std::sqrt((double)totalArea);
-			int atlasW = NextPow2(std::min(approx, (float)maxSize));
-			atlasW = std::max(atlasW, images[0].w);
-
-			// Pack images in simple shelf algorithm
-			struct Rect { std::string name; int x, y, w, h; };
-			std::vector<Rect> rects;
-			int x = 0, y = 0, shelf = 0;
-			for (auto const& img : images) {
-				if (x + img.w > atlasW) {
-					x = 0;
-					y += shelf;
-					shelf = 0;
-				}
-				rects.push_back({ img.name, x, y, img.w, img.h });
-				x += img.w;
-				shelf = std::max(shelf, img.h);
+		// 4) Mappings, reports and registration, in folder order
+		for (auto& build : builds) {
+			const std::string& atlasName = build.name;
+			fs::path atlasPng = baseDir / AtlasPageFile(atlasName, 0);
+			fs::path atlasJson = baseDir / (atlasName + "_atlas.json");
+
+			if (build.cached) {
+				spdlog::info("[AtlasGen] '{}' unchanged; reusing {}", atlasName, atlasJson.string());
 			}
-			int atlasH = NextPow2(y + shelf);
-
-			// Build atlas image buffer
-			std::vector<unsigned char> buf(atlasW * atlasH * 4, 0);
-			for (size_t i = 0; i < rects.size(); ++i) {
-				auto const& r = rects[i];
-				auto const& img = images[i];
-				for (int row = 0; row < r.h; ++row) {
-					unsigned char* dst = &buf[((r.y + row) * atlasW + r.x) * 4];
-					const unsigned char* src = img.data.data() + row * img.w * 4;
-					std::memcpy(dst, src, img.w * 4);
+			else {
+				if (build.sources.empty()) {
+					spdlog::warn("[AtlasGen] '{}' empty", build.dir.string());
+					continue;
 				}
-			}
 
-			// Write out PNG
-			fs::path atlasPng = baseDir / (atlasName + "_atlas.png");
-			stbi_write_png(
-				atlasPng.string().c_str(),
-				atlasW, atlasH, 4, buf.data(),
-				atlasW * 4
-			);
+				const auto& packed = build.packed;
+				for (size_t i = 0; i < build.sources.size(); ++i) {
+					if (packed.placements[i].page < 0) {
+						spdlog::warn("[AtlasGen] '{}' ({}x{}) does not fit a {}px page; left out of '{}'",
+							build.sources[i].name, build.sources[i].w, build.sources[i].h, settings.maxPageSize, atlasName);
+					}
+				}
+				if (packed.pages.empty()) continue;
+
+				const bool textureArray = cfg.atlasTextureArray &&
+					(glMaxLayers <= 0 || packed.pages.size() <= static_cast<size_t>(glMaxLayers));
+
+				nlohmann::json pagesJson = nlohmann::json::array();
+				for (size_t page = 0; page < packed.pages.size(); ++page) {
+					pagesJson.push_back({
+						{"image", AtlasPageFile(atlasName, page)},
+						{"width", packed.pages[page].width}, {"height", packed.pages[page].height}
+						});
+				}
+
+				// Pages a previous, larger build left behind
+				for (size_t page = packed.pages.size();; ++page) {
+					std::error_code ec;
+					if (!fs::remove(baseDir / AtlasPageFile(atlasName, page), ec)) break;
+				}
 
-			// Build JSON mapping
-			nlohmann::json j;
-			j["meta"] = { {"width", atlasW}, {"height", atlasH} };
-			for (auto const& r : rects) {
-				j["frames"][r.name] = {
-					{"x", r.x}, {"y", r.y},
-					{"w", r.w}, {"h", r.h}
+				// Report how well the layout packs and how many binds drawing from it takes
+				AtlasBuildReport& report = build.report;
+				report.images = build.sources.size() - packed.rejected;
+				report.pages = packed.pages.size();
+				report.rejected = packed.rejected;
+				report.usedArea = packed.UsedArea();
+				report.pageArea = packed.PageArea();
+				report.efficiency = packed.Efficiency();
+				report.textureArray = textureArray;
+				report.batchesPerPass = textureArray ? 1 : packed.pages.size();
+
+				// Build JSON mapping; it is written after the pages, so a build cut short never
+				// matches its key, and it carries no key if a page failed to write
+				nlohmann::json j;
+				j["meta"] = {
+					{"width", packed.pages[0].width}, {"height", packed.pages[0].height},
+					{"pages", pagesJson},
+					{"textureArray", textureArray},
+					{"padding", settings.padding}, {"extrude", settings.extrude},
+					{"efficiency", report.efficiency},
+					{"images", report.images}, {"rejected", report.rejected}, {"usedArea", report.usedArea}
 				};
+				if (!build.writeFailed) j["meta"]["cacheKey"] = build.cacheKey;
+				else spdlog::warn("[AtlasGen] '{}' has unwritten pages; it will be rebuilt next start", atlasName);
+				for (size_t i = 0; i < build.sources.size(); ++i) {
+					const auto& placement = packed.placements[i];
+					if (placement.page < 0) continue;
+					j["frames"][build.sources[i].name] = {
+						{"x", placement.x}, {"y", placement.y},
+						{"w", build.sources[i].w}, {"h", build.sources[i].h},
+						{"page", placement.page}
+					};
+				}
+
+				// Write out JSON
+				fs::create_directories(atlasJson.parent_path());
+				std::ofstream of(atlasJson.string(), std::ios::trunc);
+				of << j.dump(2);
+				of.close();
+				spdlog::info("[AtlasGen] Wrote mapping {}", atlasJson.string());
+
+				build.sources = {};
+				build.packed = {};
 			}
 
-			// Write out JSON
-			fs::path atlasJson = baseDir / (atlasName + "_atlas.json");
-			fs::create_directories(atlasJson.parent_path());
-			std::ofstream of(atlasJson.string(), std::ios::trunc);
-			of << j.dump(2);
-			of.close();
-			spdlog::info("[AtlasGen] Wrote mapping {}", atlasJson.string());
+			const AtlasBuildReport& report = build.report;
+			m_AtlasReports[atlasName] = report;
+			spdlog::info("[AtlasGen] '{}': {} images on {} page(s), {:.1f}% packed, {} batch(es) per pass{}{}",
+				atlasName, report.images, report.pages, report.efficiency * 100.0, report.batchesPerPass,
+				report.textureArray ? " (texture array)" : "", report.cached ? " (cached)" : "");
 
 			// **Always** register the atlas for use (hot-reload will catch updates)
 			RegisterAtlas(
@@ -337,4 +528,9 @@ namespace WanderSpire {
 		}
 	}
 
+	const AtlasBuildReport* RenderResourceManager::GetAtlasReport(const std::string& name) const {
+		auto it = m_AtlasReports.find(name);
+		return it != m_AtlasReports.end() ? &it->second : nullptr;
+	}
+
 }
\ No newline at end of file
@@ -0,0 +1,290 @@
+#include "WanderSpire/Graphics/RenderThread.h"
+#include "WanderSpire/Graphics/RenderManager.h"
+
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+namespace WanderSpire {
+
+	namespace {
+		/// Weight of the newest sample in the running averages
+		constexpr double SMOOTHING = 0.1;
+
+		thread_local bool t_isRenderThread = false;
+		thread_local int  t_scopeDepth = 0;
+
+		double MicrosSince(std::chrono::steady_clock::time_point start) {
+			return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		void Smooth(double& average, double sample) {
+			average = average == 0.0 ? sample : average + (sample - average) * SMOOTHING;
+		}
+	}
+
+	void RenderBackend::Execute(FramePacket& packet) {
+		RenderManager::ExecutePacket(packet);
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Lifetime
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	RenderThread& RenderThread::Get() {
+		static RenderThread instance;
+		return instance;
+	}
+
+	RenderThread::RenderThread()
+		: m_backend(std::make_unique<RenderBackend>())
+	{
+	}
+
+	RenderThread::~RenderThread() {
+		Stop();
+	}
+
+	void RenderThread::SetBackend(std::unique_ptr<RenderBackend> backend) {
+		std::lock_guard lock(m_mutex);
+		if (IsThreaded()) {
+			spdlog::error("[RenderThread] Stop the render thread before replacing its backend");
+			return;
+		}
+		m_backend = backend ? std::move(backend) : std::make_unique<RenderBackend>();
+	}
+
+	bool RenderThread::Start() {
+		std::unique_lock lock(m_mutex);
+		if (IsThreaded()) return true;
+
+		m_backend->DetachContext();
+		m_stopping = false;
+		m_startState = StartState::Pending;
+		m_thread = std::thread(&RenderThread::ThreadLoop, this);
+		m_changed.wait(lock, [this] { return m_startState != StartState::Pending; });
+
+		if (m_startState == StartState::Failed) {
+			lock.unlock();
+			m_thread.join();
+			m_backend->AttachContext();
+			spdlog::error("[RenderThread] The render thread could not take the GL context; rendering stays on this thread");
+			return false;
+		}
+
+		m_threaded.store(true, std::memory_order_release);
+		m_stats.threaded = true;
+		spdlog::info("[RenderThread] Rendering on a dedicated thread");
+		return true;
+	}
+
+	void RenderThread::Stop() {
+		{
+			std::lock_guard lock(m_mutex);
+			if (!IsThreaded()) return;
+			m_stopping = true;
+		}
+		m_wake.notify_all();
+		m_thread.join();   // Draws whatever is still queued first
+
+		std::lock_guard lock(m_mutex);
+		m_threaded.store(false, std::memory_order_release);
+		m_stopping = false;
+		m_stats.threaded = false;
+		m_backend->AttachContext();
+		spdlog::info("[RenderThread] Rendering back on the calling thread");
+	}
+
+	bool RenderThread::OwnsContext() const {
+		return !IsThreaded() || t_isRenderThread || t_scopeDepth > 0;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Producer side
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void RenderThread::Pace() {
+		const auto start = std::chrono::steady_clock::now();
+
+		if (IsThreaded()) {
+			std::unique_lock lock(m_mutex);
+			// Double buffering: the slot the next packet goes into must be free
+			m_changed.wait(lock, [this] { return m_slots[m_write].state == SlotState::Free; });
+
+			// If drawing the current packet will take longer than building the next
+			// one, start later so the next frame is built from fresher input
+			if (m_slots[m_write ^ 1].state == SlotState::Executing) {
+				const double remaining = m_stats.averageRenderMicros - MicrosSince(m_executeStart);
+				const double slack = std::min(remaining - m_stats.averageBuildMicros, m_stats.averageRenderMicros);
+				if (slack > 0.0) {
+					m_changed.wait_for(lock, std::chrono::duration<double, std::micro>(slack),
+						[this] { return m_slots[m_write ^ 1].state != SlotState::Executing; });
+				}
+			}
+		}
+
+		m_buildStart = std::chrono::steady_clock::now();
+		const double waited = std::chrono::duration<double, std::micro>(m_buildStart - start).count();
+		std::lock_guard lock(m_mutex);
+		m_stats.lastPaceWaitMicros = waited;
+		m_stats.paceWaitMicros += waited;
+	}
+
+	FramePacket& RenderThread::BeginPacket() {
+		if (IsThreaded()) {
+			std::unique_lock lock(m_mutex);
+			m_changed.wait(lock, [this] { return m_slots[m_write].state == SlotState::Free; });
+		}
+		return m_slots[m_write].packet;
+	}
+
+	void RenderThread::SubmitPacket() {
+		{
+			std::lock_guard lock(m_mutex);
+			++m_stats.framesSubmitted;
+			if (m_buildStart != std::chrono::steady_clock::time_point{}) {
+				Smooth(m_stats.averageBuildMicros, MicrosSince(m_buildStart));
+				m_buildStart = {};
+			}
+			if (IsThreaded()) {
+				m_slots[m_write].state = SlotState::Ready;
+				m_write ^= 1;
+			}
+		}
+
+		if (IsThreaded()) {
+			m_wake.notify_all();
+			return;
+		}
+		Process(m_slots[m_write].packet);
+	}
+
+	void RenderThread::Flush() {
+		std::unique_lock lock(m_mutex);
+		m_changed.wait(lock, [this] {
+			return !IsThreaded() ||
+				(m_slots[0].state == SlotState::Free && m_slots[1].state == SlotState::Free);
+			});
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Render side
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void RenderThread::ThreadLoop() {
+		t_isRenderThread = true;
+
+		std::unique_lock lock(m_mutex);
+		const bool attached = m_backend->AttachContext();
+		m_startState = attached ? StartState::Running : StartState::Failed;
+		m_changed.notify_all();
+		if (!attached) return;
+
+		while (true) {
+			m_wake.wait(lock, [this] {
+				return m_slots[m_read].state == SlotState::Ready || m_borrowRequested || m_stopping;
+				});
+
+			// Queued packets go first, so borrowers and Stop() see their results
+			auto& slot = m_slots[m_read];
+			if (slot.state == SlotState::Ready) {
+				slot.state = SlotState::Executing;
+				m_executeStart = std::chrono::steady_clock::now();
+				lock.unlock();
+				Process(slot.packet);
+				lock.lock();
+				slot.state = SlotState::Free;
+				m_read ^= 1;
+				m_changed.notify_all();
+				continue;
+			}
+
+			if (m_borrowRequested) {
+				m_backend->DetachContext();
+				m_lent = true;
+				m_changed.notify_all();
+				m_wake.wait(lock, [this] { return !m_borrowRequested; });
+				m_backend->AttachContext();
+				m_lent = false;
+				m_changed.notify_all();
+				continue;
+			}
+
+			break;   // Stopping, and nothing left to draw
+		}
+
+		m_backend->DetachContext();
+	}
+
+	void RenderThread::Process(FramePacket& packet) {
+		const auto start = std::chrono::steady_clock::now();
+		try {
+			m_backend->Execute(packet);
+			m_backend->Present(packet);
+		}
+		catch (const std::exception& e) {
+			spdlog::error("[RenderThread] Frame {} failed: {}", packet.frameIndex, e.what());
+		}
+		packet.commands.clear();
+		packet.hasViewport = false;
+
+		const double micros = MicrosSince(start);
+		std::lock_guard lock(m_mutex);
+		++m_stats.framesPresented;
+		m_stats.lastRenderMicros = micros;
+		Smooth(m_stats.averageRenderMicros, micros);
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Borrowing the context
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	bool RenderThread::Borrow() {
+		if (t_isRenderThread) return false;
+
+		std::unique_lock lock(m_mutex);
+		if (!IsThreaded()) return false;
+
+		// One borrower at a time, and only once the last one's context went back
+		m_changed.wait(lock, [this] { return !m_borrowRequested && !m_lent; });
+		m_borrowRequested = true;
+		m_wake.notify_all();
+		m_changed.wait(lock, [this] { return m_lent; });
+
+		m_backend->AttachContext();
+		++m_stats.contextBorrows;
+		return true;
+	}
+
+	void RenderThread::Return() {
+		std::unique_lock lock(m_mutex);
+		m_backend->DetachContext();
+		m_borrowRequested = false;
+		m_wake.notify_all();
+		m_changed.wait(lock, [this] { return !m_lent; });
+	}
+
+	RenderThread::ContextScope::ContextScope() {
+		if (t_scopeDepth++ == 0) m_borrowed = RenderThread::Get().Borrow();
+	}
+
+	RenderThread::ContextScope::~ContextScope() {
+		if (m_borrowed) RenderThread::Get().Return();
+		--t_scopeDepth;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Statistics
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	RenderThreadStats RenderThread::GetStats() const {
+		std::lock_guard lock(m_mutex);
+		return m_stats;
+	}
+
+	void RenderThread::ResetStats() {
+		std::lock_guard lock(m_mutex);
+		m_stats = RenderThreadStats{};
+		m_stats.threaded = IsThreaded();
+	}
+
+} // namespace WanderSpire
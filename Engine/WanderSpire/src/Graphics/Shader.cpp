@@ -1,6 +1,11 @@
 ﻿// src/Graphics/Shader.cpp
 #include "WanderSpire/Graphics/Shader.h"
 #include "WanderSpire/Core/AssetManager.h"
+#include "WanderSpire/Graphics/GLDevice.h"
+#include "WanderSpire/Graphics/GLStateCache.h"
+#include "WanderSpire/Graphics/FrameUniforms.h"
+
+#include <cstring>
 
 namespace WanderSpire {
 
@@ -25,61 +30,78 @@ namespace WanderSpire {
 
 	Shader::~Shader() {
 		if (m_ProgramID) {
-			glDeleteProgram(m_ProgramID);
+			GL::StateCache::Get().ForgetProgram(m_ProgramID);
+			GL::Device::Get().DeleteProgram(m_ProgramID);
 			spdlog::info("[Shader] Deleted program {}", m_ProgramID);
 		}
 	}
 
 	void Shader::CompileFromSource(const std::string& vsSource, const std::string& fsSource) {
-		if (m_ProgramID) {
-			glDeleteProgram(m_ProgramID);
-			m_UniformLocationCache.clear();
-		}
-
+		// A failed (re)compile keeps the previous program running
+		auto& gl = GL::Device::Get();
 		GLuint vs = CompileShader(GL_VERTEX_SHADER, vsSource);
 		GLuint fs = CompileShader(GL_FRAGMENT_SHADER, fsSource);
 		if (!vs || !fs) {
 			spdlog::error("[Shader] Skipping link due to compile errors");
-			if (vs) glDeleteShader(vs);
-			if (fs) glDeleteShader(fs);
+			if (vs) gl.DeleteShader(vs);
+			if (fs) gl.DeleteShader(fs);
 			return;
 		}
 
-		m_ProgramID = glCreateProgram();
-		glAttachShader(m_ProgramID, vs);
-		glAttachShader(m_ProgramID, fs);
-		glLinkProgram(m_ProgramID);
+		GLuint program = gl.CreateProgram();
+		gl.AttachShader(program, vs);
+		gl.AttachShader(program, fs);
+		gl.LinkProgram(program);
+		gl.DeleteShader(vs);
+		gl.DeleteShader(fs);
 
 		GLint success;
-		glGetProgramiv(m_ProgramID, GL_LINK_STATUS, &success);
+		gl.GetProgramiv(program, GL_LINK_STATUS, &success);
 		if (!success) {
 			char buf[512];
-			glGetProgramInfoLog(m_ProgramID, 512, nullptr, buf);
+			gl.GetProgramInfoLog(program, 512, buf);
 			spdlog::error("[Shader] Link Error: {}", buf);
-			glDeleteProgram(m_ProgramID);
-			m_ProgramID = 0;
+			gl.DeleteProgram(program);
+			return;
+		}
+
+		if (m_ProgramID) {
+			GL::StateCache::Get().ForgetProgram(m_ProgramID);
+			gl.DeleteProgram(m_ProgramID);
 		}
+		m_ProgramID = program;
+
+		// Shared per-frame data comes from the FrameUniforms buffer
+		const GLuint block = gl.GetUniformBlockIndex(m_ProgramID, FrameUniforms::BLOCK_NAME);
+		if (block != GL_INVALID_INDEX)
+			gl.UniformBlockBinding(m_ProgramID, block, FrameUniforms::BINDING);
 
-		glDeleteShader(vs);
-		glDeleteShader(fs);
+		ResolveUniforms();
+		spdlog::info("[Shader] Linked program {}", m_ProgramID);
+	}
 
-		if (m_ProgramID)
-			spdlog::info("[Shader] Linked program {}", m_ProgramID);
+	void Shader::Release() {
+		if (!m_ProgramID) return;
+		GL::StateCache::Get().ForgetProgram(m_ProgramID);
+		GL::Device::Get().DeleteProgram(m_ProgramID);
+		m_ProgramID = 0;
+		ResolveUniforms();
 	}
 
 	GLuint Shader::CompileShader(GLenum type, const std::string& src) {
-		GLuint sh = glCreateShader(type);
+		auto& gl = GL::Device::Get();
+		GLuint sh = gl.CreateShader(type);
 		const char* c = src.c_str();
-		glShaderSource(sh, 1, &c, nullptr);
-		glCompileShader(sh);
+		gl.ShaderSource(sh, c);
+		gl.CompileShader(sh);
 
 		GLint ok;
-		glGetShaderiv(sh, GL_COMPILE_STATUS, &ok);
+		gl.GetShaderiv(sh, GL_COMPILE_STATUS, &ok);
 		if (!ok) {
 			char buf[512];
-			glGetShaderInfoLog(sh, 512, nullptr, buf);
+			gl.GetShaderInfoLog(sh, 512, buf);
 			spdlog::error("[Shader] Compile Error (type={}): {}", type, buf);
-			glDeleteShader(sh);
+			gl.DeleteShader(sh);
 			return 0;
 		}
 		return sh;
@@ -90,36 +112,71 @@ namespace WanderSpire {
 			spdlog::warn("[Shader] Bind() called on invalid program");
 			return;
 		}
-		if (s_CurrentProgramID != m_ProgramID) {
-			glUseProgram(m_ProgramID);
-			s_CurrentProgramID = m_ProgramID;
-		}
+		GL::StateCache::Get().UseProgram(m_ProgramID);
 	}
 
 	void Shader::Unbind() const {
-		glUseProgram(0);
-		s_CurrentProgramID = 0;
+		GL::StateCache::Get().UseProgram(0);
 	}
 
-	GLint Shader::GetUniformLocation(const std::string& name) {
-		if (auto it = m_UniformLocationCache.find(name); it != m_UniformLocationCache.end())
+	// ─── Uniform handles ─────────────────────────────────────────────────
+
+	UniformHandle Shader::DeclareUniform(const std::string& name) {
+		if (auto it = m_UniformHandles.find(name); it != m_UniformHandles.end())
 			return it->second;
-		GLint loc = glGetUniformLocation(m_ProgramID, name.c_str());
-		if (loc == -1) spdlog::warn("[Shader] Uniform '{}' not found.", name);
-		m_UniformLocationCache[name] = loc;
-		return loc;
+
+		const auto handle = static_cast<UniformHandle>(m_Uniforms.size());
+		auto& slot = m_Uniforms.emplace_back();
+		slot.name = name;
+		if (m_ProgramID) {
+			slot.location = GL::Device::Get().GetUniformLocation(m_ProgramID, name.c_str());
+			if (slot.location == -1) spdlog::warn("[Shader] Uniform '{}' not found.", name);
+		}
+		m_UniformHandles.emplace(name, handle);
+		return handle;
+	}
+
+	void Shader::ResolveUniforms() {
+		// A (re)linked program starts with default values: nothing is known
+		for (auto& slot : m_Uniforms) {
+			slot.known = false;
+			slot.location = m_ProgramID ? GL::Device::Get().GetUniformLocation(m_ProgramID, slot.name.c_str()) : -1;
+			if (m_ProgramID && slot.location == -1)
+				spdlog::warn("[Shader] Uniform '{}' not found.", slot.name);
+		}
 	}
 
-	void Shader::SetUniformInt(const std::string& name, int val) { glUniform1i(GetUniformLocation(name), val); }
-	void Shader::SetUniformFloat(const std::string& name, float v) { glUniform1f(GetUniformLocation(name), v); }
-	void Shader::SetUniformVec2(const std::string& name, const glm::vec2& v) {
-		glUniform2f(GetUniformLocation(name), v.x, v.y);
+	Shader::UniformSlot* Shader::Changed(UniformHandle handle, const void* value, size_t bytes) {
+		if (handle < 0 || handle >= static_cast<UniformHandle>(m_Uniforms.size())) return nullptr;
+		auto& slot = m_Uniforms[handle];
+		if (slot.location == -1) return nullptr;
+		if (slot.known && std::memcmp(slot.value, value, bytes) == 0) return nullptr;
+
+		std::memcpy(slot.value, value, bytes);
+		slot.known = true;
+		return &slot;
+	}
+
+	void Shader::Set(UniformHandle handle, int value) {
+		if (auto* slot = Changed(handle, &value, sizeof(value))) GL::Device::Get().Uniform1i(slot->location, value);
 	}
-	void Shader::SetUniformVec3(const std::string& name, const glm::vec3& v) {
-		glUniform3f(GetUniformLocation(name), v.x, v.y, v.z);
+	void Shader::Set(UniformHandle handle, float value) {
+		if (auto* slot = Changed(handle, &value, sizeof(value))) GL::Device::Get().Uniform1f(slot->location, value);
 	}
-	void Shader::SetUniformMat4(const std::string& name, const glm::mat4& m) {
-		glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &m[0][0]);
+	void Shader::Set(UniformHandle handle, const glm::vec2& v) {
+		if (auto* slot = Changed(handle, &v, sizeof(v))) GL::Device::Get().Uniform2f(slot->location, v.x, v.y);
 	}
+	void Shader::Set(UniformHandle handle, const glm::vec3& v) {
+		if (auto* slot = Changed(handle, &v, sizeof(v))) GL::Device::Get().Uniform3f(slot->location, v.x, v.y, v.z);
+	}
+	void Shader::Set(UniformHandle handle, const glm::mat4& m) {
+		if (auto* slot = Changed(handle, &m, sizeof(m))) GL::Device::Get().UniformMatrix4fv(slot->location, 1, GL_FALSE, &m[0][0]);
+	}
+
+	void Shader::SetUniformInt(const std::string& name, int val) { Set(DeclareUniform(name), val); }
+	void Shader::SetUniformFloat(const std::string& name, float v) { Set(DeclareUniform(name), v); }
+	void Shader::SetUniformVec2(const std::string& name, const glm::vec2& v) { Set(DeclareUniform(name), v); }
+	void Shader::SetUniformVec3(const std::string& name, const glm::vec3& v) { Set(DeclareUniform(name), v); }
+	void Shader::SetUniformMat4(const std::string& name, const glm::mat4& m) { Set(DeclareUniform(name), m); }
 
 }
\ No newline at end of file
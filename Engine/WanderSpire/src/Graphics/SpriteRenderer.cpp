@@ -3,6 +3,9 @@
 // ─────────────────────────────────────────────────────────────────────────────
 #include "WanderSpire/Graphics/SpriteRenderer.h"
 #include "WanderSpire/Graphics/RenderResourceManager.h"
+#include "WanderSpire/Graphics/GLDevice.h"
+#include "WanderSpire/Graphics/GLStateCache.h"
+#include "WanderSpire/Graphics/FrameUniforms.h"
 #include <spdlog/spdlog.h>
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -14,12 +17,18 @@ namespace WanderSpire {
 		if (!m_Shader)
 			spdlog::error("[SpriteRenderer] 'sprite' shader not found!");
 
-		/* one‑time sampler / uniform setup */
-		if (m_Shader && m_Shader->GetID()) {
-			m_Shader->Bind();
-			m_Shader->SetUniformInt("u_Texture", 0);
-			m_Shader->SetUniformInt("u_UseTexture", 1);
-			m_Shader->Unbind();
+		/* uniforms are looked up once; the shader re-resolves them on (re)link */
+		if (m_Shader) {
+			m_Uniforms.texture = m_Shader->DeclareUniform("u_Texture");
+			m_Uniforms.useTexture = m_Shader->DeclareUniform("u_UseTexture");
+			m_Uniforms.useInstancing = m_Shader->DeclareUniform("u_UseInstancing");
+			m_Uniforms.model = m_Shader->DeclareUniform("u_Model");
+			m_Uniforms.color = m_Shader->DeclareUniform("u_Color");
+			m_Uniforms.uvOffset = m_Shader->DeclareUniform("u_UVOffset");
+			m_Uniforms.uvSize = m_Shader->DeclareUniform("u_UVSize");
+			m_Uniforms.textureArray = m_Shader->DeclareUniform("u_TextureArray");
+			m_Uniforms.useTextureArray = m_Shader->DeclareUniform("u_UseTextureArray");
+			m_Uniforms.layer = m_Shader->DeclareUniform("u_Layer");
 		}
 
 		m_QuadVAO = RenderResourceManager::Get().GetQuadVAO();
@@ -35,23 +44,26 @@ namespace WanderSpire {
 
 	void SpriteRenderer::BeginFrame(const glm::mat4& viewProjection)
 	{
+		/* view-projection goes to the shared FrameData block, once per view */
+		FrameUniforms::Get().BeginView(viewProjection);
+
 		auto& rm = RenderResourceManager::Get();
 		if (!m_Shader || !m_Shader->GetID()
 			|| rm.GetQuadVAO() == 0 || rm.GetQuadEBO() == 0)
 			return;
 
 		m_Shader->Bind();
-		m_Shader->SetUniformMat4("u_ViewProjection", viewProjection);
-		m_Shader->SetUniformInt("u_UseTexture", 1);
-		m_Shader->SetUniformInt("u_UseInstancing", 0);   // sprites only
+		m_Shader->Set(m_Uniforms.texture, 0);
+		m_Shader->Set(m_Uniforms.textureArray, 1);     // atlas page arrays
+		m_Shader->Set(m_Uniforms.useInstancing, 0);   // sprites only
 
-		glBindVertexArray(rm.GetQuadVAO());
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, rm.GetQuadEBO());
+		GL::StateCache::Get().BindVertexArray(rm.GetQuadVAO());
+		GL::StateCache::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, rm.GetQuadEBO());
 	}
 
 	void SpriteRenderer::EndFrame()
 	{
-		glBindVertexArray(0);
+		GL::StateCache::Get().BindVertexArray(0);
 		if (m_Shader && m_Shader->GetID())
 			m_Shader->Unbind();
 	}
@@ -64,23 +76,30 @@ namespace WanderSpire {
 		float           rotation,
 		const glm::vec3& color,
 		const glm::vec2& uvMin,
-		const glm::vec2& uvSize)
+		const glm::vec2& uvSize,
+		int             layer)
 	{
 		auto& rm = RenderResourceManager::Get();
 		if (!m_Shader || !m_Shader->GetID()
 			|| rm.GetQuadVAO() == 0 || rm.GetQuadEBO() == 0)
 			return;
 
-		/* ensure VAO/EBO are bound (user may interleave raw GL elsewhere) */
-		glBindVertexArray(rm.GetQuadVAO());
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, rm.GetQuadEBO());
+		/* ensure VAO/EBO are bound; free when BeginFrame already did */
+		GL::StateCache::Get().BindVertexArray(rm.GetQuadVAO());
+		GL::StateCache::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, rm.GetQuadEBO());
 
 		const bool useTex = (textureID != 0);
-		m_Shader->SetUniformInt("u_UseTexture", useTex ? 1 : 0);
-
-		if (useTex) {
-			glActiveTexture(GL_TEXTURE0);
-			glBindTexture(GL_TEXTURE_2D, textureID);
+		const bool useArray = useTex && layer >= 0;
+		m_Shader->Set(m_Uniforms.useTexture, useTex ? 1 : 0);
+		m_Shader->Set(m_Uniforms.useTextureArray, useArray ? 1 : 0);
+
+		/* sprites of every page of an array atlas share one bind */
+		if (useArray) {
+			GL::StateCache::Get().BindTexture(GL_TEXTURE_2D_ARRAY, textureID, 1);
+			m_Shader->Set(m_Uniforms.layer, static_cast<float>(layer));
+		}
+		else if (useTex) {
+			GL::StateCache::Get().BindTexture(GL_TEXTURE_2D, textureID, 0);
 		}
 
 		/*  IMPORTANT CHANGE  – the incoming position is already the quad
@@ -90,15 +109,13 @@ namespace WanderSpire {
 		model = glm::rotate(model, rotation, glm::vec3(0, 0, 1));
 		model = glm::scale(model, glm::vec3(size, 1.0f));
 
-		m_Shader->SetUniformMat4("u_Model", model);
-		m_Shader->SetUniformVec3("u_Color", color);
-		m_Shader->SetUniformVec2("u_UVOffset", uvMin);
-		m_Shader->SetUniformVec2("u_UVSize", uvSize);
-
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+		/* unchanged values (color, UVs of a repeated sprite) are not re-sent */
+		m_Shader->Set(m_Uniforms.model, model);
+		m_Shader->Set(m_Uniforms.color, color);
+		m_Shader->Set(m_Uniforms.uvOffset, uvMin);
+		m_Shader->Set(m_Uniforms.uvSize, uvSize);
 
-		/* restore default (textured) state so the next call is predictable */
-		m_Shader->SetUniformInt("u_UseTexture", 1);
+		GL::Device::Get().DrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
 	}
 
 	/* helper for debug overlays */
@@ -0,0 +1,282 @@
+#include "WanderSpire/Graphics/StreamBuffer.h"
+#include "WanderSpire/Graphics/GLDevice.h"
+#include "WanderSpire/Graphics/GLStateCache.h"
+
+#include <chrono>
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+namespace WanderSpire {
+
+	namespace {
+
+		// ─────────────────────────────────────────────────────────────────────
+		// GL device
+		// ─────────────────────────────────────────────────────────────────────
+
+		class GLStreamBufferDevice final : public StreamBufferDevice {
+		public:
+			bool SupportsPersistentMapping() const override {
+				return GL::Device::Get().SupportsBufferStorage();
+			}
+
+			bool CreateStorage(size_t capacity, bool persistent, void** outMapping) override {
+				auto& gl = GL::Device::Get();
+				m_buffer = gl.GenBuffer();
+				GL::StateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_buffer);
+
+				if (persistent) {
+					constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+					gl.BufferStorage(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(capacity), nullptr, flags);
+					*outMapping = gl.MapBufferRange(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(capacity), flags);
+				}
+				else {
+					gl.BufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(capacity), nullptr, GL_STREAM_DRAW);
+				}
+
+				GL::StateCache::Get().BindBuffer(GL_ARRAY_BUFFER, 0);
+				return m_buffer != 0 && (!persistent || *outMapping);
+			}
+
+			void DestroyStorage() override {
+				if (m_buffer != 0) {
+					GL::StateCache::Get().ForgetBuffer(m_buffer);
+					GL::Device::Get().DeleteBuffer(m_buffer);   // Also unmaps
+					m_buffer = 0;
+				}
+			}
+
+			GLuint GetBuffer() const override { return m_buffer; }
+
+			void* MapRange(size_t offset, size_t size) override {
+				GL::StateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_buffer);
+				return GL::Device::Get().MapBufferRange(GL_ARRAY_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size),
+					GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+			}
+
+			void UnmapRange() override {
+				GL::StateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_buffer);
+				GL::Device::Get().UnmapBuffer(GL_ARRAY_BUFFER);
+			}
+
+			uint64_t InsertFence() override {
+				return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(GL::Device::Get().FenceSync()));
+			}
+
+			bool WaitFence(uint64_t fence, uint64_t timeoutNanos) override {
+				auto sync = reinterpret_cast<GLsync>(static_cast<uintptr_t>(fence));
+				const GLenum result = GL::Device::Get().ClientWaitSync(sync, timeoutNanos ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, timeoutNanos);
+				if (result == GL_WAIT_FAILED) {
+					spdlog::error("[StreamBuffer] glClientWaitSync failed");
+					return true;
+				}
+				return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+			}
+
+			void DeleteFence(uint64_t fence) override {
+				GL::Device::Get().DeleteSync(reinterpret_cast<GLsync>(static_cast<uintptr_t>(fence)));
+			}
+
+		private:
+			GLuint m_buffer = 0;
+		};
+
+		size_t AlignUp(size_t value, size_t alignment) {
+			return (value + alignment - 1) / alignment * alignment;
+		}
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Lifetime
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	StreamBuffer& StreamBuffer::Get() {
+		static StreamBuffer instance;
+		return instance;
+	}
+
+	StreamBuffer::~StreamBuffer() {
+		Shutdown();
+	}
+
+	bool StreamBuffer::Initialize(size_t capacity, size_t framesInFlight, std::unique_ptr<StreamBufferDevice> device) {
+		Shutdown();
+		if (capacity == 0) return false;
+
+		m_device = device ? std::move(device) : std::make_unique<GLStreamBufferDevice>();
+		m_capacity = capacity;
+		m_maxFramesInFlight = framesInFlight > 0 ? framesInFlight : 1;
+
+		const bool persistent = m_device->SupportsPersistentMapping();
+		void* mapping = nullptr;
+		if (!m_device->CreateStorage(capacity, persistent, &mapping)) {
+			spdlog::error("[StreamBuffer] Failed to create a {} byte stream buffer", capacity);
+			m_device->DestroyStorage();
+			m_device.reset();
+			return false;
+		}
+		m_mapping = static_cast<uint8_t*>(mapping);
+
+		ResetStats();
+		spdlog::info("[StreamBuffer] {} KiB ring, {} frames in flight, {}", capacity / 1024, m_maxFramesInFlight,
+			persistent ? "persistently mapped" : "mapped per allocation");
+		return true;
+	}
+
+	void StreamBuffer::Shutdown() {
+		if (!m_device) return;
+
+		if (m_rangeMapped) m_device->UnmapRange();
+		for (const auto& frame : m_inFlight) m_device->DeleteFence(frame.fence);
+		m_device->DestroyStorage();
+		m_device.reset();
+
+		m_inFlight.clear();
+		m_mapping = nullptr;
+		m_rangeMapped = false;
+		m_capacity = 0;
+		m_head = m_used = m_frameBytes = 0;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Allocation
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	StreamBuffer::Allocation StreamBuffer::Allocate(size_t size, StreamUsage usage, size_t alignment) {
+		if (!m_device || size == 0) return {};
+		if (alignment == 0) alignment = 1;
+		if (size > m_capacity) {
+			++m_stats.failedAllocations;
+			spdlog::warn("[StreamBuffer] {} byte allocation exceeds the {} byte ring", size, m_capacity);
+			return {};
+		}
+
+		// The previous allocation must be unmapped before mapping another range
+		if (m_rangeMapped) {
+			m_device->UnmapRange();
+			m_rangeMapped = false;
+		}
+
+		size_t offset = 0;
+		size_t need = 0;
+		bool wrap = false;
+		for (;;) {
+			offset = AlignUp(m_head, alignment);
+			wrap = offset + size > m_capacity;
+			if (wrap) offset = 0;
+			// Wrapping gives up the tail of the ring until this frame is reclaimed
+			need = (wrap ? m_capacity - m_head : offset - m_head) + size;
+			if (m_capacity - m_used >= need) break;
+
+			if (!m_inFlight.empty()) RetireOldest(true);
+			else if (m_frameBytes > 0) FenceCurrentFrame();   // This frame alone filled the ring
+			else m_head = 0;                                  // Empty ring: start over at the front
+		}
+
+		if (wrap) ++m_stats.wraps;
+		m_head = offset + size;
+		m_used += need;
+		m_frameBytes += need;
+
+		Allocation allocation;
+		allocation.offset = offset;
+		allocation.size = size;
+		allocation.buffer = m_device->GetBuffer();
+		if (m_mapping) {
+			allocation.data = m_mapping + offset;
+		}
+		else {
+			allocation.data = m_device->MapRange(offset, size);
+			m_rangeMapped = allocation.data != nullptr;
+		}
+
+		if (!allocation.data) {
+			++m_stats.failedAllocations;
+			return {};
+		}
+
+		++m_stats.allocations;
+		m_stats.bytesThisFrame += size;
+		m_stats.bytesTotal += size;
+		m_usageBytes[static_cast<size_t>(usage)] += size;
+		return allocation;
+	}
+
+	void StreamBuffer::Commit(const Allocation& allocation) {
+		if (!allocation || m_mapping || !m_rangeMapped) return;
+		m_device->UnmapRange();
+		m_rangeMapped = false;
+	}
+
+	StreamBuffer::Allocation StreamBuffer::Upload(const void* data, size_t size, StreamUsage usage, size_t alignment) {
+		Allocation allocation = Allocate(size, usage, alignment);
+		if (!allocation) return {};
+		std::memcpy(allocation.data, data, size);
+		Commit(allocation);
+		return allocation;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Frame fences
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void StreamBuffer::EndFrame() {
+		if (!m_device) return;
+
+		if (m_rangeMapped) {
+			m_device->UnmapRange();
+			m_rangeMapped = false;
+		}
+		FenceCurrentFrame();
+
+		// Frames older than the limit are reclaimed even if that means waiting;
+		// newer ones only once the GPU is done with them
+		while (m_inFlight.size() > m_maxFramesInFlight) RetireOldest(true);
+		while (!m_inFlight.empty() && RetireOldest(false)) {}
+
+		m_stats.bytesLastFrame = m_stats.bytesThisFrame;
+		m_stats.bytesThisFrame = 0;
+		for (size_t i = 0; i < static_cast<size_t>(StreamUsage::Count); ++i) {
+			m_stats.bytesLastFrameByUsage[i] = m_usageBytes[i];
+			m_usageBytes[i] = 0;
+		}
+		++m_stats.frames;
+		m_stats.framesInFlight = m_inFlight.size();
+	}
+
+	void StreamBuffer::FenceCurrentFrame() {
+		if (m_frameBytes == 0) return;
+		m_inFlight.push_back({ m_device->InsertFence(), m_frameBytes });
+		m_frameBytes = 0;
+	}
+
+	bool StreamBuffer::RetireOldest(bool wait) {
+		const FencedFrame frame = m_inFlight.front();
+
+		if (!m_device->WaitFence(frame.fence, 0)) {
+			if (!wait) return false;
+
+			++m_stats.stalls;
+			const auto start = std::chrono::steady_clock::now();
+			while (!m_device->WaitFence(frame.fence, 1'000'000'000ull)) {
+				spdlog::warn("[StreamBuffer] Still waiting for the GPU to release stream buffer space");
+			}
+			m_stats.stallMicros += std::chrono::duration<double, std::micro>(
+				std::chrono::steady_clock::now() - start).count();
+		}
+
+		m_device->DeleteFence(frame.fence);
+		m_used -= frame.bytes;
+		m_inFlight.pop_front();
+		return true;
+	}
+
+	void StreamBuffer::ResetStats() {
+		m_stats = StreamBufferStats{};
+		for (auto& bytes : m_usageBytes) bytes = 0;
+		m_stats.capacity = m_capacity;
+		m_stats.persistent = m_mapping != nullptr;
+		m_stats.framesInFlight = m_inFlight.size();
+	}
+
+} // namespace WanderSpire
@@ -1,6 +1,8 @@
 // src/Graphics/Texture.cpp
 #include "WanderSpire/Graphics/Texture.h"
 #include "WanderSpire/Core/AssetManager.h"
+#include "WanderSpire/Graphics/GLDevice.h"
+#include "WanderSpire/Graphics/GLStateCache.h"
 #include "WanderSpire/External/stb_image.h"
 #include <spdlog/spdlog.h>
 #include <filesystem>
@@ -22,15 +24,16 @@ namespace WanderSpire {
 			return;
 		}
 
-		glGenTextures(1, &m_TextureID);
-		glBindTexture(GL_TEXTURE_2D, m_TextureID);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-		glTexImage2D(
+		auto& gl = GL::Device::Get();
+		m_TextureID = gl.GenTexture();
+		GL::StateCache::Get().BindTexture(GL_TEXTURE_2D, m_TextureID);
+		gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		gl.TexImage2D(
 			GL_TEXTURE_2D, 0, GL_RGBA,
-			m_Width, m_Height, 0,
+			m_Width, m_Height,
 			GL_RGBA, GL_UNSIGNED_BYTE, data
 		);
 
@@ -45,37 +48,46 @@ namespace WanderSpire {
 		m_Channels = 4;
 		unsigned char white[4] = { 255, 255, 255, 255 };
 
-		glGenTextures(1, &m_TextureID);
-		glBindTexture(GL_TEXTURE_2D, m_TextureID);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-		glTexImage2D(
+		auto& gl = GL::Device::Get();
+		m_TextureID = gl.GenTexture();
+		GL::StateCache::Get().BindTexture(GL_TEXTURE_2D, m_TextureID);
+		gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		gl.TexImage2D(
 			GL_TEXTURE_2D, 0, GL_RGBA,
-			m_Width, m_Height, 0,
+			m_Width, m_Height,
 			GL_RGBA, GL_UNSIGNED_BYTE, white
 		);
-		glBindTexture(GL_TEXTURE_2D, 0);
+		GL::StateCache::Get().BindTexture(GL_TEXTURE_2D, 0);
 
 		spdlog::info("[Texture] Created 11 white placeholder (ID={})", m_TextureID);
 	}
 
 	Texture::~Texture() {
 		if (m_TextureID) {
-			glDeleteTextures(1, &m_TextureID);
+			GL::StateCache::Get().ForgetTexture(m_TextureID);
+			GL::Device::Get().DeleteTexture(m_TextureID);
 			spdlog::info("[Texture] Deleted GPU texture{}",
 				m_Path.empty() ? "" : (" for " + m_Path));
 		}
 	}
 
 	void Texture::Bind(uint32_t slot) const noexcept {
-		glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTexture(GL_TEXTURE_2D, m_TextureID);
+		GL::StateCache::Get().BindTexture(GL_TEXTURE_2D, m_TextureID, slot);
 	}
 
 	void Texture::Unbind() const noexcept {
-		glBindTexture(GL_TEXTURE_2D, 0);
+		auto& cache = GL::StateCache::Get();
+		cache.BindTexture(GL_TEXTURE_2D, 0, cache.GetActiveTexture());
+	}
+
+	void Texture::Release() {
+		if (!m_TextureID) return;
+		GL::StateCache::Get().ForgetTexture(m_TextureID);
+		GL::Device::Get().DeleteTexture(m_TextureID);
+		m_TextureID = 0;
 	}
 
 	void Texture::UploadFromData(const unsigned char* data, int width, int height) {
@@ -83,21 +95,23 @@ namespace WanderSpire {
 		m_Height = height;
 		m_Channels = 4;
 
+		auto& gl = GL::Device::Get();
 		if (m_TextureID) {
-			glDeleteTextures(1, &m_TextureID);
+			GL::StateCache::Get().ForgetTexture(m_TextureID);
+			gl.DeleteTexture(m_TextureID);
 		}
-		glGenTextures(1, &m_TextureID);
-		glBindTexture(GL_TEXTURE_2D, m_TextureID);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-		glTexImage2D(
+		m_TextureID = gl.GenTexture();
+		GL::StateCache::Get().BindTexture(GL_TEXTURE_2D, m_TextureID);
+		gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		gl.TexImage2D(
 			GL_TEXTURE_2D, 0, GL_RGBA,
-			m_Width, m_Height, 0,
+			m_Width, m_Height,
 			GL_RGBA, GL_UNSIGNED_BYTE, data
 		);
-		glBindTexture(GL_TEXTURE_2D, 0);
+		GL::StateCache::Get().BindTexture(GL_TEXTURE_2D, 0);
 
 		spdlog::info("[Texture] Async upload complete ({}{})", m_Width, m_Height);
 	}
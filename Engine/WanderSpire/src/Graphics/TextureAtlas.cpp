@@ -1,5 +1,7 @@
 ﻿#include "WanderSpire/Graphics/TextureAtlas.h"
 #include "WanderSpire/Core/AssetManager.h"
+#include "WanderSpire/Graphics/GLDevice.h"
+#include "WanderSpire/Graphics/GLStateCache.h"
 #include "WanderSpire/External/stb_image.h"
 #include <nlohmann/json.hpp>
 #include <fstream>
@@ -8,31 +10,38 @@
 
 namespace WanderSpire {
 
-	void TextureAtlas::Load(const std::string& atlasImagePath, const std::string& mappingJsonPath) {
-		namespace fs = std::filesystem;
-
-		try {
-			// Load texture with RAII
-			fs::path imgPath = AssetManager::GetAssetsRoot() / atlasImagePath;
+	namespace {
+		struct PageImage {
+			std::string path;   ///< Relative to the assets root
+			int width = 0;
+			int height = 0;
+			std::unique_ptr<unsigned char, decltype(&stbi_image_free)> pixels{ nullptr, stbi_image_free };
+		};
+	}
 
-			int w, h, ch;
-			stbi_set_flip_vertically_on_load(false);
-			std::unique_ptr<unsigned char, decltype(&stbi_image_free)> pix(
-				stbi_load(imgPath.string().c_str(), &w, &h, &ch, STBI_rgb_alpha),
-				stbi_image_free
-			);
+	TextureAtlas::~TextureAtlas() {
+		ReleaseArray();
+	}
 
-			if (!pix) {
-				spdlog::error("[TextureAtlas] Can't open '{}'", imgPath.string());
-				return;
-			}
+	void TextureAtlas::ReleaseArray() {
+		if (m_ArrayTexture) {
+			GL::StateCache::Get().ForgetTexture(m_ArrayTexture);
+			GL::Device::Get().DeleteTexture(m_ArrayTexture);
+			m_ArrayTexture = 0;
+		}
+	}
 
-			if (!m_AtlasTexture) {
-				m_AtlasTexture = std::make_shared<Texture>();
-			}
+	void TextureAtlas::Release() {
+		for (auto& page : m_Pages) {
+			if (page) page->Release();
+		}
+		ReleaseArray();
+	}
 
-			m_AtlasTexture->UploadFromData(pix.get(), w, h);
+	void TextureAtlas::Load(const std::string& atlasImagePath, const std::string& mappingJsonPath) {
+		namespace fs = std::filesystem;
 
+		try {
 			// JSON parsing with better error handling
 			fs::path mapPath = AssetManager::GetAssetsRoot() / mappingJsonPath;
 			std::ifstream file(mapPath);
@@ -49,24 +58,90 @@ namespace WanderSpire {
 				return;
 			}
 
-			int atlasW = j["meta"].value("width", 0);
-			int atlasH = j["meta"].value("height", 0);
-			if (atlasW <= 0 || atlasH <= 0) {
-				spdlog::error("[TextureAtlas] Invalid atlas dimensions in {}", mapPath.string());
-				return;
+			// Pages: listed next to the first page's image, or just that image
+			const auto& meta = j["meta"];
+			std::vector<PageImage> pages;
+			if (meta.contains("pages") && meta["pages"].is_array() && !meta["pages"].empty()) {
+				const fs::path dir = fs::path(atlasImagePath).parent_path();
+				for (const auto& page : meta["pages"]) {
+					PageImage image;
+					image.path = (dir / page.value("image", std::string{})).generic_string();
+					pages.push_back(std::move(image));
+				}
+			}
+			else {
+				PageImage image;
+				image.path = atlasImagePath;
+				pages.push_back(std::move(image));
 			}
 
-			m_Frames.clear();
-			float invW = 1.0f / float(atlasW);
-			float invH = 1.0f / float(atlasH);
+			// Load textures with RAII
+			stbi_set_flip_vertically_on_load(false);
+			for (auto& page : pages) {
+				fs::path imgPath = AssetManager::GetAssetsRoot() / page.path;
+				int ch;
+				page.pixels.reset(stbi_load(imgPath.string().c_str(), &page.width, &page.height, &ch, STBI_rgb_alpha));
+				if (!page.pixels) {
+					spdlog::error("[TextureAtlas] Can't open '{}'", imgPath.string());
+					return;
+				}
+			}
+
+			// A texture array needs every layer the same size
+			bool useArray = meta.value("textureArray", false);
+			for (const auto& page : pages) {
+				if (useArray && (page.width != pages[0].width || page.height != pages[0].height)) {
+					spdlog::warn("[TextureAtlas] Pages of '{}' differ in size; loading them as separate textures",
+						atlasImagePath);
+					useArray = false;
+				}
+			}
+
+			if (useArray) {
+				m_Pages.clear();
+				ReleaseArray();
+				auto& gl = GL::Device::Get();
+				m_ArrayTexture = gl.GenTexture();
+				GL::StateCache::Get().BindTexture(GL_TEXTURE_2D_ARRAY, m_ArrayTexture);
+				gl.TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+				gl.TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+				gl.TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+				gl.TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+				gl.TexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, pages[0].width, pages[0].height,
+					static_cast<GLsizei>(pages.size()), GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+				for (size_t layer = 0; layer < pages.size(); ++layer) {
+					gl.TexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, static_cast<GLint>(layer),
+						pages[layer].width, pages[layer].height, 1, GL_RGBA, GL_UNSIGNED_BYTE, pages[layer].pixels.get());
+				}
+				GL::StateCache::Get().BindTexture(GL_TEXTURE_2D_ARRAY, 0);
+			}
+			else {
+				ReleaseArray();
+				m_Pages.resize(pages.size());
+				for (size_t i = 0; i < pages.size(); ++i) {
+					if (!m_Pages[i]) {
+						m_Pages[i] = std::make_shared<Texture>();
+					}
+					m_Pages[i]->UploadFromData(pages[i].pixels.get(), pages[i].width, pages[i].height);
+				}
+			}
+			m_PageCount = pages.size();
 
+			m_Frames.clear();
 			for (auto& [name, frame] : j["frames"].items()) {
 				int x = frame.value("x", 0);
 				int y = frame.value("y", 0);
 				int frameW = frame.value("w", 0);
 				int frameH = frame.value("h", 0);
+				int page = frame.value("page", 0);
 
 				// Add bounds checking
+				if (page < 0 || page >= static_cast<int>(pages.size())) {
+					spdlog::warn("[TextureAtlas] Frame '{}' is on missing page {}", name, page);
+					continue;
+				}
+				const int atlasW = pages[page].width;
+				const int atlasH = pages[page].height;
 				if (x < 0 || y < 0 || frameW <= 0 || frameH <= 0 ||
 					x + frameW > atlasW || y + frameH > atlasH) {
 					spdlog::warn("[TextureAtlas] Invalid frame bounds for '{}': x={}, y={}, w={}, h={}",
@@ -74,6 +149,8 @@ namespace WanderSpire {
 					continue;
 				}
 
+				float invW = 1.0f / float(atlasW);
+				float invH = 1.0f / float(atlasH);
 				float u0 = (x + 0.5f) * invW;
 				float v0 = (y + 0.5f) * invH;
 				float u1 = (x + frameW - 0.5f) * invW;
@@ -82,11 +159,12 @@ namespace WanderSpire {
 				AtlasFrame af;
 				af.uvOffset = { u0, v0 };
 				af.uvSize = { u1 - u0, v1 - v0 };
+				af.page = page;
 				m_Frames[name] = af;
 			}
 
-			spdlog::info("[TextureAtlas] Loaded atlas '{}' with {} frames",
-				atlasImagePath, m_Frames.size());
+			spdlog::info("[TextureAtlas] Loaded atlas '{}' with {} frames on {} page(s){}",
+				atlasImagePath, m_Frames.size(), m_PageCount, IsTextureArray() ? " (texture array)" : "");
 
 		}
 		catch (const std::exception& e) {
@@ -94,6 +172,12 @@ namespace WanderSpire {
 		}
 	}
 
+	GLuint TextureAtlas::GetTextureID(const AtlasFrame& frame) const {
+		if (m_ArrayTexture) return m_ArrayTexture;
+		if (frame.page < 0 || static_cast<size_t>(frame.page) >= m_Pages.size() || !m_Pages[frame.page]) return 0;
+		return m_Pages[frame.page]->GetID();
+	}
+
 	// Add missing implementation of GetFrame to resolve linker errors
 	AtlasFrame TextureAtlas::GetFrame(const std::string& name) const {
 		auto it = m_Frames.find(name);
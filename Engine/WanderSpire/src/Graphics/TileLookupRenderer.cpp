@@ -0,0 +1,556 @@
+#include "WanderSpire/Graphics/TileLookupRenderer.h"
+#include "WanderSpire/Graphics/GLDevice.h"
+#include "WanderSpire/Graphics/GLStateCache.h"
+#include "WanderSpire/Graphics/GLStateManager.h"
+#include "WanderSpire/Graphics/Shader.h"
+#include "WanderSpire/Graphics/StreamBuffer.h"
+#include "WanderSpire/Graphics/TextureAtlas.h"
+#include "WanderSpire/Components/SceneNodeComponent.h"
+#include "WanderSpire/Components/TilemapChunkComponent.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <spdlog/spdlog.h>
+
+namespace WanderSpire {
+
+	/// A layer's GL objects; only touched on the thread drawing
+	struct TileLookupGpuLayer {
+		GLuint indexTexture = 0;
+		GLuint lookupTexture = 0;
+		GLuint vao = 0;
+		GLuint fallbackVBO = 0;
+		uint64_t applied = 0;               ///< Serial of the last packet applied
+		std::atomic<bool> resync{ false };  ///< A packet was lost; the textures need sending whole
+	};
+
+	/// One layer's uploads and chunk quads for a frame
+	struct TileLookupDraw {
+		/// A rectangle of the index texture; its ids start at `first` in `pixels`
+		struct Region {
+			glm::ivec2 origin{ 0 };
+			glm::ivec2 size{ 0 };
+			size_t first = 0;
+		};
+
+		std::shared_ptr<TileLookupGpuLayer> gpu;
+		uint64_t serial = 0;
+
+		bool indexWhole = false;            ///< `pixels` is the whole index texture
+		glm::ivec2 indexSize{ 0 };
+		std::vector<Region> regions;
+		std::vector<int32_t> pixels;
+
+		bool lookupWhole = false;           ///< `lookup` is the whole lookup texture
+		int lookupRows = 0;
+		int lookupFirstRow = 0;
+		std::vector<glm::vec4> lookup;      ///< Rows from lookupFirstRow
+
+		std::vector<glm::vec4> chunks;      ///< World origin.xy, index region origin.zw
+		Shader* shader = nullptr;
+		TileLookupUniforms uniforms;
+		std::vector<std::pair<int, GLuint>> passes;   ///< (page, texture); page -1 draws every page
+		bool textureArray = false;
+		int chunkSize = 0;
+		float tileSize = 1.0f;
+	};
+
+	namespace {
+		constexpr int LOOKUP_WIDTH = TileLookupRenderer::LOOKUP_IDS_PER_ROW * 2;
+
+		uint64_t ChunkKey(const glm::ivec2& coords) {
+			return (static_cast<uint64_t>(static_cast<uint32_t>(coords.x)) << 32) | static_cast<uint32_t>(coords.y);
+		}
+
+		int FloorDiv(int value, int divisor) {
+			return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+		}
+
+		/// Id stored in the index texture; ids the lookup cannot hold draw nothing
+		int32_t StoredId(int tileId) {
+			return tileId >= 0 && tileId < TileLookupRenderer::MAX_TILE_ID ? tileId : -1;
+		}
+
+		void DeleteGpu(TileLookupGpuLayer& gpu) {
+			auto& cache = GL::StateCache::Get();
+			auto& gl = GL::Device::Get();
+			for (GLuint* texture : { &gpu.indexTexture, &gpu.lookupTexture }) {
+				if (!*texture) continue;
+				cache.ForgetTexture(*texture);
+				gl.DeleteTexture(*texture);
+				*texture = 0;
+			}
+			if (gpu.vao) {
+				cache.ForgetVertexArray(gpu.vao);
+				gl.DeleteVertexArray(gpu.vao);
+				gpu.vao = 0;
+			}
+			if (gpu.fallbackVBO) {
+				cache.ForgetBuffer(gpu.fallbackVBO);
+				gl.DeleteBuffer(gpu.fallbackVBO);
+				gpu.fallbackVBO = 0;
+			}
+		}
+
+		/// Make `texture` the one texture calls reach. A cached binding skips the
+		/// unit switch, so the unit is selected explicitly.
+		void SelectTexture(GLuint texture, GLuint unit) {
+			auto& cache = GL::StateCache::Get();
+			cache.BindTexture(GL_TEXTURE_2D, texture, unit);
+			cache.ActiveTexture(unit);
+		}
+
+		/// Create a texture of the layer, nearest filtered and clamped
+		GLuint CreateTexture(GLuint unit) {
+			auto& gl = GL::Device::Get();
+			const GLuint texture = gl.GenTexture();
+			SelectTexture(texture, unit);
+			gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			return texture;
+		}
+	}
+
+	TileLookupRenderer& TileLookupRenderer::Get() {
+		static TileLookupRenderer instance;
+		return instance;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Frames and layers
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void TileLookupRenderer::BeginFrame() {
+		for (auto it = m_layers.begin(); it != m_layers.end();) {
+			if (it->second.preparedFrame == m_frame) {
+				++it;
+				continue;
+			}
+			Release(it->second);
+			it = m_layers.erase(it);
+		}
+		++m_frame;
+		m_stats = TileLookupStats{};
+	}
+
+	void TileLookupRenderer::Release(Layer& layer) {
+		if (!layer.gpu) return;
+		std::lock_guard lock(m_releasedMutex);
+		m_released.push_back(std::move(layer.gpu));
+	}
+
+	void TileLookupRenderer::DeleteReleased() {
+		std::vector<std::shared_ptr<TileLookupGpuLayer>> released;
+		{
+			std::lock_guard lock(m_releasedMutex);
+			released.swap(m_released);
+		}
+		for (auto& gpu : released) DeleteGpu(*gpu);
+	}
+
+	void TileLookupRenderer::Clear() {
+		for (auto& [entity, layer] : m_layers) Release(layer);
+		m_layers.clear();
+		m_uniforms.clear();
+		m_stats = TileLookupStats{};
+	}
+
+	const TileLookupUniforms& TileLookupRenderer::UniformsFor(Shader& shader) {
+		auto [it, inserted] = m_uniforms.try_emplace(&shader);
+		if (inserted) {
+			// The shader re-resolves declared uniforms on every (re)link
+			TileLookupUniforms& uniforms = it->second;
+			uniforms.chunkSize = shader.DeclareUniform("u_ChunkSize");
+			uniforms.tileSize = shader.DeclareUniform("u_TileSize");
+			uniforms.tileIndex = shader.DeclareUniform("u_TileIndex");
+			uniforms.tileLookup = shader.DeclareUniform("u_TileLookup");
+			uniforms.texture = shader.DeclareUniform("u_Texture");
+			uniforms.textureArray = shader.DeclareUniform("u_TextureArray");
+			uniforms.useTextureArray = shader.DeclareUniform("u_UseTextureArray");
+			uniforms.page = shader.DeclareUniform("u_Page");
+		}
+		return it->second;
+	}
+
+	void TileLookupRenderer::Shutdown() {
+		Clear();
+		DeleteReleased();
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Index texture
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	glm::ivec2 TileLookupRenderer::SlotOrigin(const Layer& layer, int slot) const {
+		const int perRow = INDEX_TEXTURE_WIDTH / layer.chunkSize;
+		return { (slot % perRow) * layer.chunkSize, (slot / perRow) * layer.chunkSize };
+	}
+
+	int TileLookupRenderer::AllocateSlot(Layer& layer, bool& grown) {
+		if (!layer.freeSlots.empty()) {
+			const int slot = layer.freeSlots.back();
+			layer.freeSlots.pop_back();
+			return slot;
+		}
+
+		const int perRow = INDEX_TEXTURE_WIDTH / layer.chunkSize;
+		if (layer.slotCount == layer.slotRows * perRow) {
+			// Rows are appended, so the regions handed out keep their place
+			const int maxRows = MAX_INDEX_TEXTURE_HEIGHT / layer.chunkSize;
+			const int rows = std::min(std::max(1, layer.slotRows * 2), maxRows);
+			if (rows == layer.slotRows) return -1;
+			layer.slotRows = rows;
+			layer.index.resize(static_cast<size_t>(INDEX_TEXTURE_WIDTH) * rows * layer.chunkSize, -1);
+			grown = true;
+		}
+		return layer.slotCount++;
+	}
+
+	void TileLookupRenderer::SyncChunk(Layer& layer, const Slot& slot, const int* tiles, TileLookupDraw* draw) {
+		const int size = layer.chunkSize;
+		const glm::ivec2 origin = SlotOrigin(layer, slot.index);
+		glm::ivec2 changedMin{ size, size };
+		glm::ivec2 changedMax{ -1, -1 };
+
+		for (int y = 0; y < size; ++y) {
+			int32_t* row = layer.index.data() + static_cast<size_t>(origin.y + y) * INDEX_TEXTURE_WIDTH + origin.x;
+			for (int x = 0; x < size; ++x) {
+				const int32_t id = tiles ? StoredId(tiles[y * size + x]) : -1;
+				if (row[x] == id) continue;
+				row[x] = id;
+				changedMin = glm::min(changedMin, glm::ivec2(x, y));
+				changedMax = glm::max(changedMax, glm::ivec2(x, y));
+
+				if (id < 0 || layer.knownIds[id]) continue;
+				layer.knownIds[id] = 1;
+				layer.knownList.push_back(id);
+			}
+		}
+		if (!draw || changedMax.x < 0) return;
+
+		// Only the rectangle around what changed is sent
+		TileLookupDraw::Region region;
+		region.origin = origin + changedMin;
+		region.size = changedMax - changedMin + 1;
+		region.first = draw->pixels.size();
+		for (int y = 0; y < region.size.y; ++y) {
+			const int32_t* row = layer.index.data() + static_cast<size_t>(region.origin.y + y) * INDEX_TEXTURE_WIDTH + region.origin.x;
+			draw->pixels.insert(draw->pixels.end(), row, row + region.size.x);
+		}
+		draw->regions.push_back(region);
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Lookup texture
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void TileLookupRenderer::SyncLookup(Layer& layer, const Resolver& resolve, bool full, TileLookupDraw& draw) {
+		int maxId = 0;
+		for (int id : layer.knownList) maxId = std::max(maxId, id);
+		const int rowsNeeded = maxId / LOOKUP_IDS_PER_ROW + 1;
+		if (rowsNeeded > layer.lookupRows) {
+			int rows = std::max(1, layer.lookupRows);
+			while (rows < rowsNeeded) rows *= 2;
+			layer.lookupRows = rows;
+			layer.lookup.resize(static_cast<size_t>(LOOKUP_WIDTH) * rows, glm::vec4(0.0f));
+			full = true;
+		}
+
+		// Every id stored so far, in its frame for this frame: animation costs rows, not tiles
+		int firstRow = layer.lookupRows;
+		int lastRow = -1;
+		std::fill(layer.pagesUsed.begin(), layer.pagesUsed.end(), 0);
+		for (int id : layer.knownList) {
+			glm::vec4 frame(0.0f);
+			glm::vec4 page(0.0f);
+			if (const TileRenderEntry* entry = resolve(id)) {
+				frame = glm::vec4(entry->uvOffset, entry->uvSize);
+				page.x = static_cast<float>(entry->page);
+				const size_t p = static_cast<size_t>(std::max(entry->page, 0));
+				if (p >= layer.pagesUsed.size()) layer.pagesUsed.resize(p + 1, 0);
+				layer.pagesUsed[p] = 1;
+			}
+
+			glm::vec4* texels = layer.lookup.data() + static_cast<size_t>(id) * 2;
+			if (texels[0] == frame && texels[1] == page) continue;
+			texels[0] = frame;
+			texels[1] = page;
+			firstRow = std::min(firstRow, id / LOOKUP_IDS_PER_ROW);
+			lastRow = std::max(lastRow, id / LOOKUP_IDS_PER_ROW);
+		}
+
+		draw.lookupRows = layer.lookupRows;
+		draw.lookupWhole = full;
+		if (full) {
+			firstRow = 0;
+			lastRow = layer.lookupRows - 1;
+		}
+		if (lastRow < firstRow) return;
+
+		draw.lookupFirstRow = firstRow;
+		draw.lookup.assign(layer.lookup.begin() + static_cast<std::ptrdiff_t>(firstRow) * LOOKUP_WIDTH,
+			layer.lookup.begin() + static_cast<std::ptrdiff_t>(lastRow + 1) * LOOKUP_WIDTH);
+		m_stats.lookupTexels += draw.lookup.size();
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Preparing
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	std::shared_ptr<const TileLookupDraw> TileLookupRenderer::Prepare(const entt::registry& registry,
+		entt::entity layerEntity, const Resolver& resolve, const TextureAtlas* atlas, Shader* shader,
+		const glm::vec2& minBound, const glm::vec2& maxBound, float tileSize) {
+
+		auto& layer = m_layers[layerEntity];
+		if (layer.registry != &registry) {
+			Release(layer);
+			layer = Layer{};
+			layer.registry = &registry;
+		}
+		layer.preparedFrame = m_frame;
+		++layer.passes;
+
+		const auto* layerNode = registry.try_get<SceneNodeComponent>(layerEntity);
+		if (!layerNode || tileSize <= 0.0f) return nullptr;
+
+		auto draw = std::make_shared<TileLookupDraw>();
+		// The first packet of a layer, and the one after a lost packet, send everything
+		bool indexWhole = layer.serial == 0;
+		bool lookupWhole = layer.serial == 0;
+		if (!layer.gpu) layer.gpu = std::make_shared<TileLookupGpuLayer>();
+		else if (layer.gpu->resync.exchange(false)) indexWhole = lookupWhole = true;
+		if (layer.knownIds.empty()) layer.knownIds.assign(MAX_TILE_ID, 0);
+
+		for (entt::entity chunkEntity : layerNode->children) {
+			const auto* chunk = registry.try_get<TilemapChunkComponent>(chunkEntity);
+			if (!chunk || !chunk->loaded) continue;
+
+			if (layer.chunkSize == 0) {
+				if (chunk->chunkSize <= 0 || chunk->chunkSize > INDEX_TEXTURE_WIDTH) {
+					spdlog::warn("[TileLookupRenderer] Chunk size {} does not fit the index texture", chunk->chunkSize);
+					continue;
+				}
+				layer.chunkSize = chunk->chunkSize;
+			}
+			else if (chunk->chunkSize != layer.chunkSize) {
+				spdlog::warn("[TileLookupRenderer] Skipping chunk ({}, {}): size {} differs from its layer's {}",
+					chunk->chunkCoords.x, chunk->chunkCoords.y, chunk->chunkSize, layer.chunkSize);
+				continue;
+			}
+
+			auto [it, inserted] = layer.slots.try_emplace(ChunkKey(chunk->chunkCoords));
+			Slot& slot = it->second;
+			bool changed = inserted || slot.chunk != chunkEntity || slot.version != chunk->version;
+			if (inserted) {
+				bool grown = false;
+				slot.index = AllocateSlot(layer, grown);
+				if (slot.index < 0) {
+					layer.slots.erase(it);
+					spdlog::warn("[TileLookupRenderer] Index texture full; chunk ({}, {}) is not drawn",
+						chunk->chunkCoords.x, chunk->chunkCoords.y);
+					continue;
+				}
+				indexWhole |= grown;
+			}
+			slot.seenPass = layer.passes;
+
+			// Compared against the copy only when the journal stamped a new version
+			if (changed) {
+				slot.chunk = chunkEntity;
+				slot.version = chunk->version;
+				const int tileCount = layer.chunkSize * layer.chunkSize;
+				const int* tiles = chunk->TileCount() >= tileCount ? chunk->ReadTileIds(m_scratch) : nullptr;
+				SyncChunk(layer, slot, tiles, indexWhole ? nullptr : draw.get());
+			}
+
+			if (!chunk->visible) continue;
+			const glm::vec2 chunkMin = glm::vec2(chunk->chunkCoords * layer.chunkSize) * tileSize;
+			const glm::vec2 chunkMax = chunkMin + glm::vec2(static_cast<float>(layer.chunkSize) * tileSize);
+			if (chunkMax.x < minBound.x || chunkMin.x > maxBound.x ||
+				chunkMax.y < minBound.y || chunkMin.y > maxBound.y) continue;
+
+			const glm::ivec2 origin = SlotOrigin(layer, slot.index);
+			draw->chunks.emplace_back(chunkMin, glm::vec2(origin));
+		}
+
+		// Regions of chunks gone since the last frame are handed out again
+		for (auto it = layer.slots.begin(); it != layer.slots.end();) {
+			if (it->second.seenPass == layer.passes) {
+				++it;
+				continue;
+			}
+			layer.freeSlots.push_back(it->second.index);
+			it = layer.slots.erase(it);
+		}
+		if (layer.slotRows == 0) return nullptr;
+
+		draw->indexSize = { INDEX_TEXTURE_WIDTH, layer.slotRows * layer.chunkSize };
+		draw->indexWhole = indexWhole;
+		if (indexWhole) {
+			draw->regions.clear();
+			draw->pixels = layer.index;
+			++m_stats.fullUploads;
+		}
+		m_stats.indexTexels += draw->pixels.size();
+
+		SyncLookup(layer, resolve, lookupWhole, *draw);
+
+		if (draw->chunks.empty() && !indexWhole && !draw->lookupWhole && draw->regions.empty() && draw->lookup.empty())
+			return nullptr;
+
+		// Array atlases and single pages draw in one pass; other atlases once per page shown
+		if (atlas && shader) {
+			if (atlas->IsTextureArray() || atlas->GetPageCount() <= 1) {
+				draw->passes.emplace_back(-1, atlas->GetTextureID({}));
+				draw->textureArray = atlas->IsTextureArray();
+			}
+			else {
+				for (size_t page = 0; page < layer.pagesUsed.size() && page < atlas->GetPageCount(); ++page) {
+					if (!layer.pagesUsed[page]) continue;
+					AtlasFrame frame{};
+					frame.page = static_cast<int>(page);
+					draw->passes.emplace_back(frame.page, atlas->GetTextureID(frame));
+				}
+			}
+		}
+
+		draw->gpu = layer.gpu;
+		draw->serial = ++layer.serial;
+		draw->shader = shader;
+		if (shader) draw->uniforms = UniformsFor(*shader);
+		draw->chunkSize = layer.chunkSize;
+		draw->tileSize = tileSize;
+
+		++m_stats.layers;
+		m_stats.residentChunks += layer.slots.size();
+		m_stats.drawnChunks += draw->chunks.size();
+		if (!draw->chunks.empty()) m_stats.drawCalls += draw->passes.size();
+		return draw;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Drawing
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void TileLookupRenderer::Draw(const TileLookupDraw& draw) {
+		Get().DeleteReleased();
+		if (!draw.gpu) return;
+
+		auto& gpu = *draw.gpu;
+		auto& cache = GL::StateCache::Get();
+		auto& gl = GL::Device::Get();
+
+		// Uploads patch the textures as the previous packet left them; after a
+		// lost packet, wait for the game side to send both whole again
+		if (draw.serial == gpu.applied + 1 || (draw.indexWhole && draw.lookupWhole)) {
+			if (draw.indexWhole) {
+				if (!gpu.indexTexture) gpu.indexTexture = CreateTexture(2);
+				SelectTexture(gpu.indexTexture, 2);
+				gl.TexImage2D(GL_TEXTURE_2D, 0, GL_R32I, draw.indexSize.x, draw.indexSize.y,
+					GL_RED_INTEGER, GL_INT, draw.pixels.data());
+			}
+			else if (gpu.indexTexture && !draw.regions.empty()) {
+				SelectTexture(gpu.indexTexture, 2);
+				for (const auto& region : draw.regions) {
+					gl.TexSubImage2D(GL_TEXTURE_2D, 0, region.origin.x, region.origin.y, region.size.x, region.size.y,
+						GL_RED_INTEGER, GL_INT, draw.pixels.data() + region.first);
+				}
+			}
+
+			if (draw.lookupWhole) {
+				if (!gpu.lookupTexture) gpu.lookupTexture = CreateTexture(3);
+				SelectTexture(gpu.lookupTexture, 3);
+				gl.TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, LOOKUP_WIDTH, draw.lookupRows,
+					GL_RGBA, GL_FLOAT, draw.lookup.data());
+			}
+			else if (gpu.lookupTexture && !draw.lookup.empty()) {
+				SelectTexture(gpu.lookupTexture, 3);
+				gl.TexSubImage2D(GL_TEXTURE_2D, 0, 0, draw.lookupFirstRow, LOOKUP_WIDTH,
+					static_cast<GLsizei>(draw.lookup.size() / LOOKUP_WIDTH), GL_RGBA, GL_FLOAT, draw.lookup.data());
+			}
+			gpu.applied = draw.serial;
+		}
+		else {
+			gpu.resync.store(true);
+		}
+
+		if (draw.chunks.empty() || draw.passes.empty() || !draw.shader || !draw.shader->GetID()) return;
+		if (!gpu.indexTexture || !gpu.lookupTexture) return;
+
+		// Chunk quads: this frame's part of the stream buffer, or the layer's VBO
+		if (!gpu.vao) gpu.vao = gl.GenVertexArray();
+		GL::ProgramBinder program(draw.shader->GetID());
+		GL::VertexArrayBinder vertexArray(gpu.vao);
+
+		const size_t bytes = draw.chunks.size() * sizeof(glm::vec4);
+		GLuint buffer = 0;
+		size_t offset = 0;
+		if (auto allocation = StreamBuffer::Get().Upload(draw.chunks.data(), bytes, StreamUsage::Instance)) {
+			buffer = allocation.buffer;
+			offset = allocation.offset;
+		}
+		else {
+			if (!gpu.fallbackVBO) gpu.fallbackVBO = gl.GenBuffer();
+			cache.BindBuffer(GL_ARRAY_BUFFER, gpu.fallbackVBO);
+			gl.BufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(bytes), draw.chunks.data(), GL_STREAM_DRAW);
+			buffer = gpu.fallbackVBO;
+		}
+		cache.BindBuffer(GL_ARRAY_BUFFER, buffer);
+		gl.EnableVertexAttribArray(0);
+		gl.VertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), reinterpret_cast<void*>(offset));
+		gl.VertexAttribDivisor(0, 1);
+
+		Shader& shader = *draw.shader;
+		const TileLookupUniforms& uniforms = draw.uniforms;
+		shader.Set(uniforms.chunkSize, draw.chunkSize);
+		shader.Set(uniforms.tileSize, draw.tileSize);
+		shader.Set(uniforms.tileIndex, 2);
+		shader.Set(uniforms.tileLookup, 3);
+		shader.Set(uniforms.texture, 0);
+		shader.Set(uniforms.textureArray, 1);
+		shader.Set(uniforms.useTextureArray, draw.textureArray ? 1 : 0);
+		cache.BindTexture(GL_TEXTURE_2D, gpu.indexTexture, 2);
+		cache.BindTexture(GL_TEXTURE_2D, gpu.lookupTexture, 3);
+
+		for (const auto& [page, texture] : draw.passes) {
+			shader.Set(uniforms.page, page);
+			if (texture) cache.BindTexture(draw.textureArray ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D, texture, draw.textureArray ? 1 : 0);
+			gl.DrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(draw.chunks.size()));
+		}
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// CPU reference
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	TileLookupSample TileLookupRenderer::Sample(entt::entity layerEntity, const glm::vec2& world, float tileSize) const {
+		TileLookupSample sample;
+		auto it = m_layers.find(layerEntity);
+		if (it == m_layers.end() || tileSize <= 0.0f) return sample;
+		const Layer& layer = it->second;
+		if (layer.chunkSize == 0) return sample;
+
+		const glm::vec2 tiles = world / tileSize;
+		const glm::ivec2 tile{ static_cast<int>(std::floor(tiles.x)), static_cast<int>(std::floor(tiles.y)) };
+		const glm::ivec2 chunk{ FloorDiv(tile.x, layer.chunkSize), FloorDiv(tile.y, layer.chunkSize) };
+		auto slot = layer.slots.find(ChunkKey(chunk));
+		if (slot == layer.slots.end()) return sample;
+
+		const glm::ivec2 local = tile - chunk * layer.chunkSize;
+		const glm::ivec2 texel = SlotOrigin(layer, slot->second.index) + local;
+		const int32_t id = layer.index[static_cast<size_t>(texel.y) * INDEX_TEXTURE_WIDTH + texel.x];
+		if (id < 0 || id / LOOKUP_IDS_PER_ROW >= layer.lookupRows) return sample;
+
+		const glm::vec4 frame = layer.lookup[static_cast<size_t>(id) * 2];
+		if (frame.z <= 0.0f || frame.w <= 0.0f) return sample;
+
+		sample.tileId = id;
+		sample.uv = glm::vec2(frame.x, frame.y) + (tiles - glm::vec2(tile)) * glm::vec2(frame.z, frame.w);
+		sample.page = static_cast<int>(layer.lookup[static_cast<size_t>(id) * 2 + 1].x);
+		return sample;
+	}
+
+} // namespace WanderSpire
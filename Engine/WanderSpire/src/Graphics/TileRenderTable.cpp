@@ -0,0 +1,147 @@
+#include "WanderSpire/Graphics/TileRenderTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <spdlog/spdlog.h>
+
+namespace WanderSpire {
+
+	TileRenderTable& TileRenderTable::GetInstance() {
+		static TileRenderTable instance;
+		return instance;
+	}
+
+	void TileRenderTable::Clear() {
+		m_entries.clear();
+		m_hasEntry.clear();
+		m_sparseEntries.clear();
+		m_definitionRevision = UINT64_MAX;
+		m_atlasRevision = UINT64_MAX;
+		ClearAnimations();
+		m_time = 0.0;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Entries
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	const TileRenderEntry* TileRenderTable::GetEntry(int tileId) const {
+		if (tileId < 0) return nullptr;
+		if (tileId < MAX_DENSE_ID) {
+			const size_t i = static_cast<size_t>(tileId);
+			return i < m_hasEntry.size() && m_hasEntry[i] ? &m_entries[i] : nullptr;
+		}
+		auto it = m_sparseEntries.find(tileId);
+		return it != m_sparseEntries.end() ? &it->second : nullptr;
+	}
+
+	void TileRenderTable::SetEntry(int tileId, const TileRenderEntry& entry) {
+		if (tileId < 0) return;
+		if (tileId >= MAX_DENSE_ID) {
+			m_sparseEntries[tileId] = entry;
+			return;
+		}
+		const size_t i = static_cast<size_t>(tileId);
+		if (i >= m_entries.size()) {
+			m_entries.resize(i + 1);
+			m_hasEntry.resize(i + 1, 0);
+		}
+		m_entries[i] = entry;
+		m_hasEntry[i] = 1;
+	}
+
+	void TileRenderTable::SyncDefinitions(uint64_t definitionRevision, uint64_t atlasRevision) {
+		if (definitionRevision == m_definitionRevision && atlasRevision == m_atlasRevision) return;
+		m_definitionRevision = definitionRevision;
+		m_atlasRevision = atlasRevision;
+		std::fill(m_hasEntry.begin(), m_hasEntry.end(), 0);
+		m_sparseEntries.clear();
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Animations
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void TileRenderTable::SetAnimation(int tileId, const std::vector<Frame>& frames, bool loop) {
+		if (frames.empty()) {
+			RemoveAnimation(tileId);
+			return;
+		}
+		if (tileId < 0 || tileId >= MAX_DENSE_ID) {
+			spdlog::warn("[TileRenderTable] Tile id {} cannot be animated", tileId);
+			return;
+		}
+
+		auto& definition = m_definitions[tileId];
+		if (definition.second == loop && definition.first.size() == frames.size() &&
+			std::equal(frames.begin(), frames.end(), definition.first.begin(), [](const Frame& a, const Frame& b) {
+				return a.tileId == b.tileId && a.duration == b.duration;
+				})) {
+			return;
+		}
+		definition = { frames, loop };
+		Recompile();
+	}
+
+	void TileRenderTable::RemoveAnimation(int tileId) {
+		if (m_definitions.erase(tileId)) Recompile();
+	}
+
+	void TileRenderTable::ClearAnimations() {
+		m_definitions.clear();
+		Recompile();
+	}
+
+	void TileRenderTable::Recompile() {
+		m_animations.clear();
+		m_frameTiles.clear();
+		m_frameEnds.clear();
+		m_display.clear();
+
+		int maxId = -1;
+		for (const auto& [tileId, definition] : m_definitions) {
+			Animation animation;
+			animation.tileId = tileId;
+			animation.first = static_cast<int>(m_frameTiles.size());
+			animation.loop = definition.second;
+			for (const Frame& frame : definition.first) {
+				animation.length += std::max(0.0f, frame.duration);
+				m_frameTiles.push_back(frame.tileId);
+				m_frameEnds.push_back(animation.length);
+			}
+			animation.count = static_cast<int>(definition.first.size());
+			m_animations.push_back(animation);
+			maxId = std::max(maxId, tileId);
+		}
+
+		m_display.resize(static_cast<size_t>(maxId + 1));
+		for (int i = 0; i <= maxId; ++i) m_display[i] = i;
+		ResolveAnimations();
+	}
+
+	int TileRenderTable::FrameAt(const Animation& animation) const {
+		if (animation.length <= 0.0f) return 0;
+
+		double t = m_time;
+		if (animation.loop) t = std::fmod(t, static_cast<double>(animation.length));
+		if (t < 0.0) t += animation.length;
+
+		const float* ends = m_frameEnds.data() + animation.first;
+		const int frame = static_cast<int>(std::upper_bound(ends, ends + animation.count, static_cast<float>(t)) - ends);
+		return std::min(frame, animation.count - 1);
+	}
+
+	int TileRenderTable::GetCurrentFrame(int tileId) const {
+		for (const Animation& animation : m_animations) {
+			if (animation.tileId == tileId) return FrameAt(animation);
+		}
+		return -1;
+	}
+
+	void TileRenderTable::ResolveAnimations() {
+		for (const Animation& animation : m_animations) {
+			m_display[animation.tileId] = m_frameTiles[animation.first + FrameAt(animation)];
+		}
+	}
+
+} // namespace WanderSpire
@@ -4,6 +4,7 @@
 #include "WanderSpire/Components/AllComponents.h"
 #include "WanderSpire/Components/ScriptDataComponent.h"
 #include "WanderSpire/Core/Reflection.h"
+#include "WanderSpire/World/ChunkPayloadPool.h"
 #include <fstream>
 #include <spdlog/spdlog.h>
 
@@ -62,11 +63,13 @@ namespace WanderSpire::Scene {
 	void JsonSceneLoader::LoadComponents(const nlohmann::json& json, LoadContext& context) {
 		if (!json.contains("entities")) return;
 
+		const nlohmann::json* chunkPayloads = json.contains("chunkPayloads") ? &json["chunkPayloads"] : nullptr;
+
 		size_t entityIndex = 0;
 		for (const auto& entityJson : json["entities"]) {
 			if (entityIndex < context.loadedEntities.size() && entityJson.contains("components")) {
 				LoadEntityComponents(context.loadedEntities[entityIndex],
-					entityJson["components"], *context.registry);
+					entityJson["components"], *context.registry, chunkPayloads);
 			}
 			entityIndex++;
 		}
@@ -139,7 +142,7 @@ namespace WanderSpire::Scene {
 	}
 
 	void JsonSceneLoader::LoadEntityComponents(entt::entity entity, const nlohmann::json& components,
-		entt::registry& registry) {
+		entt::registry& registry, const nlohmann::json* chunkPayloads) {
 
 		nlohmann::json scriptData;
 
@@ -150,9 +153,28 @@ namespace WanderSpire::Scene {
 				acc.LoadFromJson(componentData);
 				registry.emplace_or_replace<AnimationClipsComponent>(entity, std::move(acc));
 			}
+			else if (componentName == "TileAttributeComponent") {
+				TileAttributeComponent attributes;
+				attributes.LoadFromJson(componentData);
+				registry.emplace_or_replace<TileAttributeComponent>(entity, std::move(attributes));
+			}
 			else if (componentName == "TilemapChunkComponent") {
 				TilemapChunkComponent chunk;
-				from_json(componentData, chunk);
+				// Chunks with common content reference one entry of the payload table
+				const size_t payload = componentData.value("payload", SIZE_MAX);
+				if (payload != SIZE_MAX && chunkPayloads && payload < chunkPayloads->size()) {
+					nlohmann::json resolved = componentData;
+					resolved["tileIds"] = (*chunkPayloads)[payload]["tileIds"];
+					resolved["tileData"] = (*chunkPayloads)[payload]["tileData"];
+					from_json(resolved, chunk);
+					// ...and share one buffer in memory too, split on the first write
+					chunk.Compact();
+					chunk.shared = ChunkPayloadPool::GetInstance().Intern(chunk.packed);
+					chunk.packed = PalettedTileStorage{};
+				}
+				else {
+					from_json(componentData, chunk);
+				}
 				chunk.dirty = true;
 				chunk.loaded = true;
 				chunk.visible = true;
@@ -4,6 +4,7 @@
 #include "WanderSpire/Components/AllComponents.h"
 #include "WanderSpire/Components/ScriptDataComponent.h"
 #include "WanderSpire/Core/Reflection.h"
+#include "WanderSpire/World/ChunkPayloadPool.h"
 #include <fstream>
 #include <spdlog/spdlog.h>
 #include <filesystem>
@@ -19,6 +20,7 @@ namespace WanderSpire::Scene {
 
 			GatherEntities(context);
 			SaveMetadata(metadata, context);
+			SaveChunkPayloads(context);
 			SaveEntities(context);
 
 			std::filesystem::create_directories(std::filesystem::path(filePath).parent_path());
@@ -75,11 +77,63 @@ namespace WanderSpire::Scene {
 		};
 	}
 
+	void JsonSceneSaver::SaveChunkPayloads(SaveContext& context) {
+		struct Payload {
+			std::vector<int> tileIds;
+			std::vector<uint32_t> tileData;
+			std::vector<entt::entity> chunks;
+		};
+		std::vector<Payload> payloads;
+		std::unordered_multimap<uint64_t, size_t> byHash;
+
+		// Group chunks with identical tiles, on any layer
+		for (auto entity : context.entitiesToSave) {
+			const auto* chunk = context.registry->try_get<TilemapChunkComponent>(entity);
+			if (!chunk) continue;
+
+			TilemapChunkComponent flat;
+			if (chunk->compact) {
+				flat = *chunk;
+				flat.Expand();
+			}
+			const TilemapChunkComponent& tiles = chunk->compact ? flat : *chunk;
+			if (tiles.tileData.size() != tiles.tileIds.size()) continue;
+
+			const uint64_t hash = ChunkPayloadPool::ContentHash(tiles.tileIds.data(), tiles.tileData.data(),
+				static_cast<int>(tiles.tileIds.size()));
+			auto [first, last] = byHash.equal_range(hash);
+			auto match = std::find_if(first, last, [&](const auto& entry) {
+				return payloads[entry.second].tileIds == tiles.tileIds && payloads[entry.second].tileData == tiles.tileData;
+				});
+			if (match != last) {
+				payloads[match->second].chunks.push_back(entity);
+				continue;
+			}
+			byHash.emplace(hash, payloads.size());
+			payloads.push_back({ tiles.tileIds, tiles.tileData, { entity } });
+		}
+
+		// Payloads used by more than one chunk are written once and referenced
+		nlohmann::json table = nlohmann::json::array();
+		for (auto& payload : payloads) {
+			if (payload.chunks.size() < 2) continue;
+			for (auto entity : payload.chunks) context.chunkPayloads[entity] = table.size();
+			table.push_back({ {"tileIds", std::move(payload.tileIds)}, {"tileData", std::move(payload.tileData)} });
+		}
+		if (!table.empty()) context.sceneJson["chunkPayloads"] = std::move(table);
+	}
+
 	void JsonSceneSaver::SaveEntities(SaveContext& context) {
 		context.sceneJson["entities"] = nlohmann::json::array();
 
 		for (auto entity : context.entitiesToSave) {
 			nlohmann::json entityJson = SerializeEntity(entity, *context.registry);
+			if (auto it = context.chunkPayloads.find(entity); it != context.chunkPayloads.end()) {
+				auto& chunkJson = entityJson["components"]["TilemapChunkComponent"];
+				chunkJson.erase("tileIds");
+				chunkJson.erase("tileData");
+				chunkJson["payload"] = it->second;
+			}
 			if (!entityJson.empty()) {
 				context.sceneJson["entities"].push_back(entityJson);
 				context.entitiesSaved++;
@@ -131,13 +185,18 @@ namespace WanderSpire::Scene {
 			entityJson["components"]["AnimationClipsComponent"] = animClips->ToJson();
 		}
 
+		// Per-tile attribute channels of a tilemap layer
+		if (auto* attributes = registry.try_get<TileAttributeComponent>(entity)) {
+			entityJson["components"]["TileAttributeComponent"] = attributes->ToJson();
+		}
+
 		for (const auto& [typeName, typeInfo] : Reflect::TypeRegistry::Get().GetNameMap()) {
 			if (typeName.find("TilemapChunkComponent") != std::string::npos) {
 				continue; // Skip - handled above
 			}
 
 			// Skip AnimationClipsComponent since we handled it specially above
-			if (typeName == "AnimationClipsComponent") {
+			if (typeName == "AnimationClipsComponent" || typeName == "TileAttributeComponent") {
 				continue;
 			}
 
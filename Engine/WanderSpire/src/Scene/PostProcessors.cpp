@@ -63,8 +63,10 @@ namespace WanderSpire::Scene {
 			auto& chunkComponent = chunkView.get<TilemapChunkComponent>(chunk);
 
 			// Count non-empty tiles
-			int nonEmptyTiles = std::count_if(chunkComponent.tileIds.begin(),
-				chunkComponent.tileIds.end(), [](int id) { return id != -1; });
+			int nonEmptyTiles = 0;
+			for (int i = 0; i < chunkComponent.TileCount(); ++i) {
+				if (chunkComponent.TileAt(i) != -1) ++nonEmptyTiles;
+			}
 
 			// Configure for rendering
 			chunkComponent.instanceCount = nonEmptyTiles;
@@ -79,9 +81,11 @@ namespace WanderSpire::Scene {
 		auto* chunkComponent = registry.try_get<TilemapChunkComponent>(chunk);
 		if (!chunkComponent) return;
 
+		chunkComponent->Expand();
 		size_t expectedSize = chunkComponent->chunkSize * chunkComponent->chunkSize;
 		chunkComponent->tileIds.resize(expectedSize, -1);
 		chunkComponent->tileData.resize(expectedSize, 0);
+		chunkComponent->summary.valid = false;
 	}
 
 	// ============================================================================
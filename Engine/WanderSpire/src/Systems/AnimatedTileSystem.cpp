@@ -0,0 +1,83 @@
+#include "WanderSpire/Systems/AnimatedTileSystem.h"
+#include "WanderSpire/Components/AnimatedTileComponent.h"
+#include "WanderSpire/Graphics/TileRenderTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <unordered_set>
+#include <spdlog/spdlog.h>
+
+namespace WanderSpire {
+
+	/// Per registry: animations this system put in the table, so removed
+	/// components stop animating, and tile ids already warned about
+	struct AnimatedTileSync {
+		std::unordered_set<int> synced;
+		std::unordered_set<int> conflicts;
+	};
+
+	void AnimatedTileSystem::AdvanceClock(float deltaTime) {
+		TileRenderTable::GetInstance().Advance(deltaTime);
+	}
+
+	void AnimatedTileSystem::Update(entt::registry& registry) {
+		auto& table = TileRenderTable::GetInstance();
+
+		if (!registry.ctx().contains<AnimatedTileSync>()) registry.ctx().emplace<AnimatedTileSync>();
+		auto& sync = registry.ctx().get<AnimatedTileSync>();
+
+		std::unordered_map<int, std::pair<std::vector<TileRenderTable::Frame>, bool>> active;
+		std::vector<TileRenderTable::Frame> frames;
+
+		auto view = registry.view<AnimatedTileComponent>();
+		for (auto entity : view) {
+			const auto& anim = view.get<AnimatedTileComponent>(entity);
+			if (anim.frames.empty()) continue;
+
+			const int tileId = anim.frames.front().tileId;
+			frames.clear();
+			if (anim.playing) {
+				for (const auto& frame : anim.frames) frames.push_back({ frame.tileId, frame.duration });
+			}
+			else {
+				const auto& held = anim.frames[std::clamp(anim.currentFrame, 0, static_cast<int>(anim.frames.size()) - 1)];
+				frames.push_back({ held.tileId, held.duration });
+			}
+
+			// The first component animating an id wins; alternating would recompile every frame
+			auto [it, inserted] = active.try_emplace(tileId, frames, anim.loop);
+			if (!inserted) {
+				const bool same = it->second.second == anim.loop && it->second.first.size() == frames.size() &&
+					std::equal(frames.begin(), frames.end(), it->second.first.begin(), [](const auto& a, const auto& b) {
+						return a.tileId == b.tileId && a.duration == b.duration;
+						});
+				if (!same && sync.conflicts.insert(tileId).second)
+					spdlog::warn("[AnimatedTileSystem] Tile {} is animated by components with different frames; keeping the first", tileId);
+				continue;
+			}
+			table.SetAnimation(tileId, frames, anim.loop);
+		}
+
+		std::unordered_set<int> synced;
+		for (const auto& [tileId, definition] : active) synced.insert(tileId);
+		for (int tileId : sync.synced) {
+			if (!synced.count(tileId)) table.RemoveAnimation(tileId);
+		}
+		sync.synced = std::move(synced);
+
+		table.ResolveAnimations();
+
+		// Mirror the shared clock back for the inspector
+		for (auto entity : view) {
+			auto& anim = view.get<AnimatedTileComponent>(entity);
+			if (!anim.playing || anim.frames.empty()) continue;
+
+			anim.currentFrame = std::max(0, table.GetCurrentFrame(anim.frames.front().tileId));
+			float length = 0.0f;
+			for (const auto& frame : anim.frames) length += frame.duration;
+			anim.elapsedTime = length > 0.0f ? static_cast<float>(std::fmod(table.GetTime(), static_cast<double>(length))) : 0.0f;
+		}
+	}
+
+} // namespace WanderSpire
@@ -1,8 +1,11 @@
 ﻿#include "WanderSpire/Systems/RenderSystem.h"
 #include "WanderSpire/Graphics/RenderManager.h"
+#include "WanderSpire/Graphics/RenderJobPool.h"
 #include "WanderSpire/Graphics/RenderResourceManager.h"
-#include "WanderSpire/Graphics/SpriteRenderer.h"
+#include "WanderSpire/Graphics/DebugDraw.h"
 #include "WanderSpire/Graphics/InstanceRenderer.h"
+#include "WanderSpire/Graphics/TileLookupRenderer.h"
+#include "WanderSpire/Graphics/TileRenderTable.h"
 #include "WanderSpire/Core/Application.h"
 #include "WanderSpire/Core/EventBus.h"
 #include "WanderSpire/Core/Events.h"
@@ -16,6 +19,12 @@
 #include "WanderSpire/Core/AppState.h"
 #include "WanderSpire/World/TileDefinitionManager.h"
 #include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace WanderSpire {
@@ -38,61 +47,330 @@ namespace WanderSpire {
 				});
 	}
 
-	void RenderSystem::SubmitEntityCommands(const entt::registry& registry, const AppState* state) {
-		auto& renderMgr = RenderManager::Get();
+	namespace {
+		/// Ranges smaller than this are not worth a job of their own
+		constexpr size_t MIN_ENTITIES_PER_JOB = 512;
 
-		struct SpriteItem {
-			int zOrder;
-			const SpriteRenderComponent* render;
-			const TransformComponent* transform;
+		bool OrderLess(const std::unique_ptr<RenderCommand>& a, const std::unique_ptr<RenderCommand>& b) {
+			return a->order < b->order;
+		}
+
+		/// One tilemap layer's draw: looked up on the main thread, filled in by a job
+		/// (per-tile instances) or by TileLookupRenderer (tile lookup layers)
+		struct TerrainLayerBatch {
+			entt::entity layer = entt::null;
+			int sortingOrder = 0;
+			std::string atlasName = "terrain";
+			TextureAtlas* atlas = nullptr;
+			Shader* shader = nullptr;
+			GLuint quadVAO = 0;
+			GLuint quadEBO = 0;
+			bool tileLookup = false;
+
+			std::vector<InstanceRenderer::InstanceData> instances;
+			std::shared_ptr<const TileLookupDraw> lookupDraw;
+			std::unordered_map<int, TileRenderEntry> resolved;   ///< Entries the table lacked, stored after the jobs
+			std::unordered_set<int> missingTiles;
 		};
-		std::vector<SpriteItem> sprites;
 
+		/// Main thread: load the layer's palette and find its atlas, shader and quad
+		bool PrepareTerrainLayer(const entt::registry& registry, TerrainLayerBatch& batch) {
+			// Determine which atlas to use - check if layer has specific palette
+			const auto* layerComponent = registry.try_get<TilemapLayerComponent>(batch.layer);
+			if (layerComponent && layerComponent->paletteId > 0) {
+				// Layer has a specific palette - ensure definitions are loaded
+				if (layerComponent->autoRefreshDefinitions) {
+					TileDefinitionManager::GetInstance().LoadFromPalette(layerComponent->paletteId);
+				}
+			}
+
+			// Try to get atlas - start with the primary atlas name, then try common fallbacks
+			auto& rm = RenderResourceManager::Get();
+			batch.atlas = rm.GetAtlas(batch.atlasName);
+			if (!batch.atlas) {
+				// Try common atlas names
+				const char* fallbackNames[] = { "terrain", "tiles", "tileset", nullptr };
+				for (int i = 0; fallbackNames[i] && !batch.atlas; ++i) {
+					batch.atlas = rm.GetAtlas(fallbackNames[i]);
+					if (batch.atlas) {
+						batch.atlasName = fallbackNames[i];
+						break;
+					}
+				}
+			}
+
+			// Without the lookup shader (hosts registering only "sprite") the layer is drawn per tile
+			batch.tileLookup = layerComponent && layerComponent->tileLookup;
+			if (batch.tileLookup) {
+				batch.shader = rm.GetShader("tilemap");
+				batch.tileLookup = batch.shader && batch.shader->GetID();
+			}
+			if (!batch.tileLookup) batch.shader = rm.GetShader("sprite");
+			if (!batch.atlas || !batch.shader || !batch.shader->GetID()) {
+				spdlog::warn("[RenderSystem] Missing atlas '{}' or shader for tilemap rendering", batch.atlasName);
+				return false;
+			}
+
+			batch.quadVAO = rm.GetQuadVAO();
+			batch.quadEBO = rm.GetQuadEBO();
+			return batch.quadVAO != 0 && batch.quadEBO != 0 && registry.all_of<SceneNodeComponent>(batch.layer);
+		}
+
+		/// Atlas frame of a tile id. Frames are looked up once per tile id, then
+		/// served from the table; ids the table lacks are resolved into the batch
+		/// and stored once all jobs are done.
+		const TileRenderEntry* ResolveTerrainTile(TerrainLayerBatch& batch, int tileId) {
+			if (const auto* entry = TileRenderTable::GetInstance().GetEntry(tileId)) return entry;
+			if (auto it = batch.resolved.find(tileId); it != batch.resolved.end()) return &it->second;
+
+			// NEW: Use TileDefinitionManager instead of hardcoded mapping
+			const auto* tileDef = TileDefinitionManager::GetInstance().GetTileDefinition(tileId);
+			if (!tileDef) return nullptr;
+
+			// Get the appropriate atlas if different from primary
+			TextureAtlas* tileAtlas = batch.atlas;
+			if (tileDef->atlasName != batch.atlasName) {
+				tileAtlas = RenderResourceManager::Get().GetAtlas(tileDef->atlasName);
+				if (!tileAtlas) {
+					// Fallback to primary atlas
+					tileAtlas = batch.atlas;
+					spdlog::warn("[RenderSystem] Atlas '{}' not found for tile {}, using fallback '{}'",
+						tileDef->atlasName, tileId, batch.atlasName);
+				}
+			}
+
+			// Get frame from atlas
+			auto frame = tileAtlas->GetFrame(tileDef->frameName);
+			if (frame.uvSize.x == 0 || frame.uvSize.y == 0) {
+				// Frame not found, try fallback frame or skip
+				frame = tileAtlas->GetFrame("grass"); // fallback frame
+				if (frame.uvSize.x == 0 || frame.uvSize.y == 0) return nullptr;
+			}
+
+			return &batch.resolved.emplace(tileId, TileRenderEntry{ frame.uvOffset, frame.uvSize, tileAtlas, frame.page }).first->second;
+		}
+
+		/// Any thread: only reads the registry, the tile table, the definitions and
+		/// the atlases, and only writes `batch`
+		void BuildTerrainInstances(const entt::registry& registry, TerrainLayerBatch& batch,
+			const glm::vec2& minBound, const glm::vec2& maxBound, float tileSize) {
+
+			const auto& renderTable = TileRenderTable::GetInstance();
+
+			// Calculate visible tile range
+			float half = 0.5f * tileSize;
+			int x0 = int(std::floor((minBound.x - half) / tileSize));
+			int y0 = int(std::floor((minBound.y - half) / tileSize));
+			int x1 = int(std::ceil((maxBound.x + half) / tileSize));
+			int y1 = int(std::ceil((maxBound.y + half) / tileSize));
+
+			batch.instances.reserve((y1 - y0) * (x1 - x0));
+
+			// Process chunks in this layer
+			const auto& layerNode = registry.get<SceneNodeComponent>(batch.layer);
+			for (entt::entity chunkEntity : layerNode.children) {
+				auto* chunkComponent = registry.try_get<TilemapChunkComponent>(chunkEntity);
+				if (!chunkComponent || !chunkComponent->loaded || !chunkComponent->visible) continue;
+
+				int chunkWorldX = chunkComponent->chunkCoords.x * chunkComponent->chunkSize;
+				int chunkWorldY = chunkComponent->chunkCoords.y * chunkComponent->chunkSize;
+
+				// Skip chunks outside visible area
+				if (chunkWorldX + chunkComponent->chunkSize < x0 || chunkWorldX > x1 ||
+					chunkWorldY + chunkComponent->chunkSize < y0 || chunkWorldY > y1) {
+					continue;
+				}
+
+				// Render tiles from this chunk
+				for (int localY = 0; localY < chunkComponent->chunkSize; ++localY) {
+					for (int localX = 0; localX < chunkComponent->chunkSize; ++localX) {
+						int worldX = chunkWorldX + localX;
+						int worldY = chunkWorldY + localY;
+
+						if (worldX < x0 || worldX >= x1 || worldY < y0 || worldY >= y1) continue;
+
+						int tileIndex = localY * chunkComponent->chunkSize + localX;
+						if (tileIndex >= 0 && tileIndex < chunkComponent->TileCount()) {
+							int tileId = chunkComponent->TileAt(tileIndex);
+							if (tileId == -1) continue;
+
+							// Animated ids are drawn as whichever frame tile the table points them at
+							const int shownId = renderTable.GetDisplayTile(tileId);
+							const auto* entry = ResolveTerrainTile(batch, shownId);
+							if (!entry) {
+								batch.missingTiles.insert(shownId);
+								continue;
+							}
+
+							glm::vec2 worldPos = glm::vec2(worldX, worldY) * tileSize + glm::vec2(half);
+							batch.instances.push_back({ worldPos, entry->uvOffset, entry->uvSize, static_cast<float>(entry->page) });
+						}
+					}
+				}
+			}
+		}
+
+		/// Main thread (TileLookupRenderer is not shared between threads): update the
+		/// layer's index and lookup textures and cull its chunks. Per frame this
+		/// resolves each tile id the layer holds, not each tile.
+		void PrepareLookupLayer(const entt::registry& registry, TerrainLayerBatch& batch,
+			const glm::vec2& minBound, const glm::vec2& maxBound, float tileSize) {
+
+			const auto& renderTable = TileRenderTable::GetInstance();
+			batch.lookupDraw = TileLookupRenderer::Get().Prepare(registry, batch.layer,
+				[&](int tileId) -> const TileRenderEntry* {
+					const int shownId = renderTable.GetDisplayTile(tileId);
+					const auto* entry = ResolveTerrainTile(batch, shownId);
+					if (!entry) batch.missingTiles.insert(shownId);
+					return entry;
+				}, batch.atlas, batch.shader, minBound, maxBound, tileSize);
+		}
+
+		/// Main thread: store what the jobs resolved and report missing tiles
+		void CommitTerrainLayers(std::vector<TerrainLayerBatch>& batches) {
+			auto& renderTable = TileRenderTable::GetInstance();
+			std::unordered_set<int> missingTiles;
+			for (auto& batch : batches) {
+				for (const auto& [tileId, entry] : batch.resolved) renderTable.SetEntry(tileId, entry);
+				batch.resolved.clear();
+				missingTiles.insert(batch.missingTiles.begin(), batch.missingTiles.end());
+			}
+
+			// Log missing tiles (throttled to avoid spam)
+			if (!missingTiles.empty()) {
+				static std::chrono::steady_clock::time_point lastLog;
+				auto now = std::chrono::steady_clock::now();
+				if (now - lastLog > std::chrono::seconds(5)) {
+					std::string missingStr;
+					for (int tileId : missingTiles) {
+						if (!missingStr.empty()) missingStr += ", ";
+						missingStr += std::to_string(tileId);
+					}
+					spdlog::warn("[RenderSystem] Missing tile definitions for tiles: {}", missingStr);
+					lastLog = now;
+				}
+			}
+		}
+
+		void DrawTerrainLayer(const TerrainLayerBatch& batch, float tileSize) {
+			if (batch.instances.empty()) return;
+
+			auto& instanceRenderer = InstanceRenderer::Get();
+			instanceRenderer.BeginFrame(batch.shader, batch.quadVAO, batch.quadEBO);
+
+			// Array atlases draw every page at once; otherwise one draw per page in use
+			const auto& atlas = *batch.atlas;
+			if (atlas.IsTextureArray()) {
+				instanceRenderer.RenderInstances(atlas.GetTextureID({}), batch.instances, tileSize, GL_TEXTURE_2D_ARRAY);
+			}
+			else if (atlas.GetPageCount() <= 1) {
+				instanceRenderer.RenderInstances(atlas.GetTextureID({}), batch.instances, tileSize);
+			}
+			else {
+				std::vector<std::vector<InstanceRenderer::InstanceData>> pages(atlas.GetPageCount());
+				for (const auto& instance : batch.instances) {
+					const size_t page = static_cast<size_t>(instance.layer);
+					if (page < pages.size()) pages[page].push_back(instance);
+				}
+				for (size_t page = 0; page < pages.size(); ++page) {
+					AtlasFrame frame{};
+					frame.page = static_cast<int>(page);
+					instanceRenderer.RenderInstances(atlas.GetTextureID(frame), pages[page], tileSize);
+				}
+			}
+			instanceRenderer.EndFrame();
+		}
+	}
+
+	void RenderSystem::SubmitEntityCommands(const entt::registry& registry, const AppState* state) {
 		const auto& cam = Application::GetCamera();
 		const float halfW = cam.GetWidth() * 0.5f / cam.GetZoom();
 		const float halfH = cam.GetHeight() * 0.5f / cam.GetZoom();
 		const glm::vec2 minB = cam.GetPosition() - glm::vec2(halfW, halfH);
 		const glm::vec2 maxB = cam.GetPosition() + glm::vec2(halfW, halfH);
 
-		for (auto entity : registry.view<SpriteRenderComponent>()) {
-			const auto* render = &registry.get<SpriteRenderComponent>(entity);
-			const auto* transform = registry.try_get<TransformComponent>(entity);
-			if (!transform) continue;
+		RenderManager::Get().Submit(BuildEntityCommands(registry, minB, maxB));
+	}
 
-			// Frustum culling
-			const glm::vec2 centre = transform->localPosition;
-			if (centre.x + render->worldSize.x < minB.x || centre.x > maxB.x ||
-				centre.y + render->worldSize.y < minB.y || centre.y > maxB.y)
-				continue;
+	std::vector<std::unique_ptr<RenderCommand>> RenderSystem::BuildEntityCommands(const entt::registry& registry,
+		const glm::vec2& minBound, const glm::vec2& maxBound, size_t jobs) {
 
-			int zOrder = 0;
-			if (const auto* obstacle = registry.try_get<ObstacleComponent>(entity)) {
-				zOrder = obstacle->zOrder;
-			}
+		auto view = registry.view<SpriteRenderComponent>();
+		const size_t count = view.size();
+		if (count == 0) return {};
 
-			sprites.push_back({ zOrder, render, transform });
+		auto& pool = RenderJobPool::Get();
+		if (jobs == 0) {
+			jobs = std::min<size_t>(pool.GetThreadCount(), (count + MIN_ENTITIES_PER_JOB - 1) / MIN_ENTITIES_PER_JOB);
 		}
+		jobs = std::clamp<size_t>(jobs, 1, count);
+
+		// Each job culls a contiguous range of the view and sorts it by z-order
+		std::vector<std::vector<std::unique_ptr<RenderCommand>>> parts(jobs);
+		pool.Run(jobs, [&](size_t job) {
+			const size_t first = count * job / jobs;
+			const size_t last = count * (job + 1) / jobs;
+			auto& part = parts[job];
+
+			auto it = std::next(view.begin(), static_cast<std::ptrdiff_t>(first));
+			for (size_t i = first; i < last; ++i, ++it) {
+				const entt::entity entity = *it;
+				const auto& render = registry.get<SpriteRenderComponent>(entity);
+				const auto* transform = registry.try_get<TransformComponent>(entity);
+				if (!transform) continue;
+
+				// Frustum culling
+				const glm::vec2 centre = transform->localPosition;
+				if (centre.x + render.worldSize.x < minBound.x || centre.x > maxBound.x ||
+					centre.y + render.worldSize.y < minBound.y || centre.y > maxBound.y)
+					continue;
+
+				int zOrder = 0;
+				if (const auto* obstacle = registry.try_get<ObstacleComponent>(entity)) {
+					zOrder = obstacle->zOrder;
+				}
 
-		// Sort by z-order
-		std::sort(sprites.begin(), sprites.end(),
-			[](const SpriteItem& a, const SpriteItem& b) {
-				return a.zOrder < b.zOrder;
+				auto cmd = std::make_unique<SpriteCommand>(RenderLayer::Entities, zOrder);
+				cmd->textureID = render.textureID;
+				cmd->position = transform->localPosition;
+				cmd->size = render.worldSize;
+				cmd->rotation = transform->localRotation;
+				cmd->color = { 1.0f, 1.0f, 1.0f };
+				cmd->uvOffset = render.uvOffset;
+				cmd->uvSize = render.uvSize;
+				cmd->textureLayer = render.textureLayer;
+				part.push_back(std::move(cmd));
+			}
+
+			std::stable_sort(part.begin(), part.end(), OrderLess);
 			});
 
-		// Submit sprite commands
-		for (const auto& sprite : sprites) {
-			renderMgr.SubmitSprite(
-				sprite.render->textureID,
-				sprite.transform->localPosition,
-				sprite.render->worldSize,
-				sprite.transform->localRotation,
-				{ 1.0f, 1.0f, 1.0f },
-				sprite.render->uvOffset,
-				sprite.render->uvSize,
-				RenderLayer::Entities,
-				sprite.zOrder
-			);
+		std::vector<std::unique_ptr<RenderCommand>> commands;
+		std::vector<size_t> runs{ 0 };   // Boundaries of the sorted runs in `commands`
+		size_t total = 0;
+		for (const auto& part : parts) total += part.size();
+		commands.reserve(total);
+		for (auto& part : parts) {
+			std::move(part.begin(), part.end(), std::back_inserter(commands));
+			runs.push_back(commands.size());
 		}
+
+		// Merge neighbouring runs until one is left. inplace_merge puts the left run
+		// first on ties, so this equals a single stable sort of the whole view.
+		while (runs.size() > 2) {
+			pool.Run((runs.size() - 1) / 2, [&](size_t merge) {
+				std::inplace_merge(commands.begin() + runs[2 * merge],
+					commands.begin() + runs[2 * merge + 1],
+					commands.begin() + runs[2 * merge + 2], OrderLess);
+				});
+
+			std::vector<size_t> merged;
+			for (size_t i = 0; i < runs.size(); i += 2) merged.push_back(runs[i]);
+			if (merged.back() != runs.back()) merged.push_back(runs.back());
+			runs.swap(merged);
+		}
+
+		return commands;
 	}
 
 	void RenderSystem::SubmitTerrainCommands(const AppState* state,
@@ -100,7 +378,6 @@ namespace WanderSpire {
 
 		if (!state) return;
 
-		auto& renderMgr = RenderManager::Get();
 		const auto& registry = state->world.GetRegistry();
 
 		std::vector<entt::entity> tilemapsToRender;
@@ -127,23 +404,57 @@ namespace WanderSpire {
 			}
 		}
 
+		SubmitTilemapLayers(registry, tilemapsToRender, minBound, maxBound, state->ctx.settings.tileSize);
+	}
+
+	void RenderSystem::SubmitTilemapLayers(const entt::registry& registry, const std::vector<entt::entity>& tilemapsToRender,
+		const glm::vec2& minBound, const glm::vec2& maxBound, float tileSize) {
+
+		auto& renderMgr = RenderManager::Get();
+		TileLookupRenderer::Get().BeginFrame();
 		if (tilemapsToRender.empty()) return;
 
-		// Render each tilemap
+		// Look up every visible layer's resources on this thread
+		std::vector<TerrainLayerBatch> batches;
 		for (entt::entity tilemap : tilemapsToRender) {
 			auto* tilemapNode = registry.try_get<SceneNodeComponent>(tilemap);
 			if (!tilemapNode) continue;
 
-			// Render each layer
 			for (entt::entity layerEntity : tilemapNode->children) {
 				auto* layerComponent = registry.try_get<TilemapLayerComponent>(layerEntity);
 				if (!layerComponent || !layerComponent->visible) continue;
 
-				renderMgr.SubmitCustom([&registry, layerEntity, minBound, maxBound,
-					tileSize = state->ctx.settings.tileSize]() {
-						RenderTilemapLayer(registry, layerEntity, minBound, maxBound, tileSize);
-					}, RenderLayer::Terrain, layerComponent->sortingOrder);
+				TerrainLayerBatch batch;
+				batch.layer = layerEntity;
+				batch.sortingOrder = layerComponent->sortingOrder;
+				if (PrepareTerrainLayer(registry, batch)) batches.push_back(std::move(batch));
+			}
+		}
+		if (batches.empty()) return;
+
+		// Build the layers' instances in parallel, then keep what they resolved
+		TileRenderTable::GetInstance().SyncDefinitions(TileDefinitionManager::GetInstance().GetRevision(),
+			RenderResourceManager::Get().GetAtlasRevision());
+		RenderJobPool::Get().Run(batches.size(), [&](size_t i) {
+			if (!batches[i].tileLookup) BuildTerrainInstances(registry, batches[i], minBound, maxBound, tileSize);
+			});
+		for (auto& batch : batches) {
+			if (batch.tileLookup) PrepareLookupLayer(registry, batch, minBound, maxBound, tileSize);
+		}
+		CommitTerrainLayers(batches);
+
+		for (auto& batch : batches) {
+			if (batch.lookupDraw) {
+				renderMgr.SubmitCustom([draw = std::move(batch.lookupDraw)]() {
+					TileLookupRenderer::Draw(*draw);
+					}, RenderLayer::Terrain, batch.sortingOrder);
+				continue;
 			}
+			if (batch.instances.empty()) continue;
+			const int sortingOrder = batch.sortingOrder;
+			renderMgr.SubmitCustom([built = std::make_shared<TerrainLayerBatch>(std::move(batch)), tileSize]() {
+				DrawTerrainLayer(*built, tileSize);
+				}, RenderLayer::Terrain, sortingOrder);
 		}
 	}
 
@@ -153,146 +464,18 @@ namespace WanderSpire {
 		const glm::vec2& maxBound,
 		float tileSize) {
 
-		// Get tile definition manager for texture mapping
-		auto& tileDefManager = TileDefinitionManager::GetInstance();
-
-		// Determine which atlas to use - check if layer has specific palette
-		std::string primaryAtlasName = "terrain"; // default fallback
-		const auto* layerComponent = registry.try_get<TilemapLayerComponent>(tilemapLayer);
-		if (layerComponent && layerComponent->paletteId > 0) {
-			// Layer has a specific palette - ensure definitions are loaded
-			if (layerComponent->autoRefreshDefinitions) {
-				tileDefManager.LoadFromPalette(layerComponent->paletteId);
-			}
-		}
-
-		// Try to get atlas - start with the primary atlas name, then try common fallbacks
-		auto& rm = RenderResourceManager::Get();
-		TextureAtlas* atlas = rm.GetAtlas(primaryAtlasName);
-		if (!atlas) {
-			// Try common atlas names
-			const char* fallbackNames[] = { "terrain", "tiles", "tileset", nullptr };
-			for (int i = 0; fallbackNames[i] && !atlas; ++i) {
-				atlas = rm.GetAtlas(fallbackNames[i]);
-				if (atlas) {
-					primaryAtlasName = fallbackNames[i];
-					break;
-				}
-			}
-		}
-
-		auto* shader = rm.GetShader("sprite");
-		if (!atlas || !shader || !shader->GetID()) {
-			spdlog::warn("[RenderSystem] Missing atlas '{}' or shader for tilemap rendering", primaryAtlasName);
-			return;
-		}
-
-		GLuint quadVAO = rm.GetQuadVAO();
-		GLuint quadEBO = rm.GetQuadEBO();
-		if (quadVAO == 0 || quadEBO == 0) return;
-
-		// Calculate visible tile range
-		float half = 0.5f * tileSize;
-		int x0 = int(std::floor((minBound.x - half) / tileSize));
-		int y0 = int(std::floor((minBound.y - half) / tileSize));
-		int x1 = int(std::ceil((maxBound.x + half) / tileSize));
-		int y1 = int(std::ceil((maxBound.y + half) / tileSize));
-
-		std::vector<InstanceRenderer::InstanceData> instances;
-		instances.reserve((y1 - y0) * (x1 - x0));
-
-		auto* layerNode = registry.try_get<SceneNodeComponent>(tilemapLayer);
-		if (!layerNode) return;
-
-		// Track missing definitions for logging
-		std::unordered_set<int> missingTiles;
-
-		// Process chunks in this layer
-		for (entt::entity chunkEntity : layerNode->children) {
-			auto* chunkComponent = registry.try_get<TilemapChunkComponent>(chunkEntity);
-			if (!chunkComponent || !chunkComponent->loaded || !chunkComponent->visible) continue;
+		std::vector<TerrainLayerBatch> batches(1);
+		batches[0].layer = tilemapLayer;
+		if (!PrepareTerrainLayer(registry, batches[0])) return;
 
-			int chunkWorldX = chunkComponent->chunkCoords.x * chunkComponent->chunkSize;
-			int chunkWorldY = chunkComponent->chunkCoords.y * chunkComponent->chunkSize;
+		TileRenderTable::GetInstance().SyncDefinitions(TileDefinitionManager::GetInstance().GetRevision(),
+			RenderResourceManager::Get().GetAtlasRevision());
+		if (batches[0].tileLookup) PrepareLookupLayer(registry, batches[0], minBound, maxBound, tileSize);
+		else BuildTerrainInstances(registry, batches[0], minBound, maxBound, tileSize);
+		CommitTerrainLayers(batches);
 
-			// Skip chunks outside visible area
-			if (chunkWorldX + chunkComponent->chunkSize < x0 || chunkWorldX > x1 ||
-				chunkWorldY + chunkComponent->chunkSize < y0 || chunkWorldY > y1) {
-				continue;
-			}
-
-			// Render tiles from this chunk
-			for (int localY = 0; localY < chunkComponent->chunkSize; ++localY) {
-				for (int localX = 0; localX < chunkComponent->chunkSize; ++localX) {
-					int worldX = chunkWorldX + localX;
-					int worldY = chunkWorldY + localY;
-
-					if (worldX < x0 || worldX >= x1 || worldY < y0 || worldY >= y1) continue;
-
-					int tileIndex = localY * chunkComponent->chunkSize + localX;
-					if (tileIndex >= 0 && tileIndex < static_cast<int>(chunkComponent->tileIds.size())) {
-						int tileId = chunkComponent->tileIds[tileIndex];
-						if (tileId == -1) continue;
-
-						// NEW: Use TileDefinitionManager instead of hardcoded mapping
-						const auto* tileDef = tileDefManager.GetTileDefinition(tileId);
-						if (!tileDef) {
-							missingTiles.insert(tileId);
-							continue;
-						}
-
-						// Get the appropriate atlas if different from primary
-						TextureAtlas* tileAtlas = atlas;
-						if (tileDef->atlasName != primaryAtlasName) {
-							tileAtlas = rm.GetAtlas(tileDef->atlasName);
-							if (!tileAtlas) {
-								// Fallback to primary atlas
-								tileAtlas = atlas;
-								spdlog::warn("[RenderSystem] Atlas '{}' not found for tile {}, using fallback '{}'",
-									tileDef->atlasName, tileId, primaryAtlasName);
-							}
-						}
-
-						// Get frame from atlas
-						auto frame = tileAtlas->GetFrame(tileDef->frameName);
-						if (frame.uvSize.x == 0 || frame.uvSize.y == 0) {
-							// Frame not found, try fallback frame or skip
-							frame = tileAtlas->GetFrame("grass"); // fallback frame
-							if (frame.uvSize.x == 0 || frame.uvSize.y == 0) {
-								missingTiles.insert(tileId);
-								continue;
-							}
-						}
-
-						glm::vec2 worldPos = glm::vec2(worldX, worldY) * tileSize + glm::vec2(half);
-						instances.push_back({ worldPos, frame.uvOffset, frame.uvSize });
-					}
-				}
-			}
-		}
-
-		// Log missing tiles (throttled to avoid spam)
-		if (!missingTiles.empty()) {
-			static std::chrono::steady_clock::time_point lastLog;
-			auto now = std::chrono::steady_clock::now();
-			if (now - lastLog > std::chrono::seconds(5)) {
-				std::string missingStr;
-				for (int tileId : missingTiles) {
-					if (!missingStr.empty()) missingStr += ", ";
-					missingStr += std::to_string(tileId);
-				}
-				spdlog::warn("[RenderSystem] Missing tile definitions for tiles: {}", missingStr);
-				lastLog = now;
-			}
-		}
-
-		if (instances.empty()) return;
-
-		// Render instances
-		auto& instanceRenderer = InstanceRenderer::Get();
-		instanceRenderer.BeginFrame(shader, quadVAO, quadEBO);
-		instanceRenderer.RenderInstances(atlas->GetTexture()->GetID(), instances, tileSize);
-		instanceRenderer.EndFrame();
+		if (batches[0].lookupDraw) TileLookupRenderer::Draw(*batches[0].lookupDraw);
+		else DrawTerrainLayer(batches[0], tileSize);
 	}
 
 	void RenderSystem::SubmitDebugCommands(const entt::registry& registry,
@@ -302,40 +485,33 @@ namespace WanderSpire {
 
 		if (!state) return;
 
-		auto& renderMgr = RenderManager::Get();
+		auto& debugDraw = DebugDraw::Get();
 		const float tileSz = state->ctx.settings.tileSize;
 		const glm::vec2 half(tileSz * 0.5f);
 
-		// Grid debug overlay
+		// Grid debug overlay: one line per tile row and column, not four quads per tile
 		if (state->debugEntityTiles) {
-			renderMgr.SubmitCustom([tileSz, half, minBound, maxBound]() {
-				auto& renderer = SpriteRenderer::Get();
-
-				int x0 = int(std::floor((minBound.x - half.x) / tileSz));
-				int y0 = int(std::floor((minBound.y - half.y) / tileSz));
-				int x1 = int(std::ceil((maxBound.x + half.x) / tileSz));
-				int y1 = int(std::ceil((maxBound.y + half.y) / tileSz));
-
-				for (int y = y0; y < y1; ++y) {
-					for (int x = x0; x < x1; ++x) {
-						glm::vec2 center = glm::vec2(x, y) * tileSz + half;
-						renderer.DrawTileBorder(center - half, tileSz, { 0.8f, 0.8f, 0.8f });
-					}
-				}
-				}, RenderLayer::Debug);
+			int x0 = int(std::floor((minBound.x - half.x) / tileSz));
+			int y0 = int(std::floor((minBound.y - half.y) / tileSz));
+			int x1 = int(std::ceil((maxBound.x + half.x) / tileSz));
+			int y1 = int(std::ceil((maxBound.y + half.y) / tileSz));
+
+			const glm::vec4 gridColor(0.8f, 0.8f, 0.8f, 1.0f);
+			for (int x = x0; x <= x1; ++x) {
+				debugDraw.Line({ x * tileSz, y0 * tileSz }, { x * tileSz, y1 * tileSz }, gridColor);
+			}
+			for (int y = y0; y <= y1; ++y) {
+				debugDraw.Line({ x0 * tileSz, y * tileSz }, { x1 * tileSz, y * tileSz }, gridColor);
+			}
 		}
 
 		// Entity tile debug overlay
 		if (state->debugEntityTiles) {
-			renderMgr.SubmitCustom([&registry, tileSz, half]() {
-				auto& renderer = SpriteRenderer::Get();
-
-				for (auto entity : registry.view<GridPositionComponent, SpriteRenderComponent>()) {
-					const auto& gp = registry.get<GridPositionComponent>(entity);
-					glm::vec2 center = glm::vec2(gp.tile) * tileSz + half;
-					renderer.DrawTileBorder(center - half, tileSz, { 0.2f, 0.4f, 1.0f });
-				}
-				}, RenderLayer::Debug);
+			const glm::vec4 tileColor(0.2f, 0.4f, 1.0f, 1.0f);
+			for (auto entity : registry.view<GridPositionComponent, SpriteRenderComponent>()) {
+				const auto& gp = registry.get<GridPositionComponent>(entity);
+				debugDraw.Rect(glm::vec2(gp.tile) * tileSz, { tileSz, tileSz }, tileColor);
+			}
 		}
 	}
 
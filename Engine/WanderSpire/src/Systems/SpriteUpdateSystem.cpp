@@ -100,8 +100,9 @@ namespace WanderSpire {
 
 				if (atlas) {
 					// JSON‑atlas frame
-					rc.textureID = atlas->GetTexture()->GetID();
 					auto frame = atlas->GetFrame(sprite.frameName);
+					rc.textureID = atlas->GetTextureID(frame);
+					rc.textureLayer = atlas->GetLayer(frame);
 					rc.uvOffset = frame.uvOffset;
 					rc.uvSize = frame.uvSize;
 					rc.worldSize = { defaultTileSize, defaultTileSize };
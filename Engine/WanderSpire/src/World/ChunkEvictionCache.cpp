@@ -0,0 +1,290 @@
+#include "WanderSpire/World/ChunkEvictionCache.h"
+#include "WanderSpire/ECS/RegistryIdentity.h"
+#include "WanderSpire/Components/TilemapChunkComponent.h"
+#include "WanderSpire/Core/ConfigManager.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace WanderSpire {
+
+	namespace {
+
+		using Clock = std::chrono::steady_clock;
+
+		uint64_t NanosSince(Clock::time_point start) {
+			return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+		}
+
+		uint64_t ChunkKey(const glm::ivec2& coords) {
+			return (static_cast<uint64_t>(static_cast<uint32_t>(coords.x)) << 32) | static_cast<uint32_t>(coords.y);
+		}
+
+		glm::ivec2 ChunkCoords(uint64_t key) {
+			return { static_cast<int32_t>(static_cast<uint32_t>(key >> 32)), static_cast<int32_t>(static_cast<uint32_t>(key)) };
+		}
+
+		// ─────────────────────────────────────────────────────────────────────
+		// Run-length codec: (run length, zigzag value) pairs as LEB128 varints
+		// ─────────────────────────────────────────────────────────────────────
+
+		void PutVarint(std::vector<uint8_t>& out, uint64_t v) {
+			while (v >= 0x80) {
+				out.push_back(static_cast<uint8_t>(v | 0x80));
+				v >>= 7;
+			}
+			out.push_back(static_cast<uint8_t>(v));
+		}
+
+		uint64_t GetVarint(const uint8_t*& p) {
+			uint64_t v = 0;
+			for (int shift = 0;; shift += 7) {
+				const uint8_t b = *p++;
+				v |= static_cast<uint64_t>(b & 0x7f) << shift;
+				if (!(b & 0x80)) return v;
+			}
+		}
+
+		template <typename T>
+		void EncodeRuns(std::vector<uint8_t>& out, const T* values, int count) {
+			for (int i = 0; i < count;) {
+				int run = 1;
+				while (i + run < count && values[i + run] == values[i]) ++run;
+				const int64_t v = static_cast<int64_t>(values[i]);
+				PutVarint(out, static_cast<uint64_t>(run));
+				PutVarint(out, (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+				i += run;
+			}
+		}
+
+		template <typename T>
+		void DecodeRuns(const uint8_t*& p, T* values, int count) {
+			for (int i = 0; i < count;) {
+				const int run = static_cast<int>(GetVarint(p));
+				const uint64_t z = GetVarint(p);
+				const T v = static_cast<T>(static_cast<int64_t>(z >> 1) ^ -static_cast<int64_t>(z & 1));
+				std::fill_n(values + i, run, v);
+				i += run;
+			}
+		}
+
+	} // namespace
+
+	size_t ChunkEvictionCache::KeyHash::operator()(const Key& k) const noexcept {
+		return std::hash<uint64_t>{}(k.chunk * 0x9E3779B97F4A7C15ull ^ entt::to_integral(k.layer));
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Lifetime
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	ChunkEvictionCache& ChunkEvictionCache::GetInstance() {
+		static ChunkEvictionCache instance;
+		return instance;
+	}
+
+	ChunkEvictionCache::ChunkEvictionCache()
+		: m_budget(static_cast<size_t>(std::max(0, ConfigManager::Get().chunkCacheKilobytes)) * 1024)
+	{
+	}
+
+	void ChunkEvictionCache::Clear() {
+		std::lock_guard lock(m_mutex);
+		m_lru.clear();
+		m_pinned.clear();
+		m_registries.clear();
+		m_bytes = 0;
+	}
+
+	void ChunkEvictionCache::SetBudget(size_t bytes) {
+		std::lock_guard lock(m_mutex);
+		m_budget = bytes;
+		Trim();
+	}
+
+	size_t ChunkEvictionCache::GetBudget() const {
+		std::lock_guard lock(m_mutex);
+		return m_budget;
+	}
+
+	ChunkCacheStats ChunkEvictionCache::GetStats(entt::registry& registry) {
+		std::lock_guard lock(m_mutex);
+		return StateFor(registry).stats;
+	}
+
+	void ChunkEvictionCache::ResetStats(entt::registry& registry) {
+		std::lock_guard lock(m_mutex);
+		auto& stats = StateFor(registry).stats;
+		const ChunkCacheStats held = stats;
+		stats = {};
+		stats.entries = held.entries;
+		stats.bytes = held.bytes;
+		stats.rawBytes = held.rawBytes;
+	}
+
+	ChunkEvictionCache::RegistryState& ChunkEvictionCache::StateFor(entt::registry& registry) {
+		auto it = m_registries.find(&registry);
+		if (it != m_registries.end() && !IsRegistryMarked<ChunkEvictionCache>(registry)) {
+			// Chunks of the registry that used to live at this address
+			for (auto& [key, entry] : it->second.entries) {
+				m_bytes -= entry->bytes.size();
+				(entry->pinned ? m_pinned : m_lru).erase(entry);
+			}
+			m_registries.erase(it);
+			it = m_registries.end();
+		}
+		if (it == m_registries.end()) {
+			MarkRegistry<ChunkEvictionCache>(registry);
+			it = m_registries.emplace(&registry, RegistryState{}).first;
+		}
+		return it->second;
+	}
+
+	void ChunkEvictionCache::Erase(EntryList::iterator it) {
+		RegistryState& owner = *it->owner;
+		owner.entries.erase(it->key);
+		owner.stats.entries--;
+		if (it->pinned) owner.stats.pinned--;
+		owner.stats.bytes -= it->bytes.size();
+		owner.stats.rawBytes -= static_cast<size_t>(it->tileCount) * (sizeof(int) + sizeof(uint32_t));
+		m_bytes -= it->bytes.size();
+		(it->pinned ? m_pinned : m_lru).erase(it);
+	}
+
+	void ChunkEvictionCache::Trim() {
+		// Pinned entries count against the budget but only unmodified ones go
+		while (m_bytes > m_budget && !m_lru.empty()) {
+			auto oldest = std::prev(m_lru.end());
+			oldest->owner->stats.evictions++;
+			Erase(oldest);
+		}
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Store / restore
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void ChunkEvictionCache::Store(entt::registry& registry, entt::entity tilemapLayer, const TilemapChunkComponent& chunk,
+		bool backed, bool modified)
+	{
+		const auto start = Clock::now();
+		const Key key{ tilemapLayer, ChunkKey(chunk.chunkCoords) };
+
+		{
+			std::lock_guard lock(m_mutex);
+			auto& state = StateFor(registry);
+			state.unloaded.insert(key);
+			if (auto it = state.entries.find(key); it != state.entries.end()) Erase(it->second);
+			if (m_budget == 0 && !modified) return;
+		}
+
+		const int tileCount = chunk.TileCount();
+		std::vector<int> idScratch;
+		const int* ids = chunk.ReadTileIds(idScratch);
+		std::vector<uint32_t> dataScratch;
+		const uint32_t* data = chunk.ReadTileData(dataScratch);
+
+		// An empty chunk comes back identical from a miss, unless the layer's file
+		// or generator would fill it: there it stays as a tombstone
+		const bool empty = std::all_of(ids, ids + tileCount, [](int id) { return id == -1; }) &&
+			std::all_of(data, data + tileCount, [](uint32_t d) { return d == 0; });
+		if (empty && !backed) return;
+
+		Entry entry;
+		entry.key = key;
+		entry.tileCount = tileCount;
+		entry.pinned = modified;
+		EncodeRuns(entry.bytes, ids, tileCount);
+		EncodeRuns(entry.bytes, data, tileCount);
+		entry.bytes.shrink_to_fit();
+
+		std::lock_guard lock(m_mutex);
+		auto& state = StateFor(registry);
+		if (!modified && entry.bytes.size() > m_budget) return;
+
+		entry.owner = &state;
+		const size_t size = entry.bytes.size();
+		EntryList& list = modified ? m_pinned : m_lru;
+		list.push_front(std::move(entry));
+		state.entries[key] = list.begin();
+		m_bytes += size;
+
+		state.stats.stores++;
+		state.stats.entries++;
+		if (modified) state.stats.pinned++;
+		state.stats.bytes += size;
+		state.stats.rawBytes += static_cast<size_t>(tileCount) * (sizeof(int) + sizeof(uint32_t));
+		state.stats.storeNanos += NanosSince(start);
+		Trim();
+	}
+
+	bool ChunkEvictionCache::Contains(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords) {
+		std::lock_guard lock(m_mutex);
+		return StateFor(registry).entries.count(Key{ tilemapLayer, ChunkKey(chunkCoords) }) > 0;
+	}
+
+	bool ChunkEvictionCache::Peek(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords,
+		std::vector<int>& tileIds, std::vector<uint32_t>& tileData)
+	{
+		std::lock_guard lock(m_mutex);
+		auto& state = StateFor(registry);
+		auto it = state.entries.find(Key{ tilemapLayer, ChunkKey(chunkCoords) });
+		if (it == state.entries.end()) return false;
+
+		const Entry& entry = *it->second;
+		tileIds.resize(static_cast<size_t>(entry.tileCount));
+		tileData.resize(static_cast<size_t>(entry.tileCount));
+		const uint8_t* p = entry.bytes.data();
+		DecodeRuns(p, tileIds.data(), entry.tileCount);
+		DecodeRuns(p, tileData.data(), entry.tileCount);
+		return true;
+	}
+
+	std::vector<glm::ivec2> ChunkEvictionCache::GetCachedChunks(entt::registry& registry, entt::entity tilemapLayer) {
+		std::lock_guard lock(m_mutex);
+		std::vector<glm::ivec2> coords;
+		for (const auto& [key, entry] : StateFor(registry).entries)
+			if (key.layer == tilemapLayer) coords.push_back(ChunkCoords(key.chunk));
+		return coords;
+	}
+
+	void ChunkEvictionCache::Forget(entt::registry& registry, entt::entity tilemapLayer) {
+		std::lock_guard lock(m_mutex);
+		auto& state = StateFor(registry);
+		for (auto it = state.entries.begin(); it != state.entries.end();) {
+			auto entry = (it++)->second;
+			if (entry->key.layer == tilemapLayer) Erase(entry);
+		}
+		std::erase_if(state.unloaded, [tilemapLayer](const Key& key) { return key.layer == tilemapLayer; });
+	}
+
+	bool ChunkEvictionCache::Restore(entt::registry& registry, entt::entity tilemapLayer,
+		const glm::ivec2& chunkCoords, TilemapChunkComponent& chunk, bool backed, bool* modified)
+	{
+		const auto start = Clock::now();
+		std::lock_guard lock(m_mutex);
+		auto& state = StateFor(registry);
+
+		const Key key{ tilemapLayer, ChunkKey(chunkCoords) };
+		const bool unloaded = state.unloaded.erase(key) > 0;
+		auto it = state.entries.find(key);
+		if (it == state.entries.end()) {
+			if (unloaded || backed) state.stats.misses++;
+			return false;
+		}
+
+		const Entry& entry = *it->second;
+		chunk.tileIds.resize(static_cast<size_t>(entry.tileCount));
+		chunk.tileData.resize(static_cast<size_t>(entry.tileCount));
+		const uint8_t* p = entry.bytes.data();
+		DecodeRuns(p, chunk.tileIds.data(), entry.tileCount);
+		DecodeRuns(p, chunk.tileData.data(), entry.tileCount);
+		if (modified) *modified = entry.pinned;
+
+		Erase(it->second);
+		state.stats.hits++;
+		state.stats.restoreNanos += NanosSince(start);
+		return true;
+	}
+
+} // namespace WanderSpire
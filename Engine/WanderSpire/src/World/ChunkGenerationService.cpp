@@ -0,0 +1,294 @@
+#include "WanderSpire/World/ChunkGenerationService.h"
+#include "WanderSpire/ECS/RegistryIdentity.h"
+#include "WanderSpire/World/TilemapSystem.h"
+#include "WanderSpire/Core/ConfigManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <spdlog/spdlog.h>
+
+namespace WanderSpire {
+
+	namespace {
+		uint64_t ChunkKey(const glm::ivec2& coords) {
+			return (static_cast<uint64_t>(static_cast<uint32_t>(coords.x)) << 32) | static_cast<uint32_t>(coords.y);
+		}
+
+		glm::ivec2 ChunkCoords(uint64_t key) {
+			return { static_cast<int32_t>(key >> 32), static_cast<int32_t>(key & 0xffffffffu) };
+		}
+	}
+
+	size_t ChunkGenerationService::KeyHash::operator()(const Key& k) const noexcept {
+		return std::hash<uint64_t>{}(k.chunk * 0x9E3779B97F4A7C15ull ^ entt::to_integral(k.layer));
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Lifetime
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	ChunkGenerationService& ChunkGenerationService::GetInstance() {
+		static ChunkGenerationService instance;
+		return instance;
+	}
+
+	ChunkGenerationService::ChunkGenerationService()
+		: m_threadCount(static_cast<unsigned>(std::max(0, ConfigManager::Get().chunkGenThreads)))
+		, m_budgetMicros(static_cast<uint32_t>(std::max(0, ConfigManager::Get().chunkGenBudgetMicros)))
+	{
+	}
+
+	ChunkGenerationService::~ChunkGenerationService() {
+		StopWorkers();
+	}
+
+	void ChunkGenerationService::Clear() {
+		std::lock_guard lock(m_mutex);
+		m_jobs.clear();
+		m_registries.clear();
+	}
+
+	void ChunkGenerationService::SetThreadCount(unsigned threads) {
+		StopWorkers();
+		std::lock_guard lock(m_mutex);
+		m_threadCount = threads;
+		if (!m_jobs.empty()) StartWorkers();
+	}
+
+	unsigned ChunkGenerationService::GetThreadCount() const {
+		std::lock_guard lock(m_mutex);
+		if (m_threadCount) return m_threadCount;
+		return std::max(1u, std::thread::hardware_concurrency() - 1);
+	}
+
+	void ChunkGenerationService::SetFrameBudget(uint32_t micros) {
+		std::lock_guard lock(m_mutex);
+		m_budgetMicros = micros;
+	}
+
+	uint32_t ChunkGenerationService::GetFrameBudget() const {
+		std::lock_guard lock(m_mutex);
+		return m_budgetMicros;
+	}
+
+	ChunkGenerationService::RegistryState& ChunkGenerationService::StateFor(entt::registry& registry) {
+		auto it = m_registries.find(&registry);
+		if (it != m_registries.end() && !IsRegistryMarked<ChunkGenerationService>(registry)) {
+			m_registries.erase(it);
+			it = m_registries.end();
+		}
+		if (it == m_registries.end()) {
+			MarkRegistry<ChunkGenerationService>(registry);
+			it = m_registries.emplace(&registry, RegistryState{}).first;
+			it->second.id = m_nextStateId++;
+		}
+		return it->second;
+	}
+
+	ChunkGenerationService::RegistryState* ChunkGenerationService::StateById(uint64_t id) {
+		for (auto& [registry, state] : m_registries) {
+			if (state.id == id) return &state;
+		}
+		return nullptr;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Generators and jobs
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void ChunkGenerationService::SetGenerator(entt::registry& registry, entt::entity tilemapLayer,
+		std::shared_ptr<const IChunkGenerator> generator, uint64_t worldSeed)
+	{
+		if (!generator) {
+			ClearGenerator(registry, tilemapLayer);
+			return;
+		}
+		std::lock_guard lock(m_mutex);
+		StateFor(registry).generators[tilemapLayer] = { std::move(generator), worldSeed };
+	}
+
+	void ChunkGenerationService::ClearGenerator(entt::registry& registry, entt::entity tilemapLayer) {
+		CancelPending(registry, tilemapLayer, [](const glm::ivec2&) { return true; });
+		std::lock_guard lock(m_mutex);
+		StateFor(registry).generators.erase(tilemapLayer);
+	}
+
+	bool ChunkGenerationService::HasGenerator(entt::registry& registry, entt::entity tilemapLayer) {
+		std::lock_guard lock(m_mutex);
+		return StateFor(registry).generators.count(tilemapLayer) > 0;
+	}
+
+	bool ChunkGenerationService::Request(entt::registry& registry, entt::entity tilemapLayer,
+		const glm::ivec2& chunkCoords, int chunkSize)
+	{
+		std::lock_guard lock(m_mutex);
+		auto& state = StateFor(registry);
+		auto gen = state.generators.find(tilemapLayer);
+		if (gen == state.generators.end()) return false;
+
+		const Key key{ tilemapLayer, ChunkKey(chunkCoords) };
+		if (state.pending.count(key)) return false;
+
+		Job job;
+		job.stateId = state.id;
+		job.ticket = m_nextTicket++;
+		job.key = key;
+		job.generator = gen->second.generator;
+		job.context.chunkCoords = chunkCoords;
+		job.context.chunkSize = chunkSize;
+		job.context.worldSeed = gen->second.worldSeed;
+		job.context.chunkSeed = Noise::ChunkSeed(gen->second.worldSeed, chunkCoords);
+
+		state.pending.emplace(key, job.ticket);
+		m_jobs.push_back(std::move(job));
+		StartWorkers();
+		m_jobReady.notify_one();
+		return true;
+	}
+
+	size_t ChunkGenerationService::CancelPending(entt::registry& registry, entt::entity tilemapLayer,
+		const std::function<bool(const glm::ivec2&)>& shouldCancel)
+	{
+		std::lock_guard lock(m_mutex);
+		auto& state = StateFor(registry);
+		size_t cancelled = 0;
+
+		// Running jobs finish, but their results no longer match a pending ticket
+		for (auto it = state.pending.begin(); it != state.pending.end();) {
+			if (it->first.layer == tilemapLayer && shouldCancel(ChunkCoords(it->first.chunk))) {
+				it = state.pending.erase(it);
+				++cancelled;
+			}
+			else ++it;
+		}
+		m_jobs.erase(std::remove_if(m_jobs.begin(), m_jobs.end(), [&](const Job& job) {
+			return job.stateId == state.id && !state.pending.count(job.key);
+			}), m_jobs.end());
+		return cancelled;
+	}
+
+	size_t ChunkGenerationService::GetPendingCount(entt::registry& registry) {
+		std::lock_guard lock(m_mutex);
+		return StateFor(registry).pending.size();
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Workers
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void ChunkGenerationService::StartWorkers() {
+		// Called with m_mutex held
+		if (!m_workers.empty()) return;
+		const unsigned count = m_threadCount ? m_threadCount : std::max(1u, std::thread::hardware_concurrency() - 1);
+		for (unsigned i = 0; i < count; ++i) {
+			m_workers.emplace_back(&ChunkGenerationService::WorkerLoop, this);
+		}
+	}
+
+	void ChunkGenerationService::StopWorkers() {
+		std::vector<std::thread> workers;
+		{
+			std::lock_guard lock(m_mutex);
+			m_stopping = true;
+			workers.swap(m_workers);
+		}
+		m_jobReady.notify_all();
+		for (auto& worker : workers) worker.join();
+
+		std::lock_guard lock(m_mutex);
+		m_stopping = false;
+	}
+
+	void ChunkGenerationService::WorkerLoop() {
+		while (true) {
+			Job job;
+			{
+				std::unique_lock lock(m_mutex);
+				m_jobReady.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+				if (m_stopping) return;   // Queued jobs wait for the next set of workers
+				job = std::move(m_jobs.front());
+				m_jobs.pop_front();
+				if (auto* state = StateById(job.stateId)) state->running++;
+			}
+
+			const size_t total = static_cast<size_t>(job.context.chunkSize) * static_cast<size_t>(job.context.chunkSize);
+			Result result;
+			result.ticket = job.ticket;
+			result.key = job.key;
+			result.chunkCoords = job.context.chunkCoords;
+			result.tileIds.assign(total, -1);
+			result.tileData.assign(total, 0);
+			try {
+				job.generator->Generate(job.context, result.tileIds.data(), result.tileData.data());
+			}
+			catch (const std::exception& e) {
+				spdlog::error("[ChunkGenerationService] Generator failed for chunk ({}, {}): {}",
+					job.context.chunkCoords.x, job.context.chunkCoords.y, e.what());
+			}
+
+			{
+				std::lock_guard lock(m_mutex);
+				if (auto* state = StateById(job.stateId)) {
+					state->running--;
+					state->finished.push_back(std::move(result));
+				}
+			}
+			m_jobDone.notify_all();
+		}
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Frame update
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	size_t ChunkGenerationService::Update(entt::registry& registry) {
+		return Update(registry, GetFrameBudget());
+	}
+
+	size_t ChunkGenerationService::Update(entt::registry& registry, uint32_t budgetMicros) {
+		using Clock = std::chrono::steady_clock;
+		const auto frameStart = Clock::now();
+		const auto budget = std::chrono::microseconds(budgetMicros);
+		auto& tilemaps = TilemapSystem::GetInstance();
+		size_t installed = 0;
+
+		while (true) {
+			Result result;
+			{
+				std::lock_guard lock(m_mutex);
+				auto& state = StateFor(registry);
+				if (state.finished.empty()) break;
+				result = std::move(state.finished.back());
+				state.finished.pop_back();
+
+				// Cancelled or superseded while it was running
+				auto it = state.pending.find(result.key);
+				if (it == state.pending.end() || it->second != result.ticket) continue;
+				state.pending.erase(it);
+			}
+
+			if (registry.valid(result.key.layer) &&
+				tilemaps.InstallChunk(registry, result.key.layer, result.chunkCoords,
+					std::move(result.tileIds), std::move(result.tileData))) {
+				++installed;
+			}
+			if (Clock::now() - frameStart >= budget) break;
+		}
+		return installed;
+	}
+
+	size_t ChunkGenerationService::Drain(entt::registry& registry) {
+		{
+			std::unique_lock lock(m_mutex);
+			auto& state = StateFor(registry);
+			const uint64_t id = state.id;
+			if (!m_jobs.empty()) StartWorkers();
+			m_jobDone.wait(lock, [&] {
+				return state.running == 0 &&
+					std::none_of(m_jobs.begin(), m_jobs.end(), [id](const Job& job) { return job.stateId == id; });
+				});
+		}
+		return Update(registry, UINT32_MAX);
+	}
+
+} // namespace WanderSpire
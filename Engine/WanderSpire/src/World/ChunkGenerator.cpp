@@ -0,0 +1,165 @@
+#include "WanderSpire/World/ChunkGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace WanderSpire {
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Noise
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	namespace Noise {
+
+		uint64_t Hash(uint64_t seed, int x, int y) {
+			uint64_t h = seed ^ (static_cast<uint64_t>(static_cast<uint32_t>(x)) * 0x9E3779B97F4A7C15ull)
+				^ (static_cast<uint64_t>(static_cast<uint32_t>(y)) * 0xC2B2AE3D27D4EB4Full);
+			// splitmix64 finalizer
+			h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+			h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+			return h ^ (h >> 31);
+		}
+
+		uint64_t ChunkSeed(uint64_t worldSeed, const glm::ivec2& chunkCoords) {
+			return Hash(worldSeed ^ 0x5851F42D4C957F2Dull, chunkCoords.x, chunkCoords.y);
+		}
+
+		static float ToSigned(uint64_t h) {
+			return static_cast<float>(h >> 40) * (2.0f / 16777216.0f) - 1.0f;
+		}
+
+		static float Fade(float t) {
+			return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+		}
+
+		float Value2D(uint64_t seed, float x, float y) {
+			const float fx = std::floor(x), fy = std::floor(y);
+			const int ix = static_cast<int>(fx), iy = static_cast<int>(fy);
+			const float u = Fade(x - fx), v = Fade(y - fy);
+
+			const float a = ToSigned(Hash(seed, ix, iy));
+			const float b = ToSigned(Hash(seed, ix + 1, iy));
+			const float c = ToSigned(Hash(seed, ix, iy + 1));
+			const float d = ToSigned(Hash(seed, ix + 1, iy + 1));
+			const float top = a + (b - a) * u;
+			const float bottom = c + (d - c) * u;
+			return top + (bottom - top) * v;
+		}
+
+		float Simplex2D(uint64_t seed, float x, float y) {
+			static constexpr float F2 = 0.36602540378f;   // (sqrt(3) - 1) / 2
+			static constexpr float G2 = 0.21132486540f;   // (3 - sqrt(3)) / 6
+			static constexpr float GRADIENTS[8][2] = {
+				{ 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 },
+				{ 0.70710678f, 0.70710678f }, { -0.70710678f, 0.70710678f },
+				{ 0.70710678f, -0.70710678f }, { -0.70710678f, -0.70710678f }
+			};
+
+			const float s = (x + y) * F2;
+			const int i = static_cast<int>(std::floor(x + s));
+			const int j = static_cast<int>(std::floor(y + s));
+			const float t = (i + j) * G2;
+			const float x0 = x - (i - t), y0 = y - (j - t);
+
+			const int i1 = x0 > y0 ? 1 : 0;
+			const int j1 = x0 > y0 ? 0 : 1;
+			const float x1 = x0 - i1 + G2, y1 = y0 - j1 + G2;
+			const float x2 = x0 - 1.0f + 2.0f * G2, y2 = y0 - 1.0f + 2.0f * G2;
+
+			auto corner = [seed](int cx, int cy, float dx, float dy) {
+				float falloff = 0.5f - dx * dx - dy * dy;
+				if (falloff <= 0.0f) return 0.0f;
+				const float* g = GRADIENTS[Hash(seed, cx, cy) & 7];
+				falloff *= falloff;
+				return falloff * falloff * (g[0] * dx + g[1] * dy);
+			};
+
+			const float n = corner(i, j, x0, y0) + corner(i + i1, j + j1, x1, y1) + corner(i + 1, j + 1, x2, y2);
+			return std::clamp(n * 70.0f, -1.0f, 1.0f);
+		}
+
+	} // namespace Noise
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// NoiseChunkGenerator
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	NoiseChunkGenerator::NoiseChunkGenerator(Settings settings)
+		: m_settings(std::move(settings))
+	{
+		m_settings.octaves = std::max(1, m_settings.octaves);
+		std::stable_sort(m_settings.bands.begin(), m_settings.bands.end(),
+			[](const Band& a, const Band& b) { return a.maxHeight < b.maxHeight; });
+	}
+
+	float NoiseChunkGenerator::HeightAt(uint64_t worldSeed, const glm::ivec2& tile) const {
+		float sum = 0.0f, norm = 0.0f;
+		float amplitude = 1.0f, frequency = m_settings.frequency;
+		for (int octave = 0; octave < m_settings.octaves; ++octave) {
+			const uint64_t seed = worldSeed + static_cast<uint64_t>(octave) * 0x632BE59BD9B4E019ull;
+			const float x = tile.x * frequency, y = tile.y * frequency;
+			sum += amplitude * (m_settings.noise == NoiseType::Simplex
+				? Noise::Simplex2D(seed, x, y)
+				: Noise::Value2D(seed, x, y));
+			norm += amplitude;
+			amplitude *= m_settings.persistence;
+			frequency *= m_settings.lacunarity;
+		}
+		return norm > 0.0f ? sum / norm : 0.0f;
+	}
+
+	int NoiseChunkGenerator::TerrainAt(uint64_t worldSeed, const glm::ivec2& tile) const {
+		const float height = HeightAt(worldSeed, tile);
+		auto band = std::find_if(m_settings.bands.begin(), m_settings.bands.end(),
+			[height](const Band& b) { return height <= b.maxHeight; });
+		return band != m_settings.bands.end() ? band->tileId : m_settings.fallbackTileId;
+	}
+
+	void NoiseChunkGenerator::Generate(const ChunkGenerationContext& context, int* tileIds, uint32_t* tileData) const {
+		const int size = context.chunkSize;
+		const glm::ivec2 origin = context.chunkCoords * size;
+
+		for (int y = 0; y < size; ++y) {
+			for (int x = 0; x < size; ++x) tileIds[y * size + x] = TerrainAt(context.worldSeed, origin + glm::ivec2(x, y));
+		}
+
+		// Anchors are world tiles tested against the terrain, not earlier stamps,
+		// and applied in world order, so every chunk a stamp overlaps draws its
+		// part of it identically. Anchors outside the chunk sample the terrain.
+		std::vector<int> terrain(tileIds, tileIds + size * size);
+		auto terrainAt = [&](const glm::ivec2& tile) {
+			const glm::ivec2 local = tile - origin;
+			return local.x >= 0 && local.y >= 0 && local.x < size && local.y < size
+				? terrain[local.y * size + local.x]
+				: TerrainAt(context.worldSeed, tile);
+		};
+
+		for (size_t s = 0; s < m_settings.stamps.size(); ++s) {
+			const Stamp& stamp = m_settings.stamps[s];
+			if (stamp.density <= 0.0f || stamp.width <= 0 || stamp.height <= 0 ||
+				stamp.tiles.size() < static_cast<size_t>(stamp.width * stamp.height)) continue;
+
+			// Upper 32 hash bits below the threshold place the stamp; density 1 always does
+			const uint64_t seed = context.worldSeed + (s + 1) * 0x9E3779B97F4A7C15ull;
+			const uint64_t threshold = static_cast<uint64_t>(std::min(1.0, static_cast<double>(stamp.density)) * 4294967296.0);
+			for (int ay = origin.y - stamp.height + 1; ay < origin.y + size; ++ay) {
+				for (int ax = origin.x - stamp.width + 1; ax < origin.x + size; ++ax) {
+					if ((Noise::Hash(seed, ax, ay) >> 32) >= threshold) continue;
+					if (stamp.onTileId != -1 && terrainAt({ ax, ay }) != stamp.onTileId) continue;
+
+					// Clip the footprint to this chunk
+					const int x0 = std::max(ax, origin.x), x1 = std::min(ax + stamp.width, origin.x + size);
+					const int y0 = std::max(ay, origin.y), y1 = std::min(ay + stamp.height, origin.y + size);
+					for (int y = y0; y < y1; ++y) {
+						for (int x = x0; x < x1; ++x) {
+							const int id = stamp.tiles[(y - ay) * stamp.width + (x - ax)];
+							if (id != -1) tileIds[(y - origin.y) * size + (x - origin.x)] = id;
+						}
+					}
+				}
+			}
+		}
+		(void)tileData;
+	}
+
+} // namespace WanderSpire
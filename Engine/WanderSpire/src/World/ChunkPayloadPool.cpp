@@ -0,0 +1,75 @@
+#include "WanderSpire/World/ChunkPayloadPool.h"
+
+#include <algorithm>
+
+namespace WanderSpire {
+
+	ChunkPayloadPool& ChunkPayloadPool::GetInstance() {
+		static ChunkPayloadPool instance;
+		return instance;
+	}
+
+	uint64_t ChunkPayloadPool::ContentHash(const int* tileIds, const uint32_t* tileData, int tileCount) {
+		uint64_t h = 1469598103934665603ull;
+		auto mix = [&h](uint64_t v) { h = (h ^ v) * 1099511628211ull; };
+		mix(static_cast<uint64_t>(tileCount));
+		for (int i = 0; i < tileCount; ++i) {
+			mix(static_cast<uint32_t>(tileIds[i]));
+			if (tileData) mix(tileData[i]);
+			else mix(0);
+		}
+		return h;
+	}
+
+	ChunkPayloadPool::Payload ChunkPayloadPool::Intern(const PalettedTileStorage& storage) {
+		const int count = storage.TileCount();
+		std::vector<int> ids(static_cast<size_t>(count));
+		std::vector<uint32_t> data(static_cast<size_t>(count));
+		storage.Decode(ids.data());
+		storage.DecodeData(data.data());
+		const uint64_t hash = ContentHash(ids.data(), data.data(), count);
+
+		std::lock_guard lock(m_mutex);
+		std::vector<int> otherIds(static_cast<size_t>(count));
+		std::vector<uint32_t> otherData(static_cast<size_t>(count));
+		auto [first, last] = m_payloads.equal_range(hash);
+		for (auto it = first; it != last; ++it) {
+			Payload existing = it->second.lock();
+			if (!existing || existing->TileCount() != count) continue;
+			existing->Decode(otherIds.data());
+			existing->DecodeData(otherData.data());
+			if (otherIds == ids && otherData == data) return existing;
+		}
+
+		// Re-encode so the shared copy is canonical and tightly packed
+		auto payload = std::make_shared<PalettedTileStorage>();
+		payload->Encode(ids.data(), data.data(), count);
+		m_payloads.emplace(hash, payload);
+		if (m_payloads.size() >= m_pruneAt) Prune();
+		return payload;
+	}
+
+	void ChunkPayloadPool::Prune() {
+		for (auto it = m_payloads.begin(); it != m_payloads.end();) {
+			if (it->second.expired()) it = m_payloads.erase(it);
+			else ++it;
+		}
+		m_pruneAt = std::max<size_t>(64, m_payloads.size() * 2);
+	}
+
+	size_t ChunkPayloadPool::GetPayloadCount() {
+		std::lock_guard lock(m_mutex);
+		Prune();
+		return m_payloads.size();
+	}
+
+	size_t ChunkPayloadPool::GetPayloadBytes() {
+		std::lock_guard lock(m_mutex);
+		size_t bytes = 0;
+		for (const auto& [hash, weak] : m_payloads) {
+			if (Payload payload = weak.lock()) bytes += payload->MemoryBytes();
+		}
+		return bytes;
+	}
+
+} // namespace WanderSpire
@@ -0,0 +1,542 @@
+﻿#include "WanderSpire/World/ConnectivityMap.h"
+#include "WanderSpire/World/TilemapSystem.h"
+#include "WanderSpire/Components/TilemapChunkComponent.h"
+#include "WanderSpire/Components/ObstacleComponent.h"
+#include "WanderSpire/Components/GridPositionComponent.h"
+#include "WanderSpire/Components/TileComponent.h"
+
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+namespace WanderSpire {
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Helpers
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	static inline uint64_t PackCoords(const glm::ivec2& p) {
+		return (uint64_t(uint32_t(p.x)) << 32) | uint32_t(p.y);
+	}
+
+	static inline glm::ivec2 UnpackCoords(uint64_t key) {
+		return glm::ivec2{ int32_t(key >> 32), int32_t(key) };
+	}
+
+	static constexpr uint32_t VOID_NODE = 0;
+
+	static uint32_t FindRoot(std::vector<uint32_t>& parent, uint32_t n) {
+		while (parent[n] != n) {
+			parent[n] = parent[parent[n]];
+			n = parent[n];
+		}
+		return n;
+	}
+
+	static void Unite(std::vector<uint32_t>& parent, uint32_t a, uint32_t b) {
+		a = FindRoot(parent, a);
+		b = FindRoot(parent, b);
+		if (a == b) return;
+		// Keep the smaller id as root so the void stays its own representative
+		if (a < b) parent[b] = a; else parent[a] = b;
+	}
+
+	/// Sides of a chunk in ChunkLabels::edges order; side ^ 1 is the opposite one
+	static constexpr glm::ivec2 SIDES[4] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+
+	template<typename Labels>
+	static uint32_t NodeOf(const Labels& chunk, int index) {
+		const uint16_t label = chunk.labels[index];
+		return label ? chunk.baseNode + label - 1 : UINT32_MAX;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Lifetime
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	ConnectivityMap& ConnectivityMap::GetInstance() {
+		static ConnectivityMap instance;
+		return instance;
+	}
+
+	// TileComponent overrides change walkability, so they count as obstacles;
+	// changes arrive per entity and are applied as deltas
+	ConnectivityMap::ConnectivityMap()
+		: m_listener(true, true) {}
+
+	void ConnectivityMap::Clear() {
+		m_listener.Clear();
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Public queries
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	bool ConnectivityMap::AreConnected(entt::registry& registry, entt::entity tilemapLayer,
+		const glm::ivec2& a, const glm::ivec2& b)
+	{
+		if (a == b) return true;
+		if (tilemapLayer == entt::null || !registry.valid(tilemapLayer)) return true;
+
+		std::lock_guard lock(m_listener.Mutex());
+		auto& state = m_listener.StateFor(registry);
+		auto& layerState = state.layers[tilemapLayer];
+		Refresh(registry, state, tilemapLayer, layerState);
+
+		const int na = NodeAt(state, layerState, a);
+		const int nb = NodeAt(state, layerState, b);
+		if (na < 0 || nb < 0) return false;
+		return layerState.parent[na] == layerState.parent[nb];
+	}
+
+	int ConnectivityMap::GetComponentId(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& pos) {
+		if (tilemapLayer == entt::null || !registry.valid(tilemapLayer)) return 0;
+
+		std::lock_guard lock(m_listener.Mutex());
+		auto& state = m_listener.StateFor(registry);
+		auto& layerState = state.layers[tilemapLayer];
+		Refresh(registry, state, tilemapLayer, layerState);
+
+		const int node = NodeAt(state, layerState, pos);
+		return node < 0 ? -1 : static_cast<int>(layerState.parent[node]);
+	}
+
+	void ConnectivityMap::MarkChunkDirty(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords) {
+		m_listener.MarkChunkDirty(registry, tilemapLayer, chunkCoords);
+	}
+
+	void ConnectivityMap::Invalidate(entt::registry& registry) {
+		m_listener.Invalidate(registry);
+
+		std::lock_guard lock(m_listener.Mutex());
+		auto it = m_listener.States().find(&registry);
+		if (it == m_listener.States().end()) return;
+		for (auto& [layer, layerState] : it->second.layers) layerState.topologyDirty = true;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Rebuild pipeline
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void ConnectivityMap::Refresh(entt::registry& registry, RegistryState& state,
+		entt::entity layer, LayerState& layerState)
+	{
+		if (state.obstaclesDirty) {
+			SyncObstacles(registry, state);
+		}
+		else if (!state.changedObstacles.empty()) {
+			ApplyObstacleChanges(registry, state);
+		}
+
+		if (layerState.chunkSetDirty) {
+			ReindexChunks(registry, layer, layerState);
+		}
+
+		std::vector<int> scratch;
+		for (auto& [key, chunk] : layerState.chunks) {
+			if (!chunk.dirty) continue;
+			auto* comp = registry.try_get<TilemapChunkComponent>(chunk.entity);
+			if (!comp) {
+				layerState.topologyDirty = true;
+				chunk.dirty = false;
+				continue;
+			}
+			const uint16_t oldCount = chunk.componentCount;
+			const int* tileIds = comp->ReadTileIds(scratch);
+			if (LabelChunk(state, key, chunk, tileIds, comp->TileCount(), comp->chunkSize) && !layerState.topologyDirty) {
+				DetachChunk(layerState, key, chunk, oldCount);
+			}
+		}
+
+		// Nodes left behind by unloaded or grown chunks are reclaimed by a full rebuild
+		if (layerState.freeNodes * 2 > layerState.parent.size()) {
+			layerState.topologyDirty = true;
+		}
+
+		if (layerState.topologyDirty) {
+			RebuildUnionFind(layerState);
+		}
+		else if (!layerState.staleSides.empty()) {
+			MergeStale(layerState);
+		}
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Obstacles
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void ConnectivityMap::SyncObstacles(entt::registry& registry, RegistryState& state) {
+		// Rescan every source from scratch; tiles the old sources covered are
+		// rechecked too, so the blocked set is diffed rather than replaced
+		std::unordered_set<uint64_t> touchedTiles;
+		for (const auto& [entity, source] : state.sources) {
+			if (source.blocks) touchedTiles.insert(source.obstacleTile);
+			if (source.overrides) touchedTiles.insert(source.overrideTile);
+		}
+		state.sources.clear();
+		state.blockers.clear();
+		state.changedObstacles.clear();
+
+		for (auto entity : registry.view<TileComponent>()) {
+			UpdateSource(registry, state, entity, touchedTiles);
+		}
+		for (auto entity : registry.view<ObstacleComponent, GridPositionComponent>()) {
+			if (!state.sources.count(entity)) UpdateSource(registry, state, entity, touchedTiles);
+		}
+
+		UpdateBlocked(state, touchedTiles);
+		state.obstaclesDirty = false;
+	}
+
+	void ConnectivityMap::ApplyObstacleChanges(entt::registry& registry, RegistryState& state) {
+		std::unordered_set<uint64_t> touchedTiles;
+		for (entt::entity entity : state.changedObstacles) {
+			UpdateSource(registry, state, entity, touchedTiles);
+		}
+		state.changedObstacles.clear();
+		UpdateBlocked(state, touchedTiles);
+	}
+
+	void ConnectivityMap::UpdateSource(entt::registry& registry, RegistryState& state, entt::entity entity,
+		std::unordered_set<uint64_t>& touchedTiles)
+	{
+		// Withdraw what the entity contributed before
+		if (auto it = state.sources.find(entity); it != state.sources.end()) {
+			const ObstacleSource& old = it->second;
+			if (old.blocks) {
+				state.blockers[old.obstacleTile].obstacles--;
+				touchedTiles.insert(old.obstacleTile);
+			}
+			if (old.overrides) {
+				auto& blockers = state.blockers[old.overrideTile];
+				(old.walkable ? blockers.walkableOverrides : blockers.blockingOverrides)--;
+				touchedTiles.insert(old.overrideTile);
+			}
+			state.sources.erase(it);
+		}
+		if (!registry.valid(entity)) return;
+
+		ObstacleSource source;
+		if (const auto* tile = registry.try_get<TileComponent>(entity)) {
+			source.overrides = true;
+			source.walkable = tile->walkable;
+			source.overrideTile = PackCoords(tile->gridPosition);
+		}
+		const auto* obstacle = registry.try_get<ObstacleComponent>(entity);
+		const auto* grid = registry.try_get<GridPositionComponent>(entity);
+		if (obstacle && grid && obstacle->blocksMovement) {
+			source.blocks = true;
+			source.obstacleTile = PackCoords(grid->tile);
+		}
+		if (!source.blocks && !source.overrides) return;
+
+		if (source.blocks) {
+			state.blockers[source.obstacleTile].obstacles++;
+			touchedTiles.insert(source.obstacleTile);
+		}
+		if (source.overrides) {
+			auto& blockers = state.blockers[source.overrideTile];
+			(source.walkable ? blockers.walkableOverrides : blockers.blockingOverrides)++;
+			touchedTiles.insert(source.overrideTile);
+		}
+		state.sources.emplace(entity, source);
+	}
+
+	void ConnectivityMap::UpdateBlocked(RegistryState& state, const std::unordered_set<uint64_t>& touchedTiles) {
+		auto& tilemapSystem = TilemapSystem::GetInstance();
+		const int chunkSize = tilemapSystem.GetChunkSize();
+
+		// Dirty only the chunks whose blocked set actually changed
+		std::unordered_set<uint64_t> changedChunks;
+		for (uint64_t key : touchedTiles) {
+			// Mirror Pathfinder2D::IsTileWalkable: a TileComponent override wins over
+			// obstacles (both only matter on non-empty tiles, checked at labelling).
+			// The pathfinder honours whichever override it finds first; conflicting
+			// ones count as walkable here so no reachable pair is ever rejected.
+			bool blocks = false;
+			if (auto it = state.blockers.find(key); it != state.blockers.end()) {
+				const TileBlockers& blockers = it->second;
+				blocks = blockers.walkableOverrides == 0 && (blockers.blockingOverrides > 0 || blockers.obstacles > 0);
+				if (!blockers.obstacles && !blockers.walkableOverrides && !blockers.blockingOverrides)
+					state.blockers.erase(it);
+			}
+			if (blocks == (state.blocked.count(key) > 0)) continue;
+
+			const glm::ivec2 pos = UnpackCoords(key);
+			const glm::ivec2 chunkCoords = tilemapSystem.GetChunkCoords(pos);
+			const glm::ivec2 local = pos - chunkCoords * chunkSize;
+			const uint64_t chunkKey = PackCoords(chunkCoords);
+			const int index = local.y * chunkSize + local.x;
+			if (blocks) {
+				state.blocked.insert(key);
+				state.blockedByChunk[chunkKey].insert(index);
+			}
+			else {
+				state.blocked.erase(key);
+				auto chunkIt = state.blockedByChunk.find(chunkKey);
+				if (chunkIt != state.blockedByChunk.end()) {
+					chunkIt->second.erase(index);
+					if (chunkIt->second.empty()) state.blockedByChunk.erase(chunkIt);
+				}
+			}
+			changedChunks.insert(chunkKey);
+		}
+
+		for (auto& [layer, layerState] : state.layers) {
+			for (uint64_t chunkKey : changedChunks) {
+				auto it = layerState.chunks.find(chunkKey);
+				if (it != layerState.chunks.end()) it->second.dirty = true;
+			}
+		}
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Labelling
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void ConnectivityMap::ReindexChunks(entt::registry& registry, entt::entity layer, LayerState& layerState) {
+		const auto present = TilemapListener<RegistryState>::IndexLoadedChunks(registry, layer, layerState);
+
+		for (auto it = layerState.chunks.begin(); it != layerState.chunks.end();) {
+			if (!present.count(it->first)) {
+				if (!layerState.topologyDirty) DetachChunk(layerState, it->first, it->second, it->second.componentCount);
+				layerState.freeNodes += it->second.nodeCapacity;
+				it = layerState.chunks.erase(it);
+			}
+			else {
+				++it;
+			}
+		}
+
+		layerState.chunkSetDirty = false;
+	}
+
+	bool ConnectivityMap::LabelChunk(const RegistryState& state, uint64_t chunkKey, ChunkLabels& chunk,
+		const int* tileIds, int tileCount, int chunkSize)
+	{
+		const int total = chunkSize * chunkSize;
+		std::vector<uint8_t> walkable(total, 1);
+
+		// Tiles a short chunk lacks read as empty, hence walkable
+		std::vector<int> padded;
+		if (tileCount < total) {
+			padded.assign(total, -1);
+			std::copy(tileIds, tileIds + std::max(0, tileCount), padded.begin());
+			tileIds = padded.data();
+		}
+
+		// Obstacles only block non-empty tiles (empty tiles are always walkable)
+		if (auto it = state.blockedByChunk.find(chunkKey); it != state.blockedByChunk.end()) {
+			for (int index : it->second) {
+				if (index >= 0 && index < total && tileIds[index] != -1) walkable[index] = 0;
+			}
+		}
+
+		std::vector<uint16_t> labels(total, 0);
+		std::vector<int> stack;
+		stack.reserve(total);
+		uint16_t next = 0;
+
+		for (int seed = 0; seed < total; ++seed) {
+			if (!walkable[seed] || labels[seed]) continue;
+
+			labels[seed] = ++next;
+			stack.push_back(seed);
+			while (!stack.empty()) {
+				const int cur = stack.back();
+				stack.pop_back();
+				const int x = cur % chunkSize;
+				const int y = cur / chunkSize;
+
+				auto visit = [&](int idx) {
+					if (walkable[idx] && !labels[idx]) {
+						labels[idx] = next;
+						stack.push_back(idx);
+					}
+					};
+				if (x > 0)             visit(cur - 1);
+				if (x < chunkSize - 1) visit(cur + 1);
+				if (y > 0)             visit(cur - chunkSize);
+				if (y < chunkSize - 1) visit(cur + chunkSize);
+			}
+		}
+
+		// Labels are assigned in scan order, so identical walkability yields identical labels
+		const bool changed = chunk.chunkSize != chunkSize ||
+			chunk.componentCount != next ||
+			chunk.labels != labels;
+
+		chunk.chunkSize = chunkSize;
+		chunk.componentCount = next;
+		chunk.labels = std::move(labels);
+		chunk.dirty = false;
+		return changed;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Union-find
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void ConnectivityMap::DetachChunk(LayerState& layerState, uint64_t chunkKey, const ChunkLabels& chunk, uint32_t nodeCount) {
+		// The chunk's old components and everything stitched to them get re-merged
+		auto& parent = layerState.parent;
+		auto staleEdges = [&](const std::vector<Edge>& edges) {
+			for (const Edge& edge : edges) {
+				layerState.staleRoots.insert(parent[edge.first]);
+				layerState.staleRoots.insert(parent[edge.second]);
+			}
+			};
+
+		for (uint32_t i = 0; i < nodeCount; ++i) layerState.staleRoots.insert(parent[chunk.baseNode + i]);
+		for (const auto& edges : chunk.edges) staleEdges(edges);
+		layerState.staleSides[chunkKey] = 0xF;
+
+		// Neighbours restitch only the side facing this chunk
+		const glm::ivec2 coords = UnpackCoords(chunkKey);
+		for (int side = 0; side < 4; ++side) {
+			const uint64_t neighbourKey = PackCoords(coords + SIDES[side]);
+			auto it = layerState.chunks.find(neighbourKey);
+			if (it == layerState.chunks.end()) continue;
+			const int facing = side ^ 1;
+			staleEdges(it->second.edges[facing]);
+			layerState.staleSides[neighbourKey] |= uint8_t(1u << facing);
+		}
+	}
+
+	void ConnectivityMap::ComputeEdges(const LayerState& layerState, uint64_t chunkKey, ChunkLabels& chunk, int side) const {
+		auto& edges = chunk.edges[side];
+		edges.clear();
+		const int n = chunk.chunkSize;
+		if (n <= 0 || chunk.labels.empty()) return;
+
+		const glm::ivec2 dir = SIDES[side];
+		auto nIt = layerState.chunks.find(PackCoords(UnpackCoords(chunkKey) + dir));
+		const ChunkLabels* neighbour =
+			(nIt != layerState.chunks.end() && nIt->second.chunkSize == n && !nIt->second.labels.empty())
+			? &nIt->second : nullptr;
+
+		// Edge tiles meet the neighbour's opposite edge, or the void if it isn't loaded
+		for (int i = 0; i < n; ++i) {
+			int ownIndex, otherIndex;
+			if (dir.x != 0) {
+				ownIndex = i * n + (dir.x > 0 ? n - 1 : 0);
+				otherIndex = i * n + (dir.x > 0 ? 0 : n - 1);
+			}
+			else {
+				ownIndex = (dir.y > 0 ? n - 1 : 0) * n + i;
+				otherIndex = (dir.y > 0 ? 0 : n - 1) * n + i;
+			}
+
+			const uint32_t own = NodeOf(chunk, ownIndex);
+			if (own == UINT32_MAX) continue;
+			const uint32_t other = neighbour ? NodeOf(*neighbour, otherIndex) : VOID_NODE;
+			if (other != UINT32_MAX) edges.emplace_back(own, other);
+		}
+
+		std::sort(edges.begin(), edges.end());
+		edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+	}
+
+	void ConnectivityMap::RebuildUnionFind(LayerState& layerState) {
+		// Assign global node ranges; node 0 is the unloaded void
+		uint32_t nodeCount = 1;
+		for (auto& [key, chunk] : layerState.chunks) {
+			chunk.baseNode = nodeCount;
+			chunk.nodeCapacity = chunk.componentCount;
+			nodeCount += chunk.componentCount;
+		}
+
+		auto& parent = layerState.parent;
+		parent.resize(nodeCount);
+		for (uint32_t i = 0; i < nodeCount; ++i) parent[i] = i;
+
+		// Stitch each chunk's edges against its neighbours (or the void)
+		for (auto& [key, chunk] : layerState.chunks) {
+			for (int side = 0; side < 4; ++side) {
+				ComputeEdges(layerState, key, chunk, side);
+				for (const Edge& edge : chunk.edges[side]) Unite(parent, edge.first, edge.second);
+			}
+		}
+
+		// Flatten so queries never walk the forest
+		for (uint32_t i = 0; i < nodeCount; ++i) parent[i] = FindRoot(parent, i);
+
+		layerState.freeNodes = 0;
+		layerState.staleRoots.clear();
+		layerState.staleSides.clear();
+		layerState.topologyDirty = false;
+	}
+
+	void ConnectivityMap::MergeStale(LayerState& layerState) {
+		auto& parent = layerState.parent;
+
+		// Chunks that outgrew their node range move to the end of the forest
+		for (const auto& [key, sides] : layerState.staleSides) {
+			auto it = layerState.chunks.find(key);
+			if (it == layerState.chunks.end()) continue;
+			auto& chunk = it->second;
+			if (chunk.componentCount <= chunk.nodeCapacity) continue;
+
+			layerState.freeNodes += chunk.nodeCapacity;
+			chunk.baseNode = static_cast<uint32_t>(parent.size());
+			chunk.nodeCapacity = chunk.componentCount;
+			parent.resize(chunk.baseNode + chunk.nodeCapacity);
+			for (uint32_t i = chunk.baseNode; i < parent.size(); ++i) parent[i] = i;
+		}
+
+		// Split the stale components into single nodes. Roots are their
+		// component's smallest node, so each root is reset before its members.
+		const uint32_t nodeCount = static_cast<uint32_t>(parent.size());
+		std::vector<uint8_t> reset(nodeCount, 0);
+		for (uint32_t i = 0; i < nodeCount; ++i) {
+			if (!layerState.staleRoots.count(parent[i])) continue;
+			parent[i] = i;
+			reset[i] = 1;
+		}
+
+		// Restitch the stale sides, then re-merge every other edge reaching a reset node
+		for (const auto& [key, sides] : layerState.staleSides) {
+			auto it = layerState.chunks.find(key);
+			if (it == layerState.chunks.end()) continue;
+			for (int side = 0; side < 4; ++side) {
+				if (!(sides & (1u << side))) continue;
+				ComputeEdges(layerState, key, it->second, side);
+				for (const Edge& edge : it->second.edges[side]) Unite(parent, edge.first, edge.second);
+			}
+		}
+		for (const auto& [key, chunk] : layerState.chunks) {
+			auto staleIt = layerState.staleSides.find(key);
+			const uint8_t restitched = staleIt != layerState.staleSides.end() ? staleIt->second : 0;
+			for (int side = 0; side < 4; ++side) {
+				if (restitched & (1u << side)) continue;
+				for (const Edge& edge : chunk.edges[side]) {
+					if (reset[edge.first] || reset[edge.second]) Unite(parent, edge.first, edge.second);
+				}
+			}
+		}
+
+		for (uint32_t i = 0; i < nodeCount; ++i) parent[i] = FindRoot(parent, i);
+
+		layerState.staleRoots.clear();
+		layerState.staleSides.clear();
+	}
+
+	int ConnectivityMap::NodeAt(const RegistryState& state, const LayerState& layerState, const glm::ivec2& pos) const {
+		auto& tilemapSystem = TilemapSystem::GetInstance();
+		const glm::ivec2 chunkCoords = tilemapSystem.GetChunkCoords(pos);
+
+		auto it = layerState.chunks.find(PackCoords(chunkCoords));
+		if (it == layerState.chunks.end() || it->second.labels.empty()) {
+			// Unloaded tiles read as empty (-1) and therefore walkable
+			return static_cast<int>(VOID_NODE);
+		}
+
+		const auto& chunk = it->second;
+		const glm::ivec2 local = pos - chunkCoords * chunk.chunkSize;
+		const int index = local.y * chunk.chunkSize + local.x;
+		if (index < 0 || index >= static_cast<int>(chunk.labels.size())) return static_cast<int>(VOID_NODE);
+
+		const uint16_t label = chunk.labels[index];
+		return label ? static_cast<int>(chunk.baseNode + label - 1) : -1;
+	}
+
+} // namespace WanderSpire
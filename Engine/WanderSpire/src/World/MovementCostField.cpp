@@ -0,0 +1,365 @@
+#include "WanderSpire/World/MovementCostField.h"
+#include "WanderSpire/World/TilemapSystem.h"
+#include "WanderSpire/World/TileDefinitionManager.h"
+#include "WanderSpire/Components/TilemapChunkComponent.h"
+#include "WanderSpire/Components/ObstacleComponent.h"
+#include "WanderSpire/Components/GridPositionComponent.h"
+#include "WanderSpire/Components/TileComponent.h"
+
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+namespace WanderSpire {
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Helpers
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	static inline uint64_t PackCoords(const glm::ivec2& p) {
+		return (uint64_t(uint32_t(p.x)) << 32) | uint32_t(p.y);
+	}
+
+	static inline glm::ivec2 UnpackCoords(uint64_t key) {
+		return glm::ivec2{ int32_t(key >> 32), int32_t(key) };
+	}
+
+	static inline int FloorDiv(int a, int b) {
+		return (a >= 0) ? a / b : -((-a + b - 1) / b);
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Lifetime
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	MovementCostField& MovementCostField::GetInstance() {
+		static MovementCostField instance;
+		return instance;
+	}
+
+	// TileComponent overrides change passability, so they count as obstacles
+	MovementCostField::MovementCostField()
+		: m_listener(true) {}
+
+	void MovementCostField::Clear() {
+		m_listener.Clear();
+
+		std::lock_guard lock(m_listener.Mutex());
+		m_costByTile.clear();
+		m_definitionRevision = UINT64_MAX;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Queries
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	MovementCostField::Reader MovementCostField::Acquire(entt::registry& registry, entt::entity tilemapLayer) {
+		std::unique_lock lock(m_listener.Mutex());
+		const LayerState& layerState = Prepare(registry, tilemapLayer);
+		return Reader(std::move(lock), &layerState, TilemapSystem::GetInstance().GetChunkSize(), layerState.minCost);
+	}
+
+	uint8_t MovementCostField::GetCost(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& pos) {
+		auto reader = Acquire(registry, tilemapLayer);
+		return reader(pos);
+	}
+
+	uint8_t MovementCostField::Reader::operator()(const glm::ivec2& pos) {
+		const glm::ivec2 chunkCoords{ FloorDiv(pos.x, m_chunkSize), FloorDiv(pos.y, m_chunkSize) };
+		if (chunkCoords != m_cachedCoords) {
+			m_cachedCoords = chunkCoords;
+			auto it = m_layer->chunks.find(PackCoords(chunkCoords));
+			m_cached = (it != m_layer->chunks.end() && !it->second.costs.empty()) ? &it->second : nullptr;
+		}
+		if (!m_cached) return BASE_COST;
+
+		const glm::ivec2 local = pos - chunkCoords * m_cached->chunkSize;
+		return m_cached->costs[local.y * m_cached->chunkSize + local.x];
+	}
+
+	void MovementCostField::SetCostOverlay(entt::registry& registry, const glm::ivec2& pos, uint8_t cost) {
+		std::lock_guard lock(m_listener.Mutex());
+		auto& state = m_listener.StateFor(registry);
+		auto [it, inserted] = state.overlays.try_emplace(PackCoords(pos), cost);
+		if (!inserted) {
+			if (it->second == cost) return;
+			it->second = cost;
+		}
+		MarkOverlayDirty(state, pos);
+	}
+
+	void MovementCostField::ClearCostOverlay(entt::registry& registry, const glm::ivec2& pos) {
+		std::lock_guard lock(m_listener.Mutex());
+		auto& state = m_listener.StateFor(registry);
+		if (state.overlays.erase(PackCoords(pos)) == 0) return;
+		MarkOverlayDirty(state, pos);
+	}
+
+	void MovementCostField::ClearCostOverlays(entt::registry& registry) {
+		std::lock_guard lock(m_listener.Mutex());
+		auto& state = m_listener.StateFor(registry);
+		if (state.overlays.empty()) return;
+
+		for (auto& [key, indices] : state.overlaysByChunk) {
+			for (auto& [layer, layerState] : state.layers) {
+				if (auto it = layerState.chunks.find(key); it != layerState.chunks.end()) it->second.dirty = true;
+				layerState.chunkSetDirty = true;
+			}
+		}
+		state.overlays.clear();
+		state.overlaysByChunk.clear();
+	}
+
+	void MovementCostField::MarkChunkDirty(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords) {
+		m_listener.MarkChunkDirty(registry, tilemapLayer, chunkCoords);
+	}
+
+	void MovementCostField::Invalidate(entt::registry& registry) {
+		m_listener.Invalidate(registry);
+	}
+
+	void MovementCostField::MarkOverlayDirty(RegistryState& state, const glm::ivec2& pos) {
+		auto& tilemapSystem = TilemapSystem::GetInstance();
+		const int chunkSize = tilemapSystem.GetChunkSize();
+		const glm::ivec2 chunkCoords = tilemapSystem.GetChunkCoords(pos);
+		const uint64_t chunkKey = PackCoords(chunkCoords);
+		const glm::ivec2 local = pos - chunkCoords * chunkSize;
+		const int index = local.y * chunkSize + local.x;
+
+		auto& indices = state.overlaysByChunk[chunkKey];
+		auto it = std::lower_bound(indices.begin(), indices.end(), index);
+		const bool present = state.overlays.count(PackCoords(pos)) != 0;
+		if (present && (it == indices.end() || *it != index)) indices.insert(it, index);
+		if (!present && it != indices.end() && *it == index) indices.erase(it);
+		if (indices.empty()) state.overlaysByChunk.erase(chunkKey);
+
+		for (auto& [layer, layerState] : state.layers) {
+			auto chunkIt = layerState.chunks.find(chunkKey);
+			if (chunkIt != layerState.chunks.end()) chunkIt->second.dirty = true;
+			// Overlay-only chunks come and go with their overlays
+			layerState.chunkSetDirty = true;
+		}
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Rebuild pipeline
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	MovementCostField::LayerState& MovementCostField::Prepare(entt::registry& registry, entt::entity tilemapLayer) {
+		SyncDefinitions();
+
+		auto& state = m_listener.StateFor(registry);
+		auto& layerState = state.layers[tilemapLayer];
+
+		if (state.obstaclesDirty) {
+			SyncObstacles(registry, state);
+		}
+
+		bool changed = false;
+		if (layerState.chunkSetDirty) {
+			ReindexChunks(registry, tilemapLayer, state, layerState);
+			changed = true;
+		}
+
+		for (auto& [key, chunk] : layerState.chunks) {
+			if (!chunk.dirty) continue;
+			RebuildChunk(registry, state, key, chunk);
+			changed = true;
+		}
+
+		if (changed) {
+			// Empty and unloaded ground always costs BASE_COST
+			uint8_t minCost = BASE_COST;
+			for (const auto& [key, chunk] : layerState.chunks) minCost = std::min(minCost, chunk.minCost);
+			layerState.minCost = minCost;
+		}
+
+		return layerState;
+	}
+
+	uint8_t MovementCostField::DefinitionCost(int tileId) {
+		auto it = m_costByTile.find(tileId);
+		if (it == m_costByTile.end()) {
+			it = m_costByTile.emplace(tileId, TileDefinitionManager::GetInstance().GetMovementCost(tileId)).first;
+		}
+		return it->second;
+	}
+
+	void MovementCostField::SyncDefinitions() {
+		const uint64_t revision = TileDefinitionManager::GetInstance().GetRevision();
+		if (revision == m_definitionRevision) return;
+		m_definitionRevision = revision;
+
+		// Re-read only the ids we have seen and dirty the chunks that use a changed one
+		auto& definitions = TileDefinitionManager::GetInstance();
+		std::unordered_set<int> changedIds;
+		for (auto& [id, cost] : m_costByTile) {
+			const uint8_t current = definitions.GetMovementCost(id);
+			if (current != cost) {
+				cost = current;
+				changedIds.insert(id);
+			}
+		}
+		if (changedIds.empty()) return;
+
+		for (auto& [reg, state] : m_listener.States()) {
+			for (auto& [layer, layerState] : state.layers) {
+				for (auto& [key, chunk] : layerState.chunks) {
+					if (chunk.dirty) continue;
+					for (int id : chunk.tileIds) {
+						if (changedIds.count(id)) { chunk.dirty = true; break; }
+					}
+				}
+			}
+		}
+	}
+
+	void MovementCostField::SyncObstacles(entt::registry& registry, RegistryState& state) {
+		// Mirror Pathfinder2D::IsTileWalkable: the first TileComponent at a
+		// position wins over obstacles; both only apply to non-empty tiles.
+		auto& tilemapSystem = TilemapSystem::GetInstance();
+		const int chunkSize = tilemapSystem.GetChunkSize();
+
+		std::unordered_set<uint64_t> overridden;
+		std::unordered_map<uint64_t, std::vector<int>> blockedByChunk;
+		std::unordered_map<uint64_t, std::vector<int>> walkableByChunk;
+
+		auto addTo = [&](std::unordered_map<uint64_t, std::vector<int>>& byChunk, const glm::ivec2& pos) {
+			const glm::ivec2 chunkCoords = tilemapSystem.GetChunkCoords(pos);
+			const glm::ivec2 local = pos - chunkCoords * chunkSize;
+			byChunk[PackCoords(chunkCoords)].push_back(local.y * chunkSize + local.x);
+			};
+
+		auto tileView = registry.view<TileComponent>();
+		for (auto entity : tileView) {
+			const auto& tile = tileView.get<TileComponent>(entity);
+			if (!overridden.insert(PackCoords(tile.gridPosition)).second) continue;
+			addTo(tile.walkable ? walkableByChunk : blockedByChunk, tile.gridPosition);
+		}
+
+		auto obstacleView = registry.view<ObstacleComponent, GridPositionComponent>();
+		for (auto entity : obstacleView) {
+			if (!obstacleView.get<ObstacleComponent>(entity).blocksMovement) continue;
+			const glm::ivec2 pos = obstacleView.get<GridPositionComponent>(entity).tile;
+			if (overridden.insert(PackCoords(pos)).second) addTo(blockedByChunk, pos);
+		}
+
+		for (auto* byChunk : { &blockedByChunk, &walkableByChunk }) {
+			for (auto& [key, indices] : *byChunk) std::sort(indices.begin(), indices.end());
+		}
+
+		// Dirty only the chunks whose override sets changed
+		std::unordered_set<uint64_t> changed;
+		auto diff = [&](const std::unordered_map<uint64_t, std::vector<int>>& next,
+			const std::unordered_map<uint64_t, std::vector<int>>& prev) {
+				for (auto& [key, indices] : next) {
+					auto it = prev.find(key);
+					if (it == prev.end() || it->second != indices) changed.insert(key);
+				}
+				for (auto& [key, indices] : prev) {
+					if (!next.count(key)) changed.insert(key);
+				}
+			};
+		diff(blockedByChunk, state.blockedByChunk);
+		diff(walkableByChunk, state.walkableByChunk);
+
+		state.blockedByChunk = std::move(blockedByChunk);
+		state.walkableByChunk = std::move(walkableByChunk);
+		state.obstaclesDirty = false;
+
+		for (auto& [layer, layerState] : state.layers) {
+			for (uint64_t key : changed) {
+				if (auto it = layerState.chunks.find(key); it != layerState.chunks.end()) it->second.dirty = true;
+			}
+		}
+	}
+
+	void MovementCostField::ReindexChunks(entt::registry& registry, entt::entity layer,
+		RegistryState& state, LayerState& layerState)
+	{
+		auto present = TilemapListener<RegistryState>::IndexLoadedChunks(registry, layer, layerState);
+
+		// Overlays apply over unloaded ground too
+		for (auto& [key, indices] : state.overlaysByChunk) {
+			if (present.insert(key).second) {
+				auto& entry = layerState.chunks[key];
+				if (entry.entity != entt::null || entry.costs.empty()) {
+					entry.entity = entt::null;
+					entry.dirty = true;
+				}
+			}
+		}
+
+		for (auto it = layerState.chunks.begin(); it != layerState.chunks.end();) {
+			if (!present.count(it->first)) it = layerState.chunks.erase(it);
+			else ++it;
+		}
+
+		layerState.chunkSetDirty = false;
+	}
+
+	void MovementCostField::RebuildChunk(entt::registry& registry, const RegistryState& state,
+		uint64_t chunkKey, CostChunk& chunk)
+	{
+		const auto* comp = (chunk.entity != entt::null && registry.valid(chunk.entity))
+			? registry.try_get<TilemapChunkComponent>(chunk.entity) : nullptr;
+		const int chunkSize = comp ? comp->chunkSize : TilemapSystem::GetInstance().GetChunkSize();
+		const int total = chunkSize * chunkSize;
+		const bool hasTiles = comp != nullptr;
+		std::vector<int> scratch;
+		const int* tileIds = hasTiles ? comp->ReadTileIds(scratch) : nullptr;
+
+		// Tiles a short chunk lacks read as empty, as in ConnectivityMap::LabelChunk
+		std::vector<int> padded;
+		if (hasTiles && comp->TileCount() < total) {
+			padded.assign(total, -1);
+			std::copy(tileIds, tileIds + std::max(0, comp->TileCount()), padded.begin());
+			tileIds = padded.data();
+		}
+
+		chunk.chunkSize = chunkSize;
+		chunk.costs.assign(total, BASE_COST);
+		chunk.tileIds.clear();
+
+		if (hasTiles) {
+			for (int i = 0; i < total; ++i) {
+				const int id = tileIds[i];
+				if (id == -1) continue;
+				chunk.costs[i] = DefinitionCost(id);
+				if (std::find(chunk.tileIds.begin(), chunk.tileIds.end(), id) == chunk.tileIds.end())
+					chunk.tileIds.push_back(id);
+			}
+		}
+
+		auto isTile = [&](int i) { return hasTiles && tileIds[i] != -1; };
+
+		// Overlays replace the definition cost...
+		if (auto it = state.overlaysByChunk.find(chunkKey); it != state.overlaysByChunk.end()) {
+			const glm::ivec2 origin = UnpackCoords(chunkKey) * chunkSize;
+			for (int i : it->second) {
+				if (i < 0 || i >= total) continue;
+				auto overlay = state.overlays.find(PackCoords(origin + glm::ivec2{ i % chunkSize, i / chunkSize }));
+				if (overlay != state.overlays.end()) chunk.costs[i] = overlay->second;
+			}
+		}
+
+		// ...while per-tile overrides and obstacles decide passability
+		if (auto it = state.walkableByChunk.find(chunkKey); it != state.walkableByChunk.end()) {
+			for (int i : it->second) {
+				if (i >= 0 && i < total && isTile(i) && chunk.costs[i] == BLOCKED) chunk.costs[i] = BASE_COST;
+			}
+		}
+		if (auto it = state.blockedByChunk.find(chunkKey); it != state.blockedByChunk.end()) {
+			for (int i : it->second) {
+				if (i >= 0 && i < total && isTile(i)) chunk.costs[i] = BLOCKED;
+			}
+		}
+
+		uint8_t minCost = BASE_COST;
+		for (uint8_t cost : chunk.costs) {
+			if (cost != BLOCKED && cost < minCost) minCost = cost;
+		}
+		chunk.minCost = minCost;
+		chunk.dirty = false;
+	}
+
+} // namespace WanderSpire
@@ -0,0 +1,231 @@
+#include "WanderSpire/World/PalettedTileStorage.h"
+
+#include <algorithm>
+
+namespace WanderSpire {
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Construction
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	int PalettedTileStorage::BitsFor(size_t paletteSize) {
+		if (paletteSize <= 1) return 0;
+		if (paletteSize <= 2) return 1;
+		if (paletteSize <= 4) return 2;
+		if (paletteSize <= 16) return 4;
+		if (paletteSize <= 256) return 8;
+		return 16;
+	}
+
+	void PalettedTileStorage::SetBits(int bits) {
+		m_bits = bits;
+		if (bits == 0) {
+			m_perWordShift = 6;
+			m_mask = 0;
+			m_words.clear();
+			m_words.shrink_to_fit();
+			return;
+		}
+		m_perWordShift = 0;
+		while ((bits << m_perWordShift) < 64) ++m_perWordShift;   // 64 / bits indices per word
+		m_mask = (uint64_t(1) << bits) - 1;
+		const size_t perWord = size_t(1) << m_perWordShift;
+		m_words.assign((static_cast<size_t>(m_tileCount) + perWord - 1) / perWord, 0);
+	}
+
+	void PalettedTileStorage::Reset(int tileCount, int fillTileId) {
+		m_tileCount = std::max(0, tileCount);
+		m_palette.assign(1, fillTileId);
+		m_refCounts.assign(1, static_cast<uint32_t>(m_tileCount));
+		m_freeEntries.clear();
+		m_lookup.clear();
+		m_data.clear();
+		SetBits(0);
+	}
+
+	void PalettedTileStorage::Encode(const int* tileIds, const uint32_t* tileData, int tileCount) {
+		m_tileCount = std::max(0, tileCount);
+		m_palette.clear();
+		m_refCounts.clear();
+		m_freeEntries.clear();
+		m_lookup.clear();
+		m_data.clear();
+
+		std::vector<uint32_t> indices(static_cast<size_t>(m_tileCount));
+		for (int i = 0; i < m_tileCount; ++i) {
+			const uint32_t slot = FindOrAddPaletteEntry(tileIds[i]);
+			++m_refCounts[slot];
+			indices[i] = slot;
+		}
+		if (m_palette.empty()) {
+			m_palette.push_back(-1);
+			m_refCounts.push_back(0);
+		}
+
+		SetBits(BitsFor(m_palette.size()));
+		if (m_bits) {
+			for (int i = 0; i < m_tileCount; ++i) SetIndexAt(i, indices[i]);
+		}
+
+		if (tileData) {
+			for (int i = 0; i < m_tileCount; ++i) {
+				if (tileData[i]) m_data.emplace_back(static_cast<uint32_t>(i), tileData[i]);
+			}
+		}
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Decoding
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void PalettedTileStorage::Decode(int* outTileIds) const {
+		DecodeRange(0, m_tileCount, outTileIds);
+	}
+
+	void PalettedTileStorage::DecodeRange(int first, int count, int* outTileIds) const {
+		if (count <= 0) return;
+		if (m_bits == 0) {
+			std::fill_n(outTileIds, count, m_palette[0]);
+			return;
+		}
+
+		// Walk whole words, shifting each down instead of recomputing positions
+		const int perWord = 1 << m_perWordShift;
+		const int* palette = m_palette.data();
+		int i = first;
+		const int end = first + count;
+		while (i < end) {
+			size_t w = static_cast<size_t>(i) >> m_perWordShift;
+			int lane = i & (perWord - 1);
+			uint64_t word = m_words[w] >> (lane * m_bits);
+			const int stop = std::min(end, i + (perWord - lane));
+			for (; i < stop; ++i) {
+				*outTileIds++ = palette[word & m_mask];
+				word >>= m_bits;
+			}
+		}
+	}
+
+	void PalettedTileStorage::DecodeData(uint32_t* outTileData) const {
+		std::fill_n(outTileData, m_tileCount, 0u);
+		for (const auto& [index, value] : m_data) outTileData[index] = value;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Editing
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void PalettedTileStorage::SetIndexAt(int i, uint32_t paletteIndex) {
+		uint64_t& word = m_words[static_cast<size_t>(i) >> m_perWordShift];
+		const int shift = (i & ((1 << m_perWordShift) - 1)) * m_bits;
+		word = (word & ~(m_mask << shift)) | (static_cast<uint64_t>(paletteIndex) << shift);
+	}
+
+	uint32_t PalettedTileStorage::FindOrAddPaletteEntry(int tileId) {
+		uint32_t slot = UINT32_MAX;
+		if (!m_lookup.empty()) {
+			if (auto it = m_lookup.find(tileId); it != m_lookup.end()) slot = it->second;
+		}
+		else {
+			for (size_t i = 0; i < m_palette.size(); ++i) {
+				if (m_palette[i] == tileId) { slot = static_cast<uint32_t>(i); break; }
+			}
+		}
+
+		if (slot != UINT32_MAX) {
+			// A dead entry coming back to life must leave the free list
+			if (m_refCounts[slot] == 0) {
+				m_freeEntries.erase(std::remove(m_freeEntries.begin(), m_freeEntries.end(), slot), m_freeEntries.end());
+			}
+			return slot;
+		}
+
+		if (!m_freeEntries.empty()) {
+			slot = m_freeEntries.back();
+			m_freeEntries.pop_back();
+			if (!m_lookup.empty()) m_lookup.erase(m_palette[slot]);
+			m_palette[slot] = tileId;
+		}
+		else {
+			slot = static_cast<uint32_t>(m_palette.size());
+			m_palette.push_back(tileId);
+			m_refCounts.push_back(0);
+		}
+
+		if (!m_lookup.empty()) {
+			m_lookup[tileId] = slot;
+		}
+		else if (m_palette.size() > LINEAR_LOOKUP_LIMIT) {
+			for (size_t i = 0; i < m_palette.size(); ++i) m_lookup[m_palette[i]] = static_cast<uint32_t>(i);
+		}
+		return slot;
+	}
+
+	void PalettedTileStorage::Repack(int newBits) {
+		std::vector<uint32_t> indices(static_cast<size_t>(m_tileCount));
+		for (int i = 0; i < m_tileCount; ++i) indices[i] = IndexAt(i);
+		SetBits(newBits);
+		if (m_bits) {
+			for (int i = 0; i < m_tileCount; ++i) SetIndexAt(i, indices[i]);
+		}
+	}
+
+	void PalettedTileStorage::Set(int index, int tileId) {
+		const uint32_t oldSlot = IndexAt(index);
+		if (m_palette[oldSlot] == tileId) return;
+
+		const uint32_t newSlot = FindOrAddPaletteEntry(tileId);
+		const int needed = BitsFor(m_palette.size());
+		if (needed > m_bits) Repack(needed);
+
+		SetIndexAt(index, newSlot);
+		++m_refCounts[newSlot];
+		if (--m_refCounts[oldSlot] == 0) m_freeEntries.push_back(oldSlot);
+	}
+
+	uint32_t PalettedTileStorage::GetData(int index) const {
+		auto it = std::lower_bound(m_data.begin(), m_data.end(), static_cast<uint32_t>(index),
+			[](const auto& entry, uint32_t i) { return entry.first < i; });
+		return (it != m_data.end() && it->first == static_cast<uint32_t>(index)) ? it->second : 0;
+	}
+
+	void PalettedTileStorage::SetData(int index, uint32_t value) {
+		auto it = std::lower_bound(m_data.begin(), m_data.end(), static_cast<uint32_t>(index),
+			[](const auto& entry, uint32_t i) { return entry.first < i; });
+		const bool present = it != m_data.end() && it->first == static_cast<uint32_t>(index);
+		if (value == 0) {
+			if (present) m_data.erase(it);
+		}
+		else if (present) {
+			it->second = value;
+		}
+		else {
+			m_data.insert(it, { static_cast<uint32_t>(index), value });
+		}
+	}
+
+	void PalettedTileStorage::ShrinkToFit() {
+		std::vector<int> tiles(static_cast<size_t>(m_tileCount));
+		Decode(tiles.data());
+		auto data = std::move(m_data);
+		Encode(tiles.data(), nullptr, m_tileCount);
+		m_data = std::move(data);
+		m_data.shrink_to_fit();
+		m_palette.shrink_to_fit();
+		m_refCounts.shrink_to_fit();
+	}
+
+	size_t PalettedTileStorage::MemoryBytes() const {
+		size_t bytes = sizeof(*this);
+		bytes += m_palette.capacity() * sizeof(int);
+		bytes += m_refCounts.capacity() * sizeof(uint32_t);
+		bytes += m_freeEntries.capacity() * sizeof(uint32_t);
+		bytes += m_words.capacity() * sizeof(uint64_t);
+		bytes += m_data.capacity() * sizeof(std::pair<uint32_t, uint32_t>);
+		// Rough node cost: key/value plus pointer and bucket slot
+		bytes += m_lookup.size() * (sizeof(std::pair<const int, uint32_t>) + 2 * sizeof(void*));
+		bytes += m_lookup.bucket_count() * sizeof(void*);
+		return bytes;
+	}
+
+} // namespace WanderSpire
@@ -0,0 +1,259 @@
+#include "WanderSpire/World/PathRequestService.h"
+#include "WanderSpire/ECS/RegistryIdentity.h"
+#include "WanderSpire/World/Pathfinder2D.h"
+#include "WanderSpire/Core/ConfigManager.h"
+#include "WanderSpire/Core/EventBus.h"
+#include "WanderSpire/Core/Events.h"
+
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+namespace WanderSpire {
+
+	size_t PathRequestService::SearchKeyHash::operator()(const SearchKey& k) const noexcept {
+		uint64_t h = 1469598103934665603ull;
+		auto mix = [&h](uint64_t v) { h = (h ^ v) * 1099511628211ull; };
+		mix(uint32_t(k.start.x)); mix(uint32_t(k.start.y));
+		mix(uint32_t(k.target.x)); mix(uint32_t(k.target.y));
+		mix(uint32_t(k.maxRange));
+		mix(static_cast<uint64_t>(entt::to_integral(k.layer)));
+		mix(k.weighted ? 1u : 0u);
+		return static_cast<size_t>(h);
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Lifetime
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	PathRequestService& PathRequestService::GetInstance() {
+		static PathRequestService instance;
+		return instance;
+	}
+
+	PathRequestService::PathRequestService()
+		: m_budgetMicros(static_cast<uint32_t>(std::max(0, ConfigManager::Get().pathBudgetMicros)))
+	{
+	}
+
+	void PathRequestService::Clear() {
+		std::lock_guard lock(m_mutex);
+		m_registries.clear();
+	}
+
+	void PathRequestService::SetFrameBudget(uint32_t micros) {
+		std::lock_guard lock(m_mutex);
+		m_budgetMicros = micros;
+	}
+
+	uint32_t PathRequestService::GetFrameBudget() const {
+		std::lock_guard lock(m_mutex);
+		return m_budgetMicros;
+	}
+
+	void PathRequestService::SetFrameBudget(entt::registry& registry, uint32_t micros) {
+		std::lock_guard lock(m_mutex);
+		auto& state = StateFor(registry);
+		state.budgetMicros = micros;
+		state.ownBudget = true;
+	}
+
+	uint32_t PathRequestService::GetFrameBudget(entt::registry& registry) {
+		std::lock_guard lock(m_mutex);
+		auto& state = StateFor(registry);
+		return state.ownBudget ? state.budgetMicros : m_budgetMicros;
+	}
+
+	PathRequestService::RegistryState& PathRequestService::StateFor(entt::registry& registry) {
+		auto it = m_registries.find(&registry);
+		if (it != m_registries.end() && !IsRegistryMarked<PathRequestService>(registry)) {
+			m_registries.erase(it);
+			it = m_registries.end();
+		}
+		if (it == m_registries.end()) {
+			MarkRegistry<PathRequestService>(registry);
+			registry.on_destroy<entt::entity>().connect<&PathRequestService::OnEntityDestroyed>(*this);
+			it = m_registries.emplace(&registry, RegistryState{}).first;
+		}
+		return it->second;
+	}
+
+	void PathRequestService::OnEntityDestroyed(entt::registry& registry, entt::entity entity) {
+		std::lock_guard lock(m_mutex);
+		auto it = m_registries.find(&registry);
+		if (it == m_registries.end() || !IsRegistryMarked<PathRequestService>(registry)) return;
+
+		auto& state = it->second;
+		if (auto entIt = state.byEntity.find(entity); entIt != state.byEntity.end()) {
+			Remove(state, entIt->second);
+		}
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Queue management
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	PathRequestService::RequestId PathRequestService::Submit(entt::registry& registry, const PathRequest& request) {
+		std::lock_guard lock(m_mutex);
+		auto& state = StateFor(registry);
+
+		// Nothing would receive the result
+		if (request.entity != entt::null && !registry.valid(request.entity)) return INVALID_REQUEST;
+
+		// A re-targeting agent only cares about its latest request
+		if (request.entity != entt::null) {
+			if (auto it = state.byEntity.find(request.entity); it != state.byEntity.end()) {
+				Remove(state, it->second);
+			}
+		}
+
+		RequestId id = m_nextId++;
+		if (id == INVALID_REQUEST) id = m_nextId++;
+
+		Pending entry;
+		entry.key = { request.start, request.target, std::max(1, request.maxRange),
+			request.tilemapLayer, request.weighted };
+		entry.entity = request.entity;
+		entry.priority = request.priority;
+		entry.deadline = request.deadlineMicros
+			? Clock::now() + std::chrono::microseconds(request.deadlineMicros)
+			: Clock::time_point::max();
+		entry.sequence = m_nextSequence++;
+
+		state.order.emplace(-entry.priority, entry.deadline, entry.sequence, id);
+		if (request.deadlineMicros) state.deadlines.emplace(entry.deadline, id);
+		state.byKey[entry.key].push_back(id);
+		if (request.entity != entt::null) state.byEntity[request.entity] = id;
+		state.pending.emplace(id, entry);
+
+		return id;
+	}
+
+	bool PathRequestService::Cancel(entt::registry& registry, RequestId id) {
+		std::lock_guard lock(m_mutex);
+		auto& state = StateFor(registry);
+		if (!state.pending.count(id)) return false;
+		Remove(state, id);
+		return true;
+	}
+
+	size_t PathRequestService::CancelForEntity(entt::registry& registry, entt::entity entity) {
+		std::lock_guard lock(m_mutex);
+		auto& state = StateFor(registry);
+		auto it = state.byEntity.find(entity);
+		if (it == state.byEntity.end()) return 0;
+		Remove(state, it->second);
+		return 1;
+	}
+
+	size_t PathRequestService::GetPendingCount(entt::registry& registry) {
+		std::lock_guard lock(m_mutex);
+		return StateFor(registry).pending.size();
+	}
+
+	void PathRequestService::Remove(RegistryState& state, RequestId id) {
+		auto it = state.pending.find(id);
+		if (it == state.pending.end()) return;
+		const Pending& entry = it->second;
+
+		state.order.erase({ -entry.priority, entry.deadline, entry.sequence, id });
+		state.deadlines.erase({ entry.deadline, id });
+
+		if (auto keyIt = state.byKey.find(entry.key); keyIt != state.byKey.end()) {
+			auto& ids = keyIt->second;
+			ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+			if (ids.empty()) state.byKey.erase(keyIt);
+		}
+
+		if (entry.entity != entt::null) {
+			auto entIt = state.byEntity.find(entry.entity);
+			if (entIt != state.byEntity.end() && entIt->second == id) state.byEntity.erase(entIt);
+		}
+
+		state.pending.erase(it);
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Frame update
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	size_t PathRequestService::Update(entt::registry& registry) {
+		return Update(registry, GetFrameBudget(registry));
+	}
+
+	size_t PathRequestService::Update(entt::registry& registry, uint32_t budgetMicros) {
+		const auto frameStart = Clock::now();
+		const auto budget = std::chrono::microseconds(budgetMicros);
+		size_t searches = 0;
+
+		while (true) {
+			std::unique_ptr<PathSearch> search;
+			SearchKey key;
+			{
+				std::lock_guard lock(m_mutex);
+				auto& state = StateFor(registry);
+
+				// A search nobody waits for any more is abandoned mid-way
+				if (state.search && !state.byKey.count(state.searchKey)) {
+					state.search.reset();
+				}
+
+				if (state.search) {
+					// The search started in an earlier slice finishes first
+					search = std::move(state.search);
+					key = state.searchKey;
+				}
+				else {
+					if (state.order.empty()) break;
+
+					// Overdue requests jump the priority order
+					RequestId next = std::get<3>(*state.order.begin());
+					if (!state.deadlines.empty() && state.deadlines.begin()->first <= frameStart) {
+						next = state.deadlines.begin()->second;
+					}
+					key = state.pending.at(next).key;
+					search = std::make_unique<PathSearch>(key.start, key.target, key.maxRange, key.layer, key.weighted);
+				}
+			}
+
+			// Search without holding the lock so submissions never stall
+			const bool done = search->Step(registry, SLICE_EXPANSIONS);
+
+			// Every request still waiting on this search shares its result
+			std::vector<std::pair<RequestId, entt::entity>> waiters;
+			{
+				std::lock_guard lock(m_mutex);
+				auto& state = StateFor(registry);
+				if (!done) {
+					state.search = std::move(search);
+					state.searchKey = key;
+				}
+				else if (auto it = state.byKey.find(key); it != state.byKey.end()) {
+					const std::vector<RequestId> ids = it->second;
+					for (RequestId id : ids) {
+						waiters.emplace_back(id, state.pending.at(id).entity);
+						Remove(state, id);
+					}
+				}
+			}
+
+			if (done) {
+				++searches;
+				const PathResult& result = search->Result();
+				auto& bus = EventBus::Get();
+				for (const auto& [id, entity] : waiters) {
+					if (entity != entt::null && !registry.valid(entity)) continue;
+					PathAppliedEvent ev;
+					ev.entity = entity;
+					ev.checkpoints = result.checkpoints;
+					ev.requestId = id;
+					bus.Publish(ev);
+				}
+			}
+
+			if (Clock::now() - frameStart >= budget) break;
+		}
+
+		return searches;
+	}
+
+} // namespace WanderSpire
@@ -1,15 +1,17 @@
 ﻿#include "WanderSpire/World/Pathfinder2D.h"
 #include "WanderSpire/World/TilemapSystem.h"
+#include "WanderSpire/World/ConnectivityMap.h"
+#include "WanderSpire/World/MovementCostField.h"
 #include "WanderSpire/Components/ObstacleComponent.h"
 #include "WanderSpire/Components/GridPositionComponent.h"
 #include "WanderSpire/Components/TileComponent.h"
 #include "WanderSpire/Components/TilemapLayerComponent.h"
 #include "WanderSpire/Components/SceneNodeComponent.h"
 
-#include <queue>
 #include <unordered_map>
 #include <unordered_set>
 #include <limits>
+#include <algorithm>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/norm.hpp>
 
@@ -32,6 +34,59 @@ namespace WanderSpire {
 		{-1,  1}, {-1, -1}
 	};
 
+	/// Step greedily toward target until stuck, reached or out of range.
+	template<typename CanMove, typename InRange>
+	static void GreedyFallback(PathResult& out, const glm::ivec2& start, const glm::ivec2& target,
+		int maxRange, CanMove&& canMove, InRange&& withinRange)
+	{
+		glm::ivec2 cur = start;
+		out.fullPath.push_back(cur);
+
+		// Keep stepping greedily toward target until stuck or reached
+		while (cur != target && int(out.fullPath.size()) <= maxRange) {
+			float bestDist = std::numeric_limits<float>::infinity();
+			glm::ivec2 bestNbr = cur;
+
+			for (auto d : DIRS) {
+				glm::ivec2 cand = cur + d;
+				if (!withinRange(cand)) continue;
+				if (!canMove(cur, cand)) continue;
+
+				float dist2 = glm::distance2(glm::vec2(cand), glm::vec2(target));
+				if (dist2 < bestDist) {
+					bestDist = dist2;
+					bestNbr = cand;
+				}
+			}
+
+			if (bestNbr == cur) {
+				// No neighbor improved—stop
+				break;
+			}
+
+			cur = bestNbr;
+			out.fullPath.push_back(cur);
+			if (cur == target) break;
+		}
+	}
+
+	/// Record the tile before every direction change, plus the destination.
+	static void ExtractCheckpoints(PathResult& out) {
+		if (out.fullPath.empty()) return;
+
+		glm::ivec2 prevDir{ 0, 0 };
+		for (size_t i = 1; i < out.fullPath.size(); ++i) {
+			glm::ivec2 dir = out.fullPath[i] - out.fullPath[i - 1];
+			// Whenever direction changes, record the previous tile
+			if (dir.x != prevDir.x || dir.y != prevDir.y) {
+				out.checkpoints.push_back(out.fullPath[i - 1]);
+				prevDir = dir;
+			}
+		}
+		// Always append the final destination
+		out.checkpoints.push_back(out.fullPath.back());
+	}
+
 	// ─────────────────────────────────────────────────────────────────────────────
 	// Dynamic tilemap layer finding
 	// ─────────────────────────────────────────────────────────────────────────────
@@ -148,6 +203,19 @@ namespace WanderSpire {
 		return true;
 	}
 
+	bool Pathfinder2D::AreConnected(entt::registry& registry, entt::entity tilemapLayer,
+		const glm::ivec2& a, const glm::ivec2& b) {
+		if (!registry.valid(tilemapLayer) || tilemapLayer == entt::null) {
+			tilemapLayer = FindFirstTilemapLayer(registry);
+			if (tilemapLayer == entt::null) {
+				// No tilemap found, everything is open ground
+				return true;
+			}
+		}
+
+		return ConnectivityMap::GetInstance().AreConnected(registry, tilemapLayer, a, b);
+	}
+
 	// ─────────────────────────────────────────────────────────────────────────────
 	// Main pathfinding algorithm
 	// ─────────────────────────────────────────────────────────────────────────────
@@ -159,129 +227,262 @@ namespace WanderSpire {
 		entt::registry& registry,
 		entt::entity      tilemapLayer
 	) {
-		PathResult out;
+		PathSearch search(start, target, maxRange, tilemapLayer, false);
+		search.Step(registry, SIZE_MAX);
+		return search.TakeResult();
+	}
+
+	PathResult Pathfinder2D::FindWeightedPath(
+		const glm::ivec2& start,
+		const glm::ivec2& target,
+		int               maxRange,
+		entt::registry& registry,
+		entt::entity      tilemapLayer
+	) {
+		PathSearch search(start, target, maxRange, tilemapLayer, true);
+		search.Step(registry, SIZE_MAX);
+		return search.TakeResult();
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Resumable search
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	PathSearch::PathSearch(const glm::ivec2& start, const glm::ivec2& target, int maxRange,
+		entt::entity tilemapLayer, bool weighted)
+		: m_start(start)
+		, m_target(target)
+		, m_range(std::max(1, maxRange))
+		, m_layer(tilemapLayer)
+		, m_weighted(weighted)
+	{
+	}
+
+	bool PathSearch::WithinRange(const glm::ivec2& p) const {
+		const glm::ivec2 d = p - m_start;
+		return d.x * d.x + d.y * d.y <= m_range * m_range;
+	}
+
+	uint32_t PathSearch::IndexOf(const glm::ivec2& p) const {
+		return static_cast<uint32_t>((p.y - m_start.y + m_range) * m_side + (p.x - m_start.x + m_range));
+	}
 
+	glm::ivec2 PathSearch::PosOf(uint32_t index) const {
+		return glm::ivec2{ int(index % m_side) - m_range + m_start.x, int(index / m_side) - m_range + m_start.y };
+	}
+
+	// Octile distance scaled by the cheapest tile keeps the heuristic admissible
+	uint32_t PathSearch::Heuristic(const glm::ivec2& p) const {
+		const int dx = std::abs(m_target.x - p.x);
+		const int dy = std::abs(m_target.y - p.y);
+		return m_minCost * static_cast<uint32_t>(10 * std::max(dx, dy) + 4 * std::min(dx, dy));
+	}
+
+	// Min-heap on f
+	static bool HeapLess(const std::pair<uint32_t, uint32_t>& a, const std::pair<uint32_t, uint32_t>& b) {
+		return a.first > b.first;
+	}
+
+	bool PathSearch::Step(entt::registry& registry, size_t maxExpansions) {
+		if (m_done) return true;
+
+		if (!m_started) {
+			m_started = true;
+			Begin(registry);
+			if (m_done) return true;
+		}
+		else if (!registry.valid(m_layer)) {
+			// The layer went away between slices; there is nothing left to search
+			m_done = true;
+			return true;
+		}
+
+		if (m_weighted) StepWeighted(registry, maxExpansions);
+		else StepBreadthFirst(registry, maxExpansions);
+		return m_done;
+	}
+
+	void PathSearch::Begin(entt::registry& registry) {
 		// Auto-find tilemap layer if not provided or invalid
-		if (!registry.valid(tilemapLayer) || tilemapLayer == entt::null) {
-			tilemapLayer = FindFirstTilemapLayer(registry);
-			if (tilemapLayer == entt::null) {
+		if (!registry.valid(m_layer) || m_layer == entt::null) {
+			m_layer = Pathfinder2D::FindFirstTilemapLayer(registry);
+			if (m_layer == entt::null) {
 				// No tilemap found - create a simple direct path
-				out.fullPath.push_back(start);
-				if (start != target) {
-					out.fullPath.push_back(target);
+				m_result.fullPath.push_back(m_start);
+				if (m_start != m_target) {
+					m_result.fullPath.push_back(m_target);
 				}
-				out.checkpoints = out.fullPath;
-				return out;
+				m_result.checkpoints = m_result.fullPath;
+				m_done = true;
+				return;
 			}
 		}
 
-		// Early exit if start or target is not walkable
-		if (!IsTileWalkable(registry, tilemapLayer, start) ||
-			!IsTileWalkable(registry, tilemapLayer, target)) {
-			return out;
+		if (!m_weighted) {
+			// Early exit if start or target is not walkable
+			if (!Pathfinder2D::IsTileWalkable(registry, m_layer, m_start) ||
+				!Pathfinder2D::IsTileWalkable(registry, m_layer, m_target)) {
+				m_done = true;
+				return;
+			}
+
+			// ─── Reachability rejection ──────────────────────────────────────────
+			// Targets in another walkable region can never be reached, so skip the
+			// flood of the whole range and go straight to the greedy fallback.
+			m_searching = ConnectivityMap::GetInstance().AreConnected(registry, m_layer, m_start, m_target);
+
+			m_queue.push_back(m_start);
+			m_visited.insert(HashKey(m_start));
+			return;
 		}
 
-		// Range limit
-		int r = std::max(1, maxRange);
-		int r2 = r * r;
+		// Connectivity ignores step costs, so it can only over-approximate here
+		const bool reachable = ConnectivityMap::GetInstance().AreConnected(registry, m_layer, m_start, m_target);
 
-		auto withinRange = [&](const glm::ivec2& p) {
-			return glm::distance2(glm::vec2(p), glm::vec2(start)) <= float(r2);
-			};
+		auto cost = MovementCostField::GetInstance().Acquire(registry, m_layer);
+		if (cost(m_start) == MovementCostField::BLOCKED || cost(m_target) == MovementCostField::BLOCKED) {
+			m_done = true;
+			return;
+		}
 
-		// ─── BFS phase ────────────────────────────────────────────────────────────
-		std::queue<glm::ivec2> q;
-		std::unordered_map<uint64_t, glm::ivec2> parent;
-		std::unordered_set<uint64_t> visited;
+		m_searching = reachable && WithinRange(m_target);
+		if (!m_searching) return;
 
-		uint64_t startKey = HashKey(start);
-		q.push(start);
-		visited.insert(startKey);
-		bool found = false;
-		glm::ivec2 reached{ -1, -1 };
+		// Costs may change between slices; the heuristic keeps the scale seen here
+		m_minCost = cost.MinCost();
+		m_side = 2 * m_range + 1;
+		const size_t cells = static_cast<size_t>(m_side) * static_cast<size_t>(m_side);
+		m_gScore.assign(cells, UINT32_MAX);
+		m_cameFrom.assign(cells, 0xFF);
 
-		while (!q.empty()) {
-			glm::ivec2 cur = q.front();
-			q.pop();
+		const uint32_t startIndex = IndexOf(m_start);
+		m_gScore[startIndex] = 0;
+		m_open.push_back({ Heuristic(m_start), startIndex });
+	}
+
+	void PathSearch::StepBreadthFirst(entt::registry& registry, size_t maxExpansions) {
+		auto canMove = [&](const glm::ivec2& a, const glm::ivec2& b) {
+			return Pathfinder2D::CanMoveBetween(registry, m_layer, a, b);
+			};
 
-			if (cur == target) {
-				reached = cur;
-				found = true;
+		while (m_searching && !m_queue.empty()) {
+			if (maxExpansions-- == 0) return;
+			++m_expansions;
+
+			const glm::ivec2 cur = m_queue.front();
+			m_queue.pop_front();
+
+			if (cur == m_target) {
+				m_found = true;
 				break;
 			}
 
 			for (auto d : DIRS) {
-				glm::ivec2 nxt = cur + d;
-				uint64_t key = HashKey(nxt);
+				const glm::ivec2 nxt = cur + d;
+				const uint64_t key = HashKey(nxt);
 
-				if (!withinRange(nxt)) continue;
-				if (visited.count(key)) continue;
-				if (!CanMoveBetween(registry, tilemapLayer, cur, nxt)) continue;
+				if (!WithinRange(nxt)) continue;
+				if (m_visited.count(key)) continue;
+				if (!canMove(cur, nxt)) continue;
 
-				visited.insert(key);
-				parent[key] = cur;
-				q.push(nxt);
+				m_visited.insert(key);
+				m_parent[key] = cur;
+				m_queue.push_back(nxt);
 			}
 		}
 
-		if (found) {
-			// Reconstruct BFS path
-			for (glm::ivec2 p = reached; ; p = parent[HashKey(p)]) {
-				out.fullPath.push_back(p);
-				if (p == start) break;
+		Finish(canMove);
+	}
+
+	void PathSearch::StepWeighted(entt::registry& registry, size_t maxExpansions) {
+		auto cost = MovementCostField::GetInstance().Acquire(registry, m_layer);
+		auto canMove = [&](const glm::ivec2& from, const glm::ivec2& to) {
+			if (cost(to) == MovementCostField::BLOCKED) return false;
+			const glm::ivec2 d = to - from;
+			// No corner cutting, same as CanMoveBetween
+			if (d.x != 0 && d.y != 0) {
+				if (cost({ from.x + d.x, from.y }) == MovementCostField::BLOCKED ||
+					cost({ from.x, from.y + d.y }) == MovementCostField::BLOCKED) {
+					return false;
+				}
 			}
-			std::reverse(out.fullPath.begin(), out.fullPath.end());
-		}
+			return true;
+			};
 
-		// ─── Greedy fallback if BFS failed ─────────────────────────────────────────
-		if (out.fullPath.empty()) {
-			glm::ivec2 cur = start;
-			out.fullPath.push_back(cur);
+		// Step cost is the destination tile's cost ×10 orthogonally, ×14 diagonally
+		const uint32_t targetIndex = m_searching ? IndexOf(m_target) : UINT32_MAX;
+		while (m_searching && !m_open.empty()) {
+			if (maxExpansions-- == 0) return;
+			++m_expansions;
 
-			// Keep stepping greedily toward target until stuck or reached
-			while (cur != target && int(out.fullPath.size()) <= maxRange) {
-				float bestDist = std::numeric_limits<float>::infinity();
-				glm::ivec2 bestNbr = cur;
+			std::pop_heap(m_open.begin(), m_open.end(), HeapLess);
+			const auto [f, curIndex] = m_open.back();
+			m_open.pop_back();
 
-				for (auto d : DIRS) {
-					glm::ivec2 cand = cur + d;
-					if (!withinRange(cand)) continue;
-					if (!CanMoveBetween(registry, tilemapLayer, cur, cand)) continue;
+			const glm::ivec2 cur = PosOf(curIndex);
+			const uint32_t g = m_gScore[curIndex];
+			if (f > g + Heuristic(cur)) continue; // stale entry
 
-					float dist2 = glm::distance2(glm::vec2(cand), glm::vec2(target));
-					if (dist2 < bestDist) {
-						bestDist = dist2;
-						bestNbr = cand;
-					}
-				}
+			if (curIndex == targetIndex) {
+				m_found = true;
+				break;
+			}
 
-				if (bestNbr == cur) {
-					// No neighbor improved—stop
-					break;
-				}
+			for (uint8_t dir = 0; dir < 8; ++dir) {
+				const glm::ivec2 nxt = cur + DIRS[dir];
+				if (!WithinRange(nxt)) continue;
+				if (!canMove(cur, nxt)) continue;
+
+				const uint32_t step = cost(nxt) * (dir < 4 ? 10u : 14u);
+				const uint32_t nIndex = IndexOf(nxt);
+				const uint32_t ng = g + step;
+				if (m_gScore[nIndex] <= ng) continue;
 
-				cur = bestNbr;
-				out.fullPath.push_back(cur);
-				if (cur == target) break;
+				m_gScore[nIndex] = ng;
+				m_cameFrom[nIndex] = dir;
+				m_open.push_back({ ng + Heuristic(nxt), nIndex });
+				std::push_heap(m_open.begin(), m_open.end(), HeapLess);
 			}
 		}
 
-		// ─── Extract turn‐point "checkpoints" ────────────────────────────────────
-		if (!out.fullPath.empty()) {
-			glm::ivec2 prevDir{ 0, 0 };
-			for (size_t i = 1; i < out.fullPath.size(); ++i) {
-				glm::ivec2 dir = out.fullPath[i] - out.fullPath[i - 1];
-				// Whenever direction changes, record the previous tile
-				if (dir.x != prevDir.x || dir.y != prevDir.y) {
-					out.checkpoints.push_back(out.fullPath[i - 1]);
-					prevDir = dir;
+		Finish(canMove);
+	}
+
+	template<typename CanMove>
+	void PathSearch::Finish(CanMove&& canMove) {
+		auto& path = m_result.fullPath;
+		if (m_found) {
+			if (m_weighted) {
+				for (glm::ivec2 p = m_target; ; p = p - DIRS[m_cameFrom[IndexOf(p)]]) {
+					path.push_back(p);
+					if (p == m_start) break;
 				}
 			}
-			// Always append the final destination
-			out.checkpoints.push_back(out.fullPath.back());
+			else {
+				for (glm::ivec2 p = m_target; ; p = m_parent[HashKey(p)]) {
+					path.push_back(p);
+					if (p == m_start) break;
+				}
+			}
+			std::reverse(path.begin(), path.end());
 		}
 
-		return out;
+		// ─── Greedy fallback if the search failed ────────────────────────────────
+		if (path.empty()) {
+			GreedyFallback(m_result, m_start, m_target, m_range, canMove,
+				[this](const glm::ivec2& p) { return WithinRange(p); });
+		}
+
+		// ─── Extract turn‐point "checkpoints" ────────────────────────────────────
+		ExtractCheckpoints(m_result);
+
+		m_done = true;
+		m_queue = {};
+		m_parent = {};
+		m_visited = {};
+		m_gScore = {};
+		m_cameFrom = {};
+		m_open = {};
 	}
 
 	// ─────────────────────────────────────────────────────────────────────────────
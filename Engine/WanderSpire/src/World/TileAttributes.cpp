@@ -0,0 +1,568 @@
+#include "WanderSpire/World/TileAttributes.h"
+#include "WanderSpire/World/TilemapSystem.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <spdlog/spdlog.h>
+
+namespace WanderSpire {
+
+	namespace {
+		uint64_t ChunkKey(const glm::ivec2& coords) {
+			return (static_cast<uint64_t>(static_cast<uint32_t>(coords.x)) << 32) | static_cast<uint32_t>(coords.y);
+		}
+
+		/// Visit each chunk overlapping an inclusive rectangle with the local part it covers
+		template <typename Fn>
+		void ForEachChunkInRect(int chunkSize, const glm::ivec2& min, const glm::ivec2& max, Fn&& fn) {
+			auto floorDiv = [chunkSize](int v) { return (v >= 0) ? v / chunkSize : -((-v + chunkSize - 1) / chunkSize); };
+			const glm::ivec2 c0{ floorDiv(min.x), floorDiv(min.y) };
+			const glm::ivec2 c1{ floorDiv(max.x), floorDiv(max.y) };
+
+			for (int cy = c0.y; cy <= c1.y; ++cy) {
+				for (int cx = c0.x; cx <= c1.x; ++cx) {
+					const glm::ivec2 origin{ cx * chunkSize, cy * chunkSize };
+					const glm::ivec2 lo = glm::max(min, origin) - origin;
+					const glm::ivec2 hi = glm::min(max, origin + glm::ivec2(chunkSize - 1)) - origin;
+					fn(glm::ivec2{ cx, cy }, lo, hi);
+				}
+			}
+		}
+
+		/// Call fn with a value of the channel's element type (bool for flags)
+		template <typename Fn>
+		decltype(auto) WithElementType(TileAttributeType type, Fn&& fn) {
+			switch (type) {
+			case TileAttributeType::U8:  return fn(uint8_t{});
+			case TileAttributeType::U16: return fn(uint16_t{});
+			case TileAttributeType::F32: return fn(float{});
+			default:                     return fn(bool{});
+			}
+		}
+
+		bool Compare(TileAttributeCompare compare, float a, float b) {
+			switch (compare) {
+			case TileAttributeCompare::Equal:        return a == b;
+			case TileAttributeCompare::NotEqual:     return a != b;
+			case TileAttributeCompare::Less:         return a < b;
+			case TileAttributeCompare::LessEqual:    return a <= b;
+			case TileAttributeCompare::Greater:      return a > b;
+			case TileAttributeCompare::GreaterEqual: return a >= b;
+			}
+			return false;
+		}
+
+		/// Set bits in [first, first + count) of a bit array
+		size_t CountBits(const uint64_t* words, int first, int count) {
+			size_t bits = 0;
+			while (count > 0) {
+				const int shift = first & 63;
+				const int take = std::min(count, 64 - shift);
+				const uint64_t mask = (take == 64 ? ~uint64_t(0) : ((uint64_t(1) << take) - 1)) << shift;
+				bits += static_cast<size_t>(std::popcount(words[first >> 6] & mask));
+				first += take;
+				count -= take;
+			}
+			return bits;
+		}
+
+		void FillBits(uint64_t* words, int first, int count, bool value) {
+			while (count > 0) {
+				const int shift = first & 63;
+				const int take = std::min(count, 64 - shift);
+				const uint64_t mask = (take == 64 ? ~uint64_t(0) : ((uint64_t(1) << take) - 1)) << shift;
+				if (value) words[first >> 6] |= mask;
+				else words[first >> 6] &= ~mask;
+				first += take;
+				count -= take;
+			}
+		}
+
+		// Row kernels: straight loops over one contiguous run of a block, so the
+		// compiler can vectorize them
+
+		template <typename T>
+		void AccumulateRow(const T* row, int count, TileAttributeStats& stats) {
+			using Sum = std::conditional_t<std::is_floating_point_v<T>, double, uint64_t>;
+			T lo = row[0];
+			T hi = row[0];
+			Sum sum = 0;
+			for (int i = 0; i < count; ++i) {
+				lo = std::min(lo, row[i]);
+				hi = std::max(hi, row[i]);
+				sum += row[i];
+			}
+			stats.min = std::min(stats.min, static_cast<float>(lo));
+			stats.max = std::max(stats.max, static_cast<float>(hi));
+			stats.sum += static_cast<double>(sum);
+		}
+
+		template <typename T, typename Op>
+		size_t CountRow(const T* row, int count, T value, Op op) {
+			size_t matches = 0;
+			for (int i = 0; i < count; ++i) matches += op(row[i], value) ? 1 : 0;
+			return matches;
+		}
+
+		template <typename T>
+		size_t CountRow(const T* row, int count, TileAttributeCompare compare, float value) {
+			// Integer channels compare exactly against the threshold rounded into their domain
+			if constexpr (std::is_integral_v<T>) {
+				constexpr float top = static_cast<float>(std::numeric_limits<T>::max());
+				switch (compare) {
+				case TileAttributeCompare::Equal:
+				case TileAttributeCompare::NotEqual: {
+					const bool representable = value >= 0.0f && value <= top && std::floor(value) == value;
+					const size_t equal = representable ? CountRow(row, count, static_cast<T>(value), std::equal_to<T>{}) : 0;
+					return compare == TileAttributeCompare::Equal ? equal : static_cast<size_t>(count) - equal;
+				}
+				case TileAttributeCompare::Less:
+				case TileAttributeCompare::GreaterEqual: {
+					// x < v  ⇔  x < ceil(v)
+					const float t = std::ceil(value);
+					const size_t less = t <= 0.0f ? 0 : t > top ? static_cast<size_t>(count)
+						: CountRow(row, count, static_cast<T>(t), std::less<T>{});
+					return compare == TileAttributeCompare::Less ? less : static_cast<size_t>(count) - less;
+				}
+				case TileAttributeCompare::LessEqual:
+				case TileAttributeCompare::Greater: {
+					// x <= v  ⇔  x <= floor(v)
+					const float t = std::floor(value);
+					const size_t lessEqual = t < 0.0f ? 0 : t >= top ? static_cast<size_t>(count)
+						: CountRow(row, count, static_cast<T>(t), std::less_equal<T>{});
+					return compare == TileAttributeCompare::LessEqual ? lessEqual : static_cast<size_t>(count) - lessEqual;
+				}
+				}
+				return 0;
+			}
+			else {
+				switch (compare) {
+				case TileAttributeCompare::Equal:        return CountRow(row, count, value, std::equal_to<float>{});
+				case TileAttributeCompare::NotEqual:     return CountRow(row, count, value, std::not_equal_to<float>{});
+				case TileAttributeCompare::Less:         return CountRow(row, count, value, std::less<float>{});
+				case TileAttributeCompare::LessEqual:    return CountRow(row, count, value, std::less_equal<float>{});
+				case TileAttributeCompare::Greater:      return CountRow(row, count, value, std::greater<float>{});
+				case TileAttributeCompare::GreaterEqual: return CountRow(row, count, value, std::greater_equal<float>{});
+				}
+				return 0;
+			}
+		}
+	}
+
+	TileAttributes& TileAttributes::GetInstance() {
+		static TileAttributes instance;
+		return instance;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Channels
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	int TileAttributes::CreateChannel(entt::registry& registry, entt::entity tilemapLayer, const std::string& name,
+		TileAttributeType type, float defaultValue)
+	{
+		if (!registry.valid(tilemapLayer) || name.empty()) return -1;
+
+		auto* attributes = registry.try_get<TileAttributeComponent>(tilemapLayer);
+		if (!attributes) {
+			attributes = &registry.emplace<TileAttributeComponent>(tilemapLayer);
+			attributes->chunkSize = TilemapSystem::GetInstance().GetChunkSize();
+		}
+
+		if (const int existing = FindChannel(registry, tilemapLayer, name); existing >= 0) {
+			const auto& current = attributes->channels[existing & ((1 << SLOT_BITS) - 1)];
+			if (current.type == type) return existing;
+			spdlog::warn("[TileAttributes] Channel '{}' already exists with type {}", name,
+				TileAttributeComponent::TypeName(current.type));
+			return -1;
+		}
+
+		TileAttributeChannel channel;
+		channel.name = name;
+		channel.type = type;
+		channel.defaultValue = TileAttributeChannel::Quantize(type, defaultValue);
+
+		// Reuse a removed channel's slot under its new generation
+		auto& channels = attributes->channels;
+		auto free = std::find_if(channels.begin(), channels.end(), [](const auto& c) { return c.name.empty(); });
+		if (free != channels.end()) {
+			channel.generation = free->generation;
+			*free = std::move(channel);
+			return MakeChannelId(static_cast<size_t>(free - channels.begin()), free->generation);
+		}
+		if (channels.size() >= (size_t(1) << SLOT_BITS)) {
+			spdlog::warn("[TileAttributes] Layer has no room for channel '{}'", name);
+			return -1;
+		}
+		channels.push_back(std::move(channel));
+		return MakeChannelId(channels.size() - 1, 0);
+	}
+
+	int TileAttributes::FindChannel(entt::registry& registry, entt::entity tilemapLayer, const std::string& name) const {
+		const auto* attributes = registry.valid(tilemapLayer) ? registry.try_get<TileAttributeComponent>(tilemapLayer) : nullptr;
+		if (!attributes || name.empty()) return -1;
+		for (size_t i = 0; i < attributes->channels.size(); ++i) {
+			if (attributes->channels[i].name == name) return MakeChannelId(i, attributes->channels[i].generation);
+		}
+		return -1;
+	}
+
+	bool TileAttributes::RemoveChannel(entt::registry& registry, entt::entity tilemapLayer, int channel) {
+		auto* data = FindChannelData(registry, tilemapLayer, channel);
+		if (!data) return false;
+		const uint16_t generation = static_cast<uint16_t>((data->generation + 1) & GENERATION_MASK);
+		*data = TileAttributeChannel{};
+		data->generation = generation;
+		return true;
+	}
+
+	bool TileAttributes::GetChannelType(entt::registry& registry, entt::entity tilemapLayer, int channel,
+		TileAttributeType& outType) const
+	{
+		const auto* data = FindChannelData(registry, tilemapLayer, channel);
+		if (!data) return false;
+		outType = data->type;
+		return true;
+	}
+
+	const TileAttributeChannel* TileAttributes::FindChannelData(entt::registry& registry, entt::entity tilemapLayer,
+		int channel, int* outChunkSize) const
+	{
+		const auto* attributes = registry.valid(tilemapLayer) ? registry.try_get<TileAttributeComponent>(tilemapLayer) : nullptr;
+		if (!attributes || channel < 0) return nullptr;
+		const size_t slot = static_cast<size_t>(channel) & ((size_t(1) << SLOT_BITS) - 1);
+		if (slot >= attributes->channels.size()) return nullptr;
+		const auto& data = attributes->channels[slot];
+		if (data.name.empty() || MakeChannelId(slot, data.generation) != channel || attributes->chunkSize <= 0) return nullptr;
+		if (outChunkSize) *outChunkSize = attributes->chunkSize;
+		return &data;
+	}
+
+	TileAttributeChannel* TileAttributes::FindChannelData(entt::registry& registry, entt::entity tilemapLayer,
+		int channel, int* outChunkSize)
+	{
+		return const_cast<TileAttributeChannel*>(std::as_const(*this).FindChannelData(registry, tilemapLayer, channel, outChunkSize));
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Values
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	float TileAttributes::Get(entt::registry& registry, entt::entity tilemapLayer, int channel,
+		const glm::ivec2& position) const
+	{
+		float value = 0.0f;
+		ReadRect(registry, tilemapLayer, channel, position, position, &value);
+		return value;
+	}
+
+	void TileAttributes::Set(entt::registry& registry, entt::entity tilemapLayer, int channel,
+		const glm::ivec2& position, float value)
+	{
+		WriteRect(registry, tilemapLayer, channel, position, position, &value);
+	}
+
+	void TileAttributes::FillRect(entt::registry& registry, entt::entity tilemapLayer, int channel,
+		const glm::ivec2& min, const glm::ivec2& max, float value)
+	{
+		int chunkSize = 0;
+		auto* data = FindChannelData(registry, tilemapLayer, channel, &chunkSize);
+		if (!data || max.x < min.x || max.y < min.y) return;
+
+		const float stored = TileAttributeChannel::Quantize(data->type, value);
+		const bool isDefault = stored == data->defaultValue;
+		const int tileCount = chunkSize * chunkSize;
+
+		ForEachChunkInRect(chunkSize, min, max, [&](const glm::ivec2& coords, const glm::ivec2& lo, const glm::ivec2& hi) {
+			const uint64_t key = ChunkKey(coords);
+			auto it = data->blocks.find(key);
+			const bool whole = lo == glm::ivec2(0) && hi == glm::ivec2(chunkSize - 1);
+			if (isDefault && (whole || it == data->blocks.end())) {
+				// Back to the default everywhere: drop the block
+				if (it != data->blocks.end()) data->blocks.erase(it);
+				return;
+			}
+			if (it == data->blocks.end()) it = data->blocks.emplace(key, data->MakeBlock(tileCount)).first;
+
+			uint64_t* block = it->second.data();
+			const int rowLength = hi.x - lo.x + 1;
+			WithElementType(data->type, [&](auto element) {
+				using T = decltype(element);
+				for (int y = lo.y; y <= hi.y; ++y) {
+					const int first = y * chunkSize + lo.x;
+					if constexpr (std::is_same_v<T, bool>) FillBits(block, first, rowLength, stored != 0.0f);
+					else std::fill_n(reinterpret_cast<T*>(block) + first, rowLength, static_cast<T>(stored));
+				}
+				});
+			});
+	}
+
+	void TileAttributes::ReadRect(entt::registry& registry, entt::entity tilemapLayer, int channel,
+		const glm::ivec2& min, const glm::ivec2& max, float* outValues) const
+	{
+		int chunkSize = 0;
+		const auto* data = FindChannelData(registry, tilemapLayer, channel, &chunkSize);
+		if (!outValues || max.x < min.x || max.y < min.y) return;
+		const int width = max.x - min.x + 1;
+		if (!data) {
+			std::fill_n(outValues, static_cast<size_t>(width) * (max.y - min.y + 1), 0.0f);
+			return;
+		}
+
+		ForEachChunkInRect(chunkSize, min, max, [&](const glm::ivec2& coords, const glm::ivec2& lo, const glm::ivec2& hi) {
+			const glm::ivec2 origin = coords * chunkSize;
+			auto it = data->blocks.find(ChunkKey(coords));
+			const uint64_t* block = it != data->blocks.end() ? it->second.data() : nullptr;
+			for (int y = lo.y; y <= hi.y; ++y) {
+				float* dst = outValues + static_cast<size_t>(origin.y + y - min.y) * width + (origin.x + lo.x - min.x);
+				for (int x = lo.x; x <= hi.x; ++x) {
+					*dst++ = block ? TileAttributeChannel::Load(block, data->type, y * chunkSize + x) : data->defaultValue;
+				}
+			}
+			});
+	}
+
+	void TileAttributes::WriteRect(entt::registry& registry, entt::entity tilemapLayer, int channel,
+		const glm::ivec2& min, const glm::ivec2& max, const float* values)
+	{
+		int chunkSize = 0;
+		auto* data = FindChannelData(registry, tilemapLayer, channel, &chunkSize);
+		if (!data || !values || max.x < min.x || max.y < min.y) return;
+		const int width = max.x - min.x + 1;
+		const int tileCount = chunkSize * chunkSize;
+
+		ForEachChunkInRect(chunkSize, min, max, [&](const glm::ivec2& coords, const glm::ivec2& lo, const glm::ivec2& hi) {
+			const glm::ivec2 origin = coords * chunkSize;
+			auto source = [&](int x, int y) {
+				return values[static_cast<size_t>(origin.y + y - min.y) * width + (origin.x + x - min.x)];
+			};
+
+			const uint64_t key = ChunkKey(coords);
+			auto it = data->blocks.find(key);
+			if (it == data->blocks.end()) {
+				// Only a non-default value allocates the chunk's block
+				bool needed = false;
+				for (int y = lo.y; y <= hi.y && !needed; ++y)
+					for (int x = lo.x; x <= hi.x && !needed; ++x)
+						needed = TileAttributeChannel::Quantize(data->type, source(x, y)) != data->defaultValue;
+				if (!needed) return;
+				it = data->blocks.emplace(key, data->MakeBlock(tileCount)).first;
+			}
+
+			uint64_t* block = it->second.data();
+			for (int y = lo.y; y <= hi.y; ++y)
+				for (int x = lo.x; x <= hi.x; ++x)
+					TileAttributeChannel::Store(block, data->type, y * chunkSize + x, source(x, y));
+			});
+	}
+
+	bool TileAttributes::ReadRectRaw(entt::registry& registry, entt::entity tilemapLayer, int channel,
+		const glm::ivec2& min, const glm::ivec2& max, void* outValues) const
+	{
+		int chunkSize = 0;
+		const auto* data = FindChannelData(registry, tilemapLayer, channel, &chunkSize);
+		if (!data || !outValues || max.x < min.x || max.y < min.y) return false;
+		const int width = max.x - min.x + 1;
+
+		WithElementType(data->type, [&](auto element) {
+			using T = decltype(element);
+			using Out = std::conditional_t<std::is_same_v<T, bool>, uint8_t, T>;
+			auto* out = static_cast<Out*>(outValues);
+			const Out fallback = static_cast<Out>(data->defaultValue);
+
+			ForEachChunkInRect(chunkSize, min, max, [&](const glm::ivec2& coords, const glm::ivec2& lo, const glm::ivec2& hi) {
+				const glm::ivec2 origin = coords * chunkSize;
+				auto it = data->blocks.find(ChunkKey(coords));
+				const uint64_t* block = it != data->blocks.end() ? it->second.data() : nullptr;
+				const int rowLength = hi.x - lo.x + 1;
+				for (int y = lo.y; y <= hi.y; ++y) {
+					Out* dst = out + static_cast<size_t>(origin.y + y - min.y) * width + (origin.x + lo.x - min.x);
+					const int first = y * chunkSize + lo.x;
+					if (!block) std::fill_n(dst, rowLength, fallback);
+					else if constexpr (std::is_same_v<T, bool>) {
+						for (int i = 0; i < rowLength; ++i) dst[i] = static_cast<uint8_t>((block[(first + i) >> 6] >> ((first + i) & 63)) & 1u);
+					}
+					else std::memcpy(dst, reinterpret_cast<const T*>(block) + first, sizeof(T) * rowLength);
+				}
+				});
+			});
+		return true;
+	}
+
+	bool TileAttributes::WriteRectRaw(entt::registry& registry, entt::entity tilemapLayer, int channel,
+		const glm::ivec2& min, const glm::ivec2& max, const void* values)
+	{
+		int chunkSize = 0;
+		auto* data = FindChannelData(registry, tilemapLayer, channel, &chunkSize);
+		if (!data || !values || max.x < min.x || max.y < min.y) return false;
+		const int width = max.x - min.x + 1;
+		const int tileCount = chunkSize * chunkSize;
+
+		WithElementType(data->type, [&](auto element) {
+			using T = decltype(element);
+			using In = std::conditional_t<std::is_same_v<T, bool>, uint8_t, T>;
+			const auto* in = static_cast<const In*>(values);
+			const In fallback = static_cast<In>(data->defaultValue);
+
+			ForEachChunkInRect(chunkSize, min, max, [&](const glm::ivec2& coords, const glm::ivec2& lo, const glm::ivec2& hi) {
+				const glm::ivec2 origin = coords * chunkSize;
+				const int rowLength = hi.x - lo.x + 1;
+				auto row = [&](int y) {
+					return in + static_cast<size_t>(origin.y + y - min.y) * width + (origin.x + lo.x - min.x);
+				};
+
+				const uint64_t key = ChunkKey(coords);
+				auto it = data->blocks.find(key);
+				if (it == data->blocks.end()) {
+					bool needed = false;
+					for (int y = lo.y; y <= hi.y && !needed; ++y) {
+						const In* src = row(y);
+						if constexpr (std::is_same_v<T, bool>)
+							needed = std::any_of(src, src + rowLength, [&](In v) { return (v != 0) != (fallback != 0); });
+						else
+							needed = std::any_of(src, src + rowLength, [&](In v) { return v != fallback; });
+					}
+					if (!needed) return;
+					it = data->blocks.emplace(key, data->MakeBlock(tileCount)).first;
+				}
+
+				uint64_t* block = it->second.data();
+				for (int y = lo.y; y <= hi.y; ++y) {
+					const In* src = row(y);
+					const int first = y * chunkSize + lo.x;
+					if constexpr (std::is_same_v<T, bool>) {
+						for (int i = 0; i < rowLength; ++i) FillBits(block, first + i, 1, src[i] != 0);
+					}
+					else std::memcpy(reinterpret_cast<T*>(block) + first, src, sizeof(T) * rowLength);
+				}
+				});
+			});
+		return true;
+	}
+
+	void* TileAttributes::GetChunkBlock(entt::registry& registry, entt::entity tilemapLayer, int channel,
+		const glm::ivec2& chunkCoords, bool allocate)
+	{
+		int chunkSize = 0;
+		auto* data = FindChannelData(registry, tilemapLayer, channel, &chunkSize);
+		if (!data) return nullptr;
+
+		const uint64_t key = ChunkKey(chunkCoords);
+		auto it = data->blocks.find(key);
+		if (it == data->blocks.end()) {
+			if (!allocate) return nullptr;
+			it = data->blocks.emplace(key, data->MakeBlock(chunkSize * chunkSize)).first;
+		}
+		return it->second.data();
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Region queries
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	TileAttributeStats TileAttributes::QueryRect(entt::registry& registry, entt::entity tilemapLayer, int channel,
+		const glm::ivec2& min, const glm::ivec2& max) const
+	{
+		TileAttributeStats stats;
+		int chunkSize = 0;
+		const auto* data = FindChannelData(registry, tilemapLayer, channel, &chunkSize);
+		if (!data || max.x < min.x || max.y < min.y) return stats;
+
+		stats.min = std::numeric_limits<float>::max();
+		stats.max = std::numeric_limits<float>::lowest();
+
+		WithElementType(data->type, [&](auto element) {
+			using T = decltype(element);
+			ForEachChunkInRect(chunkSize, min, max, [&](const glm::ivec2& coords, const glm::ivec2& lo, const glm::ivec2& hi) {
+				const int rowLength = hi.x - lo.x + 1;
+				const size_t tiles = static_cast<size_t>(rowLength) * (hi.y - lo.y + 1);
+				stats.count += tiles;
+
+				auto it = data->blocks.find(ChunkKey(coords));
+				if (it == data->blocks.end()) {
+					stats.min = std::min(stats.min, data->defaultValue);
+					stats.max = std::max(stats.max, data->defaultValue);
+					stats.sum += static_cast<double>(data->defaultValue) * static_cast<double>(tiles);
+					return;
+				}
+
+				const uint64_t* block = it->second.data();
+				if constexpr (std::is_same_v<T, bool>) {
+					size_t set = 0;
+					for (int y = lo.y; y <= hi.y; ++y) set += CountBits(block, y * chunkSize + lo.x, rowLength);
+					if (set < tiles) stats.min = std::min(stats.min, 0.0f);
+					if (set > 0) stats.max = std::max(stats.max, 1.0f);
+					if (set == 0) stats.max = std::max(stats.max, 0.0f);
+					if (set == tiles) stats.min = std::min(stats.min, 1.0f);
+					stats.sum += static_cast<double>(set);
+				}
+				else {
+					const T* values = reinterpret_cast<const T*>(block);
+					for (int y = lo.y; y <= hi.y; ++y) AccumulateRow(values + y * chunkSize + lo.x, rowLength, stats);
+				}
+				});
+			});
+		return stats;
+	}
+
+	size_t TileAttributes::CountWhere(entt::registry& registry, entt::entity tilemapLayer, int channel,
+		const glm::ivec2& min, const glm::ivec2& max, TileAttributeCompare compare, float value) const
+	{
+		int chunkSize = 0;
+		const auto* data = FindChannelData(registry, tilemapLayer, channel, &chunkSize);
+		if (!data || max.x < min.x || max.y < min.y) return 0;
+
+		size_t matches = 0;
+		const bool defaultMatches = Compare(compare, data->defaultValue, value);
+
+		WithElementType(data->type, [&](auto element) {
+			using T = decltype(element);
+			ForEachChunkInRect(chunkSize, min, max, [&](const glm::ivec2& coords, const glm::ivec2& lo, const glm::ivec2& hi) {
+				const int rowLength = hi.x - lo.x + 1;
+				const size_t tiles = static_cast<size_t>(rowLength) * (hi.y - lo.y + 1);
+
+				auto it = data->blocks.find(ChunkKey(coords));
+				if (it == data->blocks.end()) {
+					if (defaultMatches) matches += tiles;
+					return;
+				}
+
+				const uint64_t* block = it->second.data();
+				if constexpr (std::is_same_v<T, bool>) {
+					size_t set = 0;
+					for (int y = lo.y; y <= hi.y; ++y) set += CountBits(block, y * chunkSize + lo.x, rowLength);
+					if (Compare(compare, 1.0f, value)) matches += set;
+					if (Compare(compare, 0.0f, value)) matches += tiles - set;
+				}
+				else {
+					const T* values = reinterpret_cast<const T*>(block);
+					for (int y = lo.y; y <= hi.y; ++y)
+						matches += CountRow(values + y * chunkSize + lo.x, rowLength, compare, value);
+				}
+				});
+			});
+		return matches;
+	}
+
+	size_t TileAttributes::GetBlockCount(entt::registry& registry, entt::entity tilemapLayer, int channel) const {
+		const auto* data = FindChannelData(registry, tilemapLayer, channel);
+		return data ? data->blocks.size() : 0;
+	}
+
+	size_t TileAttributes::GetMemoryBytes(entt::registry& registry, entt::entity tilemapLayer) const {
+		const auto* attributes = registry.valid(tilemapLayer) ? registry.try_get<TileAttributeComponent>(tilemapLayer) : nullptr;
+		if (!attributes) return 0;
+		size_t bytes = 0;
+		for (const auto& channel : attributes->channels) {
+			for (const auto& [key, block] : channel.blocks) bytes += block.capacity() * sizeof(uint64_t);
+		}
+		return bytes;
+	}
+
+} // namespace WanderSpire
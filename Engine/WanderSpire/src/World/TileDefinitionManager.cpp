@@ -5,6 +5,7 @@
 
 #include <spdlog/spdlog.h>
 #include <shared_mutex>
+#include <algorithm>
 
 namespace WanderSpire {
 
@@ -23,7 +24,14 @@ namespace WanderSpire {
 		def.walkable = walkable;
 		def.collisionType = collisionType;
 
+		// Re-registering keeps visibility and cost settings made earlier
+		if (auto it = m_definitions.find(tileId); it != m_definitions.end()) {
+			def.blocksVision = it->second.blocksVision;
+			def.movementCost = it->second.movementCost;
+		}
+
 		m_definitions[tileId] = std::move(def);
+		++m_revision;
 
 		spdlog::debug("[TileDefinitionManager] Registered tile {} -> {}:{}",
 			tileId, atlasName, frameName);
@@ -44,6 +52,7 @@ namespace WanderSpire {
 	void TileDefinitionManager::Clear() {
 		std::unique_lock lock(m_mutex);
 		m_definitions.clear();
+		++m_revision;
 		spdlog::info("[TileDefinitionManager] Cleared all tile definitions");
 	}
 
@@ -84,6 +93,7 @@ namespace WanderSpire {
 
 			m_definitions[tileEntry.tileId] = std::move(def);
 		}
+		++m_revision;
 
 		spdlog::info("[TileDefinitionManager] Loaded {} tile definitions from palette '{}'",
 			palette.tiles.size(), palette.name);
@@ -93,11 +103,52 @@ namespace WanderSpire {
 		std::unique_lock lock(m_mutex);
 		m_defaultDefinition.atlasName = atlasName;
 		m_defaultDefinition.frameName = frameName;
+		++m_revision;
 
 		spdlog::info("[TileDefinitionManager] Set default tile definition to {}:{}",
 			atlasName, frameName);
 	}
 
+	void TileDefinitionManager::SetTileBlocksVision(int tileId, bool blocksVision) {
+		std::unique_lock lock(m_mutex);
+
+		auto it = m_definitions.find(tileId);
+		if (it == m_definitions.end()) {
+			spdlog::warn("[TileDefinitionManager] Cannot set vision flag on unregistered tile {}", tileId);
+			return;
+		}
+
+		it->second.blocksVision = blocksVision;
+		++m_revision;
+	}
+
+	void TileDefinitionManager::SetTileMovementCost(int tileId, uint8_t movementCost) {
+		std::unique_lock lock(m_mutex);
+
+		auto it = m_definitions.find(tileId);
+		if (it == m_definitions.end()) {
+			spdlog::warn("[TileDefinitionManager] Cannot set movement cost on unregistered tile {}", tileId);
+			return;
+		}
+
+		// 0 is reserved for "impassable"; use walkable = false for that
+		it->second.movementCost = std::max<uint8_t>(movementCost, 1);
+		++m_revision;
+	}
+
+	uint8_t TileDefinitionManager::GetMovementCost(int tileId) const {
+		std::shared_lock lock(m_mutex);
+
+		auto it = m_definitions.find(tileId);
+		const TileDefinition& def = (it != m_definitions.end()) ? it->second : m_defaultDefinition;
+		return def.walkable ? def.movementCost : 0;
+	}
+
+	uint64_t TileDefinitionManager::GetRevision() const {
+		std::shared_lock lock(m_mutex);
+		return m_revision;
+	}
+
 	size_t TileDefinitionManager::GetTileCount() const {
 		std::shared_lock lock(m_mutex);
 		return m_definitions.size();
@@ -0,0 +1,166 @@
+#include "WanderSpire/World/TilemapChangeJournal.h"
+#include "WanderSpire/ECS/RegistryIdentity.h"
+
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+namespace WanderSpire {
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Lifetime
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	TilemapChangeJournal& TilemapChangeJournal::GetInstance() {
+		static TilemapChangeJournal instance;
+		return instance;
+	}
+
+	void TilemapChangeJournal::Clear() {
+		std::lock_guard lock(m_mutex);
+		m_registries.clear();
+	}
+
+	void TilemapChangeJournal::SetCapacity(size_t records) {
+		std::lock_guard lock(m_mutex);
+		m_capacity = std::max<size_t>(1, records);
+		for (auto& [registry, state] : m_registries) Resize(state);
+	}
+
+	size_t TilemapChangeJournal::GetCapacity() const {
+		std::lock_guard lock(m_mutex);
+		return m_capacity;
+	}
+
+	TilemapChangeJournal::RegistryState& TilemapChangeJournal::StateFor(entt::registry& registry) {
+		auto it = m_registries.find(&registry);
+		if (it != m_registries.end() && !IsRegistryMarked<TilemapChangeJournal>(registry)) {
+			m_registries.erase(it);
+			it = m_registries.end();
+		}
+		if (it == m_registries.end()) {
+			MarkRegistry<TilemapChangeJournal>(registry);
+			it = m_registries.emplace(&registry, RegistryState{}).first;
+			it->second.ring.resize(m_capacity);
+		}
+		return it->second;
+	}
+
+	void TilemapChangeJournal::Resize(RegistryState& state) {
+		if (state.ring.size() == m_capacity) return;
+
+		// Re-slot the newest records that still fit
+		const uint64_t keep = std::min<uint64_t>(state.count, m_capacity);
+		std::vector<TileChangeRecord> ring(m_capacity);
+		for (uint64_t s = state.nextSequence - keep; s < state.nextSequence; ++s) {
+			ring[s % m_capacity] = state.ring[s % state.ring.size()];
+		}
+		state.ring = std::move(ring);
+		state.count = keep;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Writing
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	uint64_t TilemapChangeJournal::Record(entt::registry& registry, entt::entity tilemapLayer,
+		const glm::ivec2& chunkCoords, const glm::ivec2& min, const glm::ivec2& max, bool removed)
+	{
+		std::lock_guard lock(m_mutex);
+		auto& state = StateFor(registry);
+		const uint64_t version = state.nextVersion++;
+		const size_t capacity = state.ring.size();
+
+		// Fold into the newest record while no reader has seen it
+		if (state.count > 0 && !removed) {
+			const uint64_t last = state.nextSequence - 1;
+			TileChangeRecord& newest = state.ring[last % capacity];
+			if (last > state.handedOut && !newest.removed &&
+				newest.layer == tilemapLayer && newest.chunkCoords == chunkCoords) {
+				newest.min = glm::min(newest.min, min);
+				newest.max = glm::max(newest.max, max);
+				newest.chunkVersion = version;
+				return version;
+			}
+		}
+
+		TileChangeRecord& record = state.ring[state.nextSequence % capacity];
+		record.sequence = state.nextSequence++;
+		record.layer = tilemapLayer;
+		record.chunkCoords = chunkCoords;
+		record.chunkVersion = version;
+		record.min = min;
+		record.max = max;
+		record.removed = removed;
+		state.count = std::min<uint64_t>(state.count + 1, capacity);
+		return version;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Reading
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	uint64_t TilemapChangeJournal::GetHead(entt::registry& registry) {
+		std::lock_guard lock(m_mutex);
+		auto& state = StateFor(registry);
+		// A cursor taken here must not miss edits merged into the newest record
+		state.handedOut = state.nextSequence - 1;
+		return state.nextSequence;
+	}
+
+	bool TilemapChangeJournal::Read(RegistryState& state, uint64_t& cursor,
+		std::vector<TileChangeRecord>& out, size_t maxRecords)
+	{
+		const uint64_t oldest = state.nextSequence - state.count;
+		bool complete = true;
+		if (cursor < oldest) {
+			complete = false;
+			cursor = oldest;
+		}
+
+		const size_t capacity = state.ring.size();
+		size_t copied = 0;
+		while (cursor < state.nextSequence && copied < maxRecords) {
+			out.push_back(state.ring[cursor % capacity]);
+			++cursor;
+			++copied;
+		}
+		if (copied) state.handedOut = std::max(state.handedOut, cursor - 1);
+		return complete;
+	}
+
+	bool TilemapChangeJournal::ReadSince(entt::registry& registry, uint64_t& cursor,
+		std::vector<TileChangeRecord>& out, size_t maxRecords)
+	{
+		std::lock_guard lock(m_mutex);
+		return Read(StateFor(registry), cursor, out, maxRecords);
+	}
+
+	TilemapChangeJournal::SubscriberId TilemapChangeJournal::Subscribe(entt::registry& registry) {
+		std::lock_guard lock(m_mutex);
+		auto& state = StateFor(registry);
+		SubscriberId id = state.nextSubscriber++;
+		if (id == INVALID_SUBSCRIBER) id = state.nextSubscriber++;
+		state.cursors[id] = state.nextSequence;
+		state.handedOut = state.nextSequence - 1;
+		return id;
+	}
+
+	void TilemapChangeJournal::Unsubscribe(entt::registry& registry, SubscriberId id) {
+		std::lock_guard lock(m_mutex);
+		StateFor(registry).cursors.erase(id);
+	}
+
+	bool TilemapChangeJournal::Poll(entt::registry& registry, SubscriberId id,
+		std::vector<TileChangeRecord>& out, size_t maxRecords)
+	{
+		std::lock_guard lock(m_mutex);
+		auto& state = StateFor(registry);
+		auto it = state.cursors.find(id);
+		if (it == state.cursors.end()) {
+			spdlog::warn("[TilemapChangeJournal] Poll on unknown subscriber {}", id);
+			return false;
+		}
+		return Read(state, it->second, out, maxRecords);
+	}
+
+} // namespace WanderSpire
@@ -0,0 +1,343 @@
+#include "WanderSpire/World/TilemapFile.h"
+#include "WanderSpire/Components/TilemapChunkComponent.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <spdlog/spdlog.h>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace WanderSpire {
+
+	static_assert(std::endian::native == std::endian::little, "Tilemap files are read in place and stored little endian");
+
+	using namespace TilemapFileFormat;
+
+	namespace {
+		uint64_t ChunkKey(int32_t x, int32_t y) {
+			return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+		}
+
+		uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+
+		uint64_t PayloadBytes(const ChunkEntry& entry) {
+			const uint64_t ids = static_cast<uint64_t>(entry.tileCount) * sizeof(int32_t);
+			return entry.flags & CHUNK_HAS_DATA ? ids * 2 : ids;
+		}
+
+		uint32_t HeaderCrc(const Header& header) {
+			return Crc32(&header, offsetof(Header, headerCrc));
+		}
+	}
+
+	uint32_t TilemapFileFormat::Crc32(const void* data, size_t size, uint32_t crc) {
+		static const auto table = [] {
+			std::array<uint32_t, 256> t{};
+			for (uint32_t i = 0; i < 256; ++i) {
+				uint32_t c = i;
+				for (int k = 0; k < 8; ++k) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+				t[i] = c;
+			}
+			return t;
+		}();
+
+		const auto* bytes = static_cast<const uint8_t*>(data);
+		crc = ~crc;
+		for (size_t i = 0; i < size; ++i) crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+		return ~crc;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Writer
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	TilemapFileWriter::~TilemapFileWriter() {
+		if (m_file.is_open()) {
+			spdlog::warn("[TilemapFile] '{}' was never finished and is not a valid tilemap file", m_path);
+		}
+	}
+
+	bool TilemapFileWriter::Fail(const char* what) {
+		spdlog::error("[TilemapFile] Failed to {} '{}'", what, m_path);
+		m_file.close();
+		m_directory.clear();
+		m_written.clear();
+		return false;
+	}
+
+	bool TilemapFileWriter::Open(const std::string& path, int chunkSize, uint32_t alignment) {
+		if (m_file.is_open()) m_file.close();
+		m_path = path;
+		m_directory.clear();
+		m_written.clear();
+
+		if (chunkSize <= 0 || alignment < MIN_ALIGNMENT || !std::has_single_bit(alignment)) {
+			spdlog::error("[TilemapFile] Invalid chunk size {} or alignment {} for '{}'", chunkSize, alignment, path);
+			return false;
+		}
+		m_chunkSize = chunkSize;
+		m_alignment = alignment;
+
+		m_file.open(path, std::ios::binary | std::ios::trunc);
+		if (!m_file) return Fail("create");
+
+		// Placeholder until Finish(): an all-zero header fails the magic check
+		const Header blank{};
+		m_file.write(reinterpret_cast<const char*>(&blank), sizeof(blank));
+		m_offset = sizeof(blank);
+		return m_file.good() || Fail("write");
+	}
+
+	bool TilemapFileWriter::WriteChunk(const glm::ivec2& chunkCoords, const int* tileIds, const uint32_t* tileData,
+		int tileCount)
+	{
+		if (!m_file.is_open() || !tileIds || tileCount <= 0) return false;
+		if (!m_written.emplace(ChunkKey(chunkCoords.x, chunkCoords.y), m_directory.size()).second) {
+			spdlog::warn("[TilemapFile] Chunk ({}, {}) written twice to '{}'; keeping the first",
+				chunkCoords.x, chunkCoords.y, m_path);
+			return false;
+		}
+
+		static const char zeros[256] = {};
+		for (uint64_t pad = AlignUp(m_offset, m_alignment) - m_offset; pad > 0;) {
+			const auto n = static_cast<std::streamsize>(std::min<uint64_t>(pad, sizeof(zeros)));
+			m_file.write(zeros, n);
+			pad -= n;
+			m_offset += n;
+		}
+
+		ChunkEntry entry{};
+		entry.x = chunkCoords.x;
+		entry.y = chunkCoords.y;
+		entry.offset = m_offset;
+		entry.tileCount = static_cast<uint32_t>(tileCount);
+
+		const size_t bytes = static_cast<size_t>(tileCount) * sizeof(int32_t);
+		m_file.write(reinterpret_cast<const char*>(tileIds), static_cast<std::streamsize>(bytes));
+		entry.crc = Crc32(tileIds, bytes);
+
+		if (tileData && std::any_of(tileData, tileData + tileCount, [](uint32_t d) { return d != 0; })) {
+			m_file.write(reinterpret_cast<const char*>(tileData), static_cast<std::streamsize>(bytes));
+			entry.crc = Crc32(tileData, bytes, entry.crc);
+			entry.flags |= CHUNK_HAS_DATA;
+		}
+
+		m_offset += PayloadBytes(entry);
+		m_directory.push_back(entry);
+		return m_file.good() || Fail("write");
+	}
+
+	bool TilemapFileWriter::Finish() {
+		if (!m_file.is_open()) return false;
+
+		Header header{};
+		std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.version = VERSION;
+		header.headerSize = sizeof(Header);
+		header.chunkSize = m_chunkSize;
+		header.alignment = m_alignment;
+		header.chunkCount = m_directory.size();
+		header.directoryOffset = m_offset;
+
+		const size_t directoryBytes = m_directory.size() * sizeof(ChunkEntry);
+		m_file.write(reinterpret_cast<const char*>(m_directory.data()), static_cast<std::streamsize>(directoryBytes));
+		header.directoryCrc = Crc32(m_directory.data(), directoryBytes);
+		header.headerCrc = HeaderCrc(header);
+
+		m_file.seekp(0);
+		m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		m_file.close();
+		if (m_file.fail()) return Fail("finish");
+
+		spdlog::info("[TilemapFile] Wrote {} chunks to '{}' ({} bytes)", m_directory.size(), m_path,
+			m_offset + directoryBytes);
+		return true;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Reader
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	std::shared_ptr<TilemapFileReader> TilemapFileReader::Open(const std::string& path) {
+		std::shared_ptr<TilemapFileReader> reader(new TilemapFileReader());
+		reader->m_path = path;
+		if (!reader->Map(path) || !reader->ReadDirectory()) return nullptr;
+		return reader;
+	}
+
+	TilemapFileReader::~TilemapFileReader() {
+		Unmap();
+	}
+
+	bool TilemapFileReader::Map(const std::string& path) {
+#ifdef _WIN32
+		// Shared for delete so SaveLayerFile can rename a new file over one still mapped
+		HANDLE file = CreateFileW(std::filesystem::path(path).wstring().c_str(), GENERIC_READ,
+			FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			spdlog::error("[TilemapFile] Cannot open '{}'", path);
+			return false;
+		}
+		m_fileHandle = file;
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(Header))) {
+			spdlog::error("[TilemapFile] '{}' is too small to be a tilemap file", path);
+			return false;
+		}
+		m_size = static_cast<size_t>(size.QuadPart);
+
+		m_mappingHandle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!m_mappingHandle) {
+			spdlog::error("[TilemapFile] Cannot map '{}'", path);
+			return false;
+		}
+		m_base = static_cast<const uint8_t*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			spdlog::error("[TilemapFile] Cannot open '{}'", path);
+			return false;
+		}
+		struct stat info {};
+		if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+			::close(fd);
+			spdlog::error("[TilemapFile] '{}' is too small to be a tilemap file", path);
+			return false;
+		}
+		m_size = static_cast<size_t>(info.st_size);
+
+		void* base = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if (base == MAP_FAILED) base = nullptr;
+		// Chunks are visited in view order, not file order: don't read ahead
+		else ::madvise(base, m_size, MADV_RANDOM);
+		m_base = static_cast<const uint8_t*>(base);
+#endif
+		if (!m_base) {
+			spdlog::error("[TilemapFile] Cannot map '{}'", path);
+			return false;
+		}
+		return true;
+	}
+
+	void TilemapFileReader::Unmap() {
+#ifdef _WIN32
+		if (m_base) UnmapViewOfFile(m_base);
+		if (m_mappingHandle) CloseHandle(m_mappingHandle);
+		if (m_fileHandle) CloseHandle(m_fileHandle);
+		m_mappingHandle = nullptr;
+		m_fileHandle = nullptr;
+#else
+		if (m_base) ::munmap(const_cast<uint8_t*>(m_base), m_size);
+#endif
+		m_base = nullptr;
+		m_size = 0;
+	}
+
+	bool TilemapFileReader::ReadDirectory() {
+		Header header;
+		std::memcpy(&header, m_base, sizeof(header));
+
+		if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+			spdlog::error("[TilemapFile] '{}' is not a tilemap file (or was never finished)", m_path);
+			return false;
+		}
+		if (header.version != VERSION || header.headerSize != sizeof(Header)) {
+			spdlog::error("[TilemapFile] '{}' has unsupported version {}", m_path, header.version);
+			return false;
+		}
+		if (HeaderCrc(header) != header.headerCrc) {
+			spdlog::error("[TilemapFile] '{}' has a corrupt header", m_path);
+			return false;
+		}
+
+		const uint64_t directoryBytes = header.chunkCount * sizeof(ChunkEntry);
+		if (header.chunkSize <= 0 || header.directoryOffset > m_size ||
+			header.chunkCount > (m_size - header.directoryOffset) / sizeof(ChunkEntry)) {
+			spdlog::error("[TilemapFile] '{}' is truncated", m_path);
+			return false;
+		}
+		if (Crc32(m_base + header.directoryOffset, directoryBytes) != header.directoryCrc) {
+			spdlog::error("[TilemapFile] '{}' has a corrupt chunk directory", m_path);
+			return false;
+		}
+
+		m_chunkSize = header.chunkSize;
+		m_directory.resize(header.chunkCount);
+		std::memcpy(m_directory.data(), m_base + header.directoryOffset, directoryBytes);
+
+		m_index.reserve(m_directory.size());
+		for (size_t i = 0; i < m_directory.size(); ++i) {
+			const ChunkEntry& entry = m_directory[i];
+			if (entry.offset % alignof(int32_t) != 0 || entry.offset > header.directoryOffset ||
+				PayloadBytes(entry) > header.directoryOffset - entry.offset) {
+				spdlog::error("[TilemapFile] '{}' chunk ({}, {}) lies outside the file", m_path, entry.x, entry.y);
+				return false;
+			}
+			m_index.emplace(ChunkKey(entry.x, entry.y), i);
+		}
+		m_checked.assign(m_directory.size(), ChunkCheck::Unchecked);
+		return true;
+	}
+
+	bool TilemapFileReader::HasChunk(const glm::ivec2& chunkCoords) const {
+		return m_index.count(ChunkKey(chunkCoords.x, chunkCoords.y)) > 0;
+	}
+
+	std::vector<glm::ivec2> TilemapFileReader::GetChunkCoords() const {
+		std::vector<glm::ivec2> coords;
+		coords.reserve(m_directory.size());
+		for (const ChunkEntry& entry : m_directory) coords.emplace_back(entry.x, entry.y);
+		return coords;
+	}
+
+	bool TilemapFileReader::CheckChunk(size_t index) {
+		if (m_checked[index] == ChunkCheck::Unchecked) {
+			const ChunkEntry& entry = m_directory[index];
+			const bool valid = Crc32(m_base + entry.offset, PayloadBytes(entry)) == entry.crc;
+			m_checked[index] = valid ? ChunkCheck::Valid : ChunkCheck::Corrupt;
+			if (!valid) spdlog::error("[TilemapFile] '{}' chunk ({}, {}) fails its checksum", m_path, entry.x, entry.y);
+		}
+		return m_checked[index] == ChunkCheck::Valid;
+	}
+
+	std::shared_ptr<const MappedChunkTiles> TilemapFileReader::MapChunk(const glm::ivec2& chunkCoords) {
+		auto it = m_index.find(ChunkKey(chunkCoords.x, chunkCoords.y));
+		if (it == m_index.end() || !CheckChunk(it->second)) return nullptr;
+
+		const ChunkEntry& entry = m_directory[it->second];
+		auto tiles = std::make_shared<MappedChunkTiles>();
+		tiles->tileIds = reinterpret_cast<const int*>(m_base + entry.offset);
+		if (entry.flags & CHUNK_HAS_DATA) tiles->tileData = reinterpret_cast<const uint32_t*>(tiles->tileIds + entry.tileCount);
+		tiles->tileCount = static_cast<int>(entry.tileCount);
+		tiles->owner = shared_from_this();
+		return tiles;
+	}
+
+	bool TilemapFileReader::Verify() {
+		bool valid = true;
+		for (size_t i = 0; i < m_directory.size(); ++i) valid &= CheckChunk(i);
+		return valid;
+	}
+
+} // namespace WanderSpire
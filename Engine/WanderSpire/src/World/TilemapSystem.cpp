@@ -1,4 +1,9 @@
 ﻿#include "WanderSpire/World/TilemapSystem.h"
+#include "WanderSpire/World/TilemapChangeJournal.h"
+#include "WanderSpire/World/ChunkEvictionCache.h"
+#include "WanderSpire/World/ChunkPayloadPool.h"
+#include "WanderSpire/World/ChunkGenerationService.h"
+#include "WanderSpire/World/TilemapFile.h"
 #include "WanderSpire/Components/TilemapChunkComponent.h"
 #include "WanderSpire/Components/TilemapLayerComponent.h"
 #include "WanderSpire/Components/SceneNodeComponent.h"
@@ -6,9 +11,12 @@
 #include "WanderSpire/Core/ConfigManager.h"
 
 #include <algorithm>
-#include <queue>
+#include <bit>
+#include <deque>
 #include <unordered_set>
 #include <cmath>
+#include <cstring>
+#include <filesystem>
 #include <spdlog/spdlog.h>
 
 namespace WanderSpire {
@@ -18,6 +26,54 @@ namespace WanderSpire {
 		return instance;
 	}
 
+	/// Pack a chunk and point it at the interned payload for its content
+	static void CompactShared(TilemapChunkComponent& chunk) {
+		if (chunk.compact) return;
+		chunk.Compact();
+		chunk.shared = ChunkPayloadPool::GetInstance().Intern(chunk.packed);
+		chunk.packed = PalettedTileStorage{};
+	}
+
+	/// Tilemap files attached to a registry's layers (OpenLayerFile)
+	struct LayerFileSources {
+		std::unordered_map<entt::entity, std::shared_ptr<TilemapFileReader>> layers;
+	};
+
+	/// Chunk index of each of a registry's layers (FindChunk, bulk edits)
+	struct LayerChunkIndices {
+		struct Layer {
+			std::unordered_map<uint64_t, entt::entity> chunks;
+			size_t children = SIZE_MAX;   ///< Layer child count the index matches
+		};
+		std::unordered_map<entt::entity, Layer> layers;
+	};
+
+	static TilemapFileReader* LayerFile(const entt::registry& registry, entt::entity tilemapLayer) {
+		if (!registry.ctx().contains<LayerFileSources>()) return nullptr;
+		const auto& layers = registry.ctx().get<LayerFileSources>().layers;
+		auto it = layers.find(tilemapLayer);
+		return it != layers.end() ? it->second.get() : nullptr;
+	}
+
+	/// Point a chunk at its tiles on a layer file's mapped pages; false if the file lacks it
+	static bool MapFromFile(TilemapChunkComponent& chunk, TilemapFileReader* file) {
+		const size_t total = static_cast<size_t>(chunk.chunkSize) * static_cast<size_t>(chunk.chunkSize);
+		auto tiles = file ? file->MapChunk(chunk.chunkCoords) : nullptr;
+		if (!tiles || static_cast<size_t>(tiles->tileCount) != total) return false;
+
+		std::vector<int>().swap(chunk.tileIds);
+		std::vector<uint32_t>().swap(chunk.tileData);
+		chunk.packed = PalettedTileStorage{};
+		chunk.shared.reset();
+		chunk.compact = true;
+		chunk.instanceCount = static_cast<int>(std::count_if(tiles->tileIds, tiles->tileIds + tiles->tileCount,
+			[](int id) { return id != -1; }));
+		chunk.mapped = std::move(tiles);
+		chunk.summary.valid = false;
+		chunk.dirty = true;
+		return true;
+	}
+
 	// ═════════════════════════════════════════════════════════════════════
 	// TILEMAP & LAYER MANAGEMENT
 	// ═════════════════════════════════════════════════════════════════════
@@ -68,32 +124,40 @@ namespace WanderSpire {
 		glm::ivec2 localPos = position - (chunkCoords * chunkSize);
 		int index = localPos.y * chunkSize + localPos.x;
 
-		if (index >= 0 && index < static_cast<int>(chunkComponent.tileIds.size())) {
-			chunkComponent.tileIds[index] = tileId;
+		if (index >= 0 && index < chunkComponent.TileCount()) {
+			const int oldTileId = chunkComponent.TileAt(index);
+			if (oldTileId == tileId) return;
+
+			// Compact chunks take single writes in place (a shared payload is split
+			// off first); only bulk edits expand them
+			if (!chunkComponent.compact) chunkComponent.tileIds[index] = tileId;
+			else {
+				chunkComponent.Unshare();
+				chunkComponent.packed.Set(index, tileId);
+			}
 			chunkComponent.dirty = true;
 
-			// Update instance count
-			chunkComponent.instanceCount = std::count_if(chunkComponent.tileIds.begin(),
-				chunkComponent.tileIds.end(), [](int id) { return id != -1; });
+			// Update instance count incrementally
+			chunkComponent.instanceCount += (tileId != -1 ? 1 : 0) - (oldTileId != -1 ? 1 : 0);
+			chunkComponent.summary.OnTileChanged(oldTileId, tileId, index, chunkSize);
+
+			chunkComponent.version = TilemapChangeJournal::GetInstance().Record(
+				registry, tilemapLayer, chunkCoords, position, position);
+
+			NotifyChunkChanged(registry, tilemapLayer, chunkCoords);
 		}
 	}
 
 	int TilemapSystem::GetTile(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& position) {
 		glm::ivec2 chunkCoords = GetChunkCoords(position);
 
-		// Check layer's children first
-		if (auto* layerNode = registry.try_get<SceneNodeComponent>(tilemapLayer)) {
-			for (entt::entity chunkEntity : layerNode->children) {
-				if (auto* chunkComponent = registry.try_get<TilemapChunkComponent>(chunkEntity)) {
-					if (chunkComponent->chunkCoords == chunkCoords) {
-						glm::ivec2 localPos = position - (chunkCoords * chunkSize);
-						int index = localPos.y * chunkSize + localPos.x;
-
-						if (index >= 0 && index < static_cast<int>(chunkComponent->tileIds.size())) {
-							return chunkComponent->tileIds[index];
-						}
-					}
-				}
+		entt::entity chunkEntity = FindChunk(registry, tilemapLayer, chunkCoords);
+		if (auto* chunkComponent = chunkEntity != entt::null ? registry.try_get<TilemapChunkComponent>(chunkEntity) : nullptr) {
+			glm::ivec2 localPos = position - (chunkCoords * chunkSize);
+			int index = localPos.y * chunkSize + localPos.x;
+
+			if (index >= 0 && index < chunkComponent->TileCount()) {
+				return chunkComponent->TileAt(index);
 			}
 		}
 
@@ -109,42 +173,83 @@ namespace WanderSpire {
 	// ═════════════════════════════════════════════════════════════════════
 
 	void TilemapSystem::LoadChunk(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords) {
+		if (FindChunk(registry, tilemapLayer, chunkCoords) != entt::null) return;
+
+		// Procedural layers generate unseen chunks off-thread (authored ones come from the layer file)
+		auto& generation = ChunkGenerationService::GetInstance();
+		const auto* file = LayerFile(registry, tilemapLayer);
+		if (generation.HasGenerator(registry, tilemapLayer) && !(file && file->HasChunk(chunkCoords)) &&
+			!ChunkEvictionCache::GetInstance().Contains(registry, tilemapLayer, chunkCoords)) {
+			generation.Request(registry, tilemapLayer, chunkCoords, chunkSize);
+			return;
+		}
+
 		GetOrCreateChunk(registry, tilemapLayer, chunkCoords);
 	}
 
-	void TilemapSystem::UnloadChunk(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords) {
-		auto chunkView = registry.view<TilemapChunkComponent, SceneNodeComponent>();
-
-		for (auto chunk : chunkView) {
-			const auto& chunkComponent = chunkView.get<TilemapChunkComponent>(chunk);
-			const auto& node = chunkView.get<SceneNodeComponent>(chunk);
+	bool TilemapSystem::InstallChunk(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords,
+		std::vector<int>&& tileIds, std::vector<uint32_t>&& tileData)
+	{
+		const size_t total = static_cast<size_t>(chunkSize) * static_cast<size_t>(chunkSize);
+		if (tileIds.size() != total || FindChunk(registry, tilemapLayer, chunkCoords) != entt::null) return false;
+		tileData.resize(total, 0);
 
-			if (node.parent == tilemapLayer && chunkComponent.chunkCoords == chunkCoords) {
-				// Remove from parent's children
-				if (auto* parentNode = registry.try_get<SceneNodeComponent>(tilemapLayer)) {
-					auto& children = parentNode->children;
-					children.erase(std::remove(children.begin(), children.end(), chunk), children.end());
-				}
+		entt::entity chunk = GetOrCreateChunk(registry, tilemapLayer, chunkCoords);
+		auto& chunkComponent = registry.get<TilemapChunkComponent>(chunk);
+		chunkComponent.tileIds = std::move(tileIds);
+		chunkComponent.tileData = std::move(tileData);
+		chunkComponent.instanceCount = static_cast<int>(std::count_if(chunkComponent.tileIds.begin(),
+			chunkComponent.tileIds.end(), [](int id) { return id != -1; }));
+		CompactShared(chunkComponent);   // generated terrain repeats; share it from the start
+		chunkComponent.summary.valid = false;
+		chunkComponent.dirty = true;
+		chunkComponent.version = TilemapChangeJournal::GetInstance().Record(registry, tilemapLayer, chunkCoords,
+			chunkCoords * chunkSize, (chunkCoords + glm::ivec2(1)) * chunkSize - glm::ivec2(1));
+		chunkComponent.sourceVersion = chunkComponent.version;   // the generator can make it again
+
+		NotifyChunkChanged(registry, tilemapLayer, chunkCoords);
+		return true;
+	}
 
-				registry.destroy(chunk);
-				spdlog::debug("[TilemapSystem] Unloaded chunk ({}, {}) from layer {}",
-					chunkCoords.x, chunkCoords.y, entt::to_integral(tilemapLayer));
-				return;
-			}
+	void TilemapSystem::UnloadChunk(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords) {
+		entt::entity chunk = FindChunk(registry, tilemapLayer, chunkCoords);
+		if (chunk == entt::null) return;
+
+		const auto& chunkComponent = registry.get<TilemapChunkComponent>(chunk);
+		// Keep the tiles around in case streaming brings the chunk straight back;
+		// untouched chunks from the layer file come back from it for free. Edits
+		// the file or generator would undo (erasing included) are pinned in the cache
+		const auto* file = LayerFile(registry, tilemapLayer);
+		const bool inFile = file && file->HasChunk(chunkCoords);
+		const bool backed = inFile || ChunkGenerationService::GetInstance().HasGenerator(registry, tilemapLayer);
+		const bool modified = chunkComponent.version != chunkComponent.sourceVersion;
+		if (modified || !inFile)
+			ChunkEvictionCache::GetInstance().Store(registry, tilemapLayer, chunkComponent, backed, modified || !backed);
+
+		// Remove from parent's children
+		if (auto* parentNode = registry.try_get<SceneNodeComponent>(tilemapLayer)) {
+			auto& children = parentNode->children;
+			children.erase(std::remove(children.begin(), children.end(), chunk), children.end());
 		}
+		UpdateChunkIndex(registry, tilemapLayer, chunkCoords, entt::null);
+
+		registry.destroy(chunk);
+		TilemapChangeJournal::GetInstance().Record(registry, tilemapLayer, chunkCoords,
+			chunkCoords * chunkSize, (chunkCoords + glm::ivec2(1)) * chunkSize - glm::ivec2(1), true);
+		spdlog::debug("[TilemapSystem] Unloaded chunk ({}, {}) from layer {}",
+			chunkCoords.x, chunkCoords.y, entt::to_integral(tilemapLayer));
+		NotifyChunkChanged(registry, tilemapLayer, chunkCoords);
 	}
 
 	bool TilemapSystem::IsChunkLoaded(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords) {
-		if (auto* layerNode = registry.try_get<SceneNodeComponent>(tilemapLayer)) {
-			for (entt::entity chunkEntity : layerNode->children) {
-				if (auto* chunkComponent = registry.try_get<TilemapChunkComponent>(chunkEntity)) {
-					if (chunkComponent->chunkCoords == chunkCoords) {
-						return chunkComponent->loaded;
-					}
-				}
-			}
-		}
-		return false;
+		entt::entity chunk = FindChunk(registry, tilemapLayer, chunkCoords);
+		return chunk != entt::null && registry.get<TilemapChunkComponent>(chunk).loaded;
+	}
+
+	uint64_t TilemapSystem::GetChunkVersion(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords) const {
+		entt::entity chunk = FindChunk(registry, tilemapLayer, chunkCoords);
+		auto* chunkComponent = chunk != entt::null ? registry.try_get<TilemapChunkComponent>(chunk) : nullptr;
+		return chunkComponent ? chunkComponent->version : 0;
 	}
 
 	void TilemapSystem::EnsureChunksLoaded(entt::registry& registry, const glm::vec2& minWorldBound, const glm::vec2& maxWorldBound) {
@@ -210,6 +315,24 @@ namespace WanderSpire {
 				glm::ivec2 coords = chunkComponent.chunkCoords;
 				UnloadChunk(registry, layer, coords);
 			}
+
+			// Generation queued for chunks that already left the view is wasted work
+			ChunkGenerationService::GetInstance().CancelPending(registry, layer, [&](const glm::ivec2& coords) {
+				return requiredChunks.find(ChunkCoordsToKey(coords)) == requiredChunks.end();
+				});
+
+			// Chunks nobody wrote to since the last pass are cold: pack them
+			if (idleChunkCompaction) {
+				if (auto* layerNode = registry.try_get<SceneNodeComponent>(layer)) {
+					for (entt::entity chunk : layerNode->children) {
+						if (!registry.valid(chunk)) continue;
+						auto* chunkComponent = registry.try_get<TilemapChunkComponent>(chunk);
+						if (!chunkComponent || chunkComponent->compact) continue;
+						if (chunkComponent->idleCheckVersion == chunkComponent->version) CompactShared(*chunkComponent);
+						else chunkComponent->idleCheckVersion = chunkComponent->version;
+					}
+				}
+			}
 		}
 
 		//if (!requiredChunks.empty()) {
@@ -218,6 +341,175 @@ namespace WanderSpire {
 		//}
 	}
 
+	bool TilemapSystem::CompactChunk(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords) {
+		entt::entity chunk = FindChunk(registry, tilemapLayer, chunkCoords);
+		auto* chunkComponent = chunk != entt::null ? registry.try_get<TilemapChunkComponent>(chunk) : nullptr;
+		if (!chunkComponent) return false;
+
+		CompactShared(*chunkComponent);
+		return true;
+	}
+
+	bool TilemapSystem::ExpandChunk(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords) {
+		entt::entity chunk = FindChunk(registry, tilemapLayer, chunkCoords);
+		auto* chunkComponent = chunk != entt::null ? registry.try_get<TilemapChunkComponent>(chunk) : nullptr;
+		if (!chunkComponent) return false;
+
+		chunkComponent->Expand();
+		return true;
+	}
+
+	size_t TilemapSystem::CompactLayer(entt::registry& registry, entt::entity tilemapLayer) {
+		size_t compacted = 0;
+		if (auto* layerNode = registry.try_get<SceneNodeComponent>(tilemapLayer)) {
+			for (entt::entity chunk : layerNode->children) {
+				auto* chunkComponent = registry.try_get<TilemapChunkComponent>(chunk);
+				if (!chunkComponent || chunkComponent->compact) continue;
+				CompactShared(*chunkComponent);
+				++compacted;
+			}
+		}
+		return compacted;
+	}
+
+	size_t TilemapSystem::GetLayerTileMemory(entt::registry& registry, entt::entity tilemapLayer) const {
+		size_t bytes = 0;
+		std::unordered_set<const PalettedTileStorage*> sharedSeen;
+		if (auto* layerNode = registry.try_get<SceneNodeComponent>(tilemapLayer)) {
+			for (entt::entity chunk : layerNode->children) {
+				auto* chunkComponent = registry.try_get<TilemapChunkComponent>(chunk);
+				if (!chunkComponent || chunkComponent->mapped) continue;   // Pages belong to the tilemap file
+				if (chunkComponent->shared) {
+					// Count each shared payload once per layer
+					if (sharedSeen.insert(chunkComponent->shared.get()).second) bytes += chunkComponent->shared->MemoryBytes();
+				}
+				else {
+					bytes += chunkComponent->compact
+						? chunkComponent->packed.MemoryBytes()
+						: chunkComponent->tileIds.capacity() * sizeof(int) + chunkComponent->tileData.capacity() * sizeof(uint32_t);
+				}
+			}
+		}
+		return bytes;
+	}
+
+	// ═════════════════════════════════════════════════════════════════════
+	// TILEMAP FILES
+	// ═════════════════════════════════════════════════════════════════════
+
+	bool TilemapSystem::SaveLayerFile(entt::registry& registry, entt::entity tilemapLayer, const std::string& path) {
+		auto* layerNode = registry.try_get<SceneNodeComponent>(tilemapLayer);
+		if (!layerNode) return false;
+
+		// Written beside the target and swapped in at the end, so a mapping of the
+		// previous file (possibly this very layer's) never sees a half-written one
+		const std::string tempPath = path + ".tmp";
+		TilemapFileWriter writer;
+		if (!writer.Open(tempPath, chunkSize)) return false;
+
+		const size_t total = static_cast<size_t>(chunkSize) * static_cast<size_t>(chunkSize);
+		std::unordered_set<uint64_t> written;
+		auto write = [&](const glm::ivec2& coords, const int* tiles, const uint32_t* data) {
+			written.insert(ChunkCoordsToKey(coords));
+			// Empty chunks read back as empty without taking up a page
+			if (std::all_of(tiles, tiles + total, [](int id) { return id == -1; }) &&
+				(!data || std::all_of(data, data + total, [](uint32_t d) { return d == 0; }))) return;
+			writer.WriteChunk(coords, tiles, data, static_cast<int>(total));
+		};
+
+		std::vector<int> idScratch;
+		std::vector<uint32_t> dataScratch;
+		for (entt::entity chunk : layerNode->children) {
+			const auto* chunkComponent = registry.try_get<TilemapChunkComponent>(chunk);
+			if (!chunkComponent || chunkComponent->chunkSize != chunkSize ||
+				static_cast<size_t>(chunkComponent->TileCount()) != total) continue;
+			write(chunkComponent->chunkCoords, chunkComponent->ReadTileIds(idScratch), chunkComponent->ReadTileData(dataScratch));
+		}
+
+		// Unloaded chunks: the cache holds edits newer than the attached file
+		auto& cache = ChunkEvictionCache::GetInstance();
+		for (const glm::ivec2& coords : cache.GetCachedChunks(registry, tilemapLayer)) {
+			if (written.count(ChunkCoordsToKey(coords))) continue;
+			if (!cache.Peek(registry, tilemapLayer, coords, idScratch, dataScratch) || idScratch.size() != total) {
+				spdlog::error("[TilemapSystem] Not saving '{}': cached chunk ({},{}) is unreadable", path, coords.x, coords.y);
+				writer.Finish();
+				std::filesystem::remove(tempPath);
+				return false;
+			}
+			write(coords, idScratch.data(), dataScratch.data());
+		}
+		if (TilemapFileReader* file = LayerFile(registry, tilemapLayer)) {
+			for (const glm::ivec2& coords : file->GetChunkCoords()) {
+				if (written.count(ChunkCoordsToKey(coords))) continue;
+				auto tiles = file->MapChunk(coords);
+				if (!tiles || static_cast<size_t>(tiles->tileCount) != total) {
+					spdlog::error("[TilemapSystem] Not saving '{}': chunk ({},{}) of '{}' is unreadable",
+						path, coords.x, coords.y, file->GetPath());
+					writer.Finish();
+					std::filesystem::remove(tempPath);
+					return false;
+				}
+				write(coords, tiles->tileIds, tiles->tileData);
+			}
+		}
+		if (!writer.Finish()) return false;
+
+		std::error_code error;
+		std::filesystem::rename(tempPath, path, error);
+		if (error) {
+			spdlog::error("[TilemapSystem] Could not replace '{}' ({}); layer saved to '{}'", path, error.message(), tempPath);
+			return false;
+		}
+		return true;
+	}
+
+	bool TilemapSystem::OpenLayerFile(entt::registry& registry, entt::entity tilemapLayer, const std::string& path) {
+		if (!registry.all_of<TilemapLayerComponent>(tilemapLayer)) return false;
+
+		auto file = TilemapFileReader::Open(path);
+		if (!file) return false;
+		if (file->GetChunkSize() != chunkSize) {
+			spdlog::error("[TilemapSystem] '{}' uses {}-tile chunks, the tilemap uses {}", path, file->GetChunkSize(), chunkSize);
+			return false;
+		}
+
+		if (!registry.ctx().contains<LayerFileSources>()) registry.ctx().emplace<LayerFileSources>();
+		registry.ctx().get<LayerFileSources>().layers[tilemapLayer] = file;
+
+		// The file replaces whatever the layer held for the chunks it contains
+		ChunkEvictionCache::GetInstance().Forget(registry, tilemapLayer);
+		ChunkGenerationService::GetInstance().CancelPending(registry, tilemapLayer, [&](const glm::ivec2& coords) {
+			return file->HasChunk(coords);
+			});
+
+		std::vector<glm::ivec2> remapped;
+		if (auto* layerNode = registry.try_get<SceneNodeComponent>(tilemapLayer)) {
+			for (entt::entity chunk : layerNode->children) {
+				auto* chunkComponent = registry.try_get<TilemapChunkComponent>(chunk);
+				if (!chunkComponent || !MapFromFile(*chunkComponent, file.get())) continue;
+				const glm::ivec2 coords = chunkComponent->chunkCoords;
+				chunkComponent->version = TilemapChangeJournal::GetInstance().Record(registry, tilemapLayer, coords,
+					coords * chunkSize, (coords + glm::ivec2(1)) * chunkSize - glm::ivec2(1));
+				chunkComponent->sourceVersion = chunkComponent->version;
+				remapped.push_back(coords);
+			}
+		}
+		for (const glm::ivec2& coords : remapped) NotifyChunkChanged(registry, tilemapLayer, coords);
+
+		spdlog::info("[TilemapSystem] Opened '{}' for layer {} ({} chunks, {} already loaded)",
+			path, entt::to_integral(tilemapLayer), file->GetChunkCount(), remapped.size());
+		return true;
+	}
+
+	void TilemapSystem::CloseLayerFile(entt::registry& registry, entt::entity tilemapLayer) {
+		if (registry.ctx().contains<LayerFileSources>())
+			registry.ctx().get<LayerFileSources>().layers.erase(tilemapLayer);
+	}
+
+	bool TilemapSystem::HasLayerFile(entt::registry& registry, entt::entity tilemapLayer) const {
+		return LayerFile(registry, tilemapLayer) != nullptr;
+	}
+
 	// ═════════════════════════════════════════════════════════════════════
 	// CONFIGURATION
 	// ═════════════════════════════════════════════════════════════════════
@@ -227,6 +519,14 @@ namespace WanderSpire {
 		spdlog::info("[TilemapSystem] Chunk size set to {}", chunkSize);
 	}
 
+	void TilemapSystem::SetIdleChunkCompaction(bool enabled) {
+		idleChunkCompaction = enabled;
+	}
+
+	bool TilemapSystem::GetIdleChunkCompaction() const {
+		return idleChunkCompaction;
+	}
+
 	int TilemapSystem::GetChunkSize() const {
 		return chunkSize;
 	}
@@ -244,49 +544,553 @@ namespace WanderSpire {
 	// BULK OPERATIONS
 	// ═════════════════════════════════════════════════════════════════════
 
-	void TilemapSystem::FloodFill(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& startPos, int newTileId) {
-		int originalTileId = GetTile(registry, tilemapLayer, startPos);
-		if (originalTileId == newTileId) return;
+	size_t TilemapSystem::FloodFill(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& startPos, int newTileId) {
+		return FloodFill(registry, tilemapLayer, startPos, newTileId, FloodFillOptions{}).tilesFilled;
+	}
+
+	void TilemapSystem::FloodFillArea(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& min, const glm::ivec2& max, int tileId) {
+		size_t tilesSet = FillRect(registry, tilemapLayer, min, max, tileId);
+
+		spdlog::debug("[TilemapSystem] Area fill set {} tiles to {} in area ({},{}) to ({},{})",
+			tilesSet, tileId, min.x, min.y, max.x, max.y);
+	}
+
+	// ─── Bulk edit helpers ───────────────────────────────────────────────────
+
+	/// Visit the part of an inclusive tile rectangle inside each chunk it overlaps.
+	/// fn(chunkCoords, localMin, localMax) with inclusive local bounds.
+	template<typename Fn>
+	static void ForEachChunkInRect(int chunkSize, const glm::ivec2& min, const glm::ivec2& max, Fn&& fn) {
+		auto floorDiv = [chunkSize](int v) { return (v >= 0) ? v / chunkSize : -((-v + chunkSize - 1) / chunkSize); };
+		const glm::ivec2 c0{ floorDiv(min.x), floorDiv(min.y) };
+		const glm::ivec2 c1{ floorDiv(max.x), floorDiv(max.y) };
+
+		for (int cy = c0.y; cy <= c1.y; ++cy) {
+			for (int cx = c0.x; cx <= c1.x; ++cx) {
+				const glm::ivec2 origin{ cx * chunkSize, cy * chunkSize };
+				const glm::ivec2 lo = glm::max(min, origin) - origin;
+				const glm::ivec2 hi = glm::min(max, origin + glm::ivec2(chunkSize - 1)) - origin;
+				fn(glm::ivec2{ cx, cy }, lo, hi);
+			}
+		}
+	}
+
+	/// Copy one row into a chunk, keeping instanceCount; returns tiles changed
+	static size_t WriteRow(TilemapChunkComponent& chunk, int index, const int* src, int count) {
+		int* dst = chunk.tileIds.data() + index;
+		size_t changed = 0;
+		int delta = 0;
+		for (int i = 0; i < count; ++i) {
+			changed += dst[i] != src[i];
+			delta += (src[i] != -1) - (dst[i] != -1);
+		}
+		if (!changed) return 0;
+
+		for (int i = 0; i < count; ++i) {
+			chunk.summary.OnTileChanged(dst[i], src[i], index + i, chunk.chunkSize);
+		}
+
+		std::memcpy(dst, src, sizeof(int) * static_cast<size_t>(count));
+		chunk.instanceCount += delta;
+		return changed;
+	}
+
+	/// Fill one row of a chunk, keeping instanceCount; returns tiles changed
+	static size_t FillRow(TilemapChunkComponent& chunk, int index, int tileId, int count) {
+		int* dst = chunk.tileIds.data() + index;
+		const size_t changed = static_cast<size_t>(count - std::count(dst, dst + count, tileId));
+		if (!changed) return 0;
+
+		const int oldFilled = count - static_cast<int>(std::count(dst, dst + count, -1));
+		for (int i = 0; i < count; ++i) {
+			chunk.summary.OnTileChanged(dst[i], tileId, index + i, chunk.chunkSize);
+		}
+		std::fill_n(dst, count, tileId);
+		chunk.instanceCount += (tileId != -1 ? count : 0) - oldFilled;
+		return changed;
+	}
+
+	/// Chunk holds a full tile set for this chunk size (flat or compact)
+	static bool HasFullTileArray(const TilemapChunkComponent& chunk, int chunkSize) {
+		return chunk.chunkSize == chunkSize && chunk.TileCount() >= chunkSize * chunkSize;
+	}
+
+	/// Flat, writable tiles: compact chunks are expanded before a bulk edit
+	static bool PrepareForWrite(TilemapChunkComponent& chunk, int chunkSize) {
+		chunk.Expand();
+		return HasFullTileArray(chunk, chunkSize);
+	}
+
+	/// Scratch for decoding compact chunks on read paths
+	static std::vector<int>& DecodeScratch() {
+		thread_local std::vector<int> scratch;
+		return scratch;
+	}
+
+	/// Summary of a chunk, rebuilt first if it was loaded or edited outside TilemapSystem
+	static const TileChunkSummary& EnsureSummary(TilemapChunkComponent& chunk) {
+		if (!chunk.summary.valid || chunk.summary.boundsStale) {
+			const int* tiles = chunk.ReadTileIds(DecodeScratch());
+			if (!chunk.summary.valid) chunk.summary.Rebuild(tiles, chunk.TileCount(), chunk.chunkSize);
+			else chunk.summary.RecomputeBounds(tiles, chunk.TileCount(), chunk.chunkSize);
+		}
+		return chunk.summary;
+	}
+
+	// ─── Bulk edits ──────────────────────────────────────────────────────────
+
+	size_t TilemapSystem::SetTiles(entt::registry& registry, entt::entity tilemapLayer,
+		const glm::ivec2* positions, const int* tileIds, size_t count)
+	{
+		if (!positions || !tileIds || count == 0) return 0;
+
+		ChunkIndex& chunks = GetChunkIndex(registry, tilemapLayer);
+		TouchSet touched;
+		size_t changed = 0;
+
+		// Positions usually arrive spatially coherent, so cache the current chunk
+		glm::ivec2 currentCoords{ INT32_MAX, INT32_MAX };
+		TilemapChunkComponent* current = nullptr;
+
+		for (size_t i = 0; i < count; ++i) {
+			const glm::ivec2 coords = GetChunkCoords(positions[i]);
+			if (coords != currentCoords) {
+				currentCoords = coords;
+				const uint64_t key = ChunkCoordsToKey(coords);
+				auto it = chunks.find(key);
+				if (it == chunks.end() && tileIds[i] != -1) {
+					it = chunks.emplace(key, GetOrCreateChunk(registry, tilemapLayer, coords)).first;
+				}
+				current = (it != chunks.end()) ? registry.try_get<TilemapChunkComponent>(it->second) : nullptr;
+				if (current && !PrepareForWrite(*current, chunkSize)) current = nullptr;
+			}
+			if (!current) continue;
+
+			const glm::ivec2 local = positions[i] - coords * chunkSize;
+			int& slot = current->tileIds[local.y * chunkSize + local.x];
+			if (slot == tileIds[i]) continue;
+
+			current->instanceCount += (tileIds[i] != -1 ? 1 : 0) - (slot != -1 ? 1 : 0);
+			current->summary.OnTileChanged(slot, tileIds[i], local.y * chunkSize + local.x, chunkSize);
+			slot = tileIds[i];
+			++changed;
+			Touch(touched, ChunkCoordsToKey(coords), chunks[ChunkCoordsToKey(coords)], local, local);
+		}
+
+		FinishBulkEdit(registry, tilemapLayer, touched);
+		return changed;
+	}
+
+	size_t TilemapSystem::SetTiles(entt::registry& registry, entt::entity tilemapLayer,
+		const TileSpan* spans, size_t count)
+	{
+		if (!spans || count == 0) return 0;
+
+		ChunkIndex& chunks = GetChunkIndex(registry, tilemapLayer);
+		TouchSet touched;
+		size_t changed = 0;
+
+		for (size_t s = 0; s < count; ++s) {
+			const TileSpan& span = spans[s];
+			if (span.length <= 0) continue;
+
+			const glm::ivec2 min = span.start;
+			const glm::ivec2 max = span.start + glm::ivec2{ span.length - 1, 0 };
+
+			ForEachChunkInRect(chunkSize, min, max, [&](const glm::ivec2& coords, const glm::ivec2& lo, const glm::ivec2& hi) {
+				const uint64_t key = ChunkCoordsToKey(coords);
+				auto it = chunks.find(key);
+				if (it == chunks.end()) {
+					if (span.tileId == -1) return;
+					it = chunks.emplace(key, GetOrCreateChunk(registry, tilemapLayer, coords)).first;
+				}
+				auto* chunk = registry.try_get<TilemapChunkComponent>(it->second);
+				if (!chunk || !PrepareForWrite(*chunk, chunkSize)) return;
+
+				const size_t n = FillRow(*chunk, lo.y * chunkSize + lo.x, span.tileId, hi.x - lo.x + 1);
+				if (n) {
+					changed += n;
+					Touch(touched, key, it->second, lo, hi);
+				}
+				});
+		}
+
+		FinishBulkEdit(registry, tilemapLayer, touched);
+		return changed;
+	}
+
+	size_t TilemapSystem::SetTilesRect(entt::registry& registry, entt::entity tilemapLayer,
+		const glm::ivec2& min, const glm::ivec2& max, const int* tileIds)
+	{
+		if (!tileIds || max.x < min.x || max.y < min.y) return 0;
+
+		const int width = max.x - min.x + 1;
+		ChunkIndex& chunks = GetChunkIndex(registry, tilemapLayer);
+		TouchSet touched;
+		size_t changed = 0;
+
+		ForEachChunkInRect(chunkSize, min, max, [&](const glm::ivec2& coords, const glm::ivec2& lo, const glm::ivec2& hi) {
+			const glm::ivec2 origin = coords * chunkSize;
+			const int rowLength = hi.x - lo.x + 1;
+			auto source = [&](int localY) {
+				return tileIds + static_cast<size_t>(origin.y + localY - min.y) * width + (origin.x + lo.x - min.x);
+				};
+
+			const uint64_t key = ChunkCoordsToKey(coords);
+			auto it = chunks.find(key);
+			if (it == chunks.end()) {
+				// Only materialise unloaded chunks that receive real tiles
+				bool anyTile = false;
+				for (int y = lo.y; y <= hi.y && !anyTile; ++y) {
+					const int* row = source(y);
+					anyTile = std::any_of(row, row + rowLength, [](int id) { return id != -1; });
+				}
+				if (!anyTile) return;
+				it = chunks.emplace(key, GetOrCreateChunk(registry, tilemapLayer, coords)).first;
+			}
+			auto* chunk = registry.try_get<TilemapChunkComponent>(it->second);
+			if (!chunk || !PrepareForWrite(*chunk, chunkSize)) return;
+
+			size_t n = 0;
+			for (int y = lo.y; y <= hi.y; ++y) {
+				n += WriteRow(*chunk, y * chunkSize + lo.x, source(y), rowLength);
+			}
+			if (n) {
+				changed += n;
+				Touch(touched, key, it->second, lo, hi);
+			}
+			});
+
+		FinishBulkEdit(registry, tilemapLayer, touched);
+		return changed;
+	}
+
+	size_t TilemapSystem::FillRect(entt::registry& registry, entt::entity tilemapLayer,
+		const glm::ivec2& min, const glm::ivec2& max, int tileId)
+	{
+		if (max.x < min.x || max.y < min.y) return 0;
+
+		ChunkIndex& chunks = GetChunkIndex(registry, tilemapLayer);
+		TouchSet touched;
+		size_t changed = 0;
+
+		ForEachChunkInRect(chunkSize, min, max, [&](const glm::ivec2& coords, const glm::ivec2& lo, const glm::ivec2& hi) {
+			const uint64_t key = ChunkCoordsToKey(coords);
+			auto it = chunks.find(key);
+			if (it == chunks.end()) {
+				if (tileId == -1) return; // erasing unloaded ground is a no-op
+				it = chunks.emplace(key, GetOrCreateChunk(registry, tilemapLayer, coords)).first;
+			}
+			auto* chunk = registry.try_get<TilemapChunkComponent>(it->second);
+			if (!chunk || !PrepareForWrite(*chunk, chunkSize)) return;
+
+			size_t n = 0;
+			for (int y = lo.y; y <= hi.y; ++y) {
+				n += FillRow(*chunk, y * chunkSize + lo.x, tileId, hi.x - lo.x + 1);
+			}
+			if (n) {
+				changed += n;
+				Touch(touched, key, it->second, lo, hi);
+			}
+			});
+
+		FinishBulkEdit(registry, tilemapLayer, touched);
+		return changed;
+	}
+
+	void TilemapSystem::ReadRect(entt::registry& registry, entt::entity tilemapLayer,
+		const glm::ivec2& min, const glm::ivec2& max, int* outTileIds)
+	{
+		if (!outTileIds || max.x < min.x || max.y < min.y) return;
+
+		const int width = max.x - min.x + 1;
+		ChunkIndex& chunks = GetChunkIndex(registry, tilemapLayer);
+
+		ForEachChunkInRect(chunkSize, min, max, [&](const glm::ivec2& coords, const glm::ivec2& lo, const glm::ivec2& hi) {
+			const glm::ivec2 origin = coords * chunkSize;
+			const int rowLength = hi.x - lo.x + 1;
+
+			const TilemapChunkComponent* chunk = nullptr;
+			if (auto it = chunks.find(ChunkCoordsToKey(coords)); it != chunks.end()) {
+				chunk = registry.try_get<TilemapChunkComponent>(it->second);
+				if (chunk && !HasFullTileArray(*chunk, chunkSize)) chunk = nullptr;
+			}
+
+			for (int y = lo.y; y <= hi.y; ++y) {
+				int* dst = outTileIds + static_cast<size_t>(origin.y + y - min.y) * width + (origin.x + lo.x - min.x);
+				if (!chunk) std::fill_n(dst, rowLength, -1);
+				else chunk->ReadTileRange(y * chunkSize + lo.x, rowLength, dst);
+			}
+			});
+	}
+
+	size_t TilemapSystem::CopyRect(entt::registry& registry, entt::entity srcLayer,
+		const glm::ivec2& srcMin, const glm::ivec2& srcMax,
+		entt::entity dstLayer, const glm::ivec2& dstMin, bool skipEmpty)
+	{
+		if (srcMax.x < srcMin.x || srcMax.y < srcMin.y) return 0;
+
+		const glm::ivec2 size = srcMax - srcMin + glm::ivec2(1);
+		const glm::ivec2 dstMax = dstMin + size - glm::ivec2(1);
+
+		// Stage through a buffer so overlapping copies within a layer are safe
+		std::vector<int> buffer(static_cast<size_t>(size.x) * static_cast<size_t>(size.y));
+		ReadRect(registry, srcLayer, srcMin, srcMax, buffer.data());
+
+		if (skipEmpty) {
+			std::vector<int> existing(buffer.size());
+			ReadRect(registry, dstLayer, dstMin, dstMax, existing.data());
+			for (size_t i = 0; i < buffer.size(); ++i) {
+				if (buffer[i] == -1) buffer[i] = existing[i];
+			}
+		}
+
+		return SetTilesRect(registry, dstLayer, dstMin, dstMax, buffer.data());
+	}
 
-		std::queue<glm::ivec2> toProcess;
-		std::unordered_set<uint64_t> visited;
-		toProcess.push(startPos);
+	size_t TilemapSystem::ReplaceInRect(entt::registry& registry, entt::entity tilemapLayer,
+		const glm::ivec2& min, const glm::ivec2& max, int fromTileId, int toTileId)
+	{
+		if (fromTileId == toTileId || max.x < min.x || max.y < min.y) return 0;
+
+		ChunkIndex& chunks = GetChunkIndex(registry, tilemapLayer);
+		TouchSet touched;
+		size_t changed = 0;
+		const int instanceDelta = (toTileId != -1 ? 1 : 0) - (fromTileId != -1 ? 1 : 0);
+
+		ForEachChunkInRect(chunkSize, min, max, [&](const glm::ivec2& coords, const glm::ivec2& lo, const glm::ivec2& hi) {
+			const uint64_t key = ChunkCoordsToKey(coords);
+			auto it = chunks.find(key);
+			if (it == chunks.end()) {
+				// Unloaded ground reads as -1
+				if (fromTileId != -1) return;
+				it = chunks.emplace(key, GetOrCreateChunk(registry, tilemapLayer, coords)).first;
+			}
+			auto* chunk = registry.try_get<TilemapChunkComponent>(it->second);
+			if (!chunk || !HasFullTileArray(*chunk, chunkSize)) return;
+
+			// The summary rules out chunks without the id and rows outside its bounds
+			glm::ivec2 a = lo, b = hi;
+			if (fromTileId != -1) {
+				const TileChunkSummary& summary = EnsureSummary(*chunk);
+				if (!summary.Count(fromTileId)) return;
+				a = glm::max(lo, summary.boundsMin);
+				b = glm::min(hi, summary.boundsMax);
+				if (a.x > b.x || a.y > b.y) return;
+			}
+			chunk->Expand();
+
+			size_t n = 0;
+			for (int y = a.y; y <= b.y; ++y) {
+				int* row = chunk->tileIds.data() + y * chunkSize + a.x;
+				const int rowLength = b.x - a.x + 1;
+				// Branch-free select so the compiler can vectorise the row
+				for (int x = 0; x < rowLength; ++x) {
+					const bool match = row[x] == fromTileId;
+					n += match;
+					row[x] = match ? toTileId : row[x];
+				}
+			}
+			if (n) {
+				chunk->summary.OnTilesReplaced(fromTileId, toTileId, static_cast<int>(n));
+				chunk->instanceCount += instanceDelta * static_cast<int>(n);
+				changed += n;
+				Touch(touched, key, it->second, a, b);
+			}
+			});
 
-		int tilesChanged = 0;
-		while (!toProcess.empty()) {
-			glm::ivec2 pos = toProcess.front();
-			toProcess.pop();
+		FinishBulkEdit(registry, tilemapLayer, touched);
+		return changed;
+	}
 
-			uint64_t key = (uint64_t(pos.x) << 32) | uint32_t(pos.y);
-			if (visited.count(key)) continue;
-			visited.insert(key);
+	// ─── Scanline flood fill ─────────────────────────────────────────────────
 
-			if (GetTile(registry, tilemapLayer, pos) == originalTileId) {
-				SetTile(registry, tilemapLayer, pos, newTileId);
-				tilesChanged++;
+	TilemapSystem::FloodFillResult TilemapSystem::FloodFill(entt::registry& registry, entt::entity tilemapLayer,
+		const glm::ivec2& startPos, int newTileId, const FloodFillOptions& options)
+	{
+		FloodFillResult result;
+		result.originalTileId = GetTile(registry, tilemapLayer, startPos);
+		if (result.originalTileId == newTileId) return result;
+
+		const int originalTileId = result.originalTileId;
+		ChunkIndex& chunks = GetChunkIndex(registry, tilemapLayer);
+
+		// Resolve bounds; an unbounded fill of empty ground would never end
+		glm::ivec2 lo, hi;
+		if (options.useBounds) {
+			lo = glm::min(options.boundsMin, options.boundsMax);
+			hi = glm::max(options.boundsMin, options.boundsMax);
+		}
+		else {
+			glm::ivec2 cmin = GetChunkCoords(startPos), cmax = cmin;
+			for (const auto& [key, chunk] : chunks) {
+				const glm::ivec2 cc = KeyToChunkCoords(key);
+				cmin = glm::min(cmin, cc);
+				cmax = glm::max(cmax, cc);
+			}
+			lo = cmin * chunkSize;
+			hi = (cmax + glm::ivec2(1)) * chunkSize - glm::ivec2(1);
+		}
+		if (glm::any(glm::lessThan(startPos, lo)) || glm::any(glm::greaterThan(startPos, hi))) return result;
+
+		// Per-chunk view of the raw tile array plus a visited bitset, which
+		// doubles as the fill mask since only matching tiles are ever marked
+		struct FillChunk {
+			glm::ivec2 coords{ 0, 0 };
+			const int* tiles = nullptr;   ///< null = unloaded (reads as -1)
+			bool blocked = false;         ///< Chunk with a foreign tile layout
+			size_t count = 0;
+			std::vector<uint64_t> visited;
+			std::vector<int> decoded;     ///< Flat copy of a compact chunk
+		};
+		std::deque<FillChunk> slots;
+		std::unordered_map<uint64_t, FillChunk*> slotByKey;
+
+		const int cs = chunkSize;
+		const size_t words = (static_cast<size_t>(cs) * cs + 63) / 64;
+		auto floorDiv = [cs](int v) { return (v >= 0) ? v / cs : -((-v + cs - 1) / cs); };
+
+		glm::ivec2 lastCoords{ INT32_MAX, INT32_MAX };
+		FillChunk* last = nullptr;
+
+		auto chunkAt = [&](int x, int y, int& local) -> FillChunk& {
+			const glm::ivec2 cc{ floorDiv(x), floorDiv(y) };
+			if (cc != lastCoords) {
+				lastCoords = cc;
+				const uint64_t key = ChunkCoordsToKey(cc);
+				auto it = slotByKey.find(key);
+				if (it == slotByKey.end()) {
+					FillChunk& fc = slots.emplace_back();
+					fc.coords = cc;
+					fc.visited.assign(words, 0);
+					if (auto ci = chunks.find(key); ci != chunks.end()) {
+						auto* comp = registry.try_get<TilemapChunkComponent>(ci->second);
+						if (comp && HasFullTileArray(*comp, cs)) fc.tiles = comp->ReadTileIds(fc.decoded);
+						else fc.blocked = true;
+					}
+					it = slotByKey.emplace(key, &fc).first;
+				}
+				last = it->second;
+			}
+			local = (y - cc.y * cs) * cs + (x - cc.x * cs);
+			return *last;
+			};
+
+		auto fillable = [&](int x, int y) {
+			if (x < lo.x || x > hi.x || y < lo.y || y > hi.y) return false;
+			int local;
+			const FillChunk& fc = chunkAt(x, y, local);
+			if (fc.blocked || (fc.visited[local >> 6] >> (local & 63)) & 1u) return false;
+			return (fc.tiles ? fc.tiles[local] : -1) == originalTileId;
+			};
+
+		auto mark = [&](int x, int y) {
+			int local;
+			FillChunk& fc = chunkAt(x, y, local);
+			fc.visited[local >> 6] |= uint64_t(1) << (local & 63);
+			++fc.count;
+			};
+
+		// Span stack: fill a whole row run, then seed one point per run above and below
+		std::vector<glm::ivec2> stack{ startPos };
+		size_t total = 0;
+
+		while (!stack.empty()) {
+			const glm::ivec2 seed = stack.back();
+			stack.pop_back();
+			if (!fillable(seed.x, seed.y)) continue;
+
+			int left = seed.x, right = seed.x;
+			while (fillable(left - 1, seed.y)) --left;
+			while (fillable(right + 1, seed.y)) ++right;
+			for (int x = left; x <= right; ++x) mark(x, seed.y);
+
+			total += static_cast<size_t>(right - left + 1);
+			if (total > options.maxTiles) {
+				result.aborted = true;
+				break;
+			}
 
-				toProcess.push(pos + glm::ivec2{ 1, 0 });
-				toProcess.push(pos + glm::ivec2{ -1, 0 });
-				toProcess.push(pos + glm::ivec2{ 0, 1 });
-				toProcess.push(pos + glm::ivec2{ 0, -1 });
+			for (int y : { seed.y - 1, seed.y + 1 }) {
+				bool inRun = false;
+				for (int x = left; x <= right; ++x) {
+					const bool open = fillable(x, y);
+					if (open && !inRun) stack.push_back({ x, y });
+					inRun = open;
+				}
 			}
 		}
 
+		if (result.aborted) {
+			spdlog::warn("[TilemapSystem] Flood fill from ({}, {}) exceeded {} tiles, aborted",
+				startPos.x, startPos.y, options.maxTiles);
+			return result;
+		}
+
+		FloodFillMask mask;
+		mask.chunkSize = cs;
+		mask.tileCount = total;
+		for (FillChunk& fc : slots) {
+			if (fc.count) mask.chunks.push_back({ fc.coords, std::move(fc.visited) });
+		}
+
+		result.tilesFilled = options.apply ? ApplyMask(registry, tilemapLayer, mask, newTileId) : total;
+		if (options.collectMask) result.mask = std::move(mask);
+
 		spdlog::debug("[TilemapSystem] Flood fill changed {} tiles from {} to {} starting at ({}, {})",
-			tilesChanged, originalTileId, newTileId, startPos.x, startPos.y);
+			result.tilesFilled, originalTileId, newTileId, startPos.x, startPos.y);
+		return result;
 	}
 
-	void TilemapSystem::FloodFillArea(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& min, const glm::ivec2& max, int tileId) {
-		int tilesSet = 0;
-		for (int y = min.y; y <= max.y; ++y) {
-			for (int x = min.x; x <= max.x; ++x) {
-				SetTile(registry, tilemapLayer, { x, y }, tileId);
-				tilesSet++;
+	size_t TilemapSystem::ApplyMask(entt::registry& registry, entt::entity tilemapLayer, const FloodFillMask& mask, int tileId) {
+		if (mask.chunks.empty()) return 0;
+		if (mask.chunkSize != chunkSize) {
+			spdlog::warn("[TilemapSystem] Tile mask built for chunk size {} cannot be applied at {}", mask.chunkSize, chunkSize);
+			return 0;
+		}
+
+		ChunkIndex& chunks = GetChunkIndex(registry, tilemapLayer);
+		TouchSet touched;
+		size_t changed = 0;
+
+		for (const auto& maskChunk : mask.chunks) {
+			const uint64_t key = ChunkCoordsToKey(maskChunk.chunkCoords);
+			auto it = chunks.find(key);
+			if (it == chunks.end()) {
+				if (tileId == -1) continue; // already empty
+				it = chunks.emplace(key, GetOrCreateChunk(registry, tilemapLayer, maskChunk.chunkCoords)).first;
+			}
+			auto* chunk = registry.try_get<TilemapChunkComponent>(it->second);
+			if (!chunk || !PrepareForWrite(*chunk, chunkSize)) continue;
+
+			int* tiles = chunk->tileIds.data();
+			size_t n = 0;
+			int delta = 0;
+			glm::ivec2 dirtyMin{ INT32_MAX, INT32_MAX }, dirtyMax{ INT32_MIN, INT32_MIN };
+			for (size_t w = 0; w < maskChunk.bits.size(); ++w) {
+				for (uint64_t bits = maskChunk.bits[w]; bits; bits &= bits - 1) {
+					const int index = static_cast<int>(w * 64) + std::countr_zero(bits);
+					int& slot = tiles[index];
+					if (slot == tileId) continue;
+					++n;
+					delta += (tileId != -1) - (slot != -1);
+					chunk->summary.OnTileChanged(slot, tileId, index, chunkSize);
+					slot = tileId;
+
+					const glm::ivec2 local{ index % chunkSize, index / chunkSize };
+					dirtyMin = glm::min(dirtyMin, local);
+					dirtyMax = glm::max(dirtyMax, local);
+				}
+			}
+			if (n) {
+				chunk->instanceCount += delta;
+				changed += n;
+				Touch(touched, key, it->second, dirtyMin, dirtyMax);
 			}
 		}
 
-		spdlog::debug("[TilemapSystem] Area fill set {} tiles to {} in area ({},{}) to ({},{})",
-			tilesSet, tileId, min.x, min.y, max.x, max.y);
+		FinishBulkEdit(registry, tilemapLayer, touched);
+		return changed;
 	}
 
 	// ═════════════════════════════════════════════════════════════════════
@@ -382,22 +1186,232 @@ namespace WanderSpire {
 		return entt::null;
 	}
 
+	// ─── Region queries ──────────────────────────────────────────────────────
+
+	bool TilemapSystem::GetLayerBounds(entt::registry& registry, entt::entity tilemapLayer,
+		glm::ivec2& outMin, glm::ivec2& outMax)
+	{
+		glm::ivec2 lo{ INT32_MAX, INT32_MAX }, hi{ INT32_MIN, INT32_MIN };
+		bool any = false;
+
+		if (auto* layerNode = registry.try_get<SceneNodeComponent>(tilemapLayer)) {
+			for (entt::entity child : layerNode->children) {
+				auto* chunk = registry.try_get<TilemapChunkComponent>(child);
+				if (!chunk || !HasFullTileArray(*chunk, chunkSize)) continue;
+
+				const TileChunkSummary& summary = EnsureSummary(*chunk);
+				if (!summary.occupancy) continue;
+
+				const glm::ivec2 origin = chunk->chunkCoords * chunkSize;
+				lo = glm::min(lo, origin + summary.boundsMin);
+				hi = glm::max(hi, origin + summary.boundsMax);
+				any = true;
+			}
+		}
+
+		if (any) {
+			outMin = lo;
+			outMax = hi;
+		}
+		return any;
+	}
+
+	size_t TilemapSystem::CountTilesInRect(entt::registry& registry, entt::entity tilemapLayer,
+		const glm::ivec2& min, const glm::ivec2& max, int tileId)
+	{
+		if (max.x < min.x || max.y < min.y) return 0;
+
+		// Empty tiles are whatever the occupied ones leave over
+		if (tileId == -1) {
+			const size_t area = static_cast<size_t>(max.x - min.x + 1) * static_cast<size_t>(max.y - min.y + 1);
+			return area - CountTilesInRect(registry, tilemapLayer, min, max, ANY_TILE);
+		}
+
+		ChunkIndex& chunks = GetChunkIndex(registry, tilemapLayer);
+		size_t total = 0;
+
+		ForEachChunkInRect(chunkSize, min, max, [&](const glm::ivec2& coords, const glm::ivec2& lo, const glm::ivec2& hi) {
+			auto it = chunks.find(ChunkCoordsToKey(coords));
+			if (it == chunks.end()) return;
+			auto* chunk = registry.try_get<TilemapChunkComponent>(it->second);
+			if (!chunk || !HasFullTileArray(*chunk, chunkSize)) return;
+
+			const TileChunkSummary& summary = EnsureSummary(*chunk);
+			const int inChunk = (tileId == ANY_TILE) ? summary.occupancy : summary.Count(tileId);
+			if (!inChunk) return;
+
+			const glm::ivec2 a = glm::max(lo, summary.boundsMin);
+			const glm::ivec2 b = glm::min(hi, summary.boundsMax);
+			if (a.x > b.x || a.y > b.y) return;
+
+			// Rect covers every occupied tile: answer straight from the summary
+			if (a == summary.boundsMin && b == summary.boundsMax) {
+				total += static_cast<size_t>(inChunk);
+				return;
+			}
+
+			const int* tiles = chunk->ReadTileIds(DecodeScratch());
+			const int rowLength = b.x - a.x + 1;
+			for (int y = a.y; y <= b.y; ++y) {
+				const int* row = tiles + y * chunkSize + a.x;
+				total += (tileId == ANY_TILE)
+					? static_cast<size_t>(rowLength - std::count(row, row + rowLength, -1))
+					: static_cast<size_t>(std::count(row, row + rowLength, tileId));
+			}
+			});
+
+		return total;
+	}
+
+	size_t TilemapSystem::FindTilePositions(entt::registry& registry, entt::entity tilemapLayer, int tileId,
+		glm::ivec2* outPositions, size_t maxPositions)
+	{
+		if (!outPositions || maxPositions == 0 || tileId == -1) return 0;
+
+		size_t found = 0;
+		auto* layerNode = registry.try_get<SceneNodeComponent>(tilemapLayer);
+		if (!layerNode) return 0;
+
+		for (entt::entity child : layerNode->children) {
+			auto* chunk = registry.try_get<TilemapChunkComponent>(child);
+			if (!chunk || !HasFullTileArray(*chunk, chunkSize)) continue;
+
+			const TileChunkSummary& summary = EnsureSummary(*chunk);
+			if (!summary.Count(tileId)) continue;
+
+			const glm::ivec2 origin = chunk->chunkCoords * chunkSize;
+			const int* tiles = chunk->ReadTileIds(DecodeScratch());
+			for (int y = summary.boundsMin.y; y <= summary.boundsMax.y; ++y) {
+				const int* row = tiles + y * chunkSize;
+				for (int x = summary.boundsMin.x; x <= summary.boundsMax.x; ++x) {
+					if (row[x] != tileId) continue;
+					outPositions[found++] = origin + glm::ivec2{ x, y };
+					if (found == maxPositions) return found;
+				}
+			}
+		}
+
+		return found;
+	}
+
+	// ═════════════════════════════════════════════════════════════════════
+	// CHANGE NOTIFICATION
+	// ═════════════════════════════════════════════════════════════════════
+
+	size_t TilemapSystem::AddChunkChangedListener(ChunkChangedCallback callback) {
+		size_t id = nextListenerId++;
+		chunkChangedListeners.emplace_back(id, std::move(callback));
+		return id;
+	}
+
+	void TilemapSystem::RemoveChunkChangedListener(size_t listenerId) {
+		chunkChangedListeners.erase(std::remove_if(chunkChangedListeners.begin(), chunkChangedListeners.end(),
+			[listenerId](const auto& entry) { return entry.first == listenerId; }),
+			chunkChangedListeners.end());
+	}
+
+	void TilemapSystem::NotifyChunkChanged(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords) {
+		for (auto& [id, callback] : chunkChangedListeners) {
+			callback(registry, tilemapLayer, chunkCoords);
+		}
+	}
+
 	// ═════════════════════════════════════════════════════════════════════
 	// PRIVATE HELPER METHODS
 	// ═════════════════════════════════════════════════════════════════════
 
+	entt::entity TilemapSystem::FindChunk(entt::registry& registry, entt::entity tilemapLayer,
+		const glm::ivec2& chunkCoords) const
+	{
+		const uint64_t key = ChunkCoordsToKey(chunkCoords);
+		for (int attempt = 0; attempt < 2; ++attempt) {
+			ChunkIndex& chunks = GetChunkIndex(registry, tilemapLayer);
+			auto it = chunks.find(key);
+			if (it == chunks.end()) return entt::null;
+
+			// A chunk destroyed or rewritten behind our back forces a reindex
+			auto* cc = registry.valid(it->second) ? registry.try_get<TilemapChunkComponent>(it->second) : nullptr;
+			if (cc && cc->chunkCoords == chunkCoords) return it->second;
+			registry.ctx().get<LayerChunkIndices>().layers[tilemapLayer].children = SIZE_MAX;
+		}
+		return entt::null;
+	}
+
+	TilemapSystem::ChunkIndex& TilemapSystem::GetChunkIndex(entt::registry& registry, entt::entity tilemapLayer) const {
+		if (!registry.ctx().contains<LayerChunkIndices>()) registry.ctx().emplace<LayerChunkIndices>();
+		auto& entry = registry.ctx().get<LayerChunkIndices>().layers[tilemapLayer];
+
+		// Chunks attached or detached without TilemapSystem change the child count
+		auto* layerNode = registry.valid(tilemapLayer) ? registry.try_get<SceneNodeComponent>(tilemapLayer) : nullptr;
+		const size_t children = layerNode ? layerNode->children.size() : 0;
+		if (entry.children != children) {
+			entry.chunks.clear();
+			if (layerNode) {
+				entry.chunks.reserve(children);
+				for (entt::entity child : layerNode->children) {
+					if (auto* cc = registry.try_get<TilemapChunkComponent>(child)) {
+						entry.chunks.emplace(ChunkCoordsToKey(cc->chunkCoords), child);
+					}
+				}
+			}
+			entry.children = children;
+		}
+		return entry.chunks;
+	}
+
+	void TilemapSystem::UpdateChunkIndex(entt::registry& registry, entt::entity tilemapLayer,
+		const glm::ivec2& chunkCoords, entt::entity chunk) const
+	{
+		auto* layerNode = registry.try_get<SceneNodeComponent>(tilemapLayer);
+		if (!layerNode || !registry.ctx().contains<LayerChunkIndices>()) return;
+		auto& layers = registry.ctx().get<LayerChunkIndices>().layers;
+		auto it = layers.find(tilemapLayer);
+		if (it == layers.end()) return;
+
+		// Only an index that matched the children before this one change stays exact;
+		// anything else is rebuilt on the next lookup
+		auto& entry = it->second;
+		const size_t children = layerNode->children.size();
+		if (entry.children != (chunk != entt::null ? children - 1 : children + 1)) return;
+
+		if (chunk != entt::null) entry.chunks[ChunkCoordsToKey(chunkCoords)] = chunk;
+		else entry.chunks.erase(ChunkCoordsToKey(chunkCoords));
+		entry.children = children;
+	}
+
+	void TilemapSystem::Touch(TouchSet& touched, uint64_t key, entt::entity chunk,
+		const glm::ivec2& localMin, const glm::ivec2& localMax) const
+	{
+		auto [it, inserted] = touched.try_emplace(key, TouchedChunk{ chunk, localMin, localMax });
+		if (!inserted) {
+			it->second.min = glm::min(it->second.min, localMin);
+			it->second.max = glm::max(it->second.max, localMax);
+		}
+	}
+
+	void TilemapSystem::FinishBulkEdit(entt::registry& registry, entt::entity tilemapLayer, const TouchSet& touched) {
+		auto& journal = TilemapChangeJournal::GetInstance();
+		for (const auto& [key, touch] : touched) {
+			const glm::ivec2 chunkCoords = KeyToChunkCoords(key);
+			const glm::ivec2 origin = chunkCoords * chunkSize;
+			const uint64_t version = journal.Record(registry, tilemapLayer, chunkCoords,
+				origin + touch.min, origin + touch.max);
+
+			if (auto* cc = registry.try_get<TilemapChunkComponent>(touch.entity)) {
+				cc->dirty = true;
+				cc->version = version;
+			}
+			NotifyChunkChanged(registry, tilemapLayer, chunkCoords);
+		}
+	}
+
 	entt::entity TilemapSystem::GetOrCreateChunk(entt::registry& registry,
 		entt::entity     tilemapLayer,
 		const glm::ivec2& chunkCoords)
 	{
 		// 1)  Return existing chunk if present
-		if (auto* layerNode = registry.try_get<SceneNodeComponent>(tilemapLayer)) {
-			for (entt::entity child : layerNode->children) {
-				if (auto* cc = registry.try_get<TilemapChunkComponent>(child);
-					cc && cc->chunkCoords == chunkCoords) {
-					return child;
-				}
-			}
+		if (entt::entity existing = FindChunk(registry, tilemapLayer, chunkCoords); existing != entt::null) {
+			return existing;
 		}
 
 		// 2)  Create new chunk entity
@@ -423,16 +1437,39 @@ namespace WanderSpire {
 			.visible = true
 		};
 		const size_t total = static_cast<size_t>(chunkSize) * static_cast<size_t>(chunkSize);
-		comp.tileIds.resize(total, -1);
-		comp.tileData.resize(total, 0);
+		// A recently unloaded chunk comes back from the eviction cache with its tiles
+		// (its edits are newer than the layer file), otherwise from the file's mapped pages
+		auto* file = LayerFile(registry, tilemapLayer);
+		bool modified = false;
+		const bool restored = ChunkEvictionCache::GetInstance().Restore(registry, tilemapLayer, chunkCoords, comp,
+			file && file->HasChunk(chunkCoords), &modified) && comp.tileIds.size() == total;
+		if (restored || MapFromFile(comp, file)) {
+			if (restored) {
+				comp.instanceCount = static_cast<int>(std::count_if(comp.tileIds.begin(), comp.tileIds.end(),
+					[](int id) { return id != -1; }));
+				CompactShared(comp);
+			}
+			comp.dirty = true;
+			comp.version = TilemapChangeJournal::GetInstance().Record(registry, tilemapLayer, chunkCoords,
+				chunkCoords * chunkSize, (chunkCoords + glm::ivec2(1)) * chunkSize - glm::ivec2(1));
+			// Restored edits still differ from the file/generator until saved
+			if (!(restored && modified)) comp.sourceVersion = comp.version;
+		}
+		else {
+			comp.tileIds.assign(total, -1);
+			comp.tileData.assign(total, 0);
+			comp.summary.valid = true;   // all empty
+		}
 		registry.emplace<TilemapChunkComponent>(chunk, std::move(comp));
 
 		// Hook into parent node hierarchy
 		if (auto* layerNode = registry.try_get<SceneNodeComponent>(tilemapLayer)) {
 			layerNode->children.push_back(chunk);
+			UpdateChunkIndex(registry, tilemapLayer, chunkCoords, chunk);
 		}
 
 		spdlog::debug("[TilemapSystem] Created chunk ({}, {})", chunkCoords.x, chunkCoords.y);
+		NotifyChunkChanged(registry, tilemapLayer, chunkCoords);
 		return chunk;
 	}
 
@@ -440,8 +1477,9 @@ namespace WanderSpire {
 		auto* chunkComponent = registry.try_get<TilemapChunkComponent>(chunk);
 		if (!chunkComponent || !chunkComponent->dirty) return;
 
-		chunkComponent->instanceCount = std::count_if(chunkComponent->tileIds.begin(),
-			chunkComponent->tileIds.end(), [](int id) { return id != -1; });
+		const int* tiles = chunkComponent->ReadTileIds(DecodeScratch());
+		chunkComponent->instanceCount = static_cast<int>(std::count_if(tiles, tiles + chunkComponent->TileCount(),
+			[](int id) { return id != -1; }));
 		chunkComponent->instanceVBO = 0;
 		chunkComponent->dirty = false;
 	}
@@ -0,0 +1,425 @@
+﻿#include "WanderSpire/World/VisibilityMap.h"
+#include "WanderSpire/World/TilemapSystem.h"
+#include "WanderSpire/World/TileDefinitionManager.h"
+#include "WanderSpire/Components/TilemapChunkComponent.h"
+#include "WanderSpire/Components/ObstacleComponent.h"
+#include "WanderSpire/Components/GridPositionComponent.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+namespace WanderSpire {
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Helpers
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	static inline uint64_t PackCoords(const glm::ivec2& p) {
+		return (uint64_t(uint32_t(p.x)) << 32) | uint32_t(p.y);
+	}
+
+	static inline glm::ivec2 UnpackCoords(uint64_t key) {
+		return glm::ivec2{ int32_t(key >> 32), int32_t(key) };
+	}
+
+	static inline int FloorDiv(int a, int b) {
+		return (a >= 0) ? a / b : -((-a + b - 1) / b);
+	}
+
+	// Octant transforms for shadowcasting (xx, xy, yx, yy per octant)
+	static constexpr int OCTANTS[8][4] = {
+		{ 1,  0,  0,  1 }, { 0,  1,  1,  0 },
+		{ 0, -1,  1,  0 }, {-1,  0,  0,  1 },
+		{-1,  0,  0, -1 }, { 0, -1, -1,  0 },
+		{ 0,  1, -1,  0 }, { 1,  0,  0, -1 }
+	};
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// VisibilityBitmap
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	void VisibilityBitmap::Reset(const glm::ivec2& newOrigin, int newRadius) {
+		origin = newOrigin;
+		radius = std::max(0, newRadius);
+		const size_t count = static_cast<size_t>(Side()) * static_cast<size_t>(Side());
+		bits.assign((count + 63) / 64, 0);
+	}
+
+	void VisibilityBitmap::Set(const glm::ivec2& tile) {
+		const glm::ivec2 local = tile - origin + glm::ivec2(radius);
+		if (local.x < 0 || local.y < 0 || local.x >= Side() || local.y >= Side()) return;
+		const size_t index = static_cast<size_t>(local.y) * Side() + local.x;
+		bits[index >> 6] |= (uint64_t(1) << (index & 63));
+	}
+
+	bool VisibilityBitmap::Test(const glm::ivec2& tile) const {
+		const glm::ivec2 local = tile - origin + glm::ivec2(radius);
+		if (local.x < 0 || local.y < 0 || local.x >= Side() || local.y >= Side()) return false;
+		const size_t index = static_cast<size_t>(local.y) * Side() + local.x;
+		return (bits[index >> 6] >> (index & 63)) & 1;
+	}
+
+	size_t VisibilityBitmap::Count() const {
+		size_t total = 0;
+		for (uint64_t word : bits) total += std::popcount(word);
+		return total;
+	}
+
+	void VisibilityBitmap::CopyTo(uint8_t* outMask, size_t maskBytes) const {
+		if (!outMask) return;
+		const size_t count = static_cast<size_t>(Side()) * static_cast<size_t>(Side());
+		const size_t needed = std::min(maskBytes, (count + 7) / 8);
+		// Little-endian words give the documented byte order directly
+		for (size_t i = 0; i < needed; ++i) {
+			outMask[i] = static_cast<uint8_t>(bits[i >> 3] >> ((i & 7) * 8));
+		}
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Lifetime
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	VisibilityMap& VisibilityMap::GetInstance() {
+		static VisibilityMap instance;
+		return instance;
+	}
+
+	// Tile overrides only decide walkability, never sight
+	VisibilityMap::VisibilityMap()
+		: m_listener(false) {}
+
+	void VisibilityMap::Clear() {
+		m_listener.Clear();
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Queries
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	bool VisibilityMap::IsOpaque(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& pos) {
+		std::lock_guard lock(m_listener.Mutex());
+		OpacityReader reader{ &Prepare(registry, tilemapLayer), TilemapSystem::GetInstance().GetChunkSize() };
+		return reader(pos);
+	}
+
+	void VisibilityMap::ComputeFOV(entt::registry& registry, entt::entity tilemapLayer,
+		const glm::ivec2& origin, int radius, VisibilityBitmap& out)
+	{
+		std::lock_guard lock(m_listener.Mutex());
+		OpacityReader reader{ &Prepare(registry, tilemapLayer), TilemapSystem::GetInstance().GetChunkSize() };
+
+		out.Reset(origin, radius);
+		out.Set(origin);
+		for (const auto& o : OCTANTS) {
+			CastLight(reader, out, 1, 1.0f, 0.0f, out.radius, o[0], o[1], o[2], o[3]);
+		}
+	}
+
+	void VisibilityMap::ComputeFOVBatch(entt::registry& registry, entt::entity tilemapLayer,
+		const glm::ivec2* origins, size_t count, int radius, std::vector<VisibilityBitmap>& out)
+	{
+		std::lock_guard lock(m_listener.Mutex());
+		OpacityReader reader{ &Prepare(registry, tilemapLayer), TilemapSystem::GetInstance().GetChunkSize() };
+
+		out.resize(count);
+		for (size_t i = 0; i < count; ++i) {
+			auto& bitmap = out[i];
+			bitmap.Reset(origins[i], radius);
+			bitmap.Set(origins[i]);
+			for (const auto& o : OCTANTS) {
+				CastLight(reader, bitmap, 1, 1.0f, 0.0f, bitmap.radius, o[0], o[1], o[2], o[3]);
+			}
+		}
+	}
+
+	bool VisibilityMap::HasLineOfSight(entt::registry& registry, entt::entity tilemapLayer,
+		const glm::ivec2& from, const glm::ivec2& to)
+	{
+		std::lock_guard lock(m_listener.Mutex());
+		OpacityReader reader{ &Prepare(registry, tilemapLayer), TilemapSystem::GetInstance().GetChunkSize() };
+		return TraceLine(reader, from, to);
+	}
+
+	size_t VisibilityMap::HasLineOfSightBatch(entt::registry& registry, entt::entity tilemapLayer,
+		const glm::ivec2* from, const glm::ivec2* to, size_t count,
+		float maxDistance, uint8_t* outVisible)
+	{
+		std::lock_guard lock(m_listener.Mutex());
+		OpacityReader reader{ &Prepare(registry, tilemapLayer), TilemapSystem::GetInstance().GetChunkSize() };
+
+		const float maxDist2 = maxDistance * maxDistance;
+		size_t visible = 0;
+		for (size_t i = 0; i < count; ++i) {
+			bool result = true;
+			if (maxDistance > 0.0f) {
+				const glm::vec2 d = glm::vec2(to[i] - from[i]);
+				result = (d.x * d.x + d.y * d.y) <= maxDist2;
+			}
+			result = result && TraceLine(reader, from[i], to[i]);
+
+			if (outVisible) outVisible[i] = result ? 1 : 0;
+			if (result) ++visible;
+		}
+		return visible;
+	}
+
+	void VisibilityMap::MarkChunkDirty(entt::registry& registry, entt::entity tilemapLayer, const glm::ivec2& chunkCoords) {
+		m_listener.MarkChunkDirty(registry, tilemapLayer, chunkCoords);
+	}
+
+	void VisibilityMap::Invalidate(entt::registry& registry) {
+		m_listener.Invalidate(registry);
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Kernels
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	bool VisibilityMap::OpacityReader::operator()(const glm::ivec2& pos) {
+		const glm::ivec2 chunkCoords{ FloorDiv(pos.x, chunkSize), FloorDiv(pos.y, chunkSize) };
+		if (chunkCoords != cachedCoords) {
+			cachedCoords = chunkCoords;
+			auto it = layer->chunks.find(PackCoords(chunkCoords));
+			cached = (it != layer->chunks.end() && !it->second.bits.empty()) ? &it->second : nullptr;
+		}
+		if (!cached) return false;
+
+		const glm::ivec2 local = pos - chunkCoords * cached->chunkSize;
+		const int index = local.y * cached->chunkSize + local.x;
+		return (cached->bits[index >> 6] >> (index & 63)) & 1;
+	}
+
+	void VisibilityMap::CastLight(OpacityReader& opaque, VisibilityBitmap& out, int row, float start, float end,
+		int radius, int xx, int xy, int yx, int yy)
+	{
+		if (start < end) return;
+
+		const int radius2 = radius * radius;
+		float newStart = 0.0f;
+
+		for (int j = row; j <= radius; ++j) {
+			int dx = -j - 1;
+			const int dy = -j;
+			bool blocked = false;
+
+			while (dx <= 0) {
+				++dx;
+				const float leftSlope = (dx - 0.5f) / (dy + 0.5f);
+				const float rightSlope = (dx + 0.5f) / (dy - 0.5f);
+
+				if (start < rightSlope) continue;
+				if (end > leftSlope) break;
+
+				const glm::ivec2 tile{
+					out.origin.x + dx * xx + dy * xy,
+					out.origin.y + dx * yx + dy * yy
+				};
+
+				if (dx * dx + dy * dy <= radius2) {
+					out.Set(tile);
+				}
+
+				const bool isOpaque = opaque(tile);
+				if (blocked) {
+					if (isOpaque) {
+						newStart = rightSlope;
+						continue;
+					}
+					blocked = false;
+					start = newStart;
+				}
+				else if (isOpaque && j < radius) {
+					blocked = true;
+					CastLight(opaque, out, j + 1, start, leftSlope, radius, xx, xy, yx, yy);
+					newStart = rightSlope;
+				}
+			}
+
+			if (blocked) break;
+		}
+	}
+
+	bool VisibilityMap::TraceLine(OpacityReader& opaque, const glm::ivec2& from, const glm::ivec2& to) {
+		if (from == to) return true;
+
+		const int nx = std::abs(to.x - from.x);
+		const int ny = std::abs(to.y - from.y);
+		const int sx = to.x > from.x ? 1 : -1;
+		const int sy = to.y > from.y ? 1 : -1;
+
+		glm::ivec2 p = from;
+		int ix = 0, iy = 0;
+
+		// Integer DDA: compare the parametric distance to the next vertical
+		// and horizontal cell boundary without floating point.
+		while (ix < nx || iy < ny) {
+			const long long decision =
+				static_cast<long long>(1 + 2 * ix) * ny - static_cast<long long>(1 + 2 * iy) * nx;
+
+			if (decision == 0) {
+				// Exactly through a corner: sight is blocked only if both sides are
+				if (opaque({ p.x + sx, p.y }) && opaque({ p.x, p.y + sy })) return false;
+				p.x += sx; p.y += sy;
+				++ix; ++iy;
+			}
+			else if (decision < 0) {
+				p.x += sx;
+				++ix;
+			}
+			else {
+				p.y += sy;
+				++iy;
+			}
+
+			if (p == to) return true;
+			if (opaque(p)) return false;
+		}
+
+		return true;
+	}
+
+	// ─────────────────────────────────────────────────────────────────────────────
+	// Rebuild pipeline
+	// ─────────────────────────────────────────────────────────────────────────────
+
+	VisibilityMap::LayerState& VisibilityMap::Prepare(entt::registry& registry, entt::entity tilemapLayer) {
+		auto& state = m_listener.StateFor(registry);
+		auto& layerState = state.layers[tilemapLayer];
+
+		const uint64_t revision = TileDefinitionManager::GetInstance().GetRevision();
+		if (revision != state.definitionRevision) {
+			state.definitionRevision = revision;
+			for (auto& [layer, ls] : state.layers) {
+				for (auto& [key, chunk] : ls.chunks) chunk.dirty = true;
+			}
+		}
+
+		if (state.obstaclesDirty) {
+			SyncObstacles(registry, state);
+		}
+
+		if (layerState.chunkSetDirty) {
+			ReindexChunks(registry, tilemapLayer, state, layerState);
+		}
+
+		for (auto& [key, chunk] : layerState.chunks) {
+			if (chunk.dirty) RebuildChunk(registry, state, key, chunk);
+		}
+
+		return layerState;
+	}
+
+	void VisibilityMap::SyncObstacles(entt::registry& registry, RegistryState& state) {
+		auto& tilemapSystem = TilemapSystem::GetInstance();
+		const int chunkSize = tilemapSystem.GetChunkSize();
+
+		std::unordered_map<uint64_t, std::vector<int>> opaqueByChunk;
+		auto view = registry.view<ObstacleComponent, GridPositionComponent>();
+		for (auto entity : view) {
+			if (!view.get<ObstacleComponent>(entity).blocksVision) continue;
+			const glm::ivec2 pos = view.get<GridPositionComponent>(entity).tile;
+			const glm::ivec2 chunkCoords = tilemapSystem.GetChunkCoords(pos);
+			const glm::ivec2 local = pos - chunkCoords * chunkSize;
+			opaqueByChunk[PackCoords(chunkCoords)].push_back(local.y * chunkSize + local.x);
+		}
+		for (auto& [key, indices] : opaqueByChunk) {
+			std::sort(indices.begin(), indices.end());
+		}
+
+		// Dirty chunks whose obstacle set changed, in every layer
+		std::unordered_set<uint64_t> changed;
+		for (auto& [key, indices] : opaqueByChunk) {
+			auto it = state.opaqueByChunk.find(key);
+			if (it == state.opaqueByChunk.end() || it->second != indices) changed.insert(key);
+		}
+		for (auto& [key, indices] : state.opaqueByChunk) {
+			if (!opaqueByChunk.count(key)) changed.insert(key);
+		}
+
+		state.opaqueByChunk = std::move(opaqueByChunk);
+		state.obstaclesDirty = false;
+
+		if (changed.empty()) return;
+		for (auto& [layer, layerState] : state.layers) {
+			layerState.chunkSetDirty = true;
+			for (uint64_t key : changed) {
+				if (auto it = layerState.chunks.find(key); it != layerState.chunks.end()) it->second.dirty = true;
+			}
+		}
+	}
+
+	void VisibilityMap::ReindexChunks(entt::registry& registry, entt::entity layer,
+		RegistryState& state, LayerState& layerState)
+	{
+		// A null layer means "obstacles only"
+		auto present = TilemapListener<RegistryState>::IndexLoadedChunks(registry, layer, layerState);
+
+		// Obstacles block sight even over unloaded ground
+		for (auto& [key, indices] : state.opaqueByChunk) {
+			if (present.insert(key).second) {
+				auto& entry = layerState.chunks[key];
+				if (entry.entity != entt::null) {
+					entry.entity = entt::null;
+					entry.dirty = true;
+				}
+			}
+		}
+
+		for (auto it = layerState.chunks.begin(); it != layerState.chunks.end();) {
+			if (!present.count(it->first)) it = layerState.chunks.erase(it);
+			else ++it;
+		}
+
+		layerState.chunkSetDirty = false;
+	}
+
+	void VisibilityMap::RebuildChunk(entt::registry& registry, const RegistryState& state,
+		uint64_t chunkKey, OpacityChunk& chunk)
+	{
+		const auto* comp = (chunk.entity != entt::null && registry.valid(chunk.entity))
+			? registry.try_get<TilemapChunkComponent>(chunk.entity) : nullptr;
+		const int chunkSize = comp ? comp->chunkSize : TilemapSystem::GetInstance().GetChunkSize();
+		const int total = chunkSize * chunkSize;
+
+		chunk.chunkSize = chunkSize;
+		chunk.bits.assign((total + 63) / 64, 0);
+
+		if (comp) {
+			auto& definitions = TileDefinitionManager::GetInstance();
+			std::unordered_map<int, bool> opaqueIds;
+			std::vector<int> scratch;
+			const int* tileIds = comp->ReadTileIds(scratch);
+
+			// Tiles a short chunk lacks read as empty, as in ConnectivityMap::LabelChunk
+			std::vector<int> padded;
+			if (comp->TileCount() < total) {
+				padded.assign(total, -1);
+				std::copy(tileIds, tileIds + std::max(0, comp->TileCount()), padded.begin());
+				tileIds = padded.data();
+			}
+
+			for (int i = 0; i < total; ++i) {
+				const int id = tileIds[i];
+				if (id == -1) continue;
+
+				auto it = opaqueIds.find(id);
+				if (it == opaqueIds.end()) {
+					const auto* def = definitions.GetTileDefinition(id);
+					it = opaqueIds.emplace(id, def && def->blocksVision).first;
+				}
+				if (it->second) chunk.bits[i >> 6] |= (uint64_t(1) << (i & 63));
+			}
+		}
+
+		if (auto it = state.opaqueByChunk.find(chunkKey); it != state.opaqueByChunk.end()) {
+			for (int i : it->second) {
+				if (i >= 0 && i < total) chunk.bits[i >> 6] |= (uint64_t(1) << (i & 63));
+			}
+		}
+
+		chunk.dirty = false;
+	}
+
+} // namespace WanderSpire
@@ -0,0 +1,9 @@
+#version 330 core
+
+in vec4 v_Color;
+out vec4 FragColor;
+
+void main() {
+    // straight alpha, for GL_SRC_ALPHA / GL_ONE_MINUS_SRC_ALPHA blending
+    FragColor = v_Color;
+}
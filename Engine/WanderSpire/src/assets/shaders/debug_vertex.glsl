@@ -0,0 +1,35 @@
+#version 330 core
+
+// — lines (per vertex) —
+layout(location = 0) in vec2 a_Position;
+// — lines: per vertex, quads: per instance —
+layout(location = 1) in vec4 a_Color;
+// — quads (per instance) —
+layout(location = 2) in vec4 a_QuadRect;       // centre.xy, half size.zw
+layout(location = 3) in float a_QuadRotation;  // radians
+
+// — per-view data, shared by all shaders (FrameUniforms) —
+layout(std140) uniform FrameData {
+    mat4 u_ViewProjection;
+    vec4 u_Viewport;
+    vec4 u_Time;
+};
+
+uniform bool u_Quads;   // 1: instanced triangle strip, corners from gl_VertexID
+
+out vec4 v_Color;
+
+void main() {
+    vec2 worldPos = a_Position;
+
+    if (u_Quads) {
+        vec2 corner = vec2((gl_VertexID & 1) != 0 ? 1.0 : -1.0,
+                           (gl_VertexID & 2) != 0 ? 1.0 : -1.0) * a_QuadRect.zw;
+        float c = cos(a_QuadRotation);
+        float s = sin(a_QuadRotation);
+        worldPos = a_QuadRect.xy + vec2(c * corner.x - s * corner.y, s * corner.x + c * corner.y);
+    }
+
+    gl_Position = u_ViewProjection * vec4(worldPos, 0.0, 1.0);
+    v_Color     = a_Color;
+}
@@ -1,14 +1,21 @@
 ﻿#version 330 core
 
 in vec2 v_TexCoord;
+in float v_Layer;
 out vec4 FragColor;
 
 uniform sampler2D u_Texture;
 uniform vec3      u_Color;
 uniform bool      u_UseTexture;
 
+// — atlas pages as one texture array (unit 1) —
+uniform sampler2DArray u_TextureArray;
+uniform bool           u_UseTextureArray;
+
 void main() {
-    if (u_UseTexture) {
+    if (u_UseTexture && u_UseTextureArray) {
+        FragColor = texture(u_TextureArray, vec3(v_TexCoord, v_Layer));
+    } else if (u_UseTexture) {
         FragColor = texture(u_Texture, v_TexCoord);
     } else {
         FragColor = vec4(u_Color, 1.0);
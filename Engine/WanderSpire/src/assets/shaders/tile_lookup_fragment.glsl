@@ -0,0 +1,44 @@
+#version 330 core
+
+in vec2 v_Local;
+flat in ivec2 v_Region;
+out vec4 FragColor;
+
+// — tile ids, a chunkSize² region per chunk (unit 2) —
+uniform isampler2D u_TileIndex;
+// — two texels per tile id: uv offset.xy and size.zw, then page (unit 3) —
+uniform sampler2D  u_TileLookup;
+uniform int        u_ChunkSize;
+uniform int        u_Page;          // page drawn by this pass; -1 draws every page
+
+// — atlas: one page (unit 0) or every page as a texture array (unit 1) —
+uniform sampler2D      u_Texture;
+uniform sampler2DArray u_TextureArray;
+uniform bool           u_UseTextureArray;
+
+const int IDS_PER_ROW = 256;
+
+void main() {
+    ivec2 tile = clamp(ivec2(floor(v_Local)), ivec2(0), ivec2(u_ChunkSize - 1));
+    int id = texelFetch(u_TileIndex, v_Region + tile, 0).r;
+    if (id < 0) discard;
+
+    ivec2 entry = ivec2((id % IDS_PER_ROW) * 2, id / IDS_PER_ROW);
+    if (entry.y >= textureSize(u_TileLookup, 0).y) discard;
+    vec4 frame = texelFetch(u_TileLookup, entry, 0);
+    if (frame.z <= 0.0 || frame.w <= 0.0) discard;   // no frame for this id
+
+    int page = int(texelFetch(u_TileLookup, entry + ivec2(1, 0), 0).r);
+    if (u_Page >= 0 && page != u_Page) discard;
+
+    // Gradients of the continuous coordinate, so tile edges keep the mip level
+    vec2 uv = frame.xy + (v_Local - vec2(tile)) * frame.zw;
+    vec2 dx = dFdx(v_Local) * frame.zw;
+    vec2 dy = dFdy(v_Local) * frame.zw;
+
+    if (u_UseTextureArray) {
+        FragColor = textureGrad(u_TextureArray, vec3(uv, float(page)), dx, dy);
+    } else {
+        FragColor = textureGrad(u_Texture, uv, dx, dy);
+    }
+}
@@ -0,0 +1,26 @@
+#version 330 core
+
+// — per instance: one quad per chunk —
+layout(location = 0) in vec4 a_Chunk;   // world origin.xy, origin of its index texture region.zw (texels)
+
+// — per-view data, shared by all shaders (FrameUniforms) —
+layout(std140) uniform FrameData {
+    mat4 u_ViewProjection;
+    vec4 u_Viewport;
+    vec4 u_Time;
+};
+
+uniform int   u_ChunkSize;   // tiles per chunk side
+uniform float u_TileSize;
+
+out vec2 v_Local;            // tiles from the chunk's origin
+flat out ivec2 v_Region;
+
+void main() {
+    // Triangle strip: corners from gl_VertexID
+    vec2 corner = vec2(gl_VertexID & 1, (gl_VertexID >> 1) & 1);
+    v_Local  = corner * float(u_ChunkSize);
+    v_Region = ivec2(a_Chunk.zw);
+
+    gl_Position = u_ViewProjection * vec4(a_Chunk.xy + v_Local * u_TileSize, 0.0, 1.0);
+}
@@ -8,20 +8,29 @@ layout(location = 1) in vec2 a_TexCoord;
 layout(location = 2) in vec2 a_InstancePos;
 layout(location = 3) in vec2 a_InstanceUVOffset;
 layout(location = 4) in vec2 a_InstanceUVSize;
+layout(location = 5) in float a_InstanceLayer;   // atlas page, when pages form a texture array
+
+// — per-view data, shared by all shaders (FrameUniforms) —
+layout(std140) uniform FrameData {
+    mat4 u_ViewProjection;
+    vec4 u_Viewport;
+    vec4 u_Time;
+};
 
 // — shared uniforms —
-uniform mat4  u_ViewProjection;
 uniform bool  u_UseInstancing;   // 1 for terrain, 0 for sprites
 
 // — legacy (sprites only) —
 uniform mat4  u_Model;
 uniform vec2  u_UVOffset;
 uniform vec2  u_UVSize;
+uniform float u_Layer;
 
 // — instancing helper —
 uniform float u_TileSize;
 
 out vec2 v_TexCoord;
+out float v_Layer;
 
 void main() {
     vec2 worldPos;
@@ -33,11 +42,13 @@ void main() {
         worldPos = a_InstancePos + a_Position.xy * u_TileSize;
         uvOff    = a_InstanceUVOffset;
         uvSz     = a_InstanceUVSize;
+        v_Layer  = a_InstanceLayer;
     } else {
         // sprite path
         worldPos = (u_Model * vec4(a_Position,1.0)).xy;
         uvOff    = u_UVOffset;
         uvSz     = u_UVSize;
+        v_Layer  = u_Layer;
     }
 
     gl_Position = u_ViewProjection * vec4(worldPos, 0.0, 1.0);
@@ -74,6 +74,92 @@ extern "C" {
 		long peakMemoryUsed;
 	} PerformanceMetrics;
 
+	/// Per-frame data streamed through the ring buffer
+	typedef struct {
+		int64_t bytesLastFrame;
+		int64_t instanceBytes;      ///< Last frame, per stream
+		int64_t spriteBytes;
+		int64_t debugBytes;
+		int64_t bytesTotal;
+		int64_t allocations;
+		int64_t failedAllocations;
+		int64_t stalls;             ///< Waits for the GPU to release ring space
+		double stallMicros;
+		int64_t wraps;
+		int64_t capacity;
+		int framesInFlight;
+		int persistent;             ///< 1 if persistently mapped
+	} RenderStreamStats;
+
+	/// GL state cache counters. Per-kind order: program, vertex array, buffer,
+	/// texture, capability, blend, depth, scissor, viewport, framebuffer, clear color
+	typedef struct {
+		int64_t requested;          ///< State changes asked of the cache
+		int64_t skipped;            ///< Of which redundant, never reaching GL
+		int64_t queries;            ///< glGet* issued to learn unknown state
+		int64_t invalidations;
+		int64_t requestedByKind[11];
+		int64_t skippedByKind[11];
+	} GLStateCacheStats;
+
+	/// Render thread counters; times in microseconds, averages smoothed over recent frames
+	typedef struct {
+		int threaded;               ///< 1 if frames are drawn on a dedicated render thread
+		int64_t framesSubmitted;
+		int64_t framesPresented;
+		int64_t contextBorrows;     ///< Times other GL work took the context from the render thread
+		double lastRenderMicros;
+		double averageRenderMicros;
+		double averageBuildMicros;  ///< Time spent building a frame before submitting it
+		double lastPaceWaitMicros;
+		double paceWaitMicros;      ///< Total time the game thread waited for the render thread
+	} RenderThreadReport;
+
+	/// How a generated atlas was packed
+	typedef struct {
+		int images;
+		int pages;
+		int rejected;               ///< Images larger than a page, left out
+		int64_t usedArea;           ///< Image pixels
+		int64_t pageArea;           ///< Page pixels
+		double efficiency;          ///< usedArea / pageArea
+		int textureArray;           ///< 1 if the pages are one GL_TEXTURE_2D_ARRAY
+		int batchesPerPass;         ///< Texture binds to draw frames from every page
+		int cached;                 ///< 1 if the atlas from the last build was reused unchanged
+	} AtlasPackReport;
+
+	/// Debug primitives for Engine_DebugDrawBatch. Colours are straight-alpha
+	/// 0xAARRGGBB; duration is in seconds, 0 draws once, INFINITY until cleared.
+	typedef struct {
+		float x1, y1, x2, y2;
+		uint32_t colour;
+		float width;                ///< World units; up to 1 draws a one-pixel line
+		float duration;
+	} DebugLinePrimitive;
+
+	typedef struct {
+		float x, y;                 ///< Bottom-left corner
+		float width, height;
+		uint32_t colour;
+		int filled;
+		float duration;
+	} DebugRectPrimitive;
+
+	typedef struct {
+		float x, y, radius;
+		uint32_t colour;
+		int segments;
+		float duration;
+	} DebugCirclePrimitive;
+
+	/// What the last frame's debug geometry took
+	typedef struct {
+		int lines;
+		int quads;
+		int persistent;             ///< Primitives kept alive by their duration
+		int drawCalls;              ///< At most 2: all lines, then all quads
+	} DebugDrawReport;
+
 	/// Profiling section result
 	typedef struct {
 		char name[64];
@@ -278,6 +364,8 @@ extern "C" {
 	// PATHFINDING API
 	//=============================================================================
 
+	/// Searches on the calling thread and returns the path as JSON. Agents that
+	/// move every frame should use Path_Request, which runs within the budget.
 	ENGINE_API char* Engine_FindPath(
 		EngineContextHandle h,
 		int startX, int startY,
@@ -293,8 +381,104 @@ extern "C" {
 		EntityId tilemapLayer
 	);
 
+	/// Returns 1 if a walkable route can exist between the two tiles, 0 if they
+	/// lie in disconnected regions. Pass WS_INVALID_ENTITY to auto-find the layer.
+	ENGINE_API int Engine_AreConnected(
+		EngineContextHandle h,
+		int ax, int ay,
+		int bx, int by,
+		EntityId tilemapLayer
+	);
+
+	/// Cost-aware path (tile definition costs + overlays); same JSON format as
+	/// Engine_FindPath. Pass WS_INVALID_ENTITY to auto-find the layer.
+	ENGINE_API char* Engine_FindWeightedPath(
+		EngineContextHandle h,
+		int startX, int startY,
+		int targetX, int targetY,
+		int maxRange,
+		EntityId tilemapLayer
+	);
+
+	/// Override one tile's movement cost (0 blocks, 10 = plain ground)
+	ENGINE_API void Engine_SetMovementCostOverlay(
+		EngineContextHandle h,
+		int x, int y,
+		int cost
+	);
+
+	ENGINE_API void Engine_ClearMovementCostOverlay(
+		EngineContextHandle h,
+		int x, int y
+	);
+
+	/// Queue a path search served within the per-frame budget. The result
+	/// arrives as a PathAppliedEvent carrying the returned request id (0 on
+	/// failure). A new request for the same entity supersedes its pending one.
+	ENGINE_API uint32_t Path_Request(
+		EngineContextHandle h,
+		EntityId entity,
+		int startX, int startY,
+		int targetX, int targetY,
+		int maxRange,
+		EntityId tilemapLayer,
+		int weighted,
+		int priority,
+		uint32_t deadlineMicros
+	);
+
+	ENGINE_API int Path_Cancel(EngineContextHandle h, uint32_t requestId);
+	ENGINE_API int Path_CancelForEntity(EngineContextHandle h, EntityId entity);
+	ENGINE_API int Path_GetPendingCount(EngineContextHandle h);
+	/// Path search time per frame for this context only
+	ENGINE_API void Path_SetFrameBudget(EngineContextHandle h, uint32_t budgetMicros);
+
 	ENGINE_API void Engine_FreeString(char* str);
 
+	//=============================================================================
+	// VISIBILITY API
+	//=============================================================================
+
+	/// Bytes needed for one FOV mask: (2r+1)² bits, row-major from (ox-r, oy-r)
+	ENGINE_API int Visibility_GetFOVMaskSize(int radius);
+
+	/// Shadowcast FOV for one observer. Returns the visible tile count, or -1 if
+	/// the mask buffer is too small. Pass WS_INVALID_ENTITY to auto-find the layer.
+	ENGINE_API int Visibility_ComputeFOV(
+		EngineContextHandle ctx,
+		EntityId tilemapLayer,
+		int originX, int originY,
+		int radius,
+		uint8_t* outMask, int maskSize
+	);
+
+	/// FOV for many observers (x,y pairs) in one call; mask i starts at
+	/// outMasks + i * maskStride. Returns observers processed or -1.
+	ENGINE_API int Visibility_ComputeFOVBatch(
+		EngineContextHandle ctx,
+		EntityId tilemapLayer,
+		const int* observersXY, int observerCount,
+		int radius,
+		uint8_t* outMasks, int maskStride
+	);
+
+	ENGINE_API int Visibility_HasLineOfSight(
+		EngineContextHandle ctx,
+		EntityId tilemapLayer,
+		int fromX, int fromY,
+		int toX, int toY
+	);
+
+	/// Line of sight for (fromX, fromY, toX, toY) quadruples; pairs farther than
+	/// maxDistance (if > 0) fail. Writes 0/1 per pair, returns the visible count.
+	ENGINE_API int Visibility_HasLineOfSightBatch(
+		EngineContextHandle ctx,
+		EntityId tilemapLayer,
+		const int* pairs, int pairCount,
+		float maxDistance,
+		uint8_t* outVisible
+	);
+
 	//=============================================================================
 	// SCENE MANAGEMENT API
 	//=============================================================================
@@ -627,6 +811,10 @@ extern "C" {
 	ENGINE_API void TilemapLayer_SetSortOrder(EngineContextHandle ctx, EntityId layer, int sortOrder);
 	ENGINE_API void TilemapLayer_Reorder(EngineContextHandle ctx, EntityId layer, int newSortOrder);
 
+	/// Draw the layer from a GPU index texture (one quad per chunk) instead of per-tile instances
+	ENGINE_API void TilemapLayer_SetTileLookup(EngineContextHandle ctx, EntityId layer, int enabled);
+	ENGINE_API int TilemapLayer_GetTileLookup(EngineContextHandle ctx, EntityId layer);
+
 	ENGINE_API int TilemapLayer_GetPaintable(
 		EngineContextHandle ctx,
 		uint32_t* outLayers,
@@ -767,6 +955,18 @@ extern "C" {
 		const char* frameName
 	);
 
+	ENGINE_API void TileDef_SetBlocksVision(
+		EngineContextHandle ctx,
+		int tileId,
+		int blocksVision
+	);
+
+	ENGINE_API void TileDef_SetMovementCost(
+		EngineContextHandle ctx,
+		int tileId,
+		int movementCost
+	);
+
 	ENGINE_API int TileDef_GetCount(EngineContextHandle ctx);
 	ENGINE_API void TileDef_Clear(EngineContextHandle ctx);
 
@@ -797,6 +997,7 @@ extern "C" {
 	// TILEMAP ANALYSIS API
 	//=============================================================================
 
+	/// Exact bounds of the layer's non-empty tiles; returns 0 if the layer is empty
 	ENGINE_API int Tilemap_GetBounds(
 		EngineContextHandle ctx,
 		EntityId tilemapLayer,
@@ -811,6 +1012,8 @@ extern "C" {
 		int maxX, int maxY
 	);
 
+	/// Writes up to maxPositions (x, y) pairs into outPositions (2 * maxPositions ints);
+	/// returns the number of positions found
 	ENGINE_API int Tilemap_FindTilePositions(
 		EngineContextHandle ctx,
 		EntityId tilemapLayer,
@@ -828,6 +1031,156 @@ extern "C" {
 		int maxX, int maxY
 	);
 
+	//=============================================================================
+	// TILEMAP CHANGE JOURNAL API
+	//=============================================================================
+
+	/// One journaled edit: tiles in [min, max] (tile coords, inclusive) of a chunk changed
+	typedef struct {
+		uint64_t sequence;
+		uint64_t chunkVersion;
+		uint32_t layer;
+		int chunkX, chunkY;
+		int minX, minY, maxX, maxY;
+		int removed;            ///< Chunk was unloaded
+	} TilemapChangeRecord;
+
+	/// Start reading changes from now on; returns a subscriber id (0 on failure)
+	ENGINE_API uint32_t TileJournal_Subscribe(EngineContextHandle ctx);
+	ENGINE_API void TileJournal_Unsubscribe(EngineContextHandle ctx, uint32_t subscriber);
+
+	/// Copy up to maxRecords changes since the subscriber's last poll; returns the
+	/// number written. *outOverflowed is set to 1 when older changes were lost and
+	/// the caller must rebuild whatever it derives from the tilemap.
+	ENGINE_API int TileJournal_Poll(
+		EngineContextHandle ctx,
+		uint32_t subscriber,
+		TilemapChangeRecord* outRecords,
+		int maxRecords,
+		int* outOverflowed
+	);
+
+	ENGINE_API void TileJournal_SetCapacity(EngineContextHandle ctx, int records);
+
+	/// Version of a chunk's latest change (0 = not loaded or never edited)
+	ENGINE_API uint64_t Tilemap_GetChunkVersion(
+		EngineContextHandle ctx,
+		EntityId tilemapLayer,
+		int chunkX, int chunkY
+	);
+
+	//=============================================================================
+	// TILEMAP CHUNK CACHE API
+	//=============================================================================
+
+	/// Compressed cache of recently unloaded chunks (hit rate = hits / (hits + misses))
+	typedef struct {
+		uint64_t hits;
+		uint64_t misses;
+		uint64_t stores;
+		uint64_t evictions;
+		int64_t entries;
+		int64_t bytes;            ///< Compressed bytes held
+		int64_t rawBytes;         ///< Same chunks as flat arrays
+		int64_t budgetBytes;
+		double avgStoreMicros;    ///< Mean compression time per stored chunk
+		double avgRestoreMicros;  ///< Mean decompression time per hit
+	} TilemapChunkCacheStats;
+
+	ENGINE_API void Tilemap_GetChunkCacheStats(EngineContextHandle ctx, TilemapChunkCacheStats* outStats);
+	ENGINE_API void Tilemap_ResetChunkCacheStats(EngineContextHandle ctx);
+
+	/// Byte budget shared by all cached chunks; 0 disables the cache
+	ENGINE_API void Tilemap_SetChunkCacheBudget(EngineContextHandle ctx, int64_t bytes);
+
+	//=============================================================================
+	// PROCEDURAL CHUNK GENERATION API
+	//=============================================================================
+
+	/// Pattern stamped onto generated terrain
+	typedef struct {
+		int width, height;
+		const int* tiles;           ///< width*height, row-major; -1 keeps the terrain
+		int onTileId;               ///< Required anchor tile (-1 = any)
+		float density;              ///< Chance per anchor tile
+	} ChunkGenStamp;
+
+	/// Built-in generator: fractal noise height thresholded into bands, then stamps
+	typedef struct {
+		uint64_t seed;
+		int noiseType;              ///< 0 = value noise, 1 = simplex
+		float frequency;
+		int octaves;
+		float persistence;
+		float lacunarity;
+		const float* bandMaxHeights;  ///< Heights in [-1, 1], ascending
+		const int* bandTileIds;
+		int bandCount;
+		int fallbackTileId;
+		const ChunkGenStamp* stamps;
+		int stampCount;
+	} NoiseChunkGeneratorDesc;
+
+	/// Generate chunks of this layer on worker threads as streaming loads them; returns 1 on success
+	ENGINE_API int Tilemap_SetNoiseGenerator(EngineContextHandle ctx, EntityId tilemapLayer,
+		const NoiseChunkGeneratorDesc* desc);
+	ENGINE_API void Tilemap_ClearGenerator(EngineContextHandle ctx, EntityId tilemapLayer);
+
+	/// Chunks queued or being generated
+	ENGINE_API int Tilemap_GetPendingGeneration(EngineContextHandle ctx);
+
+	/// Wait for every queued chunk and install it now; returns how many were installed
+	ENGINE_API int Tilemap_DrainGeneration(EngineContextHandle ctx);
+
+	/// Worker threads (0 = automatic)
+	ENGINE_API void Tilemap_SetGenerationThreads(EngineContextHandle ctx, int threads);
+
+	/// Write a layer's loaded chunks to a binary tilemap file; returns 1 on success
+	ENGINE_API int Tilemap_SaveLayerFile(EngineContextHandle ctx, EntityId tilemapLayer, const char* path);
+
+	/// Memory-map a binary tilemap file as the layer's chunk source; returns 1 on success
+	ENGINE_API int Tilemap_OpenLayerFile(EngineContextHandle ctx, EntityId tilemapLayer, const char* path);
+	ENGINE_API void Tilemap_CloseLayerFile(EngineContextHandle ctx, EntityId tilemapLayer);
+
+	//=============================================================================
+	// TILE ATTRIBUTE API
+	//=============================================================================
+
+	/// Channel types: 0 = uint8, 1 = uint16, 2 = float, 3 = flag (1 bit)
+	/// Comparisons:   0 ==, 1 !=, 2 <, 3 <=, 4 >, 5 >=
+	/// Rectangles are inclusive and row-major
+
+	typedef struct {
+		float min;
+		float max;
+		double sum;
+		int64_t count;            ///< Tiles covered
+	} TileAttributeStats;
+
+	/// Add a named channel to a layer (or get the existing one); returns its id, -1 on failure
+	ENGINE_API int Tilemap_CreateAttributeChannel(EngineContextHandle ctx, EntityId tilemapLayer,
+		const char* name, int type, float defaultValue);
+	ENGINE_API int Tilemap_FindAttributeChannel(EngineContextHandle ctx, EntityId tilemapLayer, const char* name);
+	/// The removed channel's id never addresses a later channel
+	ENGINE_API int Tilemap_RemoveAttributeChannel(EngineContextHandle ctx, EntityId tilemapLayer, int channel);
+
+	ENGINE_API float Tilemap_GetAttribute(EngineContextHandle ctx, EntityId tilemapLayer, int channel, int x, int y);
+	ENGINE_API void Tilemap_SetAttribute(EngineContextHandle ctx, EntityId tilemapLayer, int channel,
+		int x, int y, float value);
+	ENGINE_API void Tilemap_FillAttributeRect(EngineContextHandle ctx, EntityId tilemapLayer, int channel,
+		int minX, int minY, int maxX, int maxY, float value);
+
+	/// Copy values in the channel's own type (flags: one byte per tile); returns 1 on success
+	ENGINE_API int Tilemap_ReadAttributeRect(EngineContextHandle ctx, EntityId tilemapLayer, int channel,
+		int minX, int minY, int maxX, int maxY, void* outValues);
+	ENGINE_API int Tilemap_WriteAttributeRect(EngineContextHandle ctx, EntityId tilemapLayer, int channel,
+		int minX, int minY, int maxX, int maxY, const void* values);
+
+	ENGINE_API void Tilemap_QueryAttributeRect(EngineContextHandle ctx, EntityId tilemapLayer, int channel,
+		int minX, int minY, int maxX, int maxY, TileAttributeStats* outStats);
+	ENGINE_API int64_t Tilemap_CountAttributeWhere(EngineContextHandle ctx, EntityId tilemapLayer, int channel,
+		int minX, int minY, int maxX, int maxY, int compare, float value);
+
 	//=============================================================================
 	// COORDINATE CONVERSION API
 	//=============================================================================
@@ -949,6 +1302,18 @@ extern "C" {
 	ENGINE_API void Engine_DrawDebugRect(EngineContextHandle ctx, float x, float y, float width, float height,
 		float colorR, float colorG, float colorB, int filled);
 
+	/// Queue arrays of debug primitives in one call; any array may be null
+	ENGINE_API void Engine_DebugDrawBatch(EngineContextHandle ctx,
+		const DebugLinePrimitive* lines, int lineCount,
+		const DebugRectPrimitive* rects, int rectCount,
+		const DebugCirclePrimitive* circles, int circleCount);
+
+	/// Drop debug primitives and overlays kept alive by a duration
+	ENGINE_API void Engine_DebugDrawClear(EngineContextHandle ctx);
+
+	/// Get debug draw statistics of the last frame
+	ENGINE_API void Engine_GetDebugDrawStats(EngineContextHandle ctx, DebugDrawReport* outReport);
+
 	//=============================================================================
 	// PERFORMANCE AND PROFILING
 	//=============================================================================
@@ -956,6 +1321,36 @@ extern "C" {
 	/// Get detailed performance metrics
 	ENGINE_API void Engine_GetPerformanceMetrics(EngineContextHandle ctx, PerformanceMetrics* outMetrics);
 
+	/// Get stream buffer upload and stall counters
+	ENGINE_API void Engine_GetRenderStreamStats(EngineContextHandle ctx, RenderStreamStats* outStats);
+
+	/// Reset the stream buffer counters
+	ENGINE_API void Engine_ResetRenderStreamStats(EngineContextHandle ctx);
+
+	/// Get redundant GL state change counters
+	ENGINE_API void Engine_GetGLStateCacheStats(EngineContextHandle ctx, GLStateCacheStats* outStats);
+
+	/// Reset the GL state cache counters
+	ENGINE_API void Engine_ResetGLStateCacheStats(EngineContextHandle ctx);
+
+	/// Forget the cached GL state; call after GL code outside the engine changed it
+	ENGINE_API void Engine_InvalidateGLStateCache(EngineContextHandle ctx);
+
+	/// Threads building render commands, the main thread included (0 = automatic, 1 = serial)
+	ENGINE_API void Engine_SetRenderPrepThreads(EngineContextHandle ctx, int threads);
+
+	/// Draw and present frames on a dedicated render thread (standalone only). Returns 1 if threaded
+	ENGINE_API int Engine_SetRenderThreadEnabled(EngineContextHandle ctx, int enabled);
+
+	/// Get render thread pacing and timing counters
+	ENGINE_API void Engine_GetRenderThreadStats(EngineContextHandle ctx, RenderThreadReport* outStats);
+
+	/// Reset the render thread counters
+	ENGINE_API void Engine_ResetRenderThreadStats(EngineContextHandle ctx);
+
+	/// Get the packing report of a generated atlas. Returns 0 if it was not generated
+	ENGINE_API int Engine_GetAtlasPackReport(EngineContextHandle ctx, const char* atlasName, AtlasPackReport* outReport);
+
 	/// Start performance profiling section
 	ENGINE_API void Engine_BeginProfileSection(EngineContextHandle ctx, const char* name);
 
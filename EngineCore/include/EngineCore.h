@@ -19,13 +19,6 @@ namespace WanderSpire { struct AppState; }
 /*──────── per-context data ──────────────────────────────────────────*/
 namespace EngineCoreInternal {
 
-	/* Primitive used by the managed-overlay renderer */
-	struct OverlayRect
-	{
-		float x, y, w, h;
-		uint32_t colour;
-	};
-
 	struct Wrapper
 	{
 		/* filled by WanderSpire::Application --------------------------- */
@@ -18,11 +18,26 @@
 #include "WanderSpire/Editor/EditorGlobals.h"
 #include "WanderSpire/World/TilemapSystem.h"
 #include "WanderSpire/World/Pathfinder2D.h"
+#include "WanderSpire/World/VisibilityMap.h"
+#include "WanderSpire/World/MovementCostField.h"
+#include "WanderSpire/World/PathRequestService.h"
+#include "WanderSpire/World/TilemapChangeJournal.h"
+#include "WanderSpire/World/ChunkEvictionCache.h"
+#include "WanderSpire/World/ChunkGenerationService.h"
+#include "WanderSpire/World/TileAttributes.h"
 #include <WanderSpire/Components/AllComponents.h>
 #include <WanderSpire/Components/ScriptDataComponent.h>
 #include <WanderSpire/Graphics/SpriteRenderer.h>
 #include "WanderSpire/Editor/SceneHierarchyManager.h"
 #include "WanderSpire/Graphics/RenderManager.h"
+#include "WanderSpire/Graphics/DebugDraw.h"
+#include "WanderSpire/Graphics/FrameUniforms.h"
+#include "WanderSpire/Graphics/StreamBuffer.h"
+#include "WanderSpire/Graphics/GLStateCache.h"
+#include "WanderSpire/Graphics/RenderJobPool.h"
+#include "WanderSpire/Graphics/RenderThread.h"
+#include "WanderSpire/Graphics/RenderResourceManager.h"
+#include "WanderSpire/Systems/AnimatedTileSystem.h"
 #include "WanderSpire/Components/IDComponent.h"
 
 #include <glm/vec2.hpp>
@@ -119,10 +134,6 @@ static OpenGLState g_glState;
 static WS_RunInContext g_runInCtx = nullptr;
 static EditorCameraState g_editorCamera;
 
-using EngineCoreInternal::OverlayRect;
-static std::mutex                     gOverlayMx;
-static std::vector<OverlayRect>       gOverlays;
-
 //──────────────── helper ────────────────────────────────────────────────
 static inline WanderSpire::AppState* asAppState(Wrapper* w) {
 	return static_cast<WanderSpire::AppState*>(w->appState);
@@ -216,40 +227,27 @@ findField(const char* comp, const char* field, const Reflect::TypeInfo** outTI =
 
 /* ─────────────── Overlay helpers ─────────────────────────────────────── */
 
-/* helper – decode premultiplied 0xAARRGGBB into linear vec3 */
-static glm::vec3 DecodeColour(uint32_t rgba)
+/* helper – decode straight-alpha 0xAARRGGBB into a vec4 */
+static glm::vec4 DecodeColour(uint32_t argb)
 {
-	const float a = ((rgba >> 24) & 0xFF) / 255.f;
-	const float r = ((rgba >> 16) & 0xFF) / 255.f * a;
-	const float g = ((rgba >> 8) & 0xFF) / 255.f * a;
-	const float b = (rgba & 0xFF) / 255.f * a;
-	return { r,g,b };
+	return { ((argb >> 16) & 0xFF) / 255.f, ((argb >> 8) & 0xFF) / 255.f,
+		(argb & 0xFF) / 255.f, ((argb >> 24) & 0xFF) / 255.f };
 }
 
+/* draw the debug geometry gathered so far, overlays included, in two draws */
 static void FlushOverlayBatch()
 {
-	/* copy under lock */
-	std::vector<OverlayRect> snapshot;
-	{
-		std::scoped_lock lk(gOverlayMx);
-		if (gOverlays.empty())
-			return;
-		snapshot = gOverlays;            // deep-copy, leave the source intact
-	}
-
-	auto& renderer = WanderSpire::SpriteRenderer::Get();
-	auto& cam = WanderSpire::Application::GetCamera();
-
-	renderer.BeginFrame(cam.GetViewProjectionMatrix());
-	for (auto const& r : snapshot)
-		renderer.DrawSprite(
-			/*textureID*/ 0,
-			/*centre   */{ r.x, r.y },
-			/*size     */{ r.w, r.h },
-			/*rot      */ 0.f,
-			/*colour   */ DecodeColour(r.colour),
-			/*UVs      */{ 0.f, 0.f }, { 1.f, 1.f });
-	renderer.EndFrame();
+	auto command = WanderSpire::DebugDraw::Get().BuildCommand();
+	if (!command)
+		return;
+
+	/* the render thread holds the context – draw with the next frame instead */
+	if (!WanderSpire::RenderThread::Get().OwnsContext()) {
+		WanderSpire::RenderManager::Get().Submit(std::move(command));
+		return;
+	}
+	WanderSpire::FrameUniforms::Get().BeginView(WanderSpire::Application::GetCamera().GetViewProjectionMatrix());
+	command->Execute();
 }
 
 // Helper to convert an std::vector<glm::ivec2> → JSON string.
@@ -295,7 +293,19 @@ static void WireUpScriptEventForwarding(Wrapper* w, EngineContextHandle vmHandle
 	w->scriptEventSubscriptions.emplace_back(
 		bus.Subscribe<PathAppliedEvent>(
 			[vmHandle](auto const& ev) {
-				Script_PublishEvent(vmHandle, "PathAppliedEvent", &ev, sizeof(ev));
+				// Flat layout matching the managed PathAppliedEvent struct
+				struct {
+					uint32_t          entity;
+					const glm::ivec2* checkpoints;
+					int               checkpointCount;
+					uint32_t          requestId;
+				} payload{
+					static_cast<uint32_t>(ev.entity),
+					ev.checkpoints.data(),
+					static_cast<int>(ev.checkpoints.size()),
+					ev.requestId
+				};
+				Script_PublishEvent(vmHandle, "PathAppliedEvent", &payload, sizeof(payload));
 			}));
 	w->scriptEventSubscriptions.emplace_back(
 		bus.Subscribe<AnimationFinishedEvent>(
@@ -1106,8 +1116,7 @@ extern "C" {
 
 	ENGINE_API void Engine_OverlayClear(EngineContextHandle /*ctx*/)
 	{
-		std::scoped_lock lk(gOverlayMx);
-		gOverlays.clear();
+		WanderSpire::DebugDraw::Get().Clear();
 	}
 
 	ENGINE_API void Engine_OverlayRect(EngineContextHandle /*ctx*/,
@@ -1115,8 +1124,9 @@ extern "C" {
 		float w, float h,
 		uint32_t colour)
 	{
-		std::scoped_lock lk(gOverlayMx);
-		gOverlays.push_back({ wx,wy,w,h,colour });
+		/* centred at (wx, wy); stays until Engine_OverlayClear */
+		WanderSpire::DebugDraw::Get().Quad({ wx, wy }, { w, h }, 0.f, DecodeColour(colour),
+			WanderSpire::DebugDraw::UNTIL_CLEARED);
 	}
 
 	ENGINE_API void Engine_OverlayPresent(void)
@@ -1228,10 +1238,255 @@ extern "C" {
 		return _marshalPathToJson(result.fullPath);
 	}
 
+	ENGINE_API int Engine_AreConnected(
+		EngineContextHandle h,
+		int                 ax,
+		int                 ay,
+		int                 bx,
+		int                 by,
+		EntityId            tilemapLayer)
+	{
+		auto* w = GetWrapper(h);
+		if (!w) return 1;
+
+		auto& registry = w->reg();
+		entt::entity layerEntity = is_null(tilemapLayer.id)
+			? entt::entity{ entt::null }
+			: static_cast<entt::entity>(tilemapLayer.id);
+
+		return WanderSpire::Pathfinder2D::AreConnected(
+			registry, layerEntity, glm::ivec2{ ax, ay }, glm::ivec2{ bx, by }) ? 1 : 0;
+	}
+
+	ENGINE_API char* Engine_FindWeightedPath(
+		EngineContextHandle h,
+		int                 startX,
+		int                 startY,
+		int                 targetX,
+		int                 targetY,
+		int                 maxRange,
+		EntityId            tilemapLayer)
+	{
+		auto* w = GetWrapper(h);
+		if (!w) return _marshalPathToJson({});
+
+		auto& registry = w->reg();
+		entt::entity layerEntity = is_null(tilemapLayer.id)
+			? entt::entity{ entt::null }
+			: static_cast<entt::entity>(tilemapLayer.id);
+
+		auto result = WanderSpire::Pathfinder2D::FindWeightedPath(
+			glm::ivec2(startX, startY),
+			glm::ivec2(targetX, targetY),
+			maxRange,
+			registry,
+			layerEntity
+		);
+
+		return _marshalPathToJson(result.fullPath);
+	}
+
+	ENGINE_API void Engine_SetMovementCostOverlay(EngineContextHandle h, int x, int y, int cost)
+	{
+		auto* w = GetWrapper(h);
+		if (!w) return;
+
+		WanderSpire::MovementCostField::GetInstance().SetCostOverlay(
+			w->reg(), glm::ivec2{ x, y }, static_cast<uint8_t>(std::clamp(cost, 0, 255)));
+	}
+
+	ENGINE_API void Engine_ClearMovementCostOverlay(EngineContextHandle h, int x, int y)
+	{
+		auto* w = GetWrapper(h);
+		if (!w) return;
+
+		WanderSpire::MovementCostField::GetInstance().ClearCostOverlay(w->reg(), glm::ivec2{ x, y });
+	}
+
+	ENGINE_API uint32_t Path_Request(
+		EngineContextHandle h,
+		EntityId            entity,
+		int                 startX,
+		int                 startY,
+		int                 targetX,
+		int                 targetY,
+		int                 maxRange,
+		EntityId            tilemapLayer,
+		int                 weighted,
+		int                 priority,
+		uint32_t            deadlineMicros)
+	{
+		auto* w = GetWrapper(h);
+		if (!w) return WanderSpire::PathRequestService::INVALID_REQUEST;
+
+		WanderSpire::PathRequest request;
+		request.entity = is_null(entity.id) ? entt::entity{ entt::null } : static_cast<entt::entity>(entity.id);
+		request.start = { startX, startY };
+		request.target = { targetX, targetY };
+		request.maxRange = maxRange;
+		request.tilemapLayer = is_null(tilemapLayer.id)
+			? entt::entity{ entt::null }
+			: static_cast<entt::entity>(tilemapLayer.id);
+		request.weighted = weighted != 0;
+		request.priority = priority;
+		request.deadlineMicros = deadlineMicros;
+
+		return WanderSpire::PathRequestService::GetInstance().Submit(w->reg(), request);
+	}
+
+	ENGINE_API int Path_Cancel(EngineContextHandle h, uint32_t requestId)
+	{
+		auto* w = GetWrapper(h);
+		if (!w) return 0;
+		return WanderSpire::PathRequestService::GetInstance().Cancel(w->reg(), requestId) ? 1 : 0;
+	}
+
+	ENGINE_API int Path_CancelForEntity(EngineContextHandle h, EntityId entity)
+	{
+		auto* w = GetWrapper(h);
+		if (!w || is_null(entity.id)) return 0;
+		return static_cast<int>(WanderSpire::PathRequestService::GetInstance().CancelForEntity(
+			w->reg(), static_cast<entt::entity>(entity.id)));
+	}
+
+	ENGINE_API int Path_GetPendingCount(EngineContextHandle h)
+	{
+		auto* w = GetWrapper(h);
+		if (!w) return 0;
+		return static_cast<int>(WanderSpire::PathRequestService::GetInstance().GetPendingCount(w->reg()));
+	}
+
+	ENGINE_API void Path_SetFrameBudget(EngineContextHandle h, uint32_t budgetMicros)
+	{
+		auto* w = GetWrapper(h);
+		if (!w) return;
+		WanderSpire::PathRequestService::GetInstance().SetFrameBudget(w->reg(), budgetMicros);
+	}
+
 	ENGINE_API void Engine_FreeString(char* str) {
 		std::free(str);
 	}
 
+	//=============================================================================
+	// VISIBILITY API
+	//=============================================================================
+
+	static entt::entity ResolveVisibilityLayer(entt::registry& registry, EntityId tilemapLayer)
+	{
+		entt::entity layer = is_null(tilemapLayer.id)
+			? entt::entity{ entt::null }
+			: static_cast<entt::entity>(tilemapLayer.id);
+
+		if (layer == entt::null || !registry.valid(layer))
+			layer = WanderSpire::Pathfinder2D::FindFirstTilemapLayer(registry);
+		return layer;
+	}
+
+	ENGINE_API int Visibility_GetFOVMaskSize(int radius)
+	{
+		if (radius < 0) return 0;
+		const int side = radius * 2 + 1;
+		return (side * side + 7) / 8;
+	}
+
+	ENGINE_API int Visibility_ComputeFOV(
+		EngineContextHandle ctx,
+		EntityId            tilemapLayer,
+		int                 originX,
+		int                 originY,
+		int                 radius,
+		uint8_t* outMask,
+		int                 maskSize)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w || !outMask || radius < 0) return -1;
+		if (maskSize < Visibility_GetFOVMaskSize(radius)) return -1;
+
+		auto& registry = w->reg();
+		entt::entity layer = ResolveVisibilityLayer(registry, tilemapLayer);
+
+		WanderSpire::VisibilityBitmap bitmap;
+		WanderSpire::VisibilityMap::GetInstance().ComputeFOV(
+			registry, layer, glm::ivec2{ originX, originY }, radius, bitmap);
+		bitmap.CopyTo(outMask, static_cast<size_t>(maskSize));
+
+		return static_cast<int>(bitmap.Count());
+	}
+
+	ENGINE_API int Visibility_ComputeFOVBatch(
+		EngineContextHandle ctx,
+		EntityId            tilemapLayer,
+		const int* observersXY,
+		int                 observerCount,
+		int                 radius,
+		uint8_t* outMasks,
+		int                 maskStride)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w || !observersXY || !outMasks || observerCount < 0 || radius < 0) return -1;
+		if (maskStride < Visibility_GetFOVMaskSize(radius)) return -1;
+
+		auto& registry = w->reg();
+		entt::entity layer = ResolveVisibilityLayer(registry, tilemapLayer);
+
+		std::vector<glm::ivec2> origins(static_cast<size_t>(observerCount));
+		for (int i = 0; i < observerCount; ++i)
+			origins[i] = { observersXY[i * 2], observersXY[i * 2 + 1] };
+
+		// Reused across calls so steady-state batches do not allocate
+		thread_local std::vector<WanderSpire::VisibilityBitmap> bitmaps;
+		WanderSpire::VisibilityMap::GetInstance().ComputeFOVBatch(
+			registry, layer, origins.data(), origins.size(), radius, bitmaps);
+
+		for (int i = 0; i < observerCount; ++i)
+			bitmaps[i].CopyTo(outMasks + static_cast<size_t>(i) * maskStride, static_cast<size_t>(maskStride));
+
+		return observerCount;
+	}
+
+	ENGINE_API int Visibility_HasLineOfSight(
+		EngineContextHandle ctx,
+		EntityId            tilemapLayer,
+		int                 fromX,
+		int                 fromY,
+		int                 toX,
+		int                 toY)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w) return 0;
+
+		auto& registry = w->reg();
+		entt::entity layer = ResolveVisibilityLayer(registry, tilemapLayer);
+
+		return WanderSpire::VisibilityMap::GetInstance().HasLineOfSight(
+			registry, layer, glm::ivec2{ fromX, fromY }, glm::ivec2{ toX, toY }) ? 1 : 0;
+	}
+
+	ENGINE_API int Visibility_HasLineOfSightBatch(
+		EngineContextHandle ctx,
+		EntityId            tilemapLayer,
+		const int* pairs,
+		int                 pairCount,
+		float               maxDistance,
+		uint8_t* outVisible)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w || !pairs || !outVisible || pairCount <= 0) return 0;
+
+		auto& registry = w->reg();
+		entt::entity layer = ResolveVisibilityLayer(registry, tilemapLayer);
+
+		std::vector<glm::ivec2> from(static_cast<size_t>(pairCount));
+		std::vector<glm::ivec2> to(static_cast<size_t>(pairCount));
+		for (int i = 0; i < pairCount; ++i) {
+			from[i] = { pairs[i * 4 + 0], pairs[i * 4 + 1] };
+			to[i] = { pairs[i * 4 + 2], pairs[i * 4 + 3] };
+		}
+
+		return static_cast<int>(WanderSpire::VisibilityMap::GetInstance().HasLineOfSightBatch(
+			registry, layer, from.data(), to.data(), from.size(), maxDistance, outVisible));
+	}
+
 	//=============================================================================
 	// SCENE MANAGEMENT API
 	//=============================================================================
@@ -1489,6 +1744,9 @@ extern "C" {
 
 		ImGui::Render();
 		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+		// The ImGui backend changes GL state directly, bypassing the state cache
+		WanderSpire::GL::StateCache::Get().Invalidate();
 	}
 
 	ENGINE_API int ImGui_WantCaptureMouse(EngineContextHandle h)
@@ -1827,8 +2085,7 @@ extern "C" {
 		entt::entity layer = static_cast<entt::entity>(tilemapLayer.id);
 
 		if (registry.valid(layer)) {
-			WanderSpire::TilemapSystem::GetInstance().FloodFill(registry, layer, { startX, startY }, newTileId);
-			return 1; // TODO: Return actual count of affected tiles
+			return static_cast<int>(WanderSpire::TilemapSystem::GetInstance().FloodFill(registry, layer, { startX, startY }, newTileId));
 		}
 
 		return 0;
@@ -2390,6 +2647,29 @@ extern "C" {
 		TilemapLayer_SetSortOrder(ctx, layer, newSortOrder);
 	}
 
+	ENGINE_API void TilemapLayer_SetTileLookup(EngineContextHandle ctx, EntityId layer, int enabled) {
+		auto* w = GetWrapper(ctx);
+		if (!w) return;
+
+		auto& registry = w->reg();
+		entt::entity layerEntity = static_cast<entt::entity>(layer.id);
+
+		if (ValidateLayer(registry, layerEntity)) {
+			registry.get<WanderSpire::TilemapLayerComponent>(layerEntity).tileLookup = enabled != 0;
+		}
+	}
+
+	ENGINE_API int TilemapLayer_GetTileLookup(EngineContextHandle ctx, EntityId layer) {
+		auto* w = GetWrapper(ctx);
+		if (!w) return 0;
+
+		auto& registry = w->reg();
+		entt::entity layerEntity = static_cast<entt::entity>(layer.id);
+
+		if (!ValidateLayer(registry, layerEntity)) return 0;
+		return registry.get<WanderSpire::TilemapLayerComponent>(layerEntity).tileLookup ? 1 : 0;
+	}
+
 	ENGINE_API int TilemapLayer_GetPaintable(
 		EngineContextHandle ctx,
 		uint32_t* outLayers,
@@ -2817,6 +3097,24 @@ extern "C" {
 		tileDefManager.SetDefaultDefinition(atlasName, frameName);
 	}
 
+	ENGINE_API void TileDef_SetBlocksVision(
+		EngineContextHandle ctx,
+		int tileId,
+		int blocksVision)
+	{
+		auto& tileDefManager = WanderSpire::TileDefinitionManager::GetInstance();
+		tileDefManager.SetTileBlocksVision(tileId, blocksVision != 0);
+	}
+
+	ENGINE_API void TileDef_SetMovementCost(
+		EngineContextHandle ctx,
+		int tileId,
+		int movementCost)
+	{
+		auto& tileDefManager = WanderSpire::TileDefinitionManager::GetInstance();
+		tileDefManager.SetTileMovementCost(tileId, static_cast<uint8_t>(std::clamp(movementCost, 1, 255)));
+	}
+
 	ENGINE_API int TileDef_GetCount(EngineContextHandle ctx) {
 		auto& tileDefManager = WanderSpire::TileDefinitionManager::GetInstance();
 		return static_cast<int>(tileDefManager.GetTileCount());
@@ -2908,12 +3206,13 @@ extern "C" {
 
 		if (!ValidateLayer(registry, layer)) return 0;
 
-		// This would need to be implemented by scanning through chunks
-		// For now, return a default large area
-		if (outMinX) *outMinX = -100;
-		if (outMinY) *outMinY = -100;
-		if (outMaxX) *outMaxX = 100;
-		if (outMaxY) *outMaxY = 100;
+		glm::ivec2 min, max;
+		if (!WanderSpire::TilemapSystem::GetInstance().GetLayerBounds(registry, layer, min, max)) return 0;
+
+		if (outMinX) *outMinX = min.x;
+		if (outMinY) *outMinY = min.y;
+		if (outMaxX) *outMaxX = max.x;
+		if (outMaxY) *outMaxY = max.y;
 
 		return 1;
 	}
@@ -2932,18 +3231,8 @@ extern "C" {
 
 		if (!ValidateLayer(registry, layer)) return 0;
 
-		auto& tilemapSystem = WanderSpire::TilemapSystem::GetInstance();
-		int count = 0;
-
-		for (int y = minY; y <= maxY; ++y) {
-			for (int x = minX; x <= maxX; ++x) {
-				if (tilemapSystem.GetTile(registry, layer, { x, y }) != -1) {
-					count++;
-				}
-			}
-		}
-
-		return count;
+		return static_cast<int>(WanderSpire::TilemapSystem::GetInstance().CountTilesInRect(
+			registry, layer, { minX, minY }, { maxX, maxY }));
 	}
 
 	ENGINE_API int Tilemap_FindTilePositions(
@@ -2961,9 +3250,15 @@ extern "C" {
 
 		if (!ValidateLayer(registry, layer)) return 0;
 
-		// This would need to scan through all loaded chunks
-		// For now, return empty result
-		return 0;
+		std::vector<glm::ivec2> positions(static_cast<size_t>(maxPositions));
+		const size_t found = WanderSpire::TilemapSystem::GetInstance().FindTilePositions(
+			registry, layer, tileId, positions.data(), positions.size());
+
+		for (size_t i = 0; i < found; ++i) {
+			outPositions[i * 2] = positions[i].x;
+			outPositions[i * 2 + 1] = positions[i].y;
+		}
+		return static_cast<int>(found);
 	}
 
 	ENGINE_API int Tilemap_ReplaceTiles(
@@ -2982,19 +3277,340 @@ extern "C" {
 
 		if (!ValidateLayer(registry, layer)) return 0;
 
-		auto& tilemapSystem = WanderSpire::TilemapSystem::GetInstance();
-		int replacedCount = 0;
+		return static_cast<int>(WanderSpire::TilemapSystem::GetInstance().ReplaceInRect(
+			registry, layer, { minX, minY }, { maxX, maxY }, oldTileId, newTileId));
+	}
 
-		for (int y = minY; y <= maxY; ++y) {
-			for (int x = minX; x <= maxX; ++x) {
-				if (tilemapSystem.GetTile(registry, layer, { x, y }) == oldTileId) {
-					tilemapSystem.SetTile(registry, layer, { x, y }, newTileId);
-					replacedCount++;
-				}
+	//=============================================================================
+	// TILEMAP CHANGE JOURNAL API IMPLEMENTATION
+	//=============================================================================
+
+	ENGINE_API uint32_t TileJournal_Subscribe(EngineContextHandle ctx)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w) return 0;
+
+		return WanderSpire::TilemapChangeJournal::GetInstance().Subscribe(w->reg());
+	}
+
+	ENGINE_API void TileJournal_Unsubscribe(EngineContextHandle ctx, uint32_t subscriber)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w) return;
+
+		WanderSpire::TilemapChangeJournal::GetInstance().Unsubscribe(w->reg(), subscriber);
+	}
+
+	ENGINE_API int TileJournal_Poll(
+		EngineContextHandle ctx,
+		uint32_t subscriber,
+		TilemapChangeRecord* outRecords,
+		int maxRecords,
+		int* outOverflowed)
+	{
+		if (outOverflowed) *outOverflowed = 0;
+		auto* w = GetWrapper(ctx);
+		if (!w || !outRecords || maxRecords <= 0) return 0;
+
+		std::vector<WanderSpire::TileChangeRecord> records;
+		records.reserve(static_cast<size_t>(maxRecords));
+		const bool complete = WanderSpire::TilemapChangeJournal::GetInstance().Poll(
+			w->reg(), subscriber, records, static_cast<size_t>(maxRecords));
+		if (!complete && outOverflowed) *outOverflowed = 1;
+
+		for (size_t i = 0; i < records.size(); ++i) {
+			const auto& r = records[i];
+			TilemapChangeRecord& out = outRecords[i];
+			out.sequence = r.sequence;
+			out.chunkVersion = r.chunkVersion;
+			out.layer = entt::to_integral(r.layer);
+			out.chunkX = r.chunkCoords.x;
+			out.chunkY = r.chunkCoords.y;
+			out.minX = r.min.x;
+			out.minY = r.min.y;
+			out.maxX = r.max.x;
+			out.maxY = r.max.y;
+			out.removed = r.removed ? 1 : 0;
+		}
+		return static_cast<int>(records.size());
+	}
+
+	ENGINE_API void TileJournal_SetCapacity(EngineContextHandle ctx, int records)
+	{
+		if (records <= 0) return;
+		WanderSpire::TilemapChangeJournal::GetInstance().SetCapacity(static_cast<size_t>(records));
+	}
+
+	ENGINE_API uint64_t Tilemap_GetChunkVersion(
+		EngineContextHandle ctx,
+		EntityId tilemapLayer,
+		int chunkX, int chunkY)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w) return 0;
+
+		auto& registry = w->reg();
+		entt::entity layer = static_cast<entt::entity>(tilemapLayer.id);
+
+		if (!ValidateLayer(registry, layer)) return 0;
+
+		return WanderSpire::TilemapSystem::GetInstance().GetChunkVersion(registry, layer, { chunkX, chunkY });
+	}
+
+	//=============================================================================
+	// TILEMAP CHUNK CACHE API IMPLEMENTATION
+	//=============================================================================
+
+	ENGINE_API void Tilemap_GetChunkCacheStats(EngineContextHandle ctx, TilemapChunkCacheStats* outStats)
+	{
+		if (!outStats) return;
+		*outStats = {};
+		auto* w = GetWrapper(ctx);
+		if (!w) return;
+
+		auto& cache = WanderSpire::ChunkEvictionCache::GetInstance();
+		const WanderSpire::ChunkCacheStats stats = cache.GetStats(w->reg());
+		outStats->hits = stats.hits;
+		outStats->misses = stats.misses;
+		outStats->stores = stats.stores;
+		outStats->evictions = stats.evictions;
+		outStats->entries = static_cast<int64_t>(stats.entries);
+		outStats->bytes = static_cast<int64_t>(stats.bytes);
+		outStats->rawBytes = static_cast<int64_t>(stats.rawBytes);
+		outStats->budgetBytes = static_cast<int64_t>(cache.GetBudget());
+		outStats->avgStoreMicros = stats.stores ? stats.storeNanos / 1000.0 / stats.stores : 0.0;
+		outStats->avgRestoreMicros = stats.hits ? stats.restoreNanos / 1000.0 / stats.hits : 0.0;
+	}
+
+	ENGINE_API void Tilemap_ResetChunkCacheStats(EngineContextHandle ctx)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w) return;
+
+		WanderSpire::ChunkEvictionCache::GetInstance().ResetStats(w->reg());
+	}
+
+	ENGINE_API void Tilemap_SetChunkCacheBudget(EngineContextHandle ctx, int64_t bytes)
+	{
+		if (bytes < 0) return;
+		WanderSpire::ChunkEvictionCache::GetInstance().SetBudget(static_cast<size_t>(bytes));
+	}
+
+	//=============================================================================
+	// PROCEDURAL CHUNK GENERATION API IMPLEMENTATION
+	//=============================================================================
+
+	ENGINE_API int Tilemap_SetNoiseGenerator(EngineContextHandle ctx, EntityId tilemapLayer,
+		const NoiseChunkGeneratorDesc* desc)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w || !desc) return 0;
+
+		auto& registry = w->reg();
+		entt::entity layer = static_cast<entt::entity>(tilemapLayer.id);
+
+		if (!ValidateLayer(registry, layer)) return 0;
+
+		using Generator = WanderSpire::NoiseChunkGenerator;
+		Generator::Settings settings;
+		settings.noise = desc->noiseType == 0 ? Generator::NoiseType::Value : Generator::NoiseType::Simplex;
+		settings.frequency = desc->frequency;
+		settings.octaves = desc->octaves;
+		settings.persistence = desc->persistence;
+		settings.lacunarity = desc->lacunarity;
+		settings.fallbackTileId = desc->fallbackTileId;
+
+		if (desc->bandCount > 0 && desc->bandMaxHeights && desc->bandTileIds) {
+			for (int i = 0; i < desc->bandCount; ++i) {
+				settings.bands.push_back({ desc->bandMaxHeights[i], desc->bandTileIds[i] });
 			}
 		}
+		if (desc->stampCount > 0 && desc->stamps) {
+			for (int i = 0; i < desc->stampCount; ++i) {
+				const ChunkGenStamp& in = desc->stamps[i];
+				if (!in.tiles || in.width <= 0 || in.height <= 0) continue;
+				Generator::Stamp stamp;
+				stamp.width = in.width;
+				stamp.height = in.height;
+				stamp.tiles.assign(in.tiles, in.tiles + in.width * in.height);
+				stamp.onTileId = in.onTileId;
+				stamp.density = in.density;
+				settings.stamps.push_back(std::move(stamp));
+			}
+		}
+
+		WanderSpire::ChunkGenerationService::GetInstance().SetGenerator(registry, layer,
+			std::make_shared<Generator>(std::move(settings)), desc->seed);
+		return 1;
+	}
+
+	ENGINE_API void Tilemap_ClearGenerator(EngineContextHandle ctx, EntityId tilemapLayer)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w) return;
+
+		WanderSpire::ChunkGenerationService::GetInstance().ClearGenerator(
+			w->reg(), static_cast<entt::entity>(tilemapLayer.id));
+	}
+
+	ENGINE_API int Tilemap_GetPendingGeneration(EngineContextHandle ctx)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w) return 0;
+
+		return static_cast<int>(WanderSpire::ChunkGenerationService::GetInstance().GetPendingCount(w->reg()));
+	}
+
+	ENGINE_API int Tilemap_DrainGeneration(EngineContextHandle ctx)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w) return 0;
+
+		return static_cast<int>(WanderSpire::ChunkGenerationService::GetInstance().Drain(w->reg()));
+	}
+
+	ENGINE_API void Tilemap_SetGenerationThreads(EngineContextHandle ctx, int threads)
+	{
+		if (threads < 0) return;
+		WanderSpire::ChunkGenerationService::GetInstance().SetThreadCount(static_cast<unsigned>(threads));
+	}
+
+	ENGINE_API int Tilemap_SaveLayerFile(EngineContextHandle ctx, EntityId tilemapLayer, const char* path)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w || !path) return 0;
+
+		auto& registry = w->reg();
+		auto layer = static_cast<entt::entity>(tilemapLayer.id);
+		if (!ValidateLayer(registry, layer)) return 0;
+
+		return WanderSpire::TilemapSystem::GetInstance().SaveLayerFile(registry, layer, path) ? 1 : 0;
+	}
+
+	ENGINE_API int Tilemap_OpenLayerFile(EngineContextHandle ctx, EntityId tilemapLayer, const char* path)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w || !path) return 0;
+
+		auto& registry = w->reg();
+		auto layer = static_cast<entt::entity>(tilemapLayer.id);
+		if (!ValidateLayer(registry, layer)) return 0;
+
+		return WanderSpire::TilemapSystem::GetInstance().OpenLayerFile(registry, layer, path) ? 1 : 0;
+	}
+
+	ENGINE_API void Tilemap_CloseLayerFile(EngineContextHandle ctx, EntityId tilemapLayer)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w) return;
+
+		WanderSpire::TilemapSystem::GetInstance().CloseLayerFile(w->reg(), static_cast<entt::entity>(tilemapLayer.id));
+	}
+
+	//=============================================================================
+	// TILE ATTRIBUTE API IMPLEMENTATION
+	//=============================================================================
+
+	ENGINE_API int Tilemap_CreateAttributeChannel(EngineContextHandle ctx, EntityId tilemapLayer,
+		const char* name, int type, float defaultValue)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w || !name || type < 0 || type > static_cast<int>(WanderSpire::TileAttributeType::Flag)) return -1;
+
+		auto& registry = w->reg();
+		auto layer = static_cast<entt::entity>(tilemapLayer.id);
+		if (!ValidateLayer(registry, layer)) return -1;
+
+		return WanderSpire::TileAttributes::GetInstance().CreateChannel(registry, layer, name,
+			static_cast<WanderSpire::TileAttributeType>(type), defaultValue);
+	}
+
+	ENGINE_API int Tilemap_FindAttributeChannel(EngineContextHandle ctx, EntityId tilemapLayer, const char* name)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w || !name) return -1;
+
+		return WanderSpire::TileAttributes::GetInstance().FindChannel(w->reg(), static_cast<entt::entity>(tilemapLayer.id), name);
+	}
+
+	ENGINE_API int Tilemap_RemoveAttributeChannel(EngineContextHandle ctx, EntityId tilemapLayer, int channel)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w) return 0;
+
+		return WanderSpire::TileAttributes::GetInstance().RemoveChannel(w->reg(), static_cast<entt::entity>(tilemapLayer.id), channel) ? 1 : 0;
+	}
+
+	ENGINE_API float Tilemap_GetAttribute(EngineContextHandle ctx, EntityId tilemapLayer, int channel, int x, int y)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w) return 0.0f;
+
+		return WanderSpire::TileAttributes::GetInstance().Get(w->reg(), static_cast<entt::entity>(tilemapLayer.id), channel, { x, y });
+	}
+
+	ENGINE_API void Tilemap_SetAttribute(EngineContextHandle ctx, EntityId tilemapLayer, int channel,
+		int x, int y, float value)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w) return;
+
+		WanderSpire::TileAttributes::GetInstance().Set(w->reg(), static_cast<entt::entity>(tilemapLayer.id), channel, { x, y }, value);
+	}
+
+	ENGINE_API void Tilemap_FillAttributeRect(EngineContextHandle ctx, EntityId tilemapLayer, int channel,
+		int minX, int minY, int maxX, int maxY, float value)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w) return;
+
+		WanderSpire::TileAttributes::GetInstance().FillRect(w->reg(), static_cast<entt::entity>(tilemapLayer.id), channel,
+			{ minX, minY }, { maxX, maxY }, value);
+	}
+
+	ENGINE_API int Tilemap_ReadAttributeRect(EngineContextHandle ctx, EntityId tilemapLayer, int channel,
+		int minX, int minY, int maxX, int maxY, void* outValues)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w || !outValues) return 0;
+
+		return WanderSpire::TileAttributes::GetInstance().ReadRectRaw(w->reg(), static_cast<entt::entity>(tilemapLayer.id), channel,
+			{ minX, minY }, { maxX, maxY }, outValues) ? 1 : 0;
+	}
+
+	ENGINE_API int Tilemap_WriteAttributeRect(EngineContextHandle ctx, EntityId tilemapLayer, int channel,
+		int minX, int minY, int maxX, int maxY, const void* values)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w || !values) return 0;
+
+		return WanderSpire::TileAttributes::GetInstance().WriteRectRaw(w->reg(), static_cast<entt::entity>(tilemapLayer.id), channel,
+			{ minX, minY }, { maxX, maxY }, values) ? 1 : 0;
+	}
 
-		return replacedCount;
+	ENGINE_API void Tilemap_QueryAttributeRect(EngineContextHandle ctx, EntityId tilemapLayer, int channel,
+		int minX, int minY, int maxX, int maxY, TileAttributeStats* outStats)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w || !outStats) return;
+
+		const auto stats = WanderSpire::TileAttributes::GetInstance().QueryRect(w->reg(), static_cast<entt::entity>(tilemapLayer.id),
+			channel, { minX, minY }, { maxX, maxY });
+		outStats->min = stats.min;
+		outStats->max = stats.max;
+		outStats->sum = stats.sum;
+		outStats->count = static_cast<int64_t>(stats.count);
+	}
+
+	ENGINE_API int64_t Tilemap_CountAttributeWhere(EngineContextHandle ctx, EntityId tilemapLayer, int channel,
+		int minX, int minY, int maxX, int maxY, int compare, float value)
+	{
+		auto* w = GetWrapper(ctx);
+		if (!w || compare < 0 || compare > static_cast<int>(WanderSpire::TileAttributeCompare::GreaterEqual)) return 0;
+
+		return static_cast<int64_t>(WanderSpire::TileAttributes::GetInstance().CountWhere(w->reg(),
+			static_cast<entt::entity>(tilemapLayer.id), channel, { minX, minY }, { maxX, maxY },
+			static_cast<WanderSpire::TileAttributeCompare>(compare), value));
 	}
 
 	//=============================================================================
@@ -3048,7 +3664,7 @@ extern "C" {
 		g_editorState.editorRenderFlags = flags;
 
 		// Initialize editor-specific rendering
-		glViewport(0, 0, width, height);
+		WanderSpire::GL::StateCache::Get().Viewport(0, 0, width, height);
 
 		spdlog::info("[Editor] Initialized editor mode: {}x{}, flags: {}", width, height, flags);
 		return 0;
@@ -3059,7 +3675,7 @@ extern "C" {
 
 		g_editorState.viewportWidth = width;
 		g_editorState.viewportHeight = height;
-		glViewport(0, 0, width, height);
+		WanderSpire::GL::StateCache::Get().Viewport(0, 0, width, height);
 
 		// Update camera aspect ratio
 		WanderSpire::Application::GetCamera().SetScreenSize(static_cast<float>(width), static_cast<float>(height));
@@ -3403,67 +4019,60 @@ extern "C" {
 		float colorR, float colorG, float colorB, float width) {
 		if (!ctx) return;
 
-		// Submit debug line to render manager
-		auto& renderMgr = WanderSpire::RenderManager::Get();
-		renderMgr.SubmitCustom([x1, y1, x2, y2, colorR, colorG, colorB, width]() {
-			auto& renderer = WanderSpire::SpriteRenderer::Get();
-
-			// Calculate line properties
-			glm::vec2 start(x1, y1);
-			glm::vec2 end(x2, y2);
-			glm::vec2 center = (start + end) * 0.5f;
-			glm::vec2 diff = end - start;
-			float length = glm::length(diff);
-			float angle = std::atan2(diff.y, diff.x);
-
-			// Draw line as stretched quad
-			renderer.DrawSprite(0, center, { length, width }, angle,
-				{ colorR, colorG, colorB }, { 0, 0 }, { 1, 1 });
-			}, WanderSpire::RenderLayer::Debug);
+		// Batched with all other debug geometry; up to 1 unit wide is a hairline
+		WanderSpire::DebugDraw::Get().Line({ x1, y1 }, { x2, y2 }, { colorR, colorG, colorB, 1.0f }, width);
 	}
 
 	ENGINE_API void Engine_DrawDebugCircle(EngineContextHandle ctx, float centerX, float centerY, float radius,
 		float colorR, float colorG, float colorB, int segments) {
 		if (!ctx || segments < 3) return;
 
-		// Draw circle as line segments
-		float angleStep = 2.0f * M_PI / segments;
-		for (int i = 0; i < segments; ++i) {
-			float angle1 = i * angleStep;
-			float angle2 = (i + 1) * angleStep;
-
-			float x1 = centerX + radius * std::cos(angle1);
-			float y1 = centerY + radius * std::sin(angle1);
-			float x2 = centerX + radius * std::cos(angle2);
-			float y2 = centerY + radius * std::sin(angle2);
-
-			Engine_DrawDebugLine(ctx, x1, y1, x2, y2, colorR, colorG, colorB, 1.0f);
-		}
+		WanderSpire::DebugDraw::Get().Circle({ centerX, centerY }, radius, { colorR, colorG, colorB, 1.0f }, segments);
 	}
 
 	ENGINE_API void Engine_DrawDebugRect(EngineContextHandle ctx, float x, float y, float width, float height,
 		float colorR, float colorG, float colorB, int filled) {
 		if (!ctx) return;
 
-		if (filled) {
-			// Draw filled rectangle
-			auto& renderMgr = WanderSpire::RenderManager::Get();
-			renderMgr.SubmitCustom([x, y, width, height, colorR, colorG, colorB]() {
-				auto& renderer = WanderSpire::SpriteRenderer::Get();
-				glm::vec2 center(x + width * 0.5f, y + height * 0.5f);
-				renderer.DrawSprite(0, center, { width, height }, 0.0f,
-					{ colorR, colorG, colorB }, { 0, 0 }, { 1, 1 });
-				}, WanderSpire::RenderLayer::Debug);
+		WanderSpire::DebugDraw::Get().Rect({ x, y }, { width, height }, { colorR, colorG, colorB, 1.0f }, filled != 0);
+	}
+
+	ENGINE_API void Engine_DebugDrawBatch(EngineContextHandle ctx,
+		const DebugLinePrimitive* lines, int lineCount,
+		const DebugRectPrimitive* rects, int rectCount,
+		const DebugCirclePrimitive* circles, int circleCount) {
+		if (!ctx) return;
+
+		auto& debugDraw = WanderSpire::DebugDraw::Get();
+		for (int i = 0; lines && i < lineCount; ++i) {
+			const auto& l = lines[i];
+			debugDraw.Line({ l.x1, l.y1 }, { l.x2, l.y2 }, DecodeColour(l.colour), l.width, l.duration);
 		}
-		else {
-			// Draw outline rectangle
-			Engine_DrawDebugLine(ctx, x, y, x + width, y, colorR, colorG, colorB, 1.0f);
-			Engine_DrawDebugLine(ctx, x + width, y, x + width, y + height, colorR, colorG, colorB, 1.0f);
-			Engine_DrawDebugLine(ctx, x + width, y + height, x, y + height, colorR, colorG, colorB, 1.0f);
-			Engine_DrawDebugLine(ctx, x, y + height, x, y, colorR, colorG, colorB, 1.0f);
+		for (int i = 0; rects && i < rectCount; ++i) {
+			const auto& r = rects[i];
+			debugDraw.Rect({ r.x, r.y }, { r.width, r.height }, DecodeColour(r.colour), r.filled != 0, r.duration);
+		}
+		for (int i = 0; circles && i < circleCount; ++i) {
+			const auto& c = circles[i];
+			debugDraw.Circle({ c.x, c.y }, c.radius, DecodeColour(c.colour), c.segments, c.duration);
 		}
 	}
 
+	ENGINE_API void Engine_DebugDrawClear(EngineContextHandle ctx) {
+		if (!ctx) return;
+		WanderSpire::DebugDraw::Get().Clear();
+	}
+
+	ENGINE_API void Engine_GetDebugDrawStats(EngineContextHandle ctx, DebugDrawReport* outReport) {
+		if (!ctx || !outReport) return;
+
+		const auto stats = WanderSpire::DebugDraw::Get().GetStats();
+		outReport->lines = static_cast<int>(stats.lines);
+		outReport->quads = static_cast<int>(stats.quads);
+		outReport->persistent = static_cast<int>(stats.persistent);
+		outReport->drawCalls = static_cast<int>(stats.drawCalls);
+	}
+
 	//=============================================================================
 	// PERFORMANCE AND PROFILING
 	//=============================================================================
@@ -3486,6 +4095,118 @@ extern "C" {
 		outMetrics->peakMemoryUsed = 0; // TODO: Implement
 	}
 
+	ENGINE_API void Engine_GetRenderStreamStats(EngineContextHandle ctx, RenderStreamStats* outStats) {
+		if (!ctx || !outStats) return;
+
+		const auto& stats = WanderSpire::StreamBuffer::Get().GetStats();
+		auto usage = [&](WanderSpire::StreamUsage u) {
+			return static_cast<int64_t>(stats.bytesLastFrameByUsage[static_cast<size_t>(u)]);
+		};
+		outStats->bytesLastFrame = static_cast<int64_t>(stats.bytesLastFrame);
+		outStats->instanceBytes = usage(WanderSpire::StreamUsage::Instance);
+		outStats->spriteBytes = usage(WanderSpire::StreamUsage::Sprite);
+		outStats->debugBytes = usage(WanderSpire::StreamUsage::Debug);
+		outStats->bytesTotal = static_cast<int64_t>(stats.bytesTotal);
+		outStats->allocations = static_cast<int64_t>(stats.allocations);
+		outStats->failedAllocations = static_cast<int64_t>(stats.failedAllocations);
+		outStats->stalls = static_cast<int64_t>(stats.stalls);
+		outStats->stallMicros = stats.stallMicros;
+		outStats->wraps = static_cast<int64_t>(stats.wraps);
+		outStats->capacity = static_cast<int64_t>(stats.capacity);
+		outStats->framesInFlight = static_cast<int>(stats.framesInFlight);
+		outStats->persistent = stats.persistent ? 1 : 0;
+	}
+
+	ENGINE_API void Engine_ResetRenderStreamStats(EngineContextHandle ctx) {
+		if (!ctx) return;
+		WanderSpire::StreamBuffer::Get().ResetStats();
+	}
+
+	ENGINE_API void Engine_GetGLStateCacheStats(EngineContextHandle ctx, GLStateCacheStats* outStats) {
+		if (!ctx || !outStats) return;
+
+		using WanderSpire::GL::StateCacheStats;
+		static_assert(StateCacheStats::KINDS == sizeof(outStats->requestedByKind) / sizeof(int64_t));
+
+		const auto& stats = WanderSpire::GL::StateCache::Get().GetStats();
+		outStats->requested = static_cast<int64_t>(stats.TotalRequested());
+		outStats->skipped = static_cast<int64_t>(stats.TotalSkipped());
+		outStats->queries = static_cast<int64_t>(stats.queries);
+		outStats->invalidations = static_cast<int64_t>(stats.invalidations);
+		for (size_t i = 0; i < StateCacheStats::KINDS; ++i) {
+			outStats->requestedByKind[i] = static_cast<int64_t>(stats.requested[i]);
+			outStats->skippedByKind[i] = static_cast<int64_t>(stats.skipped[i]);
+		}
+	}
+
+	ENGINE_API void Engine_ResetGLStateCacheStats(EngineContextHandle ctx) {
+		if (!ctx) return;
+		WanderSpire::GL::StateCache::Get().ResetStats();
+	}
+
+	ENGINE_API void Engine_InvalidateGLStateCache(EngineContextHandle ctx) {
+		if (!ctx) return;
+		WanderSpire::GL::StateCache::Get().Invalidate();
+	}
+
+	ENGINE_API void Engine_SetRenderPrepThreads(EngineContextHandle ctx, int threads) {
+		if (!ctx || threads < 0) return;
+		WanderSpire::RenderJobPool::Get().SetThreadCount(static_cast<unsigned>(threads));
+	}
+
+	ENGINE_API int Engine_SetRenderThreadEnabled(EngineContextHandle ctx, int enabled) {
+		if (!ctx) return 0;
+
+		auto& renderThread = WanderSpire::RenderThread::Get();
+		if (!enabled) {
+			renderThread.Stop();
+			return 0;
+		}
+		if (WanderSpire::Application::IsEditorMode()) {
+			spdlog::warn("[RenderThread] The editor renders on its own thread; not starting a render thread");
+			return 0;
+		}
+		return renderThread.Start() ? 1 : 0;
+	}
+
+	ENGINE_API void Engine_GetRenderThreadStats(EngineContextHandle ctx, RenderThreadReport* outStats) {
+		if (!ctx || !outStats) return;
+
+		const auto stats = WanderSpire::RenderThread::Get().GetStats();
+		outStats->threaded = stats.threaded ? 1 : 0;
+		outStats->framesSubmitted = static_cast<int64_t>(stats.framesSubmitted);
+		outStats->framesPresented = static_cast<int64_t>(stats.framesPresented);
+		outStats->contextBorrows = static_cast<int64_t>(stats.contextBorrows);
+		outStats->lastRenderMicros = stats.lastRenderMicros;
+		outStats->averageRenderMicros = stats.averageRenderMicros;
+		outStats->averageBuildMicros = stats.averageBuildMicros;
+		outStats->lastPaceWaitMicros = stats.lastPaceWaitMicros;
+		outStats->paceWaitMicros = stats.paceWaitMicros;
+	}
+
+	ENGINE_API void Engine_ResetRenderThreadStats(EngineContextHandle ctx) {
+		if (!ctx) return;
+		WanderSpire::RenderThread::Get().ResetStats();
+	}
+
+	ENGINE_API int Engine_GetAtlasPackReport(EngineContextHandle ctx, const char* atlasName, AtlasPackReport* outReport) {
+		if (!ctx || !atlasName || !outReport) return 0;
+
+		const auto* report = WanderSpire::RenderResourceManager::Get().GetAtlasReport(atlasName);
+		if (!report) return 0;
+
+		outReport->images = static_cast<int>(report->images);
+		outReport->pages = static_cast<int>(report->pages);
+		outReport->rejected = static_cast<int>(report->rejected);
+		outReport->usedArea = static_cast<int64_t>(report->usedArea);
+		outReport->pageArea = static_cast<int64_t>(report->pageArea);
+		outReport->efficiency = report->efficiency;
+		outReport->textureArray = report->textureArray ? 1 : 0;
+		outReport->batchesPerPass = static_cast<int>(report->batchesPerPass);
+		outReport->cached = report->cached ? 1 : 0;
+		return 1;
+	}
+
 	ENGINE_API void Engine_BeginProfileSection(EngineContextHandle ctx, const char* name) {
 		if (!ctx || !name) return;
 
@@ -3714,8 +4435,10 @@ extern "C" {
 			return -2;
 		}
 
-		// Initialize OpenGL state
-		glGetIntegerv(GL_FRAMEBUFFER_BINDING, reinterpret_cast<GLint*>(&g_glState.currentFramebuffer));
+		// Initialize OpenGL state; whatever the cache knew may belong to another context
+		auto& glStateCache = WanderSpire::GL::StateCache::Get();
+		glStateCache.Invalidate();
+		g_glState.currentFramebuffer = glStateCache.GetFramebuffer(GL_DRAW_FRAMEBUFFER);
 
 		spdlog::info("[OpenGL] Shared context initialized successfully");
 		return 0;
@@ -3728,13 +4451,14 @@ extern "C" {
 			return 0;
 		}
 
+		WanderSpire::RenderThread::ContextScope glContext;
+
 		using namespace WanderSpire::GL;
 
 		// Generate framebuffer
 		GLuint fbo;
 		glGenFramebuffers(1, &fbo);
-		VertexArrayBinder fboBinder(fbo);
-		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+		FramebufferBinder fboBinder(fbo);
 
 		// Create color texture
 		GLuint colorTexture;
@@ -3766,6 +4490,9 @@ extern "C" {
 		GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
 		if (status != GL_FRAMEBUFFER_COMPLETE) {
 			spdlog::error("[OpenGL] Framebuffer incomplete: {}", status);
+			StateCache::Get().ForgetFramebuffer(fbo);
+			StateCache::Get().ForgetTexture(colorTexture);
+			StateCache::Get().ForgetTexture(depthTexture);
 			glDeleteFramebuffers(1, &fbo);
 			glDeleteTextures(1, &colorTexture);
 			glDeleteTextures(1, &depthTexture);
@@ -3790,9 +4517,12 @@ extern "C" {
 
 		if (!ctx || framebuffer == 0) return;
 
+		WanderSpire::RenderThread::ContextScope glContext;
+
 		auto fboIt = g_glState.framebuffers.find(framebuffer);
 		if (fboIt != g_glState.framebuffers.end()) {
 			GLuint fbo = fboIt->second;
+			WanderSpire::GL::StateCache::Get().ForgetFramebuffer(fbo);
 			glDeleteFramebuffers(1, &fbo);
 			g_glState.framebuffers.erase(fboIt);
 		}
@@ -3800,6 +4530,7 @@ extern "C" {
 		auto colorIt = g_glState.colorTextures.find(framebuffer);
 		if (colorIt != g_glState.colorTextures.end()) {
 			GLuint tex = colorIt->second;
+			WanderSpire::GL::StateCache::Get().ForgetTexture(tex);
 			glDeleteTextures(1, &tex);
 			g_glState.colorTextures.erase(colorIt);
 		}
@@ -3807,6 +4538,7 @@ extern "C" {
 		auto depthIt = g_glState.depthTextures.find(framebuffer);
 		if (depthIt != g_glState.depthTextures.end()) {
 			GLuint tex = depthIt->second;
+			WanderSpire::GL::StateCache::Get().ForgetTexture(tex);
 			glDeleteTextures(1, &tex);
 			g_glState.depthTextures.erase(depthIt);
 		}
@@ -3819,6 +4551,8 @@ extern "C" {
 
 		if (!ctx || framebuffer == 0 || newWidth <= 0 || newHeight <= 0) return -1;
 
+		WanderSpire::RenderThread::ContextScope glContext;
+
 		using namespace WanderSpire::GL;
 
 		auto colorIt = g_glState.colorTextures.find(framebuffer);
@@ -3847,6 +4581,8 @@ extern "C" {
 	ENGINE_API void Engine_SetRenderTarget(EngineContextHandle ctx, uint32_t framebuffer, int width, int height) {
 		if (!ctx) return;
 
+		WanderSpire::RenderThread::ContextScope glContext;
+
 		GLuint fbo = 0;
 		if (framebuffer != 0) {
 			auto it = g_glState.framebuffers.find(framebuffer);
@@ -3855,8 +4591,9 @@ extern "C" {
 			}
 		}
 
-		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-		glViewport(0, 0, width, height);
+		auto& glStateCache = WanderSpire::GL::StateCache::Get();
+		glStateCache.BindFramebuffer(GL_FRAMEBUFFER, fbo);
+		glStateCache.Viewport(0, 0, width, height);
 		g_glState.currentFramebuffer = fbo;
 		g_glState.viewportWidth = width;
 		g_glState.viewportHeight = height;
@@ -3867,7 +4604,10 @@ extern "C" {
 	ENGINE_API void Engine_RestoreDefaultFramebuffer(EngineContextHandle ctx) {
 		if (!ctx) return;
 
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		WanderSpire::RenderThread::ContextScope glContext;
+
+		auto& glStateCache = WanderSpire::GL::StateCache::Get();
+		glStateCache.BindFramebuffer(GL_FRAMEBUFFER, 0);
 		g_glState.currentFramebuffer = 0;
 
 		// Get window size for viewport
@@ -3875,7 +4615,7 @@ extern "C" {
 		if (window) {
 			int w, h;
 			SDL_GetWindowSizeInPixels(window, &w, &h);
-			glViewport(0, 0, w, h);
+			glStateCache.Viewport(0, 0, w, h);
 			g_glState.viewportWidth = w;
 			g_glState.viewportHeight = h;
 		}
@@ -3886,6 +4626,8 @@ extern "C" {
 	ENGINE_API void Engine_RenderToTarget(EngineContextHandle ctx, EngineContextHandle nativeWindow, int width, int height) {
 		if (!ctx) return;
 
+		WanderSpire::RenderThread::ContextScope glContext;
+
 		auto* w = static_cast<Wrapper*>(ctx);
 
 		// Clear the current render target
@@ -3914,6 +4656,8 @@ extern "C" {
 
 		if (!ctx) return;
 
+		WanderSpire::RenderThread::ContextScope glContext;
+
 		GLuint srcGL = 0, dstGL = 0;
 
 		if (srcFBO != 0) {
@@ -3930,14 +4674,15 @@ extern "C" {
 			}
 		}
 
-		glBindFramebuffer(GL_READ_FRAMEBUFFER, srcGL);
-		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, dstGL);
+		auto& glStateCache = WanderSpire::GL::StateCache::Get();
+		glStateCache.BindFramebuffer(GL_READ_FRAMEBUFFER, srcGL);
+		glStateCache.BindFramebuffer(GL_DRAW_FRAMEBUFFER, dstGL);
 
 		glBlitFramebuffer(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1,
 			mask, filter);
 
 		// Restore previous framebuffer
-		glBindFramebuffer(GL_FRAMEBUFFER, g_glState.currentFramebuffer);
+		glStateCache.BindFramebuffer(GL_FRAMEBUFFER, g_glState.currentFramebuffer);
 
 		spdlog::debug("[OpenGL] Blitted framebuffer {} to {}", srcFBO, dstFBO);
 	}
@@ -4137,7 +4882,7 @@ extern "C" {
 	ENGINE_API void Engine_SetEditorViewport(EngineContextHandle ctx, int x, int y, int width, int height) {
 		if (!ctx) return;
 
-		glViewport(x, y, width, height);
+		WanderSpire::GL::StateCache::Get().Viewport(x, y, width, height);
 		g_editorState.viewportWidth = width;
 		g_editorState.viewportHeight = height;
 
@@ -4148,6 +4893,8 @@ extern "C" {
 	ENGINE_API void Engine_RenderSceneWithOverlays(EngineContextHandle ctx) {
 		if (!ctx) return;
 
+		WanderSpire::RenderThread::ContextScope glContext;
+
 		auto* w = static_cast<Wrapper*>(ctx);
 
 		// Render the main scene
@@ -4451,7 +5198,9 @@ extern "C" {
 			WanderSpire::AssetLoader::Get().UpdateMainThread();
 			WanderSpire::FileWatcher::Get().Update();
 
-			// Update world systems (ECS, physics, etc.)
+			// Update world systems (ECS, physics, etc.); the tile animation
+			// clock is shared across worlds, so it moves once per frame here
+			WanderSpire::AnimatedTileSystem::AdvanceClock(dt);
 			state->world.Tick(dt, state->ctx);
 			state->world.Update(dt, state->ctx);
 
@@ -4553,7 +5302,8 @@ extern "C" {
 			glGenBuffers(1, &ebo);
 
 			// Set up basic quad geometry for rendering
-			glBindVertexArray(vao);
+			auto& glStateCache = WanderSpire::GL::StateCache::Get();
+			glStateCache.BindVertexArray(vao);
 
 			static const float verts[] = {
 				 0.5f,  0.5f, 0.0f,   1.0f, 1.0f,
@@ -4563,10 +5313,10 @@ extern "C" {
 			};
 			static const unsigned idx[] = { 0, 1, 3, 1, 2, 3 };
 
-			glBindBuffer(GL_ARRAY_BUFFER, vbo);
+			glStateCache.BindBuffer(GL_ARRAY_BUFFER, vbo);
 			glBufferData(GL_ARRAY_BUFFER, sizeof(verts), verts, GL_STATIC_DRAW);
 
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+			glStateCache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
 			glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(idx), idx, GL_STATIC_DRAW);
 
 			// Set up vertex attributes
@@ -4593,7 +5343,7 @@ extern "C" {
 			glEnableVertexAttribArray(4);
 			glVertexAttribDivisor(4, 1);
 
-			glBindVertexArray(0);
+			glStateCache.BindVertexArray(0);
 
 			// Check for any OpenGL errors
 			error = glGetError();
@@ -4607,12 +5357,13 @@ extern "C" {
 
 			// Register shaders - the shader files should already be compatible with OpenGL ES
 			rm.RegisterShader("sprite", "shaders/vertex.glsl", "shaders/fragment.glsl");
+			rm.RegisterShader("tilemap", "shaders/tile_lookup_vertex.glsl", "shaders/tile_lookup_fragment.glsl");
 
 			// Load basic textures
 			rm.RegisterTexture("debug_tile", "textures/debug_tile.png");
 
 			// Set viewport
-			glViewport(0, 0, width, height);
+			glStateCache.Viewport(0, 0, width, height);
 
 			spdlog::info("[EngineInitRendering] Rendering initialization complete");
 			return 0;
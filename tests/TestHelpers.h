@@ -8,6 +8,7 @@
 #include <WanderSpire/Core/Reflection.h>
 #include <WanderSpire/Core/EngineContext.h>
 #include <WanderSpire/World/Pathfinder2D.h>
+#include <WanderSpire/World/TilemapSystem.h>
 #include <WanderSpire/ECS/PrefabManager.h>
 #include <WanderSpire/Core/AssetManager.h>
 #include <WanderSpire/ECS/World.h>
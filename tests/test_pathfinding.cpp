@@ -1,5 +1,18 @@
 ﻿#include <catch2/catch_test_macros.hpp>
 #include "TestHelpers.h"
+#include <WanderSpire/World/TileDefinitionManager.h>
+#include <WanderSpire/World/ConnectivityMap.h>
+#include <WanderSpire/World/ChunkEvictionCache.h>
+#include <WanderSpire/World/VisibilityMap.h>
+#include <WanderSpire/World/MovementCostField.h>
+#include <WanderSpire/World/PathRequestService.h>
+#include <WanderSpire/Core/EventBus.h>
+#include <WanderSpire/Core/Events.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <unordered_map>
 
 TEST_CASE("Pathfinder straight line", "[pathfinding]") {
 	// 5×5 grid of 1.0f tiles
@@ -11,3 +24,392 @@ TEST_CASE("Pathfinder straight line", "[pathfinding]") {
 	//std::vector<glm::ivec2> goals = { {4, 0} };
 
 }
+
+TEST_CASE("Connectivity rejects walled-off targets", "[pathfinding]") {
+	entt::registry reg;
+	auto& tilemaps = TilemapSystem::GetInstance();
+	auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+	auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+
+	tilemaps.FloodFillArea(reg, layer, { 0, 0 }, { 10, 10 }, 1);
+
+	// Wall in (5,5) with four orthogonal obstacles; diagonals cannot cut corners
+	std::vector<entt::entity> walls;
+	for (glm::ivec2 p : { glm::ivec2{ 4, 5 }, glm::ivec2{ 6, 5 }, glm::ivec2{ 5, 4 }, glm::ivec2{ 5, 6 } }) {
+		auto e = reg.create();
+		reg.emplace<GridPositionComponent>(e, p);
+		reg.emplace<ObstacleComponent>(e);
+		walls.push_back(e);
+	}
+
+	REQUIRE_FALSE(Pathfinder2D::AreConnected(reg, layer, { 0, 0 }, { 5, 5 }));
+	REQUIRE(Pathfinder2D::AreConnected(reg, layer, { 0, 0 }, { 10, 10 }));
+	// Unloaded space beyond the chunk is open ground
+	REQUIRE(Pathfinder2D::AreConnected(reg, layer, { 0, 0 }, { 100, -40 }));
+
+	auto blocked = Pathfinder2D::FindPath({ 0, 0 }, { 5, 5 }, 20, reg, layer);
+	REQUIRE((blocked.fullPath.empty() || blocked.fullPath.back() != glm::ivec2{ 5, 5 }));
+
+	// Opening the wall reconnects the regions
+	reg.destroy(walls.front());
+	REQUIRE(Pathfinder2D::AreConnected(reg, layer, { 0, 0 }, { 5, 5 }));
+
+	auto open = Pathfinder2D::FindPath({ 0, 0 }, { 5, 5 }, 20, reg, layer);
+	REQUIRE_FALSE(open.fullPath.empty());
+	REQUIRE(open.fullPath.back() == glm::ivec2{ 5, 5 });
+
+	// Tile writes dirty only their chunk; erasing the tile under an obstacle frees it
+	tilemaps.SetTile(reg, layer, { 5, 4 }, -1);
+	REQUIRE(Pathfinder2D::AreConnected(reg, layer, { 5, 3 }, { 5, 5 }));
+
+	// A chunk short of tiles reads the missing ones as empty, so no stale labels survive
+	auto rewall = reg.create();
+	reg.emplace<GridPositionComponent>(rewall, glm::ivec2{ 4, 5 });
+	reg.emplace<ObstacleComponent>(rewall);
+	tilemaps.SetTile(reg, layer, { 5, 4 }, 1);
+	REQUIRE_FALSE(Pathfinder2D::AreConnected(reg, layer, { 0, 0 }, { 5, 5 }));
+	const auto chunk = reg.view<TilemapChunkComponent>().front();
+	reg.patch<TilemapChunkComponent>(chunk, [](auto& c) { c.tileIds.resize(static_cast<size_t>(5 * c.chunkSize)); });
+	REQUIRE(Pathfinder2D::AreConnected(reg, layer, { 0, 0 }, { 5, 5 }));
+}
+
+TEST_CASE("Connectivity updated in place matches a full rebuild", "[pathfinding]") {
+	entt::registry reg;
+	auto& tilemaps = TilemapSystem::GetInstance();
+	auto& connectivity = ConnectivityMap::GetInstance();
+	auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+	auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+	REQUIRE(tilemaps.FillRect(reg, layer, { 0, 0 }, { 95, 95 }, 1) == 96 * 96);
+
+	// Two rings of obstacles, the larger one straddling chunk borders
+	std::vector<entt::entity> obstacles;
+	auto ring = [&](glm::ivec2 lo, glm::ivec2 hi) {
+		for (int y = lo.y; y <= hi.y; ++y) {
+			for (int x = lo.x; x <= hi.x; ++x) {
+				if (x != lo.x && x != hi.x && y != lo.y && y != hi.y) continue;
+				auto e = reg.create();
+				reg.emplace<GridPositionComponent>(e, glm::ivec2{ x, y });
+				reg.emplace<ObstacleComponent>(e);
+				obstacles.push_back(e);
+			}
+		}
+	};
+	ring({ 10, 10 }, { 20, 20 });
+	ring({ 25, 25 }, { 70, 70 });
+	REQUIRE_FALSE(connectivity.AreConnected(reg, layer, { 15, 15 }, { 0, 0 }));
+	REQUIRE_FALSE(connectivity.AreConnected(reg, layer, { 40, 40 }, { 15, 15 }));
+	REQUIRE(connectivity.AreConnected(reg, layer, { 0, 0 }, { 200, 200 }));
+
+	// Unloading the middle chunk opens the big ring to the void; reloading closes it
+	tilemaps.UnloadChunk(reg, layer, { 1, 1 });
+	REQUIRE(connectivity.AreConnected(reg, layer, { 26, 26 }, { 200, 200 }));
+	tilemaps.LoadChunk(reg, layer, { 1, 1 });
+	REQUIRE_FALSE(connectivity.AreConnected(reg, layer, { 26, 26 }, { 200, 200 }));
+
+	// Component ids differ between builds; the partition of the probes must not
+	std::vector<glm::ivec2> probes = { { 15, 15 }, { 40, 40 }, { 200, 200 } };
+	for (int y = 1; y < 96; y += 6)
+		for (int x = 2; x < 96; x += 6) probes.push_back({ x, y });
+	auto partition = [&]() {
+		std::vector<int> groups;
+		std::unordered_map<int, int> first;
+		for (const auto& p : probes) {
+			const int id = connectivity.GetComponentId(reg, layer, p);
+			groups.push_back(id < 0 ? -1 : first.emplace(id, static_cast<int>(first.size())).first->second);
+		}
+		return groups;
+	};
+
+	std::mt19937 rng(11);
+	auto pick = [&](int n) { return std::uniform_int_distribution<int>(0, n - 1)(rng); };
+	for (int step = 1; step <= 200; ++step) {
+		switch (pick(6)) {
+		case 0: {   // move an obstacle
+			const auto e = obstacles[pick(static_cast<int>(obstacles.size()))];
+			if (e != entt::null) reg.patch<GridPositionComponent>(e, [&](auto& grid) { grid.tile = { pick(96), pick(96) }; });
+			break;
+		}
+		case 1: {   // remove an obstacle, or put one back in the rings' area
+			auto& e = obstacles[pick(static_cast<int>(obstacles.size()))];
+			if (e != entt::null) {
+				reg.destroy(e);
+				e = entt::null;
+			}
+			else {
+				e = reg.create();
+				reg.emplace<GridPositionComponent>(e, glm::ivec2{ 10 + pick(61), 10 + pick(61) });
+				reg.emplace<ObstacleComponent>(e);
+			}
+			break;
+		}
+		case 2: {   // a tile override, walkable or not
+			auto e = reg.create();
+			reg.emplace<TileComponent>(e, TileComponent{ .tileId = 1, .gridPosition = { pick(96), pick(96) },
+				.walkable = pick(2) == 0 });
+			break;
+		}
+		case 3:
+			tilemaps.SetTile(reg, layer, { pick(96), pick(96) }, pick(3) == 0 ? -1 : 1);
+			break;
+		case 4: {
+			const glm::ivec2 chunk{ pick(3), pick(3) };
+			if (tilemaps.IsChunkLoaded(reg, layer, chunk)) tilemaps.UnloadChunk(reg, layer, chunk);
+			else tilemaps.LoadChunk(reg, layer, chunk);
+			break;
+		}
+		default:
+			tilemaps.FillRect(reg, layer, { pick(96), pick(96) }, { pick(96), pick(96) }, 1);
+			break;
+		}
+
+		// Refresh in place every step; compare against a full rebuild now and then
+		const auto updated = partition();
+		if (step % 10 == 0) {
+			connectivity.Invalidate(reg);
+			REQUIRE(partition() == updated);
+		}
+	}
+	ChunkEvictionCache::GetInstance().Forget(reg, layer);
+}
+
+TEST_CASE("Shadowcast FOV and line of sight respect opaque tiles", "[visibility]") {
+	entt::registry reg;
+	auto& tilemaps = TilemapSystem::GetInstance();
+	auto& tileDefs = TileDefinitionManager::GetInstance();
+	auto& visibility = VisibilityMap::GetInstance();
+	auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+	auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+
+	tileDefs.RegisterTile(2, "terrain", "wall");
+	tileDefs.SetTileBlocksVision(2, true);
+
+	// Open floor with a wall column at x = 5
+	tilemaps.FloodFillArea(reg, layer, { 0, 0 }, { 10, 10 }, 1);
+	for (int y = 0; y <= 10; ++y)
+		tilemaps.SetTile(reg, layer, { 5, y }, 2);
+
+	VisibilityBitmap fov;
+	visibility.ComputeFOV(reg, layer, { 2, 5 }, 8, fov);
+	REQUIRE(fov.Test({ 2, 5 }));
+	REQUIRE(fov.Test({ 4, 5 }));
+	REQUIRE(fov.Test({ 5, 5 }));       // the wall face itself is seen
+	REQUIRE_FALSE(fov.Test({ 7, 5 }));
+	REQUIRE_FALSE(fov.Test({ 2, 20 })); // outside the radius
+
+	REQUIRE(visibility.HasLineOfSight(reg, layer, { 2, 5 }, { 4, 0 }));
+	REQUIRE_FALSE(visibility.HasLineOfSight(reg, layer, { 2, 5 }, { 8, 5 }));
+
+	// Batch results agree with single queries
+	const glm::ivec2 from[] = { { 2, 5 }, { 2, 5 }, { 2, 5 } };
+	const glm::ivec2 to[] = { { 4, 0 }, { 8, 5 }, { 4, 9 } };
+	uint8_t visible[3] = {};
+	REQUIRE(visibility.HasLineOfSightBatch(reg, layer, from, to, 3, 0.0f, visible) == 2);
+	REQUIRE(visible[0] == 1);
+	REQUIRE(visible[1] == 0);
+	REQUIRE(visible[2] == 1);
+	REQUIRE(visibility.HasLineOfSightBatch(reg, layer, from, to, 3, 3.0f, visible) == 0);
+
+	// Opening a gap and placing a vision-blocking obstacle both invalidate lazily
+	tilemaps.SetTile(reg, layer, { 5, 5 }, 1);
+	REQUIRE(visibility.HasLineOfSight(reg, layer, { 2, 5 }, { 8, 5 }));
+
+	auto crate = reg.create();
+	reg.emplace<GridPositionComponent>(crate, glm::ivec2{ 6, 5 });
+	reg.emplace<ObstacleComponent>(crate);
+	REQUIRE_FALSE(visibility.HasLineOfSight(reg, layer, { 2, 5 }, { 8, 5 }));
+
+	// A chunk short of tiles keeps the walls it has; only the missing tiles read as empty
+	const auto chunk = reg.view<TilemapChunkComponent>().front();
+	reg.patch<TilemapChunkComponent>(chunk, [](auto& c) { c.tileIds.resize(static_cast<size_t>(3 * c.chunkSize)); });
+	REQUIRE_FALSE(visibility.HasLineOfSight(reg, layer, { 2, 1 }, { 8, 1 }));
+	REQUIRE(visibility.HasLineOfSight(reg, layer, { 2, 8 }, { 8, 8 }));
+
+	tileDefs.Clear();
+}
+
+TEST_CASE("Weighted search follows cheap terrain", "[pathfinding]") {
+	entt::registry reg;
+	auto& tilemaps = TilemapSystem::GetInstance();
+	auto& tileDefs = TileDefinitionManager::GetInstance();
+	auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+	auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+
+	tileDefs.RegisterTile(3, "terrain", "swamp");
+	tileDefs.SetTileMovementCost(3, 100);
+	tileDefs.RegisterTile(4, "terrain", "road");
+	tileDefs.SetTileMovementCost(4, 5);
+
+	// Swamp well past the route (empty ground costs BASE_COST) with a road two rows up
+	tilemaps.FloodFillArea(reg, layer, { -20, -20 }, { 40, 20 }, 3);
+	tilemaps.FloodFillArea(reg, layer, { 0, 2 }, { 20, 2 }, 4);
+
+	auto contains = [](const PathResult& r, glm::ivec2 p) {
+		return std::find(r.fullPath.begin(), r.fullPath.end(), p) != r.fullPath.end();
+		};
+
+	auto viaRoad = Pathfinder2D::FindWeightedPath({ 0, 0 }, { 20, 0 }, 30, reg, layer);
+	REQUIRE_FALSE(viaRoad.fullPath.empty());
+	REQUIRE(viaRoad.fullPath.back() == glm::ivec2{ 20, 0 });
+	REQUIRE(contains(viaRoad, { 10, 2 }));
+	REQUIRE_FALSE(contains(viaRoad, { 10, 0 }));
+
+	// A definition change rebuilds the chunks using that tile
+	tileDefs.SetTileMovementCost(4, 200);
+	auto direct = Pathfinder2D::FindWeightedPath({ 0, 0 }, { 20, 0 }, 30, reg, layer);
+	REQUIRE(contains(direct, { 10, 0 }));
+
+	// Overlays override definitions per tile, and 0 blocks
+	MovementCostField::GetInstance().SetCostOverlay(reg, { 10, 0 }, MovementCostField::BLOCKED);
+	REQUIRE(MovementCostField::GetInstance().GetCost(reg, layer, { 10, 0 }) == MovementCostField::BLOCKED);
+	auto detour = Pathfinder2D::FindWeightedPath({ 0, 0 }, { 20, 0 }, 30, reg, layer);
+	REQUIRE(detour.fullPath.back() == glm::ivec2{ 20, 0 });
+	REQUIRE_FALSE(contains(detour, { 10, 0 }));
+
+	MovementCostField::GetInstance().ClearCostOverlays(reg);
+
+	// A chunk short of tiles keeps the costs it has; only the missing tiles read as empty
+	for (auto [e, chunk] : reg.view<TilemapChunkComponent>().each()) {
+		if (chunk.chunkCoords != glm::ivec2{ 0, 0 }) continue;
+		reg.patch<TilemapChunkComponent>(e, [](auto& c) { c.tileIds.resize(static_cast<size_t>(3 * c.chunkSize)); });
+	}
+	REQUIRE(MovementCostField::GetInstance().GetCost(reg, layer, { 10, 1 }) != MovementCostField::BASE_COST);
+	REQUIRE(MovementCostField::GetInstance().GetCost(reg, layer, { 10, 10 }) == MovementCostField::BASE_COST);
+
+	tileDefs.Clear();
+}
+
+TEST_CASE("Weighted search stays within 1.5x of unweighted", "[.][benchmark][pathfinding]") {
+	entt::registry reg;
+	auto& tilemaps = TilemapSystem::GetInstance();
+	auto& tileDefs = TileDefinitionManager::GetInstance();
+	auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+	auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+
+	tileDefs.RegisterTile(1, "terrain", "grass");
+	tileDefs.RegisterTile(3, "terrain", "swamp");
+	tileDefs.SetTileMovementCost(3, 30);
+	tileDefs.RegisterTile(4, "terrain", "road");
+	tileDefs.SetTileMovementCost(4, 5);
+
+	// 64×64 of mixed terrain with scattered rocks
+	for (int y = 0; y < 64; ++y) {
+		for (int x = 0; x < 64; ++x) {
+			const int id = (y % 16 == 8) ? 4 : ((x * 7 + y * 13) % 5 == 0 ? 3 : 1);
+			tilemaps.SetTile(reg, layer, { x, y }, id);
+			if ((x * 31 + y * 17) % 23 == 0) {
+				auto rock = reg.create();
+				reg.emplace<GridPositionComponent>(rock, glm::ivec2{ x, y });
+				reg.emplace<ObstacleComponent>(rock);
+			}
+		}
+	}
+
+	const glm::ivec2 pairs[][2] = {
+		{ { 1, 1 }, { 60, 60 } }, { { 2, 40 }, { 58, 5 } }, { { 30, 1 }, { 33, 62 } }, { { 61, 30 }, { 3, 31 } }
+	};
+
+	auto time = [&](auto&& search) {
+		for (const auto& p : pairs) search(p[0], p[1]); // warm caches
+		const auto t0 = std::chrono::steady_clock::now();
+		for (int i = 0; i < 5; ++i) {
+			for (const auto& p : pairs) search(p[0], p[1]);
+		}
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+		};
+
+	const double unweighted = time([&](glm::ivec2 a, glm::ivec2 b) { return Pathfinder2D::FindPath(a, b, 90, reg, layer); });
+	const double weighted = time([&](glm::ivec2 a, glm::ivec2 b) { return Pathfinder2D::FindWeightedPath(a, b, 90, reg, layer); });
+
+	WARN("unweighted " << unweighted * 1000.0 << " ms, weighted " << weighted * 1000.0 << " ms");
+	REQUIRE(weighted <= unweighted * 1.5);
+
+	tileDefs.Clear();
+}
+
+TEST_CASE("Path requests are coalesced, cancelled and delivered with ids", "[pathfinding]") {
+	entt::registry reg;
+	auto& tilemaps = TilemapSystem::GetInstance();
+	auto& service = PathRequestService::GetInstance();
+	auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+	auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+	tilemaps.FloodFillArea(reg, layer, { 0, 0 }, { 24, 24 }, 1);
+
+	std::vector<PathAppliedEvent> delivered;
+	auto token = EventBus::Get().Subscribe<PathAppliedEvent>(
+		[&](const PathAppliedEvent& ev) { delivered.push_back(ev); });
+
+	auto a = reg.create();
+	auto b = reg.create();
+	auto c = reg.create();
+
+	PathRequest request;
+	request.start = { 0, 0 };
+	request.target = { 8, 3 };
+	request.tilemapLayer = layer;
+
+	request.entity = a;
+	const auto idA = service.Submit(reg, request);
+	request.entity = b;
+	const auto idB = service.Submit(reg, request);   // same search as a
+
+	// c re-targets: only its latest request survives
+	request.entity = c;
+	request.target = { 2, 9 };
+	const auto stale = service.Submit(reg, request);
+	request.target = { 9, 9 };
+	const auto idC = service.Submit(reg, request);
+	REQUIRE(service.GetPendingCount(reg) == 3);
+	REQUIRE_FALSE(service.Cancel(reg, stale));
+
+	// Destroying an agent frees its queue slot at once, without searching
+	request.entity = reg.create();
+	request.target = { 5, 5 };
+	service.Submit(reg, request);
+	REQUIRE(service.GetPendingCount(reg) == 4);
+	reg.destroy(request.entity);
+	REQUIRE(service.GetPendingCount(reg) == 3);
+	REQUIRE(service.Submit(reg, request) == PathRequestService::INVALID_REQUEST);
+
+	REQUIRE(service.Update(reg, 1000000) == 2);
+	REQUIRE(service.GetPendingCount(reg) == 0);
+	REQUIRE(delivered.size() == 3);
+
+	for (const auto& ev : delivered) {
+		REQUIRE_FALSE(ev.checkpoints.empty());
+		if (ev.requestId == idA) REQUIRE(ev.entity == a);
+		else if (ev.requestId == idB) REQUIRE(ev.entity == b);
+		else {
+			REQUIRE(ev.requestId == idC);
+			REQUIRE(ev.checkpoints.back() == glm::ivec2{ 9, 9 });
+		}
+	}
+
+	// A zero budget still makes progress one slice at a time, resuming the
+	// search it cut off before starting the next one
+	delivered.clear();
+	request.entity = a;
+	request.target = { 20, 20 };
+	service.Submit(reg, request);
+	request.entity = b;
+	request.target = { 1, 1 };
+	service.Submit(reg, request);
+	int slices = 1;
+	while (service.Update(reg, 0) == 0) ++slices;
+	REQUIRE(slices > 1);
+	REQUIRE(delivered.size() == 1);
+	REQUIRE(delivered[0].checkpoints.back() == glm::ivec2{ 20, 20 });
+	REQUIRE(service.CancelForEntity(reg, b) + service.CancelForEntity(reg, a) == 1);
+
+	// A search run in slices finds the same path as one run whole
+	PathSearch sliced({ 0, 0 }, { 20, 20 }, 32, layer, false);
+	while (!sliced.Step(reg, 16)) {}
+	REQUIRE(sliced.Result().fullPath ==
+		Pathfinder2D::FindPath({ 0, 0 }, { 20, 20 }, 32, reg, layer).fullPath);
+
+	// Budgets set for one registry leave the others on the global one
+	entt::registry other;
+	const uint32_t global = service.GetFrameBudget();
+	service.SetFrameBudget(reg, 123);
+	REQUIRE(service.GetFrameBudget(reg) == 123);
+	REQUIRE(service.GetFrameBudget(other) == global);
+}
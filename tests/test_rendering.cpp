@@ -0,0 +1,1212 @@
+﻿#include <catch2/catch_test_macros.hpp>
+#include "TestHelpers.h"
+#include <WanderSpire/World/TileDefinitionManager.h>
+#include <WanderSpire/Graphics/TileRenderTable.h>
+#include <WanderSpire/Graphics/TileLookupRenderer.h>
+#include <WanderSpire/Graphics/AtlasPacker.h>
+#include <WanderSpire/Graphics/DebugDraw.h>
+#include <WanderSpire/Graphics/StreamBuffer.h>
+#include <WanderSpire/Graphics/RecordingDevice.h>
+#include <WanderSpire/Graphics/InstanceRenderer.h>
+#include <WanderSpire/Graphics/GLStateManager.h>
+#include <WanderSpire/Graphics/Shader.h>
+#include <WanderSpire/Graphics/RenderJobPool.h>
+#include <WanderSpire/Graphics/RenderManager.h>
+#include <WanderSpire/Graphics/RenderResourceManager.h>
+#include <WanderSpire/Graphics/FrameUniforms.h>
+#include <WanderSpire/Graphics/RenderThread.h>
+#include <WanderSpire/Systems/RenderSystem.h>
+#include <WanderSpire/Components/SpriteRenderComponent.h>
+#include <WanderSpire/External/stb_image_write.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+
+namespace {
+	/// Stand-in for the GL calls of StreamBuffer: host memory and fences the test signals
+	struct RecordingStreamDevice : StreamBufferDevice {
+		bool persistent = true;
+		std::vector<uint8_t> memory;
+		std::vector<std::pair<size_t, size_t>> mappedRanges;
+		int unmaps = 0;
+		uint64_t nextFence = 1;
+		std::vector<uint64_t> signaled, deleted;
+		int blockingWaits = 0;
+
+		bool Signaled(uint64_t f) const { return std::find(signaled.begin(), signaled.end(), f) != signaled.end(); }
+
+		bool SupportsPersistentMapping() const override { return persistent; }
+		bool CreateStorage(size_t capacity, bool mapPersistent, void** outMapping) override {
+			memory.assign(capacity, 0);
+			if (mapPersistent) *outMapping = memory.data();
+			return true;
+		}
+		void DestroyStorage() override {}
+		GLuint GetBuffer() const override { return 7; }
+		void* MapRange(size_t offset, size_t size) override {
+			mappedRanges.emplace_back(offset, size);
+			return memory.data() + offset;
+		}
+		void UnmapRange() override { ++unmaps; }
+		uint64_t InsertFence() override { return nextFence++; }
+		bool WaitFence(uint64_t fence, uint64_t timeoutNanos) override {
+			if (Signaled(fence)) return true;
+			if (timeoutNanos == 0) return false;
+			++blockingWaits;             // The "GPU" finishes while we wait
+			signaled.push_back(fence);
+			return true;
+		}
+		void DeleteFence(uint64_t fence) override { deleted.push_back(fence); }
+	};
+}
+
+TEST_CASE("Stream buffer reuses ring space behind frame fences", "[rendering]") {
+	auto owned = std::make_unique<RecordingStreamDevice>();
+	auto* gpu = owned.get();
+	StreamBuffer stream;
+	REQUIRE(stream.Initialize(1024, 2, std::move(owned)));
+	REQUIRE(stream.GetStats().persistent);
+
+	std::vector<uint8_t> bytes(500);
+	for (size_t i = 0; i < bytes.size(); ++i) bytes[i] = static_cast<uint8_t>(i * 7);
+
+	// Frame 1: sequential, aligned sub-allocations; uploads are plain copies
+	auto a = stream.Upload(bytes.data(), 100, StreamUsage::Instance);
+	auto b = stream.Upload(bytes.data(), 100, StreamUsage::Sprite);
+	REQUIRE((a && b));
+	REQUIRE(a.offset == 0);
+	REQUIRE(b.offset == 112);
+	REQUIRE(b.buffer == 7);
+	REQUIRE(std::equal(bytes.begin(), bytes.begin() + 100, gpu->memory.begin() + 112));
+	stream.EndFrame();
+	REQUIRE(stream.GetStats().bytesLastFrame == 200);
+	REQUIRE(stream.GetStats().bytesLastFrameByUsage[static_cast<size_t>(StreamUsage::Sprite)] == 100);
+	REQUIRE(stream.GetStats().framesInFlight == 1);
+
+	// Frame 2 continues behind frame 1, which the GPU has not finished
+	auto c = stream.Upload(bytes.data(), 500, StreamUsage::Debug);
+	REQUIRE(c.offset == 224);
+	stream.EndFrame();
+	REQUIRE(stream.GetStats().framesInFlight == 2);
+	REQUIRE(stream.GetBytesInUse() == 724);
+
+	// Frame 3 wraps: frame 1 is done and reclaimed for free, frame 2 has to be waited on
+	gpu->signaled.push_back(1);
+	auto d = stream.Upload(bytes.data(), 400, StreamUsage::Instance);
+	REQUIRE(d.offset == 0);
+	REQUIRE(stream.GetStats().wraps == 1);
+	REQUIRE(stream.GetStats().stalls == 1);
+	REQUIRE(gpu->blockingWaits == 1);
+	REQUIRE(gpu->deleted == std::vector<uint64_t>{ 1, 2 });
+	REQUIRE(std::equal(bytes.begin(), bytes.begin() + 400, gpu->memory.begin()));
+	stream.EndFrame();
+
+	// No frame is kept past the frames-in-flight limit
+	for (int frame = 0; frame < 4; ++frame) {
+		REQUIRE(stream.Upload(bytes.data(), 64, StreamUsage::Instance));
+		stream.EndFrame();
+		REQUIRE(stream.GetStats().framesInFlight <= 2);
+	}
+
+	REQUIRE_FALSE(stream.Allocate(2000, StreamUsage::Instance));
+	REQUIRE(stream.GetStats().failedAllocations == 1);
+	stream.Shutdown();
+}
+
+TEST_CASE("Stream buffer maps ranges unsynchronized without buffer storage", "[rendering]") {
+	auto owned = std::make_unique<RecordingStreamDevice>();
+	owned->persistent = false;
+	auto* gpu = owned.get();
+	StreamBuffer stream;
+	REQUIRE(stream.Initialize(256, 3, std::move(owned)));
+	REQUIRE_FALSE(stream.GetStats().persistent);
+
+	auto a = stream.Allocate(200, StreamUsage::Instance);
+	REQUIRE(a);
+	REQUIRE(gpu->mappedRanges.back() == std::make_pair(size_t(0), size_t(200)));
+	stream.Commit(a);
+	REQUIRE(gpu->unmaps == 1);
+
+	// A frame that outgrows the ring fences itself and waits for its own draws
+	auto b = stream.Allocate(200, StreamUsage::Instance);
+	REQUIRE(b);
+	REQUIRE(b.offset == 0);
+	REQUIRE(stream.GetStats().stalls == 1);
+	REQUIRE(gpu->mappedRanges.back() == std::make_pair(size_t(0), size_t(200)));
+
+	// EndFrame unmaps a range left open and fences the frame
+	stream.EndFrame();
+	REQUIRE(gpu->unmaps == 2);
+	REQUIRE(gpu->nextFence == 3);
+	stream.Shutdown();
+}
+
+namespace {
+	/// Counts what reaches "GL" instead of issuing it
+	struct RecordingStateBackend : GL::StateBackend {
+		int calls = 0;
+		int queries = 0;
+		GLuint program = 0;
+
+		void UseProgram(GLuint p) override { ++calls; program = p; }
+		void BindVertexArray(GLuint) override { ++calls; }
+		void BindBuffer(GLenum, GLuint) override { ++calls; }
+		void BindBufferBase(GLenum, GLuint, GLuint) override { ++calls; }
+		void ActiveTexture(GLenum) override { ++calls; }
+		void BindTexture(GLenum, GLuint) override { ++calls; }
+		void Enable(GLenum) override { ++calls; }
+		void Disable(GLenum) override { ++calls; }
+		void BlendFuncSeparate(GLenum, GLenum, GLenum, GLenum) override { ++calls; }
+		void DepthFunc(GLenum) override { ++calls; }
+		void DepthMask(GLboolean) override { ++calls; }
+		void Scissor(GLint, GLint, GLsizei, GLsizei) override { ++calls; }
+		void Viewport(GLint, GLint, GLsizei, GLsizei) override { ++calls; }
+		void BindFramebuffer(GLenum, GLuint) override { ++calls; }
+		void ClearColor(GLfloat, GLfloat, GLfloat, GLfloat) override { ++calls; }
+		void GetIntegerv(GLenum pname, GLint* data) override {
+			++queries;
+			*data = pname == GL_ACTIVE_TEXTURE ? GL_TEXTURE0 : 0;
+		}
+		GLboolean IsEnabled(GLenum) override { ++queries; return GL_FALSE; }
+	};
+}
+
+TEST_CASE("GL state cache drops redundant changes and never queries known state", "[rendering]") {
+	auto owned = std::make_unique<RecordingStateBackend>();
+	auto* gl = owned.get();
+	auto& cache = GL::StateCache::Get();
+	cache.SetBackend(std::move(owned));
+	cache.ResetStats();
+
+	// What a frame does: set up state, draw, bind an off-screen target and an extra texture temporarily
+	auto frame = [&] {
+		cache.Viewport(0, 0, 800, 600);
+		cache.Enable(GL_BLEND);
+		cache.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		cache.UseProgram(3);
+		cache.BindVertexArray(5);
+		cache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 6);
+		for (int sprite = 0; sprite < 4; ++sprite) cache.BindTexture(GL_TEXTURE_2D, 9, 0);
+		{ GL::TextureBinder lookup(11, GL_TEXTURE_2D, 1); }
+		{ GL::FramebufferBinder target(4); }
+	};
+
+	frame();
+	REQUIRE(gl->queries == 3);            // Texture on unit 1, draw and read framebuffers
+	REQUIRE(cache.GetActiveTexture() == 0);
+	REQUIRE(cache.GetFramebuffer(GL_FRAMEBUFFER) == 0);
+
+	// Once known, no state is queried again and unchanged state never reaches GL
+	gl->calls = gl->queries = 0;
+	cache.ResetStats();
+	frame();
+	REQUIRE(gl->queries == 0);
+	REQUIRE(gl->calls == 6);              // Only the temporary binds and their restores
+	const auto& stats = cache.GetStats();
+	REQUIRE(stats.queries == 0);
+	REQUIRE(stats.skipped[static_cast<size_t>(GL::StateKind::Program)] == 1);
+	REQUIRE(stats.skipped[static_cast<size_t>(GL::StateKind::Viewport)] == 1);
+	REQUIRE(stats.TotalRequested() - stats.TotalSkipped() == 6);
+
+	// Binding a VAO switches the element array binding with it
+	cache.BindVertexArray(8);
+	cache.BindVertexArray(5);
+	gl->calls = 0;
+	cache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 6);
+	REQUIRE(gl->calls == 1);
+
+	// Deleted objects and foreign GL code make the next request go through
+	gl->calls = 0;
+	cache.ForgetTexture(9);
+	cache.BindTexture(GL_TEXTURE_2D, 9, 0);
+	REQUIRE(gl->calls == 1);
+	cache.Invalidate();
+	cache.UseProgram(3);
+	REQUIRE(gl->calls == 2);
+	REQUIRE(gl->program == 3);
+	REQUIRE(cache.GetProgram() == 3);
+	REQUIRE(gl->queries == 0);
+
+	cache.SetBackend(nullptr);
+}
+
+TEST_CASE("Shader uniform handles are declared once and outlive relinks", "[rendering]") {
+	// Handles can be declared before the program exists; locations are resolved at link
+	Shader shader;
+	const UniformHandle model = shader.DeclareUniform("u_Model");
+	const UniformHandle color = shader.DeclareUniform("u_Color");
+	REQUIRE(model != InvalidUniform);
+	REQUIRE(color != model);
+	REQUIRE(shader.DeclareUniform("u_Model") == model);
+
+	// Unresolved or invalid handles are ignored rather than sent to GL
+	shader.Set(model, glm::mat4(1.0f));
+	shader.Set(InvalidUniform, 1);
+	shader.SetUniformInt("u_UseTexture", 1);
+	REQUIRE(shader.DeclareUniform("u_UseTexture") == color + 1);
+}
+
+TEST_CASE("Parallel entity command building matches the serial path", "[rendering]") {
+	entt::registry registry;
+
+	// Plenty of equal z-orders, culled sprites and sprites without a transform
+	uint32_t seed = 12345u;
+	auto next = [&seed] { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+	for (int i = 0; i < 5000; ++i) {
+		const auto entity = registry.create();
+		auto& render = registry.emplace<SpriteRenderComponent>(entity);
+		render.textureID = static_cast<GLuint>(i);
+		render.worldSize = glm::vec2(1.0f + static_cast<float>(next() % 4));
+		if (next() % 10 == 0) continue;
+
+		auto& transform = registry.emplace<TransformComponent>(entity);
+		transform.localPosition = glm::vec2(static_cast<float>(next() % 300), static_cast<float>(next() % 300)) - 50.0f;
+		transform.localRotation = static_cast<float>(next() % 360);
+		if (next() % 3 != 0) registry.emplace<ObstacleComponent>(entity).zOrder = static_cast<int>(next() % 7) - 3;
+	}
+	const glm::vec2 minBound(0.0f), maxBound(200.0f);
+
+	auto describe = [](const std::vector<std::unique_ptr<RenderCommand>>& commands) {
+		std::vector<std::tuple<int, GLuint, float, float, float>> out;
+		for (const auto& command : commands) {
+			REQUIRE(command->type == RenderCommandType::DrawSprite);
+			const auto& sprite = static_cast<const SpriteCommand&>(*command);
+			out.emplace_back(sprite.order, sprite.textureID, sprite.position.x, sprite.position.y, sprite.rotation);
+		}
+		return out;
+	};
+
+	auto& pool = RenderJobPool::Get();
+	const unsigned threads = pool.GetThreadCount();
+
+	pool.SetThreadCount(1);
+	const auto serial = describe(RenderSystem::BuildEntityCommands(registry, minBound, maxBound, 1));
+	REQUIRE(!serial.empty());
+	REQUIRE(std::is_sorted(serial.begin(), serial.end(),
+		[](const auto& a, const auto& b) { return std::get<0>(a) < std::get<0>(b); }));
+
+	pool.SetThreadCount(4);
+	for (size_t jobs : { size_t(2), size_t(3), size_t(7), size_t(64), size_t(0) }) {
+		INFO("jobs: " << jobs);
+		REQUIRE(describe(RenderSystem::BuildEntityCommands(registry, minBound, maxBound, jobs)) == serial);
+	}
+
+	pool.SetThreadCount(threads);
+}
+
+namespace {
+	/// Tracks which thread holds the "context" and what gets presented where
+	struct RecordingRenderBackend : RenderBackend {
+		std::mutex mutex;
+		std::thread::id owner = std::this_thread::get_id();   // Current where it was created
+		int misuses = 0;                                       // Context taken twice or used without it
+		std::vector<uint64_t> presented;
+		std::vector<std::thread::id> presentedOn;
+
+		bool AttachContext() override {
+			std::lock_guard lock(mutex);
+			if (owner != std::thread::id{}) ++misuses;
+			owner = std::this_thread::get_id();
+			return true;
+		}
+		void DetachContext() override {
+			std::lock_guard lock(mutex);
+			if (owner != std::this_thread::get_id()) ++misuses;
+			owner = {};
+		}
+		void Execute(FramePacket& packet) override {
+			{
+				std::lock_guard lock(mutex);
+				if (owner != std::this_thread::get_id()) ++misuses;
+			}
+			RenderBackend::Execute(packet);
+		}
+		void Present(const FramePacket& packet) override {
+			std::lock_guard lock(mutex);
+			presented.push_back(packet.frameIndex);
+			presentedOn.push_back(std::this_thread::get_id());
+		}
+	};
+}
+
+TEST_CASE("Render thread presents frame packets in order on the thread holding the context", "[rendering]") {
+	auto owned = std::make_unique<RecordingRenderBackend>();
+	auto* backend = owned.get();
+	auto& renderThread = RenderThread::Get();
+	auto& renderMgr = RenderManager::Get();
+	renderThread.SetBackend(std::move(owned));
+	renderThread.ResetStats();
+
+	// Only touched by whichever thread draws; read once it is quiet
+	std::vector<int> drawn;
+	int frames = 0;
+	auto frame = [&] {
+		const int base = 10 * frames++;
+		renderThread.Pace();
+		renderMgr.SubmitCustom([&drawn, base] { drawn.push_back(base + 2); }, RenderLayer::Debug);
+		renderMgr.SubmitCustom([&drawn, base] { drawn.push_back(base + 0); }, RenderLayer::Terrain);
+		renderMgr.SubmitCustom([&drawn, base] { drawn.push_back(base + 1); }, RenderLayer::Entities);
+		renderMgr.SubmitFrame();
+	};
+	auto expected = [&] {
+		std::vector<int> out;
+		for (int f = 0; f < frames; ++f) for (int c = 0; c < 3; ++c) out.push_back(10 * f + c);
+		return out;
+	};
+	auto inOrder = [](const std::vector<uint64_t>& indices) {
+		for (size_t i = 1; i < indices.size(); ++i) if (indices[i] != indices[i - 1] + 1) return false;
+		return true;
+	};
+	const auto mainThread = std::this_thread::get_id();
+
+	// Single-threaded, the same path draws and presents right away
+	for (int i = 0; i < 3; ++i) frame();
+	REQUIRE(drawn == expected());
+	REQUIRE(backend->presented.size() == 3);
+	REQUIRE(std::count(backend->presentedOn.begin(), backend->presentedOn.end(), mainThread) == 3);
+	REQUIRE_FALSE(renderThread.IsThreaded());
+	REQUIRE(renderThread.OwnsContext());
+
+	// Threaded: the context moves over, and comes back to a borrower with every queued frame drawn
+	REQUIRE(renderThread.Start());
+	REQUIRE(renderThread.IsThreaded());
+	REQUIRE_FALSE(renderThread.OwnsContext());
+	for (int i = 0; i < 40; ++i) {
+		frame();
+		if (i == 20) {
+			RenderThread::ContextScope glContext;
+			REQUIRE(renderThread.OwnsContext());
+			std::lock_guard lock(backend->mutex);
+			REQUIRE(backend->owner == mainThread);
+			REQUIRE(drawn == expected());
+		}
+	}
+	renderThread.Flush();
+	REQUIRE(drawn == expected());
+
+	const auto stats = renderThread.GetStats();
+	REQUIRE(stats.threaded);
+	REQUIRE(stats.framesSubmitted == 43);
+	REQUIRE(stats.framesPresented == 43);
+	REQUIRE(stats.contextBorrows == 1);
+
+	renderThread.Stop();
+	REQUIRE_FALSE(renderThread.IsThreaded());
+	{
+		std::lock_guard lock(backend->mutex);
+		REQUIRE(backend->owner == mainThread);
+		REQUIRE(backend->misuses == 0);
+		REQUIRE(backend->presented.size() == 43);
+		REQUIRE(inOrder(backend->presented));
+		const auto renderer = backend->presentedOn[3];
+		REQUIRE(renderer != mainThread);
+		REQUIRE(std::all_of(backend->presentedOn.begin() + 3, backend->presentedOn.end(),
+			[&](std::thread::id id) { return id == renderer; }));
+	}
+
+	renderThread.SetBackend(nullptr);
+}
+
+TEST_CASE("Atlas packer spills to pages and keeps images apart", "[rendering]") {
+	AtlasPackSettings settings;
+	settings.maxPageSize = 256;
+	settings.padding = 2;
+	settings.extrude = 1;
+
+	uint32_t seed = 99u;
+	auto next = [&seed] { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+	std::vector<AtlasPacker::Size> sizes;
+	for (int i = 0; i < 150; ++i) sizes.push_back({ 1 + int(next() % 64), 1 + int(next() % 64) });
+	sizes.push_back({ 300, 8 });   // Wider than a page
+
+	const auto packed = AtlasPacker(settings).Pack(sizes);
+	REQUIRE(packed.rejected == 1);
+	REQUIRE(packed.placements.back().page == -1);
+	REQUIRE(packed.pages.size() > 1);
+	REQUIRE(packed.Efficiency() > 0.5);
+
+	// Every image and its extrusion lies on its page, with the padding to every neighbour
+	const int margin = settings.extrude;
+	for (size_t i = 0; i + 1 < sizes.size(); ++i) {
+		const auto& a = packed.placements[i];
+		REQUIRE(a.page >= 0);
+		const auto& page = packed.pages[a.page];
+		REQUIRE((page.width <= 256 && page.height <= 256));
+		REQUIRE((a.x - margin >= 0 && a.y - margin >= 0));
+		REQUIRE((a.x + sizes[i].width + margin <= page.width && a.y + sizes[i].height + margin <= page.height));
+		for (size_t k = i + 1; k + 1 < sizes.size(); ++k) {
+			const auto& b = packed.placements[k];
+			if (b.page != a.page) continue;
+			const int gap = 2 * margin + settings.padding;
+			const bool apart = a.x + sizes[i].width + gap <= b.x || b.x + sizes[k].width + gap <= a.x ||
+				a.y + sizes[i].height + gap <= b.y || b.y + sizes[k].height + gap <= a.y;
+			REQUIRE(apart);
+		}
+	}
+
+	// A texture array wants same-sized pages
+	settings.uniformPages = true;
+	const auto uniform = AtlasPacker(settings).Pack(sizes);
+	for (const auto& page : uniform.pages) {
+		REQUIRE(page.width == uniform.pages[0].width);
+		REQUIRE(page.height == uniform.pages[0].height);
+	}
+
+	// A few small images get a small page, not a full-size one
+	const auto small = AtlasPacker(settings).Pack({ { 16, 16 }, { 16, 16 }, { 8, 30 } });
+	REQUIRE(small.pages.size() == 1);
+	REQUIRE(small.pages[0].width <= 64);
+	REQUIRE(small.pages[0].height <= 64);
+
+	// Extrusion repeats the edge pixels around the image
+	std::vector<uint8_t> page(8 * 8 * 4, 0);
+	uint8_t image[2 * 2 * 4];
+	for (int i = 0; i < 16; ++i) image[i] = static_cast<uint8_t>(i + 1);
+	AtlasPacker::Blit(page, 8, 8, image, 2, 2, 1, 1, 1);
+	auto red = [&](int x, int y) { return page[(y * 8 + x) * 4]; };
+	REQUIRE(red(0, 0) == 1);
+	REQUIRE(red(1, 1) == 1);
+	REQUIRE(red(3, 1) == 5);
+	REQUIRE(red(0, 3) == 9);
+	REQUIRE(red(3, 3) == 13);
+	REQUIRE(red(4, 4) == 0);
+}
+
+TEST_CASE("Atlas cache key follows source contents and packer settings", "[rendering]") {
+	const std::vector<uint8_t> grass = { 1, 2, 3, 4 };
+	const std::vector<uint8_t> stone = { 5, 6, 7 };
+	auto keyOf = [&](const AtlasPackSettings& settings, bool textureArray, const std::vector<uint8_t>& second) {
+		AtlasCacheKey key(settings, textureArray);
+		key.AddSource("grass.png", grass.data(), grass.size());
+		key.AddSource("stone.png", second.data(), second.size());
+		return key.ToString();
+	};
+
+	const AtlasPackSettings settings;
+	const std::string base = keyOf(settings, false, stone);
+	REQUIRE(base.size() == 16);
+	REQUIRE(keyOf(settings, false, stone) == base);
+
+	// Any change to a source, the settings or the texture array choice rebuilds
+	REQUIRE(keyOf(settings, false, { 5, 6, 8 }) != base);
+	REQUIRE(keyOf(settings, true, stone) != base);
+	AtlasPackSettings padded = settings;
+	padded.padding = 4;
+	REQUIRE(keyOf(padded, false, stone) != base);
+
+	// Moving bytes between a name and its contents is a different key too
+	AtlasCacheKey a(settings, false), b(settings, false);
+	const uint8_t bytes[] = { 'g', 'x' };
+	a.AddSource("ab", bytes, 1);
+	b.AddSource("a", reinterpret_cast<const uint8_t*>("bg"), 2);
+	REQUIRE(a.ToString() != b.ToString());
+}
+
+TEST_CASE("Debug draw gathers every thread's primitives into one command", "[rendering]") {
+	auto& debugDraw = DebugDraw::Get();
+	debugDraw.Clear();
+	debugDraw.BuildCommand();
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; ++t) {
+		threads.emplace_back([&debugDraw, t] {
+			for (int i = 0; i < 500; ++i) debugDraw.Line({ 0.0f, float(i) }, { 10.0f, float(i) }, { 1, 0, 0, 1 });
+			debugDraw.Rect({ float(t), 0.0f }, { 1.0f, 1.0f }, { 0, 1, 0, 1 }, true);
+			});
+	}
+	for (auto& thread : threads) thread.join();
+
+	debugDraw.Rect({ 0, 0 }, { 2, 2 }, { 0, 0, 1, 1 });                   // Outline: four hairlines
+	debugDraw.Line({ 0, 0 }, { 10, 0 }, { 1, 1, 1, 1 }, 4.0f);             // Wide: a quad
+	debugDraw.Circle({ 0, 0 }, 5.0f, { 1, 1, 1, 1 }, 16, 60.0f);           // Lasts a minute
+
+	auto command = debugDraw.BuildCommand();
+	REQUIRE(command);
+	REQUIRE(command->layer == RenderLayer::Debug);
+	REQUIRE(command->lines.size() == 2 * (4 * 500 + 4 + 16));
+	REQUIRE(command->quads.size() == 5);
+	REQUIRE(debugDraw.GetStats().drawCalls == 2);
+	REQUIRE(command->lines[0].color == 0xFF0000FFu);   // RGBA bytes in memory
+
+	const auto wide = std::find_if(command->quads.begin(), command->quads.end(),
+		[](const DebugQuadInstance& q) { return q.halfSize.y == 2.0f; });
+	REQUIRE(wide != command->quads.end());
+	REQUIRE(wide->center.x == 5.0f);
+	REQUIRE(wide->halfSize.x == 5.0f);
+	REQUIRE(wide->rotation == 0.0f);
+
+	// The rest was drawn once; the circle stays until cleared
+	auto next = debugDraw.BuildCommand();
+	REQUIRE(next);
+	REQUIRE(next->lines.size() == 32);
+	REQUIRE(next->quads.empty());
+	REQUIRE(debugDraw.GetStats().persistent == 16);
+
+	debugDraw.Clear();
+	REQUIRE_FALSE(debugDraw.BuildCommand());
+
+	// Nothing is lost or drawn twice while threads submit during collection
+	std::atomic<bool> done{ false };
+	std::vector<std::thread> writers;
+	for (int t = 0; t < 2; ++t) {
+		writers.emplace_back([&debugDraw] {
+			for (int i = 0; i < 20000; ++i) debugDraw.Quad({ 0, 0 }, { 1, 1 }, 0.0f, { 1, 1, 1, 1 });
+			});
+	}
+	size_t quads = 0;
+	std::thread collector([&] {
+		while (!done.load()) {
+			if (auto part = debugDraw.BuildCommand()) quads += part->quads.size();
+		}
+		});
+	for (auto& writer : writers) writer.join();
+	done = true;
+	collector.join();
+	if (auto rest = debugDraw.BuildCommand()) quads += rest->quads.size();
+	REQUIRE(quads == 40000);
+}
+
+namespace {
+	const char* RECORDING_VERTEX_SHADER = R"(#version 330 core
+layout(location = 0) in vec2 a_Pos;
+layout(location = 2) in vec2 a_Offset;
+uniform mat4 u_Model;
+uniform int u_UseInstancing;
+uniform float u_TileSize;
+void main() { gl_Position = vec4(a_Pos * u_TileSize + a_Offset, 0.0, 1.0); }
+)";
+
+	const char* RECORDING_FRAGMENT_SHADER = R"(#version 330 core
+uniform int u_UseTextureArray;
+uniform sampler2DArray u_TextureArray;
+out vec4 FragColor;
+void main() { FragColor = vec4(1.0); }
+)";
+}
+
+TEST_CASE("Recording device replays an instanced frame as a golden command stream", "[rendering]") {
+	auto owned = std::make_unique<GL::RecordingDevice>(GL::RecordingDeviceCaps{ .bufferStorage = false });
+	auto* device = owned.get();
+	GL::Device::Install(std::move(owned));
+	auto& gl = GL::Device::Get();
+	auto& cache = GL::StateCache::Get();
+
+	{
+		Shader shader;
+		shader.CompileFromSource(RECORDING_VERTEX_SHADER, RECORDING_FRAGMENT_SHADER);
+		REQUIRE(shader.GetID() != 0);
+
+		// The unit quad: corners in location 0, indexed by an EBO
+		const float corners[] = { 0, 0, 1, 0, 1, 1, 0, 1 };
+		const uint32_t indices[] = { 0, 1, 2, 2, 3, 0 };
+		const GLuint vao = gl.GenVertexArray();
+		const GLuint vbo = gl.GenBuffer();
+		const GLuint ebo = gl.GenBuffer();
+		cache.BindVertexArray(vao);
+		cache.BindBuffer(GL_ARRAY_BUFFER, vbo);
+		gl.BufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+		cache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+		gl.BufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+		gl.EnableVertexAttribArray(0);
+		gl.VertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
+		cache.BindVertexArray(0);
+
+		const GLuint texture = gl.GenTexture();
+		cache.BindTexture(GL_TEXTURE_2D_ARRAY, texture, 1);
+		gl.TexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, 4, 4, 2, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+		StreamBuffer::Get().Initialize(4096, 2);
+		REQUIRE(device->GetErrors().empty());
+
+		// One frame: two batches of the same atlas, so the second only re-points the instances
+		device->TakeLog();
+		device->ResetStats();
+		device->SetLogging(true);
+
+		const std::vector<InstanceRenderer::InstanceData> instances = {
+			{ { 0, 0 }, { 0, 0 }, { 0.5f, 0.5f }, 0.0f },
+			{ { 1, 0 }, { 0.5f, 0 }, { 0.5f, 0.5f }, 1.0f },
+			{ { 2, 0 }, { 0, 0.5f }, { 0.5f, 0.5f }, 1.0f },
+		};
+		{
+			InstanceRenderer renderer;
+			renderer.BeginFrame(&shader, vao, ebo);
+			renderer.RenderInstances(texture, instances, 32.0f, GL_TEXTURE_2D_ARRAY);
+			renderer.RenderInstances(texture, { instances[0] }, 32.0f, GL_TEXTURE_2D_ARRAY);
+			renderer.EndFrame();
+			StreamBuffer::Get().EndFrame();
+		}
+
+		const std::vector<std::string> golden = {
+			"GetUniformLocation(3, u_UseInstancing)",
+			"GetUniformLocation(3, u_TileSize)",
+			"GetUniformLocation(3, u_UseTextureArray)",
+			"GetUniformLocation(3, u_TextureArray)",
+			"UseProgram(3)",
+			"BindVertexArray(4)",
+			"BindBuffer(ELEMENT_ARRAY_BUFFER, 6)",
+			"BindBuffer(ARRAY_BUFFER, 8)",
+			"MapBufferRange(ARRAY_BUFFER, 0, 84, 0x26)",
+			"UnmapBuffer(ARRAY_BUFFER)",
+			"EnableVertexAttribArray(2)",
+			"VertexAttribPointer(2, 2, FLOAT, false, 28, 0)",
+			"VertexAttribDivisor(2, 1)",
+			"EnableVertexAttribArray(3)",
+			"VertexAttribPointer(3, 2, FLOAT, false, 28, 8)",
+			"VertexAttribDivisor(3, 1)",
+			"EnableVertexAttribArray(4)",
+			"VertexAttribPointer(4, 2, FLOAT, false, 28, 16)",
+			"VertexAttribDivisor(4, 1)",
+			"EnableVertexAttribArray(5)",
+			"VertexAttribPointer(5, 1, FLOAT, false, 28, 24)",
+			"VertexAttribDivisor(5, 1)",
+			"Uniform1i(1, 1)",
+			"Uniform1f(2, 32)",
+			"Uniform1i(3, 1)",
+			"Uniform1i(4, 1)",
+			"DrawElementsInstanced(TRIANGLES, 6, UNSIGNED_INT, 0, 3)",
+			"MapBufferRange(ARRAY_BUFFER, 96, 28, 0x26)",
+			"UnmapBuffer(ARRAY_BUFFER)",
+			"EnableVertexAttribArray(2)",
+			"VertexAttribPointer(2, 2, FLOAT, false, 28, 96)",
+			"VertexAttribDivisor(2, 1)",
+			"EnableVertexAttribArray(3)",
+			"VertexAttribPointer(3, 2, FLOAT, false, 28, 104)",
+			"VertexAttribDivisor(3, 1)",
+			"EnableVertexAttribArray(4)",
+			"VertexAttribPointer(4, 2, FLOAT, false, 28, 112)",
+			"VertexAttribDivisor(4, 1)",
+			"EnableVertexAttribArray(5)",
+			"VertexAttribPointer(5, 1, FLOAT, false, 28, 120)",
+			"VertexAttribDivisor(5, 1)",
+			"DrawElementsInstanced(TRIANGLES, 6, UNSIGNED_INT, 0, 1)",
+			"Uniform1i(1, 0)",
+			"BindVertexArray(0)",
+			"BindBuffer(ARRAY_BUFFER, 0)",
+			"FenceSync(1)",
+			"ClientWaitSync(1)",
+			"DeleteSync(1)"
+		};
+		REQUIRE(device->TakeLog() == golden);
+		REQUIRE(device->GetErrors().empty());
+
+		const auto& stats = device->GetStats();
+		REQUIRE(stats.drawCalls == 2);
+		REQUIRE(stats.instances == 4);
+		REQUIRE(stats.vertices == 24);
+		REQUIRE(stats.bufferBytes == 4 * sizeof(InstanceRenderer::InstanceData));
+		REQUIRE(stats.textureBytes == 0);
+
+		device->SetLogging(false);
+		StreamBuffer::Get().Shutdown();
+		for (GLuint buffer : { vbo, ebo }) {
+			cache.ForgetBuffer(buffer);
+			gl.DeleteBuffer(buffer);
+		}
+		cache.ForgetVertexArray(vao);
+		gl.DeleteVertexArray(vao);
+		cache.ForgetTexture(texture);
+		gl.DeleteTexture(texture);
+	}
+
+	// Everything the frame created was deleted again
+	REQUIRE(device->GetLiveObjects().empty());
+	REQUIRE(device->GetErrors().empty());
+	GL::Device::Install(nullptr);
+}
+
+TEST_CASE("Recording device reports invalid calls instead of failing", "[rendering]") {
+	auto owned = std::make_unique<GL::RecordingDevice>();
+	auto* device = owned.get();
+	GL::Device::Install(std::move(owned));
+	auto& gl = GL::Device::Get();
+
+	// Nothing bound
+	gl.DrawArrays(GL_TRIANGLES, 0, 3);
+	REQUIRE(device->GetErrors().size() == 2);   // No program, no vertex array
+	gl.DeleteBuffer(42);
+	REQUIRE(device->GetErrors().back() == "DeleteBuffer: 42 is not a live object");
+
+	// A draw that reads past the end of its vertex buffer
+	const GLuint vao = gl.GenVertexArray();
+	const GLuint vbo = gl.GenBuffer();
+	gl.BindVertexArray(vao);
+	gl.BindBuffer(GL_ARRAY_BUFFER, vbo);
+	gl.BufferData(GL_ARRAY_BUFFER, 4 * sizeof(float), nullptr, GL_STREAM_DRAW);
+	gl.EnableVertexAttribArray(0);
+	gl.VertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+	device->ClearErrors();
+	gl.DrawArrays(GL_LINES, 0, 3);
+	REQUIRE(device->GetErrors().size() == 2);
+	REQUIRE(device->GetErrors().back() == "DrawArrays: attribute 0 reads 24 bytes of buffer 2 (16 bytes)");
+	REQUIRE(device->GetStats().drawCalls == 2);
+
+	// Mapped twice, uploaded to while mapped
+	gl.MapBufferRange(GL_ARRAY_BUFFER, 0, 16, GL_MAP_WRITE_BIT);
+	device->ClearErrors();
+	REQUIRE(gl.MapBufferRange(GL_ARRAY_BUFFER, 0, 16, GL_MAP_WRITE_BIT) == nullptr);
+	gl.BufferSubData(GL_ARRAY_BUFFER, 0, 4, "abcd");
+	REQUIRE(device->GetErrors().size() == 2);
+	gl.UnmapBuffer(GL_ARRAY_BUFFER);
+
+	REQUIRE(device->GetLiveObjects() == std::vector<std::string>{ "vertex array 1", "buffer 2 (16 bytes)" });
+	gl.DeleteVertexArray(vao);
+	gl.DeleteBuffer(vbo);
+	REQUIRE(device->GetLiveObjects().empty());
+	GL::Device::Install(nullptr);
+}
+
+namespace {
+	const char* SPRITE_VERTEX_SHADER = R"(#version 330 core
+layout(location = 0) in vec2 a_Pos;
+layout(location = 2) in vec2 a_Offset;
+layout(location = 3) in vec2 a_UVOffset;
+layout(location = 4) in vec2 a_UVSize;
+layout(location = 5) in float a_Layer;
+uniform mat4 u_Model;
+uniform int u_UseInstancing;
+uniform float u_TileSize;
+uniform vec2 u_UVOffset;
+uniform vec2 u_UVSize;
+void main() { gl_Position = vec4(a_Pos * u_TileSize + a_Offset, 0.0, 1.0); }
+)";
+
+	const char* SPRITE_FRAGMENT_SHADER = R"(#version 330 core
+uniform sampler2D u_Texture;
+uniform sampler2DArray u_TextureArray;
+uniform int u_UseTexture;
+uniform int u_UseTextureArray;
+uniform float u_Layer;
+uniform vec3 u_Color;
+out vec4 FragColor;
+void main() { FragColor = vec4(u_Color, 1.0); }
+)";
+
+	/// What RenderSystem draws with, on the installed device: the "sprite"
+	/// shader, a "terrain" atlas of two frames, the shared quad and tiles 1 and 2
+	struct RenderSystemScene {
+		std::filesystem::path dir = std::filesystem::temp_directory_path() / "wanderspire_render_test";
+		TextureAtlas* atlas = nullptr;
+		GLuint vao = 0, vbo = 0, ebo = 0;
+
+		explicit RenderSystemScene(size_t streamBytes) {
+			auto& gl = GL::Device::Get();
+			auto& cache = GL::StateCache::Get();
+			auto& rm = RenderResourceManager::Get();
+
+			// Created first, so their ids do not depend on what earlier tests left registered
+			const float corners[] = { -0.5f, -0.5f, 0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f };
+			const uint32_t indices[] = { 0, 1, 2, 2, 3, 0 };
+			vao = gl.GenVertexArray();
+			vbo = gl.GenBuffer();
+			ebo = gl.GenBuffer();
+			cache.BindVertexArray(vao);
+			cache.BindBuffer(GL_ARRAY_BUFFER, vbo);
+			gl.BufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+			cache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+			gl.BufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+			gl.EnableVertexAttribArray(0);
+			gl.VertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
+			cache.BindVertexArray(0);
+			rm.Init(vao, ebo);
+			StreamBuffer::Get().Initialize(streamBytes, 2);
+			rm.RegisterShaderSource("sprite", SPRITE_VERTEX_SHADER, SPRITE_FRAGMENT_SHADER);
+
+			// Two 4x4 frames side by side
+			std::filesystem::create_directories(dir);
+			const std::vector<uint8_t> pixels(8 * 4 * 4, 255);
+			stbi_write_png((dir / "terrain.png").string().c_str(), 8, 4, 4, pixels.data(), 8 * 4);
+			std::ofstream(dir / "terrain.json") << R"({ "meta": {}, "frames": {
+				"grass": { "x": 0, "y": 0, "w": 4, "h": 4 },
+				"stone": { "x": 4, "y": 0, "w": 4, "h": 4 } } })";
+			rm.RegisterAtlas("terrain", (dir / "terrain.png").string(), (dir / "terrain.json").string());
+			atlas = rm.GetAtlas("terrain");
+
+			auto& tileDefs = TileDefinitionManager::GetInstance();
+			tileDefs.RegisterTile(1, "terrain", "grass");
+			tileDefs.RegisterTile(2, "terrain", "stone");
+		}
+
+		~RenderSystemScene() {
+			auto& gl = GL::Device::Get();
+			auto& cache = GL::StateCache::Get();
+			RenderResourceManager::Get().Shutdown();
+			RenderResourceManager::Get().Init(0, 0);
+			StreamBuffer::Get().Shutdown();
+			FrameUniforms::Get().Shutdown();
+			for (GLuint buffer : { vbo, ebo }) {
+				cache.ForgetBuffer(buffer);
+				gl.DeleteBuffer(buffer);
+			}
+			cache.ForgetVertexArray(vao);
+			gl.DeleteVertexArray(vao);
+			TileDefinitionManager::GetInstance().Clear();
+			TileRenderTable::GetInstance().Clear();
+			std::filesystem::remove_all(dir);
+		}
+
+		/// A sprite of the atlas; textureID 0 draws it untextured
+		static void AddSprite(entt::registry& reg, const glm::vec2& position, float size, GLuint textureID,
+			const AtlasFrame& frame, int zOrder) {
+			const auto entity = reg.create();
+			auto& render = reg.emplace<SpriteRenderComponent>(entity);
+			render.textureID = textureID;
+			render.worldSize = glm::vec2(size);
+			render.uvOffset = frame.uvOffset;
+			render.uvSize = frame.uvSize;
+			reg.emplace<TransformComponent>(entity).localPosition = position;
+			reg.emplace<ObstacleComponent>(entity).zOrder = zOrder;
+		}
+
+		/// One frame as the game submits it: the layer's terrain, then the culled entities
+		static void Frame(const entt::registry& reg, entt::entity layer, const glm::vec2& minBound,
+			const glm::vec2& maxBound, float tileSize) {
+			auto& renderMgr = RenderManager::Get();
+			renderMgr.SetViewport(0, 0, 64, 48);
+			renderMgr.BeginFrame(glm::mat4(1.0f));
+			renderMgr.SubmitCustom([&] { RenderSystem::RenderTilemapLayer(reg, layer, minBound, maxBound, tileSize); },
+				RenderLayer::Terrain);
+			renderMgr.Submit(RenderSystem::BuildEntityCommands(reg, minBound, maxBound));
+			renderMgr.EndFrame();
+			renderMgr.ExecuteFrame();
+		}
+	};
+}
+
+TEST_CASE("RenderSystem draws terrain and sprites as a golden command stream", "[rendering]") {
+	auto owned = std::make_unique<GL::RecordingDevice>(GL::RecordingDeviceCaps{ .bufferStorage = false });
+	auto* device = owned.get();
+	GL::Device::Install(std::move(owned));
+
+	{
+		RenderSystemScene scene(4096);
+		REQUIRE(scene.atlas);
+		REQUIRE(scene.atlas->GetPageCount() == 1);
+
+		// 4x3 tiles of grass with a row of stone, two sprites in view and one culled
+		entt::registry reg;
+		auto& tilemaps = TilemapSystem::GetInstance();
+		auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+		auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+		tilemaps.FillRect(reg, layer, { 0, 0 }, { 3, 2 }, 1);
+		tilemaps.FillRect(reg, layer, { 0, 1 }, { 3, 1 }, 2);
+
+		const AtlasFrame stone = scene.atlas->GetFrame("stone");
+		const GLuint atlasTexture = scene.atlas->GetTextureID(stone);
+		RenderSystemScene::AddSprite(reg, { 24.0f, 8.0f }, 16.0f, atlasTexture, stone, 1);
+		RenderSystemScene::AddSprite(reg, { 40.0f, 24.0f }, 8.0f, 0, { glm::vec2(0.0f), glm::vec2(1.0f) }, 0);
+		RenderSystemScene::AddSprite(reg, { 500.0f, 500.0f }, 16.0f, atlasTexture, stone, 0);
+
+		// The first frame resolves tiles and uniforms; the golden is the steady frame after it
+		const glm::vec2 minBound(0.0f), maxBound(64.0f, 48.0f);
+		RenderSystemScene::Frame(reg, layer, minBound, maxBound, 16.0f);
+		REQUIRE(device->GetErrors().empty());
+
+		device->TakeLog();
+		device->ResetStats();
+		device->SetLogging(true);
+		RenderSystemScene::Frame(reg, layer, minBound, maxBound, 16.0f);
+
+		const std::vector<std::string> golden = {
+			"Clear(COLOR)",
+			"BufferSubData(UNIFORM_BUFFER, 0, 96, data)",
+			"UseProgram(7)",
+			"BindVertexArray(1)",
+			"BindBuffer(ELEMENT_ARRAY_BUFFER, 3)",
+			"BindBuffer(ARRAY_BUFFER, 4)",
+			"MapBufferRange(ARRAY_BUFFER, 336, 336, 0x26)",
+			"UnmapBuffer(ARRAY_BUFFER)",
+			"EnableVertexAttribArray(2)",
+			"VertexAttribPointer(2, 2, FLOAT, false, 28, 336)",
+			"VertexAttribDivisor(2, 1)",
+			"EnableVertexAttribArray(3)",
+			"VertexAttribPointer(3, 2, FLOAT, false, 28, 344)",
+			"VertexAttribDivisor(3, 1)",
+			"EnableVertexAttribArray(4)",
+			"VertexAttribPointer(4, 2, FLOAT, false, 28, 352)",
+			"VertexAttribDivisor(4, 1)",
+			"EnableVertexAttribArray(5)",
+			"VertexAttribPointer(5, 1, FLOAT, false, 28, 360)",
+			"VertexAttribDivisor(5, 1)",
+			"Uniform1i(1, 1)",
+			"DrawElementsInstanced(TRIANGLES, 6, UNSIGNED_INT, 0, 12)",
+			"Uniform1i(1, 0)",
+			"BindVertexArray(0)",
+			"BindBuffer(ARRAY_BUFFER, 0)",
+			"BindVertexArray(1)",
+			"BindBuffer(ELEMENT_ARRAY_BUFFER, 3)",
+			"Uniform1i(7, 0)",
+			"UniformMatrix4fv(0, 1, false, data)",
+			"Uniform2f(3, 0, 0)",
+			"Uniform2f(4, 1, 1)",
+			"DrawElements(TRIANGLES, 6, UNSIGNED_INT, 0)",
+			"Uniform1i(7, 1)",
+			"UniformMatrix4fv(0, 1, false, data)",
+			"Uniform2f(3, 0.5625, 0.125)",
+			"Uniform2f(4, 0.375, 0.75)",
+			"DrawElements(TRIANGLES, 6, UNSIGNED_INT, 0)",
+			"BindVertexArray(0)",
+			"UseProgram(0)",
+			"FenceSync(2)",
+			"ClientWaitSync(2)",
+			"DeleteSync(2)"
+		};
+		REQUIRE(device->TakeLog() == golden);
+		REQUIRE(device->GetErrors().empty());
+
+		// One instanced draw for the 12 tiles, one draw per sprite in view
+		const auto& stats = device->GetStats();
+		REQUIRE(stats.drawCalls == 3);
+		REQUIRE(stats.instances == 12 + 2);
+		REQUIRE(stats.clears == 1);
+		REQUIRE(stats.textureBytes == 0);
+		device->SetLogging(false);
+	}
+
+	// The scene's shader, atlas pages, quad and buffers were all deleted again
+	REQUIRE(device->GetLiveObjects().empty());
+	REQUIRE(device->GetErrors().empty());
+	GL::Device::Install(nullptr);
+}
+
+TEST_CASE("Parallel terrain layers match the serial path", "[rendering]") {
+	// One run's second frame of five layers: the command stream, and the stream
+	// buffer holding both frames' tile instances
+	auto record = [](unsigned threads) {
+		auto owned = std::make_unique<GL::RecordingDevice>(GL::RecordingDeviceCaps{ .bufferStorage = false });
+		auto* device = owned.get();
+		GL::Device::Install(std::move(owned));
+		auto& pool = RenderJobPool::Get();
+		const unsigned previousThreads = pool.GetThreadCount();
+		pool.SetThreadCount(threads);
+
+		std::vector<std::string> log;
+		std::vector<uint8_t> instances;
+		{
+			RenderSystemScene scene(64 * 1024);
+			entt::registry reg;
+			auto& tilemaps = TilemapSystem::GetInstance();
+			auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+
+			// Layers of different sizes and sorting orders, two of them tied; tile 9
+			// has no definition and is reported rather than drawn
+			const int orders[] = { 2, 0, 1, 0, -1 };
+			for (int i = 0; i < 5; ++i) {
+				auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Layer" + std::to_string(i));
+				reg.get<TilemapLayerComponent>(layer).sortingOrder = orders[i];
+				tilemaps.FillRect(reg, layer, { i, 0 }, { 3 + i * 2, 2 + i }, 1 + i % 2);
+				tilemaps.SetTile(reg, layer, { i, i }, 9);
+			}
+
+			auto frame = [&] {
+				auto& renderMgr = RenderManager::Get();
+				renderMgr.SetViewport(0, 0, 64, 48);
+				renderMgr.BeginFrame(glm::mat4(1.0f));
+				RenderSystem::SubmitTilemapLayers(reg, { tilemap }, glm::vec2(0.0f), glm::vec2(256.0f, 192.0f), 16.0f);
+				renderMgr.EndFrame();
+				renderMgr.ExecuteFrame();
+			};
+			frame();
+			device->SetLogging(true);
+			frame();
+			log = device->TakeLog();
+			device->SetLogging(false);
+			if (const auto* contents = device->GetBufferContents(StreamBuffer::Get().GetBuffer())) instances = *contents;
+			REQUIRE(device->GetErrors().empty());
+		}
+
+		pool.SetThreadCount(previousThreads);
+		GL::Device::Install(nullptr);
+		return std::make_pair(log, instances);
+	};
+
+	const auto serial = record(1);
+	REQUIRE(std::count_if(serial.first.begin(), serial.first.end(),
+		[](const std::string& call) { return call.rfind("DrawElementsInstanced", 0) == 0; }) == 5);
+	REQUIRE(std::any_of(serial.second.begin(), serial.second.end(), [](uint8_t byte) { return byte != 0; }));
+	for (unsigned threads : { 2u, 4u, 7u }) {
+		INFO("threads: " << threads);
+		REQUIRE(record(threads) == serial);
+	}
+}
+
+TEST_CASE("RenderSystem frame of terrain and sprites", "[.][benchmark][rendering]") {
+	auto owned = std::make_unique<GL::RecordingDevice>(GL::RecordingDeviceCaps{ .bufferStorage = false });
+	auto* device = owned.get();
+	GL::Device::Install(std::move(owned));
+
+	{
+		RenderSystemScene scene(8u << 20);
+		REQUIRE(scene.atlas);
+
+		// The golden scene scaled up: 128x128 tiles under 4000 sprites, three quarters in view
+		entt::registry reg;
+		auto& tilemaps = TilemapSystem::GetInstance();
+		auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+		auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+		tilemaps.FillRect(reg, layer, { 0, 0 }, { 127, 127 }, 1);
+		for (int y = 1; y < 128; y += 4) tilemaps.FillRect(reg, layer, { 0, y }, { 127, y }, 2);
+
+		const AtlasFrame stone = scene.atlas->GetFrame("stone");
+		const GLuint atlasTexture = scene.atlas->GetTextureID(stone);
+		uint32_t seed = 777u;
+		auto next = [&seed] { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+		for (int i = 0; i < 4000; ++i) {
+			const glm::vec2 position(static_cast<float>(next() % 2048), static_cast<float>(next() % 2048));
+			RenderSystemScene::AddSprite(reg, position, 16.0f, i % 4 ? atlasTexture : 0, stone, static_cast<int>(next() % 5));
+		}
+
+		const glm::vec2 minBound(0.0f), maxBound(2048.0f, 1536.0f);
+		RenderSystemScene::Frame(reg, layer, minBound, maxBound, 16.0f);   // Warm the tile table
+		device->ResetStats();
+
+		constexpr int kFrames = 20;
+		const auto t0 = std::chrono::steady_clock::now();
+		for (int i = 0; i < kFrames; ++i) RenderSystemScene::Frame(reg, layer, minBound, maxBound, 16.0f);
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+		const auto& stats = device->GetStats();
+		WARN(ms / kFrames << " ms per frame, " << stats.drawCalls / kFrames << " draws, "
+			<< stats.UploadedBytes() / kFrames << " bytes uploaded");
+		REQUIRE(device->GetErrors().empty());
+	}
+
+	REQUIRE(device->GetLiveObjects().empty());
+	GL::Device::Install(nullptr);
+}
+
+TEST_CASE("Tile lookup layers upload only the tiles that changed", "[rendering]") {
+	auto owned = std::make_unique<GL::RecordingDevice>();
+	auto* device = owned.get();
+	GL::Device::Install(std::move(owned));
+
+	entt::registry reg;
+	auto& tilemaps = TilemapSystem::GetInstance();
+	auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+	auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+	tilemaps.FillRect(reg, layer, { -32, 0 }, { 63, 63 }, 1);   // 3x2 chunks
+
+	std::unordered_map<int, TileRenderEntry> frames{
+		{ 1, { glm::vec2(0.0f), glm::vec2(0.25f), nullptr, 0 } },
+		{ 2, { glm::vec2(0.25f, 0.5f), glm::vec2(0.25f), nullptr, 1 } } };
+	auto resolve = [&](int tileId) -> const TileRenderEntry* {
+		auto it = frames.find(tileId);
+		return it == frames.end() ? nullptr : &it->second;
+	};
+
+	auto& lookup = TileLookupRenderer::Get();
+	lookup.Clear();
+	const float tileSize = 16.0f;
+	const glm::vec2 viewMin(-1000.0f), viewMax(2000.0f);
+	auto frame = [&](const glm::vec2& min, const glm::vec2& max, bool draw = true) {
+		lookup.BeginFrame();
+		auto packet = lookup.Prepare(reg, layer, resolve, nullptr, nullptr, min, max, tileSize);
+		if (packet && draw) TileLookupRenderer::Draw(*packet);
+		return lookup.GetStats();
+	};
+
+	// The first frame sends the textures whole
+	auto stats = frame(viewMin, viewMax);
+	REQUIRE(stats.residentChunks == 6);
+	REQUIRE(stats.drawnChunks == 6);
+	REQUIRE(stats.fullUploads == 1);
+	REQUIRE(lookup.Sample(layer, { 5.5f * tileSize, 3.25f * tileSize }, tileSize).tileId == 1);
+	REQUIRE(lookup.Sample(layer, { 0.0f, -0.5f * tileSize }, tileSize).tileId == -1);
+
+	// One tile: one texel, and one lookup row for the new id
+	tilemaps.SetTile(reg, layer, { -7, 40 }, 2);
+	stats = frame(viewMin, viewMax);
+	REQUIRE(stats.fullUploads == 0);
+	REQUIRE(stats.indexTexels == 1);
+	REQUIRE(stats.lookupTexels == TileLookupRenderer::LOOKUP_IDS_PER_ROW * 2);
+	const auto sample = lookup.Sample(layer, { -6.5f * tileSize, 40.25f * tileSize }, tileSize);
+	REQUIRE(sample.tileId == 2);
+	REQUIRE(sample.uv.x == 0.25f + 0.5f * 0.25f);
+	REQUIRE(sample.uv.y == 0.5f + 0.25f * 0.25f);
+	REQUIRE(sample.page == 1);
+
+	// Nothing changed: nothing sent
+	stats = frame(viewMin, viewMax);
+	REQUIRE(stats.indexTexels == 0);
+	REQUIRE(stats.lookupTexels == 0);
+
+	// A rectangle across a chunk border: its tiles, one region per chunk
+	tilemaps.FillRect(reg, layer, { 30, 5 }, { 33, 6 }, 2);
+	stats = frame(viewMin, viewMax);
+	REQUIRE(stats.indexTexels == 8);
+	REQUIRE(lookup.Sample(layer, { 33.5f * tileSize, 6.5f * tileSize }, tileSize).tileId == 2);
+
+	// Zooming changes the quads drawn, never the tiles touched
+	stats = frame({ 40.0f, 40.0f }, { 60.0f, 60.0f });
+	REQUIRE(stats.drawnChunks == 1);
+	REQUIRE(stats.indexTexels == 0);
+	stats = frame(viewMin, viewMax);
+	REQUIRE(stats.drawnChunks == 6);
+	REQUIRE(stats.indexTexels == 0);
+
+	// Unloaded chunks give their region back
+	tilemaps.UnloadChunk(reg, layer, { 1, 1 });
+	stats = frame(viewMin, viewMax);
+	REQUIRE(stats.residentChunks == 5);
+	REQUIRE(lookup.Sample(layer, { 40.5f * tileSize, 40.5f * tileSize }, tileSize).tileId == -1);
+
+	// A lost packet makes the next one send everything again
+	tilemaps.SetTile(reg, layer, { 0, 0 }, 2);
+	frame(viewMin, viewMax, false);
+	frame(viewMin, viewMax);
+	stats = frame(viewMin, viewMax);
+	REQUIRE(stats.fullUploads == 1);
+
+	REQUIRE(device->GetErrors().empty());
+	REQUIRE(device->GetStats().textureBytes > 0);
+	lookup.Shutdown();
+	REQUIRE(device->GetLiveObjects().empty());
+	GL::Device::Install(nullptr);
+}
+
+TEST_CASE("Tile lookup animation rewrites lookup rows, not tiles", "[rendering]") {
+	auto& table = TileRenderTable::GetInstance();
+	table.Clear();
+	table.SetEntry(40, { glm::vec2(0.0f), glm::vec2(0.5f), nullptr });
+	table.SetEntry(41, { glm::vec2(0.5f, 0.0f), glm::vec2(0.5f), nullptr });
+	table.SetAnimation(7, { { 40, 0.5f }, { 41, 0.5f } });
+
+	entt::registry reg;
+	auto& tilemaps = TilemapSystem::GetInstance();
+	auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+	auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Water");
+	tilemaps.FillRect(reg, layer, { 0, 0 }, { 63, 31 }, 7);
+
+	// Animated ids are drawn as the frame tile the table shows
+	auto resolve = [&](int tileId) { return table.GetEntry(table.GetDisplayTile(tileId)); };
+	auto& lookup = TileLookupRenderer::Get();
+	lookup.Clear();
+	auto frame = [&](double time) {
+		table.SetTime(time);
+		table.ResolveAnimations();
+		lookup.BeginFrame();
+		lookup.Prepare(reg, layer, resolve, nullptr, nullptr, glm::vec2(0.0f), glm::vec2(1024.0f), 1.0f);
+		return lookup.GetStats();
+	};
+
+	frame(0.0);
+	REQUIRE(lookup.Sample(layer, { 10.5f, 3.5f }, 1.0f).uv.x == 0.25f);
+
+	// 2048 tiles change frame; one lookup row is sent
+	const auto stats = frame(0.75);
+	REQUIRE(stats.indexTexels == 0);
+	REQUIRE(stats.lookupTexels == TileLookupRenderer::LOOKUP_IDS_PER_ROW * 2);
+	const auto sample = lookup.Sample(layer, { 10.5f, 3.5f }, 1.0f);
+	REQUIRE(sample.tileId == 7);
+	REQUIRE(sample.uv.x == 0.75f);
+
+	lookup.Clear();
+	table.Clear();
+}
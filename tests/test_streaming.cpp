@@ -0,0 +1,297 @@
+﻿#include <catch2/catch_test_macros.hpp>
+#include "TestHelpers.h"
+#include <WanderSpire/World/ChunkEvictionCache.h>
+#include <WanderSpire/World/ChunkGenerationService.h>
+#include <WanderSpire/World/TilemapFile.h>
+
+#include <algorithm>
+#include <filesystem>
+
+TEST_CASE("Unloaded chunks come back from the eviction cache", "[tilemap][streaming]") {
+	entt::registry reg;
+	auto& tilemaps = TilemapSystem::GetInstance();
+	auto& cache = ChunkEvictionCache::GetInstance();
+	auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+	auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+	const size_t budget = cache.GetBudget();
+	cache.SetBudget(1 << 20);
+
+	REQUIRE(tilemaps.FillRect(reg, layer, { 0, 0 }, { 31, 31 }, 1) == 1024);
+	tilemaps.SetTile(reg, layer, { 3, 4 }, 7);
+	tilemaps.SetTile(reg, layer, { 40, 0 }, 2);
+	tilemaps.CompactChunk(reg, layer, { 1, 0 });
+
+	tilemaps.UnloadChunk(reg, layer, { 0, 0 });
+	tilemaps.UnloadChunk(reg, layer, { 1, 0 });
+	REQUIRE_FALSE(tilemaps.IsChunkLoaded(reg, layer, { 0, 0 }));
+	auto stats = cache.GetStats(reg);
+	REQUIRE(stats.stores == 2);
+	REQUIRE(stats.bytes * 20 < stats.rawBytes);
+
+	tilemaps.LoadChunk(reg, layer, { 0, 0 });
+	REQUIRE(tilemaps.GetTile(reg, layer, { 3, 4 }) == 7);
+	REQUIRE(tilemaps.CountTilesInRect(reg, layer, { 0, 0 }, { 31, 31 }, 1) == 1023);
+
+	// Brand-new chunks are no miss; an empty one unloaded and reloaded is
+	tilemaps.LoadChunk(reg, layer, { 5, 5 });
+	REQUIRE(cache.GetStats(reg).misses == 0);
+	tilemaps.UnloadChunk(reg, layer, { 5, 5 });
+	tilemaps.LoadChunk(reg, layer, { 5, 5 });
+	stats = cache.GetStats(reg);
+	REQUIRE(stats.hits == 1);
+	REQUIRE(stats.misses == 1);
+	REQUIRE(stats.entries == 1);
+
+	// A write to an unloaded chunk recreates it from the cache first
+	tilemaps.SetTile(reg, layer, { 41, 0 }, 3);
+	REQUIRE(tilemaps.GetTile(reg, layer, { 40, 0 }) == 2);
+	REQUIRE(cache.GetStats(reg).hits == 2);
+
+	tilemaps.UnloadChunk(reg, layer, { 1, 0 });
+	REQUIRE(cache.GetStats(reg).entries == 1);
+
+	// Edits nothing else could recreate are pinned: even a one-byte budget keeps them
+	cache.SetBudget(1);
+	stats = cache.GetStats(reg);
+	REQUIRE(stats.evictions == 0);
+	REQUIRE(stats.pinned == 1);
+	REQUIRE(stats.bytes > 0);
+	cache.Forget(reg, layer);
+	cache.SetBudget(budget);
+}
+
+TEST_CASE("Erased and edited generated chunks are not generated again", "[tilemap][streaming]") {
+	entt::registry reg;
+	auto& tilemaps = TilemapSystem::GetInstance();
+	auto& cache = ChunkEvictionCache::GetInstance();
+	auto& generation = ChunkGenerationService::GetInstance();
+	auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+	auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+	const size_t budget = cache.GetBudget();
+	cache.SetBudget(1 << 20);
+
+	NoiseChunkGenerator::Settings settings;
+	settings.bands = { { 1.0f, 10 } };
+	generation.SetGenerator(reg, layer, std::make_shared<NoiseChunkGenerator>(settings), 7);
+	for (int cx = 0; cx < 3; ++cx) tilemaps.LoadChunk(reg, layer, { cx, 0 });
+	REQUIRE(generation.Drain(reg) == 3);
+	REQUIRE(tilemaps.GetTile(reg, layer, { 5, 5 }) == 10);
+
+	// Chunk 0 erased, chunk 1 edited, chunk 2 left as generated
+	tilemaps.FillRect(reg, layer, { 0, 0 }, { 31, 31 }, -1);
+	tilemaps.SetTile(reg, layer, { 40, 5 }, 3);
+	for (int cx = 0; cx < 3; ++cx) tilemaps.UnloadChunk(reg, layer, { cx, 0 });
+	auto stats = cache.GetStats(reg);
+	REQUIRE(stats.entries == 3);
+	REQUIRE(stats.pinned == 2);
+
+	// Only the chunk the generator can make again is evicted
+	cache.SetBudget(1);
+	stats = cache.GetStats(reg);
+	REQUIRE(stats.evictions == 1);
+	REQUIRE(stats.entries == 2);
+	REQUIRE(cache.Contains(reg, layer, { 0, 0 }));
+	REQUIRE_FALSE(cache.Contains(reg, layer, { 2, 0 }));
+
+	for (int cx = 0; cx < 3; ++cx) tilemaps.LoadChunk(reg, layer, { cx, 0 });
+	REQUIRE(generation.Drain(reg) == 1);
+	REQUIRE(tilemaps.GetTile(reg, layer, { 5, 5 }) == -1);
+	REQUIRE(tilemaps.GetTile(reg, layer, { 40, 5 }) == 3);
+	REQUIRE(tilemaps.GetTile(reg, layer, { 41, 5 }) == 10);
+	REQUIRE(tilemaps.GetTile(reg, layer, { 70, 5 }) == 10);
+	REQUIRE(cache.GetStats(reg).entries == 0);
+
+	// Restored edits stay pinned when they stream out again
+	tilemaps.UnloadChunk(reg, layer, { 0, 0 });
+	REQUIRE(cache.GetStats(reg).pinned == 1);
+	generation.ClearGenerator(reg, layer);
+	cache.Forget(reg, layer);
+	cache.SetBudget(budget);
+}
+
+TEST_CASE("Generated chunks are identical for any worker count", "[tilemap][streaming]") {
+	auto& tilemaps = TilemapSystem::GetInstance();
+	auto& generation = ChunkGenerationService::GetInstance();
+
+	NoiseChunkGenerator::Settings settings;
+	settings.frequency = 0.07f;
+	settings.bands = { { -0.2f, 10 }, { 0.3f, 11 }, { 0.6f, 12 } };
+	settings.fallbackTileId = 13;
+	settings.stamps.push_back({ 2, 2, { 20, 21, -1, 22 }, 11, 0.02f });
+	auto generator = std::make_shared<NoiseChunkGenerator>(settings);
+
+	// Records every tile of a 6×6-chunk region generated with the given worker count
+	auto record = [&](unsigned threads) {
+		entt::registry reg;
+		auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+		auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+		generation.SetThreadCount(threads);
+		generation.SetGenerator(reg, layer, generator, 1234);
+
+		for (int cy = -3; cy < 3; ++cy)
+			for (int cx = -3; cx < 3; ++cx) tilemaps.LoadChunk(reg, layer, { cx, cy });
+		REQUIRE(generation.GetPendingCount(reg) == 36);
+		REQUIRE_FALSE(tilemaps.IsChunkLoaded(reg, layer, { 0, 0 }));
+
+		REQUIRE(generation.Drain(reg) == 36);
+		REQUIRE(generation.GetPendingCount(reg) == 0);
+		std::vector<int> tiles(192 * 192);
+		tilemaps.ReadRect(reg, layer, { -96, -96 }, { 95, 95 }, tiles.data());
+		generation.ClearGenerator(reg, layer);
+		return tiles;
+	};
+
+	const auto single = record(1);
+	REQUIRE(std::none_of(single.begin(), single.end(), [](int id) { return id == -1; }));
+	REQUIRE(std::count(single.begin(), single.end(), 20) > 0);
+	REQUIRE(record(2) == single);
+	REQUIRE(record(7) == single);
+
+	// A chunk authored while its generation is in flight keeps the authored tiles
+	entt::registry reg;
+	auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+	auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+	generation.SetGenerator(reg, layer, generator, 1234);
+	tilemaps.LoadChunk(reg, layer, { 0, 0 });
+	tilemaps.SetTile(reg, layer, { 1, 1 }, 99);
+	REQUIRE(generation.Drain(reg) == 0);
+	REQUIRE(tilemaps.GetTile(reg, layer, { 0, 0 }) == -1);
+	REQUIRE(tilemaps.GetTile(reg, layer, { 1, 1 }) == 99);
+	generation.ClearGenerator(reg, layer);
+	generation.SetThreadCount(0);
+}
+
+TEST_CASE("Noise generator stamps cross chunk borders", "[tilemap][streaming]") {
+	NoiseChunkGenerator::Settings settings;
+	settings.bands = { { 1.0f, 10 } };
+	settings.stamps.push_back({ 3, 2, { 20, 21, 22, 23, 24, 25 }, 10, 0.25f });
+	NoiseChunkGenerator generator(settings);
+
+	auto generate = [&](const glm::ivec2& coords, int size) {
+		const ChunkGenerationContext context{ coords, size, 99, Noise::ChunkSeed(99, coords) };
+		std::vector<int> tiles(static_cast<size_t>(size * size), -1);
+		std::vector<uint32_t> data(static_cast<size_t>(size * size), 0);
+		generator.Generate(context, tiles.data(), data.data());
+		return tiles;
+	};
+
+	// Two 32-tile chunks side by side match the top half of one 64-tile chunk
+	const auto left = generate({ 0, 0 }, 32), right = generate({ 1, 0 }, 32), whole = generate({ 0, 0 }, 64);
+	int mismatches = 0, carried = 0;
+	for (int y = 0; y < 32; ++y) {
+		for (int x = 0; x < 64; ++x) {
+			mismatches += whole[y * 64 + x] != (x < 32 ? left[y * 32 + x] : right[y * 32 + x - 32]);
+		}
+		// Right-hand columns of stamps anchored in the left chunk
+		const int edge = right[y * 32];
+		carried += edge == 21 || edge == 22 || edge == 24 || edge == 25;
+	}
+	REQUIRE(mismatches == 0);
+	REQUIRE(carried > 0);
+
+	// Density 1 stamps at every anchor; each tile ends up as its own anchor's corner
+	settings.stamps[0].density = 1.0f;
+	NoiseChunkGenerator dense(settings);
+	const ChunkGenerationContext context{ { -1, 2 }, 16, 5, Noise::ChunkSeed(5, { -1, 2 }) };
+	std::vector<int> tiles(256, -1);
+	std::vector<uint32_t> data(256, 0);
+	dense.Generate(context, tiles.data(), data.data());
+	REQUIRE(std::all_of(tiles.begin(), tiles.end(), [](int id) { return id == 20; }));
+}
+
+TEST_CASE("Tilemap files map chunks in place until written", "[tilemap][streaming]") {
+	auto& tilemaps = TilemapSystem::GetInstance();
+	const std::string path = (std::filesystem::temp_directory_path() / "wanderspire_test.wstiles").string();
+
+	{
+		entt::registry reg;
+		auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+		auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+		tilemaps.FillRect(reg, layer, { -40, -8 }, { 70, 20 }, 4);
+		tilemaps.SetTile(reg, layer, { 5, 5 }, 9);
+		tilemaps.LoadChunk(reg, layer, { 10, 10 });   // empty, left out of the file
+		REQUIRE(tilemaps.SaveLayerFile(reg, layer, path));
+	}
+
+	auto file = TilemapFileReader::Open(path);
+	REQUIRE(file);
+	REQUIRE(file->GetChunkCount() == 10);
+	REQUIRE_FALSE(file->HasChunk({ 10, 10 }));
+	REQUIRE(file->Verify());
+	file.reset();
+
+	{
+		entt::registry reg;
+		auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+		auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+		REQUIRE(tilemaps.OpenLayerFile(reg, layer, path));
+		REQUIRE_FALSE(tilemaps.IsChunkLoaded(reg, layer, { 0, 0 }));
+
+		// Loading points the chunk at the mapped pages: no tile memory of its own
+		tilemaps.LoadChunk(reg, layer, { 0, 0 });
+		const auto chunk = reg.view<TilemapChunkComponent>().front();
+		REQUIRE(reg.get<TilemapChunkComponent>(chunk).mapped);
+		REQUIRE(tilemaps.GetLayerTileMemory(reg, layer) == 0);
+		REQUIRE(tilemaps.GetTile(reg, layer, { 5, 5 }) == 9);
+		REQUIRE(tilemaps.GetTile(reg, layer, { 6, 5 }) == 4);
+		REQUIRE(tilemaps.CountTilesInRect(reg, layer, { 0, 0 }, { 31, 31 }, 4) == 32 * 21 - 1);
+
+		// Writing to a chunk in the file materializes it first; the first write copies it out
+		tilemaps.SetTile(reg, layer, { -40, -8 }, 7);
+		REQUIRE(tilemaps.GetTile(reg, layer, { -39, -8 }) == 4);
+		tilemaps.SetTile(reg, layer, { 6, 5 }, 2);
+		REQUIRE_FALSE(reg.get<TilemapChunkComponent>(chunk).mapped);
+		REQUIRE(tilemaps.GetTile(reg, layer, { 6, 5 }) == 2);
+		REQUIRE(tilemaps.GetTile(reg, layer, { 5, 5 }) == 9);
+
+		// An edited chunk survives unloading; an untouched one comes back from the file
+		tilemaps.UnloadChunk(reg, layer, { 0, 0 });
+		tilemaps.LoadChunk(reg, layer, { 0, 0 });
+		REQUIRE(tilemaps.GetTile(reg, layer, { 6, 5 }) == 2);
+		tilemaps.LoadChunk(reg, layer, { 2, 0 });
+		tilemaps.UnloadChunk(reg, layer, { 2, 0 });
+		tilemaps.LoadChunk(reg, layer, { 2, 0 });
+		REQUIRE(tilemaps.GetTile(reg, layer, { 70, 20 }) == 4);
+
+		// An erased chunk stays erased rather than coming back from the file
+		tilemaps.LoadChunk(reg, layer, { 1, 0 });
+		tilemaps.FillRect(reg, layer, { 32, 0 }, { 63, 31 }, -1);
+		tilemaps.UnloadChunk(reg, layer, { 1, 0 });
+		REQUIRE(ChunkEvictionCache::GetInstance().Contains(reg, layer, { 1, 0 }));
+		tilemaps.LoadChunk(reg, layer, { 1, 0 });
+		REQUIRE(tilemaps.GetTile(reg, layer, { 40, 5 }) == -1);
+		tilemaps.UnloadChunk(reg, layer, { 1, 0 });
+
+		// Saving over the attached file keeps what isn't loaded: the edited chunk
+		// held by the eviction cache and the chunks only the file has, minus the erased one
+		tilemaps.UnloadChunk(reg, layer, { 0, 0 });
+		REQUIRE(tilemaps.SaveLayerFile(reg, layer, path));
+		auto saved = TilemapFileReader::Open(path);
+		REQUIRE(saved);
+		REQUIRE(saved->GetChunkCount() == 9);
+		REQUIRE(saved->HasChunk({ -2, -1 }));
+		REQUIRE_FALSE(saved->HasChunk({ 1, 0 }));
+		REQUIRE(saved->MapChunk({ 0, 0 })->tileIds[5 * 32 + 6] == 2);
+		saved.reset();
+		tilemaps.CloseLayerFile(reg, layer);
+		REQUIRE(tilemaps.GetTile(reg, layer, { 70, 20 }) == 4);
+	}
+
+	// Corruption is caught: the header on open, a payload when its chunk is mapped
+	{
+		std::fstream out(path, std::ios::in | std::ios::out | std::ios::binary);
+		out.seekp(TilemapFileFormat::DEFAULT_ALIGNMENT + 8);
+		out.put('\x55');
+	}
+	file = TilemapFileReader::Open(path);
+	REQUIRE(file);
+	REQUIRE_FALSE(file->Verify());
+	file.reset();
+	{
+		std::fstream out(path, std::ios::in | std::ios::out | std::ios::binary);
+		out.seekp(16);
+		out.put('\x55');
+	}
+	REQUIRE_FALSE(TilemapFileReader::Open(path));
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,506 @@
+﻿#include <catch2/catch_test_macros.hpp>
+#include "TestHelpers.h"
+#include <WanderSpire/World/TilemapChangeJournal.h>
+#include <WanderSpire/World/PalettedTileStorage.h>
+#include <WanderSpire/World/TileAttributes.h>
+#include <WanderSpire/Graphics/TileRenderTable.h>
+#include <WanderSpire/Systems/AnimatedTileSystem.h>
+#include <WanderSpire/Components/AnimatedTileComponent.h>
+
+#include <algorithm>
+#include <chrono>
+
+TEST_CASE("Bulk tile edits keep chunk instance counts exact", "[tilemap]") {
+	entt::registry reg;
+	auto& tilemaps = TilemapSystem::GetInstance();
+	auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+	auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+
+	auto countFilled = [&]() {
+		int total = 0;
+		for (auto [e, chunk] : reg.view<TilemapChunkComponent>().each()) {
+			REQUIRE(chunk.instanceCount ==
+				std::count_if(chunk.tileIds.begin(), chunk.tileIds.end(), [](int id) { return id != -1; }));
+			total += chunk.instanceCount;
+		}
+		return total;
+		};
+
+	// Spans a chunk border on both axes, including negative coordinates
+	REQUIRE(tilemaps.FillRect(reg, layer, { -5, -5 }, { 40, 3 }, 1) == 46 * 9);
+	REQUIRE(countFilled() == 46 * 9);
+	REQUIRE(tilemaps.FillRect(reg, layer, { -5, -5 }, { 40, 3 }, 1) == 0);
+
+	REQUIRE(tilemaps.ReplaceInRect(reg, layer, { 0, 0 }, { 9, 9 }, 1, 2) == 40);
+	REQUIRE(tilemaps.GetTile(reg, layer, { 9, 3 }) == 2);
+	REQUIRE(tilemaps.GetTile(reg, layer, { 9, 4 }) == -1);
+
+	// Overlapping copy within one layer reads the original tiles
+	REQUIRE(tilemaps.CopyRect(reg, layer, { 0, 0 }, { 9, 3 }, layer, { 5, 0 }) > 0);
+	std::vector<int> row(15);
+	tilemaps.ReadRect(reg, layer, { 0, 0 }, { 14, 0 }, row.data());
+	REQUIRE(std::all_of(row.begin(), row.end(), [](int id) { return id == 2; }));
+
+	const glm::ivec2 positions[] = { { 100, 100 }, { 101, 100 }, { -5, -5 } };
+	const int ids[] = { 3, 3, -1 };
+	REQUIRE(tilemaps.SetTiles(reg, layer, positions, ids, 3) == 3);
+
+	// Erasing unloaded ground creates nothing
+	const size_t chunkCount = reg.view<TilemapChunkComponent>().size();
+	REQUIRE(tilemaps.FillRect(reg, layer, { 500, 500 }, { 520, 520 }, -1) == 0);
+	REQUIRE(reg.view<TilemapChunkComponent>().size() == chunkCount);
+
+	REQUIRE(countFilled() == 46 * 9 - 1 + 2);
+
+	// Writes that change nothing notify nobody; unloaded chunks leave the index
+	size_t notified = 0;
+	const size_t listener = tilemaps.AddChunkChangedListener(
+		[&](entt::registry&, entt::entity, const glm::ivec2&) { ++notified; });
+	tilemaps.SetTile(reg, layer, { 100, 100 }, 3);
+	REQUIRE(notified == 0);
+	tilemaps.SetTile(reg, layer, { 100, 100 }, 4);
+	REQUIRE(notified == 1);
+	tilemaps.UnloadChunk(reg, layer, { 3, 3 });
+	REQUIRE_FALSE(tilemaps.IsChunkLoaded(reg, layer, { 3, 3 }));
+	REQUIRE(tilemaps.GetTile(reg, layer, { 100, 100 }) == -1);
+	tilemaps.RemoveChunkChangedListener(listener);
+}
+
+TEST_CASE("Scanline flood fill stays inside walls, bounds and tile budget", "[tilemap]") {
+	entt::registry reg;
+	auto& tilemaps = TilemapSystem::GetInstance();
+	auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+	auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+
+	// 60×60 lake of tile 1 across several chunks, split by a wall of 2 at x = 30
+	tilemaps.FillRect(reg, layer, { 0, 0 }, { 59, 59 }, 1);
+	tilemaps.FillRect(reg, layer, { 30, 0 }, { 30, 59 }, 2);
+
+	TilemapSystem::FloodFillOptions measure;
+	measure.apply = false;
+	measure.collectMask = true;
+	auto region = tilemaps.FloodFill(reg, layer, { 5, 5 }, 3, measure);
+	REQUIRE(region.originalTileId == 1);
+	REQUIRE(region.tilesFilled == 30 * 60);
+	REQUIRE(region.mask.tileCount == 30 * 60);
+	REQUIRE(tilemaps.GetTile(reg, layer, { 5, 5 }) == 1);
+
+	// Applying and reverting the mask round-trips the layer
+	REQUIRE(tilemaps.ApplyMask(reg, layer, region.mask, 3) == 30 * 60);
+	REQUIRE(tilemaps.GetTile(reg, layer, { 29, 59 }) == 3);
+	REQUIRE(tilemaps.GetTile(reg, layer, { 31, 0 }) == 1);
+	REQUIRE(tilemaps.ApplyMask(reg, layer, region.mask, 1) == 30 * 60);
+
+	// Explicit bounds clip the fill
+	TilemapSystem::FloodFillOptions bounded;
+	bounded.useBounds = true;
+	bounded.boundsMin = { 40, 40 };
+	bounded.boundsMax = { 49, 44 };
+	REQUIRE(tilemaps.FloodFill(reg, layer, { 45, 42 }, 4, bounded).tilesFilled == 50);
+	REQUIRE(tilemaps.GetTile(reg, layer, { 45, 45 }) == 1);
+
+	// The tile budget aborts without writing anything
+	TilemapSystem::FloodFillOptions capped;
+	capped.maxTiles = 100;
+	auto aborted = tilemaps.FloodFill(reg, layer, { 0, 0 }, 5, capped);
+	REQUIRE(aborted.aborted);
+	REQUIRE(aborted.tilesFilled == 0);
+	REQUIRE(tilemaps.GetTile(reg, layer, { 0, 0 }) == 1);
+
+	// Empty ground is clamped to the loaded chunks instead of running forever
+	REQUIRE(tilemaps.FloodFill(reg, layer, { 70, 70 }, 6) > 0);
+	REQUIRE(tilemaps.GetTile(reg, layer, { 500, 500 }) == -1);
+}
+
+TEST_CASE("Chunk summaries answer bounds, count and find queries exactly", "[tilemap]") {
+	entt::registry reg;
+	auto& tilemaps = TilemapSystem::GetInstance();
+	auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+	auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+
+	glm::ivec2 lo, hi;
+	REQUIRE_FALSE(tilemaps.GetLayerBounds(reg, layer, lo, hi));
+
+	tilemaps.FillRect(reg, layer, { -10, 3 }, { 40, 20 }, 1);
+	tilemaps.SetTile(reg, layer, { 70, -4 }, 7);
+	tilemaps.SetTile(reg, layer, { 5, 5 }, 7);
+
+	REQUIRE(tilemaps.GetLayerBounds(reg, layer, lo, hi));
+	REQUIRE(lo == glm::ivec2{ -10, -4 });
+	REQUIRE(hi == glm::ivec2{ 70, 20 });
+
+	// Erasing the extreme tile shrinks the bounds again
+	tilemaps.SetTile(reg, layer, { 70, -4 }, -1);
+	REQUIRE(tilemaps.GetLayerBounds(reg, layer, lo, hi));
+	REQUIRE(lo == glm::ivec2{ -10, 3 });
+	REQUIRE(hi == glm::ivec2{ 40, 20 });
+
+	REQUIRE(tilemaps.CountTilesInRect(reg, layer, { -100, -100 }, { 100, 100 }) == 51 * 18);
+	REQUIRE(tilemaps.CountTilesInRect(reg, layer, { 0, 0 }, { 9, 9 }, 1) == 10 * 7 - 1);
+	REQUIRE(tilemaps.CountTilesInRect(reg, layer, { 0, 0 }, { 9, 9 }, -1) == 30);
+	REQUIRE(tilemaps.CountTilesInRect(reg, layer, { 0, 0 }, { 9, 9 }, 7) == 1);
+
+	glm::ivec2 found[4];
+	REQUIRE(tilemaps.FindTilePositions(reg, layer, 7, found, 4) == 1);
+	REQUIRE(found[0] == glm::ivec2{ 5, 5 });
+
+	REQUIRE(tilemaps.ReplaceInRect(reg, layer, { -100, -100 }, { 100, 100 }, 7, 8) == 1);
+	REQUIRE(tilemaps.FindTilePositions(reg, layer, 7, found, 4) == 0);
+	REQUIRE(tilemaps.CountTilesInRect(reg, layer, { -100, -100 }, { 100, 100 }, 8) == 1);
+}
+
+TEST_CASE("Change journal delivers per-chunk edits to each cursor", "[tilemap]") {
+	entt::registry reg;
+	auto& tilemaps = TilemapSystem::GetInstance();
+	auto& journal = TilemapChangeJournal::GetInstance();
+	auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+	auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+
+	const auto early = journal.Subscribe(reg);
+	tilemaps.FillRect(reg, layer, { 0, 0 }, { 40, 3 }, 1);   // two chunks
+
+	std::vector<TileChangeRecord> records;
+	REQUIRE(journal.Poll(reg, early, records));
+	REQUIRE(records.size() == 2);
+	const uint64_t firstVersion = tilemaps.GetChunkVersion(reg, layer, { 0, 0 });
+	REQUIRE(firstVersion > 0);
+
+	// Unread per-tile edits of one chunk fold into a single record
+	const auto late = journal.Subscribe(reg);
+	tilemaps.SetTile(reg, layer, { 2, 2 }, 5);
+	tilemaps.SetTile(reg, layer, { 7, 1 }, 5);
+	REQUIRE(tilemaps.GetChunkVersion(reg, layer, { 0, 0 }) > firstVersion);
+
+	records.clear();
+	REQUIRE(journal.Poll(reg, late, records));
+	REQUIRE(records.size() == 1);
+	REQUIRE(records[0].min == glm::ivec2{ 2, 1 });
+	REQUIRE(records[0].max == glm::ivec2{ 7, 2 });
+	REQUIRE(records[0].chunkVersion == tilemaps.GetChunkVersion(reg, layer, { 0, 0 }));
+
+	records.clear();
+	REQUIRE(journal.Poll(reg, early, records));
+	REQUIRE(records.size() == 1);
+
+	// Wrapping the ring past a cursor reports an overflow
+	const size_t capacity = journal.GetCapacity();
+	journal.SetCapacity(4);
+	for (int i = 0; i < 6; ++i) {
+		tilemaps.SetTile(reg, layer, { i * 40, 100 }, 2);   // distinct chunks, no folding
+	}
+	records.clear();
+	REQUIRE_FALSE(journal.Poll(reg, late, records));
+	REQUIRE(records.size() == 4);
+	journal.SetCapacity(capacity);
+
+	journal.Unsubscribe(reg, early);
+	journal.Unsubscribe(reg, late);
+}
+
+TEST_CASE("Palette storage round-trips tiles across bit-width changes", "[tilemap]") {
+	PalettedTileStorage storage;
+	storage.Reset(1024);
+	REQUIRE(storage.BitsPerIndex() == 0);
+	REQUIRE(storage.Get(500) == -1);
+
+	// Palette growth widens the indices without disturbing earlier tiles
+	std::vector<int> expected(1024, -1);
+	for (int i = 0; i < 1024; ++i) {
+		const int id = (i * 37) % 300;
+		storage.Set(i, id);
+		expected[i] = id;
+		REQUIRE(storage.Get(i / 2) == expected[i / 2]);
+	}
+	REQUIRE(storage.BitsPerIndex() == 16);
+
+	std::vector<int> decoded(1024);
+	storage.Decode(decoded.data());
+	REQUIRE(decoded == expected);
+
+	// Freed palette entries shrink the width back down
+	for (int i = 0; i < 1024; ++i) storage.Set(i, i % 3);
+	storage.ShrinkToFit();
+	REQUIRE(storage.BitsPerIndex() == 2);
+	std::vector<int> range(10);
+	storage.DecodeRange(100, 10, range.data());
+	for (int i = 0; i < 10; ++i) REQUIRE(range[i] == (100 + i) % 3);
+
+	storage.SetData(7, 42);
+	storage.SetData(3, 9);
+	storage.SetData(7, 0);
+	REQUIRE(storage.GetData(3) == 9);
+	REQUIRE(storage.GetData(7) == 0);
+}
+
+TEST_CASE("Compact chunks read and write like flat ones", "[tilemap]") {
+	entt::registry reg;
+	auto& tilemaps = TilemapSystem::GetInstance();
+	auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+	auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+
+	REQUIRE(tilemaps.FillRect(reg, layer, { 0, 0 }, { 31, 31 }, 1) == 1024);
+	tilemaps.SetTile(reg, layer, { 4, 4 }, 2);
+	const size_t flatBytes = tilemaps.GetLayerTileMemory(reg, layer);
+
+	REQUIRE(tilemaps.CompactLayer(reg, layer) == 1);
+	REQUIRE(tilemaps.GetLayerTileMemory(reg, layer) < flatBytes);
+	REQUIRE(tilemaps.GetTile(reg, layer, { 4, 4 }) == 2);
+	REQUIRE(tilemaps.CountTilesInRect(reg, layer, { 0, 0 }, { 31, 31 }, 1) == 1023);
+
+	// Single writes stay packed; bulk writes expand
+	tilemaps.SetTile(reg, layer, { 5, 5 }, 3);
+	auto& chunk = reg.get<TilemapChunkComponent>(reg.view<TilemapChunkComponent>().front());
+	REQUIRE(chunk.compact);
+	REQUIRE(chunk.instanceCount == 1024);
+	std::vector<int> row(3);
+	tilemaps.ReadRect(reg, layer, { 3, 5 }, { 5, 5 }, row.data());
+	REQUIRE(row == std::vector<int>{ 1, 1, 3 });
+
+	REQUIRE(tilemaps.FillRect(reg, layer, { 0, 0 }, { 1, 0 }, -1) == 2);
+	REQUIRE_FALSE(chunk.compact);
+	REQUIRE(chunk.instanceCount == 1022);
+	REQUIRE(tilemaps.GetTile(reg, layer, { 5, 5 }) == 3);
+}
+
+TEST_CASE("Palette storage cuts chunk memory 5-20x", "[.][benchmark][tilemap]") {
+	constexpr int kChunkTiles = 32 * 32;
+	constexpr int kChunks = 1000;
+
+	// Typical terrain: a few distinct tiles per chunk, plus fully empty chunks
+	size_t flatBytes = 0, packedBytes = 0;
+	std::vector<PalettedTileStorage> packed(kChunks);
+	std::vector<int> ids(kChunkTiles);
+	for (int c = 0; c < kChunks; ++c) {
+		for (int i = 0; i < kChunkTiles; ++i)
+			ids[i] = (c % 4 == 0) ? -1 : ((i * 7 + c) % 11 == 0 ? c % 3 + 2 : 1);
+		packed[c].Encode(ids.data(), nullptr, kChunkTiles);
+		flatBytes += kChunkTiles * (sizeof(int) + sizeof(uint32_t));
+		packedBytes += packed[c].MemoryBytes();
+	}
+
+	const double ratio = double(flatBytes) / double(packedBytes);
+	INFO("flat " << flatBytes << " B, packed " << packedBytes << " B, ratio " << ratio);
+	REQUIRE(ratio >= 5.0);
+
+	// Random access stays cheap
+	volatile long long sink = 0;
+	const auto t0 = std::chrono::steady_clock::now();
+	for (int round = 0; round < 100; ++round)
+		for (auto& chunk : packed)
+			for (int i = 0; i < kChunkTiles; i += 7) sink = sink + chunk.Get(i);
+	const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - t0).count();
+	INFO("random reads: " << micros << " us");
+	SUCCEED();
+}
+
+TEST_CASE("Identical compact chunks share one payload until written", "[tilemap]") {
+	entt::registry reg;
+	auto& tilemaps = TilemapSystem::GetInstance();
+	auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+	auto ground = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+	auto water = tilemaps.CreateTilemapLayer(reg, tilemap, "Water");
+
+	// Eight chunks of ocean across two layers
+	REQUIRE(tilemaps.FillRect(reg, ground, { 0, 0 }, { 127, 31 }, 5) == 4 * 1024);
+	REQUIRE(tilemaps.FillRect(reg, water, { 0, 32 }, { 127, 63 }, 5) == 4 * 1024);
+	const size_t flatBytes = tilemaps.GetLayerTileMemory(reg, ground);
+	REQUIRE(tilemaps.CompactLayer(reg, ground) == 4);
+	REQUIRE(tilemaps.CompactLayer(reg, water) == 4);
+
+	std::vector<const PalettedTileStorage*> payloads;
+	for (auto [e, chunk] : reg.view<TilemapChunkComponent>().each()) payloads.push_back(chunk.shared.get());
+	REQUIRE(payloads.size() == 8);
+	REQUIRE(std::all_of(payloads.begin(), payloads.end(), [&](auto* p) { return p && p == payloads[0]; }));
+	REQUIRE(tilemaps.GetLayerTileMemory(reg, ground) * 50 < flatBytes);
+
+	// The first write splits the chunk off; its neighbours keep the payload
+	tilemaps.SetTile(reg, water, { 3, 40 }, 6);
+	REQUIRE(tilemaps.GetTile(reg, water, { 3, 40 }) == 6);
+	REQUIRE(tilemaps.GetTile(reg, ground, { 3, 8 }) == 5);
+	REQUIRE(tilemaps.GetTile(reg, water, { 35, 40 }) == 5);
+	size_t stillShared = 0;
+	for (auto [e, chunk] : reg.view<TilemapChunkComponent>().each()) stillShared += chunk.shared.get() == payloads[0];
+	REQUIRE(stillShared == 7);
+
+	// Bulk edits expand a shared chunk without touching the payload
+	REQUIRE(tilemaps.FillRect(reg, ground, { 0, 0 }, { 0, 0 }, -1) == 1);
+	REQUIRE(tilemaps.GetTile(reg, ground, { 32, 0 }) == 5);
+	REQUIRE(payloads[0]->Get(0) == 5);
+}
+
+TEST_CASE("Installed and restored chunks start on shared payloads", "[tilemap]") {
+	entt::registry reg;
+	auto& tilemaps = TilemapSystem::GetInstance();
+	auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+	auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+
+	auto payloadOf = [&](const glm::ivec2& coords) -> const PalettedTileStorage* {
+		for (auto [e, chunk] : reg.view<TilemapChunkComponent>().each())
+			if (chunk.chunkCoords == coords) return chunk.shared.get();
+		return nullptr;
+	};
+
+	// Generator output shares without any compaction pass
+	const std::vector<int> ocean(32 * 32, 5);
+	REQUIRE(tilemaps.InstallChunk(reg, layer, { 0, 0 }, std::vector<int>(ocean), {}));
+	REQUIRE(tilemaps.InstallChunk(reg, layer, { 1, 0 }, std::vector<int>(ocean), {}));
+	REQUIRE(payloadOf({ 0, 0 }));
+	REQUIRE(payloadOf({ 0, 0 }) == payloadOf({ 1, 0 }));
+	REQUIRE(tilemaps.GetTile(reg, layer, { 40, 3 }) == 5);
+
+	// An edit splits the chunk off; back from the eviction cache it shares again
+	tilemaps.SetTile(reg, layer, { 3, 3 }, 6);
+	REQUIRE(payloadOf({ 0, 0 }) == nullptr);
+	tilemaps.SetTile(reg, layer, { 3, 3 }, 5);
+	tilemaps.UnloadChunk(reg, layer, { 0, 0 });
+	tilemaps.LoadChunk(reg, layer, { 0, 0 });
+	REQUIRE(payloadOf({ 0, 0 }) == payloadOf({ 1, 0 }));
+	REQUIRE(tilemaps.GetTile(reg, layer, { 3, 3 }) == 5);
+}
+
+TEST_CASE("Animated tiles resolve through the tile render table", "[tilemap]") {
+	auto& table = TileRenderTable::GetInstance();
+	table.Clear();
+
+	// Frame tiles 40..42 with distinct UVs; 7 is the animated water id
+	for (int i = 0; i < 3; ++i) table.SetEntry(40 + i, { glm::vec2(0.25f * i, 0.0f), glm::vec2(0.25f), nullptr });
+
+	entt::registry reg;
+	auto water = reg.create();
+	auto& anim = reg.emplace<AnimatedTileComponent>(water);
+	anim.frames = { { 7, 0.5f }, { 40, 0.5f }, { 41, 0.5f }, { 42, 0.5f } };
+
+	// Same cost whether one tile or an ocean of tiles uses the id
+	AnimatedTileSystem::Update(reg);
+	REQUIRE(table.GetAnimationCount() == 1);
+	REQUIRE(table.GetDisplayTile(7) == 7);
+	REQUIRE(table.GetDisplayTile(40) == 40);
+
+	AnimatedTileSystem::AdvanceClock(0.75f);
+	AnimatedTileSystem::Update(reg);
+	REQUIRE(table.GetDisplayTile(7) == 40);
+	REQUIRE(table.GetEntry(table.GetDisplayTile(7))->uvOffset.x == 0.0f);
+	REQUIRE(reg.get<AnimatedTileComponent>(water).currentFrame == 1);
+
+	AnimatedTileSystem::AdvanceClock(1.0f);
+	AnimatedTileSystem::Update(reg);
+	REQUIRE(table.GetDisplayTile(7) == 42);
+	REQUIRE(table.GetEntry(table.GetDisplayTile(7))->uvOffset.x == 0.5f);
+
+	// Looping wraps around the 2 s cycle
+	AnimatedTileSystem::AdvanceClock(0.5f);
+	AnimatedTileSystem::Update(reg);
+	REQUIRE(table.GetDisplayTile(7) == 7);
+
+	// Paused components hold their frame while the clock keeps running
+	reg.get<AnimatedTileComponent>(water).playing = false;
+	reg.get<AnimatedTileComponent>(water).currentFrame = 2;
+	AnimatedTileSystem::AdvanceClock(0.3f);
+	AnimatedTileSystem::Update(reg);
+	REQUIRE(table.GetDisplayTile(7) == 41);
+
+	// Another registry's update neither advances the shared clock nor touches
+	// this registry's animations
+	{
+		const double time = table.GetTime();
+		entt::registry other;
+		AnimatedTileSystem::Update(other);
+		REQUIRE(table.GetTime() == time);
+	}
+	REQUIRE(table.GetDisplayTile(7) == 41);
+
+	// Removing the component stops the animation
+	reg.destroy(water);
+	AnimatedTileSystem::AdvanceClock(0.1f);
+	AnimatedTileSystem::Update(reg);
+	REQUIRE(table.GetAnimationCount() == 0);
+	REQUIRE(table.GetDisplayTile(7) == 7);
+
+	// Definition changes and atlas reloads drop resolved entries
+	table.SyncDefinitions(1, 0);
+	REQUIRE(table.GetEntry(40) == nullptr);
+	table.SetEntry(40, { glm::vec2(0.0f), glm::vec2(0.25f), nullptr });
+	table.SyncDefinitions(1, 0);
+	REQUIRE(table.GetEntry(40) != nullptr);
+	table.SyncDefinitions(1, 1);
+	REQUIRE(table.GetEntry(40) == nullptr);
+	table.Clear();
+}
+
+TEST_CASE("Tile attribute channels store typed values per chunk on demand", "[tilemap]") {
+	entt::registry reg;
+	auto& tilemaps = TilemapSystem::GetInstance();
+	auto& attributes = TileAttributes::GetInstance();
+	auto tilemap = tilemaps.CreateTilemap(reg, "Tilemap");
+	auto layer = tilemaps.CreateTilemapLayer(reg, tilemap, "Ground");
+
+	const int height = attributes.CreateChannel(reg, layer, "height", TileAttributeType::U8, 10.0f);
+	const int harvested = attributes.CreateChannel(reg, layer, "harvested", TileAttributeType::Flag);
+	const int water = attributes.CreateChannel(reg, layer, "water", TileAttributeType::F32, 0.5f);
+	REQUIRE(height >= 0);
+	REQUIRE(attributes.CreateChannel(reg, layer, "height", TileAttributeType::U8) == height);
+	REQUIRE(attributes.CreateChannel(reg, layer, "height", TileAttributeType::U16) == -1);
+
+	// Default values allocate nothing; U8 rounds and clamps
+	REQUIRE(attributes.Get(reg, layer, height, { -500, 300 }) == 10.0f);
+	attributes.Set(reg, layer, height, { 3, 3 }, 10.0f);
+	REQUIRE(attributes.GetBlockCount(reg, layer, height) == 0);
+	attributes.Set(reg, layer, height, { -1, -1 }, 300.7f);
+	REQUIRE(attributes.Get(reg, layer, height, { -1, -1 }) == 255.0f);
+	REQUIRE(attributes.GetBlockCount(reg, layer, height) == 1);
+
+	// Chunks without a block count as the default
+	const auto stats = attributes.QueryRect(reg, layer, height, { -40, -40 }, { 39, 39 });
+	REQUIRE(stats.count == 80 * 80);
+	REQUIRE(stats.min == 10.0f);
+	REQUIRE(stats.max == 255.0f);
+	REQUIRE(stats.sum == 10.0 * (80 * 80 - 1) + 255.0);
+	REQUIRE(attributes.CountWhere(reg, layer, height, { -40, -40 }, { 39, 39 }, TileAttributeCompare::Greater, 10.5f) == 1);
+	REQUIRE(attributes.CountWhere(reg, layer, height, { -40, -40 }, { 39, 39 }, TileAttributeCompare::LessEqual, 10.0f) == 80 * 80 - 1);
+
+	// Flags are bits; clearing a whole chunk frees its block
+	attributes.FillRect(reg, layer, harvested, { -10, -3 }, { 40, 5 }, 1.0f);
+	REQUIRE(attributes.CountWhere(reg, layer, harvested, { -64, -64 }, { 63, 63 }, TileAttributeCompare::Equal, 1.0f) == 51 * 9);
+	REQUIRE(attributes.QueryRect(reg, layer, harvested, { 0, 4 }, { 2, 6 }).sum == 6.0);
+	uint8_t flags[3] = {};
+	REQUIRE(attributes.ReadRectRaw(reg, layer, harvested, { 40, 5 }, { 42, 5 }, flags));
+	REQUIRE((flags[0] == 1 && flags[1] == 0 && flags[2] == 0));
+	attributes.FillRect(reg, layer, harvested, { -32, -32 }, { 63, 31 }, 0.0f);
+	REQUIRE(attributes.GetBlockCount(reg, layer, harvested) == 0);
+
+	// Raw rect copies in the channel's own type
+	const int owner = attributes.CreateChannel(reg, layer, "owner", TileAttributeType::U16);
+	const uint16_t owners[6] = { 1, 2, 3, 400, 500, 600 };
+	REQUIRE(attributes.WriteRectRaw(reg, layer, owner, { 30, 0 }, { 32, 1 }, owners));
+	uint16_t readBack[6] = {};
+	REQUIRE(attributes.ReadRectRaw(reg, layer, owner, { 30, 0 }, { 32, 1 }, readBack));
+	REQUIRE(std::equal(owners, owners + 6, readBack));
+	REQUIRE(attributes.GetBlockCount(reg, layer, owner) == 2);
+	REQUIRE(attributes.CountWhere(reg, layer, owner, { 0, 0 }, { 63, 1 }, TileAttributeCompare::GreaterEqual, 2.5f) == 4);
+
+	attributes.Set(reg, layer, water, { 70, 70 }, 2.25f);
+
+	// Channels round-trip through the scene JSON form
+	const auto json = reg.get<TileAttributeComponent>(layer).ToJson();
+	entt::registry loaded;
+	auto copy = loaded.create();
+	loaded.emplace<TileAttributeComponent>(copy).LoadFromJson(json);
+	REQUIRE(attributes.FindChannel(loaded, copy, "owner") == owner);
+	REQUIRE(attributes.Get(loaded, copy, height, { -1, -1 }) == 255.0f);
+	REQUIRE(attributes.Get(loaded, copy, owner, { 32, 1 }) == 600.0f);
+	REQUIRE(attributes.Get(loaded, copy, water, { 70, 70 }) == 2.25f);
+	REQUIRE(attributes.Get(loaded, copy, water, { 0, 0 }) == 0.5f);
+
+	// Removed channels free their slot for the next one, under a new id
+	REQUIRE(attributes.RemoveChannel(reg, layer, harvested));
+	REQUIRE(attributes.FindChannel(reg, layer, "harvested") == -1);
+	const int light = attributes.CreateChannel(reg, layer, "light", TileAttributeType::F32);
+	REQUIRE(light >= 0);
+	REQUIRE(light != harvested);
+	REQUIRE_FALSE(attributes.RemoveChannel(reg, layer, harvested));
+	attributes.Set(reg, layer, harvested, { 0, 0 }, 1.0f);
+	REQUIRE(attributes.Get(reg, layer, light, { 0, 0 }) == 0.0f);
+	REQUIRE(attributes.GetBlockCount(reg, layer, light) == 0);
+	REQUIRE(attributes.FindChannel(reg, layer, "light") == light);
+}